@@ -85,6 +85,11 @@ Constants specifying how bands should be treated when sharpening (see rsgislib.i
     * SHARP_RES_LOW = 1
     * SHARP_RES_HIGH = 2
 
+Methods of calculating percentiles
+    * PERCENTILE_HISTOGRAM = 0
+    * PERCENTILE_SKETCH = 1
+    * PERCENTILE_EXACT = 2
+
 """
 from __future__ import print_function
 
@@ -167,6 +172,10 @@ SHARP_RES_IGNORE = 0
 SHARP_RES_LOW = 1
 SHARP_RES_HIGH = 2
 
+PERCENTILE_HISTOGRAM = 0
+PERCENTILE_SKETCH = 1
+PERCENTILE_EXACT = 2
+
 def getRSGISLibVersion():
     """ Calls rsgis-config to get the version number. """
 
@@ -872,3 +872,45 @@ def normalise_image_band(input_img, band, output_img, gdal_format='KEA'):
     rsgislib.imagecalc.bandMath(output_img, exp, gdal_format, rsgislib.TYPE_32FLOAT, band_defns)
     rsgislib.imageutils.popImageStats(output_img, usenodataval=True, nodataval=0.0, calcpyramids=True)
 
+
+
+def calcImageBlocks(inputimgs, outputimg, gdalformat, datatype, numoutbands, blockfunc):
+    """
+    Apply a function to each block of rows of the input image(s), where the blocks are
+    passed as numpy arrays viewing the image buffers read by rsgislib (i.e., no copy is
+    made). This allows per-pixel models to be prototyped in Python (using vectorised numpy
+    operations) without writing intermediate files. The blocks are processed in order and,
+    if rsgislib.imagecalc.setPipelinedIO(True) has been called, the next block is read while
+    the function is running.
+
+    :param inputimgs: a list of input image files, the bands of which are stacked in order.
+    :param outputimg: the output image file.
+    :param gdalformat: the output image format (e.g., KEA).
+    :param datatype: the output image data type (e.g., rsgislib.TYPE_32FLOAT).
+    :param numoutbands: the number of bands within the output image.
+    :param blockfunc: a function called as blockfunc(inblock, outblock, yoff) where inblock is a
+                      list of read-only 2D float32 arrays (one per input band, shape [nrows, width]),
+                      outblock is a list of 2D float64 arrays (one per output band) which should be
+                      populated with the output values (e.g., outblock[0][...] = inblock[0] * 2) and
+                      yoff is the row within the image of the first row of the block. The arrays are
+                      only valid while blockfunc is running so must not be kept (copy them if needed).
+
+    Example::
+
+        import rsgislib
+        from rsgislib import imagecalc
+
+        def calcNDVI(inblock, outblock, yoff):
+            red = inblock[3]
+            nir = inblock[4]
+            numpy.divide(nir - red, nir + red, out=outblock[0], where=(nir + red) != 0)
+
+        imagecalc.calcImageBlocks(['LS8_img.kea'], 'LS8_ndvi.kea', 'KEA', rsgislib.TYPE_32FLOAT, 1, calcNDVI)
+
+    """
+    def _blockBufferFunc(inbufs, outbufs, width, nrows, yoff):
+        inblock = [numpy.frombuffer(buf, dtype=numpy.float32).reshape((nrows, width)) for buf in inbufs]
+        outblock = [numpy.frombuffer(buf, dtype=numpy.float64).reshape((nrows, width)) for buf in outbufs]
+        blockfunc(inblock, outblock, yoff)
+
+    calcImageBlockBuffers(inputimgs, outputimg, gdalformat, datatype, numoutbands, _blockBufferFunc)
@@ -9,12 +9,13 @@ import os.path
 
 class FilterParameters:
     """ Object, specifying the type of filter and filter parameters """
-    def __init__(self, filterType, fileEnding, size = 3, option = None, nLooks = None, stddev = None, stddevX = None, stddevY = None, angle = None):
+    def __init__(self, filterType, fileEnding, size = 3, option = None, nLooks = None, stddev = None, stddevX = None, stddevY = None, angle = None, percentile = None):
         self.filterType = filterType
         self.fileEnding = fileEnding
         self.size = size
         self.option = option
         self.nLooks = nLooks
+        self.percentile = percentile
         self.stddev = stddev
         self.stddevX = stddevX
         self.stddevY = stddevY
@@ -47,6 +48,36 @@ Example::
     applyfilters(inputimage, outputImageBase, filters, gdalformat, outExt, datatype)
 
 
+def applyPercentileFilter(inputimage, outputImage, filterSize, percentile, gdalformat, datatype):
+    """ Apply a percentile filter to the specified input image. The percentile is
+found with a running histogram as the filter window moves along each row, so 
+large filter windows remain quick to apply.
+
+Where:
+
+:param inputImage: string specifying the input image to be filtered.
+:param outputImage: string specifying the output image file..
+:param filterSize: int specfiying the size of the image filter (must be an odd number, i.e., 3, 5, 7, etc).
+:param percentile: float specifying the percentile (0-100) to be calculated within the filter window (50 is the median).
+:param gdalformat: string specifying the output image format (e.g., KEA).
+:param datatype: Specifying the output image pixel data type (e.g., rsgislib.TYPE_32FLOAT).
+
+Example::
+
+    import rsgislib
+    from rsgislib import imagefilter
+    inputImage = 'jers1palsar_stack.kea'
+    outImgFile = 'jers1palsar_stack_pc90_15.kea'
+    imagefilter.applyPercentileFilter(inputImage, outImgFile, 15, 90, "KEA", rsgislib.TYPE_32FLOAT)
+
+    """
+    outputImageBase, outExt = os.path.splitext(outputImage)
+    outExt = outExt.replace(".", "").strip()
+    filters = []
+    filters.append(FilterParameters(filterType = 'Percentile', fileEnding = '', size=filterSize, percentile=percentile) )
+    applyfilters(inputimage, outputImageBase, filters, gdalformat, outExt, datatype)
+
+
 def applyMeanFilter(inputimage, outputImage, filterSize, gdalformat, datatype):
     """ Apply a mean filter to the specified input image.
 
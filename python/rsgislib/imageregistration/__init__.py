@@ -13,6 +13,8 @@ Image distance metrics:
     * METRIC_SQDIFF = 2
     * METRIC_MANHATTEN = 3
     * METRIC_CORELATION = 4
+    * METRIC_FFT_CORELATION = 5 (as METRIC_CORELATION, including ignoring pairs of pixels where either is no data (NaN); all the shifts calculated at once using FFTs and tie points processed in parallel)
+    * METRIC_PHASE_CORELATION = 6 (phase correlation, with no data (NaN) pixels set to the image mean; all the shifts calculated at once using FFTs and tie points processed in parallel)
 
 
 GCP Output Types:
@@ -34,6 +36,8 @@ METRIC_EUCLIDEAN = 1
 METRIC_SQDIFF = 2
 METRIC_MANHATTEN = 3
 METRIC_CORELATION = 4
+METRIC_FFT_CORELATION = 5
+METRIC_PHASE_CORELATION = 6
 
 TYPE_ENVI_IMG2IMG = 1
 TYPE_ENVI_IMG2MAP = 2
@@ -56,7 +56,42 @@ import osgeo.gdal as gdal
 import json
 
 
-def runShepherdSegmentation(inputImg, outputClumps, outputMeanImg=None, tmpath='.', gdalformat='KEA', noStats=False, noStretch=False, noDelete=False, numClusters=60, minPxls=100, distThres=100, bands=None, sampling=100, kmMaxIter=200, processInMem=False, saveProcessStats=False, imgStretchStats="", kMeansCentres="", imgStatsJSONFile=""): 
+def _writeShepherdSegSceneJSON(inputImg, imgStretchStats, kMeansCentres, imgStatsJSONFile):
+    """
+Write the image extent and the stretch stats and KMeans centres file paths used by runShepherdSegmentation to a JSON file.
+    """
+    gdalDS = gdal.Open(inputImg, gdal.GA_ReadOnly)
+    geotransform = gdalDS.GetGeoTransform()
+    if not geotransform is None:
+        xTL = geotransform[0]
+        yTL = geotransform[3]
+        
+        xRes = geotransform[1]
+        yRes = geotransform[5]
+        
+        width = gdalDS.RasterXSize * xRes
+        if yRes < 0:
+            yRes = yRes * (-1)
+        height = gdalDS.RasterYSize * yRes
+        xBR = xTL + width
+        yBR = yTL - height
+        
+        xCen = xTL + (width/2)
+        yCen = yBR + (height/2)
+    
+        sceneData = dict()
+        sceneData['KCENTRES'] = kMeansCentres+str(".gmtxt")
+        sceneData['STRETCHSTATS'] = imgStretchStats
+        sceneData['CENTRE_PT'] = {'X':xCen, 'Y':yCen}
+        sceneData['BBOX'] = {'XMIN':xTL, 'YMIN':yBR, 'XMAX':xBR, 'YMAX':yTL}
+        
+        with open(imgStatsJSONFile, 'w') as outfile:
+            json.dump(sceneData, outfile, sort_keys=True, indent=4, separators=(',', ': '), ensure_ascii=False)
+
+    gdalDS = None
+
+
+def runShepherdSegmentation(inputImg, outputClumps, outputMeanImg=None, tmpath='.', gdalformat='KEA', noStats=False, noStretch=False, noDelete=False, numClusters=60, minPxls=100, distThres=100, bands=None, sampling=100, kmMaxIter=200, processInMem=False, saveProcessStats=False, imgStretchStats="", kMeansCentres="", imgStatsJSONFile="", inProcess=False): 
     """
 Utility function to call the segmentation algorithm of Shepherd et al. (2019).
 
@@ -83,6 +118,7 @@ Where:
 :param imgStretchStats: is a string providing the file name and path for the image stretch stats (Output).
 :param kMeansCentres: is a string providing the file name and path for the KMeans clusters centres (don't include file extension; .gmtxt will be added to the end) (Output).
 :param imgStatsJSONFile: is a string providing the name and path of a JSON file storing the image spatial extent and imgStretchStats and kMeansCentres file paths for use by other commands (Output).
+:param inProcess: is a bool specifying that segmentation.shepherdSegmentation is used to run the whole segmentation within a single call, without writing the intermediate images to tmpath unless processInMem is False (default = False).
 
 Example::
 
@@ -101,6 +137,21 @@ Example::
         if (imgStretchStats=="") or (kMeansCentres=="") or (imgStatsJSONFile==""):
             raise rsgislib.RSGISPyException("if image stretch and kmeans centres are to be saved then all file names (imgStretchStats, kMeansCentres, imgStatsJSONFile) need to be provided.")
     
+    if inProcess:
+        outImgStretchStats = ""
+        outKMeansCentres = ""
+        if saveProcessStats:
+            outImgStretchStats = imgStretchStats
+            outKMeansCentres = kMeansCentres
+        if not os.path.isdir(tmpath):
+            os.makedirs(tmpath)
+        rsgislib.segmentation.shepherdSegmentation(inputImg, outputClumps, outputmeanimg=outputMeanImg, tmpath=tmpath, gdalformat=gdalformat, calcstats=(not noStats), nostretch=noStretch, numclusters=numClusters, minpxls=minPxls, distthres=distThres, bands=bands, sampling=sampling, kmmaxiter=kmMaxIter, processinmem=processInMem, outimgstretchstats=outImgStretchStats, outkmeanscentres=outKMeansCentres)
+        if (not (outputMeanImg == None)) and (not noStats):
+            rsgislib.imageutils.popImageStats(outputMeanImg, True, 0, True)
+        if saveProcessStats:
+            _writeShepherdSegSceneJSON(inputImg, imgStretchStats, kMeansCentres, imgStatsJSONFile)
+        return
+    
     rsgisUtils = rsgislib.RSGISPyUtils()
     
     basefile = os.path.basename(inputImg)
@@ -202,35 +253,7 @@ Example::
     
     
     if saveProcessStats:
-        gdalDS = gdal.Open(inputImg, gdal.GA_ReadOnly)
-        geotransform = gdalDS.GetGeoTransform()
-        if not geotransform is None:
-            xTL = geotransform[0]
-            yTL = geotransform[3]
-            
-            xRes = geotransform[1]
-            yRes = geotransform[5]
-            
-            width = gdalDS.RasterXSize * xRes
-            if yRes < 0:
-                yRes = yRes * (-1)
-            height = gdalDS.RasterYSize * yRes
-            xBR = xTL + width
-            yBR = yTL - height
-            
-            xCen = xTL + (width/2)
-            yCen = yBR + (height/2)
-        
-            sceneData = dict()
-            sceneData['KCENTRES'] = kMeansCentres+str(".gmtxt")
-            sceneData['STRETCHSTATS'] = imgStretchStats
-            sceneData['CENTRE_PT'] = {'X':xCen, 'Y':yCen}
-            sceneData['BBOX'] = {'XMIN':xTL, 'YMIN':yBR, 'XMAX':xBR, 'YMAX':yTL}
-            
-            with open(imgStatsJSONFile, 'w') as outfile:
-                json.dump(sceneData, outfile, sort_keys=True, indent=4, separators=(',', ': '), ensure_ascii=False)
-
-        gdalDS = None
+        _writeShepherdSegSceneJSON(inputImg, imgStretchStats, kMeansCentres, imgStatsJSONFile)
      
     if not noDelete:
         # Deleting extra files
@@ -354,7 +354,9 @@ static PyMethodDef HistoCubeMethods[] = {
 ":param clumpsImg: is a clumps image that specifies which histogram cube row pixels in with values image are associated (note resolution must be the same as the values image).\n"
 ":param valsImg: is the image with the values which are populated into the histogram cube.\n"
 ":param band: is the band number (note band numbers start at 1)\n"
-":param inMem: is a boolean specifying whether the data array should be kept in memory; much faster in memory. (Optional, default is True)\n"
+":param inMem: is a boolean specifying whether the whole data array should be kept in memory. If False, the counts are\n"
+"              accumulated in memory for the blocks of rows (chunks) of the layer touched by the image and added to\n"
+"              the file in batches, for cubes too large to be held in memory. (Optional, default is True)\n"
 "\n"
 "Example::\n"
 "\n"
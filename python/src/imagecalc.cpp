@@ -23,6 +23,7 @@
 #include <Python.h>
 #include "rsgispy_common.h"
 #include "cmds/RSGISCmdImageCalc.h"
+#include "cmds/RSGISCmdRasterGIS.h"
 
 /* An exception object for this module */
 /* created in the init function */
@@ -181,20 +182,22 @@ static PyObject *ImageCalc_ImageBandMath(PyObject *self, PyObject *args, PyObjec
     Py_RETURN_NONE;
 }
 
-static PyObject *ImageCalc_KMeansClustering(PyObject *self, PyObject *args) {
+static PyObject *ImageCalc_KMeansClustering(PyObject *self, PyObject *args, PyObject *keywds) {
+    static char *kwlist[] = {"inputImage", "outputMatrix", "numClusters", "maxIterations", "subSample", "ignoreZeros", "degreeOfChange", "initMethod", "miniBatchSize", NULL};
     const char *pszInputImage, *pszOutputFile;
     unsigned int nNumClusters, nMaxNumIterations, nSubSample;
     int nIgnoreZeros; // passed as a bool - seems the only way to pass into C
     float fDegreeOfChange;
     int nClusterMethod;
-    if( !PyArg_ParseTuple(args, "ssIIIifi:kMeansClustering", &pszInputImage, &pszOutputFile, &nNumClusters,
-                                &nMaxNumIterations, &nSubSample, &nIgnoreZeros, &fDegreeOfChange, &nClusterMethod ))
+    unsigned int nMiniBatchSize = 0;
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssIIIifi|I:kMeansClustering", kwlist, &pszInputImage, &pszOutputFile, &nNumClusters,
+                                &nMaxNumIterations, &nSubSample, &nIgnoreZeros, &fDegreeOfChange, &nClusterMethod, &nMiniBatchSize ))
         return NULL;
     
     try
     {
         rsgis::cmds::executeKMeansClustering(pszInputImage, pszOutputFile, nNumClusters, nMaxNumIterations,
-                            nSubSample, nIgnoreZeros, fDegreeOfChange, (rsgis::cmds::RSGISInitClustererMethods)nClusterMethod);
+                            nSubSample, nIgnoreZeros, fDegreeOfChange, (rsgis::cmds::RSGISInitClustererMethods)nClusterMethod, nMiniBatchSize);
         
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1146,17 +1149,26 @@ static PyObject *ImageCalc_GetHistogram(PyObject *self, PyObject *args) {
     return outList;
 }
 
-static PyObject *ImageCalc_BandPercentile(PyObject *self, PyObject *args)
+static PyObject *ImageCalc_BandPercentile(PyObject *self, PyObject *args, PyObject *keywds)
 {
     const char *inputImage;
     float percentile;
     PyObject *noDataValueObj;
+    int method = rsgis::cmds::rsgisPercentileExact;
+    unsigned int sketchK = 200;
+    static char *kwlist[] = {"inputImage", "percentile", "noDataValue", "method", "sketchk", NULL};
 
-    if(!PyArg_ParseTuple(args, "sfO:bandPercentile", &inputImage, &percentile, &noDataValueObj))
+    if(!PyArg_ParseTupleAndKeywords(args, keywds, "sfO|iI:bandPercentile", kwlist, &inputImage, &percentile, &noDataValueObj, &method, &sketchK))
     {
         return NULL;
     }
     
+    if((method != rsgis::cmds::rsgisPercentileSketch) && (method != rsgis::cmds::rsgisPercentileExact))
+    {
+        PyErr_SetString(GETSTATE(self)->error, "method must be one of rsgislib.PERCENTILE_SKETCH or rsgislib.PERCENTILE_EXACT");
+        return NULL;
+    }
+    
     bool haveNoDataValue = false;
     float noDataValue = 0.0;
     if(noDataValueObj != Py_None)
@@ -1171,7 +1183,7 @@ static PyObject *ImageCalc_BandPercentile(PyObject *self, PyObject *args)
     PyObject *outVals = NULL;
     try
     {
-        std::vector<double> outPercentileVals = rsgis::cmds::executeBandPercentile(inputImage, percentile, noDataValue, haveNoDataValue);
+        std::vector<double> outPercentileVals = rsgis::cmds::executeBandPercentile(inputImage, percentile, noDataValue, haveNoDataValue, (method == rsgis::cmds::rsgisPercentileSketch), sketchK);
         
         Py_ssize_t listLen = outPercentileVals.size();
         outVals = PyTuple_New(listLen);
@@ -2069,6 +2081,263 @@ static PyObject *ImageCalc_CalcImgMeanInMask(PyObject *self, PyObject *args, PyO
     return outVal;
 }
 
+static PyObject *ImageCalc_SetNumThreads(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"nthreads", NULL};
+    unsigned int numThreads = 0;
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "I:setNumThreads", kwlist, &numThreads))
+    {
+        return NULL;
+    }
+    
+    try
+    {
+        rsgis::cmds::executeSetNumThreads(numThreads);
+    }
+    catch(rsgis::cmds::RSGISCmdException &e)
+    {
+        PyErr_SetString(GETSTATE(self)->error, e.what());
+        return NULL;
+    }
+    
+    Py_RETURN_NONE;
+}
+
+static PyObject *ImageCalc_GetNumThreads(PyObject *self, PyObject *args)
+{
+    unsigned int numThreads = rsgis::cmds::executeGetNumThreads();
+    return Py_BuildValue("I", numThreads);
+}
+
+static PyObject *ImageCalc_SetPipelinedIO(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"pipeline", NULL};
+    int pipelinedIO = 1;
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "|i:setPipelinedIO", kwlist, &pipelinedIO))
+    {
+        return NULL;
+    }
+    
+    rsgis::cmds::executeSetPipelinedIO(pipelinedIO != 0);
+    
+    Py_RETURN_NONE;
+}
+
+static PyObject *ImageCalc_GetPipelinedIO(PyObject *self, PyObject *args)
+{
+    if(rsgis::cmds::executeGetPipelinedIO())
+    {
+        Py_RETURN_TRUE;
+    }
+    Py_RETURN_FALSE;
+}
+
+static PyObject *ImageCalc_SetImageBlockCacheSize(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"size_mb", NULL};
+    unsigned long sizeMB = 0;
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "k:setImageBlockCacheSize", kwlist, &sizeMB))
+    {
+        return NULL;
+    }
+    
+    rsgis::cmds::executeSetImageBlockCacheSize(sizeMB);
+    
+    Py_RETURN_NONE;
+}
+
+static PyObject *ImageCalc_GetImageBlockCacheStats(PyObject *self, PyObject *args)
+{
+    double sizeMB = 0;
+    double usedMB = 0;
+    unsigned long long numHits = 0;
+    unsigned long long numMisses = 0;
+    rsgis::cmds::executeGetImageBlockCacheStats(&sizeMB, &usedMB, &numHits, &numMisses);
+    
+    return Py_BuildValue("{s:d,s:d,s:K,s:K}", "size_mb", sizeMB, "used_mb", usedMB, "hits", numHits, "misses", numMisses);
+}
+
+static PyObject *ImageCalc_ClearImageBlockCache(PyObject *self, PyObject *args)
+{
+    rsgis::cmds::executeClearImageBlockCache();
+    Py_RETURN_NONE;
+}
+
+/* Holds the Python exception raised within a block function so it can be
+   restored once the image calculation has been stopped */
+struct ImageCalcBlockFuncError
+{
+    PyObject *type;
+    PyObject *value;
+    PyObject *traceback;
+};
+
+static PyObject *ImageCalc_CalcImageBlockBuffers(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"inputimgs", "outputimg", "gdalformat", "datatype", "numoutbands", "blockfunc", NULL};
+    const char *pszOutputImage, *pszGDALFormat;
+    int nDataType;
+    unsigned int numOutBands;
+    PyObject *pInputImgsObj;
+    PyObject *pBlockFuncObj;
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "OssiIO:calcImageBlockBuffers", kwlist, &pInputImgsObj, &pszOutputImage, &pszGDALFormat, &nDataType, &numOutBands, &pBlockFuncObj))
+    {
+        return NULL;
+    }
+    
+#if PY_MAJOR_VERSION >= 3
+    if( !PySequence_Check(pInputImgsObj))
+    {
+        PyErr_SetString(GETSTATE(self)->error, "inputimgs must be a sequence");
+        return NULL;
+    }
+    
+    if( !PyCallable_Check(pBlockFuncObj))
+    {
+        PyErr_SetString(GETSTATE(self)->error, "blockfunc must be callable");
+        return NULL;
+    }
+    
+    Py_ssize_t nInputImgs = PySequence_Size(pInputImgsObj);
+    std::vector<std::string> inputImgs;
+    inputImgs.reserve(nInputImgs);
+    for( Py_ssize_t n = 0; n < nInputImgs; ++n)
+    {
+        PyObject *o = PySequence_GetItem(pInputImgsObj, n);
+        if(!RSGISPY_CHECK_STRING(o))
+        {
+            PyErr_SetString(GETSTATE(self)->error, "inputimgs must only contain strings");
+            Py_DECREF(o);
+            return NULL;
+        }
+        inputImgs.push_back(RSGISPY_STRING_EXTRACT(o));
+        Py_DECREF(o);
+    }
+    
+    PyObject *pErrorObj = GETSTATE(self)->error;
+    ImageCalcBlockFuncError blockFuncError = {NULL, NULL, NULL};
+    
+    // Each block buffer is wrapped in a memoryview (no copy) and passed to the Python
+    // function, which is called with the GIL held. The memoryviews are released before
+    // returning so nothing can use the buffers once they have been reused by RSGISCalcImage.
+    rsgis::cmds::RSGISCmdBlockFunction blockFunc = [pBlockFuncObj, pErrorObj, &blockFuncError](float **inBlock, unsigned int numInBands, double **outBlock, unsigned int numOutBands, unsigned int width, unsigned int nRows, unsigned int yOff)
+    {
+        PyGILState_STATE gilState = PyGILState_Ensure();
+        
+        Py_ssize_t nPxls = ((Py_ssize_t)width) * ((Py_ssize_t)nRows);
+        PyObject *pInViews = PyList_New(numInBands);
+        PyObject *pOutViews = PyList_New(numOutBands);
+        bool buffersOK = (pInViews != NULL) && (pOutViews != NULL);
+        for(unsigned int n = 0; buffersOK && (n < numInBands); ++n)
+        {
+            PyObject *pView = PyMemoryView_FromMemory((char *) inBlock[n], nPxls * sizeof(float), PyBUF_READ);
+            buffersOK = (pView != NULL);
+            if(buffersOK)
+            {
+                PyList_SET_ITEM(pInViews, n, pView);
+            }
+        }
+        for(unsigned int n = 0; buffersOK && (n < numOutBands); ++n)
+        {
+            PyObject *pView = PyMemoryView_FromMemory((char *) outBlock[n], nPxls * sizeof(double), PyBUF_WRITE);
+            buffersOK = (pView != NULL);
+            if(buffersOK)
+            {
+                PyList_SET_ITEM(pOutViews, n, pView);
+            }
+        }
+        
+        bool funcOK = false;
+        if(buffersOK)
+        {
+            PyObject *pResult = PyObject_CallFunction(pBlockFuncObj, "OOIII", pInViews, pOutViews, width, nRows, yOff);
+            funcOK = (pResult != NULL);
+            Py_XDECREF(pResult);
+        }
+        if(!funcOK)
+        {
+            PyErr_Fetch(&blockFuncError.type, &blockFuncError.value, &blockFuncError.traceback);
+        }
+        
+        bool released = true;
+        PyObject *pViewLists[2] = {pInViews, pOutViews};
+        for(unsigned int l = 0; l < 2; ++l)
+        {
+            if(pViewLists[l] == NULL)
+            {
+                continue;
+            }
+            for(Py_ssize_t n = 0; n < PyList_GET_SIZE(pViewLists[l]); ++n)
+            {
+                PyObject *pView = PyList_GET_ITEM(pViewLists[l], n);
+                if(pView == NULL)
+                {
+                    continue;
+                }
+                // numpy keeps a reference to the memoryview rather than holding its buffer
+                // so an array which is still in use is found from the reference count.
+                if(Py_REFCNT(pView) > 1)
+                {
+                    released = false;
+                }
+                PyObject *pResult = PyObject_CallMethod(pView, "release", NULL);
+                if(pResult == NULL)
+                {
+                    released = false;
+                    PyErr_Clear();
+                }
+                Py_XDECREF(pResult);
+            }
+            Py_DECREF(pViewLists[l]);
+        }
+        if(funcOK && !released)
+        {
+            funcOK = false;
+            PyErr_SetString(pErrorObj, "The arrays for an image block must not be kept once the block function has returned.");
+            PyErr_Fetch(&blockFuncError.type, &blockFuncError.value, &blockFuncError.traceback);
+        }
+        
+        PyGILState_Release(gilState);
+        
+        if(!funcOK)
+        {
+            throw rsgis::cmds::RSGISCmdException("Error within the Python block function.");
+        }
+    };
+    
+    std::string cmdErrorMsg;
+    bool cmdFailed = false;
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+        rsgis::cmds::executeCalcImageBlocks(inputImgs, std::string(pszOutputImage), std::string(pszGDALFormat), (rsgis::RSGISLibDataType)nDataType, numOutBands, blockFunc);
+    }
+    catch(rsgis::cmds::RSGISCmdException &e)
+    {
+        cmdFailed = true;
+        cmdErrorMsg = e.what();
+    }
+    Py_END_ALLOW_THREADS
+    
+    if(blockFuncError.type != NULL)
+    {
+        // Raise the error from the block function itself rather than a generic message.
+        PyErr_Restore(blockFuncError.type, blockFuncError.value, blockFuncError.traceback);
+        return NULL;
+    }
+    if(cmdFailed)
+    {
+        PyErr_SetString(GETSTATE(self)->error, cmdErrorMsg.c_str());
+        return NULL;
+    }
+    
+    Py_RETURN_NONE;
+#else
+    PyErr_SetString(GETSTATE(self)->error, "calcImageBlockBuffers requires Python 3");
+    return NULL;
+#endif
+}
+
 // Our list of functions in this module
 static PyMethodDef ImageCalcMethods[] = {
     {"bandMath", (PyCFunction)ImageCalc_BandMath, METH_VARARGS | METH_KEYWORDS,
@@ -2175,8 +2444,8 @@ static PyMethodDef ImageCalcMethods[] = {
 "\n"
 "\n"},
 
-{"kMeansClustering", ImageCalc_KMeansClustering, METH_VARARGS,
-"rsgislib.imagecalc.kMeansClustering(inputImage, outputMatrix, numClusters, maxIterations, subSample, ignoreZeros, degreeOfChange, initMethod)\n"
+{"kMeansClustering", (PyCFunction)ImageCalc_KMeansClustering, METH_VARARGS | METH_KEYWORDS,
+"rsgislib.imagecalc.kMeansClustering(inputImage, outputMatrix, numClusters, maxIterations, subSample, ignoreZeros, degreeOfChange, initMethod, miniBatchSize=0)\n"
 "Performs K Means Clustering and saves cluster centres to a text file.\n"
 "\n"
 "Where:\n"
@@ -2189,6 +2458,7 @@ static PyMethodDef ImageCalcMethods[] = {
 ":param ignoreZeros: is a bool specifying if zeros in the image should be treated as no data.\n"
 ":param degreeofChange: is a float providing the minimum change between itterations before terminating.\n"
 ":param initMethod: the method for initialising the clusters and is one of INITCLUSTER_* values\n"
+":param miniBatchSize: is an optional int. If greater than 0 (and less than the number of sampled pixels) each iteration updates the centres using a random batch of this many pixels (mini-batch k-means), terminating when the proportion of the batch changing cluster is less than degreeofChange. The final centres are then calculated from all the sampled pixels. (Default = 0; i.e., all the pixels are used on every iteration).\n"
 "\n"
 "Example::\n"
 "\n"
@@ -2657,7 +2927,6 @@ static PyMethodDef ImageCalcMethods[] = {
 "\n"
 "\n"
 },
-/*
 {"nnConSum1LinearSpecUnmix", ImageCalc_NnConSum1LinearSpecUnmix, METH_VARARGS,
 "rsgislib.imagecalc.nnConSum1LinearSpecUnmix(inputImage, gdalformat, datatype, lsumWeight, outputFile, endmembersFile, lsumGain, lsumOffset)\n"
 "Performs a constrained linear spectral unmixing of the input image for a set of endmembers where the sum of the unmixing will be approximately 1 and non-negative.\n"
@@ -2675,8 +2944,23 @@ static PyMethodDef ImageCalcMethods[] = {
 ":param lsumGain: is a float specifying a gain which can be applied to the output pixel values (outvalue = offset + (gain * value)). Optional, default = 1.\n"
 ":param lsumOffset: is a float specifying an offset which can be applied to the output pixel values (outvalue = offset + (gain * value)). Optional, default = 0.\n"
 "\n"
+"The non-negative least squares is solved for each pixel using the normal equations of the endmembers, which are\n"
+"calculated once, and is started from the solution of the previous pixel. The image is processed on the number\n"
+"of threads set using rsgislib.imagecalc.setNumThreads.\n"
+"\n"
+"Example::\n"
+"\n"
+"    import rsgislib.imagecalc\n"
+"    import rsgislib\n"
+"\n"
+"    imageLSImage = \"./LS8_20130519_lat52lon42_r24p204_rad_srefstdmdl.kea\"\n"
+"    unmixedImage = \"./LS8_20130519_lat52lon42_r24p204_rad_srefstdmdl_nnunmix.kea\"\n"
+"    endmembersFile = \"./endmembers.mtxt\"\n"
+"    lsumWeight = 40\n"
+"\n"
+"    rsgislib.imagecalc.nnConSum1LinearSpecUnmix(imageLSImage, \"KEA\", rsgislib.TYPE_32FLOAT, lsumWeight, unmixedImage, endmembersFile, 1.0, 0.0)\n"
+"\n"
 },
-*/
 {"allBandsEqualTo", ImageCalc_AllBandsEqualTo, METH_VARARGS,
 "rsgislib.imagecalc.allBandsEqualTo(inputImage, imgValue, outputTrueVal, outputFalseVal, outputImage, gdalformat, datatype)\n"
 "Tests whether all bands are equal to the same value\n"
@@ -2727,8 +3011,8 @@ static PyMethodDef ImageCalcMethods[] = {
 "\n"
 },
 
-{"bandPercentile", ImageCalc_BandPercentile, METH_VARARGS,
-"rsgislib.imagecalc.bandPercentile(inputImage, percentile, noDataValue)\n"
+{"bandPercentile", (PyCFunction)ImageCalc_BandPercentile, METH_VARARGS | METH_KEYWORDS,
+"rsgislib.imagecalc.bandPercentile(inputImage, percentile, noDataValue, method=rsgislib.PERCENTILE_EXACT, sketchk=200)\n"
 "Calculates image band percentiles for the input image and results a list of values\n"
 "\n"
 "Where:\n"
@@ -2736,6 +3020,11 @@ static PyMethodDef ImageCalcMethods[] = {
 ":param inputImage: is a string containing the name of the input image file\n"
 ":param percentile: is a float between 0 -- 1 specifying the percentile to be calculated.\n"
 ":param noDataValue: is a float specifying the value used to represent no data (used None when no value is to be specified).\n"
+":param method: is an optional (default = rsgislib.PERCENTILE_EXACT) int specifying how the percentiles are calculated:\n"
+"        * rsgislib.PERCENTILE_EXACT: two passes over the image, using histograms of the pixel values, so the image is not read into memory.\n"
+"        * rsgislib.PERCENTILE_SKETCH: one pass over the image using a quantile sketch for each band; the accuracy is set by sketchk.\n"
+"        The passes are split between the threads set by setNumThreads; for PERCENTILE_EXACT each thread holds about 256 KB of counts per band (e.g., 50 MB for 200 bands).\n"
+":param sketchk: is an optional (default = 200) integer specifying the size of the sketches. The rank error is about 1.65% for a sketchk of 200 and scales with 1/sketchk.\n"
 "\n"
 ":return: list of floats\n"
 "\n"
@@ -3117,6 +3406,106 @@ static PyMethodDef ImageCalcMethods[] = {
 ":return: float with mean value.\n"
 "\n"},
 
+{"setNumThreads", (PyCFunction)ImageCalc_SetNumThreads, METH_VARARGS | METH_KEYWORDS,
+"rsgislib.imagecalc.setNumThreads(nthreads)\n"
+"Sets the number of threads used to process image blocks within the image calculation\n"
+"functions (e.g., image statistics and rescaling). Functions which do not support parallel\n"
+"processing will continue to use a single thread. The default is 1 thread.\n"
+"\n"
+"Where:\n"
+"\n"
+":param nthreads: is an unsigned int specifying the number of threads (0 = number of cores on the machine).\n"
+"\n"
+"Example::\n"
+"\n"
+"   from rsgislib import imagecalc\n"
+"   imagecalc.setNumThreads(8)\n"
+"\n"},
+
+{"getNumThreads", ImageCalc_GetNumThreads, METH_NOARGS,
+"rsgislib.imagecalc.getNumThreads()\n"
+"Gets the number of threads used to process image blocks within the image calculation functions.\n"
+"\n"
+":return: unsigned int with the number of threads.\n"
+"\n"},
+
+{"setPipelinedIO", (PyCFunction)ImageCalc_SetPipelinedIO, METH_VARARGS | METH_KEYWORDS,
+"rsgislib.imagecalc.setPipelinedIO(pipeline=True)\n"
+"Sets whether, when processing on a single thread, the next image block is read and the\n"
+"previous block written on separate threads while the current block is calculated. This\n"
+"hides the I/O latency (e.g., on network file systems) for simple per-pixel calculations.\n"
+"The default is False.\n"
+"\n"
+"Where:\n"
+"\n"
+":param pipeline: is a boolean specifying whether the pipelined I/O should be used.\n"
+"\n"
+"Example::\n"
+"\n"
+"   from rsgislib import imagecalc\n"
+"   imagecalc.setPipelinedIO(True)\n"
+"\n"},
+
+{"getPipelinedIO", ImageCalc_GetPipelinedIO, METH_NOARGS,
+"rsgislib.imagecalc.getPipelinedIO()\n"
+"Gets whether pipelined reading and writing of image blocks is used within the image calculation functions.\n"
+"\n"
+":return: boolean\n"
+"\n"},
+
+{"setImageBlockCacheSize", (PyCFunction)ImageCalc_SetImageBlockCacheSize, METH_VARARGS | METH_KEYWORDS,
+"rsgislib.imagecalc.setImageBlockCacheSize(size_mb)\n"
+"Sets the memory used to keep the image blocks read by the image calculation functions\n"
+"(and the raster GIS functions which use them) so a sequence of operations over the same\n"
+"input images within a script only reads the data from disk once. When full, the least\n"
+"recently used blocks are removed. Images which have been changed are re-read, and images\n"
+"open for writing and VRTs (whose source images could change) are not cached. The default\n"
+"is 0 (off).\n"
+"\n"
+"Where:\n"
+"\n"
+":param size_mb: is an unsigned int specifying the memory (MB) used for the cache (0 = off).\n"
+"\n"
+"Example::\n"
+"\n"
+"   from rsgislib import imagecalc\n"
+"   imagecalc.setImageBlockCacheSize(4096)\n"
+"   # ... image statistics, stretch, classification, etc.\n"
+"   print(imagecalc.getImageBlockCacheStats())\n"
+"\n"},
+
+{"getImageBlockCacheStats", ImageCalc_GetImageBlockCacheStats, METH_NOARGS,
+"rsgislib.imagecalc.getImageBlockCacheStats()\n"
+"Gets the size of the image block cache and the number of blocks read from the cache (hits)\n"
+"and from disk (misses).\n"
+"\n"
+":return: dict with keys 'size_mb', 'used_mb', 'hits' and 'misses'.\n"
+"\n"},
+
+{"clearImageBlockCache", ImageCalc_ClearImageBlockCache, METH_NOARGS,
+"rsgislib.imagecalc.clearImageBlockCache()\n"
+"Removes all the blocks from the image block cache and resets the hit and miss counts.\n"
+"\n"},
+
+{"calcImageBlockBuffers", (PyCFunction)ImageCalc_CalcImageBlockBuffers, METH_VARARGS | METH_KEYWORDS,
+"rsgislib.imagecalc.calcImageBlockBuffers(inputimgs, outputimg, gdalformat, datatype, numoutbands, blockfunc)\n"
+"Calls a function for each block of rows of the input images, passing the image buffers\n"
+"as memoryviews (i.e., without copying). Use rsgislib.imagecalc.calcImageBlocks to have\n"
+"the blocks passed as numpy arrays.\n"
+"\n"
+"Where:\n"
+"\n"
+":param inputimgs: is a list of input image files, the bands of which are stacked in order.\n"
+":param outputimg: is a string containing the name of the output file.\n"
+":param gdalformat: is a string containing the GDAL format for the output file - eg 'KEA'.\n"
+":param datatype: is an int containing one of the values from rsgislib.TYPE_*.\n"
+":param numoutbands: is an unsigned int with the number of output image bands.\n"
+":param blockfunc: is a function called as blockfunc(inbufs, outbufs, width, nrows, yoff) where inbufs is a list\n"
+"                  of read-only memoryviews of float32 values (one per input band), outbufs is a list of writable\n"
+"                  memoryviews of float64 values (one per output band) and the block is nrows rows of width pixels\n"
+"                  starting at row yoff. The buffers are only valid until blockfunc returns.\n"
+"\n"},
+
 {NULL}        /* Sentinel */
 };
 
@@ -69,7 +69,7 @@ static PyObject *ImageFilter_Filter(PyObject *self, PyObject *args)
         rsgis::cmds::RSGISFilterParameters *cmdObj = new rsgis::cmds::RSGISFilterParameters();   // the c++ object we need to pass pointers of
 
         // declare and initialise pointers for all the attributes of the struct
-        PyObject *pFilterType, *pFileEnding, *pSize, *pOption, *pNLooks, *pStdDev, *pStdDevX , *pStdDevY, *pAngle = NULL;
+        PyObject *pFilterType, *pFileEnding, *pSize, *pOption, *pNLooks, *pPercentile, *pStdDev, *pStdDevX , *pStdDevY, *pAngle = NULL;
 
         std::vector<PyObject*> extractedAttributes;     // store a list of extracted pyobjects to dereference
         extractedAttributes.push_back(o);
@@ -146,6 +146,25 @@ static PyObject *ImageFilter_Filter(PyObject *self, PyObject *args)
             std::cout << "nLooks = " << cmdObj->nLooks << " ";
         }
 
+        pPercentile = PyObject_GetAttrString(o, "percentile");
+        extractedAttributes.push_back(pPercentile);
+        if( !(pPercentile == NULL) & (RSGISPY_CHECK_FLOAT(pPercentile) | RSGISPY_CHECK_INT(pPercentile)) )
+        {
+            cmdObj->percentile = RSGISPY_FLOAT_EXTRACT(pPercentile);
+            std::cout << "percentile = " << cmdObj->percentile << " ";
+        }
+        else if(cmdObj->type == "Percentile")
+        {
+            PyErr_SetString(GETSTATE(self)->error, "Need to provide 'percentile' for the Percentile filter" );
+            FreePythonObjects(extractedAttributes);
+            for(std::vector<rsgis::cmds::RSGISFilterParameters*>::iterator iter = filterParameters->begin(); iter != filterParameters->end(); ++iter) 
+            {
+                delete *iter;
+            }
+            delete cmdObj;
+            return NULL;
+        }
+
         pStdDev = PyObject_GetAttrString(o, "stddev");
         extractedAttributes.push_back(pStdDev);
         if( !(pStdDev == NULL) & (RSGISPY_CHECK_FLOAT(pStdDev) | RSGISPY_CHECK_INT(pStdDev)) )
@@ -280,6 +299,7 @@ static PyMethodDef ImageFilterMethods[] = {
 "   filters.append(imagefilter.FilterParameters(filterType = 'Prewitt', fileEnding = 'prewittxy', option = 'xy') )\n"
 "   filters.append(imagefilter.FilterParameters(filterType = 'Mean', fileEnding = 'mean', size=3) )\n"
 "   filters.append(imagefilter.FilterParameters(filterType = 'Median', fileEnding = 'median', size=3) )\n"
+"   filters.append(imagefilter.FilterParameters(filterType = 'Percentile', fileEnding = 'pc90', size=3, percentile=90) )\n"
 "   filters.append(imagefilter.FilterParameters(filterType = 'Mode', fileEnding = 'mode', size=3) )\n"
 "   filters.append(imagefilter.FilterParameters(filterType = 'StdDev', fileEnding = 'stddev', size=3) )\n"
 "   filters.append(imagefilter.FilterParameters(filterType = 'Range', fileEnding = 'range', size=3) )\n"
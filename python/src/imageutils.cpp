@@ -828,16 +828,26 @@ static PyObject *ImageUtils_AssignSpatialInfo(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
-static PyObject *ImageUtils_ExtractZoneImageValues2HDF(PyObject *self, PyObject *args)
+static PyObject *ImageUtils_ExtractZoneImageValues2HDF(PyObject *self, PyObject *args, PyObject *keywds)
 {
+    static char *kwlist[] = {"inputImage", "imageMask", "outputHDF", "maskValue", "datatype", "sample", "seed", "compress", NULL};
     const char *pszInputImage;
     const char *pszInputMaskImage;
     const char *pszOutputFile;
     float maskValue = 0;
     int nDataType = 9;
+    int sampleSize = 0;
+    int seed = 0;
+    int compress = true;
+    
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssf|iiii:extractZoneImageValues2HDF", kwlist, &pszInputImage, &pszInputMaskImage, &pszOutputFile, &maskValue, &nDataType, &sampleSize, &seed, &compress))
+    {
+        return NULL;
+    }
     
-    if( !PyArg_ParseTuple(args, "sssf|i:extractZoneImageValues2HDF", &pszInputImage, &pszInputMaskImage, &pszOutputFile, &maskValue, &nDataType))
+    if(sampleSize < 0)
     {
+        PyErr_SetString(PyExc_ValueError, "sample must be 0 (all pixels) or greater.");
         return NULL;
     }
     
@@ -845,7 +855,7 @@ static PyObject *ImageUtils_ExtractZoneImageValues2HDF(PyObject *self, PyObject
     
     try
     {
-        rsgis::cmds::executeImageRasterZone2HDF(std::string(pszInputImage), std::string(pszInputMaskImage), std::string(pszOutputFile), maskValue, type);
+        rsgis::cmds::executeImageRasterZone2HDF(std::string(pszInputImage), std::string(pszInputMaskImage), std::string(pszOutputFile), maskValue, type, sampleSize, seed, (bool)compress);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -856,16 +866,26 @@ static PyObject *ImageUtils_ExtractZoneImageValues2HDF(PyObject *self, PyObject
     Py_RETURN_NONE;
 }
 
-static PyObject *ImageUtils_ExtractZoneImageBandValues2HDF(PyObject *self, PyObject *args)
+static PyObject *ImageUtils_ExtractZoneImageBandValues2HDF(PyObject *self, PyObject *args, PyObject *keywds)
 {
+    static char *kwlist[] = {"inputImageInfo", "imageMask", "outputHDF", "maskValue", "datatype", "sample", "seed", "compress", NULL};
     PyObject *inputImageFileInfoObj;
     const char *pszInputMaskImage;
     const char *pszOutputFile;
     float maskValue = 0;
     int nDataType = 9;
+    int sampleSize = 0;
+    int seed = 0;
+    int compress = true;
+    
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "Ossf|iiii:extractZoneImageBandValues2HDF", kwlist, &inputImageFileInfoObj, &pszInputMaskImage, &pszOutputFile, &maskValue, &nDataType, &sampleSize, &seed, &compress))
+    {
+        return NULL;
+    }
     
-    if( !PyArg_ParseTuple(args, "Ossf|i:extractZoneImageBandValues2HDF", &inputImageFileInfoObj, &pszInputMaskImage, &pszOutputFile, &maskValue, &nDataType))
+    if(sampleSize < 0)
     {
+        PyErr_SetString(PyExc_ValueError, "sample must be 0 (all pixels) or greater.");
         return NULL;
     }
     
@@ -938,7 +958,7 @@ static PyObject *ImageUtils_ExtractZoneImageBandValues2HDF(PyObject *self, PyObj
     
     try
     {
-        rsgis::cmds::executeImageBandRasterZone2HDF(imageFilesInfo, std::string(pszInputMaskImage), std::string(pszOutputFile), maskValue, type);
+        rsgis::cmds::executeImageBandRasterZone2HDF(imageFilesInfo, std::string(pszInputMaskImage), std::string(pszOutputFile), maskValue, type, sampleSize, seed, (bool)compress);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -2147,6 +2167,7 @@ static PyMethodDef ImageUtilsMethods[] = {
 ":param stretchtype: is a STRETCH_* value providing the type of stretch, options are:\n"
 "        * imageutils.STRETCH_LINEARMINMAX - Stretches between min and max.\n"
 "        * imageutils.STRETCH_LINEARPERCENT - Stretches between percentage of image range. Parameter defines percent.\n"
+"        * imageutils.STRETCH_LINEARPERCENTILE - Stretches between the percentiles of the image values (i.e., percent and 100-percent). Parameter defines percent.\n"
 "        * imageutils.STRETCH_LINEARSTDDEV - Stretches between mean - sd to mean + sd. Parameter defines number of standard deviations.\n"
 "        * imageutils.STRETCH_EXPONENTIAL - Exponential stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
 "        * imageutils.STRETCH_LOGARITHMIC - Logarithmic stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
@@ -2181,6 +2202,7 @@ static PyMethodDef ImageUtilsMethods[] = {
 ":param stretchtype: is a STRETCH_* value providing the type of stretch, options are:\n"
 "        * imageutils.STRETCH_LINEARMINMAX - Stretches between min and max.\n"
 "        * imageutils.STRETCH_LINEARPERCENT - Stretches between percentage of image range. Parameter defines percent.\n"
+"        * imageutils.STRETCH_LINEARPERCENTILE - Stretches between the percentiles of the image values (i.e., percent and 100-percent). Parameter defines percent.\n"
 "        * imageutils.STRETCH_LINEARSTDDEV - Stretches between mean - sd to mean + sd. Parameter defines number of standard deviations.\n"
 "        * imageutils.STRETCH_EXPONENTIAL - Exponential stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
 "        * imageutils.STRETCH_LOGARITHMIC - Logarithmic stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
@@ -2216,6 +2238,7 @@ static PyMethodDef ImageUtilsMethods[] = {
 ":param stretchtype: is a STRETCH_* value providing the type of stretch, options are:\n"
 "        * imageutils.STRETCH_LINEARMINMAX - Stretches between min and max.\n"
 "        * imageutils.STRETCH_LINEARPERCENT - Stretches between percentage of image range. Parameter defines percent.\n"
+"        * imageutils.STRETCH_LINEARPERCENTILE - Stretches between the percentiles of the image values (i.e., percent and 100-percent). Parameter defines percent.\n"
 "        * imageutils.STRETCH_LINEARSTDDEV - Stretches between mean - sd to mean + sd. Parameter defines number of standard deviations.\n"
 "        * imageutils.STRETCH_EXPONENTIAL - Exponential stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
 "        * imageutils.STRETCH_LOGARITHMIC - Logarithmic stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
@@ -2253,6 +2276,7 @@ static PyMethodDef ImageUtilsMethods[] = {
 ":param stretchtype: is a STRETCH_* value providing the type of stretch, options are:\n"
 "        * imageutils.STRETCH_LINEARMINMAX - Stretches between min and max.\n"
 "        * imageutils.STRETCH_LINEARPERCENT - Stretches between percentage of image range. Parameter defines percent.\n"
+"        * imageutils.STRETCH_LINEARPERCENTILE - Stretches between the percentiles of the image values (i.e., percent and 100-percent). Parameter defines percent.\n"
 "        * imageutils.STRETCH_LINEARSTDDEV - Stretches between mean - sd to mean + sd. Parameter defines number of standard deviations.\n"
 "        * imageutils.STRETCH_EXPONENTIAL - Exponential stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
 "        * imageutils.STRETCH_LOGARITHMIC - Logarithmic stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
@@ -2293,6 +2317,7 @@ static PyMethodDef ImageUtilsMethods[] = {
 ":param stretchtype: is a STRETCH_* value providing the type of stretch, options are:\n"
 "        * imageutils.STRETCH_LINEARMINMAX - Stretches between min and max.\n"
 "        * imageutils.STRETCH_LINEARPERCENT - Stretches between percentage of image range. Parameter defines percent.\n"
+"        * imageutils.STRETCH_LINEARPERCENTILE - Stretches between the percentiles of the image values (i.e., percent and 100-percent). Parameter defines percent.\n"
 "        * imageutils.STRETCH_LINEARSTDDEV - Stretches between mean - sd to mean + sd. Parameter defines number of standard deviations.\n"
 "        * imageutils.STRETCH_EXPONENTIAL - Exponential stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
 "        * imageutils.STRETCH_LOGARITHMIC - Logarithmic stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
@@ -2594,8 +2619,8 @@ static PyMethodDef ImageUtilsMethods[] = {
 ":param rotY: is a double representing Y rotation of the image.\n"
 "\n"},
     
-{"extractZoneImageValues2HDF", ImageUtils_ExtractZoneImageValues2HDF, METH_VARARGS,
-"rsgislib.imageutils.extractZoneImageValues2HDF(inputImage, imageMask, outputHDF, maskValue, datatype)\n"
+{"extractZoneImageValues2HDF", (PyCFunction)ImageUtils_ExtractZoneImageValues2HDF, METH_VARARGS | METH_KEYWORDS,
+"rsgislib.imageutils.extractZoneImageValues2HDF(inputImage, imageMask, outputHDF, maskValue, datatype, sample=0, seed=0, compress=True)\n"
 "Extract the all the pixel values for raster regions to a HDF5 file (1 column for each image band).\n"
 "\n"
 "Where:\n"
@@ -2605,10 +2630,13 @@ static PyMethodDef ImageUtilsMethods[] = {
 ":param outputHDF: is a string containing the name and path of the output HDF5 file\n"
 ":param maskValue: is a float containing the value of the pixel within the mask for which values are to be extracted\n"
 ":param datatype: is a rsgislib.TYPE_* value providing the data type of the output image.\n"
+":param sample: is an optional integer (default = 0). If greater than 0 a uniform random sample of this many pixels (reservoir sampling, so in a single pass) is written rather than all the pixels within the mask.\n"
+":param seed: is an optional integer (default = 0) seed for the random sampling.\n"
+":param compress: is an optional boolean (default = True) specifying whether the chunks of the output HDF5 dataset are compressed.\n"
 "\n"},
     
-{"extractZoneImageBandValues2HDF", ImageUtils_ExtractZoneImageBandValues2HDF, METH_VARARGS,
-"rsgislib.imageutils.extractZoneImageBandValues2HDF(inputImageInfo, imageMask, outputHDF, maskValue, datatype)\n"
+{"extractZoneImageBandValues2HDF", (PyCFunction)ImageUtils_ExtractZoneImageBandValues2HDF, METH_VARARGS | METH_KEYWORDS,
+"rsgislib.imageutils.extractZoneImageBandValues2HDF(inputImageInfo, imageMask, outputHDF, maskValue, datatype, sample=0, seed=0, compress=True)\n"
 "Extract the all the pixel values for raster regions to a HDF5 file (1 column for each image band).\n"
 "Multiple input rasters can be provided and the bands extracted selected.\n"
 "\n"
@@ -2619,6 +2647,9 @@ static PyMethodDef ImageUtilsMethods[] = {
 ":param outputHDF: is a string containing the name and path of the output HDF5 file\n"
 ":param maskValue: is a float containing the value of the pixel within the mask for which values are to be extracted\n"
 ":param datatype: is a rsgislib.TYPE_* value providing the data type of the output image.\n"
+":param sample: is an optional integer (default = 0). If greater than 0 a uniform random sample of this many pixels (reservoir sampling, so in a single pass) is written rather than all the pixels within the mask.\n"
+":param seed: is an optional integer (default = 0) seed for the random sampling.\n"
+":param compress: is an optional boolean (default = True) specifying whether the chunks of the output HDF5 dataset are compressed.\n"
 "\n"
 "Example::\n"
 "\n"
@@ -3320,6 +3351,7 @@ init_imageutils(void)
     PyModule_AddIntConstant(pModule, "STRETCH_EXPONENTIAL", rsgis::cmds::exponential);
     PyModule_AddIntConstant(pModule, "STRETCH_LOGARITHMIC", rsgis::cmds::logarithmic);
     PyModule_AddIntConstant(pModule, "STRETCH_POWERLAW", rsgis::cmds::powerLaw);
+    PyModule_AddIntConstant(pModule, "STRETCH_LINEARPERCENTILE", rsgis::cmds::linearPercentile);
 
 #if PY_MAJOR_VERSION >= 3
     return pModule;
@@ -333,13 +333,23 @@ static PyObject *RasterGIS_PopulateRATWithPercentiles(PyObject *self, PyObject *
     unsigned int ratBand = 1;
     unsigned int band = 1;
     unsigned int numHistBins = 200;
-    static char *kwlist[] = {"valsimage", "clumps", "band", "bandstats", "histbins", "ratband", NULL};
+    int method = rsgis::cmds::rsgisPercentileHistogram;
+    unsigned int sketchK = 200;
+    unsigned int maxMemMB = 1024;
+    const char *tmpDIR = "";
+    static char *kwlist[] = {"valsimage", "clumps", "band", "bandstats", "histbins", "ratband", "method", "sketchk", "maxmem", "tmpdir", NULL};
 
-    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ssIO|II:populateRATWithPercentiles", kwlist, &inputImage, &clumpsImage, &band, &pBandPercentilesCmds, &numHistBins, &ratBand))
+    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ssIO|IIiIIs:populateRATWithPercentiles", kwlist, &inputImage, &clumpsImage, &band, &pBandPercentilesCmds, &numHistBins, &ratBand, &method, &sketchK, &maxMemMB, &tmpDIR))
     {
         return NULL;
     }
 
+    if((method < rsgis::cmds::rsgisPercentileHistogram) || (method > rsgis::cmds::rsgisPercentileExact))
+    {
+        PyErr_SetString(GETSTATE(self)->error, "method must be one of rsgislib.PERCENTILE_HISTOGRAM, rsgislib.PERCENTILE_SKETCH or rsgislib.PERCENTILE_EXACT");
+        return NULL;
+    }
+
     if(!PySequence_Check(pBandPercentilesCmds))
     {
         PyErr_SetString(GETSTATE(self)->error, "bandstats argument must be a sequence");
@@ -401,7 +411,7 @@ static PyObject *RasterGIS_PopulateRATWithPercentiles(PyObject *self, PyObject *
 
     try
     {
-        rsgis::cmds::executePopulateRATWithPercentiles(std::string(inputImage), std::string(clumpsImage), band, &bandPercentilesCmds, ratBand, numHistBins);
+        rsgis::cmds::executePopulateRATWithPercentiles(std::string(inputImage), std::string(clumpsImage), band, &bandPercentilesCmds, ratBand, numHistBins, (rsgis::cmds::rsgisPercentileMethodCmd)method, sketchK, maxMemMB, std::string(tmpDIR));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
     {
@@ -1261,8 +1271,10 @@ static PyObject *RasterGIS_InterpolateClumpValues2Img(PyObject *self, PyObject *
     const char *clumpsImage, *selectField, *eastingsField, *northingsField, *methodStr, *valueField, *outputFile, *imageFormat;
     int dataType, ratBand;
     ratBand = 1;
+    unsigned int idwK = 12;
+    float idwP = 2;
 
-    if(!PyArg_ParseTuple(args, "ssssssssi|i:interpolateClumpValues2Image", &clumpsImage, &selectField, &eastingsField, &northingsField, &methodStr, &valueField, &outputFile, &imageFormat, &dataType, &ratBand))
+    if(!PyArg_ParseTuple(args, "ssssssssi|iIf:interpolateClumpValues2Image", &clumpsImage, &selectField, &eastingsField, &northingsField, &methodStr, &valueField, &outputFile, &imageFormat, &dataType, &ratBand, &idwK, &idwP))
     {
         return NULL;
     }
@@ -1270,7 +1282,7 @@ static PyObject *RasterGIS_InterpolateClumpValues2Img(PyObject *self, PyObject *
     try
     {
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType) dataType;
-        rsgis::cmds::executeInterpolateClumpValuesToImage(std::string(clumpsImage), std::string(selectField), std::string(eastingsField), std::string(northingsField), std::string(methodStr), std::string(valueField), std::string(outputFile), std::string(imageFormat), type, ratBand);
+        rsgis::cmds::executeInterpolateClumpValuesToImage(std::string(clumpsImage), std::string(selectField), std::string(eastingsField), std::string(northingsField), std::string(methodStr), std::string(valueField), std::string(outputFile), std::string(imageFormat), type, ratBand, idwK, idwP);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
     {
@@ -1702,10 +1714,11 @@ static PyObject *RasterGIS_ApplyKNN(PyObject *self, PyObject *args, PyObject *ke
     float distThreshold = 100000;
     int distKNNInt = rsgis::cmds::rsgisKNNMahalanobis;
     int summeriseKNNInt = rsgis::cmds::rsgisKNNMean;
+    float approxEps = 0;
     
-    static char *kwlist[] = {"clumps", "inExtrapField", "outExtrapField", "trainRegionsField", "applyRegionsField", "fields", "kFeat", "distKNN", "summeriseKNN", "distThres", "ratband", NULL};
+    static char *kwlist[] = {"clumps", "inExtrapField", "outExtrapField", "trainRegionsField", "applyRegionsField", "fields", "kFeat", "distKNN", "summeriseKNN", "distThres", "ratband", "approxEps", NULL};
     
-    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ssssOO|IiifI:applyKNN", kwlist, &inClumpsImage, &inExtrapField, &outExtrapField, &trainRegionsField, &applyRegionsFieldObj, &pFields, &kFeatures, &distKNNInt, &summeriseKNNInt, &distThreshold, &ratBand))
+    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ssssOO|IiifIf:applyKNN", kwlist, &inClumpsImage, &inExtrapField, &outExtrapField, &trainRegionsField, &applyRegionsFieldObj, &pFields, &kFeatures, &distKNNInt, &summeriseKNNInt, &distThreshold, &ratBand, &approxEps))
     {
         return NULL;
     }
@@ -1735,7 +1748,7 @@ static PyObject *RasterGIS_ApplyKNN(PyObject *self, PyObject *args, PyObject *ke
         rsgis::cmds::rsgisKNNDistCmd distKNN = static_cast<rsgis::cmds::rsgisKNNDistCmd>(distKNNInt);
         rsgis::cmds::rsgisKNNSummeriseCmd summeriseKNN = static_cast<rsgis::cmds::rsgisKNNSummeriseCmd>(summeriseKNNInt);
         
-        rsgis::cmds::executeApplyKNN(std::string(inClumpsImage), ratBand, std::string(inExtrapField), std::string(outExtrapField), std::string(trainRegionsField), applyRegionsField, applyRegions, fields, kFeatures, distKNN, distThreshold, summeriseKNN);
+        rsgis::cmds::executeApplyKNN(std::string(inClumpsImage), ratBand, std::string(inExtrapField), std::string(outExtrapField), std::string(trainRegionsField), applyRegionsField, applyRegions, fields, kFeatures, distKNN, distThreshold, summeriseKNN, approxEps);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
     {
@@ -2163,7 +2176,7 @@ static PyMethodDef RasterGISMethods[] = {
 "\n"},
 
     {"populateRATWithPercentiles", (PyCFunction)RasterGIS_PopulateRATWithPercentiles, METH_VARARGS | METH_KEYWORDS,
-"rastergis.populateRATWithPercentiles(valsimage=string, clumps=string, band=int, bandstats=rsgislib.rastergis.BandAttStats, histbins=int, ratband=int)\n"
+"rastergis.populateRATWithPercentiles(valsimage=string, clumps=string, band=int, bandstats=rsgislib.rastergis.BandAttStats, histbins=int, ratband=int, method=int, sketchk=int, maxmem=int, tmpdir=string)\n"
 "Populates an attribute table with a percentile of the pixel values from an image.\n"
 "\n"
 "Where:\n"
@@ -2176,6 +2189,14 @@ static PyMethodDef RasterGISMethods[] = {
 "        * fieldName: string defining the name of the field to use for this percentile\n"
 ":param histbins: is an optional (default = 200) integer specifying the number of bins within the histogram (note this governs the accuracy to which percentile can be calculated).\n"
 ":param ratband: is an optional (default = 1) integer parameter specifying the image band to which the RAT is associated.\n"
+":param method: is an optional (default = rsgislib.PERCENTILE_HISTOGRAM) int specifying how the percentiles are calculated:\n"
+"        * rsgislib.PERCENTILE_HISTOGRAM: a histogram (histbins) for every row of the RAT, which needs rows x histbins x 4 bytes of memory.\n"
+"        * rsgislib.PERCENTILE_SKETCH: a quantile sketch for each clump with valid pixels; the accuracy is set by sketchk.\n"
+"        * rsgislib.PERCENTILE_EXACT: the pixel values are sorted by clump using at most maxmem MB of memory (plus 8 bytes per row), writing sorted runs to tmpdir.\n"
+":param sketchk: is an optional (default = 200) integer specifying the size of the sketches. Values are exact for clumps with fewer than sketchk\n"
+"        valid pixels, otherwise the rank error is about 1.65% for a sketchk of 200 and scales with 1/sketchk. Each sketch holds at most about 3 x sketchk values.\n"
+":param maxmem: is an optional (default = 1024) integer specifying the memory (in MB) used to sort the pixel values for the exact method.\n"
+":param tmpdir: is an optional string specifying the directory for the temporary files of the exact method (default is the system temporary directory).\n"
 "\n"
 "Example::\n"
 "\n"
@@ -2599,7 +2620,7 @@ static PyMethodDef RasterGISMethods[] = {
 "\n"},
 
 {"interpolateClumpValues2Image", RasterGIS_InterpolateClumpValues2Img, METH_VARARGS,
-"rsgislib.rastergis.interpolateClumpValues2Image(clumpsImage, selectField, eastingsField, northingsField, methodStr, valueField, outputFile, gdalformat, gdaltype, ratBand)\n"
+"rsgislib.rastergis.interpolateClumpValues2Image(clumpsImage, selectField, eastingsField, northingsField, methodStr, valueField, outputFile, gdalformat, gdaltype, ratBand, idwK, idwP)\n"
 "Interpolates values from clumps to the whole image of pixels.\n"
 "\n"
 "Where:\n"
@@ -2608,12 +2629,14 @@ static PyMethodDef RasterGISMethods[] = {
 ":param selectField: is a string which defines the column name where a value of 1 defines the clumps which will be included in the analysis.\n"
 ":param eastingsField: is a string which defines a column with a eastings for each clump.\n"
 ":param northingsField: is a string which defines a column with a northings for each clump.\n"
-":param methodStr: is a string which defines a column with a value for each clump which will be used for the distance, nearestneighbour or naturalneighbour or naturalnearestneighbour or knearestneighbour or idwall anaylsis.\n"
+":param methodStr: is a string which defines a column with a value for each clump which will be used for the distance, nearestneighbour or naturalneighbour or naturalnearestneighbour or knearestneighbour or idwall or idwknn (inverse distance weighting using the idwK nearest clumps) anaylsis.\n"
 ":param valueField: is a string which defines a column containing the values to be interpolated creating the new image.\n"
 ":param outputFile: is a string for the path to the output image file.\n"
 ":param gdalformat: is string defining the GDAL format of the output image.\n"
 ":param datatype: is an containing one of the values from rsgislib.TYPE_*\n"
-":param ratBand: is the image band with which the RAT is associated."
+":param ratBand: is the image band with which the RAT is associated.\n"
+":param idwK: is the number of nearest clumps used by the idwknn method (Default = 12).\n"
+":param idwP: is the power of the inverse distance weighting used by the idwknn method (Default = 2).\n"
 "\n"},
     
 
@@ -2851,7 +2874,7 @@ static PyMethodDef RasterGISMethods[] = {
 "\n"},
 
 {"applyKNN", (PyCFunction)RasterGIS_ApplyKNN, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.rastergis.applyKNN(clumps=string, inExtrapField=string, outExtrapField=string, trainRegionsField=string, applyRegionsField=string, fields=list<string>, kFeat=uint, distKNN=int, summeriseKNN=int, distThres=float, ratband=int)\n"
+"rsgislib.rastergis.applyKNN(clumps=string, inExtrapField=string, outExtrapField=string, trainRegionsField=string, applyRegionsField=string, fields=list<string>, kFeat=uint, distKNN=int, summeriseKNN=int, distThres=float, ratband=int, approxEps=float)\n"
 "This function uses the KNN algorithm to allow data values to be extrapolated to segments.\n"
 "\n"
 "Where:\n"
@@ -2867,6 +2890,7 @@ static PyMethodDef RasterGISMethods[] = {
 ":param summeriseKNN: specifies how the extrapolation value is calculated (rsgislib.SUMTYPE_MODE, rsgislib.SUMTYPE_MEAN, rsgislib.SUMTYPE_MEDIAN, rsgislib.SUMTYPE_MIN, rsgislib.SUMTYPE_MAX, rsgislib.SUMTYPE_STDDEV; Default: rsgislib.SUMTYPE_MEDIAN). Mode is used for classification.\n"
 ":param distThres: is a maximum distance threshold over which features will not be included within the \'k\'.\n"
 ":param ratband: is an optional (default = 1) integer parameter specifying the image band to which the RAT is associated.\n"
+":param approxEps: is an optional (default = 0) float; if greater than 0 an approximate nearest neighbour search is used where each neighbour is within a factor of (1+approxEps) of the distance to the true kth nearest neighbour (Euclidean, Manhattan and Mahalanobis distances only).\n"
 "\n"
 "Example::\n"
 "\n"
@@ -131,20 +131,22 @@ static PyObject *Segmentation_clump(PyObject *self, PyObject *args)
 }
 
 
-static PyObject *Segmentation_RMSmallClumpsStepwise(PyObject *self, PyObject *args)
+static PyObject *Segmentation_RMSmallClumpsStepwise(PyObject *self, PyObject *args, PyObject *keywds)
 {
+    static char *kwlist[] = {"inputimage", "clumpsimage", "outputimage", "gdalformat", "stretchstatsavail", "stretchstatsfile", "storemean", "processinmemory", "minclumpsize", "specThreshold", "userag", NULL};
     const char *pszInputImage, *pszClumpsImage, *pszOutputImage, *pszgdalformat, *pszStretchStatsFile;
     int storeMean,processInMemory,stretchStatsAvail;
+    int useRAG = false;
     unsigned int minClumpSize;
     float specThreshold;                   
-    if( !PyArg_ParseTuple(args, "ssssisiiIf:rmSmallClumpsStepwise", &pszInputImage, &pszClumpsImage, &pszOutputImage, &pszgdalformat,
-                    &stretchStatsAvail, &pszStretchStatsFile, &storeMean, &processInMemory, &minClumpSize, &specThreshold))            
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssssisiiIf|i:rmSmallClumpsStepwise", kwlist, &pszInputImage, &pszClumpsImage, &pszOutputImage, &pszgdalformat,
+                    &stretchStatsAvail, &pszStretchStatsFile, &storeMean, &processInMemory, &minClumpSize, &specThreshold, &useRAG))            
         return NULL;
     
     try
     {
         rsgis::cmds::executeRMSmallClumpsStepwise(pszInputImage, pszClumpsImage, pszOutputImage, pszgdalformat,
-                                stretchStatsAvail, pszStretchStatsFile, storeMean, processInMemory, minClumpSize, specThreshold);
+                                stretchStatsAvail, pszStretchStatsFile, storeMean, processInMemory, minClumpSize, specThreshold, useRAG);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -649,6 +651,82 @@ static PyObject *Segmentation_PxlGrowRegions(PyObject *self, PyObject *args)
 
 
 
+static PyObject *Segmentation_ShepherdSegmentation(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    const char *pszInputImage, *pszOutputClumps;
+    PyObject *pOutputMeanImg = Py_None;
+    const char *pszTmpPath = ".";
+    const char *pszgdalformat = "KEA";
+    int calcStats = true;
+    int noStretch = false;
+    unsigned int numClusters = 60;
+    unsigned int minPxls = 100;
+    float distThres = 100;
+    PyObject *pImageBands = Py_None;
+    unsigned int sampling = 100;
+    unsigned int kmMaxIter = 200;
+    int processInMem = false;
+    const char *pszInStretchStats = "";
+    const char *pszInKMeansCentres = "";
+    const char *pszOutStretchStats = "";
+    const char *pszOutKMeansCentres = "";
+    static char *kwlist[] = {"inputimg", "outputclumps", "outputmeanimg", "tmpath", "gdalformat", "calcstats", "nostretch", "numclusters", "minpxls", "distthres", "bands", "sampling", "kmmaxiter", "processinmem", "inimgstretchstats", "inkmeanscentres", "outimgstretchstats", "outkmeanscentres", NULL};
+    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ss|OssiiIIfOIIissss:shepherdSegmentation", kwlist, &pszInputImage, &pszOutputClumps, &pOutputMeanImg, &pszTmpPath, &pszgdalformat,
+                                    &calcStats, &noStretch, &numClusters, &minPxls, &distThres, &pImageBands, &sampling, &kmMaxIter, &processInMem,
+                                    &pszInStretchStats, &pszInKMeansCentres, &pszOutStretchStats, &pszOutKMeansCentres))
+    {
+        return NULL;
+    }
+    
+    std::string outputMeanImg = "";
+    if(pOutputMeanImg != Py_None)
+    {
+        if(!RSGISPY_CHECK_STRING(pOutputMeanImg))
+        {
+            PyErr_SetString(GETSTATE(self)->error, "outputmeanimg must be a string or None");
+            return NULL;
+        }
+        outputMeanImg = RSGISPY_STRING_EXTRACT(pOutputMeanImg);
+    }
+    
+    std::vector<unsigned int> imgBands;
+    if(pImageBands != Py_None)
+    {
+        if(!PySequence_Check(pImageBands))
+        {
+            PyErr_SetString(GETSTATE(self)->error, "bands must be a sequence of image bands (int) or None");
+            return NULL;
+        }
+        Py_ssize_t nBands = PySequence_Size(pImageBands);
+        for(Py_ssize_t i = 0; i < nBands; ++i)
+        {
+            PyObject *intObj = PySequence_GetItem(pImageBands, i);
+            if(!RSGISPY_CHECK_INT(intObj))
+            {
+                PyErr_SetString(GETSTATE(self)->error, "Bands must be integers");
+                Py_DECREF(intObj);
+                return NULL;
+            }
+            imgBands.push_back(RSGISPY_INT_EXTRACT(intObj));
+            Py_DECREF(intObj);
+        }
+    }
+    
+    try
+    {
+        rsgis::cmds::executeShepherdSegmentation(pszInputImage, pszOutputClumps, outputMeanImg, pszTmpPath, pszgdalformat, calcStats, noStretch, numClusters, minPxls, distThres,
+                                                 imgBands, sampling, kmMaxIter, processInMem, pszInStretchStats, pszInKMeansCentres, pszOutStretchStats, pszOutKMeansCentres);
+    }
+    catch(rsgis::cmds::RSGISCmdException &e)
+    {
+        PyErr_SetString(GETSTATE(self)->error, e.what());
+        return NULL;
+    }
+    
+    Py_RETURN_NONE;
+}
+
+
 // Our list of functions in this module
 static PyMethodDef SegmentationMethods[] = {
     {"labelPixelsFromClusterCentres", Segmentation_labelPixelsFromClusterCentres, METH_VARARGS, 
@@ -693,8 +771,8 @@ static PyMethodDef SegmentationMethods[] = {
 ":param addPxlVal2Rat: is a boolean specifying whether the pixel value (from inputimage) should be added as a RAT.\n"
 "\n"},
 
-    {"rmSmallClumpsStepwise", Segmentation_RMSmallClumpsStepwise, METH_VARARGS,
-"segmentation.rmSmallClumpsStepwise(inputimage, clumpsimage, outputimage, gdalformat, stretchstatsavail, stretchstatsfile, storemean, processinmemory, minclumpsize, specThreshold)\n"
+    {"rmSmallClumpsStepwise", (PyCFunction)Segmentation_RMSmallClumpsStepwise, METH_VARARGS | METH_KEYWORDS,
+"segmentation.rmSmallClumpsStepwise(inputimage, clumpsimage, outputimage, gdalformat, stretchstatsavail, stretchstatsfile, storemean, processinmemory, minclumpsize, specThreshold, userag=False)\n"
 "eliminate clumps smaller than a given size from the scene, small clumps will be combined with their spectrally closest neighbouring  clump in a stepwise fashion unless over spectral distance threshold\n"
 "\n"
 "Where:\n"
@@ -709,6 +787,9 @@ static PyMethodDef SegmentationMethods[] = {
 ":param processinmemory: is a bool specifying if processing should be carried out in memory (faster if sufficient RAM is available, set to False if unsure).\n"
 ":param minclumpsize: is an unsigned integer providing the minimum size for clumps.\n"
 ":param specThreshold: is a float providing the maximum (Euclidian distance) spectral separation for which to merge clumps. Set to a large value to ignore spectral separation and always merge.\n"
+":param userag: is an optional bool (default False) specifying that a region adjacency graph of the clumps is built in a single pass over the images and the clumps\n"
+"               are merged using the graph, with the output written in one pass. This gives the same result while using far less memory and I/O for large images.\n"
+"               The elimination is iterative if storemean is True, as it is without the graph.\n"
 "\n"},
 
     {"relabelClumps", Segmentation_relabelClumps, METH_VARARGS,
@@ -890,6 +971,40 @@ static PyMethodDef SegmentationMethods[] = {
 "    rsgislib.segmentation.pxlGrowRegions(tmpInitClearSkyRegionsFinal, tmpCloudsImgDist2CloudsNoData, tmpClearSkyRegionsGrow, 'KEA', muParseCriteria, varBandPairSeq)\n"
 "\n"},
     
+{"shepherdSegmentation", (PyCFunction)Segmentation_ShepherdSegmentation, METH_VARARGS | METH_KEYWORDS,
+"segmentation.shepherdSegmentation(inputimg, outputclumps, outputmeanimg=None, tmpath='.', gdalformat='KEA', calcstats=True, nostretch=False, numclusters=60, minpxls=100, distthres=100, bands=None, sampling=100, kmmaxiter=200, processinmem=False, inimgstretchstats='', inkmeanscentres='', outimgstretchstats='', outkmeanscentres='')\n"
+"Runs the segmentation algorithm of Shepherd et al. (2019) (as segutils.runShepherdSegmentation) within a single function call.\n"
+"The stretch is applied as the input image is read (sampling the pixels for the KMeans at the same time), the small clumps are\n"
+"eliminated using a region adjacency graph built directly from the clumps and the final relabelled clumps written in one pass,\n"
+"so the intermediate images are not written and read back between the steps.\n"
+"\n"
+"Where:\n"
+"\n"
+":param inputimg: is a string containing the name of the input file.\n"
+":param outputclumps: is a string containing the name of the output clump file.\n"
+":param outputmeanimg: is the output mean image file (clumps attributed with pixel mean from input image) - pass None to skip creating.\n"
+":param tmpath: is a file path for the intermediate images if they are not processed in memory (default is current directory); they are deleted once no longer required.\n"
+":param gdalformat: is a string containing the GDAL format for the output (and intermediate) files (default = KEA).\n"
+":param calcstats: is a bool specifying that the statistics, colour table and pyramids are built for the output clumps (default = True).\n"
+":param nostretch: is a bool which specifies that the input image bands should not be stretched (default = False).\n"
+":param numclusters: is an int which specifies the number of clusters within the KMeans clustering (default = 60).\n"
+":param minpxls: is an int which specifies the minimum number pixels within a segments (default = 100).\n"
+":param distthres: specifies the distance threshold for joining the segments (default = 100, set to large number to turn off this option).\n"
+":param bands: is a list providing a subset of image bands to use (default is None to use all bands).\n"
+":param sampling: specify the subsampling of the image for the data used within the KMeans (default = 100; 1 == no subsampling).\n"
+":param kmmaxiter: maximum iterations for KMeans.\n"
+":param processinmem: is a bool specifying that the intermediate images are held in memory rather than written to tmpath.\n"
+":param inimgstretchstats: is an optional file of pre-calculated stretch statistics (min-max stretch, as runShepherdSegmentationPreCalcdStats).\n"
+":param inkmeanscentres: is an optional file (.gmtxt) of pre-calculated KMeans cluster centres; if provided the pixels are labelled as the image is stretched.\n"
+":param outimgstretchstats: is an optional output file for the calculated stretch statistics.\n"
+":param outkmeanscentres: is an optional output file for the calculated KMeans centres (.gmtxt will be added to the end).\n"
+"\n"
+"Example::\n"
+"\n"
+"    import rsgislib.segmentation\n"
+"    rsgislib.segmentation.shepherdSegmentation('jers1palsar_stack.kea', 'jers1palsar_stack_clumps.kea', 'jers1palsar_stack_clumps_mean.kea', minpxls=100, processinmem=True)\n"
+"\n"},
+    
     
    
 
@@ -246,6 +246,53 @@ class RSGISTests:
         outputImage = path + "TestOutputs/ImageStats.txt"
         imagecalc.imageStats(inFileName, outputImage, True)
 
+    def testImageBandStatsMultiThreaded(self):
+        print("PYTHON TEST: imageBandStats - Using 4 threads")
+        outputImage = path + "TestOutputs/BandsStatsThreaded.txt"
+        imagecalc.setNumThreads(4)
+        try:
+            imagecalc.imageBandStats(inFileName, outputImage, False)
+        finally:
+            imagecalc.setNumThreads(1)
+
+    def testImageBandStatsPipelinedIO(self):
+        print("PYTHON TEST: imageBandStats - Using pipelined I/O")
+        outputImage = path + "TestOutputs/BandsStatsPipelined.txt"
+        imagecalc.setPipelinedIO(True)
+        try:
+            imagecalc.imageBandStats(inFileName, outputImage, False)
+        finally:
+            imagecalc.setPipelinedIO(False)
+
+    def testImageBlockCacheVRT(self):
+        print("PYTHON TEST: setImageBlockCacheSize - VRT source rewritten between reads")
+        srcImage = path + "TestOutputs/BlockCacheVRTSrc.tif"
+        vrtImage = path + "TestOutputs/BlockCacheVRT.vrt"
+        bandDefns = [BandDefn("b1", inFileName, 1)]
+        imagecalc.setImageBlockCacheSize(64)
+        try:
+            imagecalc.bandMath(srcImage, "(b1*0)+1", "GTiff", rsgislib.TYPE_32FLOAT, bandDefns)
+            imageutils.gdal_stack_images_vrt([srcImage], vrtImage)
+            minMax = imagecalc.getImageBandMinMax(vrtImage, 1)
+            if (minMax[0] != 1) or (minMax[1] != 1):
+                raise Exception('Incorrect min/max for the VRT. Expected (1, 1), got {}'.format(minMax))
+            imagecalc.bandMath(srcImage, "(b1*0)+2", "GTiff", rsgislib.TYPE_32FLOAT, bandDefns)
+            minMax = imagecalc.getImageBandMinMax(vrtImage, 1)
+            if (minMax[0] != 2) or (minMax[1] != 2):
+                raise Exception('Stale blocks read for the VRT after its source was rewritten. Expected (2, 2), got {}'.format(minMax))
+        finally:
+            imagecalc.setImageBlockCacheSize(0)
+            imagecalc.clearImageBlockCache()
+
+    def testCalcImageBlocks(self):
+        print("PYTHON TEST: calcImageBlocks")
+        outputImage = path + "TestOutputs/injune_p142_casi_sub_ll_blocksum.kea"
+        def sumBands(inblock, outblock, yoff):
+            outblock[0][...] = inblock[0]
+            for band in inblock[1:]:
+                outblock[0] += band
+        imagecalc.calcImageBlocks([inFileName], outputImage, "KEA", rsgislib.TYPE_32FLOAT, 1, sumBands)
+
     def testUnconLinearSpecUnmix(self):
         print("PYTHON TEST: unconLinearSpecUnmix - skipping due to lack of test data")
 
@@ -256,7 +303,33 @@ class RSGISTests:
         print("PYTHON TEST: ConSum1LinearSpecUnmix - skipping due to lack of test data")
 
     def testNnConSum1LinearSpecUnmix(self):
-        print("PYTHON TEST: NnConSum1LinearSpecUnmix - skipping due to lack of test data")
+        print("PYTHON TEST: NnConSum1LinearSpecUnmix")
+        # A synthetic image of a single spectrum mixed from three endmembers (the values
+        # previously used to check rsgis::math::RSGISNNLS) so the abundances are known.
+        endmembers = [[50.4,29.45,209.964], [81.85,65.45,244.321], [107.85,23.4,267.25],
+                      [177.1,112.8,278.679], [281.35,524.2,305.429], [324.2,653.25,299.036],
+                      [362.45,680.6,309.036], [394.55,692.25,303.036], [404.55,258.6,301.143],
+                      [237.25,114.35,273.643]]
+        abundances = [0.5, 0.2, 0.3]
+        endmembersFile = path + "TestOutputs/NNLSEndmembers.mtxt"
+        with open(endmembersFile, 'w') as f:
+            f.write("m={}\n".format(len(abundances)))
+            f.write("n={}\n".format(len(endmembers)))
+            f.write(",".join([str(val) for spectrum in endmembers for val in spectrum]) + "\n")
+        bandImages = []
+        for i, spectrum in enumerate(endmembers):
+            bandImage = path + "TestOutputs/NNLSMixBand{}.kea".format(i+1)
+            pxlVal = sum([val * abund for val, abund in zip(spectrum, abundances)])
+            imageutils.createCopyImage(inFileName, bandImage, 1, pxlVal, "KEA", rsgislib.TYPE_32FLOAT)
+            bandImages.append(bandImage)
+        mixedImage = path + "TestOutputs/NNLSMixed.kea"
+        imageutils.stackImageBands(bandImages, None, mixedImage, None, 0, "KEA", rsgislib.TYPE_32FLOAT)
+        outputImage = path + "TestOutputs/NNLSUnmixed.kea"
+        imagecalc.nnConSum1LinearSpecUnmix(mixedImage, "KEA", rsgislib.TYPE_32FLOAT, 1000, outputImage, endmembersFile)
+        for i, abund in enumerate(abundances):
+            minMax = imagecalc.getImageBandMinMax(outputImage, i+1)
+            if (abs(minMax[0] - abund) > 0.001) or (abs(minMax[1] - abund) > 0.001):
+                raise Exception('Incorrect abundance for endmember {}. Expected {}, got {}'.format(i+1, abund, minMax))
 
     def testKMeansCentres(self):
         # Only seems to do one iteration?
@@ -270,6 +343,17 @@ class RSGISTests:
         ignoreZeros = True
         imagecalc.kMeansClustering(inputImage, output, numClust, maxIter, subSample, ignoreZeros, degChange, rsgislib.INITCLUSTER_DIAGONAL_FULL_ATTACH)
 
+    def testKMeansCentresMiniBatch(self):
+        print("PYTHON TEST: kMeansClustering (mini-batch)")
+        inputImage = path + "Rasters/injune_p142_casi_sub_right_utm.kea"
+        output = path + "TestOutputs/kmeanscentres_minibatch"
+        numClust = 10
+        maxIter = 200
+        degChange = 0.0025
+        subSample = 1
+        ignoreZeros = True
+        imagecalc.kMeansClustering(inputImage, output, numClust, maxIter, subSample, ignoreZeros, degChange, rsgislib.INITCLUSTER_DIAGONAL_FULL_ATTACH, miniBatchSize=1000)
+
     def testIsoDataClustering(self):
         # Only seems to do one iteration?
         print("PYTHON TEST: isoDataClustering")
@@ -306,6 +390,15 @@ class RSGISTests:
         if int(outpercentiles[0]) != 2723:
             raise Exception('Incorrect percentile value returned. Expected 2723, got {}'.format(outpercentiles[0]))
 
+    def testBandPercentileSketch(self):
+        print("PYTHON TEST: Band Percentile (Sketch)")
+        image = path + "Rasters/injune_p142_casi_sub_right_utm.kea"
+        percentile = 0.25
+        nodata = 0
+        outpercentiles = imagecalc.bandPercentile(image, percentile, nodata, method=rsgislib.PERCENTILE_SKETCH, sketchk=400)
+        if abs(outpercentiles[0] - 2723) > 50:
+            raise Exception('Percentile value from sketch too far from the exact value. Expected about 2723, got {}'.format(outpercentiles[0]))
+
     def testMahalanobisDistWindow(self):
         print("PYTHON TEST: MahalanobisDistWindow")
         image = path + "Rasters/injune_p142_casi_sub_right_utm.kea"
@@ -432,6 +525,26 @@ class RSGISTests:
         bp.append(rastergis.BandAttPercentiles(percentile=75.0, fieldName="B1Per75"))
         rastergis.populateRATWithPercentiles(input, clumps, 1, bp)
 
+    def testPopulateRATWithPercentilesSketch(self):
+        print("PYTHON TEST: populateRATWithPercentiles (sketch)")
+        clumps = "./TestOutputs/RasterGIS/injune_p142_casi_sub_utm_segs_popstats.kea"
+        input = "./Rasters/injune_p142_casi_sub_utm.kea"
+        bp = []
+        bp.append(rastergis.BandAttPercentiles(percentile=25.0, fieldName="B1Per25Sk"))
+        bp.append(rastergis.BandAttPercentiles(percentile=50.0, fieldName="B1Per50Sk"))
+        bp.append(rastergis.BandAttPercentiles(percentile=75.0, fieldName="B1Per75Sk"))
+        rastergis.populateRATWithPercentiles(input, clumps, 1, bp, method=rsgislib.PERCENTILE_SKETCH, sketchk=200)
+
+    def testPopulateRATWithPercentilesExact(self):
+        print("PYTHON TEST: populateRATWithPercentiles (exact)")
+        clumps = "./TestOutputs/RasterGIS/injune_p142_casi_sub_utm_segs_popstats.kea"
+        input = "./Rasters/injune_p142_casi_sub_utm.kea"
+        bp = []
+        bp.append(rastergis.BandAttPercentiles(percentile=25.0, fieldName="B1Per25Ex"))
+        bp.append(rastergis.BandAttPercentiles(percentile=50.0, fieldName="B1Per50Ex"))
+        bp.append(rastergis.BandAttPercentiles(percentile=75.0, fieldName="B1Per75Ex"))
+        rastergis.populateRATWithPercentiles(input, clumps, 1, bp, method=rsgislib.PERCENTILE_EXACT, maxmem=1, tmpdir="./TestOutputs")
+
     def testExport2Ascii(self):
         print("PYTHON TEST: export2Ascii")
         table="./RATS/injune_p142_casi_sub_utm_segs.kea"
@@ -632,6 +745,14 @@ class RSGISTests:
         dataType = rsgislib.TYPE_8INT
         imageutils.stretchImage(inputImage, outputImage, False, "", True, False, gdalformat, dataType, imageutils.STRETCH_LINEARSTDDEV, 2)
 
+    def testStretchImagePercentile(self):
+        print("PYTHON TEST: stretchImage (percentile)")
+        inputImage = './Rasters/injune_p142_casi_sub_utm.kea'
+        outputImage = './TestOutputs/injune_p142_casi_sub_utm_2pcent.kea'
+        gdalformat = 'KEA'
+        dataType = rsgislib.TYPE_8INT
+        imageutils.stretchImage(inputImage, outputImage, False, "", True, False, gdalformat, dataType, imageutils.STRETCH_LINEARPERCENTILE, 2)
+
     def testSetBandNames(self):
         print("PYTHON TEST: setBandNames")
         inputImage = './TestOutputs/injune_p142_casi_sub_utm.kea'
@@ -844,6 +965,7 @@ class RSGISTests:
             filters.append(imagefilter.FilterParameters(filterType = 'Prewitt', fileEnding = 'prewittxy', option = 'xy') )
             filters.append(imagefilter.FilterParameters(filterType = 'Mean', fileEnding = 'mean', size=3) )
             filters.append(imagefilter.FilterParameters(filterType = 'Median', fileEnding = 'median', size=3) )
+            filters.append(imagefilter.FilterParameters(filterType = 'Percentile', fileEnding = 'pc90', size=3, percentile=90) )
             filters.append(imagefilter.FilterParameters(filterType = 'Mode', fileEnding = 'mode', size=3) )
             filters.append(imagefilter.FilterParameters(filterType = 'StdDev', fileEnding = 'stddev', size=3) )
             filters.append(imagefilter.FilterParameters(filterType = 'Range', fileEnding = 'range', size=3) )
@@ -860,6 +982,12 @@ class RSGISTests:
 
         imagefilter.applyfilters(inputImage, outputImageBase, filters, gdalFormat, outExt, dataType)
     
+    def testPercentileFilter(self):
+        print("PYTHON TEST: applyPercentileFilter")
+        inputImage = './Rasters/injune_p142_casi_sub_utm_single_band.vrt'
+        outputImage = './TestOutputs/injune_p142_casi_sub_utm_single_band_pc90_15.kea'
+        imagefilter.applyPercentileFilter(inputImage, outputImage, 15, 90, 'KEA', rsgislib.TYPE_32FLOAT)
+    
     def testLeungMalikFilterBank(self):
         inputImage = './Rasters/injune_p142_casi_sub_utm_single_band.vrt'
         outputImageBase = './TestOutputs/injune_p142_casi_sub_utm_single_band'
@@ -878,6 +1006,18 @@ class RSGISTests:
         
         segmentation.unionOfClumps(outputimage, gdalFormat, inputimagepaths, 0, False)
 
+    def testRMSmallClumpsStepwise(self):
+        inputImage = './Rasters/injune_p142_casi_sub_utm.kea'
+        clumpsImage = './RATS/injune_p142_casi_sub_utm_segs.kea'
+        outputImage = './TestOutputs/injune_p142_casi_sub_utm_segs_elim_test.kea'
+        segmentation.rmSmallClumpsStepwise(inputImage, clumpsImage, outputImage, 'KEA', False, '', False, False, 100, 1000000)
+
+    def testRMSmallClumpsStepwiseRAG(self):
+        inputImage = './Rasters/injune_p142_casi_sub_utm.kea'
+        clumpsImage = './RATS/injune_p142_casi_sub_utm_segs.kea'
+        outputImage = './TestOutputs/injune_p142_casi_sub_utm_segs_elim_rag_test.kea'
+        segmentation.rmSmallClumpsStepwise(inputImage, clumpsImage, outputImage, 'KEA', False, '', False, False, 100, 1000000, userag=True)
+
     def testRunShepherdSegmentation(self):
         inputImage = './Rasters/injune_p142_casi_sub_utm.kea'
         clumpsFile = './TestOutputs/injune_p142_casi_sub_utm_seg_test.kea'
@@ -886,6 +1026,14 @@ class RSGISTests:
         segmentation.segutils.runShepherdSegmentation(inputImage, clumpsFile,
                        meanImage, numClusters=100, minPxls=100)
 
+    def testShepherdSegmentation(self):
+        inputImage = './Rasters/injune_p142_casi_sub_utm.kea'
+        clumpsFile = './TestOutputs/injune_p142_casi_sub_utm_shepseg_test.kea'
+        meanImage = './TestOutputs/injune_p142_casi_sub_utm_shepseg_test_mean.kea'
+
+        segmentation.shepherdSegmentation(inputImage, clumpsFile, outputmeanimg=meanImage,
+                       tmpath='./TestOutputs', numclusters=100, minpxls=100)
+
     # Tools
     def testMetres2Degrees(self):
         print(tools.metres_to_degrees(52,1,1))
@@ -938,15 +1086,21 @@ if __name__ == '__main__':
         t.tryFuncAndCatch(t.testImageBandStatsIgnoreZeros)
         t.tryFuncAndCatch(t.testImageStats)
         t.tryFuncAndCatch(t.testImageStatsIgnoreZeros)
+        t.tryFuncAndCatch(t.testImageBandStatsMultiThreaded)
+        t.tryFuncAndCatch(t.testImageBandStatsPipelinedIO)
+        t.tryFuncAndCatch(t.testImageBlockCacheVRT)
+        t.tryFuncAndCatch(t.testCalcImageBlocks)
         t.tryFuncAndCatch(t.testUnconLinearSpecUnmix)
         t.tryFuncAndCatch(t.testExhConLinearSpecUnmix)
         t.tryFuncAndCatch(t.testConSum1LinearSpecUnmix)
         t.tryFuncAndCatch(t.testNnConSum1LinearSpecUnmix)
         t.tryFuncAndCatch(t.testKMeansCentres)
+        t.tryFuncAndCatch(t.testKMeansCentresMiniBatch)
         t.tryFuncAndCatch(t.testIsoDataClustering)
         t.tryFuncAndCatch(t.testAllBandsEqualTo)
         t.tryFuncAndCatch(t.testHistogram)
         t.tryFuncAndCatch(t.testBandPercentile)
+        t.tryFuncAndCatch(t.testBandPercentileSketch)
         t.tryFuncAndCatch(t.testMahalanobisDistWindow)
         t.tryFuncAndCatch(t.testMahalanobisDistImg2Window)
         t.tryFuncAndCatch(t.testCalcPxlColStats)
@@ -967,6 +1121,7 @@ if __name__ == '__main__':
         t.tryFuncAndCatch(t.testStackStats)
         t.tryFuncAndCatch(t.testCreateCopyImage)
         t.tryFuncAndCatch(t.testStretchImage)
+        t.tryFuncAndCatch(t.testStretchImagePercentile)
         t.tryFuncAndCatch(t.testSetBandNames)
         t.tryFuncAndCatch(t.testGetRSGISLibDataType)
         t.tryFuncAndCatch(t.testGetGDALDataType)
@@ -984,6 +1139,8 @@ if __name__ == '__main__':
         #t.tryFuncAndCatch(t.testFindSpecClose)
         t.tryFuncAndCatch(t.testPopulateRATWithStats)
         t.tryFuncAndCatch(t.testPopulateRATWithPercentiles)
+        t.tryFuncAndCatch(t.testPopulateRATWithPercentilesSketch)
+        t.tryFuncAndCatch(t.testPopulateRATWithPercentilesExact)
         t.tryFuncAndCatch(t.testExport2Ascii)
         t.tryFuncAndCatch(t.testExportCol2GDALImage)
         t.tryFuncAndCatch(t.testExportCols2GDALImage)
@@ -1028,12 +1185,16 @@ if __name__ == '__main__':
     if args.all or args.imagefilter:
         """ Image filter functions """ 
         t.tryFuncAndCatch(t.testFilter)
+        t.tryFuncAndCatch(t.testPercentileFilter)
         #t.tryFuncAndCatch(t.testLeungMalikFilterBank) # Skip as it takes a while
     
     if args.all or args.segmentation:
         """ Image filter functions """ 
         t.tryFuncAndCatch(t.testUnionOfClumps)
+        t.tryFuncAndCatch(t.testRMSmallClumpsStepwise)
+        t.tryFuncAndCatch(t.testRMSmallClumpsStepwiseRAG)
         t.tryFuncAndCatch(t.testRunShepherdSegmentation)
+        t.tryFuncAndCatch(t.testShepherdSegmentation)
 
 
     if args.all or args.tools:
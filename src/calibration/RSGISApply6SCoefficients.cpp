@@ -527,6 +527,86 @@ namespace rsgis{namespace calib{
 
     }
         
+    void RSGISApply6SCoefficients::calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output)
+    {
+        if(numValues != this->numOutBands)
+        {
+            throw rsgis::img::RSGISImageCalcException("The number of input image bands needs to be equal to the number of output image bands.");
+        }
+        
+        if(numBands <= numValues)
+        {
+            throw rsgis::img::RSGISImageCalcException("The number of input values needs to be equal to or less than the number of input image bands.");
+        }
+        
+        for(unsigned int i = 0; i < this->numValues; ++i)
+        {
+            if(imageBands[i]+bandOffset > numBands)
+            {
+                std::cout << "Image band: " << imageBands[i] << std::endl;
+                throw rsgis::img::RSGISImageCalcException("Image band is not within image.");
+            }
+        }
+        
+        // Find the elevation coefficients index for each pixel once, rather than per band.
+        if(this->elvIdxs.size() < nPxls)
+        {
+            this->elvIdxs.resize(nPxls);
+        }
+        unsigned int *elvs = this->elvIdxs.data();
+        if(this->useTopo6S)
+        {
+            float *demBand = bandValues[0];
+            for(unsigned long p = 0; p < nPxls; ++p)
+            {
+                unsigned int elv = 0;
+                double elevationScale = demBand[p] / 100.0;
+                elevationScale = int(elevationScale + 0.5);
+                int elevationInt = elevationScale * 100;
+                
+                if(elevationInt >= this->elevationThresh[0])
+                {
+                    for (unsigned int d = 1; d < numElevation; ++d)
+                    {
+                        if((elevationInt >= this->elevationThresh[d - 1]) && (elevationInt < this->elevationThresh[d]))
+                        {
+                            elv = d;
+                        }
+                    }
+                }
+                elvs[p] = elv;
+            }
+        }
+        else
+        {
+            std::fill(elvs, elvs+nPxls, 0);
+        }
+        
+        float *borderBand = bandValues[this->bandOffset];
+        double tmpVal = 0;
+        for(unsigned int i = 0; i < this->numValues; ++i)
+        {
+            float *inBand = bandValues[imageBands[i]+bandOffset];
+            float *aXBand = aX[i];
+            float *bXBand = bX[i];
+            float *cXBand = cX[i];
+            double *outBand = output[i];
+            for(unsigned long p = 0; p < nPxls; ++p)
+            {
+                if(borderBand[p] == 0) // If first band == 0, assume image border
+                {
+                    outBand[p] = 0;
+                }
+                else
+                {
+                    unsigned int elv = elvs[p];
+                    tmpVal=aXBand[elv]*inBand[p]-bXBand[elv];
+                    outBand[p] = (tmpVal/(1.0+cXBand[elv]*tmpVal))*this->scaleFactor;
+                }
+            }
+        }
+    }
+    
     RSGISApply6SCoefficients::~RSGISApply6SCoefficients()
     {
         
@@ -29,6 +29,8 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm>
 
 #include "gdal_priv.h"
 
@@ -199,6 +201,9 @@ namespace rsgis{namespace calib{
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("Not implmented.");};
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
         bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("Not implmented.");};
+        void calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output);
+        bool implementsCalcImageBlock() {return true;};
+        rsgis::img::RSGISCalcImageValue* clone() {return new RSGISApply6SCoefficients(this->numOutBands, this->imageBands, this->aX, this->bX, this->cX, this->numValues, this->elevationThresh, this->numElevation, this->scaleFactor);};
         ~RSGISApply6SCoefficients();
     protected:
         unsigned int *imageBands;
@@ -211,6 +216,7 @@ namespace rsgis{namespace calib{
 		bool useTopo6S;
         unsigned int bandOffset;
         float scaleFactor;
+        std::vector<unsigned int> elvIdxs;
     };
     
     
@@ -47,6 +47,25 @@ namespace rsgis{namespace calib{
         }
     }
     
+    void RSGISCalculateTopOfAtmosphereReflectance::calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output)
+    {
+        if(numBands != this->numOutBands)
+        {
+            throw rsgis::img::RSGISImageCalcException("The number of input and output image bands needs to be the same.");
+        }
+        
+        for(int i = 0; i < this->numOutBands; ++i)
+        {
+            double denom = solarIrradiance[i] * cos(solarZenith);
+            float *inBand = bandValues[i];
+            double *outBand = output[i];
+            for(unsigned long p = 0; p < nPxls; ++p)
+            {
+                outBand[p] = ((M_PI * inBand[p] * distSq)/denom) * this->scaleFactor;
+            }
+        }
+    }
+    
     RSGISCalculateTopOfAtmosphereReflectance::~RSGISCalculateTopOfAtmosphereReflectance()
     {
         
@@ -110,6 +110,9 @@ namespace rsgis{namespace calib{
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("Not implmented.");};
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
         bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("Not implmented.");};
+        void calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output);
+        bool implementsCalcImageBlock() {return true;};
+        rsgis::img::RSGISCalcImageValue* clone() {return new RSGISCalculateTopOfAtmosphereReflectance(this->numOutBands, this->solarIrradiance, this->distance, this->solarZenith, this->scaleFactor);};
         ~RSGISCalculateTopOfAtmosphereReflectance();
     protected:
         float *solarIrradiance;
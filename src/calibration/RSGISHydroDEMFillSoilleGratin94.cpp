@@ -25,9 +25,17 @@
 
 namespace rsgis{namespace calib{
     
-    RSGISHydroDEMFillSoilleGratin94::RSGISHydroDEMFillSoilleGratin94()
+    RSGISHydroDEMFillSoilleGratin94::RSGISHydroDEMFillSoilleGratin94(unsigned int tileSize, unsigned long maxCacheMB)
     {
-        
+        if(tileSize == 0)
+        {
+            tileSize = 512;
+        }
+        this->tileSize = tileSize;
+        this->maxCacheMB = maxCacheMB;
+        this->minVal = 0;
+        this->maxVal = 0;
+        this->numLevels = 0;
     }
     
     void RSGISHydroDEMFillSoilleGratin94::performSoilleGratin94Fill(GDALDataset *inDEMImgDS, GDALDataset *inValidImgDS, GDALDataset *outImgDS, bool calcBorderVal, long borderVal)
@@ -37,7 +45,7 @@ namespace rsgis{namespace calib{
             int numBands = inDEMImgDS->GetRasterCount();
             if(numBands != 1)
             {
-                rsgis::img::RSGISImageCalcException("The image to be filled should only have 1 image band.");
+                throw rsgis::img::RSGISImageCalcException("The image to be filled should only have 1 image band.");
             }
             
             
@@ -49,7 +57,8 @@ namespace rsgis{namespace calib{
             rsgis::img::RSGISImageUtils imgUtils;
             if(!imgUtils.doImageSpatAndExtMatch(datasets, 3))
             {
-                rsgis::img::RSGISImageCalcException("The images provided do not all have the same size and/or spaital header. The input image (e.g., DEM) and valid area image must be excatly the same.");
+                delete[] datasets;
+                throw rsgis::img::RSGISImageCalcException("The images provided do not all have the same size and/or spaital header. The input image (e.g., DEM) and valid area image must be excatly the same.");
             }
             delete[] datasets;
             
@@ -97,70 +106,117 @@ namespace rsgis{namespace calib{
                 noDataVal = 0.0;
             }
             
-            // Create the hierarchical queue.
-            pxQ = new std::list<Q2DPxl>*[numLevels];
-            for(long n = 0; n < numLevels; ++n)
+            // Work out how many tiles of each image can be held in memory.
+            unsigned long maxTiles = 0;
+            if(this->maxCacheMB > 0)
             {
-                pxQ[n] = new std::list<Q2DPxl>();
+                double tileBytes = ((double)this->tileSize) * ((double)this->tileSize) * ((2 * sizeof(long)) + sizeof(unsigned char));
+                maxTiles = (unsigned long)((((double)this->maxCacheMB) * 1024.0 * 1024.0) / tileBytes);
+                if(maxTiles == 0)
+                {
+                    maxTiles = 1;
+                }
             }
-            
+            RSGISHydroDEMTileCache<unsigned char> validCache(inValidImgDS->GetRasterBand(1), this->tileSize, maxTiles, true, true);
+            RSGISHydroDEMTileCache<long> demCache(inDEMImgDS->GetRasterBand(1), this->tileSize, maxTiles, false, true);
+            RSGISHydroDEMTileCache<long> outCache(outImgDS->GetRasterBand(1), this->tileSize, maxTiles, false, false);
+            long width = outCache.getWidth();
+            long height = outCache.getHeight();
+            long nTilesX = outCache.getNumTilesX();
+            long nTilesY = outCache.getNumTilesY();
             
             // Initialise the output image.
             std::cout << "Initalise the Output Image and find boundary pixels.\n";
-            RSGISInitOutputImageSoilleGratin94 initOutImg = RSGISInitOutputImageSoilleGratin94(noDataVal, maxVal, borderVal, pxQ[0]);
-            rsgis::img::RSGISCalcImage calcImage = rsgis::img::RSGISCalcImage(&initOutImg);
-            calcImage.calcImageWindowData(&inValidImgDS, 1, outImgDS, 3, true);
+            std::vector<unsigned long> seeds;
+            unsigned int numThreads = rsgis::RSGISThreadPool::getDefaultNumThreads();
+            if((numThreads > 1) && validCache.loadAllTiles() && outCache.loadAllTiles())
+            {
+                std::vector< std::vector<unsigned long> > tileSeeds(nTilesX * nTilesY);
+                rsgis::RSGISThreadPool threadPool(numThreads);
+                for(long tileY = 0; tileY < nTilesY; ++tileY)
+                {
+                    for(long tileX = 0; tileX < nTilesX; ++tileX)
+                    {
+                        std::vector<unsigned long> *tSeeds = &tileSeeds[(tileY * nTilesX) + tileX];
+                        threadPool.submit([this, tileX, tileY, &validCache, &outCache, noDataVal, borderVal, tSeeds](unsigned int threadIdx)
+                        {
+                            this->initOutputTile(tileX, tileY, &validCache, &outCache, (long)noDataVal, borderVal, true, tSeeds);
+                        });
+                    }
+                }
+                threadPool.wait();
+                for(std::vector< std::vector<unsigned long> >::iterator iterSeeds = tileSeeds.begin(); iterSeeds != tileSeeds.end(); ++iterSeeds)
+                {
+                    seeds.insert(seeds.end(), (*iterSeeds).begin(), (*iterSeeds).end());
+                }
+            }
+            else
+            {
+                for(long tileY = 0; tileY < nTilesY; ++tileY)
+                {
+                    for(long tileX = 0; tileX < nTilesX; ++tileX)
+                    {
+                        this->initOutputTile(tileX, tileY, &validCache, &outCache, (long)noDataVal, borderVal, false, &seeds);
+                    }
+                }
+            }
             
-            if(pxQ[0]->size() == 0)
+            if(seeds.empty())
             {
-                this->getImagesEdgesToInitFill(outImgDS->GetRasterBand(1), borderVal, pxQ[0]);
-                //throw rsgis::img::RSGISImageCalcException("The were no edge pixels with the valid mask.");
+                this->getImagesEdgesToInitFill(&outCache, borderVal, &seeds);
             }
             
-            Q2DPxl pxl;
+            // Create the hierarchical (bucket) queue, pixels are stored as (y * width) + x.
+            std::vector< std::vector<unsigned long> > pxQ(numLevels);
+            pxQ[0].swap(seeds);
+            
             long hcrt = minVal;
             long imgVal = 0;
             long img2Val = 0;
+            long x = 0;
+            long y = 0;
             std::cout << "Perform Fill:\n";
             rsgis_tqdm pbar;
             for(long n = 0; n < numLevels; ++n)
             {
                 pbar.progress(n, numLevels);
-
-                while(!this->qEmpty(hcrt))
+                
+                // Pixels pushed to the current level are appended, so the queue is read in FIFO order.
+                std::vector<unsigned long> &levelQ = pxQ[n];
+                for(size_t i = 0; i < levelQ.size(); ++i)
                 {
-                    pxl = this->qPopFront(hcrt);
-
-                    // Get Neightbours
-                    std::list<Q2DPxl> *nPxls = this->getNeighbours(pxl, inValidImgDS->GetRasterBand(1));
-                    for(std::list<Q2DPxl>::iterator iterNPxls = nPxls->begin(); iterNPxls != nPxls->end(); ++iterNPxls)
+                    x = levelQ[i] % width;
+                    y = levelQ[i] / width;
+                    
+                    for(long nY = std::max<long>(y-1, 0); nY <= std::min<long>(y+1, height-1); ++nY)
                     {
-                        imgVal = this->getPxlVal((*iterNPxls), inDEMImgDS->GetRasterBand(1));
-                        img2Val = this->getPxlVal((*iterNPxls), outImgDS->GetRasterBand(1));
-
-                        if(img2Val == maxVal)
+                        for(long nX = std::max<long>(x-1, 0); nX <= std::min<long>(x+1, width-1); ++nX)
                         {
-                            img2Val = this->rtnMax(hcrt, imgVal);
-                            this->setPxlVal((*iterNPxls), img2Val, outImgDS->GetRasterBand(1));
-                            if(img2Val < maxVal)
+                            if(((nX == x) && (nY == y)) || (validCache.getValue(nX, nY) != 1))
                             {
-                                this->qPushBack(img2Val, (*iterNPxls));
+                                continue;
+                            }
+                            
+                            if(outCache.getValue(nX, nY) == maxVal)
+                            {
+                                imgVal = demCache.getValue(nX, nY);
+                                img2Val = std::max(hcrt, imgVal);
+                                outCache.setValue(nX, nY, img2Val);
+                                if(img2Val < maxVal)
+                                {
+                                    pxQ[img2Val - minVal].push_back((nY * width) + nX);
+                                }
                             }
                         }
                     }
-                    delete nPxls;
-                    
                 }
+                std::vector<unsigned long>().swap(levelQ);
                 
                 ++hcrt;
             }
             pbar.finish();
             
-            for(long n = 0; n < numLevels; ++n)
-            {
-                delete pxQ[n];
-            }
-            delete[] pxQ;            
+            outCache.flush();
         }
         catch (rsgis::img::RSGISImageCalcException &e)
         {
@@ -176,224 +232,85 @@ namespace rsgis{namespace calib{
         }
     }
     
-    bool RSGISHydroDEMFillSoilleGratin94::qEmpty(long hcrt)
-    {
-        long qIdx = hcrt - this->minVal;
-        bool empty = pxQ[qIdx]->empty();
-        return empty;
-    }
-    
-    Q2DPxl RSGISHydroDEMFillSoilleGratin94::qPopFront(long hcrt)
+    void RSGISHydroDEMFillSoilleGratin94::initOutputTile(long tileX, long tileY, RSGISHydroDEMTileCache<unsigned char> *validCache, RSGISHydroDEMTileCache<long> *outCache, long noDataVal, long borderVal, bool resident, std::vector<unsigned long> *seeds)
     {
-        long qIdx = hcrt - this->minVal;
-        Q2DPxl pxl = pxQ[qIdx]->front();
-        pxQ[qIdx]->pop_front();
-        return pxl;
-    }
-    
-    void RSGISHydroDEMFillSoilleGratin94::qPushBack(long hcrt, Q2DPxl pxl)
-    {
-        long qIdx = hcrt - this->minVal;
-        pxQ[qIdx]->push_back(pxl);
-    }
-    
-    std::list<Q2DPxl>* RSGISHydroDEMFillSoilleGratin94::getNeighbours(Q2DPxl pxl, GDALRasterBand *inValidImg) 
-    {
-        std::list<Q2DPxl> *nPxls = new std::list<Q2DPxl>();
-        
-        long width = inValidImg->GetXSize();
-        long height = inValidImg->GetYSize();
-        
-        long minXPxl = pxl.x - 1;
-        long maxXPxl = pxl.x + 1;
-        long minYPxl = pxl.y - 1;
-        long maxYPxl = pxl.y + 1;
+        long width = validCache->getWidth();
+        long height = validCache->getHeight();
+        long xStart = tileX * this->tileSize;
+        long yStart = tileY * this->tileSize;
+        long xEnd = std::min<long>(xStart + this->tileSize, width);
+        long yEnd = std::min<long>(yStart + this->tileSize, height);
         
-        if(minXPxl < 0)
-        {
-            minXPxl = 0;
-        }
-        if(minYPxl < 0)
+        long outVal = 0;
+        for(long y = yStart; y < yEnd; ++y)
         {
-            minYPxl = 0;
-        }
-        if(maxXPxl >= width)
-        {
-            maxXPxl = width-1;
-        }
-        if(maxYPxl >= height)
-        {
-            maxYPxl = height-1;
-        }
-
-        int nWidth = (maxXPxl - minXPxl)+1;
-        int nHeight = (maxYPxl - minYPxl)+1;
-        
-        float dataVal = 0;
-        long cPxlX = 0;
-        long cPxlY = minYPxl;
-        for(int i = 0; i < nHeight; ++i)
-        {
-            cPxlX = minXPxl;
-            for(int j = 0; j < nWidth; ++j)
+            for(long x = xStart; x < xEnd; ++x)
             {
-                if(!((cPxlX == pxl.x) & (cPxlY == pxl.y)))
+                unsigned char valid = resident?validCache->getResidentValue(x, y):validCache->getValue(x, y);
+                if(valid == 1)
                 {
-                    inValidImg->RasterIO(GF_Read, cPxlX, cPxlY, 1, 1, &dataVal, 1, 1, GDT_Float32, 0, 0);
-
-                    if(dataVal == 1)
+                    outVal = this->maxVal;
+                }
+                else
+                {
+                    // Invalid pixels next to a valid pixel form the boundary the fill starts from.
+                    bool boundary = false;
+                    for(long nY = std::max<long>(y-1, 0); (nY <= std::min<long>(y+1, height-1)) && (!boundary); ++nY)
+                    {
+                        for(long nX = std::max<long>(x-1, 0); nX <= std::min<long>(x+1, width-1); ++nX)
+                        {
+                            valid = resident?validCache->getResidentValue(nX, nY):validCache->getValue(nX, nY);
+                            if(valid == 1)
+                            {
+                                boundary = true;
+                                break;
+                            }
+                        }
+                    }
+                    
+                    if(boundary)
+                    {
+                        outVal = borderVal;
+                        seeds->push_back((y * width) + x);
+                    }
+                    else
                     {
-                        nPxls->push_back(Q2DPxl(cPxlX, cPxlY));
+                        outVal = noDataVal;
                     }
                 }
-                ++cPxlX;
-            }
-            ++cPxlY;
-        }
-        
-        return nPxls;
-    }
-    
-    long RSGISHydroDEMFillSoilleGratin94::getPxlVal(Q2DPxl pxl, GDALRasterBand *imgData)
-    {
-        float outVal = 0;
-        imgData->RasterIO(GF_Read, pxl.x, pxl.y, 1, 1, &outVal, 1, 1, GDT_Float32, 0, 0);
-        return (long)outVal;
-    }
-    
-    void RSGISHydroDEMFillSoilleGratin94::setPxlVal(Q2DPxl pxl, long val, GDALRasterBand *imgData)
-    {
-        float outVal = val;
-        imgData->RasterIO(GF_Write, pxl.x, pxl.y, 1, 1, &outVal, 1, 1, GDT_Float32, 0, 0);
-    }
-    
-    long RSGISHydroDEMFillSoilleGratin94::rtnMax(long val1, long val2)
-    {
-        long outVal = val1;
-        if(val2 > val1)
-        {
-            outVal = val2;
-        }
-        return outVal;
-    }
-    
-    void RSGISHydroDEMFillSoilleGratin94::getImagesEdgesToInitFill(GDALRasterBand *imgData, double borderVal, std::list<Q2DPxl> *pxQ)
-    {
-        try
-        {
-            unsigned int xSize = imgData->GetXSize();
-            unsigned int ySize = imgData->GetYSize();
-            
-            //std::cout << "[" << xSize << ", " << ySize << "]\n";
-            
-            for(unsigned int x = 0; x < xSize; ++x)
-            {
-                Q2DPxl q2Pxl = Q2DPxl(x, 0);
-                this->setPxlVal(q2Pxl, borderVal, imgData);
-                pxQ->push_back(q2Pxl);
-            }
-            
-            for(unsigned int x = 0; x < xSize; ++x)
-            {
-                Q2DPxl q2Pxl = Q2DPxl(x, (ySize-1));
-                this->setPxlVal(q2Pxl, borderVal, imgData);
-                pxQ->push_back(q2Pxl);
-            }
-            
-            for(unsigned int y = 0; y < ySize; ++y)
-            {
-                Q2DPxl q2Pxl = Q2DPxl(0, y);
-                this->setPxlVal(q2Pxl, borderVal, imgData);
-                pxQ->push_back(q2Pxl);
-            }
-            
-            for(unsigned int y = 0; y < ySize; ++y)
-            {
-                Q2DPxl q2Pxl = Q2DPxl((xSize-1), y);
-                this->setPxlVal(q2Pxl, borderVal, imgData);
-                pxQ->push_back(q2Pxl);
+                
+                if(resident)
+                {
+                    outCache->setResidentValue(x, y, outVal);
+                }
+                else
+                {
+                    outCache->setValue(x, y, outVal);
+                }
             }
-
-        }
-        catch (rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch (rsgis::RSGISException &e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch (std::exception &e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
         }
     }
     
-    RSGISHydroDEMFillSoilleGratin94::~RSGISHydroDEMFillSoilleGratin94()
+    void RSGISHydroDEMFillSoilleGratin94::getImagesEdgesToInitFill(RSGISHydroDEMTileCache<long> *outCache, long borderVal, std::vector<unsigned long> *seeds)
     {
+        long xSize = outCache->getWidth();
+        long ySize = outCache->getHeight();
         
-    }
-    
-
-    RSGISInitOutputImageSoilleGratin94::RSGISInitOutputImageSoilleGratin94(double noDataVal, double dataVal, double borderVal, std::list<Q2DPxl> *pxQ): rsgis::img::RSGISCalcImageValue(1)
-    {
-        this->noDataVal = noDataVal;
-        this->dataVal = dataVal;
-        this->borderVal = borderVal;
-        this->pxQ = pxQ;
-    }
-    
-    void RSGISInitOutputImageSoilleGratin94::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) 
-    {
-        if(winSize != 3)
+        for(long y = 0; y < ySize; ++y)
         {
-            throw rsgis::img::RSGISImageCalcException("Window Size must be 3.");
-        }
-        
-        int hWinSize = (winSize-1)/2;
-        
-        if(dataBlock[0][hWinSize][hWinSize] == 1)
-        {
-            output[0] = dataVal;
-        }
-        else
-        {
-            bool boundary = false;
-            for(int i = 0; i < winSize; ++i)
-            {
-                for(int j = 0; j < winSize; ++j)
-                {
-                    if(dataBlock[0][i][j] == 1)
-                    {
-                        boundary = true;
-                        break;
-                    }
-                }
-                if(boundary)
-                {
-                    break;
-                }
-            }
-            
-            if(boundary)
+            // Only the first and last rows are filled, otherwise just the first and last columns.
+            long xStep = ((y == 0) || (y == (ySize-1)))?1:std::max<long>(xSize-1, 1);
+            for(long x = 0; x < xSize; x += xStep)
             {
-                output[0] = borderVal;
-                this->pxQ->push_back(Q2DPxl(extent.getMaxX(), extent.getMaxY()));
-            }
-            else
-            {
-                output[0] = noDataVal;
+                outCache->setValue(x, y, borderVal);
+                seeds->push_back((y * xSize) + x);
             }
         }
     }
     
-    RSGISInitOutputImageSoilleGratin94::~RSGISInitOutputImageSoilleGratin94()
+    RSGISHydroDEMFillSoilleGratin94::~RSGISHydroDEMFillSoilleGratin94()
     {
         
     }
     
-    
-    
 }}
-
-
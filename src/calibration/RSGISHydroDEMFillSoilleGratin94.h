@@ -35,10 +35,14 @@
 #include <iostream>
 #include <string>
 #include <math.h>
+#include <vector>
+#include <list>
+#include <algorithm>
 
 #include "gdal_priv.h"
 
 #include "common/rsgis-tqdm.h"
+#include "common/RSGISThreadPool.h"
 
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
@@ -83,49 +87,269 @@ namespace rsgis{namespace calib{
     };
     
     
+    /**
+     * An in-memory cache of a single image band split into square tiles. Tiles
+     * are read from the band when first accessed and, once the maximum number
+     * of tiles is reached, the least recently used tile is released (being
+     * written back to the band first if it has been edited). If maxTiles is 0
+     * all tiles are kept in memory.
+     *
+     * If binaryMask is true the values are stored as 1 where the band equals 1
+     * and 0 otherwise. If readOnLoad is false a tile is only read from the band
+     * if it has previously been written back, otherwise it starts as zeros.
+     */
+    template <typename T>
+    class RSGISHydroDEMTileCache
+    {
+    public:
+        RSGISHydroDEMTileCache(GDALRasterBand *band, unsigned int tileSize, unsigned long maxTiles, bool binaryMask, bool readOnLoad)
+        {
+            this->band = band;
+            this->tileSize = tileSize;
+            this->width = band->GetXSize();
+            this->height = band->GetYSize();
+            this->nTilesX = (this->width + tileSize - 1) / tileSize;
+            this->nTilesY = (this->height + tileSize - 1) / tileSize;
+            this->tiles.resize(this->nTilesX * this->nTilesY);
+            this->maxTiles = maxTiles;
+            if((this->maxTiles != 0) && (this->maxTiles < 9))
+            {
+                // A pixel and its neighbours can span 4 tiles and the output initialisation 9.
+                this->maxTiles = 9;
+            }
+            this->binaryMask = binaryMask;
+            this->readOnLoad = readOnLoad;
+            this->numLoaded = 0;
+            this->lastTileIdx = -1;
+            this->lastTile = NULL;
+        };
+        
+        /** Get a value, loading the tile containing the pixel if needed. */
+        inline T getValue(long x, long y)
+        {
+            RSGISHydroDEMTile *tile = this->getTile(x, y);
+            return tile->data[((y - tile->yOff) * tile->width) + (x - tile->xOff)];
+        };
+        
+        /** Set a value, loading the tile containing the pixel if needed. */
+        inline void setValue(long x, long y, T val)
+        {
+            RSGISHydroDEMTile *tile = this->getTile(x, y);
+            tile->data[((y - tile->yOff) * tile->width) + (x - tile->xOff)] = val;
+            tile->dirty = true;
+        };
+        
+        /**
+         * Get a value from a tile which is already in memory. This does not alter
+         * the cache so can be called from several threads once allTilesResident()
+         * is true.
+         */
+        inline T getResidentValue(long x, long y) const
+        {
+            const RSGISHydroDEMTile &tile = this->tiles[((y / this->tileSize) * this->nTilesX) + (x / this->tileSize)];
+            return tile.data[((y - tile.yOff) * tile.width) + (x - tile.xOff)];
+        };
+        
+        /**
+         * Set a value within a tile which is already in memory. Different threads
+         * may call this at the same time as long as they edit different tiles.
+         */
+        inline void setResidentValue(long x, long y, T val)
+        {
+            RSGISHydroDEMTile &tile = this->tiles[((y / this->tileSize) * this->nTilesX) + (x / this->tileSize)];
+            tile.data[((y - tile.yOff) * tile.width) + (x - tile.xOff)] = val;
+            tile.dirty = true;
+        };
+        
+        /** Load all the tiles, returns false (loading nothing) if they will not all fit in the cache. */
+        bool loadAllTiles()
+        {
+            if((this->maxTiles != 0) && (this->maxTiles < this->tiles.size()))
+            {
+                return false;
+            }
+            for(size_t i = 0; i < this->tiles.size(); ++i)
+            {
+                if(!this->tiles[i].loaded)
+                {
+                    this->loadTile(i);
+                }
+            }
+            return true;
+        };
+        
+        bool allTilesResident(){return this->numLoaded == this->tiles.size();};
+        
+        /** Write all the edited tiles back to the image band. */
+        void flush()
+        {
+            for(size_t i = 0; i < this->tiles.size(); ++i)
+            {
+                if(this->tiles[i].loaded && this->tiles[i].dirty)
+                {
+                    this->writeTile(i);
+                }
+            }
+        };
+        
+        long getWidth(){return this->width;};
+        long getHeight(){return this->height;};
+        long getNumTilesX(){return this->nTilesX;};
+        long getNumTilesY(){return this->nTilesY;};
+        unsigned int getTileSize(){return this->tileSize;};
+        
+        ~RSGISHydroDEMTileCache(){};
+    protected:
+        struct RSGISHydroDEMTile
+        {
+            RSGISHydroDEMTile(): xOff(0), yOff(0), width(0), height(0), loaded(false), dirty(false), written(false) {};
+            std::vector<T> data;
+            long xOff;
+            long yOff;
+            long width;
+            long height;
+            bool loaded;
+            bool dirty;
+            bool written;
+            typename std::list<size_t>::iterator lruPos;
+        };
+        
+        inline RSGISHydroDEMTile* getTile(long x, long y)
+        {
+            long tIdx = ((y / this->tileSize) * this->nTilesX) + (x / this->tileSize);
+            if(tIdx != this->lastTileIdx)
+            {
+                if(!this->tiles[tIdx].loaded)
+                {
+                    this->loadTile(tIdx);
+                }
+                this->lastTileIdx = tIdx;
+                this->lastTile = &this->tiles[tIdx];
+                // Move the tile to the front of the least recently used list.
+                this->lruTiles.splice(this->lruTiles.begin(), this->lruTiles, this->lastTile->lruPos);
+            }
+            return this->lastTile;
+        };
+        
+        void loadTile(size_t tIdx)
+        {
+            if((this->maxTiles != 0) && (this->numLoaded >= this->maxTiles))
+            {
+                this->releaseLeastRecentTile();
+            }
+            
+            RSGISHydroDEMTile &tile = this->tiles[tIdx];
+            tile.xOff = (tIdx % this->nTilesX) * this->tileSize;
+            tile.yOff = (tIdx / this->nTilesX) * this->tileSize;
+            tile.width = std::min<long>(this->tileSize, this->width - tile.xOff);
+            tile.height = std::min<long>(this->tileSize, this->height - tile.yOff);
+            size_t numPxls = tile.width * tile.height;
+            tile.data.assign(numPxls, T());
+            
+            if(this->readOnLoad || tile.written)
+            {
+                std::vector<double> buffer(numPxls);
+                if(this->band->RasterIO(GF_Read, tile.xOff, tile.yOff, tile.width, tile.height, buffer.data(), tile.width, tile.height, GDT_Float64, 0, 0) != CE_None)
+                {
+                    throw rsgis::img::RSGISImageCalcException("Could not read image tile.");
+                }
+                for(size_t i = 0; i < numPxls; ++i)
+                {
+                    if(this->binaryMask)
+                    {
+                        tile.data[i] = (buffer[i] == 1)?1:0;
+                    }
+                    else
+                    {
+                        tile.data[i] = (T)buffer[i];
+                    }
+                }
+            }
+            tile.loaded = true;
+            tile.dirty = false;
+            this->lruTiles.push_front(tIdx);
+            tile.lruPos = this->lruTiles.begin();
+            ++this->numLoaded;
+        };
+        
+        void writeTile(size_t tIdx)
+        {
+            RSGISHydroDEMTile &tile = this->tiles[tIdx];
+            std::vector<double> buffer(tile.data.begin(), tile.data.end());
+            if(this->band->RasterIO(GF_Write, tile.xOff, tile.yOff, tile.width, tile.height, buffer.data(), tile.width, tile.height, GDT_Float64, 0, 0) != CE_None)
+            {
+                throw rsgis::img::RSGISImageCalcException("Could not write image tile.");
+            }
+            tile.dirty = false;
+            tile.written = true;
+        };
+        
+        void releaseLeastRecentTile()
+        {
+            if(this->lruTiles.empty())
+            {
+                return;
+            }
+            size_t lruIdx = this->lruTiles.back();
+            this->lruTiles.pop_back();
+            if(this->tiles[lruIdx].dirty)
+            {
+                this->writeTile(lruIdx);
+            }
+            std::vector<T>().swap(this->tiles[lruIdx].data);
+            this->tiles[lruIdx].loaded = false;
+            --this->numLoaded;
+            if(((long)lruIdx) == this->lastTileIdx)
+            {
+                this->lastTileIdx = -1;
+                this->lastTile = NULL;
+            }
+        };
+        
+        GDALRasterBand *band;
+        unsigned int tileSize;
+        long width;
+        long height;
+        long nTilesX;
+        long nTilesY;
+        std::vector<RSGISHydroDEMTile> tiles;
+        unsigned long maxTiles;
+        bool binaryMask;
+        bool readOnLoad;
+        unsigned long numLoaded;
+        std::list<size_t> lruTiles;
+        long lastTileIdx;
+        RSGISHydroDEMTile *lastTile;
+    };
+    
+    
+    /**
+     * Fills the local minima within an image using a priority-flood, following
+     * Soille and Gratin (1994). The image, valid mask and output are accessed
+     * through in-memory tile caches rather than per-pixel RasterIO calls and the
+     * pixels waiting to be flooded are held in a bucket queue with one FIFO
+     * (a vector of pixel indexes) per integer level.
+     *
+     * tileSize is the width and height of the cached tiles and maxCacheMB limits
+     * the memory used by the caches (0 keeps the whole image in memory). When all
+     * the tiles fit within the cache and the default number of threads is greater
+     * than 1 the output initialisation is run in parallel across tiles.
+     */
     class DllExport RSGISHydroDEMFillSoilleGratin94
     {
     public:
-        RSGISHydroDEMFillSoilleGratin94();
+        RSGISHydroDEMFillSoilleGratin94(unsigned int tileSize=512, unsigned long maxCacheMB=2048);
         void performSoilleGratin94Fill(GDALDataset *inDEMImgDS, GDALDataset *inValidImgDS, GDALDataset *outImgDS, bool calcBorderVal, long borderVal=0);
         ~RSGISHydroDEMFillSoilleGratin94();
     protected:
-        bool qEmpty(long hcrt);
-        Q2DPxl qPopFront(long hcrt);
-        void qPushBack(long hcrt, Q2DPxl pxl);
-        std::list<Q2DPxl>* getNeighbours(Q2DPxl pxl, GDALRasterBand *inValidImg);
-        long getPxlVal(Q2DPxl pxl, GDALRasterBand *imgData);
-        void setPxlVal(Q2DPxl pxl, long val, GDALRasterBand *imgData);
-        long rtnMax(long val1, long val2);
-        void getImagesEdgesToInitFill(GDALRasterBand *imgData, double borderVal, std::list<Q2DPxl> *pxQ);
-        std::list<Q2DPxl> **pxQ;
+        void initOutputTile(long tileX, long tileY, RSGISHydroDEMTileCache<unsigned char> *validCache, RSGISHydroDEMTileCache<long> *outCache, long noDataVal, long borderVal, bool resident, std::vector<unsigned long> *seeds);
+        void getImagesEdgesToInitFill(RSGISHydroDEMTileCache<long> *outCache, long borderVal, std::vector<unsigned long> *seeds);
+        unsigned int tileSize;
+        unsigned long maxCacheMB;
         long minVal;
         long maxVal;
         long numLevels;
     };
-  
-    
-    class DllExport RSGISInitOutputImageSoilleGratin94 : public rsgis::img::RSGISCalcImageValue
-    {
-    public:
-        RSGISInitOutputImageSoilleGratin94(double noDataVal, double dataVal, double borderVal, std::list<Q2DPxl> *pxQ);
-        void calcImageValue(float *bandValues, int numBands, double *output) {throw rsgis::img::RSGISImageCalcException("Not implmented.");};
-        void calcImageValue(float *bandValues, int numBands) {throw rsgis::img::RSGISImageCalcException("Not implmented.");};
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, geos::geom::Envelope extent){throw rsgis::img::RSGISImageCalcException("Not implemented");};
-        void calcImageValue(float *bandValues, int numBands, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("Not implmented.");};
-        void calcImageValue(float *bandValues, int numBands, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("Not implmented.");};
-        void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-        void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent);
-        bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("Not implmented.");};
-        ~RSGISInitOutputImageSoilleGratin94();
-    protected:
-        double noDataVal;
-        double dataVal;
-        double borderVal;
-        std::list<Q2DPxl> *pxQ;
-    };
     
 }}
 
@@ -243,7 +243,6 @@ namespace rsgis{ namespace classifier{
 		if(hasInitClusterCentres)
 		{
 			rsgis::math::RSGISVectors vecUtils;
-			rsgis::math::RSGISMathsUtils mathsUtil;
 			try 
 			{
 				RSGISKMeanCalcPixelClusterCalcImageVal *calcClusterCentre = new RSGISKMeanCalcPixelClusterCalcImageVal(0, this->clusterCentres, this->numClusters, this->numImageBands);
@@ -325,34 +324,7 @@ namespace rsgis{ namespace classifier{
 				
 				if(saveCentres)
 				{
-			        // Open text file
-					std::ofstream outCentresFile;
-					outCentresFile.open(outCentresFileName.c_str());
-
-					// Write header file
-					outCentresFile << "Cluster,";
-					for(unsigned int j = 0; j < (numImageBands - 1); ++j)
-					{
-						std::string bandNumberStr = mathsUtil.inttostring(j + 1).c_str();
-						outCentresFile << "b" + bandNumberStr << ",";
-					}
-					std::string bandNumberStr = mathsUtil.inttostring(numImageBands).c_str();
-					outCentresFile << "b" + bandNumberStr;
-					outCentresFile << std::endl;
-
-					// Write out centres
-					for(unsigned int i = 0; i < numClusters; ++i)
-					{
-						outCentresFile << i << ",";
-						for(unsigned int j = 0; j < (numImageBands - 1); ++j)
-						{
-							outCentresFile << clusterCentres[i]->data->vector[j] << ",";
-						}
-						outCentresFile << clusterCentres[i]->data->vector[numImageBands-1];
-						outCentresFile << std::endl;
-					}
-					outCentresFile.flush();
-					outCentresFile.close();
+					this->saveClusterCentres(outCentresFileName);
 				}
 				
 								
@@ -370,6 +342,39 @@ namespace rsgis{ namespace classifier{
 		}
 	}
 	
+	void RSGISKMeansClassifier::saveClusterCentres(std::string outCentresFileName)
+	{
+		rsgis::math::RSGISMathsUtils mathsUtil;
+		// Open text file
+		std::ofstream outCentresFile;
+		outCentresFile.open(outCentresFileName.c_str());
+
+		// Write header file
+		outCentresFile << "Cluster,";
+		for(unsigned int j = 0; j < (numImageBands - 1); ++j)
+		{
+			std::string bandNumberStr = mathsUtil.inttostring(j + 1).c_str();
+			outCentresFile << "b" + bandNumberStr << ",";
+		}
+		std::string bandNumberStr = mathsUtil.inttostring(numImageBands).c_str();
+		outCentresFile << "b" + bandNumberStr;
+		outCentresFile << std::endl;
+
+		// Write out centres
+		for(unsigned int i = 0; i < numClusters; ++i)
+		{
+			outCentresFile << i << ",";
+			for(unsigned int j = 0; j < (numImageBands - 1); ++j)
+			{
+				outCentresFile << clusterCentres[i]->data->vector[j] << ",";
+			}
+			outCentresFile << clusterCentres[i]->data->vector[numImageBands-1];
+			outCentresFile << std::endl;
+		}
+		outCentresFile.flush();
+		outCentresFile.close();
+	}
+	
 	void RSGISKMeansClassifier::generateOutputImage(std::string outputImageFile)
 	{
 		if(hasInitClusterCentres)
@@ -430,30 +435,34 @@ namespace rsgis{ namespace classifier{
 	
 	void RSGISKMeanCalcPixelClusterCalcImageVal::calcImageValue(float *bandValues, int numBands) 
 	{
-		// Identify cluster within which point is associated with
-		double minDistance = 0;
+		// Identify cluster within which point is associated with; the sum for a
+		// centre is abandoned once it is greater than the closest so far.
+		double minSum = 0;
 		unsigned int minIdx = 0;
 		bool first = true;
 		double sum = 0;
-		double distance = 0;
+		int j = 0;
 		for(unsigned int i = 0; i < numClusters; ++i)
 		{
 			sum = 0;
-			for(int j = 0; j < numBands; ++j)
+			for(j = 0; j < numBands; ++j)
 			{
 				sum += ((clusterCentres[i]->data->vector[j] - bandValues[j])*(clusterCentres[i]->data->vector[j] - bandValues[j]));
+				if((!first) && (sum >= minSum))
+				{
+					break;
+				}
 			}
-			distance = sum/numBands;
 			
 			if(first)
 			{
-				minDistance = distance;
+				minSum = sum;
 				minIdx = i;
 				first = false;
 			}
-			else if(distance < minDistance)
+			else if(sum < minSum)
 			{
-				minDistance = distance;
+				minSum = sum;
 				minIdx = i;
 			}
 		}
@@ -71,6 +71,7 @@ namespace rsgis{ namespace classifier{
 		void generateOutputImage(std::string outputImageFile);
 		~RSGISKMeansClassifier();
 	protected:
+		void saveClusterCentres(std::string outCentresFileName);
 		std::string inputImageFile;
 		ClusterCentre **clusterCentres;
 		unsigned int numClusters;
@@ -150,6 +150,11 @@ namespace rsgis{ namespace cmds {
                     rsgis::filter::RSGISImageFilter *filter = new rsgis::filter::RSGISMedianFilter(0, (*iterFilter)->size, (*iterFilter)->fileEnding);
                     filterBank->addFilter(filter);
                 }
+                else if((*iterFilter)->type == "Percentile")
+                {
+                    rsgis::filter::RSGISImageFilter *filter = new rsgis::filter::RSGISPercentileFilter(0, (*iterFilter)->size, (*iterFilter)->fileEnding, (*iterFilter)->percentile);
+                    filterBank->addFilter(filter);
+                }
                 else if((*iterFilter)->type == "Mode")
                 {
                     rsgis::filter::RSGISImageFilter *filter = new rsgis::filter::RSGISModeFilter(0, (*iterFilter)->size, (*iterFilter)->fileEnding);
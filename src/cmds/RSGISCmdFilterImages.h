@@ -53,6 +53,7 @@ namespace rsgis{ namespace cmds {
         std::string option;
         unsigned int size;
         unsigned int nLooks;
+        float percentile;
         float stddev;
         float stddevX;
         float stddevY;
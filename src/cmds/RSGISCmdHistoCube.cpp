@@ -152,20 +152,21 @@ namespace rsgis{ namespace cmds {
                 unsigned int nBins = cubeLayer->bins.size();
                 unsigned long dataArrLen = (maxRow*nBins)+nBins;
                 unsigned int *dataArr = new unsigned int[dataArrLen];
-                histoCubeFileObj.getHistoRows(layerName, 0, maxRow, dataArr, dataArrLen);
+                histoCubeFileObj.getHistoRows(layerName, 0, maxRow+1, dataArr, dataArrLen);
                 
                 rsgis::histocube::RSGISPopHistoCubeLayerFromImgBandInMem popCubeLyrMem = rsgis::histocube::RSGISPopHistoCubeLayerFromImgBandInMem(dataArr, dataArrLen, bandIdx, maxRow, cubeLayer->scale, cubeLayer->offset, cubeLayer->bins);
                 rsgis::img::RSGISCalcImage calcImgPopCubeMem = rsgis::img::RSGISCalcImage(&popCubeLyrMem);
                 calcImgPopCubeMem.calcImage(datasets, 1, 1);
                 
-                histoCubeFileObj.setHistoRows(layerName, 0, maxRow, dataArr, dataArrLen);
+                histoCubeFileObj.setHistoRows(layerName, 0, maxRow+1, dataArr, dataArrLen);
                 delete[] dataArr;
             }
             else
             {
-                rsgis::histocube::RSGISPopHistoCubeLayerFromImgBand popCubeLyr = rsgis::histocube::RSGISPopHistoCubeLayerFromImgBand(&histoCubeFileObj, layerName, bandIdx, maxRow, cubeLayer->scale, cubeLayer->offset, cubeLayer->bins);
+                rsgis::histocube::RSGISPopHistoCubeLayerFromImgBandBatched popCubeLyr = rsgis::histocube::RSGISPopHistoCubeLayerFromImgBandBatched(&histoCubeFileObj, layerName, bandIdx, maxRow, cubeLayer->scale, cubeLayer->offset, cubeLayer->bins);
                 rsgis::img::RSGISCalcImage calcImgPopCube = rsgis::img::RSGISCalcImage(&popCubeLyr);
                 calcImgPopCube.calcImage(datasets, 1, 1);
+                popCubeLyr.flush();
             }
             histoCubeFileObj.closeFile();
             GDALClose(datasets[0]);
@@ -225,7 +226,7 @@ namespace rsgis{ namespace cmds {
             unsigned int nBins = cubeLayer->bins.size();
             unsigned long dataArrLen = (maxRow*nBins)+nBins;
             unsigned int *dataArr = new unsigned int[dataArrLen];
-            histoCubeFileObj.getHistoRows(layerName, 0, maxRow, dataArr, dataArrLen);
+            histoCubeFileObj.getHistoRows(layerName, 0, maxRow+1, dataArr, dataArrLen);
             
             rsgis::histocube::RSGISExportBins2ImgBands expBins2Img = rsgis::histocube::RSGISExportBins2ImgBands(exportBins.size(), dataArr, dataArrLen, nBins, exportBins);
             rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(&expBins2Img);
@@ -356,7 +357,7 @@ namespace rsgis{ namespace cmds {
             unsigned int nBins = cubeLayer->bins.size();
             unsigned long dataArrLen = (maxRow*nBins)+nBins;
             unsigned int *dataArr = new unsigned int[dataArrLen];
-            histoCubeFileObj.getHistoRows(layerName, 0, maxRow, dataArr, dataArrLen);
+            histoCubeFileObj.getHistoRows(layerName, 0, maxRow+1, dataArr, dataArrLen);
             
             std::cout << "Scale = " << cubeLayer->scale << std::endl;
             std::cout << "Offset = " << cubeLayer->offset << std::endl;
@@ -24,12 +24,14 @@
 #include "RSGISCmdParent.h"
 
 #include "common/RSGISImageException.h"
+#include "common/RSGISThreadPool.h"
 
 #include "img/RSGISBandMath.h"
 #include "img/RSGISImageMaths.h"
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISCalcImage.h"
+#include "img/RSGISImageBlockCache.h"
 #include "img/RSGISImageClustering.h"
 #include "img/RSGISImageWindowStats.h"
 #include "img/RSGISImageStatistics.h"
@@ -200,7 +202,7 @@ namespace rsgis{ namespace cmds {
             
             for(int i = 0; i < total_n_imgs; ++i)
             {
-                GDALClose(datasets[i]);
+                rsgis::img::RSGISImageBlockCache::closeDataset(datasets[i]);
             }
             delete[] datasets;
             
@@ -221,7 +223,7 @@ namespace rsgis{ namespace cmds {
             }
             if(editOutputImg && (!openedOutput))
             {
-                GDALClose(outDataset);
+                rsgis::img::RSGISImageBlockCache::closeDataset(outDataset);
             }
         }
         catch(rsgis::RSGISImageException &e)
@@ -313,12 +315,12 @@ namespace rsgis{ namespace cmds {
                 calcImage->calcImage(datasets, 1, outputImage, useExpAsbandName, outBandName, imageFormat, RSGIS_to_GDAL_Type(outDataType));
             }
 
-            GDALClose(datasets[0]);
+            rsgis::img::RSGISImageBlockCache::closeDataset(datasets[0]);
             delete[] datasets;
             
             if(editOutputImg && !openedOutput)
             {
-                GDALClose(outDataset);
+                rsgis::img::RSGISImageBlockCache::closeDataset(outDataset);
             }
             
             if(useExpAsbandName)
@@ -428,7 +430,7 @@ namespace rsgis{ namespace cmds {
                 calcImage->calcImage(datasets, 1, outputImage, useExpAsbandName, outBandName, imageFormat, RSGIS_to_GDAL_Type(outDataType));
             }
             
-            GDALClose(datasets[0]);
+            rsgis::img::RSGISImageBlockCache::closeDataset(datasets[0]);
             delete[] datasets;
             
             if(useExpAsbandName)
@@ -438,7 +440,7 @@ namespace rsgis{ namespace cmds {
             
             if(editOutputImg && !openedOutput)
             {
-                GDALClose(outDataset);
+                rsgis::img::RSGISImageBlockCache::closeDataset(outDataset);
             }
             
             delete muParser;
@@ -464,7 +466,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-    void executeKMeansClustering(std::string inputImage, std::string outputMatrixFile, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, RSGISInitClustererMethods initClusterMethod)
+    void executeKMeansClustering(std::string inputImage, std::string outputMatrixFile, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, RSGISInitClustererMethods initClusterMethod, unsigned int miniBatchSize)
     {
         
         std::cout << "inputImage = " << inputImage << std::endl;
@@ -517,7 +519,7 @@ namespace rsgis{ namespace cmds {
             }
 
             rsgis::img::RSGISImageClustering imgClustering;
-            imgClustering.findKMeansCentres(dataset, outputMatrixFile, numClusters, maxNumIterations, subSample, ignoreZeros, degreeOfChange, initMethod);
+            imgClustering.findKMeansCentres(dataset, outputMatrixFile, numClusters, maxNumIterations, subSample, ignoreZeros, degreeOfChange, initMethod, miniBatchSize);
 
             GDALClose(dataset);
         }
@@ -2209,7 +2211,7 @@ namespace rsgis{ namespace cmds {
         return bins;
     }
 
-    std::vector<double> executeBandPercentile(std::string inputImage, float percentile, float noDataValue, bool noDataValueSpecified)
+    std::vector<double> executeBandPercentile(std::string inputImage, float percentile, float noDataValue, bool noDataValueSpecified, bool useSketch, unsigned int sketchK)
     {
         std::vector<double> outVals;
         try
@@ -2230,7 +2232,7 @@ namespace rsgis{ namespace cmds {
             rsgis::math::RSGISMatrices matrixUtils;
             rsgis::img::RSGISImagePercentiles calcPercentiles;
 
-            rsgis::math::Matrix *bandPercentiles = calcPercentiles.getPercentilesForAllBands(imageDataset, percentile, noDataValue, noDataValueSpecified);
+            rsgis::math::Matrix *bandPercentiles = calcPercentiles.getPercentilesForAllBands(imageDataset, percentile, noDataValue, noDataValueSpecified, useSketch, sketchK);
             
             for(unsigned int i = 0; i < bandPercentiles->n; ++i)
             {
@@ -3464,6 +3466,121 @@ namespace rsgis{ namespace cmds {
         }
         return outImgVal;
     }
+    
+    void executeSetNumThreads(unsigned int numThreads)
+    {
+        try
+        {
+            rsgis::RSGISThreadPool::setDefaultNumThreads(numThreads);
+        }
+        catch (std::exception &e)
+        {
+            throw RSGISCmdException(e.what());
+        }
+    }
+    
+    unsigned int executeGetNumThreads()
+    {
+        return rsgis::RSGISThreadPool::getDefaultNumThreads();
+    }
+    
+    void executeSetPipelinedIO(bool pipelinedIO)
+    {
+        rsgis::img::RSGISCalcImage::setDefaultPipelinedIO(pipelinedIO);
+    }
+    
+    bool executeGetPipelinedIO()
+    {
+        return rsgis::img::RSGISCalcImage::getDefaultPipelinedIO();
+    }
+    
+    void executeSetImageBlockCacheSize(unsigned long sizeMB)
+    {
+        rsgis::img::RSGISImageBlockCache::setMaxMemory(((size_t)sizeMB) * 1024 * 1024);
+    }
+    
+    void executeGetImageBlockCacheStats(double *sizeMB, double *usedMB, unsigned long long *numHits, unsigned long long *numMisses)
+    {
+        *sizeMB = ((double)rsgis::img::RSGISImageBlockCache::getMaxMemory()) / (1024.0 * 1024.0);
+        *usedMB = ((double)rsgis::img::RSGISImageBlockCache::getMemoryUsed()) / (1024.0 * 1024.0);
+        *numHits = rsgis::img::RSGISImageBlockCache::getNumHits();
+        *numMisses = rsgis::img::RSGISImageBlockCache::getNumMisses();
+    }
+    
+    void executeClearImageBlockCache()
+    {
+        rsgis::img::RSGISImageBlockCache::clear();
+        rsgis::img::RSGISImageBlockCache::resetCounters();
+    }
+    
+    void executeCalcImageBlocks(std::vector<std::string> inputImgs, std::string outputImg, std::string gdalFormat, RSGISLibDataType outDataType, unsigned int numOutBands, RSGISCmdBlockFunction blockFunc)
+    {
+        try
+        {
+            GDALAllRegister();
+            
+            if(inputImgs.empty())
+            {
+                throw rsgis::RSGISImageException("At least one input image must be provided.");
+            }
+            if(numOutBands == 0)
+            {
+                throw rsgis::RSGISImageException("The number of output image bands must be greater than zero.");
+            }
+            
+            unsigned int nImgs = inputImgs.size();
+            GDALDataset **datasets = new GDALDataset*[nImgs];
+            for(unsigned int i = 0; i < nImgs; ++i)
+            {
+                datasets[i] = (GDALDataset *) GDALOpen(inputImgs.at(i).c_str(), GA_ReadOnly);
+                if(datasets[i] == NULL)
+                {
+                    std::string message = std::string("Could not open image ") + inputImgs.at(i);
+                    throw rsgis::RSGISImageException(message.c_str());
+                }
+            }
+            
+            // The block function needs the width of the overlapping region to find the rows within each block.
+            rsgis::img::RSGISImageUtils imageUtils;
+            int **dsOffsets = new int*[nImgs];
+            for(unsigned int i = 0; i < nImgs; ++i)
+            {
+                dsOffsets[i] = new int[2];
+            }
+            int width = 0;
+            int height = 0;
+            double *gdalTransform = new double[6];
+            imageUtils.getImageOverlap(datasets, nImgs, dsOffsets, &width, &height, gdalTransform);
+            for(unsigned int i = 0; i < nImgs; ++i)
+            {
+                delete[] dsOffsets[i];
+            }
+            delete[] dsOffsets;
+            delete[] gdalTransform;
+            
+            rsgis::img::RSGISApplyBlockFunction applyBlockFunc = rsgis::img::RSGISApplyBlockFunction(numOutBands, width, blockFunc);
+            rsgis::img::RSGISCalcImage calcImage = rsgis::img::RSGISCalcImage(&applyBlockFunc, "", true);
+            calcImage.calcImage(datasets, nImgs, outputImg, false, NULL, gdalFormat, RSGIS_to_GDAL_Type(outDataType));
+            
+            for(unsigned int i = 0; i < nImgs; ++i)
+            {
+                GDALClose(datasets[i]);
+            }
+            delete[] datasets;
+        }
+        catch(rsgis::RSGISImageException &e)
+        {
+            throw RSGISCmdException(e.what());
+        }
+        catch(rsgis::RSGISException &e)
+        {
+            throw RSGISCmdException(e.what());
+        }
+        catch (std::exception &e)
+        {
+            throw RSGISCmdException(e.what());
+        }
+    }
                 
 }}
 
@@ -27,6 +27,7 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <functional>
 
 #include "common/RSGISCommons.h"
 #include "RSGISCmdException.h"
@@ -97,7 +98,7 @@ namespace rsgis{ namespace cmds {
     /** Function to run the image band maths tools */
     DllExport void executeImageBandMaths(std::string inputImage, std::string outputImage, std::string mathsExpression, std::string imageFormat, RSGISLibDataType outDataType, bool useExpAsbandName, bool editOutputImg=false);
     /** Function to run the KMeans tool */
-    DllExport void executeKMeansClustering(std::string inputImage, std::string outputMatrixFile, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, RSGISInitClustererMethods initClusterMethod);
+    DllExport void executeKMeansClustering(std::string inputImage, std::string outputMatrixFile, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, RSGISInitClustererMethods initClusterMethod, unsigned int miniBatchSize=0);
     /** Function to run the KMeans tool */
     DllExport void executeISODataClustering(std::string inputImage, std::string outputMatrixFile, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, RSGISInitClustererMethods initClusterMethod, float minDistBetweenClusters, unsigned int minNumFeatures, float maxStdDev, unsigned int minNumClusters, unsigned int startIteration, unsigned int endIteration);
     /** Function to run mahalanobis distance Window Filter */
@@ -160,8 +161,8 @@ namespace rsgis{ namespace cmds {
     DllExport void executeHistogram(std::string inputImage, std::string imageMask, std::string outputFile, unsigned int imgBand, float imgValue, double binWidth, bool calcInMinMax, double inMin, double inMax);
     /** Function to generate a histogram and return it */
     DllExport unsigned int* executeGetHistogram(std::string inputImage, unsigned int imgBand, double binWidth, unsigned int *nBins, bool calcInMinMax, double *inMin, double *inMax);
-    /** Function to calculate image band percentiles */
-    DllExport std::vector<double> executeBandPercentile(std::string inputImage, float percentile, float noDataValue, bool noDataValueSpecified);
+    /** Function to calculate image band percentiles; exact (two passes over the image) or, if useSketch, approximated with a quantile sketch of size sketchK (one pass) */
+    DllExport std::vector<double> executeBandPercentile(std::string inputImage, float percentile, float noDataValue, bool noDataValueSpecified, bool useSketch=false, unsigned int sketchK=200);
     /** Function to calculate the distance to the nearest geometry for every pixel in an image */
     DllExport void executeImageDist2Geoms(std::string inputImage, std::string inputVector, std::string imageFormat, std::string outputImage);
     /** Function to calculate correlation for windows */
@@ -192,6 +193,26 @@ namespace rsgis{ namespace cmds {
     DllExport void executeIdentifyMinPxlValueInWin(std::string inputImg, std::string outputImg, std::string outputRefImg, std::vector<unsigned int> bands, unsigned int winSize, std::string gdalFormat, float noDataValue, bool useNoDataValue);
     /** A function to calculate a mean value across a number of image bands within a mask */
     DllExport float executeCalcImgMeanInMask(std::string inputImg, std::string inputImgMsk, int mskValue, std::vector<unsigned int> bands, float noDataValue, bool useNoDataValue);
+    /** A function to set the number of threads used to process image blocks (0 = number of cores) */
+    DllExport void executeSetNumThreads(unsigned int numThreads);
+    /** A function to get the number of threads used to process image blocks */
+    DllExport unsigned int executeGetNumThreads();
+    /** A function to set whether image blocks are read and written on separate threads while the previous block is processed */
+    DllExport void executeSetPipelinedIO(bool pipelinedIO);
+    /** A function to get whether pipelined reading and writing of image blocks is used */
+    DllExport bool executeGetPipelinedIO();
+    /** A function to set the memory (MB) used to keep image blocks read by the image calculation functions (0 = off) */
+    DllExport void executeSetImageBlockCacheSize(unsigned long sizeMB);
+    /** A function to get the size (MB) of the image block cache, the memory used (MB) and the number of hits and misses */
+    DllExport void executeGetImageBlockCacheStats(double *sizeMB, double *usedMB, unsigned long long *numHits, unsigned long long *numMisses);
+    /** A function to remove all the image blocks from the cache and reset the counters */
+    DllExport void executeClearImageBlockCache();
+    
+    /** A function applied to each block of rows by executeCalcImageBlocks: inBlock[band][(row*width)+col] holds the input
+        values and outBlock[band][(row*width)+col] the output values, for nRows rows starting at row yOff of the image */
+    typedef std::function<void(float **inBlock, unsigned int numInBands, double **outBlock, unsigned int numOutBands, unsigned int width, unsigned int nRows, unsigned int yOff)> RSGISCmdBlockFunction;
+    /** A function to apply a function to each block of the input images (stacked in order), using the image block buffers directly */
+    DllExport void executeCalcImageBlocks(std::vector<std::string> inputImgs, std::string outputImg, std::string gdalFormat, RSGISLibDataType outDataType, unsigned int numOutBands, RSGISCmdBlockFunction blockFunc);
 
 
 }}
@@ -34,6 +34,7 @@
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISCalcImage.h"
+#include "img/RSGISImageBlockCache.h"
 #include "img/RSGISImageUtils.h"
 #include "img/RSGISCalcEditImage.h"
 #include "img/RSGISCopyImage.h"
@@ -1226,9 +1227,9 @@ namespace rsgis{ namespace cmds {
                 GDALClose(initCloudHeightsDS);
                 GDALClose(cloudShadowTestRegionsDS);
                 GDALClose(cloudShadowRegionsDS);
-                GDALClose(finalShadowsDialateDS);
+                rsgis::img::RSGISImageBlockCache::closeDataset(finalShadowsDialateDS);
                 GDALClose(finalCloudsDS);
-                GDALClose(finalCloudsDialateDS);
+                rsgis::img::RSGISImageBlockCache::closeDataset(finalCloudsDialateDS);
                 GDALClose(finalResultDS);
                 GDALClose(reflDataset);
                 GDALClose(thermDataset);
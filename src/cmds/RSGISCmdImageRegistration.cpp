@@ -29,6 +29,7 @@
 #include "registration/RSGISBasicImageRegistration.h"
 #include "registration/RSGISImageSimilarityMetric.h"
 #include "registration/RSGISStandardImageSimilarityMetrics.h"
+#include "registration/RSGISFFTImageSimilarityMetrics.h"
 #include "registration/RSGISSingleConnectLayerImageRegistration.h"
 #include "registration/RSGISWarpImage.h"
 #include "registration/RSGISBasicNNGCPImageWarp.h"
@@ -39,6 +40,7 @@
 
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISCalcImage.h"
+#include "img/RSGISImageBlockCache.h"
 #include "img/RSGISCopyImage.h"
 
 
@@ -87,6 +89,14 @@ namespace rsgis{ namespace cmds {
             {
                 similarityMetric = new rsgis::reg::RSGISCorrelationSimilarityMetric();
             }
+            else if(metricTypeInt == 5) // fft correlation
+            {
+                similarityMetric = new rsgis::reg::RSGISFFTCorrelationSimilarityMetric();
+            }
+            else if(metricTypeInt == 6) // phase correlation
+            {
+                similarityMetric = new rsgis::reg::RSGISPhaseCorrelationSimilarityMetric();
+            }
             else
             {
                 throw rsgis::cmds::RSGISCmdException("Metric not recognised!");
@@ -175,6 +185,14 @@ namespace rsgis{ namespace cmds {
             {
                 similarityMetric = new rsgis::reg::RSGISCorrelationSimilarityMetric();
             }
+            else if(metricTypeInt == 5) // fft correlation
+            {
+                similarityMetric = new rsgis::reg::RSGISFFTCorrelationSimilarityMetric();
+            }
+            else if(metricTypeInt == 6) // phase correlation
+            {
+                similarityMetric = new rsgis::reg::RSGISPhaseCorrelationSimilarityMetric();
+            }
             else
             {
                 throw rsgis::cmds::RSGISCmdException("Metric not recognised!");
@@ -387,7 +405,7 @@ namespace rsgis{ namespace cmds {
             trans[0] = trans[0] + xOff;
             trans[3] = trans[3] + yOff;
             outDataset->SetGeoTransform(trans);
-            GDALClose(outDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outDataset);
             delete[] trans;
         }
         catch(RSGISException& e)
@@ -34,6 +34,7 @@
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISCalcImage.h"
+#include "img/RSGISImageBlockCache.h"
 #include "img/RSGISCopyImage.h"
 #include "img/RSGISStretchImage.h"
 #include "img/RSGISMaskImage.h"
@@ -92,6 +93,10 @@ namespace rsgis{ namespace cmds {
             {
                 stretchImg.executeLinearPercentStretch(stretchParam);
             }
+            else if(stretchType == linearPercentile)
+            {
+                stretchImg.executeLinearPercentileStretch(stretchParam);
+            }
             else if(stretchType == linearStdDev)
             {
                 stretchImg.executeLinearStdDevStretch(stretchParam);
@@ -153,6 +158,10 @@ namespace rsgis{ namespace cmds {
             {
                 stretchImg.executeLinearPercentStretch(stretchParam);
             }
+            else if(stretchType == linearPercentile)
+            {
+                stretchImg.executeLinearPercentileStretch(stretchParam);
+            }
             else if(stretchType == linearStdDev)
             {
                 stretchImg.executeLinearStdDevStretch(stretchParam);
@@ -314,6 +323,10 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             {
                 stretchImg.executeLinearPercentStretch(stretchParam);
             }
+            else if(stretchType == linearPercentile)
+            {
+                stretchImg.executeLinearPercentileStretch(stretchParam);
+            }
             else if(stretchType == linearStdDev)
             {
                 stretchImg.executeLinearStdDevStretch(stretchParam);
@@ -971,7 +984,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             popWithStats.calcPopStats( inDataset, useIgnoreVal, nodataValue, calcImgPyramids, pyraScaleVals);
 
 
-            GDALClose(inDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(inDataset);
         }
         catch(rsgis::RSGISException& e)
         {
@@ -1045,7 +1058,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
                 mosaic.includeDatasets(baseDS, inputImages, numDS, bands, bandsDefined);
             }
 
-            GDALClose(baseDS);
+            rsgis::img::RSGISImageBlockCache::closeDataset(baseDS);
             delete[] inputImages;
         }
         catch (RSGISImageException& e)
@@ -1074,7 +1087,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             rsgis::img::RSGISImageMosaic mosaic;
             mosaic.includeDatasetsIgnoreOverlap(baseDS, inputImages, numDS, numOverlapPxls);
             
-            GDALClose(baseDS);
+            rsgis::img::RSGISImageBlockCache::closeDataset(baseDS);
             delete[] inputImages;
         }
         catch (RSGISImageException& e)
@@ -1126,7 +1139,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             delete calcImg;
             delete[] datasets;
             
-            GDALClose(baseDS);
+            rsgis::img::RSGISImageBlockCache::closeDataset(baseDS);
             delete[] inputImages;
         }
         catch (RSGISImageException& e)
@@ -1155,7 +1168,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             rsgis::img::RSGISCombineImgTileOverview combineOverviews;
             combineOverviews.combineKEAImgTileOverviews(baseDS, inputImages, pyraScaleVals);
             
-            GDALClose(baseDS);
+            rsgis::img::RSGISImageBlockCache::closeDataset(baseDS);
         }
         catch (RSGISImageException& e)
         {
@@ -1188,7 +1201,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
 
             inDataset->SetProjection(wktStr.c_str());
 
-            GDALClose(inDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(inDataset);
         }
         catch (RSGISImageException& e)
         {
@@ -1248,7 +1261,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
 
             inDataset->SetGeoTransform(trans);
 
-            GDALClose(inDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(inDataset);
             delete[] trans;
         }
         catch (RSGISImageException& e)
@@ -1329,7 +1342,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             inDataset->SetProjection(wktString.c_str());
 
             delete[] trans;
-            GDALClose(inDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(inDataset);
         }
         catch (RSGISImageException& e)
         {
@@ -1394,7 +1407,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
     }
 
 
-    void executeImageRasterZone2HDF(std::string imageFile, std::string maskImage, std::string outputHDF, float maskVal, RSGISLibDataType dataType)
+    void executeImageRasterZone2HDF(std::string imageFile, std::string maskImage, std::string outputHDF, float maskVal, RSGISLibDataType dataType, unsigned int nSamples, int seed, bool compress)
     {
         try
         {
@@ -1415,7 +1428,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             }
 
             rsgis::img::RSGISExtractImageValues extractVals;
-            extractVals.extractDataWithinMask2HDF(maskDS, imageDS, outputHDF, maskVal, dataType);
+            extractVals.extractDataWithinMask2HDF(maskDS, imageDS, outputHDF, maskVal, dataType, nSamples, seed, compress);
 
             GDALClose(maskDS);
             GDALClose(imageDS);
@@ -1435,12 +1448,12 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
     }
     
             
-    void executeImageBandRasterZone2HDF(std::vector<std::pair<std::string, std::vector<unsigned int> > > imageFiles, std::string maskImage, std::string outputHDF, float maskVal, RSGISLibDataType dataType)
+    void executeImageBandRasterZone2HDF(std::vector<std::pair<std::string, std::vector<unsigned int> > > imageFiles, std::string maskImage, std::string outputHDF, float maskVal, RSGISLibDataType dataType, unsigned int nSamples, int seed, bool compress)
     {
         try
         {
             rsgis::img::RSGISExtractImageValues extractVals;
-            extractVals.extractImgBandDataWithinMask2HDF(imageFiles, maskImage, outputHDF, maskVal, dataType);
+            extractVals.extractImgBandDataWithinMask2HDF(imageFiles, maskImage, outputHDF, maskVal, dataType, nSamples, seed, compress);
         }
         catch (RSGISImageException& e)
         {
@@ -2193,7 +2206,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
                 throw RSGISImageException(message.c_str());
             }
             outDataset->GetRasterBand(1)->SetMetadataItem("LAYER_TYPE", "thematic");
-            GDALClose(outDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outDataset);
             
             // Tidy up
             GDALClose(dataset);
@@ -2241,7 +2254,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             }
             outDataset->GetRasterBand(1)->SetMetadataItem("LAYER_TYPE", "thematic");
             
-            GDALClose(outDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outDataset);
             // Tidy up
             for(unsigned int i = 0; i < numImages; ++i)
             {
@@ -2605,7 +2618,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             }
             rsgis::img::RSGISImageUtils imgUtils;
             imgUtils.setImageBandNames(outDataset, bandNames, true);
-            GDALClose(outDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outDataset);
             
             // Tidy up
             GDALClose(dataset);
@@ -2908,7 +2921,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             gdalRAT->SetRowCount(totNumImgs);
             ratUtils.writeStrColumn(gdalRAT, "FileName", strFileNameArr, totNumImgs);
             delete[] strFileNameArr;
-            GDALClose(outDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outDataset);
             
             // Tidy up
             for(int i = 0; i < totNumImgs; ++i)
@@ -3074,7 +3087,7 @@ void executeStretchImageWithStatsNoData(std::string inputImage, std::string outp
             }
             ratUtils.writeStrColumn(gdalRefRAT, "FileName", strFileNameArr, ratLen);
             delete[] strFileNameArr;
-            GDALClose(outRefDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outRefDataset);
             
             delete ratImgLst;
             for(std::vector<rsgis::img::RSGISCompositeInfo*>::iterator iterInfo = compInfoVec.begin(); iterInfo != compInfoVec.end(); ++iterInfo)
@@ -54,7 +54,8 @@ namespace rsgis{ namespace cmds {
         histogram,
         exponential,
         logarithmic,
-        powerLaw
+        powerLaw,
+        linearPercentile
     };
     
     enum RSGISInitSharpenBandStatus
@@ -145,11 +146,11 @@ DllExport void executeStretchImageWithStatsNoData(std::string inputImage, std::s
     /** A function to stack image bands into a single output image */
     DllExport void executeStackImageBands(std::string *imageFiles, std::string *imageBandNames, int numImages, std::string outputImage, bool skipPixels, float skipValue, float noDataValue, std::string gdalFormat, RSGISLibDataType outDataType, bool replaceBandNames);
     
-    /** A function to extract image values to a HDF file */
-    DllExport void executeImageRasterZone2HDF(std::string imageFile, std::string maskImage, std::string outputHDF, float maskVal, RSGISLibDataType dataType);
+    /** A function to extract image values to a HDF file; if nSamples > 0 only a random sample of nSamples pixels is written */
+    DllExport void executeImageRasterZone2HDF(std::string imageFile, std::string maskImage, std::string outputHDF, float maskVal, RSGISLibDataType dataType, unsigned int nSamples=0, int seed=0, bool compress=true);
         
-    /** A function to extract image band values to a HDF file */
-    DllExport void executeImageBandRasterZone2HDF(std::vector<std::pair<std::string, std::vector<unsigned int> > > imageFiles, std::string maskImage, std::string outputHDF, float maskVal, RSGISLibDataType dataType);
+    /** A function to extract image band values to a HDF file; if nSamples > 0 only a random sample of nSamples pixels is written */
+    DllExport void executeImageBandRasterZone2HDF(std::vector<std::pair<std::string, std::vector<unsigned int> > > imageFiles, std::string maskImage, std::string outputHDF, float maskVal, RSGISLibDataType dataType, unsigned int nSamples=0, int seed=0, bool compress=true);
 
     /** A function to sample a list of values saved in a HDF5 file */
     DllExport void executeRandomSampleH5File(std::string inputH5, std::string outputH5, unsigned int nSample, int seed, RSGISLibDataType dataType);
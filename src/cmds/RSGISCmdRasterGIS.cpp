@@ -312,7 +312,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-    void executePopulateRATWithPercentiles(std::string inputImage, std::string clumpsImage, unsigned int band, std::vector<rsgis::cmds::RSGISBandAttPercentilesCmds*> *bandPercentilesCmds, unsigned int ratBand, unsigned int numHistBins)
+    void executePopulateRATWithPercentiles(std::string inputImage, std::string clumpsImage, unsigned int band, std::vector<rsgis::cmds::RSGISBandAttPercentilesCmds*> *bandPercentilesCmds, unsigned int ratBand, unsigned int numHistBins, rsgisPercentileMethodCmd method, unsigned int sketchK, unsigned int maxMemMB, std::string tmpDIR)
     {
         try
         {
@@ -347,7 +347,18 @@ namespace rsgis{ namespace cmds {
             }
 
             rsgis::rastergis::RSGISPopRATWithStats popClumpStats;
-            popClumpStats.populateRATWithPercentileStats(clumpsDataset, imageDataset, band, bandPercentiles, ratBand, numHistBins);
+            if(method == rsgisPercentileSketch)
+            {
+                popClumpStats.populateRATWithPercentileStatsSketch(clumpsDataset, imageDataset, band, bandPercentiles, ratBand, sketchK);
+            }
+            else if(method == rsgisPercentileExact)
+            {
+                popClumpStats.populateRATWithPercentileStatsExact(clumpsDataset, imageDataset, band, bandPercentiles, ratBand, ((size_t)maxMemMB) * 1024 * 1024, tmpDIR);
+            }
+            else
+            {
+                popClumpStats.populateRATWithPercentileStats(clumpsDataset, imageDataset, band, bandPercentiles, ratBand, numHistBins);
+            }
 
             for(std::vector<rsgis::rastergis::RSGISBandAttPercentiles*>::iterator iterBand = bandPercentiles->begin(); iterBand != bandPercentiles->end(); ++iterBand)
             {
@@ -589,7 +600,7 @@ namespace rsgis{ namespace cmds {
 
     }
 */
-    void executeApplyKNN(std::string inClumpsImage, unsigned int ratBand, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgisKNNDistCmd distKNNCmd, float distThreshold, rsgisKNNSummeriseCmd summeriseKNNCmd) 
+    void executeApplyKNN(std::string inClumpsImage, unsigned int ratBand, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgisKNNDistCmd distKNNCmd, float distThreshold, rsgisKNNSummeriseCmd summeriseKNNCmd, float approxEps) 
     {
         GDALAllRegister();
         GDALDataset *clumpsDataset;
@@ -661,7 +672,7 @@ namespace rsgis{ namespace cmds {
             
             std::cout << "Applying KNN\n";
             rsgis::rastergis::RSGISApplyRATKNN applyKNN;
-            applyKNN.applyKNNExtrapolation(clumpsDataset, inExtrapField, outExtrapField, trainRegionsField, applyRegionsField, useApplyField, fields, kFeatures, distKNN, distThreshold, summeriseKNN, ratBand);
+            applyKNN.applyKNNExtrapolation(clumpsDataset, inExtrapField, outExtrapField, trainRegionsField, applyRegionsField, useApplyField, fields, kFeatures, distKNN, distThreshold, summeriseKNN, ratBand, approxEps);
             std::cout << "Completed KNN\n";
             
             GDALClose(clumpsDataset);
@@ -1377,7 +1388,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-    void executeInterpolateClumpValuesToImage(std::string clumpsImage, std::string selectField, std::string eastingsField, std::string northingsField, std::string methodStr, std::string valueField, std::string outputFile, std::string imageFormat, RSGISLibDataType dataType, unsigned int ratband)
+    void executeInterpolateClumpValuesToImage(std::string clumpsImage, std::string selectField, std::string eastingsField, std::string northingsField, std::string methodStr, std::string valueField, std::string outputFile, std::string imageFormat, RSGISLibDataType dataType, unsigned int ratband, unsigned int idwK, float idwP)
     {
         GDALAllRegister();
         GDALDataset *clumpsDataset;
@@ -1407,6 +1418,14 @@ namespace rsgis{ namespace cmds {
             {
                 interpolator = new rsgis::math::RSGISAllPointsIDWInterpolator(8);
             }
+            else if(methodStr == "idwknn")
+            {
+                if(idwK == 0)
+                {
+                    throw rsgis::RSGISAttributeTableException("The number of neighbours for the 'idwknn' interpolator must be greater than zero.");
+                }
+                interpolator = new rsgis::math::RSGISKNNIDWInterpolator(idwK, idwP);
+            }
             else if(methodStr == "plane")
             {
                 interpolator = new rsgis::math::RSGISLinearTrendInterpolator();
@@ -1421,7 +1440,7 @@ namespace rsgis{ namespace cmds {
             }
             else
             {
-                std::cerr << "Available Interpolators: \'nearestneighbour\', \'naturalneighbour\', \'naturalnearestneighbour\', \'knearestneighbour\', \'idwall\'\n";
+                std::cerr << "Available Interpolators: \'nearestneighbour\', \'naturalneighbour\', \'naturalnearestneighbour\', \'knearestneighbour\', \'idwall\', \'idwknn\', \'plane\', \'naturalneighbourplane\', \'nnandnn\'\n";
                 throw rsgis::RSGISAttributeTableException("The interpolated specified was not recognised.");
             }
 
@@ -70,6 +70,13 @@ namespace rsgis{ namespace cmds {
         rsgisKNNChebyshev = 4,
         rsgisKNNMinkowski = 5
     };
+    
+    enum rsgisPercentileMethodCmd
+    {
+        rsgisPercentileHistogram = 0,
+        rsgisPercentileSketch = 1,
+        rsgisPercentileExact = 2
+    };
 
     enum rsgismlpriorscmds
     {
@@ -201,8 +208,9 @@ namespace rsgis{ namespace cmds {
     /** Function for populating an attribute table from an image */
     DllExport void executePopulateRATWithStats(std::string inputImage, std::string clumpsImage, std::vector<rsgis::cmds::RSGISBandAttStatsCmds*> *bandStatsCmds, unsigned int ratBand);
 
-    /** Function for populating an attribute table with a percentile of the pixel values */
-    DllExport void executePopulateRATWithPercentiles(std::string inputImage, std::string clumpsImage, unsigned int band, std::vector<rsgis::cmds::RSGISBandAttPercentilesCmds*> *bandPercentilesCmds, unsigned int ratBand, unsigned int numHistBins);
+    /** Function for populating an attribute table with a percentile of the pixel values, using a histogram per row (numHistBins), a
+        quantile sketch per clump (sketchK) or an exact sort which uses at most maxMemMB of memory, writing sorted runs to tmpDIR */
+    DllExport void executePopulateRATWithPercentiles(std::string inputImage, std::string clumpsImage, unsigned int band, std::vector<rsgis::cmds::RSGISBandAttPercentilesCmds*> *bandPercentilesCmds, unsigned int ratBand, unsigned int numHistBins, rsgisPercentileMethodCmd method=rsgisPercentileHistogram, unsigned int sketchK=200, unsigned int maxMemMB=1024, std::string tmpDIR="");
 
     /** Function for populating the attribute table with the proporations of intersecting catagories */
     DllExport void executePopulateCategoryProportions(std::string categoriesImage, std::string clumpsImage, std::string outColsName, std::string majorityColName, bool copyClassNames, std::string majClassNameField, std::string classNameField, unsigned int ratBandClumps, unsigned int ratBandCats);
@@ -225,8 +233,8 @@ namespace rsgis{ namespace cmds {
     /** Function to calculate the features within a given spatial and spectral distance */
     //DllExport void executeFindSpecClose(std::string inputImage, std::string distanceField, std::string spatialDistField, std::string outputField, float specDistThreshold, float distThreshold);
 
-    /** Function to extrapolate values on segments using KNN, use mode for classification */
-    DllExport void executeApplyKNN(std::string inClumpsImage, unsigned int ratBand, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgisKNNDistCmd distKNNCmd, float distThreshold, rsgisKNNSummeriseCmd summeriseKNNCmd);
+    /** Function to extrapolate values on segments using KNN, use mode for classification. If approxEps > 0 an approximate nearest neighbour search is used. */
+    DllExport void executeApplyKNN(std::string inClumpsImage, unsigned int ratBand, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgisKNNDistCmd distKNNCmd, float distThreshold, rsgisKNNSummeriseCmd summeriseKNNCmd, float approxEps=0);
 
     /** Function to export columns from a GDAL RAT to ascii */
     DllExport void executeExport2Ascii(std::string inputImage, std::string outputFile, std::vector<std::string> fields, int ratBand=1);
@@ -288,8 +296,8 @@ namespace rsgis{ namespace cmds {
     /** Function to identify an extreme clump/segment with regions of the image, regions defined on a grid */
     DllExport void executeIdentifyClumpExtremesOnGrid(std::string clumpsImage, std::string inSelectField, std::string outSelectField, std::string eastingsCol, std::string northingsCol, std::string methodStr, unsigned int rows, unsigned int cols, std::string metricField);
 
-    /** Function to interpolate values from clumps to the whole image of pixels */
-    DllExport void executeInterpolateClumpValuesToImage(std::string clumpsImage, std::string selectField, std::string eastingsField, std::string northingsField, std::string methodStr, std::string valueField, std::string outputFile, std::string imageFormat, RSGISLibDataType dataType, unsigned int ratband);
+    /** Function to interpolate values from clumps to the whole image of pixels (idwK and idwP are the number of neighbours and power for the 'idwknn' method) */
+    DllExport void executeInterpolateClumpValuesToImage(std::string clumpsImage, std::string selectField, std::string eastingsField, std::string northingsField, std::string methodStr, std::string valueField, std::string outputFile, std::string imageFormat, RSGISLibDataType dataType, unsigned int ratband, unsigned int idwK=12, float idwP=2);
 
     /** Function to calculate the 'Global Segmentation Score' for the clumps using a given input image */
     //float executeFindGlobalSegmentationScore4Clumps(std::string clumpsImage, std::string inputImage, std::string colPrefix, bool calcNeighbours, float minNormV, float maxNormV, float minNormMI, float maxNormMI, std::vector<cmds::RSGISJXSegQualityScoreBandCmds> *scoreBandComps);
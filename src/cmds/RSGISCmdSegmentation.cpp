@@ -28,6 +28,7 @@
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISCalcImage.h"
+#include "img/RSGISImageBlockCache.h"
 #include "img/RSGISStretchImage.h"
 #include "img/RSGISImageUtils.h"
 
@@ -44,6 +45,7 @@
 #include "segmentation/RSGISCreateImageGrid.h"
 #include "segmentation/RSGISDropClumps.h"
 #include "segmentation/RSGISRegionGrowSegmentsPixels.h"
+#include "segmentation/RSGISShepherdSegmentation.h"
 
 #include "rastergis/RSGISRasterAttUtils.h"
 #include "rastergis/RSGISCalcImageStatsAndPyramids.h"
@@ -239,7 +241,7 @@ namespace rsgis{ namespace cmds {
         }
     }
     
-    void executeRMSmallClumpsStepwise(std::string inputImage, std::string clumpsImage, std::string outputImage, std::string imageFormat, bool stretchStatsAvail, std::string stretchStatsFile, bool storeMean, bool processInMemory, unsigned int minClumpSize, float specThreshold)
+    void executeRMSmallClumpsStepwise(std::string inputImage, std::string clumpsImage, std::string outputImage, std::string imageFormat, bool stretchStatsAvail, std::string stretchStatsFile, bool storeMean, bool processInMemory, unsigned int minClumpSize, float specThreshold, bool useRAG)
     {
         try
         {
@@ -290,7 +292,12 @@ namespace rsgis{ namespace cmds {
             
             std::cout << "Eliminant Clumps\n";
             rsgis::segment::RSGISEliminateSmallClumps eliminate;
-            if(storeMean)
+            if(useRAG)
+            {
+                // Iterative when storing the means, as with the method used below.
+                eliminate.stepwiseEliminateSmallClumpsGraph(spectralDataset, resultDataset, minClumpSize, specThreshold, bandStretchStats, stretchStatsAvail, storeMean);
+            }
+            else if(storeMean)
             {
                 //eliminate.stepwiseEliminateSmallClumps(spectralDataset, resultDataset, minClumpSize, specThreshold, bandStretchStats, stretchStatsAvail);
                 eliminate.stepwiseIterativeEliminateSmallClumps(spectralDataset, resultDataset, minClumpSize, specThreshold, bandStretchStats, stretchStatsAvail);
@@ -588,8 +595,8 @@ namespace rsgis{ namespace cmds {
             outputDataset->GetRasterBand(1)->SetMetadataItem("LAYER_TYPE", "thematic");
             borderMaskDataset->GetRasterBand(1)->SetMetadataItem("LAYER_TYPE", "thematic");
             
-            GDALClose(outputDataset);
-            GDALClose(borderMaskDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outputDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(borderMaskDataset);
         }
         catch (rsgis::RSGISException &e)
         {
@@ -620,7 +627,7 @@ namespace rsgis{ namespace cmds {
             
             borderMaskDataset->GetRasterBand(1)->SetMetadataItem("LAYER_TYPE", "thematic");
             
-            GDALClose(borderMaskDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(borderMaskDataset);
         }
         catch (rsgis::RSGISException &e)
         {
@@ -651,7 +658,7 @@ namespace rsgis{ namespace cmds {
             
             outputDataset->GetRasterBand(1)->SetMetadataItem("LAYER_TYPE", "thematic");
             
-            GDALClose(outputDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outputDataset);
         }
         catch (rsgis::RSGISException &e)
         {
@@ -708,11 +715,11 @@ namespace rsgis{ namespace cmds {
             rsgis::segment::RSGISBottomUpShapeFeatureExtraction rsgisExtractFeats;
             rsgisExtractFeats.extractBrightFeatures(inputDataset, maskDataset, outputDataset, temp1Dataset, temp2Dataset, initThres, thresIncrement, thresholdUpper, shapeFeatDescriptSegs);
             
-            GDALClose(inputDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(inputDataset);
             GDALClose(outputDataset);
             GDALClose(temp1Dataset);
             GDALClose(temp2Dataset);
-            GDALClose(maskDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(maskDataset);
         }
         catch (rsgis::RSGISException &e)
         {
@@ -763,7 +770,7 @@ namespace rsgis{ namespace cmds {
             rsgis::rastergis::RSGISPopulateWithImageStats popImageStats;
             popImageStats.populateImageWithRasterGISStats(outClumpsDataset, true, true, true, 1);
             
-            GDALClose(outClumpsDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outClumpsDataset);
         }
         catch (rsgis::RSGISException &e)
         {
@@ -861,7 +868,7 @@ namespace rsgis{ namespace cmds {
             
             rsgis::rastergis::RSGISPopulateWithImageStats popImageStats;
             popImageStats.populateImageWithRasterGISStats(outputClumpsDS, true, true, true, 1);
-            GDALClose(outputClumpsDS);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outputClumpsDS);
         }
         catch (rsgis::RSGISException &e)
         {
@@ -917,8 +924,8 @@ namespace rsgis{ namespace cmds {
             
             // Tidy up
             GDALClose(spectralDataset);
-            GDALClose(clumpDataset);
-            GDALClose(outputClumpsDS);
+            rsgis::img::RSGISImageBlockCache::closeDataset(clumpDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outputClumpsDS);
         }
         catch (rsgis::RSGISException &e)
         {
@@ -947,7 +954,7 @@ namespace rsgis{ namespace cmds {
             rsgis::segment::RSGISDropClumps dropSegs;
             dropSegs.dropSelectedClumps(clumpDataset, outputImage, selectClumpsCol, imageFormat, 1);
             
-            GDALClose(clumpDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(clumpDataset);
         }
         catch (rsgis::RSGISException &e)
         {
@@ -999,8 +1006,8 @@ namespace rsgis{ namespace cmds {
             popImageStats.populateImageWithRasterGISStats(outputClumpsDS, true, true, true, 1);
 
             // Tidy up
-            GDALClose(clumpDataset);
-            GDALClose(outputClumpsDS);
+            rsgis::img::RSGISImageBlockCache::closeDataset(clumpDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outputClumpsDS);
         }
         catch (rsgis::RSGISException &e)
         {
@@ -1060,5 +1067,67 @@ namespace rsgis{ namespace cmds {
         }
     }
     
+    void executeShepherdSegmentation(std::string inputImage, std::string outputClumps, std::string outputMeanImg, std::string tmpDIR, std::string imageFormat, bool calcStats, bool noStretch, unsigned int numClusters, unsigned int minPxls, float distThres, std::vector<unsigned int> bands, unsigned int sampling, unsigned int kmMaxIter, bool processInMemory, std::string inStretchStatsFile, std::string inKMeansCentresFile, std::string outStretchStatsFile, std::string outKMeansCentresFile)
+    {
+        GDALDataset *inDataset = NULL;
+        GDALDataset *outDataset = NULL;
+        try
+        {
+            GDALAllRegister();
+            inDataset = (GDALDataset *) GDALOpen(inputImage.c_str(), GA_ReadOnly);
+            if(inDataset == NULL)
+            {
+                std::string message = std::string("Could not open image ") + inputImage;
+                throw rsgis::RSGISImageException(message.c_str());
+            }
+            
+            rsgis::img::RSGISImageUtils imgUtils;
+            outDataset = imgUtils.createCopy(inDataset, 1, outputClumps, imageFormat, GDT_UInt32, true, "");
+            
+            if(processInMemory)
+            {
+                std::cout << "Processing in Memory\n";
+            }
+            else
+            {
+                std::cout << "Processing using Disk\n";
+            }
+            rsgis::segment::RSGISShepherdSegmentation shepherdSeg(processInMemory, tmpDIR, imageFormat);
+            shepherdSeg.performSegmentation(inDataset, bands, outDataset, noStretch, numClusters, minPxls, distThres, sampling, kmMaxIter, inStretchStatsFile, inKMeansCentresFile, outStretchStatsFile, outKMeansCentresFile);
+            
+            outDataset->GetRasterBand(1)->SetMetadataItem("LAYER_TYPE", "thematic");
+            if(calcStats)
+            {
+                rsgis::rastergis::RSGISPopulateWithImageStats popImageStats;
+                popImageStats.populateImageWithRasterGISStats(outDataset, true, true, true, 1);
+            }
+            
+            if(outputMeanImg != "")
+            {
+                std::cout << "Calculating Mean Image\n";
+                GDALDataset *meanDataset = imgUtils.createCopy(inDataset, outputMeanImg, imageFormat, inDataset->GetRasterBand(1)->GetRasterDataType(), true, "");
+                rsgis::segment::RSGISGenMeanSegImage genMeanImg;
+                genMeanImg.generateMeanImageUsingCalcImage(inDataset, outDataset, meanDataset);
+                GDALClose(meanDataset);
+            }
+            
+            // Tidy up
+            GDALClose(inDataset);
+            GDALClose(outDataset);
+        }
+        catch (std::exception &e)
+        {
+            if(outDataset != NULL)
+            {
+                GDALClose(outDataset);
+            }
+            if(inDataset != NULL)
+            {
+                GDALClose(inDataset);
+            }
+            throw rsgis::cmds::RSGISCmdException(e.what());
+        }
+    }
+    
 }}
 
@@ -71,8 +71,8 @@ namespace rsgis{ namespace cmds {
     /** Function to run the clump command */
     DllExport void executeClump(std::string inputImage, std::string outputImage, std::string imageFormat, bool processInMemory, bool noDataValProvided, float noDataVal, bool addRatPxlVals=true);
 
-    /** Function to run the iterative stepwise elimination command */
-    DllExport void executeRMSmallClumpsStepwise(std::string inputImage, std::string clumpsImage, std::string outputImage, std::string imageFormat, bool stretchStatsAvail, std::string stretchStatsFile, bool storeMean, bool processInMemory, unsigned int minClumpSize, float specThreshold);
+    /** Function to run the iterative stepwise elimination command (useRAG uses a region adjacency graph rather than accessing the image for each clump) */
+    DllExport void executeRMSmallClumpsStepwise(std::string inputImage, std::string clumpsImage, std::string outputImage, std::string imageFormat, bool stretchStatsAvail, std::string stretchStatsFile, bool storeMean, bool processInMemory, unsigned int minClumpSize, float specThreshold, bool useRAG=false);
     
     /** Function to run the relabel clumps command */
     DllExport void executeRelabelClumps(std::string inputImage, std::string outputImage, std::string imageFormat, bool processInMemory);
@@ -119,6 +119,9 @@ namespace rsgis{ namespace cmds {
     /** Function to grow regions until some termination criteria are met */
     DllExport void executePxlGrowRegions(std::string clumpsImage, std::string valsImage, std::string outputImage, std::string imageFormat, std::string muParseCriteria, std::vector<VarImgBandPairs> varNameBandPairs);
     
+    /** Function to run the segmentation algorithm of Shepherd et al. (2019) within a single process (empty strings for files which are not required) */
+    DllExport void executeShepherdSegmentation(std::string inputImage, std::string outputClumps, std::string outputMeanImg, std::string tmpDIR, std::string imageFormat, bool calcStats, bool noStretch, unsigned int numClusters, unsigned int minPxls, float distThres, std::vector<unsigned int> bands, unsigned int sampling, unsigned int kmMaxIter, bool processInMemory, std::string inStretchStatsFile, std::string inKMeansCentresFile, std::string outStretchStatsFile, std::string outKMeansCentresFile);
+    
     
 }}
 
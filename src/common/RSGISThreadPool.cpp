@@ -0,0 +1,190 @@
+/*
+ *  RSGISThreadPool.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISThreadPool.h"
+
+namespace rsgis
+{
+    std::atomic<unsigned int> RSGISThreadPool::defaultNumThreads(1);
+
+    RSGISThreadPool::RSGISThreadPool(unsigned int numThreads): numQueued(0)
+    {
+        if(numThreads == 0)
+        {
+            numThreads = RSGISThreadPool::getDefaultNumThreads();
+        }
+        this->numThreads = numThreads;
+        this->numOutstanding = 0;
+        this->nextQueue = 0;
+        this->stopping = false;
+        this->firstException = nullptr;
+
+        for(unsigned int i = 0; i < this->numThreads; ++i)
+        {
+            this->queues.push_back(new RSGISThreadPoolQueue());
+        }
+        for(unsigned int i = 0; i < this->numThreads; ++i)
+        {
+            this->workers.push_back(std::thread(&RSGISThreadPool::workerLoop, this, i));
+        }
+    }
+
+    void RSGISThreadPool::submit(RSGISThreadPoolTask task)
+    {
+        std::unique_lock<std::mutex> poolLock(this->poolMutex);
+        RSGISThreadPoolQueue *queue = this->queues[this->nextQueue];
+        this->nextQueue = (this->nextQueue + 1) % this->numThreads;
+        {
+            std::lock_guard<std::mutex> queueLock(queue->mtx);
+            queue->tasks.push_back(task);
+        }
+        ++this->numOutstanding;
+        ++this->numQueued;
+        poolLock.unlock();
+        this->workAvailable.notify_one();
+    }
+
+    void RSGISThreadPool::wait()
+    {
+        std::unique_lock<std::mutex> poolLock(this->poolMutex);
+        this->workFinished.wait(poolLock, [this]{return this->numOutstanding == 0;});
+        if(this->firstException)
+        {
+            std::exception_ptr taskException = this->firstException;
+            this->firstException = nullptr;
+            std::rethrow_exception(taskException);
+        }
+    }
+
+    bool RSGISThreadPool::popTask(unsigned int threadIdx, RSGISThreadPoolTask &task)
+    {
+        // Take the most recently queued task from this worker's own queue.
+        {
+            RSGISThreadPoolQueue *queue = this->queues[threadIdx];
+            std::lock_guard<std::mutex> queueLock(queue->mtx);
+            if(!queue->tasks.empty())
+            {
+                task = queue->tasks.back();
+                queue->tasks.pop_back();
+                --this->numQueued;
+                return true;
+            }
+        }
+
+        // Otherwise steal the oldest task from another worker.
+        for(unsigned int i = 1; i < this->numThreads; ++i)
+        {
+            RSGISThreadPoolQueue *queue = this->queues[(threadIdx + i) % this->numThreads];
+            std::lock_guard<std::mutex> queueLock(queue->mtx);
+            if(!queue->tasks.empty())
+            {
+                task = queue->tasks.front();
+                queue->tasks.pop_front();
+                --this->numQueued;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void RSGISThreadPool::workerLoop(unsigned int threadIdx)
+    {
+        RSGISThreadPoolTask task;
+        while(true)
+        {
+            if(this->popTask(threadIdx, task))
+            {
+                try
+                {
+                    task(threadIdx);
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> poolLock(this->poolMutex);
+                    if(!this->firstException)
+                    {
+                        this->firstException = std::current_exception();
+                    }
+                }
+                task = nullptr;
+
+                std::lock_guard<std::mutex> poolLock(this->poolMutex);
+                --this->numOutstanding;
+                if(this->numOutstanding == 0)
+                {
+                    this->workFinished.notify_all();
+                }
+            }
+            else
+            {
+                std::unique_lock<std::mutex> poolLock(this->poolMutex);
+                this->workAvailable.wait(poolLock, [this]{return this->stopping || (this->numQueued > 0);});
+                if(this->stopping && (this->numQueued == 0))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    RSGISThreadPool::~RSGISThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> poolLock(this->poolMutex);
+            this->stopping = true;
+        }
+        this->workAvailable.notify_all();
+        for(std::vector<std::thread>::iterator iterThread = this->workers.begin(); iterThread != this->workers.end(); ++iterThread)
+        {
+            (*iterThread).join();
+        }
+        for(std::vector<RSGISThreadPoolQueue*>::iterator iterQueue = this->queues.begin(); iterQueue != this->queues.end(); ++iterQueue)
+        {
+            delete (*iterQueue);
+        }
+    }
+
+    void RSGISThreadPool::setDefaultNumThreads(unsigned int numThreads)
+    {
+        if(numThreads == 0)
+        {
+            numThreads = RSGISThreadPool::getNumCores();
+        }
+        RSGISThreadPool::defaultNumThreads = numThreads;
+    }
+
+    unsigned int RSGISThreadPool::getDefaultNumThreads()
+    {
+        return RSGISThreadPool::defaultNumThreads;
+    }
+
+    unsigned int RSGISThreadPool::getNumCores()
+    {
+        unsigned int numCores = std::thread::hardware_concurrency();
+        if(numCores == 0)
+        {
+            numCores = 1;
+        }
+        return numCores;
+    }
+
+}
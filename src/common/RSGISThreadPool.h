@@ -0,0 +1,107 @@
+/*
+ *  RSGISThreadPool.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISThreadPool_H
+#define RSGISThreadPool_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_commons_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis
+{
+    /**
+     * A task run by the thread pool. The index of the worker thread
+     * (0 to numThreads-1) executing the task is passed so tasks can
+     * use per-thread state (e.g., buffers or cloned functors).
+     */
+    typedef std::function<void(unsigned int)> RSGISThreadPoolTask;
+
+    /**
+     * A work-stealing thread pool. Each worker has its own task queue which
+     * it processes from the back; when empty it steals from the front of the
+     * other workers' queues. Exceptions thrown by tasks are caught and the
+     * first is re-thrown from wait().
+     */
+    class DllExport RSGISThreadPool
+    {
+    public:
+        RSGISThreadPool(unsigned int numThreads=0);
+        void submit(RSGISThreadPoolTask task);
+        void wait();
+        unsigned int getNumThreads(){return this->numThreads;};
+        ~RSGISThreadPool();
+
+        /** Set the number of threads used by default across the library (0 = number of cores). */
+        static void setDefaultNumThreads(unsigned int numThreads);
+        /** Get the number of threads used by default across the library (default = 1). */
+        static unsigned int getDefaultNumThreads();
+        /** Get the number of hardware threads available on the machine. */
+        static unsigned int getNumCores();
+    protected:
+        struct RSGISThreadPoolQueue
+        {
+            std::mutex mtx;
+            std::deque<RSGISThreadPoolTask> tasks;
+        };
+
+        void workerLoop(unsigned int threadIdx);
+        bool popTask(unsigned int threadIdx, RSGISThreadPoolTask &task);
+
+        unsigned int numThreads;
+        std::vector<std::thread> workers;
+        std::vector<RSGISThreadPoolQueue*> queues;
+        std::mutex poolMutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workFinished;
+        std::atomic<unsigned long> numQueued;
+        unsigned long numOutstanding;
+        unsigned int nextQueue;
+        bool stopping;
+        std::exception_ptr firstException;
+
+        static std::atomic<unsigned int> defaultNumThreads;
+    };
+
+}
+
+#endif
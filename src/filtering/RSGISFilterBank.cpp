@@ -75,7 +75,14 @@ namespace rsgis{namespace filter{
 	{
 		try
 		{
+			int numOutBands = 0;
+			for(int n = 0; n < numDS; n++)
+			{
+				numOutBands += datasets[n]->GetRasterCount();
+			}
+			
 			std::string filename = outImageBase + this->filters->at(i)->getFileNameEnding();
+			dynamic_cast<rsgis::img::RSGISCalcImageValue*>(this->filters->at(i))->setNumOutBands(numOutBands);
 			this->filters->at(i)->runFilter(datasets, numDS, filename, gdalFormat, outDataType);
 		}
 		catch(rsgis::RSGISImageException &e)
@@ -24,9 +24,55 @@
 
 namespace rsgis{namespace filter{
 
-	RSGISImageKernelFilter::RSGISImageKernelFilter(int numberOutBands, int size, std::string filenameEnding, ImageFilter *filter) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+	RSGISImageKernelFilter::RSGISImageKernelFilter(int numberOutBands, int size, std::string filenameEnding, ImageFilter *filter) : RSGISStripWindowFilter(numberOutBands, size, filenameEnding)
 	{
 		this->filter = filter;
+		this->separable = false;
+
+		if(filter->size == size)
+		{
+			// Split the kernel into column and row vectors using the row and
+			// column of the largest value and check they reproduce the kernel.
+			int pivotRow = 0;
+			int pivotCol = 0;
+			double maxAbsVal = 0;
+			for(int j = 0; j < size; j++)
+			{
+				for(int k = 0; k < size; k++)
+				{
+					if(std::fabs(filter->filter[j][k]) > maxAbsVal)
+					{
+						maxAbsVal = std::fabs(filter->filter[j][k]);
+						pivotRow = j;
+						pivotCol = k;
+					}
+				}
+			}
+
+			if(maxAbsVal > 0)
+			{
+				this->colKernel.resize(size);
+				this->rowKernel.resize(size);
+				for(int i = 0; i < size; i++)
+				{
+					this->colKernel[i] = filter->filter[i][pivotCol];
+					this->rowKernel[i] = ((double)filter->filter[pivotRow][i]) / filter->filter[pivotRow][pivotCol];
+				}
+
+				this->separable = true;
+				for(int j = 0; (j < size) && this->separable; j++)
+				{
+					for(int k = 0; k < size; k++)
+					{
+						if(std::fabs(filter->filter[j][k] - (this->colKernel[j] * this->rowKernel[k])) > (maxAbsVal * 1e-6))
+						{
+							this->separable = false;
+							break;
+						}
+					}
+				}
+			}
+		}
 	}
 	
 	void RSGISImageKernelFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
@@ -52,6 +98,111 @@ namespace rsgis{namespace filter{
 		}
 	}
 	
+	void RSGISImageKernelFilter::filterStrip(std::vector<float> &stripVals, unsigned int numRows, unsigned int bufWidth, unsigned int width, double *outVals, rsgis::RSGISThreadPool *threadPool)
+	{
+		if(this->filter->size != this->size)
+		{
+			throw rsgis::img::RSGISImageCalcException("Filter Size and window size do not match.");
+		}
+
+		const unsigned int rowsPerTask = 16;
+		unsigned int numThreads = threadPool->getNumThreads();
+		const float *vals = stripVals.data();
+		for(unsigned int row = 0; row < numRows; row += rowsPerTask)
+		{
+			unsigned int endRow = std::min(row + rowsPerTask, numRows);
+			if(numThreads > 1)
+			{
+				threadPool->submit([this, row, endRow, bufWidth, width, vals, outVals](unsigned int threadIdx)
+				{
+					if(this->separable)
+					{
+						this->filterStripRowsSeparable(row, endRow, bufWidth, width, vals, outVals);
+					}
+					else
+					{
+						this->filterStripRows2D(row, endRow, bufWidth, width, vals, outVals);
+					}
+				});
+			}
+			else if(this->separable)
+			{
+				this->filterStripRowsSeparable(row, endRow, bufWidth, width, vals, outVals);
+			}
+			else
+			{
+				this->filterStripRows2D(row, endRow, bufWidth, width, vals, outVals);
+			}
+		}
+		if(numThreads > 1)
+		{
+			threadPool->wait();
+		}
+	}
+
+	void RSGISImageKernelFilter::filterStripRowsSeparable(unsigned int startRow, unsigned int endRow, unsigned int bufWidth, unsigned int width, const float *stripVals, double *outVals)
+	{
+		unsigned int size = this->size;
+		unsigned int numBufRows = (endRow - startRow) + size - 1;
+
+		// Horizontal pass over every buffer row needed by the output rows.
+		std::vector<double> rowFiltered(((size_t)numBufRows) * width, 0);
+		for(unsigned int r = 0; r < numBufRows; ++r)
+		{
+			const float *inRow = &stripVals[((size_t)(startRow + r)) * bufWidth];
+			double *hRow = &rowFiltered[((size_t)r) * width];
+			for(unsigned int k = 0; k < size; ++k)
+			{
+				const double kVal = this->rowKernel[k];
+				const float *inVals = inRow + k;
+				for(unsigned int x = 0; x < width; ++x)
+				{
+					hRow[x] += kVal * inVals[x];
+				}
+			}
+		}
+
+		// Vertical pass.
+		for(unsigned int row = startRow; row < endRow; ++row)
+		{
+			double *outRow = &outVals[((size_t)row) * width];
+			std::fill(outRow, outRow + width, 0.0);
+			for(unsigned int j = 0; j < size; ++j)
+			{
+				const double kVal = this->colKernel[j];
+				const double *hRow = &rowFiltered[((size_t)((row - startRow) + j)) * width];
+				for(unsigned int x = 0; x < width; ++x)
+				{
+					outRow[x] += kVal * hRow[x];
+				}
+			}
+		}
+	}
+
+	void RSGISImageKernelFilter::filterStripRows2D(unsigned int startRow, unsigned int endRow, unsigned int bufWidth, unsigned int width, const float *stripVals, double *outVals)
+	{
+		// The kernel values are summed in the same order as calcImageValue.
+		unsigned int size = this->size;
+		for(unsigned int row = startRow; row < endRow; ++row)
+		{
+			double *outRow = &outVals[((size_t)row) * width];
+			std::fill(outRow, outRow + width, 0.0);
+			for(unsigned int j = 0; j < size; ++j)
+			{
+				const float *inRow = &stripVals[((size_t)(row + j)) * bufWidth];
+				for(unsigned int k = 0; k < size; ++k)
+				{
+					const float kVal = this->filter->filter[j][k];
+					const float *inVals = inRow + k;
+					for(unsigned int x = 0; x < width; ++x)
+					{
+						outRow[x] += inVals[x] * kVal;
+					}
+				}
+			}
+		}
+	}
+
 	bool RSGISImageKernelFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) 
 	{
 		throw rsgis::img::RSGISImageCalcException("Not implemented");
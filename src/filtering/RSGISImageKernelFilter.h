@@ -25,6 +25,8 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <cmath>
 
 #include "common/RSGISImageException.h"
 
@@ -33,6 +35,7 @@
 #include "img/RSGISCalcImage.h"
 #include "img/RSGISCalcImageValue.h"
 #include "filtering/RSGISImageFilter.h"
+#include "filtering/RSGISSlidingWindowFilters.h"
 
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
@@ -50,16 +53,32 @@
 namespace rsgis{namespace filter{
 	
 	
-	class DllExport RSGISImageKernelFilter : public RSGISImageFilter
+	/**
+	 * Convolves the image with a kernel (e.g., generated by RSGISGenerateFilter).
+	 * If the kernel is separable (i.e., the outer product of a column and a row
+	 * vector, as for the Gaussian smoothing and 1st derivative kernels) the
+	 * image is filtered with two 1D passes, a cost of 2 x size rather than
+	 * size x size per pixel. Otherwise the 2D kernel is applied directly to the
+	 * rows of each strip. Either way the inner loops run along contiguous rows
+	 * so they can be vectorised by the compiler.
+	 */
+	class DllExport RSGISImageKernelFilter : public RSGISStripWindowFilter
 		{
 		public: 
 			RSGISImageKernelFilter(int numberOutBands, int size, std::string filenameEnding, ImageFilter *filter);
 			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
 			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
 			virtual void exportAsImage(std::string filename);
+			bool isSeparable(){return this->separable;};
 			~RSGISImageKernelFilter();
 		protected:
+			virtual void filterStrip(std::vector<float> &stripVals, unsigned int numRows, unsigned int bufWidth, unsigned int width, double *outVals, rsgis::RSGISThreadPool *threadPool);
+			void filterStripRowsSeparable(unsigned int startRow, unsigned int endRow, unsigned int bufWidth, unsigned int width, const float *stripVals, double *outVals);
+			void filterStripRows2D(unsigned int startRow, unsigned int endRow, unsigned int bufWidth, unsigned int width, const float *stripVals, double *outVals);
 			ImageFilter *filter;
+			bool separable;
+			std::vector<double> colKernel;
+			std::vector<double> rowKernel;
 		};
 }}
 
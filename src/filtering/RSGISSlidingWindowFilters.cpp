@@ -0,0 +1,738 @@
+/*
+ *  RSGISSlidingWindowFilters.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISSlidingWindowFilters.h"
+
+namespace rsgis{namespace filter{
+
+    // Value ordering used for ranking, NaN values are ordered after all other values.
+    static inline bool rsgisSlidingValLess(float a, float b)
+    {
+        return (a < b) || (std::isnan(b) && !std::isnan(a));
+    }
+
+    static inline bool rsgisSlidingValEqual(float a, float b)
+    {
+        return (a == b) || (std::isnan(a) && std::isnan(b));
+    }
+
+
+    RSGISSlidingHistogram::RSGISSlidingHistogram(unsigned int numTrackers)
+    {
+        this->trackers.resize(numTrackers);
+        this->reset(0);
+    }
+
+    void RSGISSlidingHistogram::reset(unsigned int numBins)
+    {
+        this->numBins = numBins;
+        this->counts.assign(numBins, 0);
+        this->coarseCounts.assign((numBins + 63) >> 6, 0);
+        for(std::vector<RSGISSlidingHistTracker>::iterator iterTracker = this->trackers.begin(); iterTracker != this->trackers.end(); ++iterTracker)
+        {
+            (*iterTracker).pos = 0;
+            (*iterTracker).below = 0;
+        }
+        this->total = 0;
+        this->resetMode();
+    }
+
+    unsigned int RSGISSlidingHistogram::getRankBin(unsigned int tracker, unsigned int rank)
+    {
+        if(rank >= this->total)
+        {
+            throw rsgis::img::RSGISImageCalcException("Rank is outside of the histogram.");
+        }
+        RSGISSlidingHistTracker &tr = this->trackers[tracker];
+
+        // Move down until there are no more than 'rank' values below the tracked bin.
+        while(tr.below > rank)
+        {
+            if(((tr.pos & 63) == 0) && (tr.pos >= 64) && ((tr.below - this->coarseCounts[(tr.pos >> 6) - 1]) > rank))
+            {
+                tr.pos -= 64;
+                tr.below -= this->coarseCounts[tr.pos >> 6];
+            }
+            else
+            {
+                --tr.pos;
+                tr.below -= this->counts[tr.pos];
+            }
+        }
+
+        // Move up until the tracked bin holds the value with the rank.
+        while((tr.below + this->counts[tr.pos]) <= rank)
+        {
+            if(((tr.pos & 63) == 0) && ((tr.below + this->coarseCounts[tr.pos >> 6]) <= rank))
+            {
+                tr.below += this->coarseCounts[tr.pos >> 6];
+                tr.pos += 64;
+            }
+            else
+            {
+                tr.below += this->counts[tr.pos];
+                ++tr.pos;
+            }
+        }
+        return tr.pos;
+    }
+
+    RSGISSlidingHistogram::~RSGISSlidingHistogram()
+    {
+
+    }
+
+
+    RSGISStripWindowFilter::RSGISStripWindowFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+    {
+
+    }
+
+    void RSGISStripWindowFilter::runFilter(GDALDataset **datasets, int numDS, std::string outputImage, std::string gdalFormat, GDALDataType outDataType)
+    {
+        if(this->size % 2 == 0)
+        {
+            throw rsgis::img::RSGISImageCalcException("Window size needs to be an odd number (min = 3).");
+        }
+        else if(this->size < 3)
+        {
+            throw rsgis::img::RSGISImageCalcException("Window size needs to be 3 or greater and an odd number.");
+        }
+
+        GDALAllRegister();
+        rsgis::img::RSGISImageUtils imgUtils;
+        double gdalTranslation[6];
+        std::vector<int> dsOffsetsMem(numDS*2, 0);
+        std::vector<int*> dsOffsets(numDS);
+        for(int i = 0; i < numDS; i++)
+        {
+            dsOffsets[i] = &dsOffsetsMem[i*2];
+        }
+        int width = 0;
+        int height = 0;
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        GDALDataset *outputImageDS = NULL;
+
+        try
+        {
+            imgUtils.getImageOverlap(datasets, numDS, dsOffsets.data(), &width, &height, gdalTranslation, &xBlockSize, &yBlockSize);
+
+            std::vector<GDALRasterBand*> inputRasterBands;
+            std::vector<int> bandXOffs;
+            std::vector<int> bandYOffs;
+            for(int i = 0; i < numDS; i++)
+            {
+                for(int j = 0; j < datasets[i]->GetRasterCount(); j++)
+                {
+                    inputRasterBands.push_back(datasets[i]->GetRasterBand(j+1));
+                    bandXOffs.push_back(dsOffsets[i][0]);
+                    bandYOffs.push_back(dsOffsets[i][1]);
+                }
+            }
+            int numInBands = inputRasterBands.size();
+            if(numInBands != this->numOutBands)
+            {
+                throw rsgis::img::RSGISImageCalcException("The number of output bands must be the same as the number of input image bands.");
+            }
+
+            // Create new Image
+            GDALDriver *gdalDriver = GetGDALDriverManager()->GetDriverByName(gdalFormat.c_str());
+            if(gdalDriver == NULL)
+            {
+                throw rsgis::img::RSGISImageBandException("Driver does not exists..");
+            }
+            char **papszOptions = imgUtils.getGDALCreationOptionsForFormat(gdalFormat);
+            outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, outDataType, papszOptions);
+            if(outputImageDS == NULL)
+            {
+                throw rsgis::img::RSGISImageBandException("Output image could not be created. Check filepath.");
+            }
+            outputImageDS->SetGeoTransform(gdalTranslation);
+            outputImageDS->SetProjection(datasets[0]->GetProjectionRef());
+
+            if(yBlockSize < 1)
+            {
+                yBlockSize = 1;
+            }
+            unsigned int stripRows = yBlockSize * std::max(1, 64/yBlockSize);
+            unsigned int hWin = this->size / 2;
+            unsigned int bufWidth = width + (2 * hWin);
+
+            std::vector<float> stripVals;
+            std::vector<double> outVals(((size_t)stripRows) * width);
+            rsgis::RSGISThreadPool threadPool(rsgis::RSGISThreadPool::getDefaultNumThreads());
+
+            unsigned int numStrips = (height + stripRows - 1) / stripRows;
+            unsigned int nStep = 0;
+            rsgis_tqdm pbar;
+            for(unsigned int rowStart = 0; rowStart < ((unsigned int)height); rowStart += stripRows)
+            {
+                unsigned int numRows = std::min(stripRows, height - rowStart);
+                unsigned int bufRows = numRows + (2 * hWin);
+                // The first image row read and its row within the buffer (rows above the image stay 0).
+                unsigned int firstImgRow = (rowStart > hWin)?(rowStart - hWin):0;
+                unsigned int lastImgRow = std::min(rowStart + numRows + hWin, (unsigned int)height);
+                unsigned int firstBufRow = firstImgRow + hWin - rowStart;
+
+                for(int n = 0; n < numInBands; n++)
+                {
+                    pbar.progress(nStep++, numStrips * numInBands);
+
+                    stripVals.assign(((size_t)bufRows) * bufWidth, 0);
+                    if(inputRasterBands[n]->RasterIO(GF_Read, bandXOffs[n], bandYOffs[n] + firstImgRow, width, (lastImgRow - firstImgRow), &stripVals[(((size_t)firstBufRow) * bufWidth) + hWin], width, (lastImgRow - firstImgRow), GDT_Float32, sizeof(float), bufWidth * sizeof(float)) != CE_None)
+                    {
+                        throw rsgis::img::RSGISImageCalcException("Could not read image block from input image.");
+                    }
+
+                    this->filterStrip(stripVals, numRows, bufWidth, width, outVals.data(), &threadPool);
+
+                    if(outputImageDS->GetRasterBand(n+1)->RasterIO(GF_Write, 0, rowStart, width, numRows, outVals.data(), width, numRows, GDT_Float64, 0, 0) != CE_None)
+                    {
+                        throw rsgis::img::RSGISImageCalcException("Could not write image block to output image.");
+                    }
+                }
+            }
+            pbar.finish();
+
+            GDALClose(outputImageDS);
+        }
+        catch(rsgis::RSGISImageException &e)
+        {
+            if(outputImageDS != NULL)
+            {
+                GDALClose(outputImageDS);
+            }
+            throw e;
+        }
+        catch(std::exception &e)
+        {
+            if(outputImageDS != NULL)
+            {
+                GDALClose(outputImageDS);
+            }
+            throw rsgis::img::RSGISImageCalcException(e.what());
+        }
+    }
+
+    RSGISStripWindowFilter::~RSGISStripWindowFilter()
+    {
+
+    }
+
+
+    RSGISSlidingWindowFilter::RSGISSlidingWindowFilter(int numberOutBands, int size, std::string filenameEnding, SlidingWindowStat stat, float percentile) : RSGISStripWindowFilter(numberOutBands, size, filenameEnding)
+    {
+        if((percentile < 0) || (percentile > 100))
+        {
+            throw rsgis::img::RSGISImageCalcException("The percentile must be between 0 and 100.");
+        }
+        this->stat = stat;
+        this->percentile = percentile;
+    }
+
+    void RSGISSlidingWindowFilter::filterStrip(std::vector<float> &stripVals, unsigned int numRows, unsigned int bufWidth, unsigned int width, double *outVals, rsgis::RSGISThreadPool *threadPool)
+    {
+        this->binStripValues(stripVals, this->stripBins, this->binVals);
+
+        unsigned int numThreads = threadPool->getNumThreads();
+        unsigned int numTrackers = (this->stat == statRange)?2:1;
+        if(this->hists.size() != numThreads)
+        {
+            this->hists.assign(numThreads, RSGISSlidingHistogram(numTrackers));
+        }
+        for(std::vector<RSGISSlidingHistogram>::iterator iterHist = this->hists.begin(); iterHist != this->hists.end(); ++iterHist)
+        {
+            (*iterHist).reset(this->binVals.size());
+        }
+
+        if(numThreads > 1)
+        {
+            for(unsigned int row = 0; row < numRows; ++row)
+            {
+                threadPool->submit([this, row, bufWidth, width, outVals](unsigned int threadIdx)
+                {
+                    this->filterStripRow(row, bufWidth, width, this->stripBins, this->binVals, &this->hists[threadIdx], &outVals[((size_t)row) * width]);
+                });
+            }
+            threadPool->wait();
+        }
+        else
+        {
+            for(unsigned int row = 0; row < numRows; ++row)
+            {
+                this->filterStripRow(row, bufWidth, width, this->stripBins, this->binVals, &this->hists[0], &outVals[((size_t)row) * width]);
+            }
+        }
+    }
+
+    void RSGISSlidingWindowFilter::binStripValues(std::vector<float> &stripVals, std::vector<unsigned int> &stripBins, std::vector<float> &binVals)
+    {
+        stripBins.resize(stripVals.size());
+
+        // Whole numbers within a limited range are binned by value.
+        bool binByValue = true;
+        float minVal = stripVals[0];
+        float maxVal = stripVals[0];
+        for(std::vector<float>::iterator iterVal = stripVals.begin(); iterVal != stripVals.end(); ++iterVal)
+        {
+            if((!std::isfinite(*iterVal)) || ((*iterVal) != std::floor(*iterVal)) || (std::fabs(*iterVal) > 16777216))
+            {
+                binByValue = false;
+                break;
+            }
+            if((*iterVal) < minVal)
+            {
+                minVal = *iterVal;
+            }
+            else if((*iterVal) > maxVal)
+            {
+                maxVal = *iterVal;
+            }
+        }
+
+        if(binByValue && ((maxVal - minVal) < 1048576))
+        {
+            unsigned int numBins = ((unsigned int)(maxVal - minVal)) + 1;
+            binVals.resize(numBins);
+            for(unsigned int i = 0; i < numBins; ++i)
+            {
+                binVals[i] = minVal + i;
+            }
+            for(size_t i = 0; i < stripVals.size(); ++i)
+            {
+                stripBins[i] = (unsigned int)(stripVals[i] - minVal);
+            }
+        }
+        else
+        {
+            // Otherwise the bins are the sorted unique values within the strip.
+            binVals.assign(stripVals.begin(), stripVals.end());
+            std::sort(binVals.begin(), binVals.end(), rsgisSlidingValLess);
+            binVals.erase(std::unique(binVals.begin(), binVals.end(), rsgisSlidingValEqual), binVals.end());
+            for(size_t i = 0; i < stripVals.size(); ++i)
+            {
+                stripBins[i] = std::lower_bound(binVals.begin(), binVals.end(), stripVals[i], rsgisSlidingValLess) - binVals.begin();
+            }
+        }
+    }
+
+    void RSGISSlidingWindowFilter::filterStripRow(unsigned int row, unsigned int bufWidth, unsigned int width, std::vector<unsigned int> &stripBins, std::vector<float> &binVals, RSGISSlidingHistogram *hist, double *outRow)
+    {
+        // The window for output row 'row' covers buffer rows row to row+size-1.
+        const unsigned int *winBins = &stripBins[((size_t)row) * bufWidth];
+        unsigned int size = this->size;
+
+        hist->resetMode();
+        for(unsigned int j = 0; j < size; ++j)
+        {
+            for(unsigned int k = 0; k < size; ++k)
+            {
+                hist->add(winBins[(j * bufWidth) + k]);
+            }
+        }
+        outRow[0] = this->getWindowStat(hist, binVals, winBins, bufWidth);
+
+        for(unsigned int x = 1; x < width; ++x)
+        {
+            for(unsigned int j = 0; j < size; ++j)
+            {
+                hist->remove(winBins[(j * bufWidth) + (x - 1)]);
+                hist->add(winBins[(j * bufWidth) + (x + size - 1)]);
+            }
+            outRow[x] = this->getWindowStat(hist, binVals, winBins + x, bufWidth);
+        }
+
+        // Empty the histogram ready for the next row.
+        for(unsigned int j = 0; j < size; ++j)
+        {
+            for(unsigned int k = 0; k < size; ++k)
+            {
+                hist->remove(winBins[(j * bufWidth) + (width - 1) + k]);
+            }
+        }
+    }
+
+    inline double RSGISSlidingWindowFilter::getWindowStat(RSGISSlidingHistogram *hist, std::vector<float> &binVals, const unsigned int *winBins, unsigned int bufWidth)
+    {
+        unsigned int numVals = this->size * this->size;
+        double outVal = 0;
+        if(this->stat == statMedian)
+        {
+            outVal = binVals[hist->getRankBin(0, numVals/2)];
+        }
+        else if(this->stat == statPercentile)
+        {
+            outVal = binVals[hist->getRankBin(0, this->getPercentileRank(numVals))];
+        }
+        else if(this->stat == statMin)
+        {
+            outVal = binVals[hist->getRankBin(0, 0)];
+        }
+        else if(this->stat == statMax)
+        {
+            outVal = binVals[hist->getRankBin(0, numVals-1)];
+        }
+        else if(this->stat == statRange)
+        {
+            outVal = binVals[hist->getRankBin(1, numVals-1)] - binVals[hist->getRankBin(0, 0)];
+        }
+        else if(this->stat == statMode)
+        {
+            unsigned int modeBin = 0;
+            if(!hist->getModeBin(&modeBin))
+            {
+                // The previous mode has left the window so find it from the window values.
+                hist->resetMode();
+                for(int j = 0; j < this->size; ++j)
+                {
+                    for(int k = 0; k < this->size; ++k)
+                    {
+                        hist->considerModeBin(winBins[(j * bufWidth) + k]);
+                    }
+                }
+                hist->getModeBin(&modeBin);
+            }
+            outVal = binVals[modeBin];
+        }
+        return outVal;
+    }
+
+    unsigned int RSGISSlidingWindowFilter::getPercentileRank(unsigned int numVals)
+    {
+        unsigned int rank = floor((this->percentile / 100.0) * numVals);
+        if(rank >= numVals)
+        {
+            rank = numVals - 1;
+        }
+        return rank;
+    }
+
+    void RSGISSlidingWindowFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output)
+    {
+        if(this->size != winSize)
+        {
+            throw rsgis::img::RSGISImageCalcException("Window sizes are different");
+        }
+
+        unsigned int numVals = winSize * winSize;
+        std::vector<float> sortedList;
+        sortedList.reserve(numVals);
+
+        for(int i = 0; i < numBands; i++)
+        {
+            sortedList.clear();
+            for(int j = 0; j < winSize; j++)
+            {
+                for(int k = 0; k < winSize; k++)
+                {
+                    sortedList.push_back(dataBlock[i][j][k]);
+                }
+            }
+            std::sort(sortedList.begin(), sortedList.end(), rsgisSlidingValLess);
+
+            if(this->stat == statMedian)
+            {
+                output[i] = sortedList[numVals/2];
+            }
+            else if(this->stat == statPercentile)
+            {
+                output[i] = sortedList[this->getPercentileRank(numVals)];
+            }
+            else if(this->stat == statMin)
+            {
+                output[i] = sortedList[0];
+            }
+            else if(this->stat == statMax)
+            {
+                output[i] = sortedList[numVals-1];
+            }
+            else if(this->stat == statRange)
+            {
+                output[i] = sortedList[numVals-1] - sortedList[0];
+            }
+            else if(this->stat == statMode)
+            {
+                // The longest run of equal values, the lowest value for ties.
+                unsigned int maxCount = 0;
+                unsigned int count = 0;
+                for(unsigned int n = 0; n < numVals; ++n)
+                {
+                    if((n > 0) && rsgisSlidingValEqual(sortedList[n], sortedList[n-1]))
+                    {
+                        ++count;
+                    }
+                    else
+                    {
+                        count = 1;
+                    }
+                    if(count > maxCount)
+                    {
+                        maxCount = count;
+                        output[i] = sortedList[n];
+                    }
+                }
+            }
+        }
+    }
+
+    bool RSGISSlidingWindowFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output)
+    {
+        throw rsgis::img::RSGISImageCalcException("Not implemented yet");
+    }
+
+    void RSGISSlidingWindowFilter::exportAsImage(std::string filename)
+    {
+        std::cout << "No Image to output\n";
+    }
+
+    RSGISSlidingWindowFilter::~RSGISSlidingWindowFilter()
+    {
+
+    }
+
+
+    RSGISBoxWindowFilter::RSGISBoxWindowFilter(int numberOutBands, int size, std::string filenameEnding, BoxWindowStat stat) : RSGISStripWindowFilter(numberOutBands, size, filenameEnding)
+    {
+        this->stat = stat;
+    }
+
+    void RSGISBoxWindowFilter::filterStrip(std::vector<float> &stripVals, unsigned int numRows, unsigned int bufWidth, unsigned int width, double *outVals, rsgis::RSGISThreadPool *threadPool)
+    {
+        // Shift the values by the rounded mean of the strip.
+        double sum = 0;
+        size_t numFinite = 0;
+        for(std::vector<float>::iterator iterVal = stripVals.begin(); iterVal != stripVals.end(); ++iterVal)
+        {
+            if(std::isfinite(*iterVal))
+            {
+                sum += *iterVal;
+                ++numFinite;
+            }
+        }
+        double shift = 0;
+        if(numFinite > 0)
+        {
+            shift = std::floor((sum / numFinite) + 0.5);
+        }
+
+        // The column sums are recalculated at the start of each set of rows.
+        const unsigned int rowsPerTask = 16;
+        unsigned int numThreads = threadPool->getNumThreads();
+        const float *vals = stripVals.data();
+        if(numThreads > 1)
+        {
+            for(unsigned int row = 0; row < numRows; row += rowsPerTask)
+            {
+                unsigned int endRow = std::min(row + rowsPerTask, numRows);
+                threadPool->submit([this, row, endRow, bufWidth, width, vals, shift, outVals](unsigned int threadIdx)
+                {
+                    this->filterStripRows(row, endRow, bufWidth, width, vals, shift, outVals);
+                });
+            }
+            threadPool->wait();
+        }
+        else
+        {
+            for(unsigned int row = 0; row < numRows; row += rowsPerTask)
+            {
+                this->filterStripRows(row, std::min(row + rowsPerTask, numRows), bufWidth, width, vals, shift, outVals);
+            }
+        }
+    }
+
+    void RSGISBoxWindowFilter::filterStripRows(unsigned int startRow, unsigned int endRow, unsigned int bufWidth, unsigned int width, const float *stripVals, double shift, double *outVals)
+    {
+        unsigned int size = this->size;
+        std::vector<double> colSums(bufWidth, 0);
+        std::vector<double> colSqSums(bufWidth, 0);
+        std::vector<unsigned int> colNonFinite(bufWidth, 0);
+
+        for(unsigned int row = startRow; row < endRow; ++row)
+        {
+            if(row == startRow)
+            {
+                for(unsigned int j = 0; j < size; ++j)
+                {
+                    const float *bufRow = &stripVals[((size_t)(row + j)) * bufWidth];
+                    for(unsigned int x = 0; x < bufWidth; ++x)
+                    {
+                        if(std::isfinite(bufRow[x]))
+                        {
+                            double val = bufRow[x] - shift;
+                            colSums[x] += val;
+                            colSqSums[x] += val * val;
+                        }
+                        else
+                        {
+                            ++colNonFinite[x];
+                        }
+                    }
+                }
+            }
+            else
+            {
+                // Remove the row which has left the window and add the new row.
+                const float *oldRow = &stripVals[((size_t)(row - 1)) * bufWidth];
+                const float *newRow = &stripVals[((size_t)(row + size - 1)) * bufWidth];
+                for(unsigned int x = 0; x < bufWidth; ++x)
+                {
+                    if(std::isfinite(oldRow[x]))
+                    {
+                        double val = oldRow[x] - shift;
+                        colSums[x] -= val;
+                        colSqSums[x] -= val * val;
+                    }
+                    else
+                    {
+                        --colNonFinite[x];
+                    }
+                    if(std::isfinite(newRow[x]))
+                    {
+                        double val = newRow[x] - shift;
+                        colSums[x] += val;
+                        colSqSums[x] += val * val;
+                    }
+                    else
+                    {
+                        ++colNonFinite[x];
+                    }
+                }
+            }
+
+            double winSum = 0;
+            double winSqSum = 0;
+            unsigned int winNonFinite = 0;
+            for(unsigned int k = 0; k < size; ++k)
+            {
+                winSum += colSums[k];
+                winSqSum += colSqSums[k];
+                winNonFinite += colNonFinite[k];
+            }
+            double *outRow = &outVals[((size_t)row) * width];
+            outRow[0] = this->getWindowStat(winSum, winSqSum, winNonFinite, shift);
+            for(unsigned int x = 1; x < width; ++x)
+            {
+                winSum += colSums[x + size - 1] - colSums[x - 1];
+                winSqSum += colSqSums[x + size - 1] - colSqSums[x - 1];
+                winNonFinite += colNonFinite[x + size - 1] - colNonFinite[x - 1];
+                outRow[x] = this->getWindowStat(winSum, winSqSum, winNonFinite, shift);
+            }
+        }
+    }
+
+    inline double RSGISBoxWindowFilter::getWindowStat(double sum, double sqSum, unsigned int numNonFinite, double shift)
+    {
+        if(numNonFinite > 0)
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        double numVals = this->size * this->size;
+        double shiftedMean = sum / numVals;
+        double outVal = 0;
+        if(this->stat == statTotal)
+        {
+            outVal = sum + (shift * numVals);
+        }
+        else if(this->stat == statMean)
+        {
+            outVal = shiftedMean + shift;
+        }
+        else
+        {
+            double variance = (sqSum / numVals) - (shiftedMean * shiftedMean);
+            if(variance < 0)
+            {
+                variance = 0;
+            }
+            outVal = sqrt(variance);
+            if(this->stat == statCoeffOfVar)
+            {
+                outVal = outVal / (shiftedMean + shift);
+            }
+        }
+        return outVal;
+    }
+
+    void RSGISBoxWindowFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output)
+    {
+        if(this->size != winSize)
+        {
+            throw rsgis::img::RSGISImageCalcException("Window sizes are different");
+        }
+
+        double numVals = winSize * winSize;
+        for(int i = 0; i < numBands; i++)
+        {
+            double sum = 0;
+            for(int j = 0; j < winSize; j++)
+            {
+                for(int k = 0; k < winSize; k++)
+                {
+                    sum += dataBlock[i][j][k];
+                }
+            }
+            double mean = sum / numVals;
+
+            if(this->stat == statTotal)
+            {
+                output[i] = sum;
+            }
+            else if(this->stat == statMean)
+            {
+                output[i] = mean;
+            }
+            else
+            {
+                double sqSum = 0;
+                for(int j = 0; j < winSize; j++)
+                {
+                    for(int k = 0; k < winSize; k++)
+                    {
+                        sqSum += (dataBlock[i][j][k] - mean) * (dataBlock[i][j][k] - mean);
+                    }
+                }
+                output[i] = sqrt(sqSum / numVals);
+                if(this->stat == statCoeffOfVar)
+                {
+                    output[i] = output[i] / mean;
+                }
+            }
+        }
+    }
+
+    bool RSGISBoxWindowFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output)
+    {
+        throw rsgis::img::RSGISImageCalcException("Not implemented yet");
+    }
+
+    void RSGISBoxWindowFilter::exportAsImage(std::string filename)
+    {
+        std::cout << "No Image to output\n";
+    }
+
+    RSGISBoxWindowFilter::~RSGISBoxWindowFilter()
+    {
+
+    }
+
+}}
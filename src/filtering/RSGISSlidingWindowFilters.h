@@ -0,0 +1,253 @@
+/*
+ *  RSGISSlidingWindowFilters.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISSlidingWindowFilters_H
+#define RSGISSlidingWindowFilters_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "gdal_priv.h"
+
+#include "common/RSGISImageException.h"
+#include "common/RSGISThreadPool.h"
+#include "common/rsgis-tqdm.h"
+
+#include "filtering/RSGISImageFilterException.h"
+#include "img/RSGISImageCalcException.h"
+#include "img/RSGISImageBandException.h"
+#include "img/RSGISImageUtils.h"
+#include "filtering/RSGISImageFilter.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_filter_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace filter{
+
+    /**
+     * A histogram of the values within a moving window, where the values have
+     * been mapped to bin indexes in value order. Adding or removing a value is
+     * O(1). Order statistics (rank 0 is the minimum) are found by moving a
+     * tracked bin position from its previous location, using a second level of
+     * counts for every 64 bins to jump over empty parts of the histogram, so
+     * they are close to O(1) as the window slides over neighbouring pixels.
+     * The most frequent bin (the lowest bin for ties) is also tracked.
+     */
+    class DllExport RSGISSlidingHistogram
+    {
+    public:
+        RSGISSlidingHistogram(unsigned int numTrackers=1);
+        /** Resize the histogram, all counts are set to zero. */
+        void reset(unsigned int numBins);
+        inline void add(unsigned int bin)
+        {
+            ++this->counts[bin];
+            ++this->coarseCounts[bin >> 6];
+            ++this->total;
+            for(std::vector<RSGISSlidingHistTracker>::iterator iterTracker = this->trackers.begin(); iterTracker != this->trackers.end(); ++iterTracker)
+            {
+                if(bin < (*iterTracker).pos)
+                {
+                    ++(*iterTracker).below;
+                }
+            }
+            if(this->modeValid && ((this->counts[bin] > this->modeCount) || ((this->counts[bin] == this->modeCount) && (bin < this->modeBin))))
+            {
+                this->modeBin = bin;
+                this->modeCount = this->counts[bin];
+            }
+        };
+        inline void remove(unsigned int bin)
+        {
+            --this->counts[bin];
+            --this->coarseCounts[bin >> 6];
+            --this->total;
+            for(std::vector<RSGISSlidingHistTracker>::iterator iterTracker = this->trackers.begin(); iterTracker != this->trackers.end(); ++iterTracker)
+            {
+                if(bin < (*iterTracker).pos)
+                {
+                    --(*iterTracker).below;
+                }
+            }
+            if(this->modeValid && (bin == this->modeBin))
+            {
+                this->modeValid = false;
+            }
+        };
+        /** Get the bin holding the value with the given rank using the tracker specified. */
+        unsigned int getRankBin(unsigned int tracker, unsigned int rank);
+        /** Returns false if the mode is not known, in which case resetMode() and considerModeBin() must be called for the window values. */
+        inline bool getModeBin(unsigned int *bin)
+        {
+            *bin = this->modeBin;
+            return this->modeValid && (this->modeCount > 0);
+        };
+        inline void resetMode()
+        {
+            this->modeValid = true;
+            this->modeBin = 0;
+            this->modeCount = 0;
+        };
+        inline void considerModeBin(unsigned int bin)
+        {
+            if((this->counts[bin] > this->modeCount) || ((this->counts[bin] == this->modeCount) && (bin < this->modeBin)))
+            {
+                this->modeBin = bin;
+                this->modeCount = this->counts[bin];
+            }
+        };
+        unsigned int getTotal(){return this->total;};
+        ~RSGISSlidingHistogram();
+    protected:
+        struct RSGISSlidingHistTracker
+        {
+            unsigned int pos;
+            unsigned int below;
+        };
+        std::vector<unsigned int> counts;
+        std::vector<unsigned int> coarseCounts;
+        std::vector<RSGISSlidingHistTracker> trackers;
+        unsigned int numBins;
+        unsigned int total;
+        bool modeValid;
+        unsigned int modeBin;
+        unsigned int modeCount;
+    };
+
+
+    /**
+     * Base class for filters which process the image in strips of rows rather
+     * than through the float*** window of RSGISCalcImage::calcImageWindowData.
+     * For each band a strip is read into a single buffer, padded with 0 by half
+     * the window size on every side (as the window functions of RSGISCalcImage),
+     * and filterStrip() is called to calculate the output values for the rows
+     * of the strip. The thread pool uses the library default number of threads.
+     */
+    class DllExport RSGISStripWindowFilter : public RSGISImageFilter
+    {
+    public:
+        RSGISStripWindowFilter(int numberOutBands, int size, std::string filenameEnding);
+        virtual void runFilter(GDALDataset **datasets, int numDS, std::string outputImage, std::string gdalFormat, GDALDataType outDataType);
+        ~RSGISStripWindowFilter();
+    protected:
+        /**
+         * stripVals holds numRows+size-1 rows of bufWidth (width+size-1) values, where
+         * row r of the output is centred on row r+size/2 of the buffer. The output is
+         * written to outVals as numRows rows of width values.
+         */
+        virtual void filterStrip(std::vector<float> &stripVals, unsigned int numRows, unsigned int bufWidth, unsigned int width, double *outVals, rsgis::RSGISThreadPool *threadPool) = 0;
+    };
+
+
+    /**
+     * Base class for the rank based filters (median, percentile, mode, min, max
+     * and range). Each row of a strip is scanned with a running histogram
+     * (RSGISSlidingHistogram) so only the column entering and the column
+     * leaving the window are processed as the window moves, rather than
+     * sorting the whole window for every pixel. Integer images are binned
+     * directly by value; otherwise the values within each strip of rows are
+     * sorted once and binned by their rank. Rows are processed in parallel.
+     *
+     * calcImageValue gives the same result for a single window.
+     */
+    class DllExport RSGISSlidingWindowFilter : public RSGISStripWindowFilter
+    {
+    public:
+        enum SlidingWindowStat
+        {
+            statMedian,
+            statPercentile,
+            statMode,
+            statMin,
+            statMax,
+            statRange
+        };
+        RSGISSlidingWindowFilter(int numberOutBands, int size, std::string filenameEnding, SlidingWindowStat stat, float percentile=50);
+        virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
+        virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
+        virtual void exportAsImage(std::string filename);
+        ~RSGISSlidingWindowFilter();
+    protected:
+        virtual void filterStrip(std::vector<float> &stripVals, unsigned int numRows, unsigned int bufWidth, unsigned int width, double *outVals, rsgis::RSGISThreadPool *threadPool);
+        void binStripValues(std::vector<float> &stripVals, std::vector<unsigned int> &stripBins, std::vector<float> &binVals);
+        void filterStripRow(unsigned int row, unsigned int bufWidth, unsigned int width, std::vector<unsigned int> &stripBins, std::vector<float> &binVals, RSGISSlidingHistogram *hist, double *outRow);
+        inline double getWindowStat(RSGISSlidingHistogram *hist, std::vector<float> &binVals, const unsigned int *winBins, unsigned int bufWidth);
+        unsigned int getPercentileRank(unsigned int numVals);
+        SlidingWindowStat stat;
+        float percentile;
+        std::vector<unsigned int> stripBins;
+        std::vector<float> binVals;
+        std::vector<RSGISSlidingHistogram> hists;
+    };
+
+
+    /**
+     * Base class for the filters calculated from the sum and sum of squares of
+     * the window (total, mean, standard deviation and coefficient of variation).
+     * Running sums are kept for each column of the window and updated as the
+     * window moves down the strip, and the window sum is updated from the
+     * column sums as the window moves along a row, so the cost per pixel does
+     * not depend on the window size. The values are shifted by the (rounded)
+     * mean of the strip before they are summed to limit the loss of precision
+     * when calculating the variance; for integer images the sums are exact.
+     *
+     * Windows containing a non-finite value (NaN or inf) give NaN.
+     */
+    class DllExport RSGISBoxWindowFilter : public RSGISStripWindowFilter
+    {
+    public:
+        enum BoxWindowStat
+        {
+            statTotal,
+            statMean,
+            statStdDev,
+            statCoeffOfVar
+        };
+        RSGISBoxWindowFilter(int numberOutBands, int size, std::string filenameEnding, BoxWindowStat stat);
+        virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
+        virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
+        virtual void exportAsImage(std::string filename);
+        ~RSGISBoxWindowFilter();
+    protected:
+        virtual void filterStrip(std::vector<float> &stripVals, unsigned int numRows, unsigned int bufWidth, unsigned int width, double *outVals, rsgis::RSGISThreadPool *threadPool);
+        void filterStripRows(unsigned int startRow, unsigned int endRow, unsigned int bufWidth, unsigned int width, const float *stripVals, double shift, double *outVals);
+        inline double getWindowStat(double sum, double sqSum, unsigned int numNonFinite, double shift);
+        BoxWindowStat stat;
+    };
+
+}}
+
+#endif
@@ -24,140 +24,39 @@
 
 namespace rsgis{namespace filter{
 
-	RSGISMeanFilter::RSGISMeanFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+	RSGISMeanFilter::RSGISMeanFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISBoxWindowFilter(numberOutBands, size, filenameEnding, RSGISBoxWindowFilter::statMean)
 	{
 
 	}
 
-	void RSGISMeanFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		if(this->size != winSize)
-		{
-			throw rsgis::img::RSGISImageCalcException("Window sizes are different");
-		}
-
-		double outputValue = 0;
-		int numberElements = this->size * this->size;
-		for(int i = 0; i < numBands; i++)
-		{
-			outputValue = 0;
-			for(int j = 0; j < this->size; j++)
-			{
-				for(int k = 0; k < this->size; k++)
-				{
-					outputValue = outputValue + dataBlock[i][j][k];
-				}
-			}
-			output[i] = outputValue/numberElements;
-		}
-	}
-
-	bool RSGISMeanFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		throw rsgis::img::RSGISImageCalcException("Not implemented yet");
-	}
-
-	void RSGISMeanFilter::exportAsImage(std::string filename)
-	{
-		std::cout << "No Image to output\n";
-	}
-
 	RSGISMeanFilter::~RSGISMeanFilter()
 	{
 
 	}
 
-	RSGISMedianFilter::RSGISMedianFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+	RSGISMedianFilter::RSGISMedianFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISSlidingWindowFilter(numberOutBands, size, filenameEnding, RSGISSlidingWindowFilter::statMedian)
 	{
 
 	}
 
-	void RSGISMedianFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		if(this->size != winSize)
-		{
-			throw rsgis::img::RSGISImageCalcException("Window sizes are different");
-		}
-
-		double outputValue = 0;
-		int numberElements = winSize * winSize;
-		int median = floor(((float)numberElements)/2.0);
-		std::vector<float> sortedList;
-        sortedList.reserve(numberElements);
-
-		for(int i = 0; i < numBands; i++)
-		{
-			outputValue = 0;
-			for(int j = 0; j < size; j++)
-			{
-				for(int k = 0; k < size; k++)
-				{
-					sortedList.push_back(dataBlock[i][j][k]);
-				}
-			}
-            
-            std::sort(sortedList.begin(), sortedList.end());
-			output[i] = sortedList[median];
-			sortedList.clear();
-		}
-	}
-
-	bool RSGISMedianFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		throw rsgis::img::RSGISImageCalcException("Not implemented yet");
-	}
-
-	void RSGISMedianFilter::exportAsImage(std::string filename)
-	{
-		std::cout << "No Image to output\n";
-	}
-
 	RSGISMedianFilter::~RSGISMedianFilter()
 	{
 
 	}
 
-	RSGISModeFilter::RSGISModeFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+	RSGISPercentileFilter::RSGISPercentileFilter(int numberOutBands, int size, std::string filenameEnding, float percentile) : RSGISSlidingWindowFilter(numberOutBands, size, filenameEnding, RSGISSlidingWindowFilter::statPercentile, percentile)
 	{
 
 	}
 
-	void RSGISModeFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
+	RSGISPercentileFilter::~RSGISPercentileFilter()
 	{
-		if(this->size != winSize)
-		{
-			throw rsgis::img::RSGISImageCalcException("Window sizes are different");
-		}
-
-		double outputValue = 0;
-
-        rsgis::datastruct::SortedGenericList<float> *sortedList = new rsgis::datastruct::SortedGenericList<float>();
 
-		for(int i = 0; i < numBands; i++)
-		{
-			outputValue = 0;
-			for(int j = 0; j < size; j++)
-			{
-				for(int k = 0; k < size; k++)
-				{
-					sortedList->add(&dataBlock[i][j][k]);
-				}
-			}
-			output[i] = *sortedList->getMostCommonValue();
-			sortedList->clearList();
-		}
-
-		delete sortedList;
 	}
 
-	bool RSGISModeFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) 
+	RSGISModeFilter::RSGISModeFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISSlidingWindowFilter(numberOutBands, size, filenameEnding, RSGISSlidingWindowFilter::statMode)
 	{
-		throw rsgis::img::RSGISImageCalcException("Not implemented yet");
-	}
 
-	void RSGISModeFilter::exportAsImage(std::string filename)
-	{
-		std::cout << "No Image to output\n";
 	}
 
 	RSGISModeFilter::~RSGISModeFilter()
@@ -166,62 +65,9 @@ namespace rsgis{namespace filter{
 	}
 
 
-	RSGISRangeFilter::RSGISRangeFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding)
-	{
-
-	}
-
-	void RSGISRangeFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		if(this->size != winSize)
-		{
-			throw rsgis::img::RSGISImageCalcException("Window sizes are different");
-		}
-
-		float min = 0;
-		float max = 0;
-		bool first = true;
-
-		for(int i = 0; i < numBands; i++)
-		{
-			min = 0;
-			max = 0;
-			first = true;
-			for(int j = 0; j < this->size; j++)
-			{
-				for(int k = 0; k < this->size; k++)
-				{
-					if(first)
-					{
-						min = dataBlock[i][j][k];
-						max = dataBlock[i][j][k];
-						first = false;
-					}
-					else
-					{
-						if(dataBlock[i][j][k] > max)
-						{
-							max = dataBlock[i][j][k];
-						}
-						else if(dataBlock[i][j][k] < min)
-						{
-							min = dataBlock[i][j][k];
-						}
-					}
-				}
-			}
-			output[i] = max-min;
-		}
-	}
-
-	bool RSGISRangeFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) 
+	RSGISRangeFilter::RSGISRangeFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISSlidingWindowFilter(numberOutBands, size, filenameEnding, RSGISSlidingWindowFilter::statRange)
 	{
-		throw rsgis::img::RSGISImageCalcException("Not implemented yet");
-	}
 
-	void RSGISRangeFilter::exportAsImage(std::string filename)
-	{
-		std::cout << "No Image to output\n";
 	}
 
 	RSGISRangeFilter::~RSGISRangeFilter()
@@ -229,57 +75,9 @@ namespace rsgis{namespace filter{
 
 	}
 
-	RSGISStdDevFilter::RSGISStdDevFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding)
-	{
-
-	}
-
-	void RSGISStdDevFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		if(this->size != winSize)
-		{
-			throw rsgis::img::RSGISImageCalcException("Window sizes are different");
-		}
-
-		double outputValue = 0;
-		double squSum = 0;
-		float mean = 0;
-		int numberElements = this->size * this->size;
-		for(int i = 0; i < numBands; i++)
-		{
-			outputValue = 0;
-			squSum = 0;
-
-			for(int j = 0; j < this->size; j++)
-			{
-				for(int k = 0; k < this->size; k++)
-				{
-					outputValue = outputValue + dataBlock[i][j][k];
-				}
-			}
-
-			mean = outputValue/numberElements;
-
-			for(int j = 0; j < this->size; j++)
-			{
-				for(int k = 0; k < this->size; k++)
-				{
-					squSum += ((dataBlock[i][j][k] - mean) * (dataBlock[i][j][k] - mean));
-				}
-			}
-
-			output[i] = sqrt(squSum/numberElements);
-		}
-	}
-
-	bool RSGISStdDevFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) 
+	RSGISStdDevFilter::RSGISStdDevFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISBoxWindowFilter(numberOutBands, size, filenameEnding, RSGISBoxWindowFilter::statStdDev)
 	{
-		throw rsgis::img::RSGISImageCalcException("Not implemented yet");
-	}
 
-	void RSGISStdDevFilter::exportAsImage(std::string filename)
-	{
-		std::cout << "No Image to output\n";
 	}
 
 	RSGISStdDevFilter::~RSGISStdDevFilter()
@@ -287,114 +85,20 @@ namespace rsgis{namespace filter{
 
 	}
 
-    RSGISCoeffOfVarFilter::RSGISCoeffOfVarFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+    RSGISCoeffOfVarFilter::RSGISCoeffOfVarFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISBoxWindowFilter(numberOutBands, size, filenameEnding, RSGISBoxWindowFilter::statCoeffOfVar)
 	{
 
 	}
 
-	void RSGISCoeffOfVarFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		if(this->size != winSize)
-		{
-			throw rsgis::img::RSGISImageCalcException("Window sizes are different");
-		}
-
-		double outputValue = 0;
-		double squSum = 0;
-		float mean = 0;
-		int numberElements = this->size * this->size;
-		for(int i = 0; i < numBands; i++)
-		{
-			outputValue = 0;
-			squSum = 0;
-
-			for(int j = 0; j < this->size; j++)
-			{
-				for(int k = 0; k < this->size; k++)
-				{
-					outputValue = outputValue + dataBlock[i][j][k];
-				}
-			}
-
-			mean = outputValue/numberElements;
-
-			for(int j = 0; j < this->size; j++)
-			{
-				for(int k = 0; k < this->size; k++)
-				{
-					squSum += ((dataBlock[i][j][k] - mean) * (dataBlock[i][j][k] - mean));
-				}
-			}
-
-			output[i] = sqrt(squSum/numberElements) / mean;
-		}
-	}
-
-	bool RSGISCoeffOfVarFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		throw rsgis::img::RSGISImageCalcException("Not implemented yet");
-	}
-
-	void RSGISCoeffOfVarFilter::exportAsImage(std::string filename)
-	{
-		std::cout << "No Image to output\n";
-	}
-
 	RSGISCoeffOfVarFilter::~RSGISCoeffOfVarFilter()
 	{
 
 	}
 
 
-	RSGISMinFilter::RSGISMinFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding)
-	{
-
-	}
-
-	void RSGISMinFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
+	RSGISMinFilter::RSGISMinFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISSlidingWindowFilter(numberOutBands, size, filenameEnding, RSGISSlidingWindowFilter::statMin)
 	{
-		if(this->size != winSize)
-		{
-			throw rsgis::img::RSGISImageCalcException("Window sizes are different");
-		}
-
-		float min = 0;
-		bool first = true;
 
-		for(int i = 0; i < numBands; i++)
-		{
-			min = 0;
-			first = true;
-			for(int j = 0; j < this->size; j++)
-			{
-				for(int k = 0; k < this->size; k++)
-				{
-					if(first)
-					{
-						min = dataBlock[i][j][k];
-						first = false;
-					}
-					else
-					{
-						if(dataBlock[i][j][k] < min)
-						{
-							min = dataBlock[i][j][k];
-						}
-					}
-				}
-			}
-			output[i] = min;
-		}
-	}
-
-	bool RSGISMinFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		throw rsgis::img::RSGISImageCalcException("Not implemented yet");
-	}
-
-	void RSGISMinFilter::exportAsImage(std::string filename)
-	{
-		std::cout << "No Image to output\n";
 	}
 
 	RSGISMinFilter::~RSGISMinFilter()
@@ -402,55 +106,9 @@ namespace rsgis{namespace filter{
 
 	}
 
-	RSGISMaxFilter::RSGISMaxFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding)
-	{
-
-	}
-
-	void RSGISMaxFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		if(this->size != winSize)
-		{
-			throw rsgis::img::RSGISImageCalcException("Window sizes are different");
-		}
-
-		float max = 0;
-		bool first = true;
-
-		for(int i = 0; i < numBands; i++)
-		{
-			max = 0;
-			first = true;
-			for(int j = 0; j < this->size; j++)
-			{
-				for(int k = 0; k < this->size; k++)
-				{
-					if(first)
-					{
-						max = dataBlock[i][j][k];
-						first = false;
-					}
-					else
-					{
-						if(dataBlock[i][j][k] > max)
-						{
-							max = dataBlock[i][j][k];
-						}
-					}
-				}
-			}
-			output[i] = max;
-		}
-	}
-
-	bool RSGISMaxFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) 
+	RSGISMaxFilter::RSGISMaxFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISSlidingWindowFilter(numberOutBands, size, filenameEnding, RSGISSlidingWindowFilter::statMax)
 	{
-		throw rsgis::img::RSGISImageCalcException("Not implemented yet");
-	}
 
-	void RSGISMaxFilter::exportAsImage(std::string filename)
-	{
-		std::cout << "No Image to output\n";
 	}
 
 	RSGISMaxFilter::~RSGISMaxFilter()
@@ -458,42 +116,9 @@ namespace rsgis{namespace filter{
 
 	}
 
-	RSGISTotalFilter::RSGISTotalFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding)
-	{
-
-	}
-
-	void RSGISTotalFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
-	{
-		if(this->size != winSize)
-		{
-			throw rsgis::img::RSGISImageCalcException("Window sizes are different");
-		}
-
-		double outputValue = 0;
-
-		for(int i = 0; i < numBands; i++)
-		{
-			outputValue = 0;
-			for(int j = 0; j < this->size; j++)
-			{
-				for(int k = 0; k < this->size; k++)
-				{
-					outputValue = outputValue + dataBlock[i][j][k];
-				}
-			}
-			output[i] = outputValue;
-		}
-	}
-
-	bool RSGISTotalFilter::calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) 
+	RSGISTotalFilter::RSGISTotalFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISBoxWindowFilter(numberOutBands, size, filenameEnding, RSGISBoxWindowFilter::statTotal)
 	{
-		throw rsgis::img::RSGISImageCalcException("Not implemented yet");
-	}
 
-	void RSGISTotalFilter::exportAsImage(std::string filename)
-	{
-		std::cout << "No Image to output\n";
 	}
 
 	RSGISTotalFilter::~RSGISTotalFilter()
@@ -33,6 +33,7 @@
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "filtering/RSGISImageFilter.h"
+#include "filtering/RSGISSlidingWindowFilters.h"
 
 #include "datastruct/SortedGenericList.cpp"
 
@@ -51,57 +52,49 @@
 
 namespace rsgis{namespace filter{
 
-	class DllExport RSGISMeanFilter : public RSGISImageFilter
+	class DllExport RSGISMeanFilter : public RSGISBoxWindowFilter
 		{
 		public:
 			RSGISMeanFilter(int numberOutBands, int size, std::string filenameEnding);
-			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual void exportAsImage(std::string filename);
 			~RSGISMeanFilter();
 		};
 
-	class DllExport RSGISMedianFilter : public RSGISImageFilter
+	class DllExport RSGISMedianFilter : public RSGISSlidingWindowFilter
 		{
 		public:
 			RSGISMedianFilter(int numberOutBands, int size, std::string filenameEnding);
-			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual void exportAsImage(std::string filename);
 			~RSGISMedianFilter();
 		};
 
-	class DllExport RSGISModeFilter : public RSGISImageFilter
+	class DllExport RSGISPercentileFilter : public RSGISSlidingWindowFilter
+		{
+		public:
+			RSGISPercentileFilter(int numberOutBands, int size, std::string filenameEnding, float percentile);
+			~RSGISPercentileFilter();
+		};
+
+	class DllExport RSGISModeFilter : public RSGISSlidingWindowFilter
 		{
 		public:
 			RSGISModeFilter(int numberOutBands, int size, std::string filenameEnding);
-			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual void exportAsImage(std::string filename);
 			~RSGISModeFilter();
 		};
 
-	class DllExport RSGISRangeFilter : public RSGISImageFilter
+	class DllExport RSGISRangeFilter : public RSGISSlidingWindowFilter
 		{
 		public:
 			RSGISRangeFilter(int numberOutBands, int size, std::string filenameEnding);
-			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual void exportAsImage(std::string filename);
 			~RSGISRangeFilter();
 		};
 
-	class DllExport RSGISStdDevFilter : public RSGISImageFilter
+	class DllExport RSGISStdDevFilter : public RSGISBoxWindowFilter
 		{
 		public:
 			RSGISStdDevFilter(int numberOutBands, int size, std::string filenameEnding);
-			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual void exportAsImage(std::string filename);
 			~RSGISStdDevFilter();
 		};
 
-    class DllExport RSGISCoeffOfVarFilter : public RSGISImageFilter
+    class DllExport RSGISCoeffOfVarFilter : public RSGISBoxWindowFilter
 		{
         /**
 
@@ -111,39 +104,27 @@ namespace rsgis{namespace filter{
         */
 		public:
 			RSGISCoeffOfVarFilter(int numberOutBands, int size, std::string filenameEnding);
-			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual void exportAsImage(std::string filename);
 			~RSGISCoeffOfVarFilter();
 		};
 
-	class DllExport RSGISMinFilter : public RSGISImageFilter
+	class DllExport RSGISMinFilter : public RSGISSlidingWindowFilter
 		{
 		public:
 			RSGISMinFilter(int numberOutBands, int size, std::string filenameEnding);
-			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual void exportAsImage(std::string filename);
 			~RSGISMinFilter();
 		};
 
-	class DllExport RSGISMaxFilter : public RSGISImageFilter
+	class DllExport RSGISMaxFilter : public RSGISSlidingWindowFilter
 		{
 		public:
 			RSGISMaxFilter(int numberOutBands, int size, std::string filenameEnding);
-			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual void exportAsImage(std::string filename);
 			~RSGISMaxFilter();
 		};
 
-	class DllExport RSGISTotalFilter : public RSGISImageFilter
+	class DllExport RSGISTotalFilter : public RSGISBoxWindowFilter
 		{
 		public:
 			RSGISTotalFilter(int numberOutBands, int size, std::string filenameEnding);
-			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output);
-			virtual void exportAsImage(std::string filename);
 			~RSGISTotalFilter();
 		};
 
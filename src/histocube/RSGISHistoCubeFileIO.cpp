@@ -645,7 +645,7 @@ namespace rsgis {namespace histocube{
                 throw rsgis::RSGISHistoCubeException("Cube Layer has the wrong dimensions.");
             }
             
-            if(eRow >= cubeLayerDIMS[0])
+            if(eRow > cubeLayerDIMS[0])
             {
                 std::cerr << "ROW = " << eRow << " Max. = " << cubeLayerDIMS[0] << std::endl;
                 throw rsgis::RSGISHistoCubeException("Row is not within the cube layer.");
@@ -742,7 +742,7 @@ namespace rsgis {namespace histocube{
                 throw rsgis::RSGISHistoCubeException("Cube Layer has the wrong dimensions.");
             }
             
-            if(eRow >= cubeLayerDIMS[0])
+            if(eRow > cubeLayerDIMS[0])
             {
                 std::cerr << "ROW = " << eRow << " Max. = " << cubeLayerDIMS[0] << std::endl;
                 throw rsgis::RSGISHistoCubeException("Row is not within the cube layer.");
@@ -807,6 +807,53 @@ namespace rsgis {namespace histocube{
         }
     }
     
+    unsigned int RSGISHistoCubeFile::getLayerChunkRows(std::string name)
+    {
+        if(!this->fileOpen)
+        {
+            throw rsgis::RSGISHistoCubeException("File was not open.");
+        }
+        
+        unsigned int chunkRows = HC_COMPRESS_CHUNK;
+        try
+        {
+            std::string cubeLayerName = HC_DATASETNAME_DATA + "/" + name;
+            H5::DataSet cubeLayerDataset = hcH5File->openDataSet( cubeLayerName );
+            H5::DSetCreatPropList cubeLayerParams = cubeLayerDataset.getCreatePlist();
+            if(cubeLayerParams.getLayout() == H5D_CHUNKED)
+            {
+                hsize_t chunkDims[2];
+                if(cubeLayerParams.getChunk(2, chunkDims) == 2)
+                {
+                    chunkRows = chunkDims[0];
+                }
+            }
+            cubeLayerParams.close();
+            cubeLayerDataset.close();
+        }
+        catch( H5::PropListIException &e )
+        {
+            throw rsgis::RSGISHistoCubeException(e.getCDetailMsg());
+        }
+        catch( H5::FileIException &e )
+        {
+            throw rsgis::RSGISHistoCubeException(e.getCDetailMsg());
+        }
+        catch( H5::DataSetIException &e )
+        {
+            throw rsgis::RSGISHistoCubeException(e.getCDetailMsg());
+        }
+        catch ( std::exception &e)
+        {
+            throw rsgis::RSGISHistoCubeException(e.what());
+        }
+        if(chunkRows == 0)
+        {
+            chunkRows = HC_COMPRESS_CHUNK;
+        }
+        return chunkRows;
+    }
+    
     std::vector<RSGISHistCubeLayerMeta*>* RSGISHistoCubeFile::getCubeLayersList()
     {
         return this->cubeLayers;
@@ -115,6 +115,8 @@ namespace rsgis {namespace histocube{
         virtual void setHistoRow(std::string name, unsigned int row, unsigned int *data, unsigned int dataLen);
         virtual void getHistoRows(std::string name, unsigned int sRow, unsigned int eRow, unsigned int *data, unsigned int dataLen);
         virtual void setHistoRows(std::string name, unsigned int sRow, unsigned int eRow, unsigned int *data, unsigned int dataLen);
+        /** The number of rows (features) within each HDF5 chunk of the cube layer. */
+        virtual unsigned int getLayerChunkRows(std::string name);
         virtual std::vector<RSGISHistCubeLayerMeta*>* getCubeLayersList();
         virtual unsigned long getNumFeatures();
         virtual void closeFile();
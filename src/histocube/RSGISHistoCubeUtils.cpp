@@ -32,14 +32,14 @@ namespace rsgis {namespace histocube{
         
     }
     
-    long RSGISHistoCubeUtils::getBinsIndex(int val, std::vector<int> bins)
+    long RSGISHistoCubeUtils::getBinsIndex(int val, const std::vector<int> &bins)
     {
         long idx = -1;
         try
         {
             long cIdx = 0;
             bool found = false;
-            for(std::vector<int>::iterator iterVal = bins.begin(); iterVal != bins.end(); ++iterVal)
+            for(std::vector<int>::const_iterator iterVal = bins.begin(); iterVal != bins.end(); ++iterVal)
             {
                 if((*iterVal) == val)
                 {
@@ -82,6 +82,39 @@ namespace rsgis {namespace histocube{
         
     }
     
+    
+    RSGISHistoCubeBinsLUT::RSGISHistoCubeBinsLUT(const std::vector<int> &bins)
+    {
+        if(bins.empty())
+        {
+            throw rsgis::RSGISHistoCubeException("There are no bins.");
+        }
+        int minVal = *std::min_element(bins.begin(), bins.end());
+        int maxVal = *std::max_element(bins.begin(), bins.end());
+        long long span = ((long long)maxVal - minVal) + 1;
+        this->minBin = minVal;
+        this->useLUT = (span <= (((long long)bins.size()) * HC_BINS_LUT_MAX_SPAN));
+        if(this->useLUT)
+        {
+            this->binsLUT.assign(span, -1);
+            // Reverse order so a repeated value has the index of its first occurrence, as getBinsIndex.
+            for(long i = ((long)bins.size())-1; i >= 0; --i)
+            {
+                this->binsLUT[bins[i] - minVal] = i;
+            }
+        }
+        else
+        {
+            // Sorting by index as well means lower_bound finds the first occurrence of a repeated value.
+            this->sortedBins.reserve(bins.size());
+            for(long i = 0; i < ((long)bins.size()); ++i)
+            {
+                this->sortedBins.push_back(std::pair<int, long>(bins[i], i));
+            }
+            std::sort(this->sortedBins.begin(), this->sortedBins.end());
+        }
+    }
+    
 }}
 
 
@@ -44,6 +44,8 @@
 #include <vector>
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <utility>
 
 #include "common/RSGISHistoCubeException.h"
 
@@ -56,10 +58,50 @@ namespace rsgis {namespace histocube{
     {
     public:
         RSGISHistoCubeUtils();
-        long getBinsIndex(int val, std::vector<int> bins);
+        long getBinsIndex(int val, const std::vector<int> &bins);
         ~RSGISHistoCubeUtils();
     };
     
+    /**
+     * Finds the index of a value within the bins (-1 if not a bin), as getBinsIndex.
+     * Where the range of the bin values is no more than HC_BINS_LUT_MAX_SPAN times the
+     * number of bins a look up table over the range is used (binsLUT[val - minBin]),
+     * otherwise a binary search of the sorted bin values so sparse bins (e.g., 0 and
+     * 1000000000) do not need a table over the whole range.
+     */
+    class DllExport RSGISHistoCubeBinsLUT
+    {
+    public:
+        static const unsigned int HC_BINS_LUT_MAX_SPAN = 16;
+        RSGISHistoCubeBinsLUT():useLUT(true), minBin(0){};
+        RSGISHistoCubeBinsLUT(const std::vector<int> &bins);
+        inline long getBinIndex(int val) const
+        {
+            if(this->useLUT)
+            {
+                long lutIdx = ((long)val) - this->minBin;
+                if((lutIdx < 0) | (lutIdx >= ((long)this->binsLUT.size())))
+                {
+                    return -1;
+                }
+                return this->binsLUT[lutIdx];
+            }
+            std::vector< std::pair<int, long> >::const_iterator iterBin = std::lower_bound(this->sortedBins.begin(), this->sortedBins.end(), std::pair<int, long>(val, std::numeric_limits<long>::min()));
+            if((iterBin == this->sortedBins.end()) || (iterBin->first != val))
+            {
+                return -1;
+            }
+            return iterBin->second;
+        };
+        ~RSGISHistoCubeBinsLUT(){};
+    protected:
+        bool useLUT;
+        int minBin;
+        std::vector<long> binsLUT;
+        /** The bin values and indexes sorted by value then index. */
+        std::vector< std::pair<int, long> > sortedBins;
+    };
+    
 }}
 
 #endif
@@ -51,7 +51,7 @@ namespace rsgis {namespace histocube{
                 int bandValInt = floor(bandVal + 0.5);
                 long idx = this->hcUtils.getBinsIndex(bandValInt, this->bins);
                 
-                if((idx >= 0) | (idx < this->dataArrLen))
+                if((idx >= 0) & (idx < this->dataArrLen))
                 {
                     this->hcFile->getHistoRow(this->layerName, row, this->dataArr, this->dataArrLen);
                     this->dataArr[idx] = this->dataArr[idx] + 1;
@@ -94,6 +94,7 @@ namespace rsgis {namespace histocube{
         this->offset = offset;
         this->bins = bins;
         this->hcUtils = RSGISHistoCubeUtils();
+        this->binsLUT = RSGISHistoCubeBinsLUT(bins);
     }
     
     void RSGISPopHistoCubeLayerFromImgBandInMem::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) 
@@ -105,9 +106,9 @@ namespace rsgis {namespace histocube{
                 unsigned int row = intBandValues[0];
                 float bandVal = (floatBandValues[bandIdx] * scale) + offset;
                 int bandValInt = floor(bandVal + 0.5);
-                long binIdx = this->hcUtils.getBinsIndex(bandValInt, this->bins);
+                long binIdx = this->binsLUT.getBinIndex(bandValInt);
                 
-                if((binIdx >= 0) | (binIdx < this->rowLen))
+                if((binIdx >= 0) & (binIdx < this->rowLen))
                 {
                     if(row == 0)
                     {
@@ -133,6 +134,88 @@ namespace rsgis {namespace histocube{
     }
     
     
+    
+    RSGISPopHistoCubeLayerFromImgBandBatched::RSGISPopHistoCubeLayerFromImgBandBatched(RSGISHistoCubeFile *hcFile, std::string layerName, unsigned int bandIdx, unsigned int maxRow, float scale, float offset, std::vector<int> bins, unsigned long maxMemory) : rsgis::img::RSGISCalcImageValue(0)
+    {
+        this->hcFile = hcFile;
+        this->layerName = layerName;
+        this->bandIdx = bandIdx;
+        this->maxRow = maxRow;
+        this->scale = scale;
+        this->offset = offset;
+        this->rowLen = bins.size();
+        this->maxMemory = maxMemory;
+        this->binsLUT = RSGISHistoCubeBinsLUT(bins);
+        // Accumulate and write whole chunks so each chunk is only decompressed and compressed once.
+        this->chunkRows = hcFile->getLayerChunkRows(layerName);
+        this->memoryUsed = 0;
+        this->lastChunkIdx = 0;
+        this->lastChunkCounts = NULL;
+    }
+    
+    void RSGISPopHistoCubeLayerFromImgBandBatched::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) 
+    {
+        if((intBandValues[0] >= 0) & (intBandValues[0] <= maxRow))
+        {
+            unsigned int row = intBandValues[0];
+            float bandVal = (floatBandValues[bandIdx] * scale) + offset;
+            long binIdx = this->binsLUT.getBinIndex((int)floor(bandVal + 0.5));
+            if(binIdx < 0)
+            {
+                return;
+            }
+            
+            unsigned int chunkIdx = row / this->chunkRows;
+            // Neighbouring pixels are usually within the same chunk.
+            if((this->lastChunkCounts == NULL) | (chunkIdx != this->lastChunkIdx))
+            {
+                std::map<unsigned int, std::vector<unsigned int> >::iterator iterChunk = this->chunkCounts.find(chunkIdx);
+                if(iterChunk == this->chunkCounts.end())
+                {
+                    unsigned long chunkLen = ((unsigned long)this->chunkRows) * this->rowLen;
+                    if((this->memoryUsed + (chunkLen * sizeof(unsigned int))) > this->maxMemory)
+                    {
+                        this->flush();
+                    }
+                    iterChunk = this->chunkCounts.insert(std::pair<unsigned int, std::vector<unsigned int> >(chunkIdx, std::vector<unsigned int>(chunkLen, 0))).first;
+                    this->memoryUsed += chunkLen * sizeof(unsigned int);
+                }
+                this->lastChunkIdx = chunkIdx;
+                this->lastChunkCounts = &iterChunk->second[0];
+            }
+            this->lastChunkCounts[(((unsigned long)(row - (chunkIdx * this->chunkRows))) * this->rowLen) + binIdx] += 1;
+        }
+    }
+    
+    void RSGISPopHistoCubeLayerFromImgBandBatched::flush()
+    {
+        unsigned long numRows = ((unsigned long)this->maxRow) + 1;
+        std::vector<unsigned int> fileCounts;
+        // The chunks are in order so the file is read and written sequentially.
+        for(std::map<unsigned int, std::vector<unsigned int> >::iterator iterChunk = this->chunkCounts.begin(); iterChunk != this->chunkCounts.end(); ++iterChunk)
+        {
+            unsigned int sRow = iterChunk->first * this->chunkRows;
+            unsigned int eRow = std::min<unsigned long>(((unsigned long)sRow) + this->chunkRows, numRows);
+            unsigned long dataLen = ((unsigned long)(eRow - sRow)) * this->rowLen;
+            fileCounts.resize(dataLen);
+            this->hcFile->getHistoRows(this->layerName, sRow, eRow, &fileCounts[0], dataLen);
+            for(unsigned long i = 0; i < dataLen; ++i)
+            {
+                fileCounts[i] += iterChunk->second[i];
+            }
+            this->hcFile->setHistoRows(this->layerName, sRow, eRow, &fileCounts[0], dataLen);
+        }
+        this->chunkCounts.clear();
+        this->memoryUsed = 0;
+        this->lastChunkCounts = NULL;
+    }
+    
+    RSGISPopHistoCubeLayerFromImgBandBatched::~RSGISPopHistoCubeLayerFromImgBandBatched()
+    {
+        
+    }
+    
+    
 }}
 
 
@@ -42,6 +42,7 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <map>
 #include <math.h>
 
 #include "common/RSGISHistoCubeException.h"
@@ -54,6 +55,7 @@
 
 namespace rsgis {namespace histocube{
     
+    static const unsigned long HC_POP_BATCH_MEMORY( 268435456 ); // 256 MB
     
     class DllExport RSGISPopHistoCubeLayerFromImgBand : public rsgis::img::RSGISCalcImageValue
     {
@@ -109,6 +111,50 @@ namespace rsgis {namespace histocube{
         unsigned int *dataArr;
         unsigned long dataArrLen;
         unsigned int rowLen;
+        RSGISHistoCubeBinsLUT binsLUT;
+    };
+    
+    /**
+     * Populates a cube layer without holding the whole layer in memory or reading and
+     * writing the file for each pixel. The counts are accumulated in memory for each
+     * HDF5 chunk (block of rows) of the layer touched by the image and, when the memory
+     * used reaches maxMemory or flush() is called, each of the chunks is added to the
+     * file with one read and one write. flush() must be called once the image has been
+     * processed.
+     */
+    class DllExport RSGISPopHistoCubeLayerFromImgBandBatched : public rsgis::img::RSGISCalcImageValue
+    {
+    public:
+        RSGISPopHistoCubeLayerFromImgBandBatched(RSGISHistoCubeFile *hcFile, std::string layerName, unsigned int bandIdx, unsigned int maxRow, float scale, float offset, std::vector<int> bins, unsigned long maxMemory=HC_POP_BATCH_MEMORY);
+        void calcImageValue(float *bandValues, int numBands, double *output) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
+        void calcImageValue(float *bandValues, int numBands) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals);
+        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
+        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, geos::geom::Envelope extent){throw rsgis::img::RSGISImageCalcException("Not implemented");};
+        void calcImageValue(float *bandValues, int numBands, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+        void calcImageValue(float *bandValues, int numBands, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+        void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+        void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+        bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+        /** Add the accumulated counts to the file. */
+        void flush();
+        ~RSGISPopHistoCubeLayerFromImgBandBatched();
+    protected:
+        RSGISHistoCubeFile *hcFile;
+        std::string layerName;
+        unsigned int bandIdx;
+        unsigned int maxRow;
+        float scale;
+        float offset;
+        unsigned int rowLen;
+        unsigned int chunkRows;
+        unsigned long maxMemory;
+        RSGISHistoCubeBinsLUT binsLUT;
+        /** The counts for each chunk touched, by chunk index. */
+        std::map<unsigned int, std::vector<unsigned int> > chunkCounts;
+        unsigned long memoryUsed;
+        unsigned int lastChunkIdx;
+        unsigned int *lastChunkCounts;
     };
     
 }}
@@ -90,5 +90,33 @@ namespace rsgis{namespace img{
 	{
 		
 	}
+    
+    RSGISApplyBlockFunction::RSGISApplyBlockFunction(int numOutputBands, unsigned int width, RSGISBlockFunction blockFunc) : RSGISCalcImageValue(numOutputBands)
+    {
+        if(width == 0)
+        {
+            throw RSGISImageCalcException("The image width must be greater than zero.");
+        }
+        this->width = width;
+        this->blockFunc = blockFunc;
+        this->pxlsProcessed = 0;
+    }
+    
+    void RSGISApplyBlockFunction::calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output)
+    {
+        if((nPxls % this->width) != 0)
+        {
+            throw RSGISImageCalcException("The image block is not a whole number of rows.");
+        }
+        unsigned int nRows = nPxls / this->width;
+        unsigned int yOff = this->pxlsProcessed / this->width;
+        this->blockFunc(bandValues, numBands, output, this->numOutBands, this->width, nRows, yOff);
+        this->pxlsProcessed += nPxls;
+    }
+    
+    RSGISApplyBlockFunction::~RSGISApplyBlockFunction()
+    {
+        
+    }
 	
 }}
@@ -27,6 +27,7 @@
 #include <iostream>
 #include <stdio.h>
 #include <math.h>
+#include <functional>
 
 #include "img/RSGISCalcImage.h"
 #include "img/RSGISCalcImageValue.h"
@@ -114,6 +115,30 @@ namespace rsgis{namespace img{
         rsgis::math::RSGISMathThreeVariableFunction *imagefunction;
 		float ignoreVal;
 	};
+    
+    /**
+     * A function applied to a block of rows: inBlock[band][(row*width)+col] holds
+     * the input values and outBlock[band][(row*width)+col] the output values to be
+     * written, where the block is nRows rows starting at row yOff of the image.
+     */
+    typedef std::function<void(float **inBlock, unsigned int numInBands, double **outBlock, unsigned int numOutBands, unsigned int width, unsigned int nRows, unsigned int yOff)> RSGISBlockFunction;
+    
+    class DllExport RSGISApplyBlockFunction : public RSGISCalcImageValue
+    {
+        /// Passes each block read by RSGISCalcImage to a function, using the
+        /// image buffers directly, rather than calculating each pixel separately.
+        /// Blocks are processed in order on a single thread.
+    public:
+        RSGISApplyBlockFunction(int numOutputBands, unsigned int width, RSGISBlockFunction blockFunc);
+        virtual void calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output);
+        virtual bool implementsCalcImageBlock() {return true;};
+        virtual void calcImageValue(float *bandValues, int numBands, double *output) {throw RSGISImageCalcException("Not implemented");};
+        ~RSGISApplyBlockFunction();
+    protected:
+        unsigned int width;
+        RSGISBlockFunction blockFunc;
+        unsigned long pxlsProcessed;
+    };
 
 }}
 
@@ -52,6 +52,26 @@ namespace rsgis{namespace img{
         }
     }
     
+    void RSGISRescaleImageData::calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output)
+    {
+        for(int i = 0; i < numBands; ++i)
+        {
+            float *inBand = bandValues[i];
+            double *outBand = output[i];
+            for(unsigned long p = 0; p < nPxls; ++p)
+            {
+                if(inBand[p] == this->cNoDataVal)
+                {
+                    outBand[p] = this->nNoDataVal;
+                }
+                else
+                {
+                    outBand[p] = (((inBand[p]-cOffset)/cGain) * nGain) + nOffset;
+                }
+            }
+        }
+    }
+    
     RSGISRescaleImageData::~RSGISRescaleImageData()
     {
         
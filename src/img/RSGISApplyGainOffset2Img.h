@@ -65,6 +65,9 @@ namespace rsgis{namespace img{
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("Not implemented");};
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw RSGISImageCalcException("No implemented");};
         bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("Not implemented");};
+        void calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output);
+        bool implementsCalcImageBlock() {return true;};
+        RSGISCalcImageValue* clone() {return new RSGISRescaleImageData(this->numOutBands, this->cNoDataVal, this->cOffset, this->cGain, this->nNoDataVal, this->nOffset, this->nGain);};
         ~RSGISRescaleImageData();
     protected:
         float cNoDataVal;
@@ -30,13 +30,18 @@ namespace rsgis{namespace img{
 		this->numVariables = numVariables;
 		
 		this->muParser = muParser;
+        this->ownsParser = false;
 		this->inVals = new mu::value_type[numVariables];
-		for(int i = 0; i < numVariables; ++i)
-		{
-			muParser->DefineVar(_T(variables[i]->name.c_str()), &inVals[i]);
-		}
-		
+		this->bindVariables(this->inVals, 1);
 	}
+    
+    void RSGISBandMath::bindVariables(mu::value_type *vals, unsigned long stride)
+    {
+        for(int i = 0; i < numVariables; ++i)
+        {
+            muParser->DefineVar(_T(variables[i]->name.c_str()), &vals[i*stride]);
+        }
+    }
 
 	void RSGISBandMath::calcImageValue(float *bandValues, int numBands, double *output) 
 	{
@@ -63,9 +68,60 @@ namespace rsgis{namespace img{
 		}
 	}
 
+    void RSGISBandMath::calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output)
+    {
+        if(numOutBands != 1)
+        {
+            throw RSGISImageCalcException("Incorrect number of output Image bands (should be equal to 1).");
+        }
+        if(nPxls == 0)
+        {
+            return;
+        }
+        
+        try
+        {
+            // Each variable is bound to its own contiguous run of nPxls values.
+            if(this->blockVals.size() < (((size_t)numVariables) * nPxls))
+            {
+                this->blockVals.resize(((size_t)numVariables) * nPxls);
+            }
+            for(int i = 0; i < numVariables; ++i)
+            {
+                float *inBand = bandValues[variables[i]->band];
+                mu::value_type *varVals = &this->blockVals[((size_t)i) * nPxls];
+                for(unsigned long p = 0; p < nPxls; ++p)
+                {
+                    varVals[p] = inBand[p];
+                }
+            }
+            this->bindVariables(this->blockVals.data(), nPxls);
+            muParser->Eval(output[0], (int)nPxls);
+            this->bindVariables(this->inVals, 1);
+        }
+        catch (mu::ParserError &e)
+        {
+            this->bindVariables(this->inVals, 1);
+            std::string message = std::string("ERROR: ") + std::string(e.GetMsg()) + std::string(":\t \'") + std::string(e.GetExpr()) + std::string("\'");
+            throw RSGISImageCalcException(message);
+        }
+    }
+    
+    RSGISCalcImageValue* RSGISBandMath::clone()
+    {
+        // Each copy needs its own parser as the variables are bound to per-object memory.
+        RSGISBandMath *calcCopy = new RSGISBandMath(this->numOutBands, this->variables, this->numVariables, new mu::Parser(*this->muParser));
+        calcCopy->ownsParser = true;
+        return calcCopy;
+    }
+
 	RSGISBandMath::~RSGISBandMath()
 	{
         delete[] inVals;
+        if(ownsParser)
+        {
+            delete muParser;
+        }
 	}
     
     
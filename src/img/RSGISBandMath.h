@@ -26,6 +26,7 @@
 #include <iostream>
 #include <string>
 #include <math.h>
+#include <vector>
 
 #include "gdal_priv.h"
 
@@ -61,12 +62,22 @@ namespace rsgis{namespace img{
 		public: 
 			RSGISBandMath(int numberOutBands, VariableBands **variables, int numVariables, mu::Parser *muParser);
 			void calcImageValue(float *bandValues, int numBands, double *output);
+            /**
+             * Evaluates the expression for a whole block using the muParser
+             * bulk mode so the expression is only parsed once per block.
+             */
+            void calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output);
+            bool implementsCalcImageBlock(){return true;};
+            RSGISCalcImageValue* clone();
 			~RSGISBandMath();
 		private:
+            void bindVariables(mu::value_type *vals, unsigned long stride);
 			VariableBands **variables;
 			int numVariables;
             mu::Parser *muParser;
             mu::value_type *inVals;
+            std::vector<mu::value_type> blockVals;
+            bool ownsParser;
 		};
     
     
@@ -30,8 +30,46 @@ namespace rsgis{namespace img{
 		this->numOutBands = valueCalc->getNumOutBands();
 		this->proj = proj;
 		this->useImageProj = useImageProj;
+        this->numThreads = rsgis::RSGISThreadPool::getDefaultNumThreads();
+        this->pipelinedIO = RSGISCalcImage::getDefaultPipelinedIO();
 	}
     
+    void RSGISCalcImage::setNumThreads(unsigned int numThreads)
+    {
+        if(numThreads == 0)
+        {
+            numThreads = rsgis::RSGISThreadPool::getNumCores();
+        }
+        this->numThreads = numThreads;
+    }
+    
+    unsigned int RSGISCalcImage::getNumThreads()
+    {
+        return this->numThreads;
+    }
+    
+    std::atomic<bool> RSGISCalcImage::defaultPipelinedIO(false);
+    
+    void RSGISCalcImage::setPipelinedIO(bool pipelinedIO)
+    {
+        this->pipelinedIO = pipelinedIO;
+    }
+    
+    bool RSGISCalcImage::getPipelinedIO()
+    {
+        return this->pipelinedIO;
+    }
+    
+    void RSGISCalcImage::setDefaultPipelinedIO(bool pipelinedIO)
+    {
+        RSGISCalcImage::defaultPipelinedIO = pipelinedIO;
+    }
+    
+    bool RSGISCalcImage::getDefaultPipelinedIO()
+    {
+        return RSGISCalcImage::defaultPipelinedIO;
+    }
+    
     
     void RSGISCalcImage::calcImage(GDALDataset **datasets, int numDS, std::string outputImage, bool setOutNames, std::string *bandNames, std::string gdalFormat, GDALDataType gdalDataType)
     {
@@ -81,6 +119,7 @@ namespace rsgis{namespace img{
 			std::cout << "New image width = " << width << " height = " << height << " bands = " << this->numOutBands << std::endl;
 			
 			outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, gdalDataType, papszOptions);
+			RSGISImageBlockCache::invalidate(outputImage);
 			
 			if(outputImageDS == NULL)
 			{
@@ -131,99 +170,129 @@ namespace rsgis{namespace img{
                 yBlockSize = outYBlockSize;
             }
             
-			// Allocate memory
-			inputData = new float*[numInBands];
-			for(int i = 0; i < numInBands; i++)
-			{
-				inputData[i] = (float *) CPLMalloc(sizeof(float)*(width*yBlockSize));
-			}
-			inDataColumn = new float[numInBands];
+            bool processedInParallel = false;
+            if(this->numThreads > 1)
+            {
+                processedInParallel = this->calcImageParallel(inputRasterBands, bandOffsets, numInBands, outputRasterBands, width, height, yBlockSize);
+            }
+            else if(this->pipelinedIO)
+            {
+                this->calcImagePipelined(inputRasterBands, bandOffsets, numInBands, outputRasterBands, width, height, yBlockSize);
+                processedInParallel = true;
+            }
             
-			outputData = new double*[this->numOutBands];
-			for(int i = 0; i < this->numOutBands; i++)
-			{
-				outputData[i] = (double *) CPLMalloc(sizeof(double)*(width*yBlockSize));
-			}
-			outDataColumn = new double[this->numOutBands];
-                      
-            int nYBlocks = floor(((double)height) / ((double)yBlockSize));
-            int remainRows = height - (nYBlocks * yBlockSize);
-            int rowOffset = 0;
+            if(!processedInParallel)
+            {
+    			// Allocate memory
+    			inputData = new float*[numInBands];
+    			for(int i = 0; i < numInBands; i++)
+    			{
+    				inputData[i] = (float *) CPLMalloc(sizeof(float)*(width*yBlockSize));
+    			}
+    			inDataColumn = new float[numInBands];
             
-			rsgis_tqdm pbar;
-			// Loop images to process data
-			for(int i = 0; i < nYBlocks; i++)
-			{
-				for(int n = 0; n < numInBands; n++)
-				{
-                    rowOffset = bandOffsets[n][1] + (yBlockSize * i);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
-				}
+    			outputData = new double*[this->numOutBands];
+    			for(int i = 0; i < this->numOutBands; i++)
+    			{
+    				outputData[i] = (double *) CPLMalloc(sizeof(double)*(width*yBlockSize));
+    			}
+    			outDataColumn = new double[this->numOutBands];
+                      
+                int nYBlocks = floor(((double)height) / ((double)yBlockSize));
+                int remainRows = height - (nYBlocks * yBlockSize);
+                int rowOffset = 0;
+            
+    			rsgis_tqdm pbar;
+    			// Loop images to process data
+    			for(int i = 0; i < nYBlocks; i++)
+    			{
+    				for(int n = 0; n < numInBands; n++)
+    				{
+                        rowOffset = bandOffsets[n][1] + (yBlockSize * i);
+    					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
+    				}
                 
-                for(int m = 0; m < yBlockSize; ++m)
-                {
-                    pbar.progress((i*yBlockSize)+m, height);
-                                        
-                    for(int j = 0; j < width; j++)
+                    if(this->calc->implementsCalcImageBlock())
                     {
-                        for(int n = 0; n < numInBands; n++)
+                        this->calc->calcImageBlock(inputData, numInBands, width*yBlockSize, outputData);
+                        pbar.progress((i*yBlockSize), height);
+                    }
+                    else
+                    {
+                        for(int m = 0; m < yBlockSize; ++m)
                         {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
+                            pbar.progress((i*yBlockSize)+m, height);
+                                        
+                            for(int j = 0; j < width; j++)
+                            {
+                                for(int n = 0; n < numInBands; n++)
+                                {
+                                    inDataColumn[n] = inputData[n][(m*width)+j];
+                                }
                         
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
+                                this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
                         
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
+                                for(int n = 0; n < this->numOutBands; n++)
+                                {
+                                    outputData[n][(m*width)+j] = outDataColumn[n];
+                                }
                         
+                            }
+                        }
                     }
-                }
 				
-				for(int n = 0; n < this->numOutBands; n++)
-				{
-                    rowOffset = yBlockSize * i;
-					outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, yBlockSize, outputData[n], width, yBlockSize, GDT_Float64, 0, 0);
-				}
-			}
+    				for(int n = 0; n < this->numOutBands; n++)
+    				{
+                        rowOffset = yBlockSize * i;
+    					outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, yBlockSize, outputData[n], width, yBlockSize, GDT_Float64, 0, 0);
+    				}
+    			}
             
-            if(remainRows > 0)
-            {
-                for(int n = 0; n < numInBands; n++)
-				{
-                    rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
-				}
-                                
-                for(int m = 0; m < remainRows; ++m)
+                if(remainRows > 0)
                 {
-                    pbar.progress((nYBlocks*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
+                    for(int n = 0; n < numInBands; n++)
+    				{
+                        rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
+    					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
+    				}
+                                
+                    if(this->calc->implementsCalcImageBlock())
                     {
-                        for(int n = 0; n < numInBands; n++)
+                        this->calc->calcImageBlock(inputData, numInBands, width*remainRows, outputData);
+                        pbar.progress((nYBlocks*yBlockSize), height);
+                    }
+                    else
+                    {
+                        for(int m = 0; m < remainRows; ++m)
                         {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
+                            pbar.progress((nYBlocks*yBlockSize)+m, height);
+                    
+                            for(int j = 0; j < width; j++)
+                            {
+                                for(int n = 0; n < numInBands; n++)
+                                {
+                                    inDataColumn[n] = inputData[n][(m*width)+j];
+                                }
                         
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
+                                this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
                         
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
+                                for(int n = 0; n < this->numOutBands; n++)
+                                {
+                                    outputData[n][(m*width)+j] = outDataColumn[n];
+                                }
                         
+                            }
+                        }
                     }
-                }
 				
-				for(int n = 0; n < this->numOutBands; n++)
-				{
-                    rowOffset = (yBlockSize * nYBlocks);
-					outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, remainRows, outputData[n], width, remainRows, GDT_Float64, 0, 0);
-				}
+    				for(int n = 0; n < this->numOutBands; n++)
+    				{
+                        rowOffset = (yBlockSize * nYBlocks);
+    					outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, remainRows, outputData[n], width, remainRows, GDT_Float64, 0, 0);
+    				}
+                }
+    			pbar.finish();
             }
-			pbar.finish();
 		}
 		catch(RSGISImageCalcException& e)
 		{
@@ -508,6 +577,7 @@ namespace rsgis{namespace img{
             std::cout << "New image width = " << width << " height = " << height << " bands = " << this->numOutBands << std::endl;
             
             outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, gdalDataType, papszOptions);
+            RSGISImageBlockCache::invalidate(outputImage);
             if(outputImageDS == NULL)
             {
                 throw RSGISImageBandException("Output image could not be created. Check filepath.");
@@ -523,6 +593,7 @@ namespace rsgis{namespace img{
             }
             
             outputRefImageDS = gdalDriver->Create(outputRefIntImage.c_str(), width, height, 1, GDT_UInt32, papszOptions);
+            RSGISImageBlockCache::invalidate(outputRefIntImage);
             if(outputRefImageDS == NULL)
             {
                 throw RSGISImageBandException("Output reference image could not be created. Check filepath.");
@@ -597,7 +668,7 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numInBands; n++)
                 {
                     rowOffset = bandOffsets[n][1] + (yBlockSize * i);
-                    inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
                 }
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -634,7 +705,7 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numInBands; n++)
                 {
                     rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
-                    inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
                 }
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -1000,99 +1071,129 @@ namespace rsgis{namespace img{
                 yBlockSize = outYBlockSize;
             }
             
-			// Allocate memory
-			inputData = new float*[numInBands];
-			for(int i = 0; i < numInBands; i++)
-			{
-				inputData[i] = (float *) CPLMalloc(sizeof(float)*width*yBlockSize);
-			}
-			inDataColumn = new float[numInBands];
+            bool processedInParallel = false;
+            if(this->numThreads > 1)
+            {
+                processedInParallel = this->calcImageParallel(inputRasterBands, bandOffsets, numInBands, outputRasterBands, width, height, yBlockSize);
+            }
+            else if(this->pipelinedIO)
+            {
+                this->calcImagePipelined(inputRasterBands, bandOffsets, numInBands, outputRasterBands, width, height, yBlockSize);
+                processedInParallel = true;
+            }
             
-			outputData = new double*[this->numOutBands];
-			for(int i = 0; i < this->numOutBands; i++)
-			{
-				outputData[i] = (double *) CPLMalloc(sizeof(double)*width*yBlockSize);
-			}
-			outDataColumn = new double[this->numOutBands];
+            if(!processedInParallel)
+            {
+    			// Allocate memory
+    			inputData = new float*[numInBands];
+    			for(int i = 0; i < numInBands; i++)
+    			{
+    				inputData[i] = (float *) CPLMalloc(sizeof(float)*width*yBlockSize);
+    			}
+    			inDataColumn = new float[numInBands];
             
-			int nYBlocks = height / yBlockSize;
-            int remainRows = height - (nYBlocks * yBlockSize);
-            int rowOffset = 0;
+    			outputData = new double*[this->numOutBands];
+    			for(int i = 0; i < this->numOutBands; i++)
+    			{
+    				outputData[i] = (double *) CPLMalloc(sizeof(double)*width*yBlockSize);
+    			}
+    			outDataColumn = new double[this->numOutBands];
             
-			rsgis_tqdm pbar;
-			// Loop images to process data
-			for(int i = 0; i < nYBlocks; i++)
-			{
-				for(int n = 0; n < numInBands; n++)
-				{
-                    rowOffset = bandOffsets[n][1] + (yBlockSize * i);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
-				}
+    			int nYBlocks = height / yBlockSize;
+                int remainRows = height - (nYBlocks * yBlockSize);
+                int rowOffset = 0;
+            
+    			rsgis_tqdm pbar;
+    			// Loop images to process data
+    			for(int i = 0; i < nYBlocks; i++)
+    			{
+    				for(int n = 0; n < numInBands; n++)
+    				{
+                        rowOffset = bandOffsets[n][1] + (yBlockSize * i);
+    					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
+    				}
                 
-                for(int m = 0; m < yBlockSize; ++m)
-                {
-                    pbar.progress((i*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
+                    if(this->calc->implementsCalcImageBlock())
                     {
-                        for(int n = 0; n < numInBands; n++)
+                        this->calc->calcImageBlock(inputData, numInBands, width*yBlockSize, outputData);
+                        pbar.progress((i*yBlockSize), height);
+                    }
+                    else
+                    {
+                        for(int m = 0; m < yBlockSize; ++m)
                         {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
+                            pbar.progress((i*yBlockSize)+m, height);
+                    
+                            for(int j = 0; j < width; j++)
+                            {
+                                for(int n = 0; n < numInBands; n++)
+                                {
+                                    inDataColumn[n] = inputData[n][(m*width)+j];
+                                }
                         
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
+                                this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
                         
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
+                                for(int n = 0; n < this->numOutBands; n++)
+                                {
+                                    outputData[n][(m*width)+j] = outDataColumn[n];
+                                }
                         
+                            }
+                        }
                     }
-                }
 				
-				for(int n = 0; n < this->numOutBands; n++)
-				{
-                    rowOffset = yBlockSize * i;
-					outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, yBlockSize, outputData[n], width, yBlockSize, GDT_Float64, 0, 0);
-				}
-			}
+    				for(int n = 0; n < this->numOutBands; n++)
+    				{
+                        rowOffset = yBlockSize * i;
+    					outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, yBlockSize, outputData[n], width, yBlockSize, GDT_Float64, 0, 0);
+    				}
+    			}
             
-            if(remainRows > 0)
-            {
-                for(int n = 0; n < numInBands; n++)
-				{
-                    rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
-				}
-                
-                for(int m = 0; m < remainRows; ++m)
+                if(remainRows > 0)
                 {
-                    pbar.progress((nYBlocks*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
+                    for(int n = 0; n < numInBands; n++)
+    				{
+                        rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
+    					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
+    				}
+                
+                    if(this->calc->implementsCalcImageBlock())
                     {
-                        for(int n = 0; n < numInBands; n++)
+                        this->calc->calcImageBlock(inputData, numInBands, width*remainRows, outputData);
+                        pbar.progress((nYBlocks*yBlockSize), height);
+                    }
+                    else
+                    {
+                        for(int m = 0; m < remainRows; ++m)
                         {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
+                            pbar.progress((nYBlocks*yBlockSize)+m, height);
+                    
+                            for(int j = 0; j < width; j++)
+                            {
+                                for(int n = 0; n < numInBands; n++)
+                                {
+                                    inDataColumn[n] = inputData[n][(m*width)+j];
+                                }
                         
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
+                                this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
                         
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
+                                for(int n = 0; n < this->numOutBands; n++)
+                                {
+                                    outputData[n][(m*width)+j] = outDataColumn[n];
+                                }
                         
+                            }
+                        }
                     }
-                }
 				
-				for(int n = 0; n < this->numOutBands; n++)
-				{
-                    rowOffset = (yBlockSize * nYBlocks);
-					outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, remainRows, outputData[n], width, remainRows, GDT_Float64, 0, 0);
-				}
+    				for(int n = 0; n < this->numOutBands; n++)
+    				{
+                        rowOffset = (yBlockSize * nYBlocks);
+    					outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, remainRows, outputData[n], width, remainRows, GDT_Float64, 0, 0);
+    				}
+                }
+    			pbar.finish();
             }
-			pbar.finish();
 		}
 		catch(RSGISImageCalcException& e)
 		{			
@@ -1428,7 +1529,7 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numInBands; n++)
                 {
                     rowOffset = bandOffsets[n][1] + (yBlockSize * i);
-                    inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
                 }
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -1464,7 +1565,7 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numInBands; n++)
                 {
                     rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
-                    inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
                 }
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -1785,6 +1886,7 @@ namespace rsgis{namespace img{
 			std::cout << "New image width = " << width << " height = " << height << " bands = " << this->numOutBands << std::endl;
 			
 			outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, gdalDataType, papszOptions);
+			RSGISImageBlockCache::invalidate(outputImage);
 			
 			if(outputImageDS == NULL)
 			{
@@ -1885,13 +1987,13 @@ namespace rsgis{namespace img{
 				for(int n = 0; n < numIntBands; n++)
 				{
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * i);
-					inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
 				}
                 
                 for(int n = 0; n < numFloatBands; n++)
 				{
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * i);
-					inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -1931,13 +2033,13 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numIntBands; n++)
 				{
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
 				}
                 
                 for(int n = 0; n < numFloatBands; n++)
 				{
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -2373,6 +2475,7 @@ namespace rsgis{namespace img{
             std::cout << "New image width = " << width << " height = " << height << " bands = " << this->numOutBands << std::endl;
             
             outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, gdalDataType, papszOptions);
+            RSGISImageBlockCache::invalidate(outputImage);
             if(outputImageDS == NULL)
             {
                 throw RSGISImageBandException("Output image could not be created. Check filepath.");
@@ -2388,6 +2491,7 @@ namespace rsgis{namespace img{
             }
             
             outputRefImageDS = gdalDriver->Create(outputRefIntImage.c_str(), width, height, 1, GDT_UInt32, papszOptions);
+            RSGISImageBlockCache::invalidate(outputRefIntImage);
             if(outputRefImageDS == NULL)
             {
                 throw RSGISImageBandException("Output reference image could not be created. Check filepath.");
@@ -2486,13 +2590,13 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numIntBands; n++)
                 {
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * i);
-                    inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
                 }
                 
                 for(int n = 0; n < numFloatBands; n++)
                 {
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * i);
-                    inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
                 }
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -2534,13 +2638,13 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numIntBands; n++)
                 {
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * nYBlocks);
-                    inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
                 }
                 
                 for(int n = 0; n < numFloatBands; n++)
                 {
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * nYBlocks);
-                    inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
                 }
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -3030,13 +3134,13 @@ namespace rsgis{namespace img{
 				for(int n = 0; n < numIntBands; n++)
 				{
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * i);
-					inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
 				}
                 
                 for(int n = 0; n < numFloatBands; n++)
 				{
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * i);
-					inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -3069,14 +3173,14 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numIntBands; n++)
 				{
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
 				}
                 
                 
                 for(int n = 0; n < numFloatBands; n++)
 				{
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -3517,13 +3621,13 @@ namespace rsgis{namespace img{
 				for(int n = 0; n < numIntBands; n++)
 				{
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * i);
-					inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
 				}
                 
                 for(int n = 0; n < numFloatBands; n++)
 				{
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * i);
-					inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -3563,13 +3667,13 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numIntBands; n++)
 				{
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
 				}
                 
                 for(int n = 0; n < numFloatBands; n++)
 				{
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -3985,68 +4089,82 @@ namespace rsgis{namespace img{
 				}
 			}
 			
-			// Allocate memory
-			inputData = new float*[numInBands];
-			for(int i = 0; i < numInBands; i++)
-			{
-				inputData[i] = (float *) CPLMalloc(sizeof(float)*width*yBlockSize);
-			}
-			inDataColumn = new float[numInBands];
+            bool processedInParallel = false;
+            if(this->numThreads > 1)
+            {
+                processedInParallel = this->calcImageParallel(inputRasterBands, bandOffsets, numInBands, NULL, width, height, yBlockSize);
+            }
+            else if(this->pipelinedIO)
+            {
+                this->calcImagePipelined(inputRasterBands, bandOffsets, numInBands, NULL, width, height, yBlockSize);
+                processedInParallel = true;
+            }
             
-            int nYBlocks = height / yBlockSize;
-            int remainRows = height - (nYBlocks * yBlockSize);
-            int rowOffset = 0;
+            if(!processedInParallel)
+            {
+    			// Allocate memory
+    			inputData = new float*[numInBands];
+    			for(int i = 0; i < numInBands; i++)
+    			{
+    				inputData[i] = (float *) CPLMalloc(sizeof(float)*width*yBlockSize);
+    			}
+    			inDataColumn = new float[numInBands];
             
-			rsgis_tqdm pbar;
-			// Loop images to process data
-			for(int i = 0; i < nYBlocks; i++)
-			{
-				for(int n = 0; n < numInBands; n++)
-				{
-                    rowOffset = bandOffsets[n][1] + (yBlockSize * i);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
-				}
+                int nYBlocks = height / yBlockSize;
+                int remainRows = height - (nYBlocks * yBlockSize);
+                int rowOffset = 0;
+            
+    			rsgis_tqdm pbar;
+    			// Loop images to process data
+    			for(int i = 0; i < nYBlocks; i++)
+    			{
+    				for(int n = 0; n < numInBands; n++)
+    				{
+                        rowOffset = bandOffsets[n][1] + (yBlockSize * i);
+    					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
+    				}
                 
-                for(int m = 0; m < yBlockSize; ++m)
-                {
-                    pbar.progress((i*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
+                    for(int m = 0; m < yBlockSize; ++m)
                     {
-                        for(int n = 0; n < numInBands; n++)
+                        pbar.progress((i*yBlockSize)+m, height);
+                    
+                        for(int j = 0; j < width; j++)
                         {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
+                            for(int n = 0; n < numInBands; n++)
+                            {
+                                inDataColumn[n] = inputData[n][(m*width)+j];
+                            }
                         
-                        this->calc->calcImageValue(inDataColumn, numInBands);
+                            this->calc->calcImageValue(inDataColumn, numInBands);
+                        }
                     }
-                }
-			}
+    			}
             
-            if(remainRows > 0)
-            {
-                for(int n = 0; n < numInBands; n++)
-				{
-                    rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
-				}
-                
-                for(int m = 0; m < remainRows; ++m)
+                if(remainRows > 0)
                 {
-                    pbar.progress((nYBlocks*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
+                    for(int n = 0; n < numInBands; n++)
+    				{
+                        rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
+    					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
+    				}
+                
+                    for(int m = 0; m < remainRows; ++m)
                     {
-                        for(int n = 0; n < numInBands; n++)
+                        pbar.progress((nYBlocks*yBlockSize)+m, height);
+                    
+                        for(int j = 0; j < width; j++)
                         {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
+                            for(int n = 0; n < numInBands; n++)
+                            {
+                                inDataColumn[n] = inputData[n][(m*width)+j];
+                            }
                         
-                        this->calc->calcImageValue(inDataColumn, numInBands);
+                            this->calc->calcImageValue(inDataColumn, numInBands);
+                        }
                     }
                 }
+    			pbar.finish();
             }
-			pbar.finish();
 		}
 		catch(RSGISImageCalcException& e)
 		{
@@ -4257,6 +4375,7 @@ namespace rsgis{namespace img{
                 std::cout << "New image width = " << width << " height = " << height << " bands = " << this->numOutBands << std::endl;
 				
 				outputImageDS = gdalDriver->Create(outputImageFileName.c_str(), width, height, this->numOutBands, GDT_Float32, papszOptions);
+				RSGISImageBlockCache::invalidate(outputImageFileName);
 				
                 if(outputImageDS == NULL)
                 {
@@ -4312,7 +4431,7 @@ namespace rsgis{namespace img{
                 {
                     pbar.progress(i, height);
 
-                    inputRasterBands[cImgBand]->RasterIO(GF_Read, bandOffsets[cImgBand][0], (bandOffsets[cImgBand][1]+i), width, 1, inputData, width, 1, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterBands[cImgBand], bandOffsets[cImgBand][0], (bandOffsets[cImgBand][1]+i), width, 1, inputData, width, 1, GDT_Float32, 0, 0);
                     
                     for(int j = 0; j < width; j++)
                     {
@@ -4494,6 +4613,7 @@ namespace rsgis{namespace img{
 			std::cout << "New image width = " << width << " height = " << height << " bands = " << this->numOutBands << std::endl;
 			
 			outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, gdalDataType, papszOptions);
+			RSGISImageBlockCache::invalidate(outputImage);
 			
 			if(outputImageDS == NULL)
 			{
@@ -4570,7 +4690,7 @@ namespace rsgis{namespace img{
 				for(int n = 0; n < numInBands; n++)
 				{
                     rowOffset = bandOffsets[n][1] + (yBlockSize * i);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -4606,7 +4726,7 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numInBands; n++)
 				{
                     rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -4940,7 +5060,7 @@ namespace rsgis{namespace img{
 				for(int n = 0; n < numInBands; n++)
 				{
                     rowOffset = bandOffsets[n][1] + (yBlockSize * i);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -4967,7 +5087,7 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numInBands; n++)
 				{
                     rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -5263,13 +5383,13 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numIntBands; n++)
                 {
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * i);
-                    inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
                 }
                 
                 for(int n = 0; n < numFloatBands; n++)
                 {
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * i);
-                    inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
                 }
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -5301,14 +5421,14 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numIntBands; n++)
                 {
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * nYBlocks);
-                    inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
                 }
                 
                 
                 for(int n = 0; n < numFloatBands; n++)
                 {
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * nYBlocks);
-                    inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
                 }
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -5674,7 +5794,7 @@ namespace rsgis{namespace img{
 				for(int n = 0; n < numInBands; n++)
 				{
                     rowOffset = bandOffsets[n][1] + (yBlockSize * i);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -5703,7 +5823,7 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numInBands; n++)
 				{
                     rowOffset = bandOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -5990,13 +6110,13 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numIntBands; n++)
                 {
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * i);
-                    inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
                 }
                 
                 for(int n = 0; n < numFloatBands; n++)
                 {
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * i);
-                    inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
                 }
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -6031,14 +6151,14 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numIntBands; n++)
                 {
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * nYBlocks);
-                    inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
                 }
                 
                 
                 for(int n = 0; n < numFloatBands; n++)
                 {
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * nYBlocks);
-                    inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
+                    RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
                 }
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -6424,7 +6544,7 @@ namespace rsgis{namespace img{
 				
 				for(int n = 0; n < numInBands; n++)
 				{
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
 				}
 
                 for(int j = 0; j < width; j++)
@@ -6733,13 +6853,13 @@ namespace rsgis{namespace img{
 				for(int n = 0; n < numIntBands; n++)
 				{
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * i);
-					inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, yBlockSize, inputIntData[n], width, yBlockSize, GDT_UInt32, 0, 0);
 				}
                 
                 for(int n = 0; n < numFloatBands; n++)
 				{
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * i);
-					inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, yBlockSize, inputFloatData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < yBlockSize; ++m)
@@ -6774,14 +6894,14 @@ namespace rsgis{namespace img{
                 for(int n = 0; n < numIntBands; n++)
 				{
                     rowOffset = bandIntOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterIntBands[n]->RasterIO(GF_Read, bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterIntBands[n], bandIntOffsets[n][0], rowOffset, width, remainRows, inputIntData[n], width, remainRows, GDT_UInt32, 0, 0);
 				}
                 
                 
                 for(int n = 0; n < numFloatBands; n++)
 				{
                     rowOffset = bandFloatOffsets[n][1] + (yBlockSize * nYBlocks);
-					inputRasterFloatBands[n]->RasterIO(GF_Read, bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterFloatBands[n], bandFloatOffsets[n][0], rowOffset, width, remainRows, inputFloatData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                 
                 for(int m = 0; m < remainRows; ++m)
@@ -7124,6 +7244,7 @@ namespace rsgis{namespace img{
             char **papszOptions = imgUtils.getGDALCreationOptionsForFormat(gdalFormat);
             
 			outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, gdalDataType, papszOptions);
+			RSGISImageBlockCache::invalidate(outputImage);
 			
 			if(outputImageDS == NULL)
 			{
@@ -7195,7 +7316,7 @@ namespace rsgis{namespace img{
 				
 				for(int n = 0; n < numInBands; n++)
 				{
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
 				}
 				
 				for(int j = 0; j < width; j++)
@@ -7599,7 +7720,7 @@ namespace rsgis{namespace img{
                         for(int n = 0; n < numInBands; n++)
                         {
                             rowOffset = bandOffsets[n][1] + (numOfLines * i);
-                            inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataMain[n], width, numOfLines, GDT_Float32, 0, 0);
+                            RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataMain[n], width, numOfLines, GDT_Float32, 0, 0);
                         }
                         // Read Lower Block
                         for(int n = 0; n < numInBands; n++)
@@ -7609,7 +7730,7 @@ namespace rsgis{namespace img{
                                 if(remainRows > 0)
                                 {
                                     rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                    inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
+                                    RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
                                     for(int k = (remainRows*width); k < numPxlsInBlock; k++)
                                     {
                                         inputDataLower[n][k] = 0;
@@ -7626,7 +7747,7 @@ namespace rsgis{namespace img{
                             else
                             {
                                 rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
+                                RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
                             }
                         }
                     }
@@ -7656,7 +7777,7 @@ namespace rsgis{namespace img{
                             if(remainRows > 0)
                             {
                                 rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
+                                RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
                                 for(int k = (remainRows*width); k < numPxlsInBlock; k++)
                                 {
                                     inputDataLower[n][k] = 0;
@@ -7695,7 +7816,7 @@ namespace rsgis{namespace img{
                         for(int n = 0; n < numInBands; n++)
                         {
                             rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                            inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
+                            RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
                         }
                     }
                     
@@ -8374,6 +8495,7 @@ namespace rsgis{namespace img{
 			}
             char **papszOptions = imgUtils.getGDALCreationOptionsForFormat(gdalFormat);
 			outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, gdalDataType, papszOptions);
+			RSGISImageBlockCache::invalidate(outputImage);
 			
 			if(outputImageDS == NULL)
 			{
@@ -8506,7 +8628,7 @@ namespace rsgis{namespace img{
                         for(int n = 0; n < numInBands; n++)
                         {
                             rowOffset = bandOffsets[n][1] + (numOfLines * i);
-                            inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataMain[n], width, numOfLines, GDT_Float32, 0, 0);
+                            RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataMain[n], width, numOfLines, GDT_Float32, 0, 0);
                         }
                         // Read Lower Block
                         for(int n = 0; n < numInBands; n++)
@@ -8516,7 +8638,7 @@ namespace rsgis{namespace img{
                                 if(remainRows > 0)
                                 {
                                     rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                    inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
+                                    RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
                                     for(int k = (remainRows*width); k < numPxlsInBlock; k++)
                                     {
                                         inputDataLower[n][k] = 0;
@@ -8533,7 +8655,7 @@ namespace rsgis{namespace img{
                             else
                             {
                                 rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
+                                RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
                             }
                         }
                     }
@@ -8563,7 +8685,7 @@ namespace rsgis{namespace img{
                             if(remainRows > 0)
                             {
                                 rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
+                                RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
                                 for(int k = (remainRows*width); k < numPxlsInBlock; k++)
                                 {
                                     inputDataLower[n][k] = 0;
@@ -8602,7 +8724,7 @@ namespace rsgis{namespace img{
                         for(int n = 0; n < numInBands; n++)
                         {
                             rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                            inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
+                            RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
                         }
                     }
                     
@@ -9334,6 +9456,7 @@ namespace rsgis{namespace img{
             }
             char **papszOptions = imgUtils.getGDALCreationOptionsForFormat(gdalFormat);
             outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, gdalDataType, papszOptions);
+            RSGISImageBlockCache::invalidate(outputImage);
             if(outputImageDS == NULL)
             {
                 throw RSGISImageBandException("Output image could not be created. Check filepath.");
@@ -9349,6 +9472,7 @@ namespace rsgis{namespace img{
             }
             
             outputRefImageDS = gdalDriver->Create(outputRefIntImage.c_str(), width, height, 1, GDT_UInt32, papszOptions);
+            RSGISImageBlockCache::invalidate(outputRefIntImage);
             if(outputRefImageDS == NULL)
             {
                 throw RSGISImageBandException("Output reference image could not be created. Check filepath.");
@@ -9482,7 +9606,7 @@ namespace rsgis{namespace img{
                         for(int n = 0; n < numInBands; n++)
                         {
                             rowOffset = bandOffsets[n][1] + (numOfLines * i);
-                            inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataMain[n], width, numOfLines, GDT_Float32, 0, 0);
+                            RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataMain[n], width, numOfLines, GDT_Float32, 0, 0);
                         }
                         // Read Lower Block
                         for(int n = 0; n < numInBands; n++)
@@ -9492,7 +9616,7 @@ namespace rsgis{namespace img{
                                 if(remainRows > 0)
                                 {
                                     rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                    inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
+                                    RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
                                     for(int k = (remainRows*width); k < numPxlsInBlock; k++)
                                     {
                                         inputDataLower[n][k] = 0;
@@ -9509,7 +9633,7 @@ namespace rsgis{namespace img{
                             else
                             {
                                 rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
+                                RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
                             }
                         }
                     }
@@ -9539,7 +9663,7 @@ namespace rsgis{namespace img{
                             if(remainRows > 0)
                             {
                                 rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
+                                RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
                                 for(int k = (remainRows*width); k < numPxlsInBlock; k++)
                                 {
                                     inputDataLower[n][k] = 0;
@@ -9578,7 +9702,7 @@ namespace rsgis{namespace img{
                         for(int n = 0; n < numInBands; n++)
                         {
                             rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                            inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
+                            RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
                         }
                     }
                     
@@ -10457,7 +10581,7 @@ namespace rsgis{namespace img{
                         for(int n = 0; n < numInBands; n++)
                         {
                             rowOffset = bandOffsets[n][1] + (numOfLines * i);
-                            inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataMain[n], width, numOfLines, GDT_Float32, 0, 0);
+                            RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataMain[n], width, numOfLines, GDT_Float32, 0, 0);
                         }
                         // Read Lower Block
                         for(int n = 0; n < numInBands; n++)
@@ -10467,7 +10591,7 @@ namespace rsgis{namespace img{
                                 if(remainRows > 0)
                                 {
                                     rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                    inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
+                                    RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
                                     for(int k = (remainRows*width); k < numPxlsInBlock; k++)
                                     {
                                         inputDataLower[n][k] = 0;
@@ -10484,7 +10608,7 @@ namespace rsgis{namespace img{
                             else
                             {
                                 rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
+                                RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
                             }
                         }
                     }
@@ -10514,7 +10638,7 @@ namespace rsgis{namespace img{
                             if(remainRows > 0)
                             {
                                 rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
+                                RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
                                 for(int k = (remainRows*width); k < numPxlsInBlock; k++)
                                 {
                                     inputDataLower[n][k] = 0;
@@ -10553,7 +10677,7 @@ namespace rsgis{namespace img{
                         for(int n = 0; n < numInBands; n++)
                         {
                             rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                            inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
+                            RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
                         }
                     }
                     
@@ -11302,6 +11426,7 @@ namespace rsgis{namespace img{
             }
             char **papszOptions = imgUtils.getGDALCreationOptionsForFormat(gdalFormat);
             outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, gdalDataType, papszOptions);
+            RSGISImageBlockCache::invalidate(outputImage);
             
             if(outputImageDS == NULL)
             {
@@ -11450,7 +11575,7 @@ namespace rsgis{namespace img{
                         for(int n = 0; n < numInBands; n++)
                         {
                             rowOffset = bandOffsets[n][1] + (numOfLines * i);
-                            inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataMain[n], width, numOfLines, GDT_Float32, 0, 0);
+                            RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataMain[n], width, numOfLines, GDT_Float32, 0, 0);
                         }
                         // Read Lower Block
                         for(int n = 0; n < numInBands; n++)
@@ -11460,7 +11585,7 @@ namespace rsgis{namespace img{
                                 if(remainRows > 0)
                                 {
                                     rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                    inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
+                                    RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
                                     for(int k = (remainRows*width); k < numPxlsInBlock; k++)
                                     {
                                         inputDataLower[n][k] = 0;
@@ -11477,7 +11602,7 @@ namespace rsgis{namespace img{
                             else
                             {
                                 rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
+                                RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
                             }
                         }
                     }
@@ -11507,7 +11632,7 @@ namespace rsgis{namespace img{
                             if(remainRows > 0)
                             {
                                 rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                                inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
+                                RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, remainRows, inputDataLower[n], width, remainRows, GDT_Float32, 0, 0);
                                 for(int k = (remainRows*width); k < numPxlsInBlock; k++)
                                 {
                                     inputDataLower[n][k] = 0;
@@ -11546,7 +11671,7 @@ namespace rsgis{namespace img{
                         for(int n = 0; n < numInBands; n++)
                         {
                             rowOffset = bandOffsets[n][1] + (numOfLines * (i+1));
-                            inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
+                            RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], rowOffset, width, numOfLines, inputDataLower[n], width, numOfLines, GDT_Float32, 0, 0);
                         }
                     }
                     
@@ -12275,6 +12400,7 @@ namespace rsgis{namespace img{
 			}
             char **papszOptions = imgUtils.getGDALCreationOptionsForFormat(gdalFormat);
 			outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, this->numOutBands, gdalDataType, papszOptions);
+			RSGISImageBlockCache::invalidate(outputImage);
 			
 			if(outputImageDS == NULL)
 			{
@@ -12333,15 +12459,62 @@ namespace rsgis{namespace img{
 			}
 			outDataColumn = new double[this->numOutBands];
 			
+			// Rasterise the polygon row by row rather than testing each pixel (if supported by the method).
+			bool useScanline = RSGISPolygonScanline::isOptionSupported(pixelPolyOption);
+			RSGISPolygonScanline scanline(poly, gdalTranslation[0], gdalTranslation[3], pxlWidth, pxlHeight, width, height);
+			std::vector<RSGISPixelSpan> rowSpans;
+			
 			rsgis_tqdm pbar;
             // Loop images to process data
 			for(int i = 0; i < height; i++)
 			{				
 				pbar.progress(i, height);
 				
+				if(useScanline)
+				{
+					scanline.findRowSpans(i, pixelPolyOption, &rowSpans);
+					for(int n = 0; n < this->numOutBands; n++)
+					{
+						for(int j = 0; j < width; j++)
+						{
+							outputData[n][j] = nodata;
+						}
+					}
+					if(!rowSpans.empty())
+					{
+						// Only read the part of the row covered by the spans.
+						int startCol = rowSpans.front().startCol;
+						int spanWidth = rowSpans.back().endCol - startCol;
+						for(int n = 0; n < numInBands; n++)
+						{
+							RSGISImageBlockCache::readRaster(inputRasterBands[n], (bandOffsets[n][0]+startCol), (bandOffsets[n][1]+i), spanWidth, 1, inputData[n], spanWidth, 1, GDT_Float32, 0, 0);
+						}
+						for(std::vector<RSGISPixelSpan>::iterator iterSpan = rowSpans.begin(); iterSpan != rowSpans.end(); ++iterSpan)
+						{
+							for(int j = (*iterSpan).startCol; j < (*iterSpan).endCol; j++)
+							{
+								for(int n = 0; n < numInBands; n++)
+								{
+									inDataColumn[n] = inputData[n][j-startCol];
+								}
+								this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
+								for(int n = 0; n < this->numOutBands; n++)
+								{
+									outputData[n][j] = outDataColumn[n];
+								}
+							}
+						}
+					}
+					for(int n = 0; n < this->numOutBands; n++)
+					{
+						outputRasterBands[n]->RasterIO(GF_Write, 0, i, width, 1, outputData[n], width, 1, GDT_Float64, 0, 0);
+					}
+					continue;
+				}
+				
 				for(int n = 0; n < numInBands; n++)
 				{
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
 				}
 				
 				for(int j = 0; j < width; j++)
@@ -12817,6 +12990,11 @@ namespace rsgis{namespace img{
 			}
 			outDataColumn = new double[this->numOutBands];
 			
+			// Rasterise the polygon row by row rather than testing each pixel (if supported by the method).
+			bool useScanline = RSGISPolygonScanline::isOptionSupported(pixelPolyOption);
+			RSGISPolygonScanline scanline(poly, gdalTranslation[0], gdalTranslation[3], pxlWidth, pxlHeight, width, height);
+			std::vector<RSGISPixelSpan> rowSpans;
+			
 			int feedback = height/10;
 			if (feedback == 0) {feedback = 1;} // Set feedback to 1
 			int feedbackCounter = 0;
@@ -12833,13 +13011,52 @@ namespace rsgis{namespace img{
 					feedbackCounter = feedbackCounter + 10;
 				}
 				
+				if(useScanline)
+				{
+					scanline.findRowSpans(i, pixelPolyOption, &rowSpans);
+					if(!rowSpans.empty())
+					{
+						// Only the part of the row covered by the spans is read and written.
+						int startCol = rowSpans.front().startCol;
+						int spanWidth = rowSpans.back().endCol - startCol;
+						for(int n = 0; n < numInBands; n++)
+						{
+							RSGISImageBlockCache::readRaster(inputRasterBands[n], (bandOffsets[n][0]+startCol), (bandOffsets[n][1]+i), spanWidth, 1, inputData[n], spanWidth, 1, GDT_Float32, 0, 0);
+						}
+						for(int n = 0; n < this->numOutBands; n++)
+						{
+							RSGISImageBlockCache::readRaster(outputRasterBands[n], (bandOffsets[n][0]+startCol), (bandOffsets[n][1]+i), spanWidth, 1, outputData[n], spanWidth, 1, GDT_Float64, 0, 0);
+						}
+						for(std::vector<RSGISPixelSpan>::iterator iterSpan = rowSpans.begin(); iterSpan != rowSpans.end(); ++iterSpan)
+						{
+							for(int j = (*iterSpan).startCol; j < (*iterSpan).endCol; j++)
+							{
+								for(int n = 0; n < numInBands; n++)
+								{
+									inDataColumn[n] = inputData[n][j-startCol];
+								}
+								this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
+								for(int n = 0; n < this->numOutBands; n++)
+								{
+									outputData[n][j-startCol] = outDataColumn[n];
+								}
+							}
+						}
+						for(int n = 0; n < this->numOutBands; n++)
+						{
+							outputRasterBands[n]->RasterIO(GF_Write, (bandOffsets[n][0]+startCol), (bandOffsets[n][1]+i), spanWidth, 1, outputData[n], spanWidth, 1, GDT_Float64, 0, 0);
+						}
+					}
+					continue;
+				}
+				
 				for(int n = 0; n < numInBands; n++)
 				{
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
 				}
 				for(int n = 0; n < this->numOutBands; n++)
 				{
-					outputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, outputData[n], width, 1, GDT_Float64, 0, 0);
+					RSGISImageBlockCache::readRaster(outputRasterBands[n], bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, outputData[n], width, 1, GDT_Float64, 0, 0);
 				}
 				
 				
@@ -13324,12 +13541,47 @@ namespace rsgis{namespace img{
 			}
 			inDataColumn = new float[numInBands];
             
+			// Rasterise the polygon row by row rather than testing each pixel (if supported by the method).
+			bool useScanline = RSGISPolygonScanline::isOptionSupported(pixelPolyOption);
+			RSGISPolygonScanline scanline(poly, gdalTranslation[0], gdalTranslation[3], pxlWidth, pxlHeight, width, height);
+			std::vector<RSGISPixelSpan> rowSpans;
+			
 			// Loop images to process data
 			for(int i = 0; i < height; i++)
 			{				
+				if(useScanline)
+				{
+					scanline.findRowSpans(i, pixelPolyOption, &rowSpans);
+					if(!rowSpans.empty())
+					{
+						// Only read the part of the row covered by the spans.
+						int startCol = rowSpans.front().startCol;
+						int spanWidth = rowSpans.back().endCol - startCol;
+						for(int n = 0; n < numInBands; n++)
+						{
+							RSGISImageBlockCache::readRaster(inputRasterBands[n], (bandOffsets[n][0]+startCol), (bandOffsets[n][1]+i), spanWidth, 1, inputData[n], spanWidth, 1, GDT_Float32, 0, 0);
+						}
+						double rowTLY = gdalTranslation[3] - (i * pxlHeight);
+						for(std::vector<RSGISPixelSpan>::iterator iterSpan = rowSpans.begin(); iterSpan != rowSpans.end(); ++iterSpan)
+						{
+							for(int j = (*iterSpan).startCol; j < (*iterSpan).endCol; j++)
+							{
+								for(int n = 0; n < numInBands; n++)
+								{
+									inDataColumn[n] = inputData[n][j-startCol];
+								}
+								double colTLX = gdalTranslation[0] + (j * pxlWidth);
+								extent.init(colTLX, (colTLX+pxlWidth), rowTLY, (rowTLY-pxlHeight));
+								this->calc->calcImageValue(inDataColumn, numInBands, extent);
+							}
+						}
+					}
+					continue;
+				}
+				
 				for(int n = 0; n < numInBands; n++)
 				{
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
 				}
 				
 				for(int j = 0; j < width; j++)
@@ -13713,12 +13965,37 @@ namespace rsgis{namespace img{
             bool readSuccess = true;
             for(int n = 0; n < numInBands; n++)
             {
-                readSuccess = inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], (bandOffsets[n][1]), width, height, inputData[n], width, height, GDT_Float32, 0, 0);
+                readSuccess = RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], (bandOffsets[n][1]), width, height, inputData[n], width, height, GDT_Float32, 0, 0);
             }
 
+            // Rasterise the polygon row by row rather than testing each pixel (if supported by the method).
+            bool useScanline = RSGISPolygonScanline::isOptionSupported(pixelPolyOption);
+            RSGISPolygonScanline scanline(poly, gdalTranslation[0], gdalTranslation[3], pxlWidth, pxlHeight, width, height);
+            std::vector<RSGISPixelSpan> rowSpans;
+
             // Loop images to process data
             for(int i = 0; i < height; i++)
             {
+                if(useScanline)
+                {
+                    scanline.findRowSpans(i, pixelPolyOption, &rowSpans);
+                    double rowTLY = gdalTranslation[3] - (i * pxlHeight);
+                    for(std::vector<RSGISPixelSpan>::iterator iterSpan = rowSpans.begin(); iterSpan != rowSpans.end(); ++iterSpan)
+                    {
+                        for(int j = (*iterSpan).startCol; j < (*iterSpan).endCol; j++)
+                        {
+                            for(int n = 0; n < numInBands; n++)
+                            {
+                                inDataColumn[n] = inputData[n][(i*width)+j];
+                            }
+                            double colTLX = gdalTranslation[0] + (j * pxlWidth);
+                            extent.init(colTLX, (colTLX+pxlWidth), rowTLY, (rowTLY-pxlHeight));
+                            this->calc->calcImageValue(inDataColumn, numInBands, extent);
+                        }
+                    }
+                    continue;
+                }
+
                 for(int j = 0; j < width; j++)
                 {
                     for(int n = 0; n < numInBands; n++)
@@ -14118,16 +14395,16 @@ namespace rsgis{namespace img{
 					feedbackCounter = feedbackCounter + 10;
 				}
 				counter = 0;
-				inputMaskBand[0]->RasterIO(GF_Read, bandOffsets[counter][0], (bandOffsets[counter][1]+i), width, 1, inputMask[0], width, 1, GDT_Float32, 0, 0);
+				RSGISImageBlockCache::readRaster(inputMaskBand[0], bandOffsets[counter][0], (bandOffsets[counter][1]+i), width, 1, inputMask[0], width, 1, GDT_Float32, 0, 0);
 				counter++;
 				for(int n = 0; n < numInBands; n++)
 				{
-					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[counter][0], (bandOffsets[counter][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[counter][0], (bandOffsets[counter][1]+i), width, 1, inputData[n], width, 1, GDT_Float32, 0, 0);
 					counter++;
 				}
 				for(int n = 0; n < this->numOutBands; n++)
 				{
-					outputRasterBands[n]->RasterIO(GF_Read, bandOffsets[counter][0], (bandOffsets[counter][1]+i), width, 1, outputData[n], width, 1, GDT_Float32, 0, 0);
+					RSGISImageBlockCache::readRaster(outputRasterBands[n], bandOffsets[counter][0], (bandOffsets[counter][1]+i), width, 1, outputData[n], width, 1, GDT_Float32, 0, 0);
 					counter++;
 				}
 				
@@ -14452,12 +14729,12 @@ namespace rsgis{namespace img{
                 {
                     if(returnInt)
                     {
-                        gdalBands[b]->RasterIO(GF_Read, x, 0, 1, 1, &tmpVal, 1, 1, GDT_Int32, 0, 0);
+                        RSGISImageBlockCache::readRaster(gdalBands[b], x, 0, 1, 1, &tmpVal, 1, 1, GDT_Int32, 0, 0);
                         pxlIntVals[b] = tmpVal;
                     }
                     else
                     {
-                        gdalBands[b]->RasterIO(GF_Read, x, 0, 1, 1, &pxlFloatVals[b], 1, 1, GDT_Float32, 0, 0);
+                        RSGISImageBlockCache::readRaster(gdalBands[b], x, 0, 1, 1, &pxlFloatVals[b], 1, 1, GDT_Float32, 0, 0);
                     }
                 }
                 this->calc->calcImageValue(pxlIntVals, numIntVals, pxlFloatVals, numfloatVals);
@@ -14467,12 +14744,12 @@ namespace rsgis{namespace img{
                 {
                     if(returnInt)
                     {
-                        gdalBands[b]->RasterIO(GF_Read, x, (imgHeight-1), 1, 1, &tmpVal, 1, 1, GDT_Int32, 0, 0);
+                        RSGISImageBlockCache::readRaster(gdalBands[b], x, (imgHeight-1), 1, 1, &tmpVal, 1, 1, GDT_Int32, 0, 0);
                         pxlIntVals[b] = tmpVal;
                     }
                     else
                     {
-                        gdalBands[b]->RasterIO(GF_Read, x, (imgHeight-1), 1, 1, &pxlFloatVals[b], 1, 1, GDT_Float32, 0, 0);
+                        RSGISImageBlockCache::readRaster(gdalBands[b], x, (imgHeight-1), 1, 1, &pxlFloatVals[b], 1, 1, GDT_Float32, 0, 0);
                     }
                 }
                 this->calc->calcImageValue(pxlIntVals, numIntVals, pxlFloatVals, numfloatVals);
@@ -14487,11 +14764,11 @@ namespace rsgis{namespace img{
                 {
                     if(returnInt)
                     {
-                        gdalBands[b]->RasterIO(GF_Read, 0, y, 1, 1, &pxlIntVals[b], 1, 1, GDT_Int32, 0, 0);
+                        RSGISImageBlockCache::readRaster(gdalBands[b], 0, y, 1, 1, &pxlIntVals[b], 1, 1, GDT_Int32, 0, 0);
                     }
                     else
                     {
-                        gdalBands[b]->RasterIO(GF_Read, 0, y, 1, 1, &pxlFloatVals[b], 1, 1, GDT_Float32, 0, 0);
+                        RSGISImageBlockCache::readRaster(gdalBands[b], 0, y, 1, 1, &pxlFloatVals[b], 1, 1, GDT_Float32, 0, 0);
                     }
                 }
                 this->calc->calcImageValue(pxlIntVals, numIntVals, pxlFloatVals, numfloatVals);
@@ -14501,11 +14778,11 @@ namespace rsgis{namespace img{
                 {
                     if(returnInt)
                     {
-                        gdalBands[b]->RasterIO(GF_Read, (imgWidth-1), y, 1, 1, &pxlIntVals[b], 1, 1, GDT_Int32, 0, 0);
+                        RSGISImageBlockCache::readRaster(gdalBands[b], (imgWidth-1), y, 1, 1, &pxlIntVals[b], 1, 1, GDT_Int32, 0, 0);
                     }
                     else
                     {
-                        gdalBands[b]->RasterIO(GF_Read, (imgWidth-1), y, 1, 1, &pxlFloatVals[b], 1, 1, GDT_Float32, 0, 0);
+                        RSGISImageBlockCache::readRaster(gdalBands[b], (imgWidth-1), y, 1, 1, &pxlFloatVals[b], 1, 1, GDT_Float32, 0, 0);
                     }
                 }
                 this->calc->calcImageValue(pxlIntVals, numIntVals, pxlFloatVals, numfloatVals);
@@ -14529,6 +14806,360 @@ namespace rsgis{namespace img{
         }
     }
     
+    void RSGISCalcImage::calcBlockValues(RSGISCalcImageValue *blockCalc, float *inputData, double *outputData, size_t blockPxls, size_t numPxls, int numInBands, float *inDataColumn, double *outDataColumn, bool calcOutput)
+    {
+        // inputData and outputData are band-major with a stride of blockPxls between bands.
+        int numOutBands = this->numOutBands;
+        if(calcOutput && blockCalc->implementsCalcImageBlock())
+        {
+            std::vector<float*> inBandPtrs(numInBands);
+            for(int n = 0; n < numInBands; n++)
+            {
+                inBandPtrs[n] = &inputData[n*blockPxls];
+            }
+            std::vector<double*> outBandPtrs(numOutBands);
+            for(int n = 0; n < numOutBands; n++)
+            {
+                outBandPtrs[n] = &outputData[n*blockPxls];
+            }
+            blockCalc->calcImageBlock(inBandPtrs.data(), numInBands, numPxls, outBandPtrs.data());
+        }
+        else
+        {
+            for(size_t k = 0; k < numPxls; ++k)
+            {
+                for(int n = 0; n < numInBands; n++)
+                {
+                    inDataColumn[n] = inputData[(n*blockPxls)+k];
+                }
+                
+                if(calcOutput)
+                {
+                    blockCalc->calcImageValue(inDataColumn, numInBands, outDataColumn);
+                    
+                    for(int n = 0; n < numOutBands; n++)
+                    {
+                        outputData[(n*blockPxls)+k] = outDataColumn[n];
+                    }
+                }
+                else
+                {
+                    blockCalc->calcImageValue(inDataColumn, numInBands);
+                }
+            }
+        }
+    }
+    
+    void RSGISCalcImage::calcImagePipelined(GDALRasterBand **inputRasterBands, int **bandOffsets, int numInBands, GDALRasterBand **outputRasterBands, int width, int height, int yBlockSize)
+    {
+        bool calcOutput = (outputRasterBands != NULL) && (this->numOutBands > 0);
+        int numOutBands = this->numOutBands;
+        size_t blockPxls = ((size_t)width) * ((size_t)yBlockSize);
+        int nBlocks = (height + yBlockSize - 1) / yBlockSize;
+        
+        // The reader and writer threads only contend for a dataset
+        // if it is both an input and the output.
+        std::map<GDALDataset*, std::mutex> dsMutexes;
+        std::vector<std::mutex*> inBandMutexes;
+        for(int n = 0; n < numInBands; ++n)
+        {
+            inBandMutexes.push_back(&dsMutexes[inputRasterBands[n]->GetDataset()]);
+        }
+        std::vector<std::mutex*> outBandMutexes;
+        if(calcOutput)
+        {
+            for(int n = 0; n < numOutBands; ++n)
+            {
+                outBandMutexes.push_back(&dsMutexes[outputRasterBands[n]->GetDataset()]);
+            }
+        }
+        
+        // A ring of buffers where block i uses slot i % numSlots. Each slot moves
+        // from free -> read -> computed (-> written/free) and every stage handles
+        // the blocks in order, so the state alone identifies which block it holds.
+        enum PipelineSlotState {slotFree, slotRead, slotComputed};
+        const int numSlots = 3;
+        std::vector< std::vector<float> > slotInData(numSlots);
+        std::vector< std::vector<double> > slotOutData(numSlots);
+        std::vector<PipelineSlotState> slotStates(numSlots, slotFree);
+        for(int s = 0; s < numSlots; ++s)
+        {
+            slotInData[s].resize(blockPxls * numInBands);
+            if(calcOutput)
+            {
+                slotOutData[s].resize(blockPxls * numOutBands);
+            }
+        }
+        std::vector<float> inDataColumn(numInBands);
+        std::vector<double> outDataColumn(numOutBands);
+        
+        std::mutex pipeMutex;
+        std::condition_variable pipeCond;
+        bool pipeAbort = false;
+        std::exception_ptr pipeException = nullptr;
+        
+        auto waitForSlot = [&](int slot, PipelineSlotState state) -> bool
+        {
+            std::unique_lock<std::mutex> pipeLock(pipeMutex);
+            pipeCond.wait(pipeLock, [&]{return pipeAbort || (slotStates[slot] == state);});
+            return !pipeAbort;
+        };
+        auto setSlotState = [&](int slot, PipelineSlotState state)
+        {
+            {
+                std::lock_guard<std::mutex> pipeLock(pipeMutex);
+                slotStates[slot] = state;
+            }
+            pipeCond.notify_all();
+        };
+        auto abortPipeline = [&]()
+        {
+            {
+                std::lock_guard<std::mutex> pipeLock(pipeMutex);
+                if(!pipeException)
+                {
+                    pipeException = std::current_exception();
+                }
+                pipeAbort = true;
+            }
+            pipeCond.notify_all();
+        };
+        
+        std::thread readerThread([&]()
+        {
+            try
+            {
+                for(int i = 0; i < nBlocks; ++i)
+                {
+                    int slot = i % numSlots;
+                    if(!waitForSlot(slot, slotFree))
+                    {
+                        return;
+                    }
+                    int rowOffset = yBlockSize * i;
+                    int numRows = std::min(yBlockSize, height - rowOffset);
+                    float *inputData = slotInData[slot].data();
+                    for(int n = 0; n < numInBands; n++)
+                    {
+                        std::lock_guard<std::mutex> dsLock(*inBandMutexes[n]);
+                        if(RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], bandOffsets[n][1] + rowOffset, width, numRows, &inputData[n*blockPxls], width, numRows, GDT_Float32, 0, 0) != CE_None)
+                        {
+                            throw RSGISImageCalcException("Could not read image block from input image.");
+                        }
+                    }
+                    setSlotState(slot, slotRead);
+                }
+            }
+            catch(...)
+            {
+                abortPipeline();
+            }
+        });
+        
+        std::thread writerThread;
+        if(calcOutput)
+        {
+            writerThread = std::thread([&]()
+            {
+                try
+                {
+                    for(int i = 0; i < nBlocks; ++i)
+                    {
+                        int slot = i % numSlots;
+                        if(!waitForSlot(slot, slotComputed))
+                        {
+                            return;
+                        }
+                        int rowOffset = yBlockSize * i;
+                        int numRows = std::min(yBlockSize, height - rowOffset);
+                        double *outputData = slotOutData[slot].data();
+                        for(int n = 0; n < numOutBands; n++)
+                        {
+                            std::lock_guard<std::mutex> dsLock(*outBandMutexes[n]);
+                            if(outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, numRows, &outputData[n*blockPxls], width, numRows, GDT_Float64, 0, 0) != CE_None)
+                            {
+                                throw RSGISImageCalcException("Could not write image block to output image.");
+                            }
+                        }
+                        setSlotState(slot, slotFree);
+                    }
+                }
+                catch(...)
+                {
+                    abortPipeline();
+                }
+            });
+        }
+        
+        rsgis_tqdm pbar;
+        try
+        {
+            for(int i = 0; i < nBlocks; ++i)
+            {
+                int slot = i % numSlots;
+                if(!waitForSlot(slot, slotRead))
+                {
+                    break;
+                }
+                int rowOffset = yBlockSize * i;
+                int numRows = std::min(yBlockSize, height - rowOffset);
+                pbar.progress(rowOffset, height);
+                
+                size_t numPxls = ((size_t)width) * ((size_t)numRows);
+                this->calcBlockValues(this->calc, slotInData[slot].data(), slotOutData[slot].data(), blockPxls, numPxls, numInBands, inDataColumn.data(), outDataColumn.data(), calcOutput);
+                
+                setSlotState(slot, calcOutput?slotComputed:slotFree);
+            }
+        }
+        catch(...)
+        {
+            abortPipeline();
+        }
+        
+        readerThread.join();
+        if(writerThread.joinable())
+        {
+            writerThread.join();
+        }
+        
+        if(pipeException)
+        {
+            std::rethrow_exception(pipeException);
+        }
+        pbar.finish();
+    }
+    
+    bool RSGISCalcImage::calcImageParallel(GDALRasterBand **inputRasterBands, int **bandOffsets, int numInBands, GDALRasterBand **outputRasterBands, int width, int height, int yBlockSize)
+    {
+        // Each thread needs its own copy of the calculator; if the calculator
+        // doesn't support this then the image is processed on a single thread.
+        std::vector<RSGISCalcImageValue*> threadCalcs;
+        for(unsigned int t = 0; t < this->numThreads; ++t)
+        {
+            RSGISCalcImageValue *threadCalc = this->calc->clone();
+            if(threadCalc == NULL)
+            {
+                for(std::vector<RSGISCalcImageValue*>::iterator iterCalc = threadCalcs.begin(); iterCalc != threadCalcs.end(); ++iterCalc)
+                {
+                    delete (*iterCalc);
+                }
+                return false;
+            }
+            threadCalcs.push_back(threadCalc);
+        }
+        
+        bool calcOutput = (outputRasterBands != NULL) && (this->numOutBands > 0);
+        int numOutBands = this->numOutBands;
+        size_t blockPxls = ((size_t)width) * ((size_t)yBlockSize);
+        
+        // GDAL datasets are not thread safe so all reads and writes to
+        // a dataset are serialised using one mutex per dataset.
+        std::map<GDALDataset*, std::mutex> dsMutexes;
+        std::vector<std::mutex*> inBandMutexes;
+        for(int n = 0; n < numInBands; ++n)
+        {
+            inBandMutexes.push_back(&dsMutexes[inputRasterBands[n]->GetDataset()]);
+        }
+        std::vector<std::mutex*> outBandMutexes;
+        if(calcOutput)
+        {
+            for(int n = 0; n < numOutBands; ++n)
+            {
+                outBandMutexes.push_back(&dsMutexes[outputRasterBands[n]->GetDataset()]);
+            }
+        }
+        
+        // Buffers are allocated once per thread and reused for each block.
+        std::vector< std::vector<float> > threadInData(this->numThreads);
+        std::vector< std::vector<double> > threadOutData(this->numThreads);
+        std::vector< std::vector<float> > threadInColumn(this->numThreads);
+        std::vector< std::vector<double> > threadOutColumn(this->numThreads);
+        for(unsigned int t = 0; t < this->numThreads; ++t)
+        {
+            threadInData[t].resize(blockPxls * numInBands);
+            threadInColumn[t].resize(numInBands);
+            if(calcOutput)
+            {
+                threadOutData[t].resize(blockPxls * numOutBands);
+                threadOutColumn[t].resize(numOutBands);
+            }
+        }
+        
+        rsgis_tqdm pbar;
+        std::mutex pbarMutex;
+        int rowsProcessed = 0;
+        
+        try
+        {
+            rsgis::RSGISThreadPool threadPool(this->numThreads);
+            int nBlocks = (height + yBlockSize - 1) / yBlockSize;
+            for(int i = 0; i < nBlocks; ++i)
+            {
+                int rowOffset = yBlockSize * i;
+                int numRows = std::min(yBlockSize, height - rowOffset);
+                threadPool.submit([&, rowOffset, numRows](unsigned int threadIdx)
+                {
+                    float *inputData = threadInData[threadIdx].data();
+                    double *outputData = threadOutData[threadIdx].data();
+                    float *inDataColumn = threadInColumn[threadIdx].data();
+                    double *outDataColumn = threadOutColumn[threadIdx].data();
+                    RSGISCalcImageValue *threadCalc = threadCalcs[threadIdx];
+                    
+                    for(int n = 0; n < numInBands; n++)
+                    {
+                        std::lock_guard<std::mutex> dsLock(*inBandMutexes[n]);
+                        if(RSGISImageBlockCache::readRaster(inputRasterBands[n], bandOffsets[n][0], bandOffsets[n][1] + rowOffset, width, numRows, &inputData[n*blockPxls], width, numRows, GDT_Float32, 0, 0) != CE_None)
+                        {
+                            throw RSGISImageCalcException("Could not read image block from input image.");
+                        }
+                    }
+                    
+                    size_t numPxls = ((size_t)width) * ((size_t)numRows);
+                    this->calcBlockValues(threadCalc, inputData, outputData, blockPxls, numPxls, numInBands, inDataColumn, outDataColumn, calcOutput);
+                    
+                    if(calcOutput)
+                    {
+                        for(int n = 0; n < numOutBands; n++)
+                        {
+                            std::lock_guard<std::mutex> dsLock(*outBandMutexes[n]);
+                            if(outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, numRows, &outputData[n*blockPxls], width, numRows, GDT_Float64, 0, 0) != CE_None)
+                            {
+                                throw RSGISImageCalcException("Could not write image block to output image.");
+                            }
+                        }
+                    }
+                    
+                    std::lock_guard<std::mutex> pbarLock(pbarMutex);
+                    rowsProcessed += numRows;
+                    pbar.progress(rowsProcessed, height);
+                });
+            }
+            threadPool.wait();
+            pbar.finish();
+            
+            // Merge any state accumulated by the thread copies.
+            for(std::vector<RSGISCalcImageValue*>::iterator iterCalc = threadCalcs.begin(); iterCalc != threadCalcs.end(); ++iterCalc)
+            {
+                this->calc->reduce(*iterCalc);
+            }
+        }
+        catch(...)
+        {
+            for(std::vector<RSGISCalcImageValue*>::iterator iterCalc = threadCalcs.begin(); iterCalc != threadCalcs.end(); ++iterCalc)
+            {
+                delete (*iterCalc);
+            }
+            throw;
+        }
+        
+        for(std::vector<RSGISCalcImageValue*>::iterator iterCalc = threadCalcs.begin(); iterCalc != threadCalcs.end(); ++iterCalc)
+        {
+            delete (*iterCalc);
+        }
+        
+        return true;
+    }
+    
 	RSGISCalcImage::~RSGISCalcImage()
 	{
 		
@@ -14688,6 +15319,7 @@ namespace rsgis{namespace img{
             std::cout << "New image width = " << refPxlWidth << " height = " << refPxlHeight << " bands = " << numOutImgBands << std::endl;
             char **papszOptions = imgUtils.getGDALCreationOptionsForFormat(gdalFormat);
             GDALDataset *outputImageDS = gdalDriver->Create(outputImage.c_str(), refPxlWidth, refPxlHeight, numOutImgBands, gdalDataType, papszOptions);
+            RSGISImageBlockCache::invalidate(outputImage);
             
             if(outputImageDS == NULL)
             {
@@ -14762,7 +15394,7 @@ namespace rsgis{namespace img{
                     pbar.progress(blockCounter, nBlocks);
                     
                     // Read Block
-                    if(statsBand->RasterIO(GF_Read, colOffsetStats, rowOffsetStats, xIOGridStats, yIOGridStats, statsDataArr, xIOGridStats, yIOGridStats, GDT_Float32, 0, 0))
+                    if(RSGISImageBlockCache::readRaster(statsBand, colOffsetStats, rowOffsetStats, xIOGridStats, yIOGridStats, statsDataArr, xIOGridStats, yIOGridStats, GDT_Float32, 0, 0))
                     {
                         throw RSGISImageException("Failed to read image data from stats band.");
                     }
@@ -14812,7 +15444,7 @@ namespace rsgis{namespace img{
                     pbar.progress(blockCounter, nBlocks);
                     
                     // Read Block
-                    if(statsBand->RasterIO(GF_Read, colOffsetStats, rowOffsetStats, remainColsStats, yIOGridStats, statsDataArr, remainColsStats, yIOGridStats, GDT_Float32, 0, 0))
+                    if(RSGISImageBlockCache::readRaster(statsBand, colOffsetStats, rowOffsetStats, remainColsStats, yIOGridStats, statsDataArr, remainColsStats, yIOGridStats, GDT_Float32, 0, 0))
                     {
                         throw RSGISImageException("Failed to read image data from stats band.");
                     }
@@ -14870,7 +15502,7 @@ namespace rsgis{namespace img{
                     pbar.progress(blockCounter, nBlocks);
                     
                     // Read Block
-                    if(statsBand->RasterIO(GF_Read, colOffsetStats, rowOffsetStats, xIOGridStats, remainRowsStats, statsDataArr, xIOGridStats, remainRowsStats, GDT_Float32, 0, 0))
+                    if(RSGISImageBlockCache::readRaster(statsBand, colOffsetStats, rowOffsetStats, xIOGridStats, remainRowsStats, statsDataArr, xIOGridStats, remainRowsStats, GDT_Float32, 0, 0))
                     {
                         throw RSGISImageException("Failed to read image data from stats band.");
                     }
@@ -14920,7 +15552,7 @@ namespace rsgis{namespace img{
                     pbar.progress(blockCounter, nBlocks);
                     
                     // Read Block
-                    if(statsBand->RasterIO(GF_Read, colOffsetStats, rowOffsetStats, remainColsStats, remainRowsStats, statsDataArr, remainColsStats, remainRowsStats, GDT_Float32, 0, 0))
+                    if(RSGISImageBlockCache::readRaster(statsBand, colOffsetStats, rowOffsetStats, remainColsStats, remainRowsStats, statsDataArr, remainColsStats, remainRowsStats, GDT_Float32, 0, 0))
                     {
                         throw RSGISImageException("Failed to read image data from stats band.");
                     }
@@ -25,6 +25,14 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <algorithm>
 
 #include "gdal_priv.h"
 
@@ -38,11 +46,14 @@
 #include "geos/geom/PrecisionModel.h"
 
 #include "common/rsgis-tqdm.h"
+#include "common/RSGISThreadPool.h"
 
 #include "img/RSGISPixelInPoly.h"
+#include "img/RSGISPolygonScanline.h"
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISImageUtils.h"
+#include "img/RSGISImageBlockCache.h"
 
 #include "math/RSGISMathsUtils.h"
 
@@ -96,12 +107,35 @@ namespace rsgis
                 void calcImageWithinPolygonExtentInMem(GDALDataset **datasets, int numDS, geos::geom::Envelope *env, geos::geom::Polygon *poly, pixelInPolyOption pixelPolyOption);
 				void calcImageWithinRasterPolygon(GDALDataset **datasets, int numDS, geos::geom::Envelope *env, long fid);
                 void calcImageBorderPixels(GDALDataset *dataset, bool returnInt);
+                /**
+                 * Set the number of threads used to process image blocks (0 = number of cores).
+                 * Only used where the RSGISCalcImageValue implements clone(), otherwise
+                 * processing falls back to a single thread. Default taken from RSGISThreadPool.
+                 */
+                void setNumThreads(unsigned int numThreads);
+                unsigned int getNumThreads();
+                /**
+                 * When processing on a single thread, read the next block and write the
+                 * previous block on separate threads while the current block is computed,
+                 * so I/O latency overlaps with the calculation. Default taken from
+                 * setDefaultPipelinedIO (false unless changed).
+                 */
+                void setPipelinedIO(bool pipelinedIO);
+                bool getPipelinedIO();
+                static void setDefaultPipelinedIO(bool pipelinedIO);
+                static bool getDefaultPipelinedIO();
                 virtual ~RSGISCalcImage();
 			private:
+                bool calcImageParallel(GDALRasterBand **inputRasterBands, int **bandOffsets, int numInBands, GDALRasterBand **outputRasterBands, int width, int height, int yBlockSize);
+                void calcImagePipelined(GDALRasterBand **inputRasterBands, int **bandOffsets, int numInBands, GDALRasterBand **outputRasterBands, int width, int height, int yBlockSize);
+                void calcBlockValues(RSGISCalcImageValue *blockCalc, float *inputData, double *outputData, size_t blockPxls, size_t numPxls, int numInBands, float *inDataColumn, double *outDataColumn, bool calcOutput);
 				RSGISCalcImageValue *calc;
 				int numOutBands;
 				std::string proj;
 				bool useImageProj;
+                unsigned int numThreads;
+                bool pipelinedIO;
+                static std::atomic<bool> defaultPipelinedIO;
 			};
         
         
@@ -633,6 +633,11 @@ namespace rsgis{namespace img{
 			}
 			inDataColumnA = new float[numInBands];
 			
+			// Rasterise the polygon row by row rather than testing each pixel (if supported by the method).
+			bool useScanline = RSGISPolygonScanline::isOptionSupported(pixelPolyOption);
+			RSGISPolygonScanline scanline(poly, pxlTLX, pxlTLY, pxlWidth, pxlHeight, width, height);
+			std::vector<RSGISPixelSpan> rowSpans;
+			
 			int feedback = height/10;
 			if (feedback == 0) {feedback = 1;} // Set feedback to 1
 			int feedbackCounter = 0;
@@ -652,6 +657,41 @@ namespace rsgis{namespace img{
 					}
 				}
 				
+				if(useScanline)
+				{
+					scanline.findRowSpans(i, pixelPolyOption, &rowSpans);
+					if(!rowSpans.empty())
+					{
+						// Only read the part of the row covered by the spans.
+						int startCol = rowSpans.front().startCol;
+						int spanWidth = rowSpans.back().endCol - startCol;
+						for(int n = 0; n < numInBands; n++)
+						{
+							inputRasterBandsA[n]->RasterIO(GF_Read, (bandOffsetsA[n][0]+startCol), (bandOffsetsA[n][1]+i), spanWidth, 1, inputDataA[n], spanWidth, 1, GDT_Float32, 0, 0);
+						}
+						double pxlCentreY = gdalTranslation[3] - ((i + 0.5) * pxlHeight);
+						for(std::vector<RSGISPixelSpan>::iterator iterSpan = rowSpans.begin(); iterSpan != rowSpans.end(); ++iterSpan)
+						{
+							for(int j = (*iterSpan).startCol; j < (*iterSpan).endCol; j++)
+							{
+								for(int n = 0; n < numInBands; n++)
+								{
+									inDataColumnA[n] = inputDataA[n][j-startCol];
+								}
+								double interceptArea = 1;
+								if(pixelPolyOption == pixelAreaInPoly)
+								{
+									interceptArea = scanline.getAreaFraction(j);
+								}
+								geos::geom::Point *pt = geomFactory->createPoint(geos::geom::Coordinate(gdalTranslation[0] + ((j + 0.5) * pxlWidth), pxlCentreY));
+								this->valueCalc->calcImageValue(inDataColumnA, interceptArea, numInBands, poly, pt);
+								delete pt;
+							}
+						}
+					}
+					continue;
+				}
+				
 				for(int n = 0; n < numInBands; n++)
 				{
 					inputRasterBandsA[n]->RasterIO(GF_Read, bandOffsetsA[n][0], (bandOffsetsA[n][1]+i), width, 1, inputDataA[n], width, 1, GDT_Float32, 0, 0);
@@ -44,6 +44,7 @@
 #include "img/RSGISCalcImageSingleValue.h"
 #include "img/RSGISImageUtils.h"
 #include "img/RSGISPixelInPoly.h"
+#include "img/RSGISPolygonScanline.h"
 
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
@@ -0,0 +1,251 @@
+/*
+ *  RSGISCalcImageTyped.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISCalcImageTyped_H
+#define RSGISCalcImageTyped_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "gdal_priv.h"
+
+#include "common/rsgis-tqdm.h"
+
+#include "img/RSGISImageCalcException.h"
+#include "img/RSGISImageBandException.h"
+#include "img/RSGISImageUtils.h"
+
+namespace rsgis{namespace img{
+
+    /**
+     * Maps a C++ pixel type to the GDAL data type used for RasterIO.
+     */
+    template <typename T> struct RSGISGDALDataTypeOf;
+    template <> struct RSGISGDALDataTypeOf<unsigned char> { static GDALDataType type(){return GDT_Byte;} };
+    template <> struct RSGISGDALDataTypeOf<unsigned short> { static GDALDataType type(){return GDT_UInt16;} };
+    template <> struct RSGISGDALDataTypeOf<short> { static GDALDataType type(){return GDT_Int16;} };
+    template <> struct RSGISGDALDataTypeOf<unsigned int> { static GDALDataType type(){return GDT_UInt32;} };
+    template <> struct RSGISGDALDataTypeOf<int> { static GDALDataType type(){return GDT_Int32;} };
+    template <> struct RSGISGDALDataTypeOf<float> { static GDALDataType type(){return GDT_Float32;} };
+    template <> struct RSGISGDALDataTypeOf<double> { static GDALDataType type(){return GDT_Float64;} };
+
+    /**
+     * Base class for calculations run by RSGISCalcImageTyped. Unlike RSGISCalcImageValue
+     * the pixel values are passed in the input (InT) and output (OutT) types, so
+     * integer images (e.g., clumps) are never converted through floating point.
+     * Values are band-major: bandValues[band][pxl] and output[outBand][pxl].
+     */
+    template <typename InT, typename OutT>
+    class RSGISCalcImageTypedValue
+    {
+    public:
+        RSGISCalcImageTypedValue(int numOutBands){this->numOutBands = numOutBands;};
+        int getNumOutBands(){return this->numOutBands;};
+        virtual void calcImageBlock(InT **bandValues, int numBands, unsigned long nPxls, OutT **output) {throw RSGISImageCalcException("Not Implemented - RSGISCalcImageTypedValue Base Class");};
+        virtual void calcImageBlock(InT **bandValues, int numBands, unsigned long nPxls) {throw RSGISImageCalcException("Not Implemented - RSGISCalcImageTypedValue Base Class");};
+        virtual ~RSGISCalcImageTypedValue(){};
+    protected:
+        int numOutBands;
+    };
+
+    /**
+     * Applies a RSGISCalcImageTypedValue to a set of images, reading and writing
+     * the data in blocks of rows using the native InT and OutT types. The number
+     * of bytes moved through RasterIO is recorded so the cost per pixel can be
+     * compared with the float32 in / float64 out path of RSGISCalcImage.
+     */
+    template <typename InT, typename OutT>
+    class RSGISCalcImageTyped
+    {
+    public:
+        RSGISCalcImageTyped(RSGISCalcImageTypedValue<InT, OutT> *valueCalc)
+        {
+            this->calc = valueCalc;
+            this->numOutBands = valueCalc->getNumOutBands();
+            this->resetIOCounters();
+        };
+        void calcImage(GDALDataset **datasets, int numDS, GDALDataset *outputImageDS)
+        {
+            if(outputImageDS == NULL)
+            {
+                throw RSGISImageCalcException("The output dataset is NULL.");
+            }
+            this->processImage(datasets, numDS, outputImageDS);
+        };
+        void calcImage(GDALDataset **datasets, int numDS)
+        {
+            this->processImage(datasets, numDS, NULL);
+        };
+        unsigned long long getBytesRead(){return this->bytesRead;};
+        unsigned long long getBytesWritten(){return this->bytesWritten;};
+        unsigned long long getNumPxlsProcessed(){return this->numPxls;};
+        /** The number of bytes read plus written through RasterIO per pixel processed. */
+        double getBytesPerPxl()
+        {
+            if(this->numPxls == 0)
+            {
+                return 0.0;
+            }
+            return ((double)(this->bytesRead + this->bytesWritten)) / ((double)this->numPxls);
+        };
+        void resetIOCounters()
+        {
+            this->bytesRead = 0;
+            this->bytesWritten = 0;
+            this->numPxls = 0;
+        };
+        ~RSGISCalcImageTyped(){};
+    protected:
+        void processImage(GDALDataset **datasets, int numDS, GDALDataset *outputImageDS)
+        {
+            GDALAllRegister();
+            RSGISImageUtils imgUtils;
+            double gdalTranslation[6];
+            std::vector<int> dsOffsetsMem(numDS*2, 0);
+            std::vector<int*> dsOffsets(numDS);
+            for(int i = 0; i < numDS; i++)
+            {
+                dsOffsets[i] = &dsOffsetsMem[i*2];
+            }
+            int width = 0;
+            int height = 0;
+            int xBlockSize = 0;
+            int yBlockSize = 0;
+
+            try
+            {
+                imgUtils.getImageOverlap(datasets, numDS, dsOffsets.data(), &width, &height, gdalTranslation, &xBlockSize, &yBlockSize);
+            }
+            catch(RSGISImageBandException &e)
+            {
+                throw RSGISImageCalcException(e.what());
+            }
+
+            std::vector<GDALRasterBand*> inputRasterBands;
+            std::vector<int> bandXOffs;
+            std::vector<int> bandYOffs;
+            for(int i = 0; i < numDS; i++)
+            {
+                for(int j = 0; j < datasets[i]->GetRasterCount(); j++)
+                {
+                    inputRasterBands.push_back(datasets[i]->GetRasterBand(j+1));
+                    bandXOffs.push_back(dsOffsets[i][0]);
+                    bandYOffs.push_back(dsOffsets[i][1]);
+                }
+            }
+            int numInBands = inputRasterBands.size();
+
+            std::vector<GDALRasterBand*> outputRasterBands;
+            if(outputImageDS != NULL)
+            {
+                if((outputImageDS->GetRasterXSize() != width) || (outputImageDS->GetRasterYSize() != height))
+                {
+                    throw RSGISImageCalcException("The output dataset does not have the same size as the input image overlap.");
+                }
+                if(outputImageDS->GetRasterCount() != this->numOutBands)
+                {
+                    throw RSGISImageCalcException("The output dataset does not have the correct number of image bands.");
+                }
+                for(int i = 0; i < this->numOutBands; i++)
+                {
+                    outputRasterBands.push_back(outputImageDS->GetRasterBand(i+1));
+                }
+                int outXBlockSize = 0;
+                int outYBlockSize = 0;
+                outputRasterBands[0]->GetBlockSize(&outXBlockSize, &outYBlockSize);
+                if(outYBlockSize > yBlockSize)
+                {
+                    yBlockSize = outYBlockSize;
+                }
+            }
+            if(yBlockSize < 1)
+            {
+                yBlockSize = 1;
+            }
+
+            GDALDataType inGDALType = RSGISGDALDataTypeOf<InT>::type();
+            GDALDataType outGDALType = RSGISGDALDataTypeOf<OutT>::type();
+            size_t blockPxls = ((size_t)width) * ((size_t)yBlockSize);
+
+            std::vector<InT> inputData(blockPxls * numInBands);
+            std::vector<InT*> inputBandPtrs(numInBands);
+            for(int n = 0; n < numInBands; n++)
+            {
+                inputBandPtrs[n] = &inputData[n*blockPxls];
+            }
+            std::vector<OutT> outputData(blockPxls * outputRasterBands.size());
+            std::vector<OutT*> outputBandPtrs(outputRasterBands.size());
+            for(size_t n = 0; n < outputRasterBands.size(); n++)
+            {
+                outputBandPtrs[n] = &outputData[n*blockPxls];
+            }
+
+            rsgis_tqdm pbar;
+            for(int rowOffset = 0; rowOffset < height; rowOffset += yBlockSize)
+            {
+                pbar.progress(rowOffset, height);
+                int numRows = std::min(yBlockSize, height - rowOffset);
+                unsigned long nBlockPxls = ((unsigned long)width) * ((unsigned long)numRows);
+
+                for(int n = 0; n < numInBands; n++)
+                {
+                    if(inputRasterBands[n]->RasterIO(GF_Read, bandXOffs[n], bandYOffs[n]+rowOffset, width, numRows, inputBandPtrs[n], width, numRows, inGDALType, 0, 0) != CE_None)
+                    {
+                        throw RSGISImageCalcException("Could not read image block from input image.");
+                    }
+                }
+                this->bytesRead += ((unsigned long long)nBlockPxls) * numInBands * sizeof(InT);
+
+                if(outputImageDS != NULL)
+                {
+                    this->calc->calcImageBlock(inputBandPtrs.data(), numInBands, nBlockPxls, outputBandPtrs.data());
+
+                    for(size_t n = 0; n < outputRasterBands.size(); n++)
+                    {
+                        if(outputRasterBands[n]->RasterIO(GF_Write, 0, rowOffset, width, numRows, outputBandPtrs[n], width, numRows, outGDALType, 0, 0) != CE_None)
+                        {
+                            throw RSGISImageCalcException("Could not write image block to output image.");
+                        }
+                    }
+                    this->bytesWritten += ((unsigned long long)nBlockPxls) * outputRasterBands.size() * sizeof(OutT);
+                }
+                else
+                {
+                    this->calc->calcImageBlock(inputBandPtrs.data(), numInBands, nBlockPxls);
+                }
+                this->numPxls += nBlockPxls;
+            }
+            pbar.finish();
+        };
+
+        RSGISCalcImageTypedValue<InT, OutT> *calc;
+        int numOutBands;
+        unsigned long long bytesRead;
+        unsigned long long bytesWritten;
+        unsigned long long numPxls;
+    };
+
+}}
+
+#endif
@@ -64,6 +64,26 @@ namespace rsgis{namespace img{
              */
             virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw RSGISImageCalcException("Not Implemented - RSGISCalcImageValue Base Class");};
             virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("Not Implemented - RSGISCalcImageValue Base Class");};
+            /**
+             * Calculate the output values for a block of nPxls pixels in a single call,
+             * avoiding a virtual call per pixel. The values are band-major, i.e.,
+             * bandValues[band][pxl] and output[outBand][pxl]. Only called by RSGISCalcImage
+             * when implementsCalcImageBlock() returns true.
+             */
+            virtual void calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output) {throw RSGISImageCalcException("Not Implemented - RSGISCalcImageValue Base Class");};
+            virtual bool implementsCalcImageBlock() {return false;};
+            /**
+             * Create a copy of this object to be used by a worker thread when
+             * RSGISCalcImage is processing blocks in parallel. Any accumulated
+             * state should be reset within the copy and merged back using reduce().
+             * Returns NULL if the object cannot be used in parallel (default).
+             */
+            virtual RSGISCalcImageValue* clone() {return NULL;};
+            /**
+             * Merge the state accumulated by a thread copy (created by clone())
+             * into this object once all the image blocks have been processed.
+             */
+            virtual void reduce(RSGISCalcImageValue *threadCalc) {};
             virtual int getNumOutBands();
             virtual void setNumOutBands(int bands);
             virtual ~RSGISCalcImageValue(){};
@@ -94,6 +94,149 @@ namespace rsgis{namespace img{
 		
 		GDALClose(outputImageDS);
 	}
+
+	void RSGISCreateTestImages::fillRandomImage(GDALDataset *dataset, unsigned int seed, double minVal, double maxVal)
+	{
+		if(maxVal <= minVal)
+		{
+			throw RSGISImageException("The maximum value must be greater than the minimum value.");
+		}
+		int width = dataset->GetRasterXSize();
+		int height = dataset->GetRasterYSize();
+		std::vector<double> rowData(width);
+		double range = maxVal - minVal;
+		for(int n = 0; n < dataset->GetRasterCount(); ++n)
+		{
+			std::mt19937 randGen(seed + n);
+			GDALRasterBand *imgBand = dataset->GetRasterBand(n+1);
+			for(int i = 0; i < height; ++i)
+			{
+				for(int j = 0; j < width; ++j)
+				{
+					rowData[j] = minVal + ((randGen() / 4294967296.0) * range);
+				}
+				if(imgBand->RasterIO(GF_Write, 0, i, width, 1, &rowData[0], width, 1, GDT_Float64, 0, 0) != CE_None)
+				{
+					throw RSGISImageException("Could not write to the image.");
+				}
+			}
+		}
+	}
+
+	void RSGISCreateTestImages::fillRegionsImage(GDALDataset *dataset, unsigned int regionSize, unsigned int numClasses, unsigned int seed)
+	{
+		if((regionSize == 0) | (numClasses == 0))
+		{
+			throw RSGISImageException("The region size and number of classes must be greater than zero.");
+		}
+		int width = dataset->GetRasterXSize();
+		int height = dataset->GetRasterYSize();
+		unsigned int numXCells = ((width - 1) / regionSize) + 1;
+		std::vector<unsigned int> cellClasses(numXCells);
+		std::vector<unsigned int> rowData(width);
+		std::mt19937 randGen(seed);
+		GDALRasterBand *imgBand = dataset->GetRasterBand(1);
+		for(int i = 0; i < height; ++i)
+		{
+			if((i % regionSize) == 0)
+			{
+				for(unsigned int c = 0; c < numXCells; ++c)
+				{
+					cellClasses[c] = (randGen() % numClasses) + 1;
+				}
+			}
+			for(int j = 0; j < width; ++j)
+			{
+				rowData[j] = cellClasses[j / regionSize];
+			}
+			if(imgBand->RasterIO(GF_Write, 0, i, width, 1, &rowData[0], width, 1, GDT_UInt32, 0, 0) != CE_None)
+			{
+				throw RSGISImageException("Could not write to the image.");
+			}
+		}
+	}
+
+	void RSGISCreateTestImages::createGridPolygons(GDALDataset *image, std::string outputVec, std::string vecLayerName, std::string vecFormat, unsigned int numXCells, unsigned int numYCells)
+	{
+		if((numXCells == 0) | (numYCells == 0))
+		{
+			throw RSGISImageException("The number of cells must be greater than zero.");
+		}
+		double trans[6];
+		image->GetGeoTransform(trans);
+		double tlX = trans[0];
+		double tlY = trans[3];
+		double cellWidth = (image->GetRasterXSize() * trans[1]) / numXCells;
+		double cellHeight = (image->GetRasterYSize() * trans[5]) / numYCells;
+
+		GDALAllRegister();
+		GDALDriver *vecDriver = GetGDALDriverManager()->GetDriverByName(vecFormat.c_str());
+		if(vecDriver == NULL)
+		{
+			throw RSGISImageException("Vector driver (" + vecFormat + ") is not available.");
+		}
+		GDALDataset *vecDS = vecDriver->Create(outputVec.c_str(), 0, 0, 0, GDT_Unknown, NULL);
+		if(vecDS == NULL)
+		{
+			throw RSGISImageException("Could not create vector file " + outputVec);
+		}
+		OGRSpatialReference *spatialRef = NULL;
+		std::string wktProj = std::string(image->GetProjectionRef());
+		if(wktProj != "")
+		{
+			spatialRef = new OGRSpatialReference(wktProj.c_str());
+		}
+		OGRLayer *vecLayer = vecDS->CreateLayer(vecLayerName.c_str(), spatialRef, wkbPolygon, NULL);
+		if(spatialRef != NULL)
+		{
+			spatialRef->Release();
+		}
+		if(vecLayer == NULL)
+		{
+			GDALClose(vecDS);
+			throw RSGISImageException("Could not create vector layer " + vecLayerName);
+		}
+		OGRFieldDefn idField("id", OFTInteger);
+		if(vecLayer->CreateField(&idField) != OGRERR_NONE)
+		{
+			GDALClose(vecDS);
+			throw RSGISImageException("Could not create the 'id' field.");
+		}
+
+		vecLayer->StartTransaction();
+		int id = 1;
+		for(unsigned int y = 0; y < numYCells; ++y)
+		{
+			for(unsigned int x = 0; x < numXCells; ++x)
+			{
+				double minX = tlX + (x * cellWidth);
+				double maxX = tlX + ((x+1) * cellWidth);
+				double minY = tlY + (y * cellHeight);
+				double maxY = tlY + ((y+1) * cellHeight);
+				OGRLinearRing ring;
+				ring.addPoint(minX, minY);
+				ring.addPoint(maxX, minY);
+				ring.addPoint(maxX, maxY);
+				ring.addPoint(minX, maxY);
+				ring.addPoint(minX, minY);
+				OGRPolygon poly;
+				poly.addRing(&ring);
+
+				OGRFeature *feature = OGRFeature::CreateFeature(vecLayer->GetLayerDefn());
+				feature->SetField("id", id++);
+				feature->SetGeometry(&poly);
+				if(vecLayer->CreateFeature(feature) != OGRERR_NONE)
+				{
+					OGRFeature::DestroyFeature(feature);
+					GDALClose(vecDS);
+					throw RSGISImageException("Could not write a polygon to the vector layer.");
+				}
+				OGRFeature::DestroyFeature(feature);
+			}
+		}
+		vecLayer->CommitTransaction();
+		GDALClose(vecDS);
+	}
 			
 	RSGISCreateTestImages::~RSGISCreateTestImages()
 	{
@@ -25,10 +25,13 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <random>
 
 #include "common/RSGISImageException.h"
 
 #include "gdal_priv.h"
+#include "ogrsf_frmts.h"
 
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
@@ -45,11 +48,25 @@
 
 namespace rsgis{namespace img{
 	
+	/**
+	 * Creates synthetic images and vectors (e.g., for tests and benchmarks). The
+	 * generators are seeded and use the raw output of std::mt19937, so the same
+	 * seed gives the same data on every platform.
+	 */
 	class DllExport RSGISCreateTestImages
 		{
 		public:
 			RSGISCreateTestImages();
 			void createRowMajorNumberedImage(std::string outputImage, int width, int height);
+			/** Fill all the bands of an existing dataset with uniform random values in [minVal, maxVal). */
+			void fillRandomImage(GDALDataset *dataset, unsigned int seed, double minVal, double maxVal);
+			/**
+			 * Fill band 1 of an existing dataset with a class (1 to numClasses) for each regionSize x regionSize
+			 * cell. Neighbouring cells with the same class join, giving irregular clumps of different sizes.
+			 */
+			void fillRegionsImage(GDALDataset *dataset, unsigned int regionSize, unsigned int numClasses, unsigned int seed);
+			/** Create a vector layer of numXCells x numYCells rectangular polygons (with an 'id' field) covering the extent of the image. */
+			void createGridPolygons(GDALDataset *image, std::string outputVec, std::string vecLayerName, std::string vecFormat, unsigned int numXCells, unsigned int numYCells);
 			~RSGISCreateTestImages();
 		};
 }}
@@ -32,7 +32,7 @@ namespace rsgis{namespace img{
         
     }
     
-    void RSGISExtractImageValues::extractDataWithinMask2HDF(GDALDataset *mask, GDALDataset *image, std::string outHDFFile, float maskValue, RSGISLibDataType dataType)
+    void RSGISExtractImageValues::extractDataWithinMask2HDF(GDALDataset *mask, GDALDataset *image, std::string outHDFFile, float maskValue, RSGISLibDataType dataType, unsigned int nSamples, int seed, bool compress)
     {
         try
         {
@@ -41,41 +41,28 @@ namespace rsgis{namespace img{
                 throw RSGISImageException("Image mask must only have 1 image band.");
             }
             unsigned int numImageBands = image->GetRasterCount();
+            std::vector<unsigned int> imgBands;
+            for(unsigned int i = 0; i < numImageBands; ++i)
+            {
+                imgBands.push_back(i+1);
+            }
             
+            rsgis::utils::RSGISExportColumnData2HDF exportCols2HDF;
+            H5::DataType h5DataType = exportCols2HDF.getH5DataType(dataType);
+            exportCols2HDF.createFile(outHDFFile, numImageBands, std::string("Pixels Extracted from ")+std::string(image->GetFileList()[0]), h5DataType, HDF5_EXTRACT_CHUNK_ROWS, compress);
             
-            std::vector<float*> *pxlVals = new std::vector<float*>();
-            
-            RSGISExtractImageValuesWithMask *extractData = new RSGISExtractImageValuesWithMask(pxlVals, maskValue);
-            RSGISCalcImage calcImg = RSGISCalcImage(extractData, "", true);
+            RSGISExtractMaskedPxlVals2HDF extractData = RSGISExtractMaskedPxlVals2HDF(&exportCols2HDF, imgBands, maskValue, nSamples, seed);
+            RSGISCalcImage calcImg = RSGISCalcImage(&extractData, "", true);
             
             GDALDataset **datasets = new GDALDataset*[2];
 			datasets[0] = mask;
 			datasets[1] = image;
             
             calcImg.calcImage(datasets, 2);
+            extractData.flush();
             
             delete[] datasets;
-            
-            rsgis::utils::RSGISExportColumnData2HDF exportCols2HDF;
-            H5::DataType h5DataType = exportCols2HDF.getH5DataType(dataType);
-            exportCols2HDF.createFile(outHDFFile, numImageBands, std::string("Pixels Extracted from ")+std::string(image->GetFileList()[0]), h5DataType);
-            float *row = new float[numImageBands];
-            for(unsigned int j = 0; j < pxlVals->size(); ++j)
-            {
-                for(unsigned int i = 0; i < numImageBands; ++i)
-                {
-                    row[i] = pxlVals->at(j)[i];
-                }
-                exportCols2HDF.addDataRow(row, H5::PredType::NATIVE_FLOAT);
-            }
             exportCols2HDF.close();
-            delete[] row;
-            
-            for(std::vector<float*>::iterator iterVals = pxlVals->begin(); iterVals != pxlVals->end(); ++iterVals)
-            {
-                delete[] *iterVals;
-            }
-            delete pxlVals;
         }
         catch (RSGISImageException &e)
         {
@@ -91,7 +78,7 @@ namespace rsgis{namespace img{
         }
     }
     
-    void RSGISExtractImageValues::extractImgBandDataWithinMask2HDF(std::vector<std::pair<std::string, std::vector<unsigned int> > > imageFiles, std::string maskImage, std::string outHDFFile, float maskValue, RSGISLibDataType dataType)
+    void RSGISExtractImageValues::extractImgBandDataWithinMask2HDF(std::vector<std::pair<std::string, std::vector<unsigned int> > > imageFiles, std::string maskImage, std::string outHDFFile, float maskValue, RSGISLibDataType dataType, unsigned int nSamples, int seed, bool compress)
     {
         try
         {
@@ -140,13 +127,17 @@ namespace rsgis{namespace img{
                 cImgBandCount += datasets[i+1]->GetRasterCount();
             }
             
-            std::vector<float*> *pxlVals = new std::vector<float*>();
             unsigned int numOutImgBands = imgBands.size();
             
-            RSGISExtractImageBandValuesWithMask extractData = RSGISExtractImageBandValuesWithMask(pxlVals, imgBands, maskValue);
+            rsgis::utils::RSGISExportColumnData2HDF exportCols2HDF;
+            H5::DataType h5DataType = exportCols2HDF.getH5DataType(dataType);
+            exportCols2HDF.createFile(outHDFFile, numOutImgBands, std::string("Pixels Extracted"), h5DataType, HDF5_EXTRACT_CHUNK_ROWS, compress);
+            
+            RSGISExtractMaskedPxlVals2HDF extractData = RSGISExtractMaskedPxlVals2HDF(&exportCols2HDF, imgBands, maskValue, nSamples, seed);
             RSGISCalcImage calcImg = RSGISCalcImage(&extractData, "", true);
             calcImg.calcImage(datasets, imageFiles.size()+1);
-            
+            extractData.flush();
+            exportCols2HDF.close();
             
             for(unsigned int i = 0; i < (imageFiles.size()+1); ++i)
             {
@@ -154,27 +145,6 @@ namespace rsgis{namespace img{
             }
             delete[] datasets;
             
-            rsgis::utils::RSGISExportColumnData2HDF exportCols2HDF;
-            H5::DataType h5DataType = exportCols2HDF.getH5DataType(dataType);
-            exportCols2HDF.createFile(outHDFFile, numOutImgBands, std::string("Pixels Extracted"), h5DataType);
-            float *row = new float[numOutImgBands];
-            for(unsigned int j = 0; j < pxlVals->size(); ++j)
-            {
-                for(unsigned int i = 0; i < numOutImgBands; ++i)
-                {
-                    row[i] = pxlVals->at(j)[i];
-                }
-                exportCols2HDF.addDataRow(row, H5::PredType::NATIVE_FLOAT);
-            }
-            exportCols2HDF.close();
-            delete[] row;
-            
-            for(std::vector<float*>::iterator iterVals = pxlVals->begin(); iterVals != pxlVals->end(); ++iterVals)
-            {
-                delete[] *iterVals;
-            }
-            delete pxlVals;
-            
         }
         catch (RSGISImageException &e)
         {
@@ -420,58 +390,82 @@ namespace rsgis{namespace img{
     
     
 	
-    RSGISExtractImageValuesWithMask::RSGISExtractImageValuesWithMask(std::vector<float*> *pxlVals, float maskValue): RSGISCalcImageValue(0)
+    RSGISExtractMaskedPxlVals2HDF::RSGISExtractMaskedPxlVals2HDF(rsgis::utils::RSGISExportColumnData2HDF *exportCols2HDF, std::vector<unsigned int> imgBands, float maskValue, unsigned int nSamples, int seed, unsigned int batchRows): RSGISCalcImageValue(0)
     {
-        this->pxlVals = pxlVals;
+        this->exportCols2HDF = exportCols2HDF;
+        this->imgBands = imgBands;
+        this->numOutVals = this->imgBands.size();
         this->maskValue = maskValue;
+        this->nSamples = nSamples;
+        this->batchRows = (batchRows > 0)?batchRows:1;
+        this->numPxlsInMask = 0;
+        this->numBufRows = 0;
+        if(this->nSamples == 0)
+        {
+            this->rowsBuffer.resize(((size_t)this->batchRows) * this->numOutVals);
+        }
+        this->randomGen.seed(seed);
     }
     
-    void RSGISExtractImageValuesWithMask::calcImageValue(float *bandValues, int numBands) 
+    void RSGISExtractMaskedPxlVals2HDF::calcImageValue(float *bandValues, int numBands)
     {
-        if(bandValues[0] == maskValue)
+        if(bandValues[0] != maskValue)
+        {
+            return;
+        }
+        ++this->numPxlsInMask;
+        
+        float *row = NULL;
+        if(this->nSamples == 0)
+        {
+            row = &this->rowsBuffer[((size_t)this->numBufRows) * this->numOutVals];
+            ++this->numBufRows;
+        }
+        else if(this->numPxlsInMask <= this->nSamples)
+        {
+            // Fill the reservoir.
+            this->rowsBuffer.resize(((size_t)this->numPxlsInMask) * this->numOutVals);
+            row = &this->rowsBuffer[((size_t)this->numBufRows) * this->numOutVals];
+            ++this->numBufRows;
+        }
+        else
         {
-            float *data = new float[numBands-1];
-            for(unsigned i = 1; i < numBands; ++i)
+            // Replace a sampled pixel with probability nSamples/numPxlsInMask.
+            boost::uniform_int<unsigned long long> randomDist(0, this->numPxlsInMask-1);
+            unsigned long long idx = randomDist(this->randomGen);
+            if(idx >= this->nSamples)
             {
-                data[i-1] = bandValues[i];
+                return;
             }
-            pxlVals->push_back(data);
+            row = &this->rowsBuffer[((size_t)idx) * this->numOutVals];
         }
-    }
-    
-    RSGISExtractImageValuesWithMask::~RSGISExtractImageValuesWithMask()
-    {
         
+        for(unsigned int i = 0; i < this->numOutVals; ++i)
+        {
+            row[i] = bandValues[this->imgBands[i]];
+        }
+        
+        if((this->nSamples == 0) && (this->numBufRows == this->batchRows))
+        {
+            this->flush();
+        }
     }
     
-    
-    
-    
-    
-    
-    
-    RSGISExtractImageBandValuesWithMask::RSGISExtractImageBandValuesWithMask(std::vector<float*> *pxlVals, std::vector<unsigned int> imgBands, float maskValue): RSGISCalcImageValue(0)
-    {
-        this->pxlVals = pxlVals;
-        this->imgBands = imgBands;
-        this->maskValue = maskValue;
-        this->numOutVals = this->imgBands.size();
-    }
-    
-    void RSGISExtractImageBandValuesWithMask::calcImageValue(float *bandValues, int numBands) 
+    void RSGISExtractMaskedPxlVals2HDF::flush()
     {
-        if(bandValues[0] == maskValue)
+        for(unsigned int rowOff = 0; rowOff < this->numBufRows; rowOff += this->batchRows)
         {
-            float *data = new float[numOutVals];
-            for(unsigned i = 0; i < numOutVals; ++i)
-            {
-                data[i] = bandValues[imgBands.at(i)];
-            }
-            pxlVals->push_back(data);
+            unsigned int nRows = std::min(this->batchRows, this->numBufRows - rowOff);
+            this->exportCols2HDF->addDataRows(&this->rowsBuffer[((size_t)rowOff) * this->numOutVals], nRows, H5::PredType::NATIVE_FLOAT);
+        }
+        this->numBufRows = 0;
+        if(this->nSamples > 0)
+        {
+            std::vector<float>().swap(this->rowsBuffer);
         }
     }
     
-    RSGISExtractImageBandValuesWithMask::~RSGISExtractImageBandValuesWithMask()
+    RSGISExtractMaskedPxlVals2HDF::~RSGISExtractMaskedPxlVals2HDF()
     {
         
     }
@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 #include <utility>
+#include <algorithm>
 
 #include "gdal_priv.h"
 
@@ -57,45 +58,35 @@
 #endif
 
 namespace rsgis{namespace img{
+    
+    /** The number of rows in the chunks of the output HDF5 files, also the number of rows written at a time. */
+    static const unsigned int HDF5_EXTRACT_CHUNK_ROWS( 10000 );
 	
     
     class DllExport RSGISExtractImageValues
     {
     public:
         RSGISExtractImageValues();
-        void extractDataWithinMask2HDF(GDALDataset *mask, GDALDataset *image, std::string outHDFFile, float maskValue, RSGISLibDataType dataType);
-        void extractImgBandDataWithinMask2HDF(std::vector<std::pair<std::string, std::vector<unsigned int> > > imageFiles, std::string maskImage, std::string outHDFFile, float maskValue, RSGISLibDataType dataType);
+        /** Extract the pixel values within the mask; if nSamples > 0 only a random sample of nSamples pixels is written. */
+        void extractDataWithinMask2HDF(GDALDataset *mask, GDALDataset *image, std::string outHDFFile, float maskValue, RSGISLibDataType dataType, unsigned int nSamples=0, int seed=0, bool compress=true);
+        void extractImgBandDataWithinMask2HDF(std::vector<std::pair<std::string, std::vector<unsigned int> > > imageFiles, std::string maskImage, std::string outHDFFile, float maskValue, RSGISLibDataType dataType, unsigned int nSamples=0, int seed=0, bool compress=true);
         void sampleExtractedHDFData(std::string inputH5, std::string outputH5, unsigned int nSamples, int seed, RSGISLibDataType dataType);
         void splitExtractedHDFData(std::string inputH5, std::string outputP1H5, std::string outputP2H5, unsigned int nSamples, int seed, RSGISLibDataType dataType);
         ~RSGISExtractImageValues();
     };
     
 	
-	class DllExport RSGISExtractImageValuesWithMask : public RSGISCalcImageValue
-	{
-	public:
-		RSGISExtractImageValuesWithMask(std::vector<float*> *pxlVals, float maskValue);
-		void calcImageValue(float *bandValues, int numBands, double *output)  {throw RSGISImageCalcException("No implemented");};
-		void calcImageValue(float *bandValues, int numBands);
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) {throw RSGISImageCalcException("Not implemented");};
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) {throw RSGISImageCalcException("Not implemented");};
-		void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, geos::geom::Envelope extent){throw rsgis::img::RSGISImageCalcException("Not implemented");};
-        void calcImageValue(float *bandValues, int numBands, geos::geom::Envelope extent)  {throw RSGISImageCalcException("No implemented");};
-		void calcImageValue(float *bandValues, int numBands, double *output, geos::geom::Envelope extent)  {throw RSGISImageCalcException("No implemented");};
-		void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output)  {throw RSGISImageCalcException("No implemented");};
-        void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw RSGISImageCalcException("No implemented");};
-		bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output)  {throw RSGISImageCalcException("No implemented");};
-		~RSGISExtractImageValuesWithMask();
-    private:
-        std::vector<float*> *pxlVals;
-        float maskValue;
-	};
-    
-    
-    class DllExport RSGISExtractImageBandValuesWithMask : public RSGISCalcImageValue
+    /**
+     * Extracts the values of the selected image bands for the pixels within the mask
+     * (band 0 of the input band values) to an open RSGISExportColumnData2HDF file. Rows
+     * are collected in a contiguous buffer and appended to the file batchRows at a time.
+     * If nSamples > 0 a uniform random sample of (at most) nSamples pixels is kept using
+     * reservoir sampling and only written when flush() is called.
+     */
+    class DllExport RSGISExtractMaskedPxlVals2HDF : public RSGISCalcImageValue
     {
     public:
-        RSGISExtractImageBandValuesWithMask(std::vector<float*> *pxlVals, std::vector<unsigned int> imgBands, float maskValue);
+        RSGISExtractMaskedPxlVals2HDF(rsgis::utils::RSGISExportColumnData2HDF *exportCols2HDF, std::vector<unsigned int> imgBands, float maskValue, unsigned int nSamples=0, int seed=0, unsigned int batchRows=HDF5_EXTRACT_CHUNK_ROWS);
         void calcImageValue(float *bandValues, int numBands, double *output)  {throw RSGISImageCalcException("No implemented");};
         void calcImageValue(float *bandValues, int numBands);
         void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) {throw RSGISImageCalcException("Not implemented");};
@@ -106,12 +97,22 @@ namespace rsgis{namespace img{
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output)  {throw RSGISImageCalcException("No implemented");};
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw RSGISImageCalcException("No implemented");};
         bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output)  {throw RSGISImageCalcException("No implemented");};
-        ~RSGISExtractImageBandValuesWithMask();
+        /** Write the rows still in the buffer (or the sample) to the file. */
+        void flush();
+        /** The number of pixels within the mask, whether or not they were sampled. */
+        unsigned long long getNumPxlsInMask(){return this->numPxlsInMask;};
+        ~RSGISExtractMaskedPxlVals2HDF();
     private:
-        std::vector<float*> *pxlVals;
+        rsgis::utils::RSGISExportColumnData2HDF *exportCols2HDF;
         std::vector<unsigned int> imgBands;
         unsigned int numOutVals;
         float maskValue;
+        unsigned int nSamples;
+        unsigned int batchRows;
+        unsigned long long numPxlsInMask;
+        unsigned int numBufRows;
+        std::vector<float> rowsBuffer;
+        boost::mt19937 randomGen;
     };
     
 
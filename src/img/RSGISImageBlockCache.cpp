@@ -0,0 +1,290 @@
+/*
+ *  RSGISImageBlockCache.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISImageBlockCache.h"
+
+namespace rsgis{namespace img{
+
+    std::mutex RSGISImageBlockCache::cacheMutex;
+    std::mutex RSGISImageBlockCache::datasetMutexes[RSGISImageBlockCache::numDatasetMutexes];
+    size_t RSGISImageBlockCache::maxMemory = 0;
+    size_t RSGISImageBlockCache::memoryUsed = 0;
+    unsigned long long RSGISImageBlockCache::numHits = 0;
+    unsigned long long RSGISImageBlockCache::numMisses = 0;
+    std::list<RSGISImageBlockCache::Block> RSGISImageBlockCache::blocks;
+    std::map<RSGISImageBlockCache::BlockKey, std::list<RSGISImageBlockCache::Block>::iterator> RSGISImageBlockCache::blockIndex;
+
+    CPLErr RSGISImageBlockCache::readRaster(GDALRasterBand *band, int xOff, int yOff, int xSize, int ySize, void *data, int bufXSize, int bufYSize, GDALDataType dataType, GSpacing pixelSpace, GSpacing lineSpace)
+    {
+        size_t maxMem = RSGISImageBlockCache::getMaxMemory();
+        if((maxMem == 0) || (bufXSize != xSize) || (bufYSize != ySize) || (pixelSpace != 0) || (lineSpace != 0) || (xSize <= 0) || (ySize <= 0)
+           || (xOff < 0) || (yOff < 0) || ((xOff + xSize) > band->GetXSize()) || ((yOff + ySize) > band->GetYSize()))
+        {
+            return band->RasterIO(GF_Read, xOff, yOff, xSize, ySize, data, bufXSize, bufYSize, dataType, pixelSpace, lineSpace);
+        }
+
+        GDALDataset *dataset = band->GetDataset();
+        if(dataset == NULL)
+        {
+            return band->RasterIO(GF_Read, xOff, yOff, xSize, ySize, data, bufXSize, bufYSize, dataType, pixelSpace, lineSpace);
+        }
+        std::string fileName = std::string(dataset->GetDescription());
+        if(dataset->GetAccess() == GA_Update)
+        {
+            // The file is being changed so any blocks cached from it are out of date.
+            RSGISImageBlockCache::invalidate(fileName);
+            return band->RasterIO(GF_Read, xOff, yOff, xSize, ySize, data, bufXSize, bufYSize, dataType, pixelSpace, lineSpace);
+        }
+        std::vector<long long> fileStats;
+        if(fileName.empty() || !RSGISImageBlockCache::getFileStats(dataset, fileName, &fileStats))
+        {
+            return band->RasterIO(GF_Read, xOff, yOff, xSize, ySize, data, bufXSize, bufYSize, dataType, pixelSpace, lineSpace);
+        }
+
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        band->GetBlockSize(&xBlockSize, &yBlockSize);
+        GDALDataType nativeType = band->GetRasterDataType();
+        int nativeBytes = GDALGetDataTypeSize(nativeType) / 8;
+        int outBytes = GDALGetDataTypeSize(dataType) / 8;
+        size_t blockBytes = ((size_t)xBlockSize) * yBlockSize * nativeBytes;
+        if((xBlockSize <= 0) || (yBlockSize <= 0) || (nativeBytes == 0) || (outBytes == 0) || (blockBytes > (maxMem / 4)))
+        {
+            return band->RasterIO(GF_Read, xOff, yOff, xSize, ySize, data, bufXSize, bufYSize, dataType, pixelSpace, lineSpace);
+        }
+
+        BlockKey key;
+        key.fileName = fileName;
+        key.fileStats = fileStats;
+        key.band = band->GetBand();
+
+        GByte *outData = (GByte *)data;
+        for(int yBlock = (yOff / yBlockSize); yBlock <= ((yOff + ySize - 1) / yBlockSize); ++yBlock)
+        {
+            for(int xBlock = (xOff / xBlockSize); xBlock <= ((xOff + xSize - 1) / xBlockSize); ++xBlock)
+            {
+                key.xBlock = xBlock;
+                key.yBlock = yBlock;
+                std::shared_ptr< std::vector<GByte> > blockData = RSGISImageBlockCache::getBlock(band, key, blockBytes);
+                if(!blockData)
+                {
+                    return CE_Failure;
+                }
+
+                // Copy the part of the block within the region, converting to the output data type.
+                int blockXOff = xBlock * xBlockSize;
+                int blockYOff = yBlock * yBlockSize;
+                int x0 = std::max(xOff, blockXOff);
+                int x1 = std::min(xOff + xSize, blockXOff + xBlockSize);
+                int y0 = std::max(yOff, blockYOff);
+                int y1 = std::min(yOff + ySize, blockYOff + yBlockSize);
+                for(int y = y0; y < y1; ++y)
+                {
+                    GByte *srcData = &(*blockData)[((((size_t)(y - blockYOff)) * xBlockSize) + (x0 - blockXOff)) * nativeBytes];
+                    GByte *dstData = &outData[((((size_t)(y - yOff)) * xSize) + (x0 - xOff)) * outBytes];
+                    GDALCopyWords(srcData, nativeType, nativeBytes, dstData, dataType, outBytes, (x1 - x0));
+                }
+            }
+        }
+        return CE_None;
+    }
+
+    bool RSGISImageBlockCache::getFileStats(GDALDataset *dataset, const std::string &fileName, std::vector<long long> *fileStats)
+    {
+        // The blocks of a VRT are read from other datasets (which may not be files, or may be
+        // other VRTs) so the files a VRT depends on cannot be reliably listed.
+        GDALDriver *driver = dataset->GetDriver();
+        if((driver == NULL) || EQUAL(driver->GetDescription(), "VRT"))
+        {
+            return false;
+        }
+
+        std::vector<std::string> fileNames;
+        fileNames.push_back(fileName);
+        char **fileList = dataset->GetFileList();
+        for(int i = 0; (fileList != NULL) && (fileList[i] != NULL); ++i)
+        {
+            if(fileName != fileList[i])
+            {
+                fileNames.push_back(std::string(fileList[i]));
+            }
+        }
+        CSLDestroy(fileList);
+
+        // The modification time (to the nanosecond, where available) and size of every file
+        // the dataset is read from (e.g., ENVI header, external overviews) so a change to any
+        // of them gives a different key.
+        fileStats->clear();
+        for(std::vector<std::string>::iterator iterFile = fileNames.begin(); iterFile != fileNames.end(); ++iterFile)
+        {
+            VSIStatBufL statBuf;
+            if((VSIStatL(iterFile->c_str(), &statBuf) != 0) || !VSI_ISREG(statBuf.st_mode))
+            {
+                return false;
+            }
+#if defined(__linux__)
+            fileStats->push_back((((long long)statBuf.st_mtime) * 1000000000LL) + statBuf.st_mtim.tv_nsec);
+#elif defined(__APPLE__)
+            fileStats->push_back((((long long)statBuf.st_mtime) * 1000000000LL) + statBuf.st_mtimespec.tv_nsec);
+#else
+            fileStats->push_back(((long long)statBuf.st_mtime) * 1000000000LL);
+#endif
+            fileStats->push_back(statBuf.st_size);
+        }
+        return true;
+    }
+
+    std::shared_ptr< std::vector<GByte> > RSGISImageBlockCache::getBlock(GDALRasterBand *band, const BlockKey &key, int blockBytes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            std::map<BlockKey, std::list<Block>::iterator>::iterator iterBlock = blockIndex.find(key);
+            if(iterBlock != blockIndex.end())
+            {
+                blocks.splice(blocks.begin(), blocks, iterBlock->second);
+                ++numHits;
+                return iterBlock->second->data;
+            }
+        }
+
+        // Read the block without holding the cache lock so other threads can use the cache,
+        // but with the lock for the dataset as a GDALRasterBand is not thread safe.
+        std::shared_ptr< std::vector<GByte> > blockData(new std::vector<GByte>(blockBytes));
+        {
+            std::lock_guard<std::mutex> dsLock(RSGISImageBlockCache::getDatasetMutex(band->GetDataset()));
+            if(band->ReadBlock(key.xBlock, key.yBlock, &(*blockData)[0]) != CE_None)
+            {
+                return std::shared_ptr< std::vector<GByte> >();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        ++numMisses;
+        if((maxMemory > 0) && (blockIndex.find(key) == blockIndex.end()))
+        {
+            Block block;
+            block.key = key;
+            block.data = blockData;
+            blocks.push_front(block);
+            blockIndex[key] = blocks.begin();
+            memoryUsed += blockBytes;
+            RSGISImageBlockCache::removeLRUBlocks();
+        }
+        return blockData;
+    }
+
+    void RSGISImageBlockCache::removeLRUBlocks()
+    {
+        while((memoryUsed > maxMemory) && (!blocks.empty()))
+        {
+            memoryUsed -= blocks.back().data->size();
+            blockIndex.erase(blocks.back().key);
+            blocks.pop_back();
+        }
+    }
+
+    std::mutex& RSGISImageBlockCache::getDatasetMutex(GDALDataset *dataset)
+    {
+        size_t idx = (((size_t)dataset) >> 4) % numDatasetMutexes;
+        return datasetMutexes[idx];
+    }
+
+    void RSGISImageBlockCache::setMaxMemory(size_t maxMemory)
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        RSGISImageBlockCache::maxMemory = maxMemory;
+        RSGISImageBlockCache::removeLRUBlocks();
+    }
+
+    size_t RSGISImageBlockCache::getMaxMemory()
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return maxMemory;
+    }
+
+    size_t RSGISImageBlockCache::getMemoryUsed()
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return memoryUsed;
+    }
+
+    unsigned long long RSGISImageBlockCache::getNumHits()
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return numHits;
+    }
+
+    unsigned long long RSGISImageBlockCache::getNumMisses()
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return numMisses;
+    }
+
+    void RSGISImageBlockCache::resetCounters()
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        numHits = 0;
+        numMisses = 0;
+    }
+
+    void RSGISImageBlockCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        blocks.clear();
+        blockIndex.clear();
+        memoryUsed = 0;
+    }
+
+    void RSGISImageBlockCache::invalidate(std::string fileName)
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        // The keys are ordered by file name first so the blocks for the file are together.
+        BlockKey firstKey;
+        firstKey.fileName = fileName;
+        firstKey.band = std::numeric_limits<int>::min();
+        firstKey.xBlock = std::numeric_limits<int>::min();
+        firstKey.yBlock = std::numeric_limits<int>::min();
+        std::map<BlockKey, std::list<Block>::iterator>::iterator iterBlock = blockIndex.lower_bound(firstKey);
+        while((iterBlock != blockIndex.end()) && (iterBlock->first.fileName == fileName))
+        {
+            memoryUsed -= iterBlock->second->data->size();
+            blocks.erase(iterBlock->second);
+            iterBlock = blockIndex.erase(iterBlock);
+        }
+    }
+
+    void RSGISImageBlockCache::closeDataset(GDALDataset *dataset)
+    {
+        if(dataset == NULL)
+        {
+            return;
+        }
+        bool wasUpdate = (dataset->GetAccess() == GA_Update);
+        std::string fileName = std::string(dataset->GetDescription());
+        GDALClose(dataset);
+        if(wasUpdate && (!fileName.empty()))
+        {
+            RSGISImageBlockCache::invalidate(fileName);
+        }
+    }
+
+}}
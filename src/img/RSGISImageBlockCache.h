@@ -0,0 +1,144 @@
+/*
+ *  RSGISImageBlockCache.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISImageBlockCache_H
+#define RSGISImageBlockCache_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <algorithm>
+#include <limits>
+
+#include "gdal_priv.h"
+#include "cpl_vsi.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_img_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace img{
+
+    /**
+     * A process wide cache of raster blocks, in the native data type of the band, which
+     * (unlike the GDAL block cache) is kept when a dataset is closed so a sequence of
+     * operations over the same input images only reads each block from disk once.
+     *
+     * Blocks are identified by the file name, the modification time and size of each file
+     * in the dataset's file list, the band and the block position. When the memory used is
+     * over the limit, the least recently used blocks are removed. The cache is off (memory
+     * limit of 0) unless set; datasets which are open for update, which are not files (e.g.,
+     * MEM) or which are VRTs (whose source files cannot be reliably listed) are always read
+     * directly.
+     *
+     * The modification time is used to the nanosecond where the platform provides it. On
+     * file systems which only store whole seconds, a file rewritten (to the same size) within
+     * the same second as it was cached, by another process or without calling closeDataset or
+     * invalidate, will still be read from the cache.
+     *
+     * Blocks are read with GDALRasterBand::ReadBlock while holding a lock for the dataset so
+     * threads reading through the cache do not use the same band at the same time. Callers
+     * must not read from a band outside of the cache while another thread is reading the same
+     * dataset through it (e.g., RSGISCalcImage holds a lock for each input dataset as well).
+     */
+    class DllExport RSGISImageBlockCache
+    {
+    public:
+        /**
+         * A replacement for GDALRasterBand::RasterIO(GF_Read, ...) which reads through the cache.
+         * Reads with a different buffer size (i.e., resampling) or non-default spacing are passed to GDAL.
+         */
+        static CPLErr readRaster(GDALRasterBand *band, int xOff, int yOff, int xSize, int ySize, void *data, int bufXSize, int bufYSize, GDALDataType dataType, GSpacing pixelSpace, GSpacing lineSpace);
+        /** Set the maximum memory (bytes) used by the cache; 0 turns the cache off. */
+        static void setMaxMemory(size_t maxMemory);
+        static size_t getMaxMemory();
+        static size_t getMemoryUsed();
+        static unsigned long long getNumHits();
+        static unsigned long long getNumMisses();
+        static void resetCounters();
+        /** Remove all the blocks from the cache. */
+        static void clear();
+        /** Remove the blocks for a file (e.g., as it is about to be overwritten). */
+        static void invalidate(std::string fileName);
+        /**
+         * A replacement for GDALClose which, if the dataset was open for update,
+         * removes the blocks for the file once it has been written.
+         */
+        static void closeDataset(GDALDataset *dataset);
+    protected:
+        struct BlockKey
+        {
+            std::string fileName;
+            /** Modification time and size of each file of the dataset. */
+            std::vector<long long> fileStats;
+            int band;
+            int xBlock;
+            int yBlock;
+            bool operator<(const BlockKey &other) const
+            {
+                if(fileName != other.fileName){return fileName < other.fileName;}
+                if(fileStats != other.fileStats){return fileStats < other.fileStats;}
+                if(band != other.band){return band < other.band;}
+                if(yBlock != other.yBlock){return yBlock < other.yBlock;}
+                return xBlock < other.xBlock;
+            };
+        };
+        struct Block
+        {
+            BlockKey key;
+            std::shared_ptr< std::vector<GByte> > data;
+        };
+        /** Returns false if the dataset cannot be cached (i.e., not all its files can be found). */
+        static bool getFileStats(GDALDataset *dataset, const std::string &fileName, std::vector<long long> *fileStats);
+        static std::shared_ptr< std::vector<GByte> > getBlock(GDALRasterBand *band, const BlockKey &key, int blockBytes);
+        static void removeLRUBlocks();
+        static std::mutex& getDatasetMutex(GDALDataset *dataset);
+
+        static std::mutex cacheMutex;
+        /** Locks for reading blocks, selected from the dataset pointer. */
+        static const unsigned int numDatasetMutexes = 64;
+        static std::mutex datasetMutexes[numDatasetMutexes];
+        static size_t maxMemory;
+        static size_t memoryUsed;
+        static unsigned long long numHits;
+        static unsigned long long numMisses;
+        /** Most recently used at the front. */
+        static std::list<Block> blocks;
+        static std::map<BlockKey, std::list<Block>::iterator> blockIndex;
+    };
+
+}}
+
+#endif
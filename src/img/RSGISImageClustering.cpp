@@ -31,7 +31,7 @@ namespace rsgis{namespace img{
         
     }
         
-    void RSGISImageClustering::findKMeansCentres(GDALDataset *dataset, std::string outputMatrix, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, rsgis::math::InitClustererMethods initMethod)
+    void RSGISImageClustering::findKMeansCentres(GDALDataset *dataset, std::string outputMatrix, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, rsgis::math::InitClustererMethods initMethod, unsigned int miniBatchSize)
     {
         try 
         {
@@ -40,7 +40,7 @@ namespace rsgis{namespace img{
             std::vector< std::vector<float> > *pxlValues = this->sampleImage(dataset, subSample, ignoreZeros);
             
             std::cout << "Performing clustering\n";
-            rsgis::math::RSGISKMeansClusterer clusterer(initMethod);
+            rsgis::math::RSGISKMeansClusterer clusterer(initMethod, 0, miniBatchSize);
             std::vector< rsgis::math::RSGISClusterCentre > *clusterCentres = clusterer.calcClusterCentres(pxlValues, numImgBands, numClusters, maxNumIterations, degreeOfChange);
             
             std::cout << "Exporting cluster centres to output file\n";
@@ -784,73 +784,45 @@ namespace rsgis{namespace img{
             
             outputRasterBand->GetBlockSize(&xBlockSize, &yBlockSize);
             
-            int bufferSize = yBlockSize * width;
-            imgData = (float *) CPLMalloc(sizeof(float)*(bufferSize));
+            // The interpolator calculates a number of rows at a time so it can reuse
+            // neighbourhoods and, when using multiple threads, process the rows in parallel.
+            int numRowsRead = yBlockSize;
+            unsigned int numThreads = rsgis::RSGISThreadPool::getDefaultNumThreads();
+            if((numThreads > 1) && (((unsigned int)yBlockSize) < (numThreads * 4)))
+            {
+                numRowsRead = yBlockSize * ceil(((double)(numThreads * 4)) / ((double)yBlockSize));
+            }
             
-            int nYBlocks = floor(((double)height) / ((double)yBlockSize));
-            int remainRows = height - (nYBlocks * yBlockSize);
-            int rowOffset = 0;
+            int bufferSize = numRowsRead * width;
+            imgData = (float *) CPLMalloc(sizeof(float)*(bufferSize));
             
             double tlX = gdalTransform[0];
             double tlY = gdalTransform[3];
             double xRes = gdalTransform[1];
             double yRes = gdalTransform[5];
             
-            double cX = 0.0;
-            double cY = 0.0;
-            
+            int numRows = 0;
             
 			int feedback = height/10.0;
 			int feedbackCounter = 0;
 			std::cout << "Started" << std::flush;
-            cY = tlY;
-            for(int i = 0; i < nYBlocks; ++i)
+            for(int rowOffset = 0; rowOffset < height; rowOffset += numRowsRead)
 			{
-                for(int m = 0; m < yBlockSize; ++m)
+                numRows = std::min(numRowsRead, height - rowOffset);
+                while((feedback != 0) && (feedbackCounter <= 90) && (rowOffset >= ((feedbackCounter / 10) * feedback)))
                 {
-                    if((feedback != 0) && (((i*yBlockSize)+m) % feedback) == 0)
-                    {
-                        std::cout << "." << feedbackCounter << "." << std::flush;
-                        feedbackCounter = feedbackCounter + 10;
-                    }
-                    cX = tlX;
-                    for(int j = 0; j < width; ++j)
-                    {
-                        imgData[(m*width)+j] = interpolator->getValue(cX, cY);
-                        cX += xRes;
-                    }
-                    cY += yRes;
+                    std::cout << "." << feedbackCounter << "." << std::flush;
+                    feedbackCounter = feedbackCounter + 10;
                 }
-				
-				rowOffset = yBlockSize * i;
-                outputRasterBand->RasterIO(GF_Write, 0, rowOffset, width, yBlockSize, imgData, width, yBlockSize, GDT_Float32, 0, 0);
+                
+                interpolator->getValues(tlX, (tlY + (rowOffset * yRes)), xRes, yRes, width, numRows, imgData);
+                
+                outputRasterBand->RasterIO(GF_Write, 0, rowOffset, width, numRows, imgData, width, numRows, GDT_Float32, 0, 0);
 			}
-            
-            if(remainRows > 0)
-            {
-                for(int m = 0; m < remainRows; ++m)
-                {
-                    if((feedback != 0) && ((((nYBlocks*yBlockSize)+m) % feedback) == 0))
-                    {
-                        std::cout << "." << feedbackCounter << "." << std::flush;
-                        feedbackCounter = feedbackCounter + 10;
-                    }
-                    cX = tlX;
-                    for(int j = 0; j < width; ++j)
-                    {
-                        imgData[(m*width)+j] = interpolator->getValue(cX, cY);
-                        cX += xRes;
-                    }
-                    cY += yRes;
-                }
-				
-				rowOffset = (yBlockSize * nYBlocks);
-                outputRasterBand->RasterIO(GF_Write, 0, rowOffset, width, remainRows, imgData, width, remainRows, GDT_Float32, 0, 0);
-            }
 			std::cout << " Complete.\n";
                         
             delete[] gdalTransform;
-            delete[] imgData;
+            CPLFree(imgData);
             
         }
         catch(rsgis::math::RSGISInterpolationException &e)
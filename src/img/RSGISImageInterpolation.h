@@ -25,12 +25,14 @@
 
 #include <iostream>
 #include <string>
+#include <algorithm>
 
 #include "gdal_priv.h"
 
 #include "common/rsgis-tqdm.h"
 #include "common/RSGISFileException.h"
 #include "common/RSGISImageException.h"
+#include "common/RSGISThreadPool.h"
 
 #include "img/RSGISImageInterpolator.h"
 
@@ -47,19 +47,9 @@ namespace rsgis{namespace img{
 		int width;
 		int height;
 		double *transformation = new double[6];
-		double *imgTransform = new double[6];
 		int numberBands = 0;
-		int tileXSize = 0;
-		int tileYSize = 0;
-		double xDiff = 0;
-		double yDiff = 0;
-		int xStart = 0;
-		int yStart = 0;
 		std::string projection = proj;
 		GDALDataset *outputDataset = NULL;
-		GDALRasterBand **inputRasterBands = NULL;
-		GDALRasterBand **outputRasterBands = NULL;
-		float **inputData = NULL;
 
         std::vector<std::string> bandnames;
 
@@ -106,176 +96,41 @@ namespace rsgis{namespace img{
 			outputDataset = imgUtils.createBlankImage(outputImage, transformation, width, height, numberBands, projection, background, bandnames, format, imgDataType);
 
 			// COPY IMAGE DATA INTO THE BLANK IMAGE
-
-            //Get Image Output Bands
-            outputRasterBands = new GDALRasterBand*[numberBands];
-            for(int i = 0; i < numberBands; i++)
-            {
-                outputRasterBands[i] = outputDataset->GetRasterBand(i+1);
-            }
-
-            int xBlockSize = 0;
-            int yBlockSize = 0;
-            outputRasterBands[0]->GetBlockSize (&xBlockSize, &yBlockSize);
-
-			std::cout << "Started (total " << numDS << ") ." << std::flush;
-
-            for(int ds = 0; ds < numDS; ds++)
-			{
-				std::cout << "." << ds+1 << "." << std::flush;
-
-                dataset = (GDALDataset *) GDALOpenShared(inputImages[ds].c_str(), GA_ReadOnly);
-                if(dataset == NULL)
-                {
-                    std::string message = std::string("Could not open image ") + inputImages[ds];
-                    throw RSGISImageException(message.c_str());
-                }
-
-                inputRasterBands = new GDALRasterBand*[numberBands];
-                for(int i = 0; i < numberBands; i++)
-                {
-                    inputRasterBands[i] = dataset->GetRasterBand(i+1);
-                }
-
-				dataset->GetGeoTransform(imgTransform);
-				tileXSize = dataset->GetRasterXSize();
-				tileYSize = dataset->GetRasterYSize();
-
-				xDiff = imgTransform[0] - transformation[0];
-				yDiff = transformation[3] - imgTransform[3];
-
-				xStart = floor((xDiff/transformation[1])+0.5);
-				yStart = floor((yDiff/transformation[1])+0.5);
-
-                // Allocate memory
-                inputData = new float*[numberBands];
-                for(int i = 0; i < numberBands; i++)
-                {
-                    inputData[i] = (float *) CPLMalloc(sizeof(float)*(tileXSize*yBlockSize));
-                }
-
-                int nYBlocks = tileYSize / yBlockSize;
-                int remainRows = tileYSize - (nYBlocks * yBlockSize);
-                int rowOffset = 0;
-
-                for(int i = 0; i < nYBlocks; i++)
-                {
-                    for(int n = 0; n < numberBands; n++)
-                    {
-                        rowOffset = yBlockSize * i;
-                        inputRasterBands[n]->RasterIO(GF_Read, 0, rowOffset, tileXSize, yBlockSize, inputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                        outputRasterBands[n]->RasterIO(GF_Write, xStart, (yStart + rowOffset), tileXSize, yBlockSize, inputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                    }
-
-                }
-
-                if(remainRows > 0)
-                {
-                    for(int n = 0; n < numberBands; n++)
-                    {
-                        rowOffset = yBlockSize * nYBlocks;
-                        inputRasterBands[n]->RasterIO(GF_Read, 0, rowOffset, tileXSize, remainRows, inputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
-                        outputRasterBands[n]->RasterIO(GF_Write, xStart, (yStart + rowOffset), tileXSize, remainRows, inputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
-                    }
-                }
-
-                // Tidy up
-                if(inputData != NULL)
-                {
-                    for(int i = 0; i < numberBands; i++)
-                    {
-                        if(inputData[i] != NULL)
-                        {
-                            delete[] inputData[i];
-                        }
-                    }
-                    delete[] inputData;
-                }
-                if(inputRasterBands != NULL)
-                {
-                    delete[] inputRasterBands;
-                }
-
-                GDALClose(dataset);
-			}
-			std::cout << ".complete\n";
-
+            this->mosaicBlocks(inputImages, numDS, outputDataset, transformation, background, 0, 0, 0, 0, 0, 0);
 		}
 		catch(RSGISImageBandException &e)
 		{
-            if(inputData != NULL)
-            {
-                for(int i = 0; i < numberBands; i++)
-                {
-                    if(inputData[i] != NULL)
-                    {
-                        delete[] inputData[i];
-                    }
-                }
-                delete[] inputData;
-            }
-            if(inputRasterBands != NULL)
-            {
-                delete[] inputRasterBands;
-            }
-            if(outputRasterBands != NULL)
-            {
-                delete[] outputRasterBands;
-            }
-			if(transformation != NULL)
+			if(outputDataset != NULL)
 			{
-				delete[] transformation;
+				GDALClose(outputDataset);
 			}
-			if(imgTransform != NULL)
+			if(transformation != NULL)
 			{
-				delete[] imgTransform;
+				delete[] transformation;
 			}
 			throw e;
 		}
 
-        // Tidy
-        if(outputRasterBands != NULL)
-        {
-            delete[] outputRasterBands;
-        }
-
 		if(transformation != NULL)
 		{
 			delete[] transformation;
 		}
-		if(imgTransform != NULL)
-		{
-			delete[] imgTransform;
-		}
 		GDALClose(outputDataset);
 	}
 
 	void RSGISImageMosaic::mosaicSkipVals(std::string *inputImages, int numDS, std::string outputImage, float background, float skipVal, bool projFromImage, std::string proj, unsigned int skipBand, unsigned int overlapBehaviour, std::string format, GDALDataType imgDataType)
 	{
 		RSGISImageUtils imgUtils;
-		rsgis::math::RSGISMathsUtils mathsUtils;
-
+        rsgis::math::RSGISMathsUtils mathsUtils;
         GDALAllRegister();
         GDALDataset *dataset = NULL;
         GDALRasterBand *imgBand = NULL;
 		int width;
 		int height;
 		double *transformation = new double[6];
-		double *imgTransform = new double[6];
 		int numberBands = 0;
-		int tileXSize = 0;
-		int tileYSize = 0;
-		double xDiff = 0;
-		double yDiff = 0;
-		int xStart = 0;
-		int yStart = 0;
 		std::string projection = proj;
 		GDALDataset *outputDataset = NULL;
-		GDALRasterBand **inputRasterBands = NULL;
-		GDALRasterBand **outputRasterBands = NULL;
-		float **inputData = NULL;
-		float **outputData = NULL;
-		bool pixelsChanged;
 
         std::vector<std::string> bandnames;
 
@@ -322,305 +177,25 @@ namespace rsgis{namespace img{
 			outputDataset = imgUtils.createBlankImage(outputImage, transformation, width, height, numberBands, projection, background, bandnames, format, imgDataType);
 
 			// COPY IMAGE DATA INTO THE BLANK IMAGE
-
-            //Get Image Output Bands
-            outputRasterBands = new GDALRasterBand*[numberBands];
-            for(int i = 0; i < numberBands; i++)
-            {
-                outputRasterBands[i] = outputDataset->GetRasterBand(i+1);
-            }
-
-            int xBlockSize = 0;
-            int yBlockSize = 0;
-            outputRasterBands[0]->GetBlockSize (&xBlockSize, &yBlockSize);
-
-			std::cout << "Started (total " << numDS << ") ." << std::flush;
-
-            for(int ds = 0; ds < numDS; ds++)
-			{
-				std::cout << "." << ds+1 << "." << std::flush;
-
-                dataset = (GDALDataset *) GDALOpenShared(inputImages[ds].c_str(), GA_ReadOnly);
-                if(dataset == NULL)
-                {
-                    std::string message = std::string("Could not open image ") + inputImages[ds];
-                    throw RSGISImageException(message.c_str());
-                }
-
-                inputRasterBands = new GDALRasterBand*[numberBands];
-                for(int i = 0; i < numberBands; i++)
-                {
-                    inputRasterBands[i] = dataset->GetRasterBand(i+1);
-                }
-
-				dataset->GetGeoTransform(imgTransform);
-				tileXSize = dataset->GetRasterXSize();
-				tileYSize = dataset->GetRasterYSize();
-
-				xDiff = imgTransform[0] - transformation[0];
-				yDiff = transformation[3] - imgTransform[3];
-
-				xStart = floor((xDiff/transformation[1])+0.5);
-				yStart = floor((yDiff/transformation[1])+0.5);
-
-                // Allocate memory
-                inputData = new float*[numberBands];
-                outputData = new float*[numberBands];
-                for(int i = 0; i < numberBands; i++)
-                {
-                    inputData[i] = (float *) CPLMalloc(sizeof(float)*(tileXSize*yBlockSize));
-                    outputData[i] = (float *) CPLMalloc(sizeof(float)*(tileXSize*yBlockSize));
-                }
-
-                int nYBlocks = tileYSize / yBlockSize;
-                int remainRows = tileYSize - (nYBlocks * yBlockSize);
-                int rowOffset = 0;
-
-                for(int i = 0; i < nYBlocks; i++)
-                {
-                    // Read input and output data
-                    for(int n = 0; n < numberBands; n++)
-                    {
-                        rowOffset = yBlockSize * i;
-                        // Read input data
-                        inputRasterBands[n]->RasterIO(GF_Read, 0, rowOffset, tileXSize, yBlockSize, inputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                        // Read output data
-                        outputRasterBands[n]->RasterIO(GF_Read, xStart, (yStart + rowOffset), tileXSize, yBlockSize, outputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                    }
-
-                    pixelsChanged = false; // Keep track if there are changes that need writing out.
-
-                    for(int m = 0; m < yBlockSize; ++m)
-                    {
-                        for(int j = 0; j < tileXSize; j++)
-                        {
-                            // Check for skip value
-                            if(inputData[skipBand][(m*tileXSize)+j] != skipVal)
-                            {
-                                // Check if behaviour is defined for overlap and not the first image
-                                if( (overlapBehaviour > 0) && (ds > 0) )
-                                {
-                                    // Check if pixel is background value (no data has been written yet)
-                                    if( outputData[skipBand][(m*tileXSize)+j] == background )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is less (min overlap behaviour)
-                                    else if( (overlapBehaviour == 1) &&  (inputData[skipBand][(m*tileXSize)+j] < outputData[skipBand][(m*tileXSize)+j]) )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is greater (max overlap behaviour)
-                                    else if( (overlapBehaviour == 2) &&  (inputData[skipBand][(m*tileXSize)+j] > outputData[skipBand][(m*tileXSize)+j]) )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                }
-                                // If no overlap behaviour defined, write out,
-                                else
-                                {
-                                    for(int n = 0; n < numberBands; n++)
-                                    {
-                                        outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                    }
-                                    pixelsChanged = true;
-                                }
-
-
-                            }
-                        }
-                    }
-
-                    // Write out data to mosaic
-                    if(pixelsChanged)
-                    {
-                        for(int n = 0; n < numberBands; n++)
-                        {
-                            outputRasterBands[n]->RasterIO(GF_Write, xStart, (yStart + rowOffset), tileXSize, yBlockSize, outputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                        }
-                    }
-
-                }
-
-                if(remainRows > 0)
-                {
-                    for(int n = 0; n < numberBands; n++)
-                    {
-                        rowOffset = yBlockSize * nYBlocks;
-                        // Read input data
-                        inputRasterBands[n]->RasterIO(GF_Read, 0, rowOffset, tileXSize, remainRows, inputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
-                        // Read output data
-                        outputRasterBands[n]->RasterIO(GF_Read, xStart, (yStart + rowOffset), tileXSize, remainRows, outputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
-                    }
-
-                    pixelsChanged = false; // Keep track if there are changes that need writing out.
-
-                    for(int m = 0; m < remainRows; ++m)
-                    {
-                        for(int j = 0; j < tileXSize; j++)
-                        {
-                            // Check for skip value
-                            if(inputData[skipBand][(m*tileXSize)+j] != skipVal)
-                            {
-                                // Check if behaviour is defined for overlap and not the first image
-                                if( (overlapBehaviour > 0) && (ds > 0) )
-                                {
-                                    // Check if pixel is background value (no data has been written yet)
-                                    if( outputData[skipBand][(m*tileXSize)+j] == background )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is less (min overlap behaviour)
-                                    else if( (overlapBehaviour == 1) &&  (inputData[skipBand][(m*tileXSize)+j] < outputData[skipBand][(m*tileXSize)+j]) )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is greater (max overlap behaviour)
-                                    else if( (overlapBehaviour == 2) &&  (inputData[skipBand][(m*tileXSize)+j] > outputData[skipBand][(m*tileXSize)+j]) )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                }
-                                // If no overlap behaviour defined, write out,
-                                else
-                                {
-                                    for(int n = 0; n < numberBands; n++)
-                                    {
-                                        outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                    }
-                                    pixelsChanged = true;
-                                }
-
-
-                            }
-                        }
-                    }
-
-                    // Write out data
-                    if(pixelsChanged)
-                    {
-                        for(int n = 0; n < numberBands; n++)
-                        {
-                            outputRasterBands[n]->RasterIO(GF_Write, xStart, (yStart + rowOffset), tileXSize, remainRows, outputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
-                        }
-                    }
-
-                }
-
-                // Tidy up
-                if(inputData != NULL)
-                {
-                    for(int i = 0; i < numberBands; i++)
-                    {
-                        if(inputData[i] != NULL)
-                        {
-                            delete[] inputData[i];
-                        }
-                    }
-                    delete[] inputData;
-                }
-                if(outputData != NULL)
-                {
-                    for(int i = 0; i < numberBands; i++)
-                    {
-                        if(outputData[i] != NULL)
-                        {
-                            delete[] outputData[i];
-                        }
-                    }
-                    delete[] outputData;
-                }
-                if(inputRasterBands != NULL)
-                {
-                    delete[] inputRasterBands;
-                }
-
-                GDALClose(dataset);
-			}
-			std::cout << ".complete\n";
-
+            this->mosaicBlocks(inputImages, numDS, outputDataset, transformation, background, 1, skipVal, 0, 0, skipBand, overlapBehaviour);
 		}
 		catch(RSGISImageBandException &e)
 		{
-            if(inputData != NULL)
-            {
-                for(int i = 0; i < numberBands; i++)
-                {
-                    if(inputData[i] != NULL)
-                    {
-                        delete[] inputData[i];
-                    }
-                }
-                delete[] inputData;
-            }
-            if(outputData != NULL)
-            {
-                for(int i = 0; i < numberBands; i++)
-                {
-                    if(outputData[i] != NULL)
-                    {
-                        delete[] outputData[i];
-                    }
-                }
-                delete[] outputData;
-            }
-            if(inputRasterBands != NULL)
-            {
-                delete[] inputRasterBands;
-            }
-            if(outputRasterBands != NULL)
-            {
-                delete[] outputRasterBands;
-            }
-			if(transformation != NULL)
+			if(outputDataset != NULL)
 			{
-				delete[] transformation;
+				GDALClose(outputDataset);
 			}
-			if(imgTransform != NULL)
+			if(transformation != NULL)
 			{
-				delete[] imgTransform;
+				delete[] transformation;
 			}
 			throw e;
 		}
 
-        // Tidy
-        if(outputRasterBands != NULL)
-        {
-            delete[] outputRasterBands;
-        }
-
 		if(transformation != NULL)
 		{
 			delete[] transformation;
 		}
-		if(imgTransform != NULL)
-		{
-			delete[] imgTransform;
-		}
 		GDALClose(outputDataset);
 	}
 
@@ -634,21 +209,9 @@ namespace rsgis{namespace img{
 		int width;
 		int height;
 		double *transformation = new double[6];
-		double *imgTransform = new double[6];
 		int numberBands = 0;
-		int tileXSize = 0;
-		int tileYSize = 0;
-		double xDiff = 0;
-		double yDiff = 0;
-		int xStart = 0;
-		int yStart = 0;
 		std::string projection = proj;
 		GDALDataset *outputDataset = NULL;
-		GDALRasterBand **inputRasterBands = NULL;
-		GDALRasterBand **outputRasterBands = NULL;
-		float **inputData = NULL;
-		float **outputData = NULL;
-		bool pixelsChanged;
 
         std::vector<std::string> bandnames;
 
@@ -695,307 +258,269 @@ namespace rsgis{namespace img{
 			outputDataset = imgUtils.createBlankImage(outputImage, transformation, width, height, numberBands, projection, background, bandnames, format, imgDataType);
 
 			// COPY IMAGE DATA INTO THE BLANK IMAGE
+            this->mosaicBlocks(inputImages, numDS, outputDataset, transformation, background, 2, 0, skipLowerThresh, skipUpperThresh, threshBand, overlapBehaviour);
+		}
+		catch(RSGISImageBandException &e)
+		{
+			if(outputDataset != NULL)
+			{
+				GDALClose(outputDataset);
+			}
+			if(transformation != NULL)
+			{
+				delete[] transformation;
+			}
+			throw e;
+		}
 
-            //Get Image Output Bands
-            outputRasterBands = new GDALRasterBand*[numberBands];
-            for(int i = 0; i < numberBands; i++)
-            {
-                outputRasterBands[i] = outputDataset->GetRasterBand(i+1);
-            }
-
-            int xBlockSize = 0;
-            int yBlockSize = 0;
-            outputRasterBands[0]->GetBlockSize (&xBlockSize, &yBlockSize);
-
-			std::cout << "Started (total " << numDS << ") ." << std::flush;
+		if(transformation != NULL)
+		{
+			delete[] transformation;
+		}
+		GDALClose(outputDataset);
+	}
 
-            for(int ds = 0; ds < numDS; ds++)
-			{
-				std::cout << "." << ds+1 << "." << std::flush;
+    void RSGISImageMosaic::mosaicBlocks(std::string *inputImages, int numDS, GDALDataset *outputDataset, double *transformation, float background, unsigned int skipMode, float skipVal, float skipLowerThresh, float skipUpperThresh, unsigned int skipBand, unsigned int overlapBehaviour)
+    {
+        int width = outputDataset->GetRasterXSize();
+        int height = outputDataset->GetRasterYSize();
+        int numberBands = outputDataset->GetRasterCount();
+        if(numberBands == 0)
+        {
+            return;
+        }
+        if(skipBand >= ((unsigned int)numberBands))
+        {
+            throw RSGISImageBandException("The band used to skip values is not within the images.");
+        }
 
-                dataset = (GDALDataset *) GDALOpenShared(inputImages[ds].c_str(), GA_ReadOnly);
-                if(dataset == NULL)
-                {
-                    std::string message = std::string("Could not open image ") + inputImages[ds];
-                    throw RSGISImageException(message.c_str());
-                }
+        // Footprint of each input image within the output image (in pixels).
+        std::vector<int> xStarts(numDS);
+        std::vector<int> yStarts(numDS);
+        std::vector<int> tileXSizes(numDS);
+        std::vector<int> tileYSizes(numDS);
+        double *imgTransform = new double[6];
+        for(int ds = 0; ds < numDS; ds++)
+        {
+            GDALDataset *dataset = (GDALDataset *) GDALOpen(inputImages[ds].c_str(), GA_ReadOnly);
+            if(dataset == NULL)
+            {
+                delete[] imgTransform;
+                std::string message = std::string("Could not open image ") + inputImages[ds];
+                throw RSGISImageException(message.c_str());
+            }
+            dataset->GetGeoTransform(imgTransform);
+            tileXSizes[ds] = dataset->GetRasterXSize();
+            tileYSizes[ds] = dataset->GetRasterYSize();
+            xStarts[ds] = floor(((imgTransform[0] - transformation[0])/transformation[1])+0.5);
+            yStarts[ds] = floor(((transformation[3] - imgTransform[3])/transformation[1])+0.5);
+            GDALClose(dataset);
+        }
+        delete[] imgTransform;
+
+        // The blocks processed follow the blocks of the output image; narrow blocks
+        // (i.e., a single row or a few rows) are extended to a number of rows and
+        // blocks across the whole width (i.e., strips) are split into columns.
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        outputDataset->GetRasterBand(1)->GetBlockSize(&xBlockSize, &yBlockSize);
+        if((xBlockSize <= 0) || (xBlockSize >= width))
+        {
+            xBlockSize = std::min(width, 4096);
+        }
+        if(yBlockSize <= 0)
+        {
+            yBlockSize = 1;
+        }
+        if(yBlockSize < 256)
+        {
+            yBlockSize = std::min(height, yBlockSize * ((int)ceil(256.0/yBlockSize)));
+        }
+        int nXBlocks = (width + xBlockSize - 1) / xBlockSize;
+        int nYBlocks = (height + yBlockSize - 1) / yBlockSize;
 
-                inputRasterBands = new GDALRasterBand*[numberBands];
-                for(int i = 0; i < numberBands; i++)
+        // Index of the input images intersecting each block, in the order given.
+        std::vector< std::vector<int> > blockInputs(((size_t)nXBlocks) * nYBlocks);
+        for(int ds = 0; ds < numDS; ds++)
+        {
+            int xMin = std::max(xStarts[ds], 0);
+            int yMin = std::max(yStarts[ds], 0);
+            int xMax = std::min(xStarts[ds] + tileXSizes[ds], width);
+            int yMax = std::min(yStarts[ds] + tileYSizes[ds], height);
+            if((xMin >= xMax) || (yMin >= yMax))
+            {
+                continue;
+            }
+            for(int by = yMin / yBlockSize; by <= ((yMax - 1) / yBlockSize); ++by)
+            {
+                for(int bx = xMin / xBlockSize; bx <= ((xMax - 1) / xBlockSize); ++bx)
                 {
-                    inputRasterBands[i] = dataset->GetRasterBand(i+1);
+                    blockInputs[(((size_t)by) * nXBlocks) + bx].push_back(ds);
                 }
+            }
+        }
 
-				dataset->GetGeoTransform(imgTransform);
-				tileXSize = dataset->GetRasterXSize();
-				tileYSize = dataset->GetRasterYSize();
-
-				xDiff = imgTransform[0] - transformation[0];
-				yDiff = transformation[3] - imgTransform[3];
+        // GDAL datasets must not be shared between threads so each thread opens
+        // its own handles to the input images, a limited number at a time.
+        unsigned int numThreads = rsgis::RSGISThreadPool::getDefaultNumThreads();
+        const size_t maxOpenDatasets = 64;
+        std::vector< std::map<int, GDALDataset*> > openDatasets(numThreads);
+        std::mutex outputMutex;
+        rsgis_tqdm pbar;
+        size_t numBlocksDone = 0;
+        size_t numBlocks = blockInputs.size();
+
+        auto processBlock = [&](size_t blockIdx, unsigned int threadIdx)
+        {
+            std::vector<int> *inputs = &blockInputs[blockIdx];
+            if(inputs->empty())
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                pbar.progress(++numBlocksDone, numBlocks);
+                return;
+            }
+            int bXOff = (blockIdx % nXBlocks) * xBlockSize;
+            int bYOff = (blockIdx / nXBlocks) * yBlockSize;
+            int bWidth = std::min(xBlockSize, width - bXOff);
+            int bHeight = std::min(yBlockSize, height - bYOff);
+            size_t numBlockPxls = ((size_t)bWidth) * bHeight;
 
-				xStart = floor((xDiff/transformation[1])+0.5);
-				yStart = floor((yDiff/transformation[1])+0.5);
+            std::vector< std::vector<float> > outputData(numberBands, std::vector<float>(numBlockPxls, background));
+            std::vector< std::vector<float> > inputData(numberBands);
+            std::map<int, GDALDataset*> *datasets = &openDatasets[threadIdx];
 
-                // Allocate memory
-                inputData = new float*[numberBands];
-                outputData = new float*[numberBands];
-                for(int i = 0; i < numberBands; i++)
+            for(std::vector<int>::iterator iterDS = inputs->begin(); iterDS != inputs->end(); ++iterDS)
+            {
+                int ds = *iterDS;
+                GDALDataset *dataset = NULL;
+                std::map<int, GDALDataset*>::iterator iterOpen = datasets->find(ds);
+                if(iterOpen != datasets->end())
                 {
-                    inputData[i] = (float *) CPLMalloc(sizeof(float)*(tileXSize*yBlockSize));
-                    outputData[i] = (float *) CPLMalloc(sizeof(float)*(tileXSize*yBlockSize));
+                    dataset = iterOpen->second;
                 }
-
-                int nYBlocks = tileYSize / yBlockSize;
-                int remainRows = tileYSize - (nYBlocks * yBlockSize);
-                int rowOffset = 0;
-
-                for(int i = 0; i < nYBlocks; i++)
+                else
                 {
-                    // Read input and output data
-                    for(int n = 0; n < numberBands; n++)
-                    {
-                        rowOffset = yBlockSize * i;
-                        // Read input data
-                        inputRasterBands[n]->RasterIO(GF_Read, 0, rowOffset, tileXSize, yBlockSize, inputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                        // Read output data
-                        outputRasterBands[n]->RasterIO(GF_Read, xStart, (yStart + rowOffset), tileXSize, yBlockSize, outputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                    }
-
-                    pixelsChanged = false; // Keep track if there are changes that need writing out.
-
-                    for(int m = 0; m < yBlockSize; ++m)
+                    if(datasets->size() >= maxOpenDatasets)
                     {
-                        for(int j = 0; j < tileXSize; j++)
+                        for(iterOpen = datasets->begin(); iterOpen != datasets->end(); ++iterOpen)
                         {
-                            // Check value is between upper and lower limits
-                            if((inputData[threshBand][(m*tileXSize)+j] > skipLowerThresh) && (inputData[threshBand][(m*tileXSize)+j] < skipUpperThresh))
-                            {
-                                // Check if behaviour is defined for overlap and not the first image
-                                if( (overlapBehaviour > 0) && (ds > 0) )
-                                {
-                                    // Check if pixel is background value (no data has been written yet)
-                                    if( outputData[threshBand][(m*tileXSize)+j] == background )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is less (min overlap behaviour)
-                                    else if( (overlapBehaviour == 1) &&  (inputData[threshBand][(m*tileXSize)+j] < outputData[threshBand][(m*tileXSize)+j]) )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is greater (max overlap behaviour)
-                                    else if( (overlapBehaviour == 2) &&  (inputData[threshBand][(m*tileXSize)+j] > outputData[threshBand][(m*tileXSize)+j]) )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                }
-                                // If no overlap behaviour defined, write out,
-                                else
-                                {
-                                    for(int n = 0; n < numberBands; n++)
-                                    {
-                                        outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                    }
-                                    pixelsChanged = true;
-                                }
-
-
-                            }
+                            GDALClose(iterOpen->second);
                         }
+                        datasets->clear();
                     }
-
-                    // Write out data to mosaic
-                    if(pixelsChanged)
+                    dataset = (GDALDataset *) GDALOpen(inputImages[ds].c_str(), GA_ReadOnly);
+                    if(dataset == NULL)
                     {
-                        for(int n = 0; n < numberBands; n++)
-                        {
-                            outputRasterBands[n]->RasterIO(GF_Write, xStart, (yStart + rowOffset), tileXSize, yBlockSize, outputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                        }
+                        std::string message = std::string("Could not open image ") + inputImages[ds];
+                        throw RSGISImageException(message.c_str());
                     }
-
+                    datasets->insert(std::pair<int, GDALDataset*>(ds, dataset));
                 }
 
-                if(remainRows > 0)
+                // Region of the block covered by the input image.
+                int xMin = std::max(xStarts[ds], bXOff);
+                int yMin = std::max(yStarts[ds], bYOff);
+                int xMax = std::min(xStarts[ds] + tileXSizes[ds], bXOff + bWidth);
+                int yMax = std::min(yStarts[ds] + tileYSizes[ds], bYOff + bHeight);
+                int inWidth = xMax - xMin;
+                int inHeight = yMax - yMin;
+                for(int n = 0; n < numberBands; n++)
                 {
-                    for(int n = 0; n < numberBands; n++)
+                    inputData[n].resize(((size_t)inWidth) * inHeight);
+                    if(dataset->GetRasterBand(n+1)->RasterIO(GF_Read, (xMin - xStarts[ds]), (yMin - yStarts[ds]), inWidth, inHeight, &inputData[n][0], inWidth, inHeight, GDT_Float32, 0, 0) != CE_None)
                     {
-                        rowOffset = yBlockSize * nYBlocks;
-                        // Read input data
-                        inputRasterBands[n]->RasterIO(GF_Read, 0, rowOffset, tileXSize, remainRows, inputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
-                        // Read output data
-                        outputRasterBands[n]->RasterIO(GF_Read, xStart, (yStart + rowOffset), tileXSize, remainRows, outputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
+                        throw RSGISImageException("Could not read from image " + inputImages[ds]);
                     }
+                }
 
-                    pixelsChanged = false; // Keep track if there are changes that need writing out.
-
-                    for(int m = 0; m < remainRows; ++m)
+                for(int m = 0; m < inHeight; ++m)
+                {
+                    size_t outIdx = (((size_t)(yMin - bYOff + m)) * bWidth) + (xMin - bXOff);
+                    size_t inIdx = ((size_t)m) * inWidth;
+                    for(int j = 0; j < inWidth; j++, outIdx++, inIdx++)
                     {
-                        for(int j = 0; j < tileXSize; j++)
+                        float inVal = inputData[skipBand][inIdx];
+                        // Check for values to skip
+                        if((skipMode == 1) && (inVal == skipVal))
                         {
-                            // Check value is between upper and lower limits
-                            if((inputData[threshBand][(m*tileXSize)+j] > skipLowerThresh) && (inputData[threshBand][(m*tileXSize)+j] < skipUpperThresh))
-                            {
-                                // Check if behaviour is defined for overlap and not the first image
-                                if( (overlapBehaviour > 0) && (ds > 0) )
-                                {
-                                    // Check if pixel is background value (no data has been written yet)
-                                    if( outputData[threshBand][(m*tileXSize)+j] == background )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is less (min overlap behaviour)
-                                    else if( (overlapBehaviour == 1) &&  (inputData[threshBand][(m*tileXSize)+j] < outputData[threshBand][(m*tileXSize)+j]) )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is greater (max overlap behaviour)
-                                    else if( (overlapBehaviour == 2) &&  (inputData[threshBand][(m*tileXSize)+j] > outputData[threshBand][(m*tileXSize)+j]) )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                }
-                                // If no overlap behaviour defined, write out,
-                                else
-                                {
-                                    for(int n = 0; n < numberBands; n++)
-                                    {
-                                        outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                    }
-                                    pixelsChanged = true;
-                                }
-
-
-                            }
+                            continue;
                         }
-                    }
-
-                    // Write out data
-                    if(pixelsChanged)
-                    {
-                        for(int n = 0; n < numberBands; n++)
+                        else if((skipMode == 2) && !((inVal > skipLowerThresh) && (inVal < skipUpperThresh)))
                         {
-                            outputRasterBands[n]->RasterIO(GF_Write, xStart, (yStart + rowOffset), tileXSize, remainRows, outputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
+                            continue;
                         }
-                    }
-
-                }
 
-                // Tidy up
-                if(inputData != NULL)
-                {
-                    for(int i = 0; i < numberBands; i++)
-                    {
-                        if(inputData[i] != NULL)
+                        // Check if behaviour is defined for overlap and not the first image
+                        if((overlapBehaviour > 0) && (ds > 0))
                         {
-                            delete[] inputData[i];
+                            float outVal = outputData[skipBand][outIdx];
+                            // Write if no data has been written yet or the new value is less (min) or greater (max)
+                            if(!((outVal == background) || ((overlapBehaviour == 1) && (inVal < outVal)) || ((overlapBehaviour == 2) && (inVal > outVal))))
+                            {
+                                continue;
+                            }
                         }
-                    }
-                    delete[] inputData;
-                }
-                if(outputData != NULL)
-                {
-                    for(int i = 0; i < numberBands; i++)
-                    {
-                        if(outputData[i] != NULL)
+                        for(int n = 0; n < numberBands; n++)
                         {
-                            delete[] outputData[i];
+                            outputData[n][outIdx] = inputData[n][inIdx];
                         }
                     }
-                    delete[] outputData;
                 }
-                if(inputRasterBands != NULL)
-                {
-                    delete[] inputRasterBands;
-                }
-
-                GDALClose(dataset);
-			}
-			std::cout << ".complete\n";
+            }
 
-		}
-		catch(RSGISImageBandException &e)
-		{
-            if(inputData != NULL)
+            std::lock_guard<std::mutex> lock(outputMutex);
+            for(int n = 0; n < numberBands; n++)
             {
-                for(int i = 0; i < numberBands; i++)
+                if(outputDataset->GetRasterBand(n+1)->RasterIO(GF_Write, bXOff, bYOff, bWidth, bHeight, &outputData[n][0], bWidth, bHeight, GDT_Float32, 0, 0) != CE_None)
                 {
-                    if(inputData[i] != NULL)
-                    {
-                        delete[] inputData[i];
-                    }
+                    throw RSGISImageException("Could not write to the output image.");
                 }
-                delete[] inputData;
             }
-            if(outputData != NULL)
+            pbar.progress(++numBlocksDone, numBlocks);
+        };
+
+        auto closeOpenDatasets = [&openDatasets, numThreads]()
+        {
+            for(unsigned int i = 0; i < numThreads; ++i)
             {
-                for(int i = 0; i < numberBands; i++)
+                for(std::map<int, GDALDataset*>::iterator iterOpen = openDatasets[i].begin(); iterOpen != openDatasets[i].end(); ++iterOpen)
                 {
-                    if(outputData[i] != NULL)
-                    {
-                        delete[] outputData[i];
-                    }
+                    GDALClose(iterOpen->second);
                 }
-                delete[] outputData;
+                openDatasets[i].clear();
             }
-            if(inputRasterBands != NULL)
+        };
+
+        std::cout << "Started (total " << numDS << " images, " << numBlocks << " blocks)" << std::endl;
+        try
+        {
+            if(numThreads > 1)
             {
-                delete[] inputRasterBands;
+                rsgis::RSGISThreadPool threadPool(numThreads);
+                for(size_t i = 0; i < numBlocks; ++i)
+                {
+                    threadPool.submit([&processBlock, i](unsigned int threadIdx){processBlock(i, threadIdx);});
+                }
+                threadPool.wait();
             }
-            if(outputRasterBands != NULL)
+            else
             {
-                delete[] outputRasterBands;
+                for(size_t i = 0; i < numBlocks; ++i)
+                {
+                    processBlock(i, 0);
+                }
             }
-			if(transformation != NULL)
-			{
-				delete[] transformation;
-			}
-			if(imgTransform != NULL)
-			{
-				delete[] imgTransform;
-			}
-			throw e;
-		}
-
-        // Tidy
-        if(outputRasterBands != NULL)
+        }
+        catch(...)
         {
-            delete[] outputRasterBands;
+            // Close the inputs opened by the threads whatever the error (e.g., std::bad_alloc from a worker).
+            closeOpenDatasets();
+            throw;
         }
+        pbar.finish();
 
-		if(transformation != NULL)
-		{
-			delete[] transformation;
-		}
-		if(imgTransform != NULL)
-		{
-			delete[] imgTransform;
-		}
-		GDALClose(outputDataset);
-	}
+        closeOpenDatasets();
+    }
 
 	void RSGISImageMosaic::includeDatasets(GDALDataset *baseImage, std::string *inputImages, int numDS, std::vector<int> bands, bool bandsDefined)
 	{
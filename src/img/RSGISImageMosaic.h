@@ -30,10 +30,15 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <algorithm>
 
 #include "libkea/KEAImageIO.h"
 
 #include "common/rsgis-tqdm.h"
+#include "common/RSGISThreadPool.h"
 
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
@@ -76,6 +81,9 @@ namespace rsgis{namespace img{
       1 - overwrite mosaic if new pixel value is smaller (min)
       2 - overwrite mosaic if new pixel value is larger (max)
      
+     mosaic, mosaicSkipVals and mosaicSkipThresh create the output one block at a
+     time (in parallel when RSGISThreadPool::getDefaultNumThreads() > 1), reading
+     only the input images which intersect each block.
      */
     {
     public:
@@ -88,6 +96,14 @@ namespace rsgis{namespace img{
         void includeDatasetsIgnoreOverlap(GDALDataset *baseImage, std::string *inputImages, int numDS, int numOverlapPxls);
         void orderInImagesValidData(std::vector<std::string> images, std::vector<std::string> *orderedImages, float noDataValue);
         ~RSGISImageMosaic();
+    protected:
+        /**
+         * Mosaic the input images into the output image (already filled with the background value)
+         * one block at a time. The inputs intersecting each block are combined in memory in the order
+         * given and the block written once.
+         * skipMode: 0 - no values skipped, 1 - skip skipVal, 2 - skip values not between skipLowerThresh and skipUpperThresh (values from skipBand).
+         */
+        void mosaicBlocks(std::string *inputImages, int numDS, GDALDataset *outputDataset, double *transformation, float background, unsigned int skipMode, float skipVal, float skipLowerThresh, float skipUpperThresh, unsigned int skipBand, unsigned int overlapBehaviour);
     };
     
     class DllExport RSGISCountValidPixels : public RSGISCalcImageValue
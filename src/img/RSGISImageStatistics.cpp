@@ -582,6 +582,83 @@ namespace rsgis{namespace img{
 	{
 		calcSD = true;
 	}
+    
+    RSGISCalcImageValue* RSGISCalcImageStatistics::clone()
+    {
+        RSGISCalcImageStatistics *threadCalc = new RSGISCalcImageStatistics(this->numOutBands, this->numInputBands, this->calcSD, this->func, this->useNoData, this->noDataVal, this->onePassSD);
+        if(this->calcSD && !this->onePassSD)
+        {
+            // The second pass of the standard deviation needs the mean from the first pass.
+            threadCalc->calcMean = this->calcMean;
+            for(int i = 0; i < this->numInputBands; ++i)
+            {
+                threadCalc->meanSum[i] = this->meanSum[i];
+                threadCalc->n[i] = this->n[i];
+            }
+        }
+        return threadCalc;
+    }
+    
+    void RSGISCalcImageStatistics::reduce(RSGISCalcImageValue *threadCalc)
+    {
+        RSGISCalcImageStatistics *threadStats = dynamic_cast<RSGISCalcImageStatistics*>(threadCalc);
+        if(threadStats == NULL)
+        {
+            throw RSGISImageCalcException("Thread statistics object is not of the same type so cannot be merged.");
+        }
+        
+        if(!this->calcSD || this->onePassSD)
+        {
+            this->calcMean = this->calcMean || threadStats->calcMean;
+            for(int i = 0; i < this->numInputBands; ++i)
+            {
+                if(!threadStats->firstMean[i])
+                {
+                    if(this->firstMean[i])
+                    {
+                        this->meanSum[i] = threadStats->meanSum[i];
+                        this->min[i] = threadStats->min[i];
+                        this->max[i] = threadStats->max[i];
+                        this->n[i] = threadStats->n[i];
+                        this->firstMean[i] = false;
+                    }
+                    else
+                    {
+                        this->meanSum[i] = this->meanSum[i] + threadStats->meanSum[i];
+                        if(threadStats->min[i] < this->min[i])
+                        {
+                            this->min[i] = threadStats->min[i];
+                        }
+                        if(threadStats->max[i] > this->max[i])
+                        {
+                            this->max[i] = threadStats->max[i];
+                        }
+                        this->n[i] = this->n[i] + threadStats->n[i];
+                    }
+                }
+                this->sumSq[i] = this->sumSq[i] + threadStats->sumSq[i];
+            }
+        }
+        else
+        {
+            for(int i = 0; i < this->numInputBands; ++i)
+            {
+                if(!threadStats->firstSD[i])
+                {
+                    if(this->firstSD[i])
+                    {
+                        this->mean[i] = threadStats->mean[i];
+                        this->sumDiffZ[i] = threadStats->sumDiffZ[i];
+                        this->firstSD[i] = false;
+                    }
+                    else
+                    {
+                        this->sumDiffZ[i] = this->sumDiffZ[i] + threadStats->sumDiffZ[i];
+                    }
+                }
+            }
+        }
+    }
 	
 	RSGISCalcImageStatistics::~RSGISCalcImageStatistics()
 	{
@@ -776,6 +853,83 @@ namespace rsgis{namespace img{
 	{
 		calcSD = true;
 	}
+    
+    RSGISCalcImageValue* RSGISCalcImageStatisticsNoData::clone()
+    {
+        RSGISCalcImageStatisticsNoData *threadCalc = new RSGISCalcImageStatisticsNoData(this->numInputBands, this->calcSD, this->func, this->noDataSpecified, this->noDataVal, this->onePassSD);
+        if(this->calcSD && !this->onePassSD)
+        {
+            // The second pass of the standard deviation needs the mean from the first pass.
+            threadCalc->calcMean = this->calcMean;
+            for(int i = 0; i < this->numInputBands; ++i)
+            {
+                threadCalc->meanSum[i] = this->meanSum[i];
+                threadCalc->n[i] = this->n[i];
+            }
+        }
+        return threadCalc;
+    }
+    
+    void RSGISCalcImageStatisticsNoData::reduce(RSGISCalcImageValue *threadCalc)
+    {
+        RSGISCalcImageStatisticsNoData *threadStats = dynamic_cast<RSGISCalcImageStatisticsNoData*>(threadCalc);
+        if(threadStats == NULL)
+        {
+            throw RSGISImageCalcException("Thread statistics object is not of the same type so cannot be merged.");
+        }
+        
+        if(!this->calcSD || this->onePassSD)
+        {
+            this->calcMean = this->calcMean || threadStats->calcMean;
+            for(int i = 0; i < this->numInputBands; ++i)
+            {
+                if(!threadStats->firstMean[i])
+                {
+                    if(this->firstMean[i])
+                    {
+                        this->meanSum[i] = threadStats->meanSum[i];
+                        this->min[i] = threadStats->min[i];
+                        this->max[i] = threadStats->max[i];
+                        this->n[i] = threadStats->n[i];
+                        this->firstMean[i] = false;
+                    }
+                    else
+                    {
+                        this->meanSum[i] = this->meanSum[i] + threadStats->meanSum[i];
+                        if(threadStats->min[i] < this->min[i])
+                        {
+                            this->min[i] = threadStats->min[i];
+                        }
+                        if(threadStats->max[i] > this->max[i])
+                        {
+                            this->max[i] = threadStats->max[i];
+                        }
+                        this->n[i] = this->n[i] + threadStats->n[i];
+                    }
+                }
+                this->sumSq[i] = this->sumSq[i] + threadStats->sumSq[i];
+            }
+        }
+        else
+        {
+            for(int i = 0; i < this->numInputBands; ++i)
+            {
+                if(!threadStats->firstSD[i])
+                {
+                    if(this->firstSD[i])
+                    {
+                        this->mean[i] = threadStats->mean[i];
+                        this->sumDiffZ[i] = threadStats->sumDiffZ[i];
+                        this->firstSD[i] = false;
+                    }
+                    else
+                    {
+                        this->sumDiffZ[i] = this->sumDiffZ[i] + threadStats->sumDiffZ[i];
+                    }
+                }
+            }
+        }
+    }
 	
 	RSGISCalcImageStatisticsNoData::~RSGISCalcImageStatisticsNoData()
 	{
@@ -945,19 +1099,20 @@ namespace rsgis{namespace img{
         
     }
     
-    rsgis::math::Matrix* RSGISImagePercentiles::getPercentilesForAllBands(GDALDataset* dataset, float percentile, float noDataVal, bool noDataDefined)
+    rsgis::math::Matrix* RSGISImagePercentiles::getPercentilesForAllBands(GDALDataset* dataset, float percentile, float noDataVal, bool noDataDefined, bool useSketch, unsigned int sketchK)
     {
         rsgis::math::RSGISMatrices matrixUtils;
         rsgis::math::Matrix *outPercentiles = NULL;
         try
         {
             unsigned numImageBands = dataset->GetRasterCount();
+            std::cout << "\tCalculating Percentile " << percentile << " of " << numImageBands << " bands" << std::endl;
+            std::vector< std::vector<double> > bandPercentiles = this->getPercentilesForAllBands(dataset, std::vector<float>(1, percentile), noDataVal, noDataDefined, useSketch, sketchK);
             outPercentiles = matrixUtils.createMatrix(numImageBands, 1);
             for(unsigned int n = 0; n < numImageBands; ++n)
             {
-                std::cout << "\tCalculating Percentile " << percentile << " of band " << n+1 << std::flush;
-                outPercentiles->matrix[n] = this->getPercentile(dataset, n+1, percentile, noDataVal, noDataDefined);
-                std::cout << " = " << outPercentiles->matrix[n] << std::endl;
+                outPercentiles->matrix[n] = bandPercentiles[n][0];
+                std::cout << "\tBand " << n+1 << " = " << outPercentiles->matrix[n] << std::endl;
             }
         }
         catch (rsgis::RSGISImageException &e)
@@ -976,51 +1131,187 @@ namespace rsgis{namespace img{
         return outPercentiles;
     }
     
-    double RSGISImagePercentiles::getPercentile(GDALDataset *dataset, unsigned int band, float percentile, float noDataVal, bool noDataDefined)
+    std::vector< std::vector<double> > RSGISImagePercentiles::getPercentilesForAllBands(GDALDataset* dataset, std::vector<float> percentiles, float noDataVal, bool noDataDefined, bool useSketch, unsigned int sketchK)
     {
-        double percentileVal = 0.0;
-        try
+        std::vector<unsigned int> bands;
+        for(int n = 0; n < dataset->GetRasterCount(); ++n)
         {
-            RSGISImageUtils imageUtils;
-            std::vector<double> *dataVals = imageUtils.getImageBandValues(dataset, band, noDataDefined, noDataVal);
-            std::sort(dataVals->begin(), dataVals->end());            
-            percentileVal = gsl_stats_quantile_from_sorted_data(&(*dataVals)[0], 1, dataVals->size(), percentile);
-            delete dataVals;
+            bands.push_back(n+1);
         }
-        catch (rsgis::RSGISImageException &e)
-        {
-            throw e;
-        }
-        catch (rsgis::RSGISException &e)
-        {
-            throw rsgis::RSGISImageException(e.what());
-        }
-        catch (std::exception &e)
-        {
-            throw rsgis::RSGISImageException(e.what());
-        }
-        
-        return percentileVal;
+        return this->calcPercentiles(dataset, bands, percentiles, noDataVal, noDataDefined, NULL, 0, NULL, false, useSketch, sketchK);
+    }
+    
+    double RSGISImagePercentiles::getPercentile(GDALDataset *dataset, unsigned int band, float percentile, float noDataVal, bool noDataDefined)
+    {
+        std::vector< std::vector<double> > percentileVals = this->calcPercentiles(dataset, std::vector<unsigned int>(1, band), std::vector<float>(1, percentile), noDataVal, noDataDefined, NULL, 0, NULL, false, false, 0);
+        return percentileVals[0][0];
     }
     
     double RSGISImagePercentiles::getPercentile(GDALDataset *dataset, unsigned int band, GDALDataset *maskDS, int maskVal, float percentile, float noDataVal, bool noDataDefined)
     {
-        double percentileVal = 0.0;
+        std::vector< std::vector<double> > percentileVals = this->calcPercentiles(dataset, std::vector<unsigned int>(1, band), std::vector<float>(1, percentile), noDataVal, noDataDefined, maskDS, maskVal, NULL, false, false, 0);
+        return percentileVals[0][0];
+    }
+    
+    double RSGISImagePercentiles::getPercentile(GDALDataset *dataset, unsigned int band, GDALDataset *maskDS, int maskVal, float percentile, float noDataVal, bool noDataDefined, geos::geom::Envelope *env, bool quiet)
+    {
+        std::vector< std::vector<double> > percentileVals = this->calcPercentiles(dataset, std::vector<unsigned int>(1, band), std::vector<float>(1, percentile), noDataVal, noDataDefined, maskDS, maskVal, env, quiet, false, 0);
+        return percentileVals[0][0];
+    }
+    
+    std::vector< std::vector<double> > RSGISImagePercentiles::calcPercentiles(GDALDataset *dataset, std::vector<unsigned int> bands, std::vector<float> percentiles, float noDataVal, bool noDataDefined, GDALDataset *maskDS, int maskVal, geos::geom::Envelope *env, bool quiet, bool useSketch, unsigned int sketchK)
+    {
+        std::vector< std::vector<double> > outVals;
         try
         {
-            std::vector<double> *dataVals = new std::vector<double>();
-            
-            RSGISGetPixelBandValues calcGetBandVals = RSGISGetPixelBandValues(dataVals, band, maskVal, noDataVal, noDataDefined);
-            RSGISCalcImage calcImg = RSGISCalcImage(&calcGetBandVals, "", true);
+            std::vector<unsigned int> bandIdxs;
+            for(std::vector<unsigned int>::iterator iterBand = bands.begin(); iterBand != bands.end(); ++iterBand)
+            {
+                if(((*iterBand) == 0) | ((*iterBand) > dataset->GetRasterCount()))
+                {
+                    throw rsgis::RSGISImageException("Band is not within the image; note band numbering starts at 1.");
+                }
+                bandIdxs.push_back((*iterBand)-1);
+            }
+            for(std::vector<float>::iterator iterPercent = percentiles.begin(); iterPercent != percentiles.end(); ++iterPercent)
+            {
+                if(((*iterPercent) < 0) | ((*iterPercent) > 1))
+                {
+                    throw rsgis::RSGISImageException("Percentile value must be between 0 - 1.");
+                }
+            }
+            if(useSketch & (sketchK < 8))
+            {
+                throw rsgis::RSGISImageException("The sketch size (k) must be at least 8.");
+            }
             
             GDALDataset **datasets = new GDALDataset*[2];
             datasets[0] = maskDS;
             datasets[1] = dataset;
-            calcImg.calcImage(datasets, 1, 1);
+            bool useMask = (maskDS != NULL);
+            // Runs a pass over the image (or the area within the mask and envelope).
+            auto runPass = [&](RSGISCalcPercentileCounts *calcCounts)
+            {
+                RSGISCalcImage calcImg = RSGISCalcImage(calcCounts, "", true);
+                if(!useMask)
+                {
+                    calcImg.calcImage(&datasets[1], 1);
+                }
+                else if(env != NULL)
+                {
+                    calcImg.calcImageInEnv(datasets, 1, 1, env, quiet);
+                }
+                else
+                {
+                    calcImg.calcImage(datasets, 1, 1);
+                }
+            };
             
-            std::sort(dataVals->begin(), dataVals->end());
-            percentileVal = gsl_stats_quantile_from_sorted_data(&(*dataVals)[0], 1, dataVals->size(), percentile);
-            delete dataVals;
+            // The pairs of ranks (and the weight of the second) for each percentile, for n values.
+            auto getRanks = [&](boost::uint_fast64_t n, float percentile, boost::uint_fast64_t *lhs, boost::uint_fast64_t *rhs, double *delta)
+            {
+                double index = percentile * (n - 1.0);
+                *lhs = (boost::uint_fast64_t) floor(index);
+                *delta = index - (*lhs);
+                *rhs = ((*lhs)+1 < n)?((*lhs)+1):(*lhs);
+            };
+            
+            outVals.resize(bands.size(), std::vector<double>(percentiles.size(), std::numeric_limits<double>::quiet_NaN()));
+            if(useSketch)
+            {
+                RSGISCalcPercentileCounts calcSketches = RSGISCalcPercentileCounts(bandIdxs, RSGISCalcPercentileCounts::quantileSketch, noDataVal, noDataDefined, useMask, maskVal, sketchK);
+                runPass(&calcSketches);
+                for(unsigned int i = 0; i < bands.size(); ++i)
+                {
+                    const rsgis::math::RSGISQuantileSketch &sketch = calcSketches.getSketch(i);
+                    if(sketch.getNumValues() == 0)
+                    {
+                        continue;
+                    }
+                    for(unsigned int p = 0; p < percentiles.size(); ++p)
+                    {
+                        boost::uint_fast64_t lhs, rhs;
+                        double delta;
+                        getRanks(sketch.getNumValues(), percentiles[p], &lhs, &rhs, &delta);
+                        outVals[i][p] = ((1 - delta) * sketch.getValueAtRank(lhs)) + (delta * sketch.getValueAtRank(rhs));
+                    }
+                }
+            }
+            else
+            {
+                // First pass: find the bin of the upper 16 bits of the key for each of the ranks.
+                RSGISCalcPercentileCounts calcUpper = RSGISCalcPercentileCounts(bandIdxs, RSGISCalcPercentileCounts::upperKeyHistogram, noDataVal, noDataDefined, useMask, maskVal, 0);
+                runPass(&calcUpper);
+                
+                std::vector< std::vector<boost::uint_fast64_t> > ranks(bands.size());
+                std::vector< std::vector<double> > deltas(bands.size());
+                std::vector< std::vector<unsigned int> > rankUpperKeys(bands.size());
+                std::vector< std::vector<boost::uint_fast64_t> > rankInUpperBins(bands.size());
+                std::vector< std::vector<unsigned int> > upperKeys(bands.size());
+                for(unsigned int i = 0; i < bands.size(); ++i)
+                {
+                    const std::vector<boost::uint_fast64_t> &upperCounts = calcUpper.getCounts(i);
+                    boost::uint_fast64_t n = 0;
+                    for(unsigned int k = 0; k < RSGISCalcPercentileCounts::numKeyBins; ++k)
+                    {
+                        n += upperCounts[k];
+                    }
+                    if(n == 0)
+                    {
+                        continue;
+                    }
+                    for(unsigned int p = 0; p < percentiles.size(); ++p)
+                    {
+                        boost::uint_fast64_t lhs, rhs;
+                        double delta;
+                        getRanks(n, percentiles[p], &lhs, &rhs, &delta);
+                        ranks[i].push_back(lhs);
+                        ranks[i].push_back(rhs);
+                        deltas[i].push_back(delta);
+                    }
+                    for(std::vector<boost::uint_fast64_t>::iterator iterRank = ranks[i].begin(); iterRank != ranks[i].end(); ++iterRank)
+                    {
+                        boost::uint_fast64_t cumCount = 0;
+                        unsigned int k = 0;
+                        while((cumCount + upperCounts[k]) <= (*iterRank))
+                        {
+                            cumCount += upperCounts[k++];
+                        }
+                        rankUpperKeys[i].push_back(k);
+                        rankInUpperBins[i].push_back((*iterRank) - cumCount);
+                        if(std::find(upperKeys[i].begin(), upperKeys[i].end(), k) == upperKeys[i].end())
+                        {
+                            upperKeys[i].push_back(k);
+                        }
+                    }
+                }
+                
+                // Second pass: count the lower 16 bits of the keys within the bins found.
+                RSGISCalcPercentileCounts calcLower = RSGISCalcPercentileCounts(bandIdxs, RSGISCalcPercentileCounts::lowerKeyHistogram, noDataVal, noDataDefined, useMask, maskVal, 0, upperKeys);
+                runPass(&calcLower);
+                
+                for(unsigned int i = 0; i < bands.size(); ++i)
+                {
+                    std::vector<double> rankVals;
+                    for(unsigned int r = 0; r < ranks[i].size(); ++r)
+                    {
+                        unsigned int j = std::find(upperKeys[i].begin(), upperKeys[i].end(), rankUpperKeys[i][r]) - upperKeys[i].begin();
+                        const std::vector<boost::uint_fast64_t> &lowerCounts = calcLower.getCounts(i, j);
+                        boost::uint_fast64_t cumCount = 0;
+                        unsigned int k = 0;
+                        while((k < (RSGISCalcPercentileCounts::numKeyBins-1)) && ((cumCount + lowerCounts[k]) <= rankInUpperBins[i][r]))
+                        {
+                            cumCount += lowerCounts[k++];
+                        }
+                        rankVals.push_back(RSGISCalcPercentileCounts::keyToFloat((rankUpperKeys[i][r] << 16) | k));
+                    }
+                    for(unsigned int p = 0; p < deltas[i].size(); ++p)
+                    {
+                        outVals[i][p] = ((1 - deltas[i][p]) * rankVals[p*2]) + (deltas[i][p] * rankVals[(p*2)+1]);
+                    }
+                }
+            }
+            delete[] datasets;
         }
         catch (rsgis::RSGISImageException &e)
         {
@@ -1035,50 +1326,131 @@ namespace rsgis{namespace img{
             throw rsgis::RSGISImageException(e.what());
         }
         
-        return percentileVal;
+        return outVals;
     }
     
-    double RSGISImagePercentiles::getPercentile(GDALDataset *dataset, unsigned int band, GDALDataset *maskDS, int maskVal, float percentile, float noDataVal, bool noDataDefined, geos::geom::Envelope *env, bool quiet)
+    RSGISImagePercentiles::~RSGISImagePercentiles()
     {
-        double percentileVal = 0.0;
-        try
+        
+    }
+	
+    
+    
+    RSGISCalcPercentileCounts::RSGISCalcPercentileCounts(std::vector<unsigned int> bandIdxs, PercentilePass pass, float noDataVal, bool noDataDefined, bool useMask, int maskVal, unsigned int sketchK, std::vector< std::vector<unsigned int> > upperKeys):RSGISCalcImageValue(0)
+    {
+        this->bandIdxs = bandIdxs;
+        this->pass = pass;
+        this->noDataVal = noDataVal;
+        this->noDataDefined = noDataDefined;
+        this->useMask = useMask;
+        this->maskVal = maskVal;
+        this->sketchK = sketchK;
+        this->upperKeys = upperKeys;
+        this->numCounted = 0;
+        if(pass == upperKeyHistogram)
         {
-            std::vector<double> *dataVals = new std::vector<double>();
-            
-            RSGISGetPixelBandValues calcGetBandVals = RSGISGetPixelBandValues(dataVals, band, maskVal, noDataVal, noDataDefined);
-            RSGISCalcImage calcImg = RSGISCalcImage(&calcGetBandVals, "", true);
-            
-            GDALDataset **datasets = new GDALDataset*[2];
-            datasets[0] = maskDS;
-            datasets[1] = dataset;
-            calcImg.calcImageInEnv(datasets, 1, 1, env, quiet);
-            
-            std::sort(dataVals->begin(), dataVals->end());
-            percentileVal = gsl_stats_quantile_from_sorted_data(&(*dataVals)[0], 1, dataVals->size(), percentile);
-            delete dataVals;
+            for(unsigned int i = 0; i < bandIdxs.size(); ++i)
+            {
+                this->countsIdx.push_back(i);
+            }
+            this->counts.resize(bandIdxs.size(), std::vector<boost::uint32_t>(numKeyBins, 0));
         }
-        catch (rsgis::RSGISImageException &e)
+        else if(pass == lowerKeyHistogram)
         {
-            throw e;
+            if(this->upperKeys.size() != bandIdxs.size())
+            {
+                throw RSGISImageCalcException("The upper keys must be provided for each band.");
+            }
+            size_t numCounts = 0;
+            for(unsigned int i = 0; i < bandIdxs.size(); ++i)
+            {
+                this->countsIdx.push_back(numCounts);
+                numCounts += this->upperKeys[i].size();
+            }
+            this->counts.resize(numCounts, std::vector<boost::uint32_t>(numKeyBins, 0));
         }
-        catch (rsgis::RSGISException &e)
+        else
         {
-            throw rsgis::RSGISImageException(e.what());
+            this->sketches.resize(bandIdxs.size(), rsgis::math::RSGISQuantileSketch(sketchK));
         }
-        catch (std::exception &e)
+    }
+    
+    void RSGISCalcPercentileCounts::calcImageValue(float *bandValues, int numBands)
+    {
+        for(unsigned int i = 0; i < this->bandIdxs.size(); ++i)
         {
-            throw rsgis::RSGISImageException(e.what());
+            this->addValue(i, bandValues[this->bandIdxs[i]]);
         }
-        
-        return percentileVal;
     }
     
-    RSGISImagePercentiles::~RSGISImagePercentiles()
+    void RSGISCalcPercentileCounts::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals)
     {
-        
+        if(this->useMask && (intBandValues[0] != this->maskVal))
+        {
+            return;
+        }
+        for(unsigned int i = 0; i < this->bandIdxs.size(); ++i)
+        {
+            this->addValue(i, floatBandValues[this->bandIdxs[i]]);
+        }
     }
-	
     
+    RSGISCalcImageValue* RSGISCalcPercentileCounts::clone()
+    {
+        return new RSGISCalcPercentileCounts(this->bandIdxs, this->pass, this->noDataVal, this->noDataDefined, this->useMask, this->maskVal, this->sketchK, this->upperKeys);
+    }
+    
+    void RSGISCalcPercentileCounts::reduce(RSGISCalcImageValue *threadCalc)
+    {
+        RSGISCalcPercentileCounts *threadCounts = dynamic_cast<RSGISCalcPercentileCounts*>(threadCalc);
+        if(threadCounts == NULL)
+        {
+            throw RSGISImageCalcException("Can only reduce a RSGISCalcPercentileCounts object.");
+        }
+        if(!this->counts.empty())
+        {
+            this->addCountsToTotals();
+            for(size_t c = 0; c < this->counts.size(); ++c)
+            {
+                for(unsigned int k = 0; k < numKeyBins; ++k)
+                {
+                    this->totals[c][k] += threadCounts->counts[c][k];
+                }
+                if(!threadCounts->totals.empty())
+                {
+                    for(unsigned int k = 0; k < numKeyBins; ++k)
+                    {
+                        this->totals[c][k] += threadCounts->totals[c][k];
+                    }
+                }
+            }
+        }
+        for(size_t i = 0; i < this->sketches.size(); ++i)
+        {
+            this->sketches[i].merge(threadCounts->sketches[i]);
+        }
+    }
+    
+    void RSGISCalcPercentileCounts::addCountsToTotals()
+    {
+        if((this->numCounted == 0) && !this->totals.empty())
+        {
+            return;
+        }
+        if(this->totals.empty())
+        {
+            this->totals.resize(this->counts.size(), std::vector<boost::uint_fast64_t>(numKeyBins, 0));
+        }
+        for(size_t c = 0; c < this->counts.size(); ++c)
+        {
+            for(unsigned int k = 0; k < numKeyBins; ++k)
+            {
+                this->totals[c][k] += this->counts[c][k];
+                this->counts[c][k] = 0;
+            }
+        }
+        this->numCounted = 0;
+    }
     
     void RSGISGetPixelBandValues::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) 
     {
@@ -25,6 +25,10 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <cstring>
+#include <limits>
+#include <algorithm>
 #include <math.h>
 
 #include "gdal_priv.h"
@@ -39,10 +43,12 @@
 #include "math/RSGISMathFunction.h"
 #include "math/RSGISMatrices.h"
 #include "math/RSGISMathsUtils.h"
+#include "math/RSGISQuantileSketch.h"
 
 #include "gsl/gsl_statistics_double.h"
 
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <boost/cstdint.hpp>
 
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
@@ -98,6 +104,8 @@ namespace rsgis{namespace img{
         bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("Not implemented");};
         void getImageStats(ImageStats** inStats, int numInputBands);
         void calcStdDev();
+        RSGISCalcImageValue* clone();
+        void reduce(RSGISCalcImageValue *threadCalc);
         ~RSGISCalcImageStatistics();
     protected:
         bool useNoData;
@@ -135,6 +143,8 @@ namespace rsgis{namespace img{
         bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("Not implemented");};
         void getImageStats(ImageStats** inStats, int numInputBands);
         void calcStdDev();
+        RSGISCalcImageValue* clone();
+        void reduce(RSGISCalcImageValue *threadCalc);
         ~RSGISCalcImageStatisticsNoData();
     protected:
         bool noDataSpecified;
@@ -191,15 +201,141 @@ namespace rsgis{namespace img{
         
     };
     
+    /**
+     * Percentiles (0 - 1, interpolated between ranks as gsl_stats_quantile_from_sorted_data)
+     * of image bands, calculated without holding the pixel values in memory.
+     *
+     * The exact method reads the image twice: each value is mapped to an order preserving
+     * 32 bit key and the first pass counts the upper 16 bits of the keys, which identifies
+     * the bin holding each of the ranks needed; the second pass counts the lower 16 bits of
+     * the keys within those bins, giving the value at each rank. The sketch method reads the
+     * image once, adding the values to a quantile sketch (RSGISQuantileSketch) for each band.
+     * In both cases all the percentiles of all the bands are found from the same reads.
+     * No data and NaN values are ignored; bands without any values give NaN.
+     *
+     * Only the passes over the whole image (no mask) are split between threads (see
+     * RSGISCalcImage::calcImage); with a mask or envelope the image is read by one thread.
+     */
     class DllExport RSGISImagePercentiles
     {
     public:
         RSGISImagePercentiles();
-        rsgis::math::Matrix* getPercentilesForAllBands(GDALDataset* dataset, float percentile, float noDataVal, bool noDataDefined);
+        rsgis::math::Matrix* getPercentilesForAllBands(GDALDataset* dataset, float percentile, float noDataVal, bool noDataDefined, bool useSketch=false, unsigned int sketchK=200);
+        /** Returns the percentiles for each band, i.e., [band][percentile]. */
+        std::vector< std::vector<double> > getPercentilesForAllBands(GDALDataset* dataset, std::vector<float> percentiles, float noDataVal, bool noDataDefined, bool useSketch=false, unsigned int sketchK=200);
         double getPercentile(GDALDataset *dataset, unsigned int band, float percentile, float noDataVal, bool noDataDefined);
         double getPercentile(GDALDataset *dataset, unsigned int band, GDALDataset *maskDS, int maskVal, float percentile, float noDataVal, bool noDataDefined);
         double getPercentile(GDALDataset *dataset, unsigned int band, GDALDataset *maskDS, int maskVal, float percentile, float noDataVal, bool noDataDefined, geos::geom::Envelope *env, bool quiet=false);
         ~RSGISImagePercentiles();
+    protected:
+        /** bands are numbered from 1; maskDS can be NULL and env can be NULL. */
+        std::vector< std::vector<double> > calcPercentiles(GDALDataset *dataset, std::vector<unsigned int> bands, std::vector<float> percentiles, float noDataVal, bool noDataDefined, GDALDataset *maskDS, int maskVal, geos::geom::Envelope *env, bool quiet, bool useSketch, unsigned int sketchK);
+    };
+    
+    /**
+     * Accumulates the band values for RSGISImagePercentiles, as counts of the upper 16 bits
+     * of the keys of the values (upperKeyHistogram), counts of the lower 16 bits of the keys
+     * of the values with selected upper 16 bits (lowerKeyHistogram) or a quantile sketch
+     * (quantileSketch). Without a mask the bands are those of the only input image; with a
+     * mask the first image is the mask and only pixels with maskVal are used.
+     *
+     * The counts are held as 32 bit values (moved to 64 bit totals before they could overflow
+     * and when read using getCounts), so each thread's copy needs 256 KB for each band in the
+     * upperKeyHistogram pass (e.g., 50 MB for 200 bands) and for each band and upper key in
+     * the lowerKeyHistogram pass.
+     */
+    class DllExport RSGISCalcPercentileCounts : public RSGISCalcImageValue
+    {
+    public:
+        enum PercentilePass
+        {
+            upperKeyHistogram,
+            lowerKeyHistogram,
+            quantileSketch
+        };
+        static const unsigned int numKeyBins = 65536;
+        /** bandIdxs are numbered from 0. */
+        RSGISCalcPercentileCounts(std::vector<unsigned int> bandIdxs, PercentilePass pass, float noDataVal, bool noDataDefined, bool useMask, int maskVal, unsigned int sketchK, std::vector< std::vector<unsigned int> > upperKeys=std::vector< std::vector<unsigned int> >());
+        void calcImageValue(float *bandValues, int numBands);
+        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals);
+        RSGISCalcImageValue* clone();
+        void reduce(RSGISCalcImageValue *threadCalc);
+        /** For upperKeyHistogram the counts for band i; for lowerKeyHistogram the counts for band i and upperKeys[i][j]. */
+        const std::vector<boost::uint_fast64_t>& getCounts(unsigned int i, unsigned int j=0)
+        {
+            this->addCountsToTotals();
+            return this->totals[this->countsIdx[i]+j];
+        };
+        const rsgis::math::RSGISQuantileSketch& getSketch(unsigned int i) const {return this->sketches[i];};
+        static inline boost::uint32_t floatToKey(float val)
+        {
+            boost::uint32_t bits = 0;
+            std::memcpy(&bits, &val, sizeof(float));
+            return (bits & 0x80000000u)?(~bits):(bits | 0x80000000u);
+        };
+        static inline float keyToFloat(boost::uint32_t key)
+        {
+            boost::uint32_t bits = (key & 0x80000000u)?(key & 0x7FFFFFFFu):(~key);
+            float val = 0;
+            std::memcpy(&val, &bits, sizeof(float));
+            return val;
+        };
+        ~RSGISCalcPercentileCounts(){};
+    protected:
+        inline void addValue(unsigned int i, float val)
+        {
+            if((boost::math::isnan)(val) || (this->noDataDefined && (val == this->noDataVal)))
+            {
+                return;
+            }
+            if(this->pass == quantileSketch)
+            {
+                this->sketches[i].add(val);
+                return;
+            }
+            boost::uint32_t key = floatToKey(val);
+            if(this->pass == upperKeyHistogram)
+            {
+                ++this->counts[i][key >> 16];
+            }
+            else
+            {
+                const std::vector<unsigned int> &bandUpperKeys = this->upperKeys[i];
+                unsigned int j = 0;
+                for(; j < bandUpperKeys.size(); ++j)
+                {
+                    if(bandUpperKeys[j] == (key >> 16))
+                    {
+                        ++this->counts[this->countsIdx[i]+j][key & 0xFFFFu];
+                        break;
+                    }
+                }
+                if(j == bandUpperKeys.size())
+                {
+                    return;
+                }
+            }
+            // No count can be larger than the number of values counted.
+            if(++this->numCounted == std::numeric_limits<boost::uint32_t>::max())
+            {
+                this->addCountsToTotals();
+            }
+        };
+        /** Add the 32 bit counts to the 64 bit totals (allocated when first needed) and reset them. */
+        void addCountsToTotals();
+        std::vector<unsigned int> bandIdxs;
+        PercentilePass pass;
+        float noDataVal;
+        bool noDataDefined;
+        bool useMask;
+        int maskVal;
+        unsigned int sketchK;
+        std::vector< std::vector<unsigned int> > upperKeys;
+        std::vector<size_t> countsIdx;
+        std::vector< std::vector<boost::uint32_t> > counts;
+        boost::uint32_t numCounted;
+        std::vector< std::vector<boost::uint_fast64_t> > totals;
+        std::vector<rsgis::math::RSGISQuantileSketch> sketches;
     };
     
     
@@ -60,28 +60,15 @@ namespace rsgis{namespace img{
                 throw RSGISImageCalcException("The number of endmember samples should be less than the number of input image bands.");
             }
             
-            gsl_matrix *V = gsl_matrix_alloc (endmembers->size2, endmembers->size2);
-            gsl_vector *S = gsl_vector_alloc(endmembers->size2);
-            gsl_vector *work = gsl_vector_alloc(endmembers->size2);
-            int status = gsl_linalg_SV_decomp(endmembers, V, S, work);
-            if(status != 0)
-            {
-                throw RSGISImageCalcException(gsl_strerror(status));
-            }
+            gsl_matrix *pInv = this->calcPseudoInverse(endmembers);
             
-            gsl_vector *b = gsl_vector_alloc(endmembers->size1);
-            gsl_vector *x = gsl_vector_alloc(endmembers->size2);
-            
-            RSGISUnconstrainedLinearSpectralUnmixing *calcUnconstrained = new RSGISUnconstrainedLinearSpectralUnmixing(endmembers->size2, endmembers, V, S, work, b, x, this->gain, this->offset);
+            RSGISPseudoInverseSpectralUnmixing *calcUnconstrained = new RSGISPseudoInverseSpectralUnmixing(endmembers->size2, pInv, NULL, this->gain, this->offset);
             RSGISCalcImage calcImage(calcUnconstrained);
             calcImage.calcImage(datasets, numDatasets, outputImage, false, NULL, gdalFormat, gdalDataType);
             
+            delete calcUnconstrained;
             gsl_matrix_free(endmembers);
-            gsl_matrix_free(V);
-            gsl_vector_free(S);
-            gsl_vector_free(work);
-            gsl_vector_free(b);
-            gsl_vector_free(x);
+            gsl_matrix_free(pInv);
             
         }
         catch(RSGISException &e)
@@ -133,29 +120,31 @@ namespace rsgis{namespace img{
             }
             
             
-            gsl_matrix *V = gsl_matrix_alloc (endmembers->size2, endmembers->size2);
-            gsl_vector *S = gsl_vector_alloc(endmembers->size2);
-            gsl_vector *work = gsl_vector_alloc(endmembers->size2);
-            int status = gsl_linalg_SV_decomp(endmembers, V, S, work);
-            if(status != 0)
+            gsl_matrix *pInvWeight = this->calcPseudoInverse(endmembers);
+            
+            // The pixel value for the weight row is always the weight so its
+            // contribution is the same constant for all the pixels.
+            gsl_matrix *pInv = gsl_matrix_alloc(endmembersIn->size2, endmembersIn->size1);
+            gsl_vector *constTerm = gsl_vector_alloc(endmembersIn->size2);
+            for(unsigned int i = 0; i < endmembersIn->size2; ++i)
             {
-                throw RSGISImageCalcException(gsl_strerror(status));
+                for(unsigned int j = 0; j < endmembersIn->size1; ++j)
+                {
+                    gsl_matrix_set(pInv, i, j, gsl_matrix_get(pInvWeight, i, j));
+                }
+                gsl_vector_set(constTerm, i, gsl_matrix_get(pInvWeight, i, endmembersIn->size1) * weight);
             }
             
-            gsl_vector *b = gsl_vector_alloc(endmembers->size1);
-            gsl_vector *x = gsl_vector_alloc(endmembers->size2);
-            
-            RSGISPartConstrainedLinearSpectralUnmixing *calcPartConstrained = new RSGISPartConstrainedLinearSpectralUnmixing(endmembers->size2, weight, endmembers, V, S, work, b, x, this->gain, this->offset);
+            RSGISPseudoInverseSpectralUnmixing *calcPartConstrained = new RSGISPseudoInverseSpectralUnmixing(endmembersIn->size2, pInv, constTerm, this->gain, this->offset);
             RSGISCalcImage calcImage(calcPartConstrained);
             calcImage.calcImage(datasets, numDatasets, outputImage, false, NULL, gdalFormat, gdalDataType);
             
+            delete calcPartConstrained;
             gsl_matrix_free(endmembersIn);
             gsl_matrix_free(endmembers);
-            gsl_matrix_free(V);
-            gsl_vector_free(S);
-            gsl_vector_free(work);
-            gsl_vector_free(b);
-            gsl_vector_free(x);
+            gsl_matrix_free(pInvWeight);
+            gsl_matrix_free(pInv);
+            gsl_vector_free(constTerm);
             
         }
         catch(RSGISException &e)
@@ -174,7 +163,6 @@ namespace rsgis{namespace img{
                 numOfImageBands += datasets[i]->GetRasterCount();
             }            
             
-            rsgis::math::RSGISVectors vecUtils;
             rsgis::math::RSGISMatrices matrixUtils;
             gsl_matrix *endmembersIn = matrixUtils.readGSLMatrixFromTxt(endmembersFilePath);
             matrixUtils.printGSLMatrix(endmembersIn);
@@ -182,6 +170,7 @@ namespace rsgis{namespace img{
             
             if(endmembersIn->size1 != numOfImageBands)
             {
+                gsl_matrix_free(endmembersIn);
                 throw RSGISImageCalcException("The number of image bands and wavelengths within the endmemebers should match.");
             }
             
@@ -190,93 +179,13 @@ namespace rsgis{namespace img{
                 gsl_matrix_free(endmembersIn);
                 throw RSGISImageCalcException("The number of endmember samples should be less than the number of input image bands.");
             }
-                                    
-            int m = endmembersIn->size1+1;
-            int n = endmembersIn->size2;
-            
-            std::cout << "m = " << m << std::endl;
-            std::cout << "n = " << n << std::endl;
-            
-            int mda = m;
-            
-            double* a = new double[m*n];
-            double *b = new double[m];
-            double *x = new double[n];
-            double rNorm = 0;
-            double *w = new double[n];
-            double *zz = new double[m];
-            int *index = new int[n];
-            int mode = 0;
-            
-            for(unsigned int i = 0; i < endmembersIn->size1; ++i)
-            {
-                for(unsigned int j = 0; j < endmembersIn->size2; ++j)
-                {
-                    a[(i*endmembersIn->size2)+j] = gsl_matrix_get(endmembersIn, i, j);
-                }
-            }
-            for(unsigned int j = 0; j < endmembersIn->size2; ++j)
-            {
-                a[(endmembersIn->size1*endmembersIn->size2)+j] = weight;
-            }
             
-            for(unsigned int i = 0; i < m; ++i)
-            {
-                for(unsigned int j = 0; j < n; ++j)
-                {
-                    if( j == 0 )
-                    {
-                        std::cout << a[(i*n)+j];
-                    }
-                    else
-                    {
-                        std::cout << "," << a[(i*n)+j];
-                    }
-                }
-                std::cout << "\n";
-            }
+            RSGISNNLSSpectralUnmixing *calcNNLS = new RSGISNNLSSpectralUnmixing(endmembersIn->size2, endmembersIn, weight, this->gain, this->offset);
+            RSGISCalcImage calcImage(calcNNLS);
+            calcImage.calcImage(datasets, numDatasets, outputImage, false, NULL, gdalFormat, gdalDataType);
             
-            float e1 = 0.5;
-            float e2 = 0.2;
-            float e3 = 0.3;
-            b[0] = ((50.4*e1)+(29.45*e2)+(209.964*e3));
-            b[1] = ((81.85*e1)+(65.45*e2)+(244.321*e3));
-            b[2] = ((107.85*e1)+(23.4*e2)+(267.25*e3));
-            b[3] = ((177.1*e1)+(112.8*e2)+(278.679*e3));
-            b[4] = ((281.35*e1)+(524.2*e2)+(305.429*e3));
-            b[5] = ((324.2*e1)+(653.25*e2)+(299.036*e3));
-            b[6] = ((362.45*e1)+(680.6*e2)+(309.036*e3));
-            b[7] = ((394.55*e1)+(692.25*e2)+(303.036*e3));
-            b[8] = ((404.55*e1)+(258.6*e2)+(301.143*e3));
-            b[9] = ((237.25*e1)+(114.35*e2)+(273.643*e3));
-            b[10] = weight;
-            
-            /*
-            50.4,29.45,209.964
-            81.85,65.45,244.321
-            107.85,23.4,267.25
-            177.1,112.8,278.679
-             281.35,524.2,305.429
-             324.2,653.25,299.036
-             362.45,680.6,309.036
-             394.55,692.25,303.036
-             404.55,258.6,301.143
-             237.25,114.35,273.643
-            */
-            std::cout << "B: [" << b[0] << "," << b[1] << "," << b[2] << "," << b[3] << "," << b[4] << "," << b[5] << "," << b[6] << "," << b[7] << "," << b[8] << "," << b[9] << "," << b[10] << "]\n";
-            
-            rsgis::math::RSGISNNLS nnls;
-            
-            //double* a, int* mda, int* m, int* n, double* b, double* x, double* rnorm, double* w, double* zz, int* index, int* mode
-            
-            int outVal = nnls.nnls_c(a, &mda, &m, &n, b, x, &rNorm, w, zz, index, &mode); 
-            std::cout << "outVal = " << outVal << std::endl;
-            std::cout << "rNorm = " << rNorm << std::endl;
-            std::cout << "mode = " << mode << std::endl;
-            
-            std::cout << "E: [" << e1 << "," << e2 << "," << e3 << "]\n";
-            std::cout << "X: [" << x[0] << "," << x[1] << "," << x[2] << "]\n";
-                        
+            delete calcNNLS;
+            gsl_matrix_free(endmembersIn);
         }
         catch(RSGISException &e)
         {
@@ -334,119 +243,250 @@ namespace rsgis{namespace img{
         }
     }
     
+    gsl_matrix* RSGISCalcLinearSpectralUnmixing::calcPseudoInverse(gsl_matrix *endmembers)
+    {
+        size_t numBands = endmembers->size1;
+        size_t numEndMembers = endmembers->size2;
+        
+        // A = U S V' (U replaces the copy of A)
+        gsl_matrix *U = gsl_matrix_alloc(numBands, numEndMembers);
+        gsl_matrix_memcpy(U, endmembers);
+        gsl_matrix *V = gsl_matrix_alloc(numEndMembers, numEndMembers);
+        gsl_vector *S = gsl_vector_alloc(numEndMembers);
+        gsl_vector *work = gsl_vector_alloc(numEndMembers);
+        int status = gsl_linalg_SV_decomp(U, V, S, work);
+        if(status != 0)
+        {
+            gsl_matrix_free(U);
+            gsl_matrix_free(V);
+            gsl_vector_free(S);
+            gsl_vector_free(work);
+            throw RSGISImageCalcException(gsl_strerror(status));
+        }
+        
+        // V S^-1, as gsl_linalg_SV_solve singular values of 0 are ignored.
+        for(size_t j = 0; j < numEndMembers; ++j)
+        {
+            double sVal = gsl_vector_get(S, j);
+            gsl_vector_view vCol = gsl_matrix_column(V, j);
+            gsl_vector_scale(&vCol.vector, (sVal != 0)?(1.0/sVal):0.0);
+        }
+        gsl_matrix *pInv = gsl_matrix_alloc(numEndMembers, numBands);
+        gsl_blas_dgemm(CblasNoTrans, CblasTrans, 1.0, V, U, 0.0, pInv);
+        
+        gsl_matrix_free(U);
+        gsl_matrix_free(V);
+        gsl_vector_free(S);
+        gsl_vector_free(work);
+        return pInv;
+    }
+    
     RSGISCalcLinearSpectralUnmixing::~RSGISCalcLinearSpectralUnmixing()
     {
         
     }
     
     
-    RSGISUnconstrainedLinearSpectralUnmixing::RSGISUnconstrainedLinearSpectralUnmixing(int numberOutBands, gsl_matrix *endmembers, gsl_matrix *V, gsl_vector *S, gsl_vector *work, gsl_vector *b, gsl_vector *x, float gain, float offset):RSGISCalcImageValue(numberOutBands)
+    RSGISPseudoInverseSpectralUnmixing::RSGISPseudoInverseSpectralUnmixing(int numberOutBands, gsl_matrix *pInv, gsl_vector *constTerm, float gain, float offset):RSGISCalcImageValue(numberOutBands)
     {
-        this->endmembers = endmembers;
-        this->V = V;
-        this->S = S;
-        this->work = work;
-        this->b = b;
-        this->x = x;
+        if(pInv->size1 != numberOutBands)
+        {
+            throw RSGISImageCalcException("The size of the pseudo-inverse is not the same of the number of output image bands.");
+        }
+        this->pInv = pInv;
+        this->constTerm = constTerm;
         this->gain = gain;
         this->offset = offset;
+        this->pxlVals = gsl_matrix_alloc(pInv->size2, UNMIXING_BLOCK_PXLS);
+        this->abundances = gsl_matrix_alloc(pInv->size1, UNMIXING_BLOCK_PXLS);
     }
-        
-    void RSGISUnconstrainedLinearSpectralUnmixing::calcImageValue(float *bandValues, int numBands, double *output) 
+    
+    void RSGISPseudoInverseSpectralUnmixing::calcImageValue(float *bandValues, int numBands, double *output) 
     {
-        try 
+        if(pInv->size2 != numBands)
         {
-            if(b->size != numBands)
-            {
-                throw RSGISImageCalcException("The size vector of for the input data is not equal to the number image bands.");
-            }
-            
-            if(x->size != this->numOutBands)
+            throw RSGISImageCalcException("The size vector of for the input data is not equal to the number image bands.");
+        }
+        
+        for(int i = 0; i < this->numOutBands; ++i)
+        {
+            double val = (constTerm == NULL)?0:gsl_vector_get(constTerm, i);
+            for(int j = 0; j < numBands; ++j)
             {
-                throw RSGISImageCalcException("The size of the output vector is not the same of the number of output image bands.");
+                val += gsl_matrix_get(pInv, i, j) * bandValues[j];
             }
-            
-            for(int i = 0; i < numBands; ++i)
-            {
-                gsl_vector_set(b, i, bandValues[i]);
+            output[i] = offset + (val*gain);
+        }
+    }
+    
+    void RSGISPseudoInverseSpectralUnmixing::calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output)
+    {
+        if(pInv->size2 != numBands)
+        {
+            throw RSGISImageCalcException("The size vector of for the input data is not equal to the number image bands.");
+        }
+        
+        for(unsigned long startPxl = 0; startPxl < nPxls; startPxl += UNMIXING_BLOCK_PXLS)
+        {
+            size_t numBlockPxls = std::min(nPxls - startPxl, (unsigned long)UNMIXING_BLOCK_PXLS);
+            gsl_matrix_view pxlView = gsl_matrix_submatrix(this->pxlVals, 0, 0, numBands, numBlockPxls);
+            gsl_matrix_view abundView = gsl_matrix_submatrix(this->abundances, 0, 0, this->numOutBands, numBlockPxls);
+            for(int n = 0; n < numBands; ++n)
+            {
+                double *pxlRow = gsl_matrix_ptr(&pxlView.matrix, n, 0);
+                float *bandRow = &bandValues[n][startPxl];
+                for(size_t k = 0; k < numBlockPxls; ++k)
+                {
+                    pxlRow[k] = bandRow[k];
+                }
             }
             
-            int status = gsl_linalg_SV_solve(endmembers, V, S, b, x);
-            if(status != 0)
-            {
-                throw RSGISImageCalcException(gsl_strerror(status));
-            }
+            // X = PB for all the pixels in the block.
+            gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, this->pInv, &pxlView.matrix, 0.0, &abundView.matrix);
             
-            for(int i = 0; i < x->size; ++i)
+            for(int i = 0; i < this->numOutBands; ++i)
             {
-                output[i] = offset + (gsl_vector_get(x, i)*gain);
+                double constVal = (constTerm == NULL)?0:gsl_vector_get(constTerm, i);
+                double *abundRow = gsl_matrix_ptr(&abundView.matrix, i, 0);
+                double *outRow = &output[i][startPxl];
+                for(size_t k = 0; k < numBlockPxls; ++k)
+                {
+                    outRow[k] = offset + ((abundRow[k] + constVal)*gain);
+                }
             }
         }
-        catch (RSGISImageCalcException &e) 
-        {
-            throw e;
-        }
     }
     
-    RSGISUnconstrainedLinearSpectralUnmixing::~RSGISUnconstrainedLinearSpectralUnmixing()
+    RSGISPseudoInverseSpectralUnmixing::~RSGISPseudoInverseSpectralUnmixing()
     {
-        
+        gsl_matrix_free(this->pxlVals);
+        gsl_matrix_free(this->abundances);
     }
     
     
-    RSGISPartConstrainedLinearSpectralUnmixing::RSGISPartConstrainedLinearSpectralUnmixing(int numberOutBands, float weight, gsl_matrix *endmembers, gsl_matrix *V, gsl_vector *S, gsl_vector *work, gsl_vector *b, gsl_vector *x, float gain, float offset):RSGISCalcImageValue(numberOutBands)
+    RSGISNNLSSpectralUnmixing::RSGISNNLSSpectralUnmixing(int numberOutBands, gsl_matrix *endmembers, float weight, float gain, float offset):RSGISCalcImageValue(numberOutBands)
     {
-        this->weight = weight;
+        if(endmembers->size2 != numberOutBands)
+        {
+            throw RSGISImageCalcException("The number of endmembers is not the same of the number of output image bands.");
+        }
         this->endmembers = endmembers;
-        this->V = V;
-        this->S = S;
-        this->work = work;
-        this->b = b;
-        this->x = x;
+        this->weight = weight;
         this->gain = gain;
         this->offset = offset;
+        
+        size_t numBands = endmembers->size1;
+        size_t numEndMembers = endmembers->size2;
+        this->endmembersT = gsl_matrix_alloc(numEndMembers, numBands);
+        gsl_matrix_transpose_memcpy(this->endmembersT, endmembers);
+        
+        // A'A where A is the endmembers with the weight row.
+        gsl_matrix *AtA = gsl_matrix_alloc(numEndMembers, numEndMembers);
+        gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, this->endmembersT, endmembers, 0.0, AtA);
+        std::vector<double> AtAVals(numEndMembers*numEndMembers);
+        for(size_t i = 0; i < numEndMembers; ++i)
+        {
+            for(size_t j = 0; j < numEndMembers; ++j)
+            {
+                AtAVals[(i*numEndMembers)+j] = gsl_matrix_get(AtA, i, j) + (((double)weight)*weight);
+            }
+        }
+        gsl_matrix_free(AtA);
+        this->nnls = new rsgis::math::RSGISFastNNLS(&AtAVals[0], numEndMembers);
+        
+        this->pxlVals = gsl_matrix_alloc(numBands, UNMIXING_BLOCK_PXLS);
+        this->AtbVals = gsl_matrix_alloc(numEndMembers, UNMIXING_BLOCK_PXLS);
+        this->Atb.assign(numEndMembers, 0.0);
+        this->x.assign(numEndMembers, 0.0);
     }
     
-    void RSGISPartConstrainedLinearSpectralUnmixing::calcImageValue(float *bandValues, int numBands, double *output) 
+    void RSGISNNLSSpectralUnmixing::calcImageValue(float *bandValues, int numBands, double *output) 
     {
-        try 
+        if(endmembers->size1 != numBands)
         {
-            if((b->size-1) != numBands)
-            {
-                throw RSGISImageCalcException("The size vector of for the input data is not equal to the number image bands.");
-            }
-            
-            if(x->size != this->numOutBands)
+            throw RSGISImageCalcException("The size vector of for the input data is not equal to the number image bands.");
+        }
+        
+        for(int i = 0; i < this->numOutBands; ++i)
+        {
+            double val = ((double)weight)*weight;
+            for(int j = 0; j < numBands; ++j)
             {
-                throw RSGISImageCalcException("The size of the output vector is not the same of the number of output image bands.");
+                val += gsl_matrix_get(endmembersT, i, j) * bandValues[j];
             }
-            
-            for(int i = 0; i < numBands; ++i)
-            {
-                gsl_vector_set(b, i, bandValues[i]);
+            this->Atb[i] = val;
+        }
+        this->solveNNLS();
+        for(int i = 0; i < this->numOutBands; ++i)
+        {
+            output[i] = offset + (this->x[i]*gain);
+        }
+    }
+    
+    void RSGISNNLSSpectralUnmixing::calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output)
+    {
+        if(endmembers->size1 != numBands)
+        {
+            throw RSGISImageCalcException("The size vector of for the input data is not equal to the number image bands.");
+        }
+        
+        double weightSq = ((double)weight)*weight;
+        for(unsigned long startPxl = 0; startPxl < nPxls; startPxl += UNMIXING_BLOCK_PXLS)
+        {
+            size_t numBlockPxls = std::min(nPxls - startPxl, (unsigned long)UNMIXING_BLOCK_PXLS);
+            gsl_matrix_view pxlView = gsl_matrix_submatrix(this->pxlVals, 0, 0, numBands, numBlockPxls);
+            gsl_matrix_view AtbView = gsl_matrix_submatrix(this->AtbVals, 0, 0, this->numOutBands, numBlockPxls);
+            for(int n = 0; n < numBands; ++n)
+            {
+                double *pxlRow = gsl_matrix_ptr(&pxlView.matrix, n, 0);
+                float *bandRow = &bandValues[n][startPxl];
+                for(size_t k = 0; k < numBlockPxls; ++k)
+                {
+                    pxlRow[k] = bandRow[k];
+                }
             }
-            gsl_vector_set(b, numBands, weight);
             
-            int status = gsl_linalg_SV_solve(endmembers, V, S, b, x);
-            if(status != 0)
-            {
-                throw RSGISImageCalcException(gsl_strerror(status));
-            }
+            // A'b for all the pixels in the block.
+            gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, this->endmembersT, &pxlView.matrix, 0.0, &AtbView.matrix);
             
-            for(int i = 0; i < x->size; ++i)
+            for(size_t k = 0; k < numBlockPxls; ++k)
             {
-                output[i] = offset + (gsl_vector_get(x, i)*gain);
+                for(int i = 0; i < this->numOutBands; ++i)
+                {
+                    this->Atb[i] = gsl_matrix_get(&AtbView.matrix, i, k) + weightSq;
+                }
+                this->solveNNLS();
+                for(int i = 0; i < this->numOutBands; ++i)
+                {
+                    output[i][startPxl+k] = offset + (this->x[i]*gain);
+                }
             }
         }
-        catch (RSGISImageCalcException &e) 
+    }
+    
+    void RSGISNNLSSpectralUnmixing::solveNNLS()
+    {
+        for(int i = 0; i < this->numOutBands; ++i)
         {
-            throw e;
+            if((boost::math::isnan)(this->Atb[i]))
+            {
+                for(int j = 0; j < this->numOutBands; ++j)
+                {
+                    this->x[j] = std::numeric_limits<double>::quiet_NaN();
+                }
+                return;
+            }
         }
+        // Neighbouring pixels usually have similar abundances so start from the previous solution.
+        this->nnls->solve(&this->Atb[0], &this->x[0], true);
     }
     
-    RSGISPartConstrainedLinearSpectralUnmixing::~RSGISPartConstrainedLinearSpectralUnmixing()
+    RSGISNNLSSpectralUnmixing::~RSGISNNLSSpectralUnmixing()
     {
-        
+        delete this->nnls;
+        gsl_matrix_free(this->endmembersT);
+        gsl_matrix_free(this->pxlVals);
+        gsl_matrix_free(this->AtbVals);
     }
     
     
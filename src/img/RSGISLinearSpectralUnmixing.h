@@ -27,13 +27,16 @@
 #include <string>
 #include <math.h>
 #include <stdlib.h>
+#include <vector>
+#include <limits>
+#include <algorithm>
 
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISCalcImage.h"
 
 #include "math/RSGISMatrices.h"
-#include "math/RSGISnnls.h"
+#include "math/RSGISFastNNLS.h"
 
 #include <geos/geom/Envelope.h>
 
@@ -44,6 +47,8 @@
 #include <gsl/gsl_linalg.h>
 #include <gsl/gsl_errno.h>
 
+#include "boost/math/special_functions/fpclassify.hpp"
+
 #include "gdal_priv.h"
 #include "ogrsf_frmts.h"
 #include "ogr_api.h"
@@ -61,6 +66,9 @@
     #define DllExport
 #endif
 
+// The number of pixels unmixed with each matrix product.
+#define UNMIXING_BLOCK_PXLS 4096
+
 namespace rsgis{namespace img{
     
     class DllExport RSGISCalcLinearSpectralUnmixing
@@ -73,6 +81,8 @@ namespace rsgis{namespace img{
         void performExhaustiveConstrainedSpectralUnmixing(GDALDataset **datasets, int numDatasets, std::string outputImage, std::string endmembersFilePath, float stepResolution);
         ~RSGISCalcLinearSpectralUnmixing();
     protected:
+        /** The (endmembers x bands) pseudo-inverse, V S^-1 U', of the endmembers matrix (singular values of 0 are ignored). */
+        gsl_matrix* calcPseudoInverse(gsl_matrix *endmembers);
         std::string gdalFormat;
         GDALDataType gdalDataType;
         float gain;
@@ -80,11 +90,24 @@ namespace rsgis{namespace img{
     };
     
     
-    class DllExport RSGISUnconstrainedLinearSpectralUnmixing : public RSGISCalcImageValue
+    /**
+     * Least squares unmixing using the pseudo-inverse (P) of the endmembers matrix, calculated
+     * once from its SVD, so the abundances for a block of pixels (X) are the matrix product
+     * X = PB + c, where B are the pixel values (bands x pixels) and c a constant for each
+     * endmember (i.e., from the weight row of the partially constrained unmixing).
+     */
+    class DllExport RSGISPseudoInverseSpectralUnmixing : public RSGISCalcImageValue
     {
     public: 
-        RSGISUnconstrainedLinearSpectralUnmixing(int numberOutBands, gsl_matrix *endmembers, gsl_matrix *V, gsl_vector *S, gsl_vector *work, gsl_vector *b, gsl_vector *x, float gain, float offset);
+        /**
+         * pInv is the (endmembers x bands) pseudo-inverse and constTerm (may be NULL)
+         * is added to each output; both are owned by the caller.
+         */
+        RSGISPseudoInverseSpectralUnmixing(int numberOutBands, gsl_matrix *pInv, gsl_vector *constTerm, float gain, float offset);
         void calcImageValue(float *bandValues, int numBands, double *output);
+        void calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output);
+        bool implementsCalcImageBlock() {return true;};
+        RSGISCalcImageValue* clone() {return new RSGISPseudoInverseSpectralUnmixing(this->numOutBands, this->pInv, this->constTerm, this->gain, this->offset);};
         void calcImageValue(float *bandValues, int numBands) {throw RSGISImageCalcException("Not implemented");};
         void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) {throw RSGISImageCalcException("Not implemented");};
         void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) {throw RSGISImageCalcException("Not implemented");};
@@ -94,41 +117,52 @@ namespace rsgis{namespace img{
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("Not implemented");};
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw RSGISImageCalcException("No implemented");};
         bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("Not implemented");};
-        ~RSGISUnconstrainedLinearSpectralUnmixing();
+        ~RSGISPseudoInverseSpectralUnmixing();
     protected:
-        gsl_matrix *endmembers;
-        gsl_matrix *V;
-        gsl_vector *S;
-        gsl_vector *work;
-        gsl_vector *b;
-        gsl_vector *x;
+        gsl_matrix *pInv;
+        gsl_vector *constTerm;
+        gsl_matrix *pxlVals;
+        gsl_matrix *abundances;
         float gain;
         float offset;
     };
     
-    class DllExport RSGISPartConstrainedLinearSpectralUnmixing : public RSGISCalcImageValue
+    /**
+     * Non-negative partially constrained (sum to approximately 1) unmixing. The normal
+     * equations (A'A) of the endmembers matrix with the weight row are calculated once
+     * and A'b for a block of pixels as a single matrix product, with the NNLS for each
+     * pixel warm started from the solution of the previous pixel.
+     */
+    class DllExport RSGISNNLSSpectralUnmixing : public RSGISCalcImageValue
     {
     public: 
-        RSGISPartConstrainedLinearSpectralUnmixing(int numberOutBands, float weight, gsl_matrix *endmembers, gsl_matrix *V, gsl_vector *S, gsl_vector *work, gsl_vector *b, gsl_vector *x, float gain, float offset);
+        /** endmembers is the (bands x endmembers) matrix, owned by the caller. */
+        RSGISNNLSSpectralUnmixing(int numberOutBands, gsl_matrix *endmembers, float weight, float gain, float offset);
         void calcImageValue(float *bandValues, int numBands, double *output);
+        void calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output);
+        bool implementsCalcImageBlock() {return true;};
+        RSGISCalcImageValue* clone() {return new RSGISNNLSSpectralUnmixing(this->numOutBands, this->endmembers, this->weight, this->gain, this->offset);};
         void calcImageValue(float *bandValues, int numBands) {throw RSGISImageCalcException("Not implemented");};
         void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) {throw RSGISImageCalcException("Not implemented");};
         void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) {throw RSGISImageCalcException("Not implemented");};
-       void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, geos::geom::Envelope extent){throw rsgis::img::RSGISImageCalcException("Not implemented");};
+        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, geos::geom::Envelope extent){throw rsgis::img::RSGISImageCalcException("Not implemented");};
         void calcImageValue(float *bandValues, int numBands, geos::geom::Envelope extent) {throw RSGISImageCalcException("Not implemented");};
         void calcImageValue(float *bandValues, int numBands, double *output, geos::geom::Envelope extent) {throw RSGISImageCalcException("Not implemented");};
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("Not implemented");};
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw RSGISImageCalcException("No implemented");};
         bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("Not implemented");};
-        ~RSGISPartConstrainedLinearSpectralUnmixing();
+        ~RSGISNNLSSpectralUnmixing();
     protected:
-        float weight;
+        /** Solve the NNLS for the A'b of a pixel (Atb) into x, which is NaN where A'b is not a number. */
+        void solveNNLS();
         gsl_matrix *endmembers;
-        gsl_matrix *V;
-        gsl_vector *S;
-        gsl_vector *work;
-        gsl_vector *b;
-        gsl_vector *x;
+        float weight;
+        gsl_matrix *endmembersT;
+        gsl_matrix *pxlVals;
+        gsl_matrix *AtbVals;
+        rsgis::math::RSGISFastNNLS *nnls;
+        std::vector<double> Atb;
+        std::vector<double> x;
         float gain;
         float offset;
     };
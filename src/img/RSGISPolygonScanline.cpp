@@ -0,0 +1,384 @@
+/*
+ *  RSGISPolygonScanline.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISPolygonScanline.h"
+
+namespace rsgis{namespace img{
+
+    RSGISPolygonScanline::RSGISPolygonScanline(const geos::geom::Polygon *poly, double tlX, double tlY, double pxlWidth, double pxlHeight, int width, int height)
+    {
+        if((pxlWidth <= 0) || (pxlHeight <= 0))
+        {
+            throw RSGISImageCalcException("The pixel size for rasterising the polygon must be positive.");
+        }
+        this->tlX = tlX;
+        this->tlY = tlY;
+        this->pxlWidth = pxlWidth;
+        this->pxlHeight = pxlHeight;
+        this->width = (width < 0)?0:width;
+        this->height = (height < 0)?0:height;
+        this->envMinCol = 0;
+        this->envMaxCol = 0;
+        this->envMinRow = 0;
+        this->envMaxRow = 0;
+
+        const geos::geom::LineString *extRing = poly->getExteriorRing();
+        if((extRing != NULL) && (!extRing->isEmpty()))
+        {
+            const geos::geom::CoordinateSequence *coords = extRing->getCoordinatesRO();
+            for(size_t i = 0; i < coords->getSize(); ++i)
+            {
+                double col = (coords->getAt(i).x - tlX) / pxlWidth;
+                double row = (tlY - coords->getAt(i).y) / pxlHeight;
+                if((i == 0) || (col < this->envMinCol)){this->envMinCol = col;}
+                if((i == 0) || (col > this->envMaxCol)){this->envMaxCol = col;}
+                if((i == 0) || (row < this->envMinRow)){this->envMinRow = row;}
+                if((i == 0) || (row > this->envMaxRow)){this->envMaxRow = row;}
+            }
+            this->addRing(extRing, false);
+            for(size_t i = 0; i < poly->getNumInteriorRing(); ++i)
+            {
+                this->addRing(poly->getInteriorRingN(i), true);
+            }
+        }
+        std::sort(this->edges.begin(), this->edges.end(), RSGISPolygonScanline::edgeYMinLess);
+
+        this->nextEdge = 0;
+        this->lastYTop = 0;
+        this->rowArea.resize(this->width + 1);
+        this->rowCover.resize(this->width + 1);
+        this->rowCoverage.resize(this->width);
+    }
+
+    bool RSGISPolygonScanline::isOptionSupported(pixelInPolyOption option)
+    {
+        return (option == polyContainsPixelCenter) || (option == pixelAreaInPoly) || (option == polyContainsPixel) || (option == polyOverlapsPixel) ||
+               (option == polyOverlapsOrContainsPixel) || (option == pixelContainsPoly) || (option == envelope);
+    }
+
+    void RSGISPolygonScanline::findRowSpans(int row, pixelInPolyOption option, std::vector<RSGISPixelSpan> *spans)
+    {
+        spans->clear();
+        if((row < 0) || (row >= this->height) || (this->width == 0))
+        {
+            return;
+        }
+
+        RSGISPixelSpan span;
+        if(option == envelope)
+        {
+            span.startCol = 0;
+            span.endCol = this->width;
+            spans->push_back(span);
+        }
+        else if(option == pixelContainsPoly)
+        {
+            if((this->edges.size() > 0) && (row <= this->envMinRow) && (this->envMaxRow <= (row + 1)))
+            {
+                span.startCol = std::max((int)std::ceil(this->envMaxCol - 1), 0);
+                span.endCol = std::min(((int)std::floor(this->envMinCol)) + 1, this->width);
+                if(span.startCol < span.endCol)
+                {
+                    spans->push_back(span);
+                }
+            }
+        }
+        else if(option == polyContainsPixelCenter)
+        {
+            this->updateActiveEdges(row, row + 1);
+            this->findCentreSpans(row, spans);
+        }
+        else if((option == pixelAreaInPoly) || (option == polyContainsPixel) || (option == polyOverlapsPixel) || (option == polyOverlapsOrContainsPixel))
+        {
+            this->updateActiveEdges(row, row + 1);
+            this->calcRowCoverage(row);
+
+            const double eps = 1e-9;
+            bool selected = false;
+            span.startCol = -1;
+            for(int col = 0; col < this->width; ++col)
+            {
+                double frac = this->rowCoverage[col];
+                if(option == pixelAreaInPoly)
+                {
+                    selected = frac > eps;
+                }
+                else if(option == polyContainsPixel)
+                {
+                    selected = frac >= (1 - eps);
+                }
+                else if(option == polyOverlapsPixel)
+                {
+                    selected = (frac > eps) && (frac < (1 - eps)) && (!this->pixelContainsPolygon(row, col));
+                }
+                else
+                {
+                    selected = (frac > eps) && ((frac >= (1 - eps)) || (!this->pixelContainsPolygon(row, col)));
+                }
+
+                if(selected && (span.startCol < 0))
+                {
+                    span.startCol = col;
+                }
+                else if((!selected) && (span.startCol >= 0))
+                {
+                    span.endCol = col;
+                    spans->push_back(span);
+                    span.startCol = -1;
+                }
+            }
+            if(span.startCol >= 0)
+            {
+                span.endCol = this->width;
+                spans->push_back(span);
+            }
+        }
+        else
+        {
+            throw RSGISImageCalcException("The pixel in polygon method is not supported by the scanline rasteriser.");
+        }
+    }
+
+    void RSGISPolygonScanline::addRing(const geos::geom::LineString *ring, bool hole)
+    {
+        if((ring == NULL) || ring->isEmpty())
+        {
+            return;
+        }
+        const geos::geom::CoordinateSequence *coords = ring->getCoordinatesRO();
+        size_t numCoords = coords->getSize();
+        if(numCoords < 3)
+        {
+            return;
+        }
+
+        std::vector<double> cols(numCoords);
+        std::vector<double> rows(numCoords);
+        double area = 0;
+        for(size_t i = 0; i < numCoords; ++i)
+        {
+            cols[i] = (coords->getAt(i).x - this->tlX) / this->pxlWidth;
+            rows[i] = (this->tlY - coords->getAt(i).y) / this->pxlHeight;
+        }
+        for(size_t i = 0; i < numCoords; ++i)
+        {
+            size_t j = (i + 1) % numCoords;
+            area += (cols[i] * rows[j]) - (cols[j] * rows[i]);
+        }
+        if(area == 0)
+        {
+            return;
+        }
+
+        // The coverage accumulated from a ring with a positive area (in pixel
+        // coordinates) is negative so weight the edges such that the exterior
+        // ring adds to the coverage and the holes subtract from it.
+        double weight = (area > 0)?-1.0:1.0;
+        if(hole)
+        {
+            weight = weight * -1;
+        }
+
+        RSGISScanlineEdge edge;
+        for(size_t i = 0; i < numCoords; ++i)
+        {
+            size_t j = (i + 1) % numCoords;
+            if(rows[i] == rows[j])
+            {
+                // Horizontal edges do not cross any scanline or add coverage.
+                continue;
+            }
+            edge.x0 = cols[i];
+            edge.y0 = rows[i];
+            edge.x1 = cols[j];
+            edge.y1 = rows[j];
+            edge.yMin = std::min(rows[i], rows[j]);
+            edge.yMax = std::max(rows[i], rows[j]);
+            edge.weight = weight;
+            this->edges.push_back(edge);
+        }
+    }
+
+    void RSGISPolygonScanline::updateActiveEdges(double yTop, double yBottom)
+    {
+        if(yTop < this->lastYTop)
+        {
+            // Rows are normally requested in order; otherwise start again.
+            this->nextEdge = 0;
+            this->activeEdges.clear();
+        }
+        this->lastYTop = yTop;
+
+        while((this->nextEdge < this->edges.size()) && (this->edges[this->nextEdge].yMin < yBottom))
+        {
+            this->activeEdges.push_back(this->nextEdge);
+            ++this->nextEdge;
+        }
+
+        size_t numActive = 0;
+        for(size_t i = 0; i < this->activeEdges.size(); ++i)
+        {
+            if(this->edges[this->activeEdges[i]].yMax > yTop)
+            {
+                this->activeEdges[numActive++] = this->activeEdges[i];
+            }
+        }
+        this->activeEdges.resize(numActive);
+    }
+
+    void RSGISPolygonScanline::findCentreSpans(int row, std::vector<RSGISPixelSpan> *spans)
+    {
+        double yCentre = row + 0.5;
+        this->crossings.clear();
+        for(std::vector<size_t>::iterator iterEdge = this->activeEdges.begin(); iterEdge != this->activeEdges.end(); ++iterEdge)
+        {
+            const RSGISScanlineEdge &edge = this->edges[*iterEdge];
+            if((edge.yMin <= yCentre) && (yCentre < edge.yMax))
+            {
+                this->crossings.push_back(edge.x0 + ((yCentre - edge.y0) * (edge.x1 - edge.x0) / (edge.y1 - edge.y0)));
+            }
+        }
+        std::sort(this->crossings.begin(), this->crossings.end());
+
+        // Pixels with their centre within each pair of crossings (even-odd rule, so holes are excluded).
+        RSGISPixelSpan span;
+        for(size_t i = 0; (i + 1) < this->crossings.size(); i += 2)
+        {
+            span.startCol = std::max((int)std::ceil(this->crossings[i] - 0.5), 0);
+            span.endCol = std::min((int)std::ceil(this->crossings[i+1] - 0.5), this->width);
+            if(span.startCol < span.endCol)
+            {
+                if((!spans->empty()) && (spans->back().endCol >= span.startCol))
+                {
+                    spans->back().endCol = std::max(spans->back().endCol, span.endCol);
+                }
+                else
+                {
+                    spans->push_back(span);
+                }
+            }
+        }
+    }
+
+    void RSGISPolygonScanline::calcRowCoverage(int row)
+    {
+        std::fill(this->rowArea.begin(), this->rowArea.end(), 0.0);
+        std::fill(this->rowCover.begin(), this->rowCover.end(), 0.0);
+
+        double yTop = row;
+        double yBottom = row + 1;
+        for(std::vector<size_t>::iterator iterEdge = this->activeEdges.begin(); iterEdge != this->activeEdges.end(); ++iterEdge)
+        {
+            const RSGISScanlineEdge &edge = this->edges[*iterEdge];
+            double yA = std::max(edge.yMin, yTop);
+            double yB = std::min(edge.yMax, yBottom);
+            if(yA >= yB)
+            {
+                continue;
+            }
+            double xA = edge.x0 + ((yA - edge.y0) * (edge.x1 - edge.x0) / (edge.y1 - edge.y0));
+            double xB = edge.x0 + ((yB - edge.y0) * (edge.x1 - edge.x0) / (edge.y1 - edge.y0));
+            if(edge.y0 < edge.y1)
+            {
+                this->addCoverageSegment(xA, yA, xB, yB, edge.weight);
+            }
+            else
+            {
+                this->addCoverageSegment(xB, yB, xA, yA, edge.weight);
+            }
+        }
+
+        double cover = 0;
+        for(int col = 0; col < this->width; ++col)
+        {
+            cover += this->rowCover[col];
+            double frac = cover + this->rowArea[col];
+            if(frac < 0)
+            {
+                frac = 0;
+            }
+            else if(frac > 1)
+            {
+                frac = 1;
+            }
+            this->rowCoverage[col] = frac;
+        }
+    }
+
+    void RSGISPolygonScanline::addCoverageSegment(double xa, double ya, double xb, double yb, double weight)
+    {
+        // Split the segment where it crosses the pixel boundaries within the grid.
+        double prevX = xa;
+        double prevY = ya;
+        if(xb > xa)
+        {
+            double grad = (yb - ya) / (xb - xa);
+            for(int k = std::max(((int)std::floor(xa)) + 1, 0); (k < xb) && (k <= this->width); ++k)
+            {
+                double y = ya + ((k - xa) * grad);
+                this->addCoveragePiece(prevX, prevY, k, y, weight);
+                prevX = k;
+                prevY = y;
+            }
+        }
+        else if(xb < xa)
+        {
+            double grad = (yb - ya) / (xb - xa);
+            for(int k = std::min(((int)std::ceil(xa)) - 1, this->width); (k > xb) && (k >= 0); --k)
+            {
+                double y = ya + ((k - xa) * grad);
+                this->addCoveragePiece(prevX, prevY, k, y, weight);
+                prevX = k;
+                prevY = y;
+            }
+        }
+        this->addCoveragePiece(prevX, prevY, xb, yb, weight);
+    }
+
+    void RSGISPolygonScanline::addCoveragePiece(double xa, double ya, double xb, double yb, double weight)
+    {
+        // Parts of the polygon left of the grid cover the whole row and parts to
+        // the right cover none of it, so clamping to the grid is exact.
+        xa = std::min(std::max(xa, 0.0), (double)this->width);
+        xb = std::min(std::max(xb, 0.0), (double)this->width);
+        int col = (int)std::floor(std::min(xa, xb));
+        if(col >= this->width)
+        {
+            return;
+        }
+        double dy = (yb - ya) * weight;
+        // The area to the right of the piece within its pixel, then all of dy for the pixels further right.
+        this->rowArea[col] += dy * ((col + 1) - ((xa + xb) / 2));
+        this->rowCover[col+1] += dy;
+    }
+
+    bool RSGISPolygonScanline::pixelContainsPolygon(int row, int col) const
+    {
+        return (col <= this->envMinCol) && (this->envMaxCol <= (col + 1)) && (row <= this->envMinRow) && (this->envMaxRow <= (row + 1));
+    }
+
+    RSGISPolygonScanline::~RSGISPolygonScanline()
+    {
+
+    }
+
+}}
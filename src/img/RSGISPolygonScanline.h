@@ -0,0 +1,136 @@
+/*
+ *  RSGISPolygonScanline.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISPolygonScanline_H
+#define RSGISPolygonScanline_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "geos/geom/Polygon.h"
+#include "geos/geom/LineString.h"
+#include "geos/geom/CoordinateSequence.h"
+
+#include "img/RSGISPixelInPoly.h"
+#include "img/RSGISImageCalcException.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_img_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace img{
+
+    /**
+     * A run of pixels [startCol, endCol) within a row of the grid.
+     */
+    struct DllExport RSGISPixelSpan
+    {
+        int startCol;
+        int endCol;
+    };
+
+    /**
+     * Rasterises a polygon (including its holes) onto a grid of width x height
+     * pixels with the top left corner at (tlX, tlY), finding the pixels of a row
+     * selected by a pixelInPolyOption as spans. Uses an edge table so each row
+     * only visits the edges which cross it rather than testing each pixel
+     * against the polygon geometry.
+     *
+     * polyContainsPixelCenter uses the crossings of the row centre line (even-odd
+     * rule). The area based options (pixelAreaInPoly, polyContainsPixel,
+     * polyOverlapsPixel and polyOverlapsOrContainsPixel) use the exact fraction
+     * of each pixel's area within the polygon, accumulated from the edges
+     * clipped to the row. adaptive, pixelContainsPolyCenter and polyAreaInPixel
+     * are not supported (see isOptionSupported).
+     */
+    class DllExport RSGISPolygonScanline
+    {
+    public:
+        RSGISPolygonScanline(const geos::geom::Polygon *poly, double tlX, double tlY, double pxlWidth, double pxlHeight, int width, int height);
+        static bool isOptionSupported(pixelInPolyOption option);
+        /**
+         * Find the spans of pixels within row which are selected by option. The
+         * spans are returned in column order and do not overlap.
+         */
+        void findRowSpans(int row, pixelInPolyOption option, std::vector<RSGISPixelSpan> *spans);
+        /**
+         * The fraction (0 - 1) of the area of the pixel at col within the polygon
+         * for the row last passed to findRowSpans with an area based option.
+         */
+        double getAreaFraction(int col) const {return this->rowCoverage[col];};
+        ~RSGISPolygonScanline();
+    protected:
+        struct RSGISScanlineEdge
+        {
+            double x0;
+            double y0;
+            double x1;
+            double y1;
+            double yMin;
+            double yMax;
+            double weight;
+        };
+        void addRing(const geos::geom::LineString *ring, bool hole);
+        void updateActiveEdges(double yTop, double yBottom);
+        void findCentreSpans(int row, std::vector<RSGISPixelSpan> *spans);
+        void calcRowCoverage(int row);
+        void addCoverageSegment(double xa, double ya, double xb, double yb, double weight);
+        void addCoveragePiece(double xa, double ya, double xb, double yb, double weight);
+        bool pixelContainsPolygon(int row, int col) const;
+        static bool edgeYMinLess(const RSGISScanlineEdge &a, const RSGISScanlineEdge &b)
+        {
+            return a.yMin < b.yMin;
+        };
+        double tlX;
+        double tlY;
+        double pxlWidth;
+        double pxlHeight;
+        int width;
+        int height;
+        double envMinCol;
+        double envMaxCol;
+        double envMinRow;
+        double envMaxRow;
+        std::vector<RSGISScanlineEdge> edges;
+        size_t nextEdge;
+        double lastYTop;
+        std::vector<size_t> activeEdges;
+        std::vector<double> crossings;
+        std::vector<double> rowArea;
+        std::vector<double> rowCover;
+        std::vector<double> rowCoverage;
+    };
+
+}}
+
+#endif
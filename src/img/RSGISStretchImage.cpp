@@ -260,6 +260,104 @@ namespace rsgis { namespace img {
 		
 	}
 	
+	void RSGISStretchImage::executeLinearPercentileStretch(float percent)
+	{
+		GDALDataset **datasets = NULL;
+		RSGISCalcImage *calcImg = NULL;
+		RSGISLinearStretchImage *linearStretchImage = NULL;
+		double *imageMax = NULL;
+		double *imageMin = NULL;
+		double *outMax = NULL;
+		double *outMin = NULL;
+		try
+		{
+			if((percent < 0) | (percent >= 50))
+			{
+				throw RSGISImageCalcException("The percentile must be between 0 and 50.");
+			}
+			int numBands = inputImage->GetRasterCount();
+			datasets = new GDALDataset*[1];
+			datasets[0] = inputImage;
+			
+			imageMax = new double[numBands];
+			imageMin = new double[numBands];
+			outMax = new double[numBands];
+			outMin = new double[numBands];
+			
+			// Exact percentiles of each band, calculated from histograms in two passes over the image.
+			std::vector<float> percentiles;
+			percentiles.push_back(percent/100);
+			percentiles.push_back(1-(percent/100));
+			RSGISImagePercentiles calcPercentiles;
+			std::vector< std::vector<double> > bandPercentiles = calcPercentiles.getPercentilesForAllBands(inputImage, percentiles, this->inNoData, this->useNoData);
+			
+            std::ofstream outTxtFile;
+            if(this->outStats)
+            {
+                outTxtFile.open(this->outStatsFile.c_str());
+                if(!outTxtFile.is_open())
+                {
+                    throw RSGISImageCalcException("Output file for the statistics could not be opened.");
+                }
+                outTxtFile << "#percentile\n";
+                outTxtFile << "#band,img_min,img_max,out_min,out_max\n";
+            }
+            
+			for(int i = 0; i < numBands; i++)
+			{
+				imageMin[i] = bandPercentiles[i][0];
+				imageMax[i] = bandPercentiles[i][1];
+				outMax[i] = this->outMaxVal;
+				outMin[i] = this->outMinVal;
+                
+                if(this->outStats)
+                {
+                    outTxtFile << i+1 << "," << imageMin[i] << "," << imageMax[i] << "," << outMin[i] << "," << outMax[i] << std::endl;
+                }
+			}
+            
+            if(this->outStats)
+            {
+                outTxtFile.flush();
+                outTxtFile.close();
+            }
+			
+			linearStretchImage = new RSGISLinearStretchImage(numBands, imageMax, imageMin, outMax, outMin, this->useNoData, this->inNoData, this->outNoData);
+			calcImg = new RSGISCalcImage(linearStretchImage, "", true);
+			calcImg->calcImage(datasets, 1, outputImage, false, NULL, imageFormat, outDataType);
+			
+		}
+		catch(RSGISImageCalcException &e)
+		{
+			if(datasets != NULL)
+			{
+				delete[] datasets;
+			}
+			throw e;
+		}
+		catch(RSGISImageException &e)
+		{
+			if(datasets != NULL)
+			{
+				delete[] datasets;
+			}
+			throw RSGISImageCalcException(e.what());
+		}
+		
+		delete[] imageMax;
+		delete[] imageMin;
+		delete[] outMax;
+		delete[] outMin;
+		
+		delete linearStretchImage;
+		delete calcImg;
+		
+		if(datasets != NULL)
+		{
+			delete[] datasets;
+		}
+	}
+	
 	void RSGISStretchImage::executeLinearStdDevStretch(float stddev) 
 	{
 		GDALDataset **datasets = NULL;
@@ -1147,6 +1245,46 @@ namespace rsgis { namespace img {
 		}
 	}
 	
+    void RSGISLinearStretchImage::calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output)
+    {
+        double norm2min = 0;
+        double outVal = 0;
+        for(int i = 0; i < numBands; i++)
+        {
+            float *inBand = bandValues[i];
+            double *outBand = output[i];
+            double inDiff = imageMax[i] - imageMin[i];
+            double outDiff = outMax[i] - outMin[i];
+            double nanOutVal = this->useNoData?this->outNoData:outMin[i];
+            double outNoDataAdj = (this->outNoData == outMax[i])?(this->outNoData - 1):(this->outNoData + 1);
+            for(unsigned long p = 0; p < nPxls; ++p)
+            {
+                if(boost::math::isnan(inBand[p]))
+                {
+                    outBand[p] = nanOutVal;
+                }
+                else if(this->useNoData && (inBand[p] == this->inNoData))
+                {
+                    outBand[p] = this->outNoData;
+                }
+                else if(inBand[p] < imageMin[i])
+                {
+                    outBand[p] = outMin[i];
+                }
+                else if(inBand[p] > imageMax[i])
+                {
+                    outBand[p] = outMax[i];
+                }
+                else
+                {
+                    norm2min = inBand[p] - imageMin[i];
+                    outVal = ((norm2min/inDiff)*outDiff)+outMin[i];
+                    outBand[p] = (outVal == this->outNoData)?outNoDataAdj:outVal;
+                }
+            }
+        }
+    }
+	
 	RSGISLinearStretchImage::~RSGISLinearStretchImage()
 	{
 		
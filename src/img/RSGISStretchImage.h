@@ -89,6 +89,7 @@ namespace rsgis { namespace img {
 		RSGISStretchImage(GDALDataset *inputImage, std::string outputImage, bool outStats, std::string outStatsFile, bool onePassSD, std::string imageFormat, GDALDataType outDataType, float outMinVal, float outMaxVal, bool useNoData, double inNoData, double outNoData);
 		void executeLinearMinMaxStretch();
 		void executeLinearPercentStretch(float percent);
+		void executeLinearPercentileStretch(float percent);
 		void executeLinearStdDevStretch(float stddev);
 		void executeHistogramStretch();
 		void executeExponentialStretch();
@@ -304,6 +305,9 @@ namespace rsgis { namespace img {
 		void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("No implemented");};
         void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw RSGISImageCalcException("No implemented");};
 		bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("No implemented");};
+        void calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output);
+        bool implementsCalcImageBlock() {return true;};
+        RSGISCalcImageValue* clone() {return new RSGISLinearStretchImage(this->numOutBands, this->imageMax, this->imageMin, this->outMax, this->outMin, this->useNoData, this->inNoData, this->outNoData);};
 		~RSGISLinearStretchImage();
 	protected:
 		double *imageMax;
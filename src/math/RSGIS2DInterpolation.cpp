@@ -26,10 +26,149 @@
 
 namespace rsgis {namespace math{
     
+    RSGIS2DPointKDTree::RSGIS2DPointKDTree(std::vector<RSGISInterpolatorDataPoint> *pts)
+    {
+        this->pts.reserve(pts->size());
+        this->pts.insert(this->pts.end(), pts->begin(), pts->end());
+        this->buildTree(0, this->pts.size(), 0);
+    }
+    
+    void RSGIS2DPointKDTree::buildTree(size_t start, size_t end, unsigned int depth)
+    {
+        if((end - start) <= leafSize)
+        {
+            return;
+        }
+        size_t mid = start + ((end - start) / 2);
+        if((depth % 2) == 0)
+        {
+            std::nth_element(pts.begin()+start, pts.begin()+mid, pts.begin()+end, compareX);
+        }
+        else
+        {
+            std::nth_element(pts.begin()+start, pts.begin()+mid, pts.begin()+end, compareY);
+        }
+        this->buildTree(start, mid, depth+1);
+        this->buildTree(mid+1, end, depth+1);
+    }
+    
+    void RSGIS2DPointKDTree::findKNN(double eastings, double northings, unsigned int k, std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > *knn, double maxDist) const
+    {
+        knn->clear();
+        if(k == 0)
+        {
+            return;
+        }
+        double maxDistSq = std::numeric_limits<double>::max();
+        if(maxDist < sqrt(std::numeric_limits<double>::max()))
+        {
+            maxDistSq = maxDist * maxDist;
+        }
+        
+        // knn is used as a max heap of squared distances while searching.
+        this->searchKNN(0, this->pts.size(), 0, eastings, northings, k, knn, &maxDistSq);
+        
+        std::sort_heap(knn->begin(), knn->end(), compareDist);
+        for(std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> >::iterator iterKNN = knn->begin(); iterKNN != knn->end(); ++iterKNN)
+        {
+            (*iterKNN).first = sqrt((*iterKNN).first);
+        }
+    }
+    
+    void RSGIS2DPointKDTree::searchKNN(size_t start, size_t end, unsigned int depth, double eastings, double northings, unsigned int k, std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > *heap, double *maxDistSq) const
+    {
+        if((end - start) <= leafSize)
+        {
+            for(size_t i = start; i < end; ++i)
+            {
+                double diffX = eastings - pts[i].x;
+                double diffY = northings - pts[i].y;
+                double distSq = (diffX * diffX) + (diffY * diffY);
+                if(distSq <= *maxDistSq)
+                {
+                    if(heap->size() == k)
+                    {
+                        if(distSq >= heap->front().first)
+                        {
+                            continue;
+                        }
+                        std::pop_heap(heap->begin(), heap->end(), compareDist);
+                        heap->pop_back();
+                    }
+                    heap->push_back(std::pair<double, const RSGISInterpolatorDataPoint*>(distSq, &pts[i]));
+                    std::push_heap(heap->begin(), heap->end(), compareDist);
+                    if(heap->size() == k)
+                    {
+                        *maxDistSq = heap->front().first;
+                    }
+                }
+            }
+            return;
+        }
+        
+        size_t mid = start + ((end - start) / 2);
+        double diffX = eastings - pts[mid].x;
+        double diffY = northings - pts[mid].y;
+        double distSq = (diffX * diffX) + (diffY * diffY);
+        if((distSq <= *maxDistSq) && ((heap->size() < k) || (distSq < heap->front().first)))
+        {
+            if(heap->size() == k)
+            {
+                std::pop_heap(heap->begin(), heap->end(), compareDist);
+                heap->pop_back();
+            }
+            heap->push_back(std::pair<double, const RSGISInterpolatorDataPoint*>(distSq, &pts[mid]));
+            std::push_heap(heap->begin(), heap->end(), compareDist);
+            if(heap->size() == k)
+            {
+                *maxDistSq = heap->front().first;
+            }
+        }
+        
+        // Search the side of the splitting plane containing the location first.
+        double diffPlane = ((depth % 2) == 0)?diffX:diffY;
+        if(diffPlane < 0)
+        {
+            this->searchKNN(start, mid, depth+1, eastings, northings, k, heap, maxDistSq);
+            if((diffPlane * diffPlane) <= *maxDistSq)
+            {
+                this->searchKNN(mid+1, end, depth+1, eastings, northings, k, heap, maxDistSq);
+            }
+        }
+        else
+        {
+            this->searchKNN(mid+1, end, depth+1, eastings, northings, k, heap, maxDistSq);
+            if((diffPlane * diffPlane) <= *maxDistSq)
+            {
+                this->searchKNN(start, mid, depth+1, eastings, northings, k, heap, maxDistSq);
+            }
+        }
+    }
+    
+    
+    
+    void RSGIS2DInterpolator::getValues(double tlEastings, double tlNorthings, double xRes, double yRes, unsigned int numCols, unsigned int numRows, float *vals)
+    {
+        double northings = tlNorthings;
+        for(unsigned int i = 0; i < numRows; ++i)
+        {
+            double eastings = tlEastings;
+            for(unsigned int j = 0; j < numCols; ++j)
+            {
+                vals[(((size_t)i)*numCols)+j] = this->getValue(eastings, northings);
+                eastings += xRes;
+            }
+            northings += yRes;
+        }
+    }
+    
+    
     
     RSGISSearchKNN2DInterpolator::RSGISSearchKNN2DInterpolator(unsigned int k): RSGIS2DInterpolator()
     {
         this->k = k;
+        this->ptsIndex = NULL;
+        this->initialised = false;
     }
     
     void RSGISSearchKNN2DInterpolator::initInterpolator(std::vector<RSGISInterpolatorDataPoint> *pts)
@@ -42,6 +181,11 @@ namespace rsgis {namespace math{
             }
             
             this->dataPTS = pts;
+            if(this->ptsIndex != NULL)
+            {
+                delete this->ptsIndex;
+            }
+            this->ptsIndex = new RSGIS2DPointKDTree(pts);
         }
         catch(RSGISInterpolationException &e)
         {
@@ -54,45 +198,76 @@ namespace rsgis {namespace math{
     std::list<std::pair<double,RSGISInterpolatorDataPoint> >* RSGISSearchKNN2DInterpolator::findKNN(double eastings, double northings)
     {
         std::list<std::pair<double,RSGISInterpolatorDataPoint> > *knn = new std::list<std::pair<double,RSGISInterpolatorDataPoint> >();
-        try
+        std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > knnPts;
+        this->ptsIndex->findKNN(eastings, northings, this->k, &knnPts);
+        for(std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> >::iterator iterK = knnPts.begin(); iterK != knnPts.end(); ++iterK)
+        {
+            knn->push_back(std::pair<double,RSGISInterpolatorDataPoint>((*iterK).first, *(*iterK).second));
+        }
+        return knn;
+    }
+    
+    void RSGISSearchKNN2DInterpolator::getValues(double tlEastings, double tlNorthings, double xRes, double yRes, unsigned int numCols, unsigned int numRows, float *vals)
+    {
+        if(!initialised)
         {
-            double dist = 0.0;
-            for(std::vector<RSGISInterpolatorDataPoint>::iterator iterPts = dataPTS->begin(); iterPts != dataPTS->end(); ++iterPts)
+            throw RSGISInterpolationException("Interpolated needs to be initialised before values can be retrieved.");
+        }
+        
+        // The k nearest neighbours of a location are all within the distance to the kth neighbour
+        // of the previous location plus the distance between the locations, which limits the search.
+        double stepDist = fabs(xRes);
+        auto calcRow = [this, tlEastings, tlNorthings, xRes, yRes, numCols, vals, stepDist](unsigned int row)
+        {
+            std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > knn;
+            knn.reserve(this->k);
+            double northings = tlNorthings + (row * yRes);
+            double prevKDist = -1;
+            for(unsigned int j = 0; j < numCols; ++j)
             {
-                dist = sqrt(pow((eastings-(*iterPts).x),2) + pow((northings-(*iterPts).y),2));
-                
-                if(knn->empty())
+                double eastings = tlEastings + (j * xRes);
+                if(prevKDist >= 0)
                 {
-                    knn->push_back(std::pair<double,RSGISInterpolatorDataPoint>(dist, *iterPts));
-                }
-                else
-                {
-                    for(std::list<std::pair<double,RSGISInterpolatorDataPoint> >::iterator iterK = knn->begin(); iterK != knn->end(); ++iterK)
-                    {
-                        if((*iterK).first > dist)
-                        {
-                            knn->insert(iterK, std::pair<double,RSGISInterpolatorDataPoint>(dist, *iterPts));
-                            break;
-                        }
-                    }
+                    this->ptsIndex->findKNN(eastings, northings, this->k, &knn, ((prevKDist + stepDist) * (1 + 1e-9)) + 1e-12);
                 }
-
-                if(knn->size() < k)
+                if((prevKDist < 0) || (knn.size() < this->k))
                 {
-                    knn->push_back(std::pair<double,RSGISInterpolatorDataPoint>(dist, *iterPts));
+                    this->ptsIndex->findKNN(eastings, northings, this->k, &knn);
                 }
-                else if(knn->size() > k)
+                if(knn.size() != this->k)
                 {
-                    knn->pop_back();
+                    throw RSGISInterpolationException("Insufficient number of K points where identified.");
                 }
+                prevKDist = knn.back().first;
+                vals[(((size_t)row)*numCols)+j] = this->calcKNNValue(&knn);
             }
+        };
+        
+        unsigned int numThreads = rsgis::RSGISThreadPool::getDefaultNumThreads();
+        if((numThreads > 1) && (numRows > 1))
+        {
+            rsgis::RSGISThreadPool threadPool(numThreads);
+            for(unsigned int i = 0; i < numRows; ++i)
+            {
+                threadPool.submit([&calcRow, i](unsigned int threadIdx){calcRow(i);});
+            }
+            threadPool.wait();
         }
-        catch(RSGISInterpolationException &e)
+        else
         {
-            delete knn;
-            throw e;
+            for(unsigned int i = 0; i < numRows; ++i)
+            {
+                calcRow(i);
+            }
+        }
+    }
+    
+    RSGISSearchKNN2DInterpolator::~RSGISSearchKNN2DInterpolator()
+    {
+        if(this->ptsIndex != NULL)
+        {
+            delete this->ptsIndex;
         }
-        return knn;
     }
     
     
@@ -254,15 +429,15 @@ namespace rsgis {namespace math{
         {
             try
             {
-                std::list<std::pair<double,RSGISInterpolatorDataPoint> > *knn = this->findKNN(eastings, northings);
-                if(knn->size() != this->k)
+                std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > knn;
+                this->ptsIndex->findKNN(eastings, northings, this->k, &knn);
+                if(knn.size() != this->k)
                 {
                     std::cout << "this->k = " << this->k << std::endl;
-                    std::cout << "knn->size() = " << knn->size() << std::endl;
+                    std::cout << "knn.size() = " << knn.size() << std::endl;
                     throw RSGISInterpolationException("Insufficient number of K points where identified.");
                 }
-                outValue = knn->front().second.value;
-                delete knn;
+                outValue = this->calcKNNValue(&knn);
             }
             catch(RSGISInterpolationException &e)
             {
@@ -272,6 +447,49 @@ namespace rsgis {namespace math{
         return outValue;
     }
     
+    double RSGISKNearestNeighbour2DInterpolator::calcKNNValue(std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > *knn)
+    {
+        return knn->front().second->value;
+    }
+    
+    
+    
+    
+    double RSGISKNNIDWInterpolator::getValue(double eastings, double northings)
+    {
+        double outValue = std::numeric_limits<double>::signaling_NaN();
+        if(initialised)
+        {
+            std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > knn;
+            this->ptsIndex->findKNN(eastings, northings, this->k, &knn);
+            if(knn.size() != this->k)
+            {
+                throw RSGISInterpolationException("Insufficient number of K points where identified.");
+            }
+            outValue = this->calcKNNValue(&knn);
+        }
+        return outValue;
+    }
+    
+    double RSGISKNNIDWInterpolator::calcKNNValue(std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > *knn)
+    {
+        // A location on a data point takes the value of the point.
+        if(knn->front().first == 0)
+        {
+            return knn->front().second->value;
+        }
+        double totalWeight = 0.0;
+        double sumValues = 0.0;
+        double weight = 0.0;
+        for(std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> >::iterator iterK = knn->begin(); iterK != knn->end(); ++iterK)
+        {
+            weight = 1 / pow((*iterK).first, (double)this->p);
+            totalWeight += weight;
+            sumValues += (*iterK).second->value * weight;
+        }
+        return sumValues / totalWeight;
+    }
+    
     
     
     
@@ -279,6 +497,18 @@ namespace rsgis {namespace math{
     void RSGISAllPointsIDWInterpolator::initInterpolator(std::vector<RSGISInterpolatorDataPoint> *pts)
     {
         this->pts = pts;
+        this->ptsX.clear();
+        this->ptsY.clear();
+        this->ptsVal.clear();
+        this->ptsX.reserve(pts->size());
+        this->ptsY.reserve(pts->size());
+        this->ptsVal.reserve(pts->size());
+        for(std::vector<RSGISInterpolatorDataPoint>::iterator iterPts = pts->begin(); iterPts != pts->end(); ++iterPts)
+        {
+            this->ptsX.push_back((*iterPts).x);
+            this->ptsY.push_back((*iterPts).y);
+            this->ptsVal.push_back((*iterPts).value);
+        }
         this->initialised = true;
     }
     
@@ -287,33 +517,63 @@ namespace rsgis {namespace math{
         float outValue = std::numeric_limits<float>::signaling_NaN();
         if(initialised)
         {
-            try
+            // The weights and weighted sum are calculated in a single pass using
+            // the squared distance (pow(distSq, p/2) == pow(dist, p)).
+            double halfP = ((double)this->p) / 2.0;
+            double totalWeight = 0.0;
+            double sumValues = 0.0;
+            double weight = 0.0;
+            double diffX = 0.0;
+            double diffY = 0.0;
+            double distSq = 0.0;
+            size_t numPts = this->ptsX.size();
+            for(size_t i = 0; i < numPts; ++i)
             {
-                double totalWeight = 0.0;
-                double weight = 0.0;
-                for(std::vector<RSGISInterpolatorDataPoint>::iterator iterPts = pts->begin(); iterPts != pts->end(); ++iterPts)
-                {
-                    weight = 1 / pow(sqrt(pow((eastings - (*iterPts).x), 2) + pow((northings - (*iterPts).y), 2)),(double)this->p);
-                    totalWeight += weight;
-                }
-                
-                
-                outValue = 0.0;
-                
-                for(std::vector<RSGISInterpolatorDataPoint>::iterator iterPts = pts->begin(); iterPts != pts->end(); ++iterPts)
+                diffX = eastings - this->ptsX[i];
+                diffY = northings - this->ptsY[i];
+                distSq = (diffX * diffX) + (diffY * diffY);
+                if(distSq == 0)
                 {
-                    weight = 1 / pow(sqrt(pow((eastings - (*iterPts).x), 2) + pow((northings - (*iterPts).y), 2)),(double)this->p);
-                    
-                    outValue += ((*iterPts).value * weight) / totalWeight;
+                    // A location on a data point takes the value of the point.
+                    return this->ptsVal[i];
                 }
-                
+                weight = 1 / pow(distSq, halfP);
+                totalWeight += weight;
+                sumValues += this->ptsVal[i] * weight;
             }
-            catch(RSGISInterpolationException &e)
+            outValue = sumValues / totalWeight;
+        }
+        return outValue;
+    }
+    
+    void RSGISAllPointsIDWInterpolator::getValues(double tlEastings, double tlNorthings, double xRes, double yRes, unsigned int numCols, unsigned int numRows, float *vals)
+    {
+        auto calcRow = [this, tlEastings, tlNorthings, xRes, yRes, numCols, vals](unsigned int row)
+        {
+            double northings = tlNorthings + (row * yRes);
+            for(unsigned int j = 0; j < numCols; ++j)
             {
-                throw e;
+                vals[(((size_t)row)*numCols)+j] = this->getValue(tlEastings + (j * xRes), northings);
+            }
+        };
+        
+        unsigned int numThreads = rsgis::RSGISThreadPool::getDefaultNumThreads();
+        if((numThreads > 1) && (numRows > 1))
+        {
+            rsgis::RSGISThreadPool threadPool(numThreads);
+            for(unsigned int i = 0; i < numRows; ++i)
+            {
+                threadPool.submit([&calcRow, i](unsigned int threadIdx){calcRow(i);});
+            }
+            threadPool.wait();
+        }
+        else
+        {
+            for(unsigned int i = 0; i < numRows; ++i)
+            {
+                calcRow(i);
             }
         }
-        return outValue;
     }
     
    
@@ -28,9 +28,15 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <limits>
 
 #include "RSGISMathsUtils.h"
 
+#include "common/RSGISThreadPool.h"
+
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Delaunay_triangulation_2.h>
 #include <CGAL/Interpolation_traits_2.h>
@@ -88,12 +94,46 @@ namespace rsgis {namespace math{
         double value;
     };
     
+    /**
+     * A KD-tree over a copy of a set of data points for nearest neighbour
+     * searches. The tree is implicit (the points are reordered so the median
+     * of each sub-range is the splitting point) and is read only once built
+     * so it can be searched from multiple threads at the same time.
+     */
+    class DllExport RSGIS2DPointKDTree
+    {
+    public:
+        RSGIS2DPointKDTree(std::vector<RSGISInterpolatorDataPoint> *pts);
+        /**
+         * Find the k nearest points, sorted by increasing distance, where the first of each pair
+         * is the distance. Only points within maxDist are returned so fewer than k points may be found.
+         */
+        void findKNN(double eastings, double northings, unsigned int k, std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > *knn, double maxDist=std::numeric_limits<double>::max()) const;
+        size_t getNumPoints() const {return this->pts.size();};
+        ~RSGIS2DPointKDTree(){};
+    protected:
+        void buildTree(size_t start, size_t end, unsigned int depth);
+        void searchKNN(size_t start, size_t end, unsigned int depth, double eastings, double northings, unsigned int k, std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > *heap, double *maxDistSq) const;
+        static bool compareX(const RSGISInterpolatorDataPoint &a, const RSGISInterpolatorDataPoint &b){return a.x < b.x;};
+        static bool compareY(const RSGISInterpolatorDataPoint &a, const RSGISInterpolatorDataPoint &b){return a.y < b.y;};
+        static bool compareDist(const std::pair<double, const RSGISInterpolatorDataPoint*> &a, const std::pair<double, const RSGISInterpolatorDataPoint*> &b){return a.first < b.first;};
+        static const size_t leafSize = 8;
+        std::vector<RSGISInterpolatorDataPoint> pts;
+    };
+    
     class DllExport RSGIS2DInterpolator
 	{
 	public:
 		RSGIS2DInterpolator(){};
 		virtual void initInterpolator(std::vector<RSGISInterpolatorDataPoint> *pts) = 0;
 		virtual double getValue(double eastings, double northings) = 0;
+        /**
+         * Get the values for a grid of numCols x numRows locations starting at (tlEastings, tlNorthings)
+         * with a step of xRes and yRes (vals[(row*numCols)+col]). The default calls getValue for
+         * each location; interpolators where it is worthwhile override this to reuse the
+         * neighbourhood between adjacent locations and to calculate the rows in parallel.
+         */
+        virtual void getValues(double tlEastings, double tlNorthings, double xRes, double yRes, unsigned int numCols, unsigned int numRows, float *vals);
 		virtual ~RSGIS2DInterpolator(){};
 	protected:
 		bool initialised;
@@ -105,11 +145,16 @@ namespace rsgis {namespace math{
 		RSGISSearchKNN2DInterpolator(unsigned int k);
 		virtual void initInterpolator(std::vector<RSGISInterpolatorDataPoint> *pts);
         virtual double getValue(double eastings, double northings) = 0;
-		virtual ~RSGISSearchKNN2DInterpolator(){};
+        /** Finds the k nearest neighbours of each location, starting the search from the neighbourhood of the previous location on the row. */
+        virtual void getValues(double tlEastings, double tlNorthings, double xRes, double yRes, unsigned int numCols, unsigned int numRows, float *vals);
+		virtual ~RSGISSearchKNN2DInterpolator();
 	protected:
         virtual std::list<std::pair<double,RSGISInterpolatorDataPoint> >* findKNN(double eastings, double northings);
+        /** Calculate the value at a location from its k nearest neighbours (sorted by distance). */
+        virtual double calcKNNValue(std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > *knn) = 0;
 		unsigned int k;
         std::vector<RSGISInterpolatorDataPoint> *dataPTS;
+        RSGIS2DPointKDTree *ptsIndex;
 	};
     
     class DllExport RSGIS2DTriagulatorInterpolator: public RSGIS2DInterpolator
@@ -155,6 +200,22 @@ namespace rsgis {namespace math{
 		RSGISKNearestNeighbour2DInterpolator(unsigned int k):RSGISSearchKNN2DInterpolator(k){};
 		double getValue(double eastings, double northings);
 		~RSGISKNearestNeighbour2DInterpolator(){};
+    protected:
+        double calcKNNValue(std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > *knn);
+	};
+    
+    /**
+     * Inverse distance weighting using the k nearest data points to each location.
+     */
+    class DllExport RSGISKNNIDWInterpolator : public RSGISSearchKNN2DInterpolator
+	{
+	public:
+		RSGISKNNIDWInterpolator(unsigned int k, float p):RSGISSearchKNN2DInterpolator(k){this->p = p;};
+		double getValue(double eastings, double northings);
+		~RSGISKNNIDWInterpolator(){};
+    protected:
+        double calcKNNValue(std::vector<std::pair<double, const RSGISInterpolatorDataPoint*> > *knn);
+        float p;
 	};
     
     
@@ -164,9 +225,15 @@ namespace rsgis {namespace math{
 		RSGISAllPointsIDWInterpolator(float p):RSGIS2DInterpolator(){this->p = p;};
         void initInterpolator(std::vector<RSGISInterpolatorDataPoint> *pts);
 		double getValue(double eastings, double northings);
+        /** Calculates the rows in parallel. */
+        void getValues(double tlEastings, double tlNorthings, double xRes, double yRes, unsigned int numCols, unsigned int numRows, float *vals);
 		~RSGISAllPointsIDWInterpolator(){};
     protected:
         std::vector<RSGISInterpolatorDataPoint> *pts;
+        /** The point coordinates and values as separate contiguous arrays. */
+        std::vector<double> ptsX;
+        std::vector<double> ptsY;
+        std::vector<double> ptsVal;
         float p;
 	};
     
@@ -837,9 +837,11 @@ namespace rsgis {namespace math{
     
 
 
-    RSGISKMeansClusterer::RSGISKMeansClusterer(InitClustererMethods initCentres)
+    RSGISKMeansClusterer::RSGISKMeansClusterer(InitClustererMethods initCentres, unsigned int numThreads, unsigned int miniBatchSize)
     {
         this->initCentres = initCentres;
+        this->numThreads = numThreads;
+        this->miniBatchSize = miniBatchSize;
     }
         
     std::vector< RSGISClusterCentre >* RSGISKMeansClusterer::calcClusterCentres(std::vector< std::vector<float> > *input, unsigned int numFeatures, unsigned int numClusters, unsigned int maxNumIterations, float degreeOfChange)
@@ -901,32 +903,37 @@ namespace rsgis {namespace math{
             delete[] minVals;
             delete[] maxVals;
             
-            std::vector< std::pair< unsigned int, std::vector<float> > > *clusterData = this->createClusterDataInitClusterIDs(input, clusterCentres);
+            // Iterate using the samples and centres held as contiguous arrays.
+            RSGISKMeansEngine kmeans(numFeatures, this->numThreads);
+            kmeans.addSamples(input);
             
-            unsigned int nIter = 0;
-            unsigned int nChange = 0;
-            float amountOfChange = 0;
+            std::vector<float> centres;
+            centres.reserve(clusterCentres->size() * numFeatures);
+            for(std::vector< RSGISClusterCentre >::iterator iterClusters = clusterCentres->begin(); iterClusters != clusterCentres->end(); ++iterClusters)
+            {
+                centres.insert(centres.end(), (*iterClusters).centre.begin(), (*iterClusters).centre.begin()+numFeatures);
+            }
             
-            std::cout << "Starting Iterative processing...\n";
-            bool contProcess = true;
-            while(contProcess)
+            std::vector<unsigned int> labels;
+            std::vector<unsigned int> numPxls;
+            if((this->miniBatchSize > 0) && (this->miniBatchSize < input->size()))
             {
-                contProcess = false;
-                
-                this->recalcClusterCentres(clusterData, clusterCentres, false);
-                
-                nChange = this->reassignClusterIDs(clusterData, clusterCentres);
-                
-                amountOfChange = ((float)nChange)/clusterData->size();
-                
-                std::cout << "Iteration " << nIter << " has change " << amountOfChange*100 << " % of data clump IDs (" << clusterCentres->size() << " clusters).\n";
-                
-                if((nIter < maxNumIterations) & (amountOfChange > degreeOfChange))
-                {
-                    contProcess = true;
-                }
-                ++nIter;
-            }            
+                kmeans.clusterSamplesMiniBatch(&centres, &labels, &numPxls, this->miniBatchSize, maxNumIterations, degreeOfChange);
+            }
+            else
+            {
+                kmeans.clusterSamples(&centres, &labels, &numPxls, maxNumIterations, degreeOfChange);
+            }
+            
+            clusterCentres->clear();
+            for(unsigned int i = 0; i < numPxls.size(); ++i)
+            {
+                RSGISClusterCentre cCentre;
+                cCentre.centre.assign(centres.begin()+(i*numFeatures), centres.begin()+((i+1)*numFeatures));
+                cCentre.stdDev.assign(numFeatures, 0);
+                cCentre.numPxl = numPxls[i];
+                clusterCentres->push_back(cCentre);
+            }
         } 
         catch (RSGISClustererException &e) 
         {
@@ -30,6 +30,7 @@
 #include "math/RSGISProbabilityDistributions.h"
 #include "math/RSGISRandomDistro.h"
 #include "math/RSGISClustererException.h"
+#include "math/RSGISKMeansEngine.h"
 
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
@@ -110,11 +111,18 @@ namespace rsgis {namespace math{
     class DllExport RSGISKMeansClusterer: public RSGISClusterer
     {
     public:
-		RSGISKMeansClusterer(InitClustererMethods initCentres);
+        /**
+         * numThreads is the number of threads used to assign the samples to the centres (0 = library default).
+         * If miniBatchSize is greater than 0 (and less than the number of samples) the centres are updated
+         * using random batches of miniBatchSize samples (mini-batch k-means) rather than all the samples.
+         */
+		RSGISKMeansClusterer(InitClustererMethods initCentres, unsigned int numThreads=0, unsigned int miniBatchSize=0);
         std::vector< RSGISClusterCentre >* calcClusterCentres(std::vector< std::vector<float> > *input, unsigned int numFeatures, unsigned int numClusters, unsigned int maxNumIterations, float degreeOfChange);
 		~RSGISKMeansClusterer();
     private:
         InitClustererMethods initCentres;
+        unsigned int numThreads;
+        unsigned int miniBatchSize;
     };
     
     class DllExport RSGISISODataClusterer: public RSGISClusterer
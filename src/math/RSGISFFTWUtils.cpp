@@ -30,6 +30,100 @@ namespace rsgis{namespace math{
 		
 	}
 	
+	unsigned int RSGISFFTWUtils::calcFFTSize(unsigned int n)
+	{
+		unsigned int size = 1;
+		while(size < n)
+		{
+			size = size << 1;
+		}
+		return size;
+	}
+	
+	void RSGISFFTWUtils::fft1D(std::complex<double> *data, unsigned int n, unsigned int stride, bool inverse)
+	{
+		if((n == 0) | ((n & (n-1)) != 0))
+		{
+			throw RSGISMatricesException("The FFT length must be a power of 2.");
+		}
+		
+		// Reorder into bit reversed order
+		for(unsigned int i = 1, j = 0; i < n; ++i)
+		{
+			unsigned int bit = n >> 1;
+			for(; j & bit; bit = bit >> 1)
+			{
+				j = j ^ bit;
+			}
+			j = j ^ bit;
+			if(i < j)
+			{
+				std::swap(data[i*stride], data[j*stride]);
+			}
+		}
+		
+		// Butterflies
+		double sign = inverse?1.0:-1.0;
+		std::vector< std::complex<double> > twiddles;
+		for(unsigned int len = 2; len <= n; len = len << 1)
+		{
+			unsigned int halfLen = len >> 1;
+			twiddles.resize(halfLen);
+			for(unsigned int k = 0; k < halfLen; ++k)
+			{
+				double angle = sign * 2.0 * M_PI * k / len;
+				twiddles[k] = std::complex<double>(cos(angle), sin(angle));
+			}
+			for(unsigned int i = 0; i < n; i += len)
+			{
+				for(unsigned int k = 0; k < halfLen; ++k)
+				{
+					std::complex<double> u = data[(i+k)*stride];
+					std::complex<double> v = data[(i+k+halfLen)*stride] * twiddles[k];
+					data[(i+k)*stride] = u + v;
+					data[(i+k+halfLen)*stride] = u - v;
+				}
+			}
+		}
+	}
+	
+	void RSGISFFTWUtils::fft2D(std::vector< std::complex<double> > *data, unsigned int width, unsigned int height, bool inverse)
+	{
+		if(data->size() != (((size_t)width) * height))
+		{
+			throw RSGISMatricesException("The data size does not match the width and height provided.");
+		}
+		
+		for(unsigned int y = 0; y < height; ++y)
+		{
+			this->fft1D(&(*data)[((size_t)y)*width], width, 1, inverse);
+		}
+		
+		// Copy each column so the transform works on contiguous values.
+		std::vector< std::complex<double> > column(height);
+		for(unsigned int x = 0; x < width; ++x)
+		{
+			for(unsigned int y = 0; y < height; ++y)
+			{
+				column[y] = (*data)[(((size_t)y)*width)+x];
+			}
+			this->fft1D(&column[0], height, 1, inverse);
+			for(unsigned int y = 0; y < height; ++y)
+			{
+				(*data)[(((size_t)y)*width)+x] = column[y];
+			}
+		}
+		
+		if(inverse)
+		{
+			double scale = 1.0 / (((double)width) * height);
+			for(size_t i = 0; i < data->size(); ++i)
+			{
+				(*data)[i] *= scale;
+			}
+		}
+	}
+	
 	RSGISFFTWUtils::~RSGISFFTWUtils()
 	{
 		
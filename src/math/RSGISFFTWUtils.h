@@ -24,6 +24,8 @@
 #define RSGISFFTWUtils_H
 
 #include <complex>
+#include <vector>
+#include <algorithm>
 //#include <fftw3.h>
 #include <math.h>
 #include "RSGISMatrices.h"
@@ -44,11 +46,20 @@
 
 namespace rsgis{namespace math{
 	    
+	/**
+	 * Fast Fourier transforms (radix-2) of complex data whose dimensions
+	 * are powers of 2; calcFFTSize gives the size to pad the data to.
+	 */
 	class DllExport RSGISFFTWUtils
 		{
 		public:
 			RSGISFFTWUtils();
-
+			/** The smallest power of 2 which is not less than n. */
+			unsigned int calcFFTSize(unsigned int n);
+			/** In-place transform of n values, each stride values apart. The inverse is not scaled. */
+			void fft1D(std::complex<double> *data, unsigned int n, unsigned int stride, bool inverse);
+			/** In-place transform of width x height values (row by row). The inverse is scaled by 1/(width*height). */
+			void fft2D(std::vector< std::complex<double> > *data, unsigned int width, unsigned int height, bool inverse);
 			~RSGISFFTWUtils();
 		};
 }}
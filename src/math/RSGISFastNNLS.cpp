@@ -0,0 +1,316 @@
+/*
+ *  RSGISFastNNLS.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISFastNNLS.h"
+
+namespace rsgis{namespace math{
+
+    RSGISFastNNLS::RSGISFastNNLS(const double *AtA, unsigned int n, unsigned int maxIter)
+    {
+        if(n == 0)
+        {
+            throw RSGISMathException("The number of variables for the NNLS must be greater than 0.");
+        }
+        this->n = n;
+        this->maxIter = maxIter;
+        if(this->maxIter == 0)
+        {
+            this->maxIter = 3 * n;
+        }
+        this->AtA.assign(AtA, AtA + (((size_t)n) * n));
+
+        // Tolerance as used by Bro and De Jong: 10 * eps * ||A'A||_1 * n
+        double maxColSum = 0;
+        for(unsigned int j = 0; j < n; ++j)
+        {
+            double colSum = 0;
+            for(unsigned int i = 0; i < n; ++i)
+            {
+                colSum += fabs(this->AtA[(i*n)+j]);
+            }
+            if(colSum > maxColSum)
+            {
+                maxColSum = colSum;
+            }
+        }
+        this->tol = 10 * std::numeric_limits<double>::epsilon() * maxColSum * n;
+
+        this->passive.assign(n, 0);
+        this->excluded.assign(n, 0);
+        this->passiveIdxs.reserve(n);
+        this->w.assign(n, 0.0);
+        this->s.assign(n, 0.0);
+        this->chol.assign(((size_t)n) * n, 0.0);
+        this->rhs.assign(n, 0.0);
+    }
+
+    unsigned int RSGISFastNNLS::solve(const double *Atb, double *x, bool warmStart)
+    {
+        unsigned int numIter = 0;
+        for(unsigned int j = 0; j < this->n; ++j)
+        {
+            x[j] = 0;
+        }
+        if(!warmStart)
+        {
+            this->resetPassiveSet();
+        }
+
+        // Start from the previous passive set, removing the variables which are
+        // not positive until the least squares solution on the set is feasible.
+        bool havePassive = false;
+        for(unsigned int j = 0; j < this->n; ++j)
+        {
+            if(this->passive[j])
+            {
+                havePassive = true;
+                break;
+            }
+        }
+        while(havePassive)
+        {
+            if(!this->solvePassive(Atb, &this->s[0]))
+            {
+                this->resetPassiveSet();
+                break;
+            }
+            bool feasible = true;
+            havePassive = false;
+            for(unsigned int j = 0; j < this->n; ++j)
+            {
+                if(this->passive[j])
+                {
+                    if(this->s[j] <= this->tol)
+                    {
+                        this->passive[j] = 0;
+                        feasible = false;
+                    }
+                    else
+                    {
+                        havePassive = true;
+                    }
+                }
+            }
+            if(feasible)
+            {
+                for(unsigned int j = 0; j < this->n; ++j)
+                {
+                    x[j] = this->passive[j]?this->s[j]:0;
+                }
+                break;
+            }
+        }
+        this->calcGradient(Atb, x);
+        this->resetExcluded();
+
+        while(numIter < this->maxIter)
+        {
+            // Add the variable with the largest positive gradient (which has not been
+            // excluded since x last changed) to the passive set.
+            int maxIdx = -1;
+            double maxW = this->tol;
+            for(unsigned int j = 0; j < this->n; ++j)
+            {
+                if((!this->passive[j]) && (!this->excluded[j]) && (this->w[j] > maxW))
+                {
+                    maxW = this->w[j];
+                    maxIdx = j;
+                }
+            }
+            if(maxIdx < 0)
+            {
+                break;
+            }
+            this->passive[maxIdx] = 1;
+            ++numIter;
+            bool solved = this->solvePassive(Atb, &this->s[0]);
+            if((!solved) || (this->s[maxIdx] <= this->tol))
+            {
+                // Either the variable is linearly dependent on those in the passive set or the step
+                // would be 0 and the variable removed again, leaving x and w unchanged (so it would be
+                // selected again until the iteration limit). As Lawson and Hanson, exclude it and try
+                // the variable with the next largest gradient.
+                this->passive[maxIdx] = 0;
+                this->excluded[maxIdx] = 1;
+                continue;
+            }
+
+            // Step back towards x until the solution is feasible.
+            while(numIter < this->maxIter)
+            {
+                double alpha = 2;
+                for(unsigned int j = 0; j < this->n; ++j)
+                {
+                    if(this->passive[j] && (this->s[j] <= this->tol))
+                    {
+                        double diff = x[j] - this->s[j];
+                        double alphaTmp = (diff > 0)?(x[j] / diff):0;
+                        if(alphaTmp < alpha)
+                        {
+                            alpha = alphaTmp;
+                        }
+                    }
+                }
+                if(alpha > 1)
+                {
+                    break;
+                }
+                ++numIter;
+                for(unsigned int j = 0; j < this->n; ++j)
+                {
+                    if(this->passive[j])
+                    {
+                        x[j] += alpha * (this->s[j] - x[j]);
+                        if(x[j] <= this->tol)
+                        {
+                            x[j] = 0;
+                            this->passive[j] = 0;
+                        }
+                    }
+                }
+                this->solvePassive(Atb, &this->s[0]);
+            }
+
+            for(unsigned int j = 0; j < this->n; ++j)
+            {
+                x[j] = this->passive[j]?this->s[j]:0;
+                if(x[j] < 0)
+                {
+                    // Only possible when the iteration limit was reached within the inner loop.
+                    x[j] = 0;
+                    this->passive[j] = 0;
+                }
+            }
+            this->calcGradient(Atb, x);
+            this->resetExcluded();
+        }
+
+        return numIter;
+    }
+
+    void RSGISFastNNLS::resetPassiveSet()
+    {
+        for(unsigned int j = 0; j < this->n; ++j)
+        {
+            this->passive[j] = 0;
+        }
+    }
+
+    void RSGISFastNNLS::resetExcluded()
+    {
+        for(unsigned int j = 0; j < this->n; ++j)
+        {
+            this->excluded[j] = 0;
+        }
+    }
+
+    bool RSGISFastNNLS::solvePassive(const double *Atb, double *s)
+    {
+        this->passiveIdxs.clear();
+        for(unsigned int j = 0; j < this->n; ++j)
+        {
+            s[j] = 0;
+            if(this->passive[j])
+            {
+                this->passiveIdxs.push_back(j);
+            }
+        }
+        size_t nP = this->passiveIdxs.size();
+        if(nP == 0)
+        {
+            return true;
+        }
+
+        // Cholesky decomposition (L, lower triangle) of the passive rows and columns of A'A.
+        double *L = &this->chol[0];
+        for(size_t i = 0; i < nP; ++i)
+        {
+            for(size_t j = 0; j <= i; ++j)
+            {
+                double sum = this->AtA[(((size_t)this->passiveIdxs[i])*this->n)+this->passiveIdxs[j]];
+                for(size_t k = 0; k < j; ++k)
+                {
+                    sum -= L[(i*nP)+k] * L[(j*nP)+k];
+                }
+                if(i == j)
+                {
+                    if(sum <= this->tol)
+                    {
+                        return false;
+                    }
+                    L[(i*nP)+i] = sqrt(sum);
+                }
+                else
+                {
+                    L[(i*nP)+j] = sum / L[(j*nP)+j];
+                }
+            }
+        }
+
+        // Forward (L y = A'b) then backward (L' s = y) substitution.
+        double *y = &this->rhs[0];
+        for(size_t i = 0; i < nP; ++i)
+        {
+            double sum = Atb[this->passiveIdxs[i]];
+            for(size_t k = 0; k < i; ++k)
+            {
+                sum -= L[(i*nP)+k] * y[k];
+            }
+            y[i] = sum / L[(i*nP)+i];
+        }
+        for(size_t i = nP; i-- > 0; )
+        {
+            double sum = y[i];
+            for(size_t k = i+1; k < nP; ++k)
+            {
+                sum -= L[(k*nP)+i] * y[k];
+            }
+            y[i] = sum / L[(i*nP)+i];
+        }
+        for(size_t i = 0; i < nP; ++i)
+        {
+            s[this->passiveIdxs[i]] = y[i];
+        }
+        return true;
+    }
+
+    void RSGISFastNNLS::calcGradient(const double *Atb, const double *x)
+    {
+        // w = A'b - A'Ax
+        for(unsigned int i = 0; i < this->n; ++i)
+        {
+            double sum = Atb[i];
+            const double *row = &this->AtA[((size_t)i)*this->n];
+            for(unsigned int j = 0; j < this->n; ++j)
+            {
+                sum -= row[j] * x[j];
+            }
+            this->w[i] = sum;
+        }
+    }
+
+    RSGISFastNNLS::~RSGISFastNNLS()
+    {
+
+    }
+
+}}
@@ -0,0 +1,102 @@
+/*
+ *  RSGISFastNNLS.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISFastNNLS_H
+#define RSGISFastNNLS_H
+
+#include <iostream>
+#include <vector>
+#include <limits>
+#include <math.h>
+
+#include "math/RSGISMathException.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_maths_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace math{
+
+    /**
+     * Non-negative least squares (min ||Ax - b|| for x >= 0) using the active set
+     * method of Lawson and Hanson on the normal equations (the fast NNLS of Bro and
+     * De Jong, 1997). A'A is provided once so each solve only needs A'b, which for
+     * many problems with the same A (e.g., the pixels of an image) can be calculated
+     * for all the problems at once as a matrix product.
+     *
+     * The passive (non-zero) set of the previous solution is kept and, when warmStart
+     * is true, used as the starting point for the next solve which, for similar problems
+     * (e.g., neighbouring pixels), removes most of the iterations. An instance should only
+     * be used by one thread at a time.
+     */
+    class DllExport RSGISFastNNLS
+    {
+    public:
+        /**
+         * AtA is the n x n matrix A'A (row-major) which is copied. If maxIter is 0
+         * the number of iterations is limited to 3n.
+         */
+        RSGISFastNNLS(const double *AtA, unsigned int n, unsigned int maxIter=0);
+        /**
+         * Solve for x (length n) given Atb = A'b (length n). Returns the number of
+         * iterations. If the iteration limit is reached x is the current (feasible) solution.
+         */
+        unsigned int solve(const double *Atb, double *x, bool warmStart=true);
+        /** Clear the passive set kept from the previous solve. */
+        void resetPassiveSet();
+        unsigned int getNumVariables(){return this->n;};
+        ~RSGISFastNNLS();
+    protected:
+        /**
+         * Solve the unconstrained least squares for the variables in the passive set
+         * (Cholesky decomposition of the passive rows and columns of A'A). The other
+         * values of s are set to 0. Returns false if the passive A'A is singular.
+         */
+        bool solvePassive(const double *Atb, double *s);
+        void calcGradient(const double *Atb, const double *x);
+        void resetExcluded();
+        std::vector<double> AtA;
+        unsigned int n;
+        unsigned int maxIter;
+        double tol;
+        std::vector<unsigned char> passive;
+        /** Variables which gave a step of 0 when added to the passive set for the current x. */
+        std::vector<unsigned char> excluded;
+        std::vector<unsigned int> passiveIdxs;
+        std::vector<double> w;
+        std::vector<double> s;
+        std::vector<double> chol;
+        std::vector<double> rhs;
+    };
+
+}}
+
+#endif
@@ -0,0 +1,241 @@
+/*
+ *  RSGISKDTree.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISKDTree.h"
+
+namespace rsgis{namespace math{
+
+    RSGISKDTree::RSGISKDTree(double **data, size_t n, size_t sIdx, size_t eIdx, rsgisdistmetrics distMetric, unsigned int leafSize)
+    {
+        if(eIdx <= sIdx)
+        {
+            throw RSGISMathException("The KD-tree needs at least one dimension.");
+        }
+        if((distMetric != rsgis_euclidean) && (distMetric != rsgis_manhatten))
+        {
+            throw RSGISMathException("The KD-tree only supports Euclidean and Manhattan distances.");
+        }
+        this->numDims = eIdx - sIdx;
+        this->sIdx = sIdx;
+        this->distMetric = distMetric;
+        this->leafSize = (leafSize < 1)?1:leafSize;
+
+        // The points are copied into a single array so the values for each dimension can
+        // be compared while building, then reordered so each leaf is contiguous in memory.
+        // Rows with a non-finite value can never be within a finite distance so are left out.
+        std::vector<double> vals(n * this->numDims);
+        this->pointIdxs.reserve(n);
+        for(size_t i = 0; i < n; ++i)
+        {
+            bool finite = true;
+            for(unsigned int d = 0; d < this->numDims; ++d)
+            {
+                vals[(i * this->numDims) + d] = data[i][sIdx + d];
+                finite = finite && std::isfinite(data[i][sIdx + d]);
+            }
+            if(finite)
+            {
+                this->pointIdxs.push_back(i);
+            }
+        }
+        this->points.swap(vals);
+        this->n = this->pointIdxs.size();
+
+        if(this->n > 0)
+        {
+            this->nodes.reserve(((2 * this->n) / this->leafSize) + 1);
+            this->buildNode(0, this->n);
+        }
+
+        vals.resize(this->n * this->numDims);
+        for(size_t i = 0; i < this->n; ++i)
+        {
+            for(unsigned int d = 0; d < this->numDims; ++d)
+            {
+                vals[(i * this->numDims) + d] = this->points[(this->pointIdxs[i] * this->numDims) + d];
+            }
+        }
+        this->points.swap(vals);
+    }
+
+    size_t RSGISKDTree::buildNode(size_t start, size_t end)
+    {
+        size_t nodeIdx = this->nodes.size();
+        RSGISKDTreeNode node;
+        node.start = start;
+        node.end = end;
+        node.splitDim = 0;
+        node.splitVal = 0;
+        node.left = 0;
+        node.right = 0;
+        this->nodes.push_back(node);
+
+        if((end - start) <= this->leafSize)
+        {
+            return nodeIdx;
+        }
+
+        // Split on the dimension with the largest spread of values.
+        unsigned int numDims = this->numDims;
+        const std::vector<double> &pts = this->points;
+        unsigned int splitDim = 0;
+        double maxSpread = 0;
+        for(unsigned int d = 0; d < numDims; ++d)
+        {
+            double minVal = pts[(this->pointIdxs[start] * numDims) + d];
+            double maxVal = minVal;
+            for(size_t i = start + 1; i < end; ++i)
+            {
+                double val = pts[(this->pointIdxs[i] * numDims) + d];
+                if(val < minVal)
+                {
+                    minVal = val;
+                }
+                else if(val > maxVal)
+                {
+                    maxVal = val;
+                }
+            }
+            if((maxVal - minVal) > maxSpread)
+            {
+                maxSpread = maxVal - minVal;
+                splitDim = d;
+            }
+        }
+        if(!(maxSpread > 0))
+        {
+            // All the points are the same so cannot be split.
+            return nodeIdx;
+        }
+
+        size_t mid = start + ((end - start) / 2);
+        std::nth_element(this->pointIdxs.begin() + start, this->pointIdxs.begin() + mid, this->pointIdxs.begin() + end, [&pts, numDims, splitDim](size_t a, size_t b)
+        {
+            return pts[(a * numDims) + splitDim] < pts[(b * numDims) + splitDim];
+        });
+
+        double splitVal = pts[(this->pointIdxs[mid] * numDims) + splitDim];
+        size_t left = this->buildNode(start, mid);
+        size_t right = this->buildNode(mid, end);
+        this->nodes[nodeIdx].splitDim = splitDim;
+        this->nodes[nodeIdx].splitVal = splitVal;
+        this->nodes[nodeIdx].left = left;
+        this->nodes[nodeIdx].right = right;
+        return nodeIdx;
+    }
+
+    void RSGISKDTree::findKNearest(const double *query, unsigned int k, std::vector<RSGISKDTreeNeighbour> *neighbours, double maxDist, double eps) const
+    {
+        neighbours->clear();
+        if((k == 0) || (this->n == 0))
+        {
+            return;
+        }
+        if(eps < 0)
+        {
+            throw RSGISMathException("The approximation factor (eps) cannot be negative.");
+        }
+
+        RSGISKDTreeQuery q;
+        q.query = query + this->sIdx;
+        q.k = k;
+        q.maxRedDist = this->toRedDist(maxDist);
+        q.pruneScale = this->toRedDist(1.0 + eps);
+        q.offsets.assign(this->numDims, 0.0);
+        q.heap.reserve(k + 1);
+
+        this->searchNode(0, 0.0, &q);
+
+        std::sort_heap(q.heap.begin(), q.heap.end(), RSGISKDTree::neighbourLess);
+        for(std::vector<RSGISKDTreeNeighbour>::iterator iterNeigh = q.heap.begin(); iterNeigh != q.heap.end(); ++iterNeigh)
+        {
+            (*iterNeigh).dist = this->fromRedDist((*iterNeigh).dist);
+        }
+        neighbours->swap(q.heap);
+    }
+
+    void RSGISKDTree::searchNode(size_t nodeIdx, double redDist, RSGISKDTreeQuery *q) const
+    {
+        const RSGISKDTreeNode &node = this->nodes[nodeIdx];
+        unsigned int numDims = this->numDims;
+
+        if(node.left == 0)
+        {
+            // q->heap is a max-heap of the k best (ordered by distance then index).
+            for(size_t i = node.start; i < node.end; ++i)
+            {
+                const double *pt = &this->points[i * numDims];
+                double ptRedDist = 0;
+                for(unsigned int d = 0; d < numDims; ++d)
+                {
+                    ptRedDist = this->accumRedDist(ptRedDist, pt[d] - q->query[d]);
+                }
+                if(!(ptRedDist < q->maxRedDist))
+                {
+                    continue;
+                }
+                RSGISKDTreeNeighbour neigh;
+                neigh.dist = ptRedDist;
+                neigh.idx = this->pointIdxs[i];
+                if(q->heap.size() < q->k)
+                {
+                    q->heap.push_back(neigh);
+                    std::push_heap(q->heap.begin(), q->heap.end(), RSGISKDTree::neighbourLess);
+                }
+                else if(RSGISKDTree::neighbourLess(neigh, q->heap.front()))
+                {
+                    std::pop_heap(q->heap.begin(), q->heap.end(), RSGISKDTree::neighbourLess);
+                    q->heap.back() = neigh;
+                    std::push_heap(q->heap.begin(), q->heap.end(), RSGISKDTree::neighbourLess);
+                }
+            }
+            return;
+        }
+
+        double diff = q->query[node.splitDim] - node.splitVal;
+        size_t nearIdx = (diff < 0)?node.left:node.right;
+        size_t farIdx = (diff < 0)?node.right:node.left;
+
+        this->searchNode(nearIdx, redDist, q);
+
+        // Lower bound on the distance to any point on the far side of the split.
+        double oldOff = q->offsets[node.splitDim];
+        double farRedDist = this->replaceOffset(redDist, oldOff, diff);
+        if(!(farRedDist < q->maxRedDist))
+        {
+            return;
+        }
+        if((q->heap.size() == q->k) && ((farRedDist * q->pruneScale) > q->heap.front().dist))
+        {
+            return;
+        }
+        q->offsets[node.splitDim] = diff;
+        this->searchNode(farIdx, farRedDist, q);
+        q->offsets[node.splitDim] = oldOff;
+    }
+
+    RSGISKDTree::~RSGISKDTree()
+    {
+
+    }
+
+}}
@@ -0,0 +1,146 @@
+/*
+ *  RSGISKDTree.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISKDTree_H
+#define RSGISKDTree_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#include "math/RSGISMathsUtils.h"
+#include "math/RSGISMathException.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_maths_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace math{
+
+    /**
+     * A neighbour found by RSGISKDTree; idx is the row of the point within
+     * the data the tree was built from.
+     */
+    struct DllExport RSGISKDTreeNeighbour
+    {
+        double dist;
+        size_t idx;
+    };
+
+    /**
+     * A KD-tree over the values sIdx to eIdx-1 of each row of a 2D array,
+     * used to find the k nearest rows to a query without comparing the
+     * query to every row. Euclidean (sqrt of the sum of squared differences)
+     * and Manhattan (sum of absolute differences) distances are supported;
+     * for Mahalanobis distance build the tree from whitened values.
+     *
+     * The tree is not changed by queries so findKNearest can be called from
+     * multiple threads at the same time.
+     */
+    class DllExport RSGISKDTree
+    {
+    public:
+        RSGISKDTree(double **data, size_t n, size_t sIdx, size_t eIdx, rsgisdistmetrics distMetric=rsgis_euclidean, unsigned int leafSize=16);
+        /**
+         * Find the (up to) k rows nearest to query[sIdx] to query[eIdx-1] with a
+         * distance less than maxDist. The neighbours are returned in order of
+         * distance, where the lowest row index comes first for equal distances.
+         * If eps is greater than 0 the search is approximate: parts of the tree
+         * are skipped once they cannot contain a row closer than 1/(1+eps) of
+         * the current kth distance, so each distance returned is within a factor
+         * of (1+eps) of the true kth nearest.
+         */
+        void findKNearest(const double *query, unsigned int k, std::vector<RSGISKDTreeNeighbour> *neighbours, double maxDist=std::numeric_limits<double>::infinity(), double eps=0) const;
+        /** The number of rows within the tree, rows with non-finite values are not included. */
+        size_t getNumPoints() const {return this->n;};
+        unsigned int getNumDims() const {return this->numDims;};
+        ~RSGISKDTree();
+    protected:
+        struct RSGISKDTreeNode
+        {
+            size_t start;
+            size_t end;
+            unsigned int splitDim;
+            double splitVal;
+            size_t left;
+            size_t right;
+        };
+        struct RSGISKDTreeQuery
+        {
+            const double *query;
+            unsigned int k;
+            double maxRedDist;
+            double pruneScale;
+            std::vector<double> offsets;
+            std::vector<RSGISKDTreeNeighbour> heap;
+        };
+        size_t buildNode(size_t start, size_t end);
+        void searchNode(size_t nodeIdx, double redDist, RSGISKDTreeQuery *q) const;
+        inline double accumRedDist(double redDist, double diff) const
+        {
+            return (this->distMetric == rsgis_manhatten)?(redDist + std::fabs(diff)):(redDist + (diff * diff));
+        };
+        inline double replaceOffset(double redDist, double oldOff, double newOff) const
+        {
+            if(this->distMetric == rsgis_manhatten)
+            {
+                return redDist - std::fabs(oldOff) + std::fabs(newOff);
+            }
+            return redDist - (oldOff * oldOff) + (newOff * newOff);
+        };
+        inline double toRedDist(double dist) const
+        {
+            return (this->distMetric == rsgis_manhatten)?dist:(dist * dist);
+        };
+        inline double fromRedDist(double redDist) const
+        {
+            return (this->distMetric == rsgis_manhatten)?redDist:std::sqrt(redDist);
+        };
+        static bool neighbourLess(const RSGISKDTreeNeighbour &a, const RSGISKDTreeNeighbour &b)
+        {
+            return (a.dist < b.dist) || ((a.dist == b.dist) && (a.idx < b.idx));
+        };
+        size_t n;
+        unsigned int numDims;
+        size_t sIdx;
+        rsgisdistmetrics distMetric;
+        unsigned int leafSize;
+        std::vector<double> points;
+        std::vector<size_t> pointIdxs;
+        std::vector<RSGISKDTreeNode> nodes;
+    };
+
+}}
+
+#endif
@@ -0,0 +1,472 @@
+/*
+ *  RSGISKMeansEngine.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISKMeansEngine.h"
+
+namespace rsgis{namespace math{
+
+    RSGISKMeansEngine::RSGISKMeansEngine(unsigned int numFeatures, unsigned int numThreads): threadPool(NULL), numSamples(0)
+    {
+        if(numFeatures == 0)
+        {
+            throw RSGISClustererException("The number of features must be greater than zero.");
+        }
+        this->numFeatures = numFeatures;
+        if(numThreads == 0)
+        {
+            numThreads = rsgis::RSGISThreadPool::getDefaultNumThreads();
+        }
+        this->numThreads = numThreads;
+        if(this->numThreads > 1)
+        {
+            this->threadPool = new rsgis::RSGISThreadPool(this->numThreads);
+        }
+        else
+        {
+            this->numThreads = 1;
+        }
+    }
+
+    void RSGISKMeansEngine::addSample(const float *vals)
+    {
+        this->samples.insert(this->samples.end(), vals, vals+this->numFeatures);
+        ++this->numSamples;
+    }
+
+    void RSGISKMeansEngine::addSamples(std::vector< std::vector<float> > *input)
+    {
+        this->samples.reserve(this->samples.size() + (input->size() * this->numFeatures));
+        for(std::vector< std::vector<float> >::iterator iterData = input->begin(); iterData != input->end(); ++iterData)
+        {
+            if((*iterData).size() < this->numFeatures)
+            {
+                throw RSGISClustererException("A sample has fewer values than the number of features.");
+            }
+            this->addSample(&(*iterData)[0]);
+        }
+    }
+
+    void RSGISKMeansEngine::runTasks(std::function<void(size_t, size_t, unsigned int)> func)
+    {
+        if(this->threadPool == NULL)
+        {
+            func(0, this->numSamples, 0);
+            return;
+        }
+
+        size_t samplesPerTask = std::max<size_t>(1024, (this->numSamples / (this->numThreads * 4)) + 1);
+        for(size_t startIdx = 0; startIdx < this->numSamples; startIdx += samplesPerTask)
+        {
+            size_t endIdx = std::min(startIdx + samplesPerTask, this->numSamples);
+            this->threadPool->submit([func, startIdx, endIdx](unsigned int threadIdx)
+            {
+                func(startIdx, endIdx, threadIdx);
+            });
+        }
+        this->threadPool->wait();
+    }
+
+    void RSGISKMeansEngine::assignSamples(const std::vector<float> &centres, std::vector<unsigned int> *labels)
+    {
+        unsigned int numCentres = centres.size() / this->numFeatures;
+        if(numCentres == 0)
+        {
+            throw RSGISClustererException("No cluster centres have been provided.");
+        }
+        labels->resize(this->numSamples);
+
+        const float *centresData = &centres[0];
+        this->runTasks([this, centresData, numCentres, labels](size_t startIdx, size_t endIdx, unsigned int threadIdx)
+        {
+            double dist = 0;
+            double minDist = 0;
+            unsigned int closest = 0;
+            for(size_t i = startIdx; i < endIdx; ++i)
+            {
+                const float *sample = this->getSample(i);
+                closest = 0;
+                minDist = this->calcDistance(sample, centresData);
+                for(unsigned int j = 1; j < numCentres; ++j)
+                {
+                    dist = this->calcDistance(sample, &centresData[j*this->numFeatures]);
+                    if(dist < minDist)
+                    {
+                        minDist = dist;
+                        closest = j;
+                    }
+                }
+                (*labels)[i] = closest;
+            }
+        });
+    }
+
+    unsigned int RSGISKMeansEngine::clusterSamples(std::vector<float> *centres, std::vector<unsigned int> *labels, std::vector<unsigned int> *numPxls, unsigned int maxNumIterations, float degreeOfChange, bool printInfo)
+    {
+        if(this->numSamples == 0)
+        {
+            throw RSGISClustererException("There are no samples to cluster.");
+        }
+        unsigned int numCentres = centres->size() / this->numFeatures;
+        if(numCentres == 0)
+        {
+            throw RSGISClustererException("No cluster centres have been provided.");
+        }
+
+        // Initial assignment, with the bounds for each sample.
+        std::vector<double> upper(this->numSamples);
+        std::vector<double> lower(this->numSamples);
+        labels->resize(this->numSamples);
+        {
+            const float *centresData = &(*centres)[0];
+            this->runTasks([this, centresData, numCentres, labels, &upper, &lower](size_t startIdx, size_t endIdx, unsigned int threadIdx)
+            {
+                for(size_t i = startIdx; i < endIdx; ++i)
+                {
+                    this->findTwoClosest(this->getSample(i), centresData, numCentres, &(*labels)[i], &upper[i], &lower[i]);
+                }
+            });
+        }
+
+        std::vector< std::vector<double> > threadSums(this->numThreads);
+        std::vector< std::vector<size_t> > threadCounts(this->numThreads);
+        std::vector<size_t> threadChanges(this->numThreads);
+        std::vector<double> newCentres;
+        std::vector<size_t> counts;
+        std::vector<unsigned int> centreIdxMap;
+        std::vector<double> moved;
+        std::vector<double> halfMinSep;
+
+        unsigned int nIter = 0;
+        size_t nChange = 0;
+        float amountOfChange = 0;
+
+        if(printInfo)
+        {
+            std::cout << "Starting Iterative processing...\n";
+        }
+        bool contProcess = true;
+        while(contProcess)
+        {
+            contProcess = false;
+
+            // Recalculate the centres from the samples assigned to them.
+            for(unsigned int t = 0; t < this->numThreads; ++t)
+            {
+                threadSums[t].assign(numCentres * this->numFeatures, 0.0);
+                threadCounts[t].assign(numCentres, 0);
+            }
+            this->runTasks([this, labels, &threadSums, &threadCounts](size_t startIdx, size_t endIdx, unsigned int threadIdx)
+            {
+                std::vector<double> &sums = threadSums[threadIdx];
+                std::vector<size_t> &cnts = threadCounts[threadIdx];
+                for(size_t i = startIdx; i < endIdx; ++i)
+                {
+                    const float *sample = this->getSample(i);
+                    unsigned int label = (*labels)[i];
+                    double *sum = &sums[label*this->numFeatures];
+                    for(unsigned int n = 0; n < this->numFeatures; ++n)
+                    {
+                        sum[n] += sample[n];
+                    }
+                    ++cnts[label];
+                }
+            });
+            newCentres.assign(numCentres * this->numFeatures, 0.0);
+            counts.assign(numCentres, 0);
+            for(unsigned int t = 0; t < this->numThreads; ++t)
+            {
+                for(size_t k = 0; k < newCentres.size(); ++k)
+                {
+                    newCentres[k] += threadSums[t][k];
+                }
+                for(unsigned int j = 0; j < numCentres; ++j)
+                {
+                    counts[j] += threadCounts[t][j];
+                }
+            }
+
+            // Remove centres without any samples; the bounds remain valid as the
+            // lower bounds are to the closest of the other centres.
+            centreIdxMap.assign(numCentres, 0);
+            unsigned int numKept = 0;
+            moved.clear();
+            numPxls->clear();
+            for(unsigned int j = 0; j < numCentres; ++j)
+            {
+                if(counts[j] > 0)
+                {
+                    double diff = 0;
+                    double dist = 0;
+                    for(unsigned int n = 0; n < this->numFeatures; ++n)
+                    {
+                        float newVal = newCentres[(j*this->numFeatures)+n] / counts[j];
+                        diff = newVal - (*centres)[(j*this->numFeatures)+n];
+                        dist += diff * diff;
+                        (*centres)[(numKept*this->numFeatures)+n] = newVal;
+                    }
+                    moved.push_back(sqrt(dist));
+                    numPxls->push_back(counts[j]);
+                    centreIdxMap[j] = numKept++;
+                }
+            }
+            if(numKept != numCentres)
+            {
+                centres->resize(numKept * this->numFeatures);
+                for(size_t i = 0; i < this->numSamples; ++i)
+                {
+                    (*labels)[i] = centreIdxMap[(*labels)[i]];
+                }
+                numCentres = numKept;
+            }
+
+            // The largest movements and half the distance from each centre to the closest other centre.
+            double maxMoved = 0;
+            double secondMaxMoved = 0;
+            unsigned int maxMovedIdx = 0;
+            for(unsigned int j = 0; j < numCentres; ++j)
+            {
+                if(moved[j] > maxMoved)
+                {
+                    secondMaxMoved = maxMoved;
+                    maxMoved = moved[j];
+                    maxMovedIdx = j;
+                }
+                else if(moved[j] > secondMaxMoved)
+                {
+                    secondMaxMoved = moved[j];
+                }
+            }
+            halfMinSep.assign(numCentres, std::numeric_limits<double>::max());
+            for(unsigned int j = 0; j < numCentres; ++j)
+            {
+                for(unsigned int k = j+1; k < numCentres; ++k)
+                {
+                    double dist = this->calcDistance(&(*centres)[j*this->numFeatures], &(*centres)[k*this->numFeatures]) / 2;
+                    halfMinSep[j] = std::min(halfMinSep[j], dist);
+                    halfMinSep[k] = std::min(halfMinSep[k], dist);
+                }
+            }
+
+            // Reassign the samples, only searching all the centres where the bounds overlap.
+            std::fill(threadChanges.begin(), threadChanges.end(), 0);
+            const float *centresData = &(*centres)[0];
+            this->runTasks([this, centresData, numCentres, labels, &upper, &lower, &moved, &halfMinSep, maxMoved, secondMaxMoved, maxMovedIdx, &threadChanges](size_t startIdx, size_t endIdx, unsigned int threadIdx)
+            {
+                unsigned int closest = 0;
+                double bound = 0;
+                for(size_t i = startIdx; i < endIdx; ++i)
+                {
+                    unsigned int label = (*labels)[i];
+                    upper[i] += moved[label];
+                    lower[i] -= (label == maxMovedIdx)?secondMaxMoved:maxMoved;
+
+                    bound = std::max(halfMinSep[label], lower[i]);
+                    if(upper[i] > bound)
+                    {
+                        const float *sample = this->getSample(i);
+                        upper[i] = this->calcDistance(sample, &centresData[label*this->numFeatures]);
+                        if(upper[i] > bound)
+                        {
+                            this->findTwoClosest(sample, centresData, numCentres, &closest, &upper[i], &lower[i]);
+                            if(closest != label)
+                            {
+                                (*labels)[i] = closest;
+                                ++threadChanges[threadIdx];
+                            }
+                        }
+                    }
+                }
+            });
+            nChange = 0;
+            for(unsigned int t = 0; t < this->numThreads; ++t)
+            {
+                nChange += threadChanges[t];
+            }
+
+            amountOfChange = ((float)nChange)/this->numSamples;
+
+            if(printInfo)
+            {
+                std::cout << "Iteration " << nIter << " has change " << amountOfChange*100 << " % of data clump IDs (" << numCentres << " clusters).\n";
+            }
+
+            if((nIter < maxNumIterations) & (amountOfChange > degreeOfChange))
+            {
+                contProcess = true;
+            }
+            ++nIter;
+        }
+
+        return nIter;
+    }
+
+    unsigned int RSGISKMeansEngine::clusterSamplesMiniBatch(std::vector<float> *centres, std::vector<unsigned int> *labels, std::vector<unsigned int> *numPxls, unsigned int batchSize, unsigned int maxNumIterations, float degreeOfChange, bool printInfo)
+    {
+        if(this->numSamples == 0)
+        {
+            throw RSGISClustererException("There are no samples to cluster.");
+        }
+        unsigned int numCentres = centres->size() / this->numFeatures;
+        if(numCentres == 0)
+        {
+            throw RSGISClustererException("No cluster centres have been provided.");
+        }
+        if(batchSize == 0)
+        {
+            throw RSGISClustererException("The mini-batch size must be greater than zero.");
+        }
+
+        RSGISKMeansEngine batch(this->numFeatures, this->numThreads);
+        boost::random::mt19937 randGen;
+        boost::random::uniform_int_distribution<size_t> sampleDist(0, this->numSamples-1);
+        std::vector<double> counts(numCentres, 0.0);
+        std::vector<unsigned int> batchLabels;
+        std::vector<unsigned int> batchLabelsUpdated;
+
+        unsigned int nIter = 0;
+        size_t nChange = 0;
+        float amountOfChange = 0;
+
+        if(printInfo)
+        {
+            std::cout << "Starting Iterative processing (mini-batches of " << batchSize << " samples)...\n";
+        }
+        bool contProcess = true;
+        while(contProcess)
+        {
+            contProcess = false;
+
+            batch.clearSamples();
+            for(unsigned int i = 0; i < batchSize; ++i)
+            {
+                batch.addSample(this->getSample(sampleDist(randGen)));
+            }
+            batch.miniBatchUpdate(centres, &counts, &batchLabels);
+            batch.assignSamples(*centres, &batchLabelsUpdated);
+
+            nChange = 0;
+            for(unsigned int i = 0; i < batchSize; ++i)
+            {
+                if(batchLabels[i] != batchLabelsUpdated[i])
+                {
+                    ++nChange;
+                }
+            }
+            amountOfChange = ((float)nChange)/batchSize;
+
+            if(printInfo)
+            {
+                std::cout << "Iteration " << nIter << " has change " << amountOfChange*100 << " % of batch clump IDs (" << numCentres << " clusters).\n";
+            }
+
+            if((nIter < maxNumIterations) & (amountOfChange > degreeOfChange))
+            {
+                contProcess = true;
+            }
+            ++nIter;
+        }
+
+        // Assign all the samples, calculate the centres as the mean of their samples
+        // and remove the centres without any samples.
+        this->assignSamples(*centres, labels);
+        std::vector<size_t> centreCounts(numCentres, 0);
+        std::vector<double> centreSums(((size_t)numCentres) * this->numFeatures, 0.0);
+        for(size_t i = 0; i < this->numSamples; ++i)
+        {
+            unsigned int label = (*labels)[i];
+            const float *sample = this->getSample(i);
+            ++centreCounts[label];
+            for(unsigned int n = 0; n < this->numFeatures; ++n)
+            {
+                centreSums[(label*this->numFeatures)+n] += sample[n];
+            }
+        }
+        std::vector<unsigned int> centreIdxMap(numCentres, 0);
+        unsigned int numKept = 0;
+        numPxls->clear();
+        for(unsigned int j = 0; j < numCentres; ++j)
+        {
+            if(centreCounts[j] > 0)
+            {
+                for(unsigned int n = 0; n < this->numFeatures; ++n)
+                {
+                    (*centres)[(numKept*this->numFeatures)+n] = centreSums[(j*this->numFeatures)+n] / centreCounts[j];
+                }
+                numPxls->push_back(centreCounts[j]);
+                centreIdxMap[j] = numKept++;
+            }
+        }
+        if(numKept != numCentres)
+        {
+            centres->resize(numKept * this->numFeatures);
+            for(size_t i = 0; i < this->numSamples; ++i)
+            {
+                (*labels)[i] = centreIdxMap[(*labels)[i]];
+            }
+        }
+
+        return nIter;
+    }
+
+    void RSGISKMeansEngine::miniBatchUpdate(std::vector<float> *centres, std::vector<double> *counts, std::vector<unsigned int> *labels)
+    {
+        unsigned int numCentres = centres->size() / this->numFeatures;
+        if(counts->size() != numCentres)
+        {
+            throw RSGISClustererException("The number of centre counts does not match the number of centres.");
+        }
+        if(this->numSamples == 0)
+        {
+            return;
+        }
+
+        std::vector<unsigned int> batchLabels;
+        if(labels == NULL)
+        {
+            labels = &batchLabels;
+        }
+        this->assignSamples(*centres, labels);
+
+        double learnRate = 0;
+        for(size_t i = 0; i < this->numSamples; ++i)
+        {
+            const float *sample = this->getSample(i);
+            unsigned int label = (*labels)[i];
+            float *centre = &(*centres)[label*this->numFeatures];
+            (*counts)[label] += 1;
+            learnRate = 1.0 / (*counts)[label];
+            for(unsigned int n = 0; n < this->numFeatures; ++n)
+            {
+                centre[n] = ((1.0 - learnRate) * centre[n]) + (learnRate * sample[n]);
+            }
+        }
+    }
+
+    RSGISKMeansEngine::~RSGISKMeansEngine()
+    {
+        if(this->threadPool != NULL)
+        {
+            delete this->threadPool;
+        }
+    }
+
+}}
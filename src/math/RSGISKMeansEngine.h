@@ -0,0 +1,156 @@
+/*
+ *  RSGISKMeansEngine.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISKMeansEngine_H
+#define RSGISKMeansEngine_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <functional>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+#include "common/RSGISThreadPool.h"
+
+#include "math/RSGISClustererException.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_maths_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace math{
+
+    /**
+     * K-means over samples held in a single contiguous array (numFeatures
+     * values per sample). Centres are also held contiguously, one row of
+     * numFeatures values per centre. All distances are Euclidean.
+     *
+     * clusterSamples runs Lloyd's algorithm using the bounds of Hamerly (2010):
+     * for each sample an upper bound on the distance to its centre and a lower
+     * bound on the distance to any other centre are kept and updated by the
+     * distance the centres move, so the distances to all the centres only need
+     * to be calculated for the samples close to a boundary. The result is the
+     * same as a full assignment on every iteration.
+     *
+     * miniBatchUpdate implements the mini-batch k-means of Sculley (2010),
+     * where the current samples are a batch (e.g., random image blocks) used
+     * to move the centres with a per-centre learning rate.
+     *
+     * The assignment of samples is divided between the threads of an
+     * RSGISThreadPool.
+     */
+    class DllExport RSGISKMeansEngine
+    {
+    public:
+        /** numThreads = 0 uses RSGISThreadPool::getDefaultNumThreads(). */
+        RSGISKMeansEngine(unsigned int numFeatures, unsigned int numThreads=0);
+        void addSample(const float *vals);
+        void addSamples(std::vector< std::vector<float> > *input);
+        void clearSamples(){this->samples.clear(); this->numSamples = 0;};
+        size_t getNumSamples() const {return this->numSamples;};
+        unsigned int getNumFeatures() const {return this->numFeatures;};
+        const float* getSample(size_t idx) const {return &this->samples[idx*this->numFeatures];};
+        /** The index of the closest centre to each sample (lowest index for equal distances). */
+        void assignSamples(const std::vector<float> &centres, std::vector<unsigned int> *labels);
+        /**
+         * Iterate until the proportion of samples changing centre is not greater than
+         * degreeOfChange or maxNumIterations is reached, matching RSGISKMeansClusterer.
+         * The samples are initially assigned to the closest of the centres provided and
+         * labels returns the final centre of each sample. Centres with no samples are
+         * removed. numPxls returns the number of samples used to calculate each centre.
+         */
+        unsigned int clusterSamples(std::vector<float> *centres, std::vector<unsigned int> *labels, std::vector<unsigned int> *numPxls, unsigned int maxNumIterations, float degreeOfChange, bool printInfo=true);
+        /**
+         * Mini-batch k-means: on each iteration batchSize samples are selected at random
+         * and used to move the centres, until the proportion of the batch changing centre
+         * due to the update is not greater than degreeOfChange or maxNumIterations is reached.
+         * All the samples are then assigned to the closest centre (labels) and the centres
+         * updated to the mean of their samples, removing centres without any samples.
+         */
+        unsigned int clusterSamplesMiniBatch(std::vector<float> *centres, std::vector<unsigned int> *labels, std::vector<unsigned int> *numPxls, unsigned int batchSize, unsigned int maxNumIterations, float degreeOfChange, bool printInfo=true);
+        /**
+         * Move the centres towards the current samples. counts holds the number of
+         * samples assigned to each centre over all the batches (initialise to 0).
+         * If labels is not NULL it returns the centre each sample was assigned to
+         * before the update.
+         */
+        void miniBatchUpdate(std::vector<float> *centres, std::vector<double> *counts, std::vector<unsigned int> *labels=NULL);
+        ~RSGISKMeansEngine();
+    protected:
+        inline double calcDistance(const float *sample, const float *centre) const
+        {
+            double dist = 0;
+            double diff = 0;
+            for(unsigned int n = 0; n < this->numFeatures; ++n)
+            {
+                diff = sample[n] - centre[n];
+                dist += diff * diff;
+            }
+            return sqrt(dist);
+        };
+        /** Find the closest and second closest centre to a sample. */
+        inline void findTwoClosest(const float *sample, const float *centres, unsigned int numCentres, unsigned int *closest, double *closestDist, double *secondDist) const
+        {
+            *closest = 0;
+            *closestDist = std::numeric_limits<double>::max();
+            *secondDist = std::numeric_limits<double>::max();
+            double dist = 0;
+            for(unsigned int j = 0; j < numCentres; ++j)
+            {
+                dist = this->calcDistance(sample, &centres[j*this->numFeatures]);
+                if(dist < *closestDist)
+                {
+                    *secondDist = *closestDist;
+                    *closestDist = dist;
+                    *closest = j;
+                }
+                else if(dist < *secondDist)
+                {
+                    *secondDist = dist;
+                }
+            }
+        };
+        /** Split [0, numSamples) into tasks and run func(startIdx, endIdx, threadIdx) for each (threadIdx < numThreads). */
+        void runTasks(std::function<void(size_t, size_t, unsigned int)> func);
+        unsigned int numFeatures;
+        unsigned int numThreads;
+        rsgis::RSGISThreadPool *threadPool;
+        size_t numSamples;
+        std::vector<float> samples;
+    };
+
+}}
+
+#endif
@@ -71,6 +71,7 @@ namespace rsgis{namespace math{
             this->exps = exps;
         };
         bool evaluate();
+        std::vector<RSGISLogicExpression*>* getExpressions(){return exps;};
         ~RSGISLogicAndExpression()
         {
             for(std::vector<RSGISLogicExpression*>::iterator iterExps = exps->begin(); iterExps != exps->end(); ++iterExps)
@@ -91,6 +92,7 @@ namespace rsgis{namespace math{
             this->exps = exps;
         };
         bool evaluate();
+        std::vector<RSGISLogicExpression*>* getExpressions(){return exps;};
         ~RSGISLogicOrExpression()
         {
             for(std::vector<RSGISLogicExpression*>::iterator iterExps = exps->begin(); iterExps != exps->end(); ++iterExps)
@@ -111,6 +113,7 @@ namespace rsgis{namespace math{
             this->exp = exp;
         };
         bool evaluate();
+        RSGISLogicExpression* getExpression(){return exp;};
         ~RSGISLogicNotExpression()
         {
             delete exp;
@@ -127,6 +130,7 @@ namespace rsgis{namespace math{
             this->exps = exps;
         };
         bool evaluate();
+        std::vector<RSGISLogicExpression*>* getExpressions(){return exps;};
         ~RSGISLogicEqualsExpression()
         {
             for(std::vector<RSGISLogicExpression*>::iterator iterExps = exps->begin(); iterExps != exps->end(); ++iterExps)
@@ -148,6 +152,8 @@ namespace rsgis{namespace math{
             this->val2 = val2;
         };
         bool evaluate();
+        double* getVal1(){return val1;};
+        double* getVal2(){return val2;};
         ~RSGISLogicEqualsValueExpression(){};
     protected:
         double *val1;
@@ -163,6 +169,8 @@ namespace rsgis{namespace math{
             this->val2 = val2;
         };
         bool evaluate();
+        double* getVal1(){return val1;};
+        double* getVal2(){return val2;};
         
         ~RSGISLogicGreaterThanValueExpression(){};
     protected:
@@ -180,6 +188,8 @@ namespace rsgis{namespace math{
             this->val2 = val2;
         };
         bool evaluate();
+        double* getVal1(){return val1;};
+        double* getVal2(){return val2;};
         ~RSGISLogicLessThanValueExpression(){};
     protected:
         double *val1;
@@ -196,6 +206,8 @@ namespace rsgis{namespace math{
             this->val2 = val2;
         };
         bool evaluate();
+        double* getVal1(){return val1;};
+        double* getVal2(){return val2;};
         ~RSGISLogicGreaterEqualToValueExpression(){};
     protected:
         double *val1;
@@ -212,6 +224,8 @@ namespace rsgis{namespace math{
             this->val2 = val2;
         };
         bool evaluate();
+        double* getVal1(){return val1;};
+        double* getVal2(){return val2;};
         ~RSGISLogicLessEqualToValueExpression(){};
     protected:
         double *val1;
@@ -227,6 +241,8 @@ namespace rsgis{namespace math{
             this->val2 = val2;
         };
         bool evaluate();
+        double* getVal1(){return val1;};
+        double* getVal2(){return val2;};
         ~RSGISLogicNotValueExpression(){};
     protected:
         double *val1;
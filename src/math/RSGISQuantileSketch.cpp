@@ -0,0 +1,203 @@
+/*
+ *  RSGISQuantileSketch.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISQuantileSketch.h"
+
+namespace rsgis{namespace math{
+
+    RSGISQuantileSketch::RSGISQuantileSketch(unsigned int k)
+    {
+        if(k < 8)
+        {
+            throw RSGISMathException("The quantile sketch size (k) must be at least 8.");
+        }
+        this->k = k;
+        this->n = 0;
+        this->level0Cap = this->getLevelCapacity(0);
+    }
+
+    void RSGISQuantileSketch::merge(const RSGISQuantileSketch &other)
+    {
+        unsigned int otherNumLevels = other.upperLevels.size() + 1;
+        while(this->getNumLevels() < otherNumLevels)
+        {
+            this->upperLevels.push_back(std::vector<float>());
+        }
+        this->level0.insert(this->level0.end(), other.level0.begin(), other.level0.end());
+        for(unsigned int i = 0; i < other.upperLevels.size(); ++i)
+        {
+            this->upperLevels[i].insert(this->upperLevels[i].end(), other.upperLevels[i].begin(), other.upperLevels[i].end());
+        }
+        this->n += other.n;
+        this->level0Cap = this->getLevelCapacity(0);
+        this->compress();
+    }
+
+    float RSGISQuantileSketch::getValueAtRank(boost::uint_fast64_t rank) const
+    {
+        if(this->n == 0)
+        {
+            throw RSGISMathException("Cannot get a value from an empty quantile sketch.");
+        }
+        if(rank >= this->n)
+        {
+            rank = this->n - 1;
+        }
+
+        if(this->isExact())
+        {
+            std::vector<float> vals(this->level0);
+            std::nth_element(vals.begin(), vals.begin() + rank, vals.end());
+            return vals[rank];
+        }
+
+        // Each value stands for 2^level values so find where the cumulative weight passes the rank.
+        std::vector< std::pair<float, boost::uint_fast64_t> > weightedVals;
+        weightedVals.reserve(this->getNumRetained());
+        for(std::vector<float>::const_iterator iterVal = this->level0.begin(); iterVal != this->level0.end(); ++iterVal)
+        {
+            weightedVals.push_back(std::pair<float, boost::uint_fast64_t>(*iterVal, 1));
+        }
+        for(unsigned int i = 0; i < this->upperLevels.size(); ++i)
+        {
+            boost::uint_fast64_t weight = ((boost::uint_fast64_t)1) << (i + 1);
+            for(std::vector<float>::const_iterator iterVal = this->upperLevels[i].begin(); iterVal != this->upperLevels[i].end(); ++iterVal)
+            {
+                weightedVals.push_back(std::pair<float, boost::uint_fast64_t>(*iterVal, weight));
+            }
+        }
+        std::sort(weightedVals.begin(), weightedVals.end());
+
+        boost::uint_fast64_t cumWeight = 0;
+        for(std::vector< std::pair<float, boost::uint_fast64_t> >::iterator iterVal = weightedVals.begin(); iterVal != weightedVals.end(); ++iterVal)
+        {
+            cumWeight += (*iterVal).second;
+            if(cumWeight > rank)
+            {
+                return (*iterVal).first;
+            }
+        }
+        return weightedVals.back().first;
+    }
+
+    size_t RSGISQuantileSketch::getNumRetained() const
+    {
+        size_t numRetained = this->level0.size();
+        for(std::vector< std::vector<float> >::const_iterator iterLevel = this->upperLevels.begin(); iterLevel != this->upperLevels.end(); ++iterLevel)
+        {
+            numRetained += (*iterLevel).size();
+        }
+        return numRetained;
+    }
+
+    void RSGISQuantileSketch::compress()
+    {
+        bool compacted = true;
+        while(compacted)
+        {
+            compacted = false;
+            for(unsigned int level = 0; level < this->getNumLevels(); ++level)
+            {
+                if(this->getLevel(level).size() >= this->getLevelCapacity(level))
+                {
+                    this->compactLevel(level);
+                    compacted = true;
+                }
+            }
+        }
+        this->level0Cap = this->getLevelCapacity(0);
+    }
+
+    void RSGISQuantileSketch::compactLevel(unsigned int level)
+    {
+        if(level + 1 == this->getNumLevels())
+        {
+            // Add the level first as it may move the existing levels in memory.
+            this->upperLevels.push_back(std::vector<float>());
+        }
+        std::vector<float> &vals = this->getLevel(level);
+        std::vector<float> &nextVals = this->getLevel(level + 1);
+        if(vals.size() < 2)
+        {
+            return;
+        }
+        std::sort(vals.begin(), vals.end());
+
+        // A pseudo-random bit from the number of values added, so the results can be reproduced.
+        boost::uint_fast64_t seed = this->n + (((boost::uint_fast64_t)level) << 56) + 0x9E3779B97F4A7C15ULL;
+        seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+        seed = seed ^ (seed >> 31);
+        size_t offset = seed & 1;
+
+        // An even number of values are compacted so the total weight is unchanged;
+        // with an odd number either the minimum or maximum stays on this level.
+        size_t startIdx = 0;
+        size_t endIdx = vals.size();
+        float leftOver = 0;
+        bool hasLeftOver = (vals.size() % 2) == 1;
+        if(hasLeftOver)
+        {
+            if((seed >> 1) & 1)
+            {
+                leftOver = vals[0];
+                startIdx = 1;
+            }
+            else
+            {
+                leftOver = vals[vals.size()-1];
+                endIdx = vals.size() - 1;
+            }
+        }
+        for(size_t i = startIdx + offset; i < endIdx; i += 2)
+        {
+            nextVals.push_back(vals[i]);
+        }
+        vals.clear();
+        if(hasLeftOver)
+        {
+            vals.push_back(leftOver);
+        }
+        if(level == 0)
+        {
+            // Release the memory if the level 0 buffer grew beyond its current capacity.
+            if(vals.capacity() > (2 * this->getLevelCapacity(0)))
+            {
+                std::vector<float>(vals).swap(vals);
+            }
+        }
+    }
+
+    unsigned int RSGISQuantileSketch::getLevelCapacity(unsigned int level) const
+    {
+        // The top level holds k values, each lower level 2/3 of the level above (minimum of 8).
+        unsigned int depth = this->getNumLevels() - 1 - level;
+        double capacity = std::ceil(((double)this->k) * std::pow(2.0/3.0, (double)depth));
+        return (capacity < 8)?8:((unsigned int)capacity);
+    }
+
+    RSGISQuantileSketch::~RSGISQuantileSketch()
+    {
+
+    }
+
+}}
@@ -0,0 +1,108 @@
+/*
+ *  RSGISQuantileSketch.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISQuantileSketch_H
+#define RSGISQuantileSketch_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include <boost/cstdint.hpp>
+
+#include "math/RSGISMathException.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_maths_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace math{
+
+    /**
+     * A mergeable quantile sketch (KLL, Karnin, Lang and Liberty 2016) for
+     * finding percentiles of a stream of values in bounded memory.
+     *
+     * Values are kept exactly until k have been added. After that the values
+     * are held in levels, where a value on level h stands for 2^h input values;
+     * when a level is full it is sorted and every other value (starting from a
+     * pseudo-random offset) is moved up a level. No more than about 3k values
+     * are retained and the error in the rank of a returned value is roughly
+     * proportional to 1/k (within 1.65% of the number of values added for
+     * k = 200 with 99% confidence).
+     */
+    class DllExport RSGISQuantileSketch
+    {
+    public:
+        RSGISQuantileSketch(unsigned int k=200);
+        inline void add(float val)
+        {
+            this->level0.push_back(val);
+            ++this->n;
+            if(this->level0.size() >= this->level0Cap)
+            {
+                this->compress();
+            }
+        };
+        /** Add the values summarised by another sketch to this sketch. */
+        void merge(const RSGISQuantileSketch &other);
+        /**
+         * Get the value with the given rank (0 is the minimum) within the sorted
+         * values which have been added. Ranks beyond the number of values give
+         * the maximum.
+         */
+        float getValueAtRank(boost::uint_fast64_t rank) const;
+        boost::uint_fast64_t getNumValues() const {return this->n;};
+        /** The number of values held in memory. */
+        size_t getNumRetained() const;
+        /** True while all the values added are retained (i.e., ranks are exact). */
+        bool isExact() const {return this->upperLevels.empty();};
+        unsigned int getK() const {return this->k;};
+        ~RSGISQuantileSketch();
+    protected:
+        void compress();
+        void compactLevel(unsigned int level);
+        unsigned int getLevelCapacity(unsigned int level) const;
+        inline unsigned int getNumLevels() const {return this->upperLevels.size() + 1;};
+        inline std::vector<float>& getLevel(unsigned int level)
+        {
+            return (level == 0)?this->level0:this->upperLevels[level-1];
+        };
+        unsigned int k;
+        unsigned int level0Cap;
+        boost::uint_fast64_t n;
+        std::vector<float> level0;
+        std::vector< std::vector<float> > upperLevels;
+    };
+
+}}
+
+#endif
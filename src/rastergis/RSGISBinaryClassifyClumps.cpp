@@ -552,124 +552,395 @@ namespace rsgis{namespace rastergis{
     
     
     
-    RSGISBinaryClassifyClumps::RSGISBinaryClassifyClumps()
+    RSGISRATLogicProgram::RSGISRATLogicProgram(rsgis::math::RSGISLogicExpression *exp, std::vector<RSGISColumnLogicIdxs*> *colIdxes)
+    {
+        this->rootInstr = this->compileExpression(exp, colIdxes);
+        this->blockRows = 0;
+    }
+    
+    unsigned int RSGISRATLogicProgram::compileExpression(rsgis::math::RSGISLogicExpression *exp, std::vector<RSGISColumnLogicIdxs*> *colIdxes)
     {
+        RSGISRATLogicInstr instr;
+        instr.logicIdx = 0;
+        instr.useThreshold = false;
+        instr.thresholdVal = 0;
         
+        std::vector<rsgis::math::RSGISLogicExpression*> *childExps = NULL;
+        if(dynamic_cast<rsgis::math::RSGISLogicAndExpression*>(exp) != NULL)
+        {
+            instr.op = rsgis_logic_and;
+            childExps = dynamic_cast<rsgis::math::RSGISLogicAndExpression*>(exp)->getExpressions();
+        }
+        else if(dynamic_cast<rsgis::math::RSGISLogicOrExpression*>(exp) != NULL)
+        {
+            instr.op = rsgis_logic_or;
+            childExps = dynamic_cast<rsgis::math::RSGISLogicOrExpression*>(exp)->getExpressions();
+        }
+        else if(dynamic_cast<rsgis::math::RSGISLogicEqualsExpression*>(exp) != NULL)
+        {
+            instr.op = rsgis_logic_equal;
+            childExps = dynamic_cast<rsgis::math::RSGISLogicEqualsExpression*>(exp)->getExpressions();
+        }
+        else if(dynamic_cast<rsgis::math::RSGISLogicNotExpression*>(exp) != NULL)
+        {
+            instr.op = rsgis_logic_not;
+            instr.children.push_back(this->compileExpression(dynamic_cast<rsgis::math::RSGISLogicNotExpression*>(exp)->getExpression(), colIdxes));
+        }
+        else if(dynamic_cast<rsgis::math::RSGISLogicEqualsValueExpression*>(exp) != NULL)
+        {
+            rsgis::math::RSGISLogicEqualsValueExpression *valExp = dynamic_cast<rsgis::math::RSGISLogicEqualsValueExpression*>(exp);
+            return this->compileComparison(rsgis_logic_eq, valExp->getVal1(), valExp->getVal2(), colIdxes);
+        }
+        else if(dynamic_cast<rsgis::math::RSGISLogicNotValueExpression*>(exp) != NULL)
+        {
+            rsgis::math::RSGISLogicNotValueExpression *valExp = dynamic_cast<rsgis::math::RSGISLogicNotValueExpression*>(exp);
+            return this->compileComparison(rsgis_logic_noteq, valExp->getVal1(), valExp->getVal2(), colIdxes);
+        }
+        else if(dynamic_cast<rsgis::math::RSGISLogicGreaterThanValueExpression*>(exp) != NULL)
+        {
+            rsgis::math::RSGISLogicGreaterThanValueExpression *valExp = dynamic_cast<rsgis::math::RSGISLogicGreaterThanValueExpression*>(exp);
+            return this->compileComparison(rsgis_logic_gt, valExp->getVal1(), valExp->getVal2(), colIdxes);
+        }
+        else if(dynamic_cast<rsgis::math::RSGISLogicLessThanValueExpression*>(exp) != NULL)
+        {
+            rsgis::math::RSGISLogicLessThanValueExpression *valExp = dynamic_cast<rsgis::math::RSGISLogicLessThanValueExpression*>(exp);
+            return this->compileComparison(rsgis_logic_lt, valExp->getVal1(), valExp->getVal2(), colIdxes);
+        }
+        else if(dynamic_cast<rsgis::math::RSGISLogicGreaterEqualToValueExpression*>(exp) != NULL)
+        {
+            rsgis::math::RSGISLogicGreaterEqualToValueExpression *valExp = dynamic_cast<rsgis::math::RSGISLogicGreaterEqualToValueExpression*>(exp);
+            return this->compileComparison(rsgis_logic_gteq, valExp->getVal1(), valExp->getVal2(), colIdxes);
+        }
+        else if(dynamic_cast<rsgis::math::RSGISLogicLessEqualToValueExpression*>(exp) != NULL)
+        {
+            rsgis::math::RSGISLogicLessEqualToValueExpression *valExp = dynamic_cast<rsgis::math::RSGISLogicLessEqualToValueExpression*>(exp);
+            return this->compileComparison(rsgis_logic_lteq, valExp->getVal1(), valExp->getVal2(), colIdxes);
+        }
+        else
+        {
+            throw RSGISAttributeTableException("The logic expression type was not recognised so could not be compiled.");
+        }
+        
+        if(childExps != NULL)
+        {
+            for(std::vector<rsgis::math::RSGISLogicExpression*>::iterator iterExps = childExps->begin(); iterExps != childExps->end(); ++iterExps)
+            {
+                instr.children.push_back(this->compileExpression(*iterExps, colIdxes));
+            }
+        }
+        this->instrs.push_back(instr);
+        return this->instrs.size()-1;
     }
     
-    void RSGISBinaryClassifyClumps::classifyClumps(GDALDataset *inputClumps, unsigned int ratBand, std::string xmlBlock, std::string outColumn)
+    unsigned int RSGISRATLogicProgram::compileComparison(RSGISRATLogicOp op, double *val1, double *val2, std::vector<RSGISColumnLogicIdxs*> *colIdxes)
     {
-        try
+        RSGISRATLogicInstr instr;
+        instr.op = op;
+        instr.useThreshold = false;
+        instr.thresholdVal = 0;
+        bool found = false;
+        for(unsigned int i = 0; i < colIdxes->size(); ++i)
         {
-            RSGISRasterAttUtils attUtils;
-            
-            GDALRasterAttributeTable *rat = inputClumps->GetRasterBand(ratBand)->GetDefaultRAT();
-            
-            size_t numRows = rat->GetRowCount();
-            if(numRows == 0)
+            if(val1 == &(colIdxes->at(i)->col1Val))
             {
-                throw rsgis::RSGISAttributeTableException("RAT has no rows, i.e., it is empty!");
+                instr.logicIdx = i;
+                if(val2 == &(colIdxes->at(i)->thresholdVal))
+                {
+                    instr.useThreshold = true;
+                    instr.thresholdVal = colIdxes->at(i)->thresholdVal;
+                }
+                else if(val2 != &(colIdxes->at(i)->col2Val))
+                {
+                    throw RSGISAttributeTableException("The second value of the comparison is not from the same column logic as the first.");
+                }
+                found = true;
+                break;
             }
-            
-            rsgis::rastergis::RSGISRATLogicXMLParse parseLogicXMLObj;
-            std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*> *colIdxes = new std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*>();
-            rsgis::math::RSGISLogicExpression* exp = parseLogicXMLObj.parseLogicXML(xmlBlock, colIdxes);
-            
-            unsigned outColIdx = attUtils.findColumnIndexOrCreate(rat, outColumn, GFT_Integer);
-            
-            std::vector<unsigned int> inRealColIdx;
-            std::vector<unsigned int> inIntColIdx;
-            std::vector<unsigned int> inStrColIdx;
-            std::vector<unsigned int> outRealColIdx;
-            std::vector<unsigned int> outIntColIdx;
-            outIntColIdx.push_back(outColIdx);
-            std::vector<unsigned int> outStrColIdx;
-            
-            for(std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*>::iterator iterColIdx = colIdxes->begin(); iterColIdx != colIdxes->end(); ++iterColIdx)
+        }
+        if(!found)
+        {
+            throw RSGISAttributeTableException("The values of the comparison are not from the column logic provided.");
+        }
+        this->instrs.push_back(instr);
+        return this->instrs.size()-1;
+    }
+    
+    void RSGISRATLogicProgram::evaluate(size_t numRows, const std::vector<const double*> &col1Vals, const std::vector<const double*> &col2Vals, boost::uint8_t *results, boost::uint8_t *nanErrs)
+    {
+        if(numRows == 0)
+        {
+            return;
+        }
+        if(numRows > this->blockRows)
+        {
+            this->blockRows = numRows;
+            this->instrResults.resize(this->instrs.size() * this->blockRows);
+            this->instrActive.resize(this->instrs.size() * this->blockRows);
+        }
+        std::vector<boost::uint8_t> allRows(numRows, 1);
+        for(size_t r = 0; r < numRows; ++r)
+        {
+            nanErrs[r] = 0;
+        }
+        this->evaluateInstr(this->rootInstr, numRows, col1Vals, col2Vals, allRows.data(), nanErrs);
+        const boost::uint8_t *rootResults = &this->instrResults[this->rootInstr * this->blockRows];
+        for(size_t r = 0; r < numRows; ++r)
+        {
+            results[r] = rootResults[r];
+        }
+    }
+    
+    void RSGISRATLogicProgram::evaluateInstr(unsigned int instrIdx, size_t numRows, const std::vector<const double*> &col1Vals, const std::vector<const double*> &col2Vals, const boost::uint8_t *active, boost::uint8_t *nanErrs)
+    {
+        const RSGISRATLogicInstr &instr = this->instrs[instrIdx];
+        boost::uint8_t *results = &this->instrResults[instrIdx * this->blockRows];
+        
+        if((instr.op == rsgis_logic_and) || (instr.op == rsgis_logic_or) || (instr.op == rsgis_logic_equal))
+        {
+            // The rows for which the tree would evaluate the next child expression.
+            boost::uint8_t *childActive = &this->instrActive[instrIdx * this->blockRows];
+            for(size_t r = 0; r < numRows; ++r)
             {
-                if((*iterColIdx)->useThreshold)
+                childActive[r] = active[r];
+                results[r] = 1;
+            }
+            const boost::uint8_t *firstResults = NULL;
+            for(size_t c = 0; c < instr.children.size(); ++c)
+            {
+                this->evaluateInstr(instr.children[c], numRows, col1Vals, col2Vals, childActive, nanErrs);
+                const boost::uint8_t *childResults = &this->instrResults[instr.children[c] * this->blockRows];
+                if(instr.op == rsgis_logic_and)
+                {
+                    for(size_t r = 0; r < numRows; ++r)
+                    {
+                        results[r] &= childResults[r];
+                        childActive[r] &= childResults[r];
+                    }
+                }
+                else if(instr.op == rsgis_logic_or)
                 {
-                    (*iterColIdx)->col1Idx = attUtils.findColumnIndex(rat, (*iterColIdx)->column1Name);
-                    std::cout << (*iterColIdx)->column1Name << " = " << (*iterColIdx)->col1Idx << std::endl;
-                    inRealColIdx.push_back((*iterColIdx)->col1Idx);
-                    (*iterColIdx)->col1Idx = inRealColIdx.size()-1;
+                    if(c == 0)
+                    {
+                        for(size_t r = 0; r < numRows; ++r)
+                        {
+                            results[r] = 0;
+                        }
+                    }
+                    for(size_t r = 0; r < numRows; ++r)
+                    {
+                        results[r] |= childResults[r];
+                        childActive[r] &= (childResults[r] ^ 1);
+                    }
+                }
+                else if(c == 0)
+                {
+                    firstResults = childResults;
                 }
                 else
                 {
-                    (*iterColIdx)->col1Idx = attUtils.findColumnIndex(rat, (*iterColIdx)->column1Name);
-                    std::cout << (*iterColIdx)->column1Name << " = " << (*iterColIdx)->col1Idx << std::endl;
-                    inRealColIdx.push_back((*iterColIdx)->col1Idx);
-                    (*iterColIdx)->col1Idx = inRealColIdx.size()-1;
-                    (*iterColIdx)->col2Idx = attUtils.findColumnIndex(rat, (*iterColIdx)->column2Name);
-                    std::cout << (*iterColIdx)->column2Name << " = " << (*iterColIdx)->col2Idx << std::endl;
-                    inRealColIdx.push_back((*iterColIdx)->col2Idx);
-                    (*iterColIdx)->col2Idx = inRealColIdx.size()-1;
+                    for(size_t r = 0; r < numRows; ++r)
+                    {
+                        boost::uint8_t isEqual = (childResults[r] == firstResults[r]);
+                        results[r] &= isEqual;
+                        childActive[r] &= isEqual;
+                    }
                 }
             }
-            
-            RSGISBinaryClumpClassifier binClumpClassifier(colIdxes, exp);
-            RSGISRATCalc ratCalc(&binClumpClassifier);
-            ratCalc.calcRATValues(rat, inRealColIdx, inIntColIdx, inStrColIdx, outRealColIdx, outIntColIdx, outStrColIdx);
-            
-            for(std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*>::iterator iterColIdx = colIdxes->begin(); iterColIdx != colIdxes->end(); ++iterColIdx)
+        }
+        else if(instr.op == rsgis_logic_not)
+        {
+            this->evaluateInstr(instr.children[0], numRows, col1Vals, col2Vals, active, nanErrs);
+            const boost::uint8_t *childResults = &this->instrResults[instr.children[0] * this->blockRows];
+            for(size_t r = 0; r < numRows; ++r)
             {
-                delete *iterColIdx;
+                results[r] = childResults[r] ^ 1;
             }
-            delete colIdxes;
-            delete exp;
         }
-        catch(RSGISAttributeTableException &e)
+        else
         {
-            throw e;
+            const double *vals1 = col1Vals[instr.logicIdx];
+            const double *vals2 = instr.useThreshold?NULL:col2Vals[instr.logicIdx];
+            if(vals1 == NULL)
+            {
+                throw RSGISAttributeTableException("The values for the first column of a comparison were not provided.");
+            }
+            if((!instr.useThreshold) && (vals2 == NULL))
+            {
+                throw RSGISAttributeTableException("The values for the second column of a comparison were not provided.");
+            }
+            
+            switch(instr.op)
+            {
+                case rsgis_logic_eq:
+                    this->compareValues< std::equal_to<double> >(instr, numRows, col1Vals, col2Vals, results);
+                    break;
+                case rsgis_logic_noteq:
+                    this->compareValues< std::not_equal_to<double> >(instr, numRows, col1Vals, col2Vals, results);
+                    break;
+                case rsgis_logic_gt:
+                    this->compareValues< std::greater<double> >(instr, numRows, col1Vals, col2Vals, results);
+                    break;
+                case rsgis_logic_lt:
+                    this->compareValues< std::less<double> >(instr, numRows, col1Vals, col2Vals, results);
+                    break;
+                case rsgis_logic_gteq:
+                    this->compareValues< std::greater_equal<double> >(instr, numRows, col1Vals, col2Vals, results);
+                    break;
+                case rsgis_logic_lteq:
+                    this->compareValues< std::less_equal<double> >(instr, numRows, col1Vals, col2Vals, results);
+                    break;
+                default:
+                    throw RSGISAttributeTableException("The logic instruction was not recognised.");
+            }
+            
+            // The tree throws an exception for NaN values, flag the rows where this comparison would have been evaluated.
+            bool threshNaN = instr.useThreshold && (boost::math::isnan)(instr.thresholdVal);
+            for(size_t r = 0; r < numRows; ++r)
+            {
+                if(active[r] && (nanErrs[r] == 0))
+                {
+                    if((boost::math::isnan)(vals1[r]))
+                    {
+                        nanErrs[r] = 1;
+                    }
+                    else if(instr.useThreshold?threshNaN:((boost::math::isnan)(vals2[r])))
+                    {
+                        nanErrs[r] = 2;
+                    }
+                }
+            }
         }
-        catch (rsgis::RSGISException &e)
+    }
+    
+    template<typename CompareOp> void RSGISRATLogicProgram::compareValues(const RSGISRATLogicInstr &instr, size_t numRows, const std::vector<const double*> &col1Vals, const std::vector<const double*> &col2Vals, boost::uint8_t *results)
+    {
+        CompareOp compare;
+        const double *vals1 = col1Vals[instr.logicIdx];
+        if(instr.useThreshold)
         {
-            throw RSGISAttributeTableException(e.what());
+            const double thresholdVal = instr.thresholdVal;
+            for(size_t r = 0; r < numRows; ++r)
+            {
+                results[r] = compare(vals1[r], thresholdVal);
+            }
         }
-        catch (std::exception &e)
+        else
         {
-            throw RSGISAttributeTableException(e.what());
+            const double *vals2 = col2Vals[instr.logicIdx];
+            for(size_t r = 0; r < numRows; ++r)
+            {
+                results[r] = compare(vals1[r], vals2[r]);
+            }
         }
     }
     
-    RSGISBinaryClassifyClumps::~RSGISBinaryClassifyClumps()
-    {
-        
-    }
     
     
     
-    RSGISBinaryClumpClassifier::RSGISBinaryClumpClassifier(std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*> *colIdxes, rsgis::math::RSGISLogicExpression *exp):RSGISRATCalcValue()
+    RSGISBinaryClassifyClumps::RSGISBinaryClassifyClumps()
     {
-        this->colIdxes = colIdxes;
-        this->exp = exp;
+        
     }
     
-    void RSGISBinaryClumpClassifier::calcRATValue(size_t fid, double *inRealCols, unsigned int numInRealCols, int *inIntCols, unsigned int numInIntCols, std::string *inStringCols, unsigned int numInStringCols, double *outRealCols, unsigned int numOutRealCols, int *outIntCols, unsigned int numOutIntCols, std::string *outStringCols, unsigned int numOutStringCols)
+    void RSGISBinaryClassifyClumps::classifyClumps(GDALDataset *inputClumps, unsigned int ratBand, std::string xmlBlock, std::string outColumn)
     {
         try
         {
-            for(std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*>::iterator iterColIdx = colIdxes->begin(); iterColIdx != colIdxes->end(); ++iterColIdx)
+            RSGISRasterAttUtils attUtils;
+            
+            GDALRasterAttributeTable *rat = inputClumps->GetRasterBand(ratBand)->GetDefaultRAT();
+            
+            size_t numRows = rat->GetRowCount();
+            if(numRows == 0)
+            {
+                throw rsgis::RSGISAttributeTableException("RAT has no rows, i.e., it is empty!");
+            }
+            
+            rsgis::rastergis::RSGISRATLogicXMLParse parseLogicXMLObj;
+            std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*> *colIdxes = new std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*>();
+            rsgis::math::RSGISLogicExpression* exp = parseLogicXMLObj.parseLogicXML(xmlBlock, colIdxes);
+            RSGISRATLogicProgram logicProg(exp, colIdxes);
+            
+            unsigned outColIdx = attUtils.findColumnIndexOrCreate(rat, outColumn, GFT_Integer);
+            
+            // The columns which need to be read (each once) and where the values for each column logic are.
+            std::vector<unsigned int> inRealColIdx;
+            std::vector<unsigned int> col1InIdx(colIdxes->size(), 0);
+            std::vector<int> col2InIdx(colIdxes->size(), -1);
+            for(unsigned int i = 0; i < colIdxes->size(); ++i)
             {
-                if((*iterColIdx)->useThreshold)
+                rsgis::rastergis::RSGISColumnLogicIdxs *colLogic = colIdxes->at(i);
+                colLogic->col1Idx = attUtils.findColumnIndex(rat, colLogic->column1Name);
+                std::cout << colLogic->column1Name << " = " << colLogic->col1Idx << std::endl;
+                col1InIdx[i] = std::find(inRealColIdx.begin(), inRealColIdx.end(), colLogic->col1Idx) - inRealColIdx.begin();
+                if(col1InIdx[i] == inRealColIdx.size())
                 {
-                    (*iterColIdx)->col1Val = inRealCols[(*iterColIdx)->col1Idx];
+                    inRealColIdx.push_back(colLogic->col1Idx);
                 }
-                else
+                if(!colLogic->useThreshold)
+                {
+                    colLogic->col2Idx = attUtils.findColumnIndex(rat, colLogic->column2Name);
+                    std::cout << colLogic->column2Name << " = " << colLogic->col2Idx << std::endl;
+                    col2InIdx[i] = std::find(inRealColIdx.begin(), inRealColIdx.end(), colLogic->col2Idx) - inRealColIdx.begin();
+                    if(((size_t)col2InIdx[i]) == inRealColIdx.size())
+                    {
+                        inRealColIdx.push_back(colLogic->col2Idx);
+                    }
+                }
+            }
+            
+            size_t blockLen = std::min(numRows, (size_t)RAT_BLOCK_LENGTH);
+            std::vector< std::vector<double> > inRealVals(inRealColIdx.size(), std::vector<double>(blockLen));
+            std::vector<const double*> col1Vals(colIdxes->size(), NULL);
+            std::vector<const double*> col2Vals(colIdxes->size(), NULL);
+            for(unsigned int i = 0; i < colIdxes->size(); ++i)
+            {
+                col1Vals[i] = inRealVals[col1InIdx[i]].data();
+                if(col2InIdx[i] >= 0)
                 {
-                    (*iterColIdx)->col1Val = inRealCols[(*iterColIdx)->col1Idx];
-                    (*iterColIdx)->col2Val = inRealCols[(*iterColIdx)->col2Idx];
+                    col2Vals[i] = inRealVals[col2InIdx[i]].data();
                 }
             }
+            std::vector<boost::uint8_t> results(blockLen);
+            std::vector<boost::uint8_t> nanErrs(blockLen);
+            std::vector<int> outVals(blockLen);
             
-            if(exp->evaluate())
+            rsgis_tqdm pbar;
+            for(size_t startRow = 0; startRow < numRows; startRow += blockLen)
             {
-                outIntCols[0] = 1;
+                pbar.progress(startRow, numRows);
+                size_t numBlockRows = std::min(blockLen, numRows - startRow);
+                for(unsigned int n = 0; n < inRealColIdx.size(); ++n)
+                {
+                    if(rat->ValuesIO(GF_Read, inRealColIdx[n], startRow, numBlockRows, inRealVals[n].data()) != CE_None)
+                    {
+                        throw RSGISAttributeTableException("Could not read column from the attribute table.");
+                    }
+                }
+                
+                logicProg.evaluate(numBlockRows, col1Vals, col2Vals, results.data(), nanErrs.data());
+                for(size_t r = 0; r < numBlockRows; ++r)
+                {
+                    if(nanErrs[r] != 0)
+                    {
+                        throw RSGISAttributeTableException(RSGISRATLogicProgram::getNaNErrMessage(nanErrs[r]));
+                    }
+                    outVals[r] = results[r];
+                }
+                
+                if(rat->ValuesIO(GF_Write, outColIdx, startRow, numBlockRows, outVals.data()) != CE_None)
+                {
+                    throw RSGISAttributeTableException("Could not write column to the attribute table.");
+                }
             }
-            else
+            pbar.finish();
+            
+            for(std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*>::iterator iterColIdx = colIdxes->begin(); iterColIdx != colIdxes->end(); ++iterColIdx)
             {
-                outIntCols[0] = 0;
+                delete *iterColIdx;
             }
+            delete colIdxes;
+            delete exp;
         }
         catch(RSGISAttributeTableException &e)
         {
@@ -685,7 +956,7 @@ namespace rsgis{namespace rastergis{
         }
     }
     
-    RSGISBinaryClumpClassifier::~RSGISBinaryClumpClassifier()
+    RSGISBinaryClassifyClumps::~RSGISBinaryClassifyClumps()
     {
         
     }
@@ -26,10 +26,12 @@
 #include <string>
 #include <vector>
 #include <math.h>
+#include <functional>
 
 #include "gdal_priv.h"
 #include "gdal_rat.h"
 
+#include "common/rsgis-tqdm.h"
 #include "common/RSGISAttributeTableException.h"
 
 #include "math/RSGISMathsUtils.h"
@@ -39,6 +41,9 @@
 #include "rastergis/RSGISRATCalcValue.h"
 #include "rastergis/RSGISRATCalc.h"
 
+#include <boost/cstdint.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/parsers/XercesDOMParser.hpp>
 #include <xercesc/sax/HandlerBase.hpp>
@@ -93,24 +98,72 @@ namespace rsgis{namespace rastergis{
         ~RSGISRATLogicXMLParse(){};
     };
     
-    class DllExport RSGISBinaryClassifyClumps
+    enum RSGISRATLogicOp
     {
-    public:
-        RSGISBinaryClassifyClumps();
-        void classifyClumps(GDALDataset *inputClumps, unsigned int ratBand, std::string xmlBlock, std::string outColumn);
-        ~RSGISBinaryClassifyClumps();
+        rsgis_logic_and,
+        rsgis_logic_or,
+        rsgis_logic_equal,
+        rsgis_logic_not,
+        rsgis_logic_eq,
+        rsgis_logic_noteq,
+        rsgis_logic_gt,
+        rsgis_logic_lt,
+        rsgis_logic_gteq,
+        rsgis_logic_lteq
     };
     
+    struct DllExport RSGISRATLogicInstr
+    {
+        RSGISRATLogicOp op;
+        /** For comparisons, the index (within colIdxes) of the values compared. */
+        unsigned int logicIdx;
+        /** For comparisons, whether the second value is the threshold rather than col2Val. */
+        bool useThreshold;
+        double thresholdVal;
+        /** For and, or, equal and not, the instructions for the child expressions (in order). */
+        std::vector<unsigned int> children;
+    };
     
-    class DllExport RSGISBinaryClumpClassifier : public RSGISRATCalcValue
+    /**
+     * A RSGISLogicExpression tree (from RSGISRATLogicXMLParse) compiled to a flat list
+     * of instructions which are evaluated for a block of rows at a time, with the values
+     * of each column as an array, rather than calling evaluate() on the tree for each row.
+     * The results are the same as the tree; where the tree would have thrown an exception
+     * as a compared value is NaN (only for comparisons reached, as and / or stop at the
+     * first false / true value) the row is flagged in nanErrs.
+     */
+    class DllExport RSGISRATLogicProgram
     {
     public:
-        RSGISBinaryClumpClassifier(std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*> *colIdxes, rsgis::math::RSGISLogicExpression *exp);
-        void calcRATValue(size_t fid, double *inRealCols, unsigned int numInRealCols, int *inIntCols, unsigned int numInIntCols, std::string *inStringCols, unsigned int numInStringCols, double *outRealCols, unsigned int numOutRealCols, int *outIntCols, unsigned int numOutIntCols, std::string *outStringCols, unsigned int numOutStringCols);
-        ~RSGISBinaryClumpClassifier();
+        RSGISRATLogicProgram(rsgis::math::RSGISLogicExpression *exp, std::vector<RSGISColumnLogicIdxs*> *colIdxes);
+        /**
+         * Evaluate the expression for numRows rows. col1Vals[i] and col2Vals[i] are the values for
+         * col1Val and col2Val of colIdxes[i] (col2Vals[i] can be NULL if only the threshold is used).
+         * results is set to 1 or 0 for each row and nanErrs to 0 or a code for getNaNErrMessage.
+         */
+        void evaluate(size_t numRows, const std::vector<const double*> &col1Vals, const std::vector<const double*> &col2Vals, boost::uint8_t *results, boost::uint8_t *nanErrs);
+        static const char* getNaNErrMessage(boost::uint8_t nanErr){return (nanErr == 1)?"Value 1 is NaN.":"Value 2 is NaN.";};
+        ~RSGISRATLogicProgram(){};
     protected:
-        std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*> *colIdxes;
-        rsgis::math::RSGISLogicExpression *exp;
+        unsigned int compileExpression(rsgis::math::RSGISLogicExpression *exp, std::vector<RSGISColumnLogicIdxs*> *colIdxes);
+        unsigned int compileComparison(RSGISRATLogicOp op, double *val1, double *val2, std::vector<RSGISColumnLogicIdxs*> *colIdxes);
+        void evaluateInstr(unsigned int instrIdx, size_t numRows, const std::vector<const double*> &col1Vals, const std::vector<const double*> &col2Vals, const boost::uint8_t *active, boost::uint8_t *nanErrs);
+        template<typename CompareOp> void compareValues(const RSGISRATLogicInstr &instr, size_t numRows, const std::vector<const double*> &col1Vals, const std::vector<const double*> &col2Vals, boost::uint8_t *results);
+        
+        std::vector<RSGISRATLogicInstr> instrs;
+        unsigned int rootInstr;
+        /** Result and active row masks for each instruction, numInstrs x blockRows. */
+        std::vector<boost::uint8_t> instrResults;
+        std::vector<boost::uint8_t> instrActive;
+        size_t blockRows;
+    };
+    
+    class DllExport RSGISBinaryClassifyClumps
+    {
+    public:
+        RSGISBinaryClassifyClumps();
+        void classifyClumps(GDALDataset *inputClumps, unsigned int ratBand, std::string xmlBlock, std::string outColumn);
+        ~RSGISBinaryClassifyClumps();
     };
     
 }}
@@ -98,6 +98,12 @@ namespace rsgis{namespace rastergis{
                 }
             }
             
+            // The criteria only depends on the values of the row being grown into so is evaluated for all the rows once.
+            RSGISRATLogicProgram logicProg(exp, colIdxes);
+            std::vector<boost::uint8_t> critResults(numRows);
+            std::vector<boost::uint8_t> critNaNErrs(numRows);
+            this->evaluateLogicForAllRows(&logicProg, colIdxes, ratCols, numRows, critResults.data(), critNaNErrs.data());
+            
             std::vector<std::vector<size_t>* > *neighbours = attUtils.getRATNeighbours(inputClumps, ratBand);
             
             if(numRows != neighbours->size())
@@ -163,20 +169,11 @@ namespace rsgis{namespace rastergis{
                             if(classColVals[*iterNeigh] != classVal)
                             {
                                 // Check if condition is met, if met then 'grow' and set change flag...
-                                for(std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*>::iterator iterColIdx = colIdxes->begin(); iterColIdx != colIdxes->end(); ++iterColIdx)
+                                if(critNaNErrs[*iterNeigh] != 0)
                                 {
-                                    if((*iterColIdx)->useThreshold)
-                                    {
-                                        (*iterColIdx)->col1Val = ratCols->at((*iterColIdx)->col1Idx)[*iterNeigh];
-                                    }
-                                    else
-                                    {
-                                        (*iterColIdx)->col1Val = ratCols->at((*iterColIdx)->col1Idx)[*iterNeigh];
-                                        (*iterColIdx)->col2Val = ratCols->at((*iterColIdx)->col2Idx)[*iterNeigh];
-                                    }
+                                    throw rsgis::RSGISAttributeTableException(RSGISRATLogicProgram::getNaNErrMessage(critNaNErrs[*iterNeigh]));
                                 }
-                                
-                                if(exp->evaluate())
+                                if(critResults[*iterNeigh])
                                 {
                                     classColValsTmp[*iterNeigh] = classVal;
                                     changeFound = true;
@@ -343,6 +340,18 @@ namespace rsgis{namespace rastergis{
                 }
             }
             
+            // The criteria only depends on the values of the row being grown into so is evaluated for all the rows once.
+            RSGISRATLogicProgram logicProgCrit(expCrit, colIdxesCritExp);
+            std::vector<boost::uint8_t> critResults(numRows);
+            std::vector<boost::uint8_t> critNaNErrs(numRows);
+            this->evaluateLogicForAllRows(&logicProgCrit, colIdxesCritExp, ratCols, numRows, critResults.data(), critNaNErrs.data());
+            
+            // The neighbour criteria is evaluated for blocks of (clump, neighbour) pairs.
+            RSGISRATLogicProgram logicProgNeigh(expNeigh, colIdxesNeighExp);
+            std::vector<size_t> pairClumps;
+            std::vector<size_t> pairNeighs;
+            pairClumps.reserve(RAT_BLOCK_LENGTH);
+            pairNeighs.reserve(RAT_BLOCK_LENGTH);
             
             std::vector<std::vector<size_t>* > *neighbours = attUtils.getRATNeighbours(inputClumps, ratBand);
             
@@ -409,46 +418,23 @@ namespace rsgis{namespace rastergis{
                             if(classColVals[*iterNeigh] != classVal)
                             {
                                 // ALSO NEEDS TO MEET THE SECOND CRITERIA COMPARING CURRENT OBJECT TO NEIGHBOUR...
-                                for(std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*>::iterator iterColIdx = colIdxesNeighExp->begin(); iterColIdx != colIdxesNeighExp->end(); ++iterColIdx)
-                                {
-                                    if(((*iterColIdx)->singleCol) & (!(*iterColIdx)->thresholdVal))
-                                    {
-                                        (*iterColIdx)->col1Val = ratCols->at((*iterColIdx)->col1Idx)[*iterNeigh];
-                                        (*iterColIdx)->col2Val = ratCols->at((*iterColIdx)->col1Idx)[i];
-                                    }
-                                    else
-                                    {
-                                        throw rsgis::RSGISAttributeTableException("Could not populate expression values as only single columns without threshold supported for neighbours");
-                                    }
-                                }
-                                
-                                if(expNeigh->evaluate())
+                                pairClumps.push_back(i);
+                                pairNeighs.push_back(*iterNeigh);
+                                if(pairClumps.size() == RAT_BLOCK_LENGTH)
                                 {
-                                    // Check if condition is met, if met then 'grow' and set change flag...
-                                    for(std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*>::iterator iterColIdx = colIdxesCritExp->begin(); iterColIdx != colIdxesCritExp->end(); ++iterColIdx)
+                                    if(this->growNeighPairs(&logicProgNeigh, colIdxesNeighExp, ratCols, &pairClumps, &pairNeighs, critResults.data(), critNaNErrs.data(), classColValsTmp, classVal, &numChangeFeats))
                                     {
-                                        if((*iterColIdx)->useThreshold)
-                                        {
-                                            (*iterColIdx)->col1Val = ratCols->at((*iterColIdx)->col1Idx)[*iterNeigh];
-                                        }
-                                        else
-                                        {
-                                            (*iterColIdx)->col1Val = ratCols->at((*iterColIdx)->col1Idx)[*iterNeigh];
-                                            (*iterColIdx)->col2Val = ratCols->at((*iterColIdx)->col2Idx)[*iterNeigh];
-                                        }
-                                    }
-                                    
-                                    if(expCrit->evaluate())
-                                    {
-                                        classColValsTmp[*iterNeigh] = classVal;
                                         changeFound = true;
-                                        ++numChangeFeats;
                                     }
                                 }
                             }
                         }
                     }
                 }
+                if(this->growNeighPairs(&logicProgNeigh, colIdxesNeighExp, ratCols, &pairClumps, &pairNeighs, critResults.data(), critNaNErrs.data(), classColValsTmp, classVal, &numChangeFeats))
+                {
+                    changeFound = true;
+                }
                 std::cout << ".Completed\n";
                 std::cout << "Iteration " << numIter << " changed " << numChangeFeats << " features\n";
                 
@@ -516,6 +502,82 @@ namespace rsgis{namespace rastergis{
         }
     }
     
+    void RSGISClumpRegionGrowing::evaluateLogicForAllRows(RSGISRATLogicProgram *logicProg, std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*> *colIdxes, std::vector<double*> *ratCols, size_t numRows, boost::uint8_t *results, boost::uint8_t *nanErrs)
+    {
+        std::vector<const double*> col1Vals(colIdxes->size(), NULL);
+        std::vector<const double*> col2Vals(colIdxes->size(), NULL);
+        for(size_t startRow = 0; startRow < numRows; startRow += RAT_BLOCK_LENGTH)
+        {
+            size_t numBlockRows = std::min(numRows - startRow, (size_t)RAT_BLOCK_LENGTH);
+            for(size_t i = 0; i < colIdxes->size(); ++i)
+            {
+                col1Vals[i] = ratCols->at(colIdxes->at(i)->col1Idx) + startRow;
+                if(!colIdxes->at(i)->useThreshold)
+                {
+                    col2Vals[i] = ratCols->at(colIdxes->at(i)->col2Idx) + startRow;
+                }
+            }
+            logicProg->evaluate(numBlockRows, col1Vals, col2Vals, results + startRow, nanErrs + startRow);
+        }
+    }
+    
+    bool RSGISClumpRegionGrowing::growNeighPairs(RSGISRATLogicProgram *logicProgNeigh, std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*> *colIdxesNeighExp, std::vector<double*> *ratCols, std::vector<size_t> *pairClumps, std::vector<size_t> *pairNeighs, boost::uint8_t *critResults, boost::uint8_t *critNaNErrs, std::string *classColValsTmp, std::string classVal, unsigned int *numChangeFeats)
+    {
+        size_t numPairs = pairClumps->size();
+        if(numPairs == 0)
+        {
+            return false;
+        }
+        
+        // Gather the neighbour (value 1) and current clump (value 2) values of each column for the pairs.
+        std::vector<std::vector<double> > pairVals1(colIdxesNeighExp->size(), std::vector<double>(numPairs));
+        std::vector<std::vector<double> > pairVals2(colIdxesNeighExp->size(), std::vector<double>(numPairs));
+        std::vector<const double*> col1Vals(colIdxesNeighExp->size(), NULL);
+        std::vector<const double*> col2Vals(colIdxesNeighExp->size(), NULL);
+        for(size_t i = 0; i < colIdxesNeighExp->size(); ++i)
+        {
+            const double *colVals = ratCols->at(colIdxesNeighExp->at(i)->col1Idx);
+            for(size_t n = 0; n < numPairs; ++n)
+            {
+                pairVals1[i][n] = colVals[pairNeighs->at(n)];
+                pairVals2[i][n] = colVals[pairClumps->at(n)];
+            }
+            col1Vals[i] = pairVals1[i].data();
+            col2Vals[i] = pairVals2[i].data();
+        }
+        
+        std::vector<boost::uint8_t> neighResults(numPairs);
+        std::vector<boost::uint8_t> neighNaNErrs(numPairs);
+        logicProgNeigh->evaluate(numPairs, col1Vals, col2Vals, neighResults.data(), neighNaNErrs.data());
+        
+        bool changeFound = false;
+        for(size_t n = 0; n < numPairs; ++n)
+        {
+            if(neighNaNErrs[n] != 0)
+            {
+                throw rsgis::RSGISAttributeTableException(RSGISRATLogicProgram::getNaNErrMessage(neighNaNErrs[n]));
+            }
+            if(neighResults[n])
+            {
+                // Check if condition is met, if met then 'grow' and set change flag...
+                size_t neigh = pairNeighs->at(n);
+                if(critNaNErrs[neigh] != 0)
+                {
+                    throw rsgis::RSGISAttributeTableException(RSGISRATLogicProgram::getNaNErrMessage(critNaNErrs[neigh]));
+                }
+                if(critResults[neigh])
+                {
+                    classColValsTmp[neigh] = classVal;
+                    changeFound = true;
+                    ++(*numChangeFeats);
+                }
+            }
+        }
+        pairClumps->clear();
+        pairNeighs->clear();
+        return changeFound;
+    }
+    
     RSGISClumpRegionGrowing::~RSGISClumpRegionGrowing()
     {
         
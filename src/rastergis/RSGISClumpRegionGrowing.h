@@ -25,6 +25,7 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <math.h>
 
 #include "gdal_priv.h"
@@ -61,6 +62,11 @@ namespace rsgis{namespace rastergis{
         void growClassRegion(GDALDataset *inputClumps, std::string classColumn, std::string classVal, int maxIter, unsigned int ratBand, std::string xmlBlock);
         void growClassRegionNeighCriteria(GDALDataset *inputClumps, std::string classColumn, std::string classVal, int maxIter, unsigned int ratBand, std::string xmlBlockCriteria, std::string xmlBlockNeighCriteria);
         ~RSGISClumpRegionGrowing();
+    protected:
+        /** Evaluate the logic for all the rows of the RAT, RAT_BLOCK_LENGTH rows at a time, using the columns read into ratCols. */
+        void evaluateLogicForAllRows(RSGISRATLogicProgram *logicProg, std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*> *colIdxes, std::vector<double*> *ratCols, size_t numRows, boost::uint8_t *results, boost::uint8_t *nanErrs);
+        /** Evaluate the neighbour criteria for a block of (clump, neighbour) pairs and grow into the neighbours which also meet the criteria. The pairs are cleared. */
+        bool growNeighPairs(RSGISRATLogicProgram *logicProgNeigh, std::vector<rsgis::rastergis::RSGISColumnLogicIdxs*> *colIdxesNeighExp, std::vector<double*> *ratCols, std::vector<size_t> *pairClumps, std::vector<size_t> *pairNeighs, boost::uint8_t *critResults, boost::uint8_t *critNaNErrs, std::string *classColValsTmp, std::string classVal, unsigned int *numChangeFeats);
     };
     
 }}
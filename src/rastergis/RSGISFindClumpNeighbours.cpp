@@ -46,7 +46,7 @@ namespace rsgis{namespace rastergis{
             for(unsigned int i = 0; i < height; ++i)
             {
                 pbar.progress(i, height);
-                imgBand->RasterIO(GF_Read, 0, i, width, 1, clumpIdxs, width, 1, GDT_UInt32, 0, 0);
+                rsgis::img::RSGISImageBlockCache::readRaster(imgBand, 0, i, width, 1, clumpIdxs, width, 1, GDT_UInt32, 0, 0);
                 for(unsigned int j = 0; j < width; ++j)
                 {
                     if((i == 0) & (j == 0))
@@ -110,7 +110,7 @@ namespace rsgis{namespace rastergis{
 						}
 						else
 						{
-							imgBand->RasterIO(GF_Read, 0, i-1, width, 1, inputData[m], width, 1, GDT_UInt32, 0, 0);
+							rsgis::img::RSGISImageBlockCache::readRaster(imgBand, 0, i-1, width, 1, inputData[m], width, 1, GDT_UInt32, 0, 0);
 						}
 					}
 					else if(m == 2)
@@ -124,12 +124,12 @@ namespace rsgis{namespace rastergis{
 						}
 						else
 						{
-							imgBand->RasterIO(GF_Read, 0, i+1, width, 1, inputData[m], width, 1, GDT_UInt32, 0, 0);
+							rsgis::img::RSGISImageBlockCache::readRaster(imgBand, 0, i+1, width, 1, inputData[m], width, 1, GDT_UInt32, 0, 0);
 						}
 					}
 					else
 					{
-						imgBand->RasterIO(GF_Read, 0, i, width, 1, inputData[m], width, 1, GDT_UInt32, 0, 0);
+						rsgis::img::RSGISImageBlockCache::readRaster(imgBand, 0, i, width, 1, inputData[m], width, 1, GDT_UInt32, 0, 0);
 					}
 				}
 				
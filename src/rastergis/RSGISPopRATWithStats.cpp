@@ -580,6 +580,231 @@ namespace rsgis{namespace rastergis{
         }
     }
 
+    void RSGISPopRATWithStats::populateRATWithPercentileStatsSketch(GDALDataset *inputClumps, GDALDataset *inputValsImage, unsigned int band, std::vector<RSGISBandAttPercentiles*> *bandStats, unsigned int ratBand, unsigned int sketchK)
+    {
+        try
+        {
+            if(sketchK < 8)
+            {
+                throw rsgis::RSGISAttributeTableException("The sketch size (k) must be at least 8.");
+            }
+            
+            size_t numRows = 0;
+            GDALRasterAttributeTable *rat = this->prepRATForPercentiles(inputClumps, inputValsImage, band, bandStats, ratBand, &numRows);
+            
+            int useNoDataVal = false;
+            double noDataVal = inputValsImage->GetRasterBand(band)->GetNoDataValue(&useNoDataVal);
+            
+            // A sketch is only created once a valid pixel is found for a clump.
+            std::vector<rsgis::math::RSGISQuantileSketch*> clumpSketches(numRows, NULL);
+            try
+            {
+                GDALDataset **datasets = new GDALDataset*[2];
+                datasets[0] = inputClumps;
+                datasets[1] = inputValsImage;
+                
+                RSGISCalcClusterPxlValueSketches calcImgValSketches(&clumpSketches, sketchK, ratBand, band, noDataVal, useNoDataVal);
+                rsgis::img::RSGISCalcImage calcImageStats(&calcImgValSketches);
+                calcImageStats.calcImage(datasets, 1, 1);
+                delete[] datasets;
+                
+                std::cout << "Writing Percentile Values to Output RAT\n";
+                size_t numPercentiles = bandStats->size();
+                std::vector< std::vector<double> > dataBlocks(numPercentiles, std::vector<double>(RAT_BLOCK_LENGTH));
+                for(size_t startRow = 0; startRow < numRows; startRow += RAT_BLOCK_LENGTH)
+                {
+                    size_t blockLen = std::min<size_t>(RAT_BLOCK_LENGTH, numRows - startRow);
+                    for(size_t j = 0; j < blockLen; ++j)
+                    {
+                        rsgis::math::RSGISQuantileSketch *sketch = clumpSketches[startRow + j];
+                        for(size_t p = 0; p < numPercentiles; ++p)
+                        {
+                            if(sketch != NULL)
+                            {
+                                dataBlocks[p][j] = sketch->getValueAtRank(this->getPercentileRank(bandStats->at(p)->percentile, sketch->getNumValues()));
+                            }
+                            else
+                            {
+                                dataBlocks[p][j] = 0.0;
+                            }
+                        }
+                        delete sketch;
+                        clumpSketches[startRow + j] = NULL;
+                    }
+                    for(size_t p = 0; p < numPercentiles; ++p)
+                    {
+                        rat->ValuesIO(GF_Write, bandStats->at(p)->fieldIdx, startRow, blockLen, dataBlocks[p].data());
+                    }
+                }
+            }
+            catch(...)
+            {
+                for(std::vector<rsgis::math::RSGISQuantileSketch*>::iterator iterSketch = clumpSketches.begin(); iterSketch != clumpSketches.end(); ++iterSketch)
+                {
+                    delete *iterSketch;
+                }
+                throw;
+            }
+        }
+        catch(RSGISAttributeTableException &e)
+        {
+            throw e;
+        }
+        catch(RSGISException &e)
+        {
+            throw RSGISAttributeTableException(e.what());
+        }
+        catch(std::exception &e)
+        {
+            throw RSGISAttributeTableException(e.what());
+        }
+    }
+    
+    void RSGISPopRATWithStats::populateRATWithPercentileStatsExact(GDALDataset *inputClumps, GDALDataset *inputValsImage, unsigned int band, std::vector<RSGISBandAttPercentiles*> *bandStats, unsigned int ratBand, size_t maxMemory, std::string tmpDIR)
+    {
+        try
+        {
+            size_t numRows = 0;
+            GDALRasterAttributeTable *rat = this->prepRATForPercentiles(inputClumps, inputValsImage, band, bandStats, ratBand, &numRows);
+            
+            int useNoDataVal = false;
+            double noDataVal = inputValsImage->GetRasterBand(band)->GetNoDataValue(&useNoDataVal);
+            
+            // The counts are needed so the percentile values can be picked out as the sorted values are read.
+            std::vector<size_t> clumpCounts(numRows, 0);
+            RSGISSortedClumpValues sortedVals(maxMemory, tmpDIR);
+            
+            GDALDataset **datasets = new GDALDataset*[2];
+            datasets[0] = inputClumps;
+            datasets[1] = inputValsImage;
+            
+            RSGISCalcClusterPxlValueSorted calcImgValSorted(&sortedVals, &clumpCounts, ratBand, band, noDataVal, useNoDataVal);
+            rsgis::img::RSGISCalcImage calcImageStats(&calcImgValSorted);
+            calcImageStats.calcImage(datasets, 1, 1);
+            delete[] datasets;
+            
+            sortedVals.finishAdding();
+            if(sortedVals.getNumRuns() > 0)
+            {
+                std::cout << "Merging " << sortedVals.getNumRuns() << " sorted runs of pixel values\n";
+            }
+            
+            std::cout << "Writing Percentile Values to Output RAT\n";
+            size_t numPercentiles = bandStats->size();
+            std::vector< std::vector<double> > dataBlocks(numPercentiles, std::vector<double>(RAT_BLOCK_LENGTH));
+            std::vector<boost::uint_fast64_t> ranks(numPercentiles, 0);
+            RSGISClumpValue clumpVal;
+            bool haveVal = sortedVals.getNextValue(&clumpVal);
+            size_t currentClump = numRows;
+            size_t valIdx = 0;
+            for(size_t startRow = 0; startRow < numRows; startRow += RAT_BLOCK_LENGTH)
+            {
+                size_t blockLen = std::min<size_t>(RAT_BLOCK_LENGTH, numRows - startRow);
+                for(size_t p = 0; p < numPercentiles; ++p)
+                {
+                    std::fill(dataBlocks[p].begin(), dataBlocks[p].end(), 0.0);
+                }
+                
+                // The values arrive in clump then value order.
+                while(haveVal && (clumpVal.clumpID < (startRow + blockLen)))
+                {
+                    if(clumpVal.clumpID != currentClump)
+                    {
+                        currentClump = clumpVal.clumpID;
+                        valIdx = 0;
+                        for(size_t p = 0; p < numPercentiles; ++p)
+                        {
+                            ranks[p] = this->getPercentileRank(bandStats->at(p)->percentile, clumpCounts[currentClump]);
+                        }
+                    }
+                    for(size_t p = 0; p < numPercentiles; ++p)
+                    {
+                        if(ranks[p] == valIdx)
+                        {
+                            dataBlocks[p][currentClump - startRow] = clumpVal.val;
+                        }
+                    }
+                    ++valIdx;
+                    haveVal = sortedVals.getNextValue(&clumpVal);
+                }
+                
+                for(size_t p = 0; p < numPercentiles; ++p)
+                {
+                    rat->ValuesIO(GF_Write, bandStats->at(p)->fieldIdx, startRow, blockLen, dataBlocks[p].data());
+                }
+            }
+        }
+        catch(RSGISAttributeTableException &e)
+        {
+            throw e;
+        }
+        catch(RSGISException &e)
+        {
+            throw RSGISAttributeTableException(e.what());
+        }
+        catch(std::exception &e)
+        {
+            throw RSGISAttributeTableException(e.what());
+        }
+    }
+    
+    GDALRasterAttributeTable* RSGISPopRATWithStats::prepRATForPercentiles(GDALDataset *inputClumps, GDALDataset *inputValsImage, unsigned int band, std::vector<RSGISBandAttPercentiles*> *bandStats, unsigned int ratBand, size_t *numRows)
+    {
+        if(ratBand == 0)
+        {
+            throw rsgis::RSGISAttributeTableException("RAT Band must be greater than zero.");
+        }
+        if(ratBand > inputClumps->GetRasterCount())
+        {
+            throw rsgis::RSGISAttributeTableException("RAT Band is larger than the number of bands within the image.");
+        }
+        if(band == 0)
+        {
+            throw rsgis::RSGISAttributeTableException("Values image band must be greater than zero.");
+        }
+        if(band > inputValsImage->GetRasterCount())
+        {
+            throw rsgis::RSGISAttributeTableException("Values image band is larger than the number of bands within the image.");
+        }
+        
+        RSGISRasterAttUtils attUtils;
+        GDALRasterAttributeTable *rat = inputClumps->GetRasterBand(ratBand)->GetDefaultRAT();
+        *numRows = rat->GetRowCount();
+        
+        long minClumpID = 0;
+        long maxClumpID = 0;
+        attUtils.getImageBandMinMax(inputClumps, ratBand, &minClumpID, &maxClumpID);
+        
+        // The clump ID is the row index so there must be maxClumpID+1 rows.
+        if((maxClumpID >= 0) && (boost::lexical_cast<size_t>(maxClumpID) >= *numRows))
+        {
+            *numRows = boost::lexical_cast<size_t>(maxClumpID) + 1;
+            rat->SetRowCount(*numRows);
+        }
+        
+        for(std::vector<rsgis::rastergis::RSGISBandAttPercentiles*>::iterator iterFeat = bandStats->begin(); iterFeat != bandStats->end(); ++iterFeat)
+        {
+            (*iterFeat)->fieldIdx = attUtils.findColumnIndexOrCreate(rat, (*iterFeat)->fieldName, GFT_Real);
+        }
+        return rat;
+    }
+    
+    boost::uint_fast64_t RSGISPopRATWithStats::getPercentileRank(float percentile, boost::uint_fast64_t numVals)
+    {
+        // calcPercentile takes the first value at which the cumulative count reaches
+        // floor(n * percentile / 100), or the minimum if that count is zero.
+        double count = floor(((double)numVals) * (percentile / 100.0));
+        if(count < 1)
+        {
+            return 0;
+        }
+        if(count > numVals)
+        {
+            return numVals - 1;
+        }
+        return ((boost::uint_fast64_t)count) - 1;
+    }
+
     void RSGISPopRATWithStats::populateRATWithMeanLitStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, GDALDataset *inputMeanLitImage, unsigned int meanLitBand, std::string meanLitCol, std::string pxlCountCol, std::vector<RSGISBandAttStats*> *bandStats, unsigned int ratBand)
     {
         try
@@ -1429,6 +1654,71 @@ namespace rsgis{namespace rastergis{
     
     
     
+    RSGISCalcClusterPxlValueSketches::RSGISCalcClusterPxlValueSketches(std::vector<rsgis::math::RSGISQuantileSketch*> *clumpSketches, unsigned int sketchK, unsigned int ratBand, unsigned int imgBand, double noDataVal, bool useNoDataVal): rsgis::img::RSGISCalcImageValue(0)
+    {
+        this->clumpSketches = clumpSketches;
+        this->sketchK = sketchK;
+        this->ratBand = ratBand;
+        this->imgBand = imgBand;
+        this->noDataVal = noDataVal;
+        this->useNoDataVal = useNoDataVal;
+    }
+    
+    void RSGISCalcClusterPxlValueSketches::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals)
+    {
+        if(intBandValues[ratBand-1] > 0)
+        {
+            size_t fid = boost::lexical_cast<size_t>(intBandValues[ratBand-1]);
+            float val = floatBandValues[imgBand-1];
+            if((boost::math::isfinite)(val) && !(this->useNoDataVal && (this->noDataVal == val)))
+            {
+                rsgis::math::RSGISQuantileSketch *sketch = clumpSketches->at(fid);
+                if(sketch == NULL)
+                {
+                    sketch = new rsgis::math::RSGISQuantileSketch(this->sketchK);
+                    clumpSketches->at(fid) = sketch;
+                }
+                sketch->add(val);
+            }
+        }
+    }
+    
+    RSGISCalcClusterPxlValueSketches::~RSGISCalcClusterPxlValueSketches()
+    {
+        
+    }
+    
+    
+    RSGISCalcClusterPxlValueSorted::RSGISCalcClusterPxlValueSorted(RSGISSortedClumpValues *sortedVals, std::vector<size_t> *clumpCounts, unsigned int ratBand, unsigned int imgBand, double noDataVal, bool useNoDataVal): rsgis::img::RSGISCalcImageValue(0)
+    {
+        this->sortedVals = sortedVals;
+        this->clumpCounts = clumpCounts;
+        this->ratBand = ratBand;
+        this->imgBand = imgBand;
+        this->noDataVal = noDataVal;
+        this->useNoDataVal = useNoDataVal;
+    }
+    
+    void RSGISCalcClusterPxlValueSorted::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals)
+    {
+        if(intBandValues[ratBand-1] > 0)
+        {
+            size_t fid = boost::lexical_cast<size_t>(intBandValues[ratBand-1]);
+            float val = floatBandValues[imgBand-1];
+            if((boost::math::isfinite)(val) && !(this->useNoDataVal && (this->noDataVal == val)))
+            {
+                ++clumpCounts->at(fid);
+                sortedVals->addValue(fid, val);
+            }
+        }
+    }
+    
+    RSGISCalcClusterPxlValueSorted::~RSGISCalcClusterPxlValueSorted()
+    {
+        
+    }
+    
+    
     RSGISCalcClusterPxlValueStatsMeanLit::RSGISCalcClusterPxlValueStatsMeanLit(double **statsData, double *pxlCount, double *meanLitColVals, unsigned int meanLitBandArrIdx, std::vector<rsgis::rastergis::RSGISBandAttStats*> *bandStats, bool *firstVal, unsigned int ratBand) : rsgis::img::RSGISCalcImageValue(0)
     {
         this->statsData = statsData;
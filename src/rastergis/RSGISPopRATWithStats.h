@@ -33,8 +33,10 @@
 #include "common/RSGISAttributeTableException.h"
 
 #include "math/RSGISMathsUtils.h"
+#include "math/RSGISQuantileSketch.h"
 
 #include "rastergis/RSGISRasterAttUtils.h"
+#include "rastergis/RSGISSortedClumpValues.h"
 
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
@@ -122,10 +124,28 @@ namespace rsgis{namespace rastergis{
         RSGISPopRATWithStats();
         void populateRATWithBasicStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, std::vector<RSGISBandAttStats*> *bandStats, unsigned int ratBand);
         void populateRATWithPercentileStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, unsigned int band, std::vector<RSGISBandAttPercentiles*> *bandStats, unsigned int ratBand, unsigned int numHistBins);
+        /**
+         * Populate the RAT with percentiles using a quantile sketch (rsgis::math::RSGISQuantileSketch)
+         * for each clump containing valid pixels rather than a histogram for every row, so memory is
+         * not proportional to the number of rows multiplied by the number of bins. sketchK sets the
+         * accuracy and the memory used for each clump (about 3 x sketchK values at most); the
+         * percentiles are exact for clumps with fewer than sketchK valid pixels.
+         */
+        void populateRATWithPercentileStatsSketch(GDALDataset *inputClumps, GDALDataset *inputValsImage, unsigned int band, std::vector<RSGISBandAttPercentiles*> *bandStats, unsigned int ratBand, unsigned int sketchK);
+        /**
+         * Populate the RAT with exact percentiles. The clump and pixel values are sorted using
+         * no more than maxMemory bytes (plus a pixel count for each row), where sorted runs are
+         * written to tmpDIR (the system temporary directory if empty) and merged as required.
+         */
+        void populateRATWithPercentileStatsExact(GDALDataset *inputClumps, GDALDataset *inputValsImage, unsigned int band, std::vector<RSGISBandAttPercentiles*> *bandStats, unsigned int ratBand, size_t maxMemory, std::string tmpDIR);
         void populateRATWithMeanLitStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, GDALDataset *inputMeanLitImage, unsigned int meanLitBand, std::string meanLitCol, std::string pxlCountCol, std::vector<RSGISBandAttStats*> *bandStats, unsigned int ratBand);
         void populateRATWithModeStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, std::string outColsName, bool useNoDataVal, long noDataVal, bool outNoDataVal, unsigned int modeBand, unsigned int ratBand);
         void populateRATWithPopValidPixels(GDALDataset *inputClumps, GDALDataset *inputValsImage, std::string outColsName, double noDataVal, unsigned int ratBand);
         ~RSGISPopRATWithStats();
+    protected:
+        GDALRasterAttributeTable* prepRATForPercentiles(GDALDataset *inputClumps, GDALDataset *inputValsImage, unsigned int band, std::vector<RSGISBandAttPercentiles*> *bandStats, unsigned int ratBand, size_t *numRows);
+        /** The (0 based) rank of the percentile value, using the same definition as rsgis::math::RSGISMathsUtils::calcPercentile. */
+        boost::uint_fast64_t getPercentileRank(float percentile, boost::uint_fast64_t numVals);
     };
     
     class DllExport RSGISCalcClusterPxlValueStats : public rsgis::img::RSGISCalcImageValue
@@ -201,6 +221,57 @@ namespace rsgis{namespace rastergis{
     
     
     
+    class DllExport RSGISCalcClusterPxlValueSketches : public rsgis::img::RSGISCalcImageValue
+	{
+	public:
+		RSGISCalcClusterPxlValueSketches(std::vector<rsgis::math::RSGISQuantileSketch*> *clumpSketches, unsigned int sketchK, unsigned int ratBand, unsigned int imgBand, double noDataVal, bool useNoDataVal);
+		void calcImageValue(float *bandValues, int numBands, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+		void calcImageValue(float *bandValues, int numBands) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
+        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals);
+        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
+		void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, geos::geom::Envelope extent){throw rsgis::img::RSGISImageCalcException("Not implemented");};
+        void calcImageValue(float *bandValues, int numBands, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+		void calcImageValue(float *bandValues, int numBands, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+		void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+        void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+		bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+		~RSGISCalcClusterPxlValueSketches();
+    private:
+        std::vector<rsgis::math::RSGISQuantileSketch*> *clumpSketches;
+        unsigned int sketchK;
+        unsigned int ratBand;
+        unsigned int imgBand;
+        double noDataVal;
+        bool useNoDataVal;
+	};
+    
+    
+    class DllExport RSGISCalcClusterPxlValueSorted : public rsgis::img::RSGISCalcImageValue
+	{
+	public:
+		RSGISCalcClusterPxlValueSorted(RSGISSortedClumpValues *sortedVals, std::vector<size_t> *clumpCounts, unsigned int ratBand, unsigned int imgBand, double noDataVal, bool useNoDataVal);
+		void calcImageValue(float *bandValues, int numBands, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+		void calcImageValue(float *bandValues, int numBands) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
+        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals);
+        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
+		void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, geos::geom::Envelope extent){throw rsgis::img::RSGISImageCalcException("Not implemented");};
+        void calcImageValue(float *bandValues, int numBands, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+		void calcImageValue(float *bandValues, int numBands, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+		void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+        void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+		bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+		~RSGISCalcClusterPxlValueSorted();
+    private:
+        RSGISSortedClumpValues *sortedVals;
+        std::vector<size_t> *clumpCounts;
+        unsigned int ratBand;
+        unsigned int imgBand;
+        double noDataVal;
+        bool useNoDataVal;
+	};
+    
+    
+    
     class DllExport RSGISCalcClusterPxlValueStatsMeanLit : public rsgis::img::RSGISCalcImageValue
 	{
 	public:
@@ -29,7 +29,7 @@ namespace rsgis{namespace rastergis{
         
     }
     
-    void RSGISApplyRATKNN::applyKNNExtrapolation(GDALDataset *clumpsDS, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgis::math::rsgisdistmetrics distKNN, float distThreshold, rsgis::math::rsgissummarytype summeriseKNN, unsigned int ratBand)
+    void RSGISApplyRATKNN::applyKNNExtrapolation(GDALDataset *clumpsDS, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgis::math::rsgisdistmetrics distKNN, float distThreshold, rsgis::math::rsgissummarytype summeriseKNN, unsigned int ratBand, float approxEps)
     {
         try
         {
@@ -136,25 +136,68 @@ namespace rsgis{namespace rastergis{
                 throw RSGISAttributeTableException("Summary method is not supported and/or known.");
             }
             
+            if(approxEps < 0)
+            {
+                throw RSGISAttributeTableException("The approximation factor for the KNN search cannot be negative.");
+            }
+            
+            size_t numFeatVals = numFloatVals - 1;
             rsgis::math::RSGISCalcDistMetric *calcDist = NULL;
+            rsgis::math::RSGISKDTree *kdTree = NULL;
+            double **whitenMatrix = NULL;
+            double **whitenTrainData = NULL;
+            double maxDist = distThreshold;
             if(distKNN == rsgis::math::rsgis_euclidean)
             {
-                calcDist = new rsgis::math::RSGISCalcEuclideanDistMetric();
-                calcDist->init();
+                // RSGISCalcEuclideanDistMetric is normalised by the number of features.
+                kdTree = new rsgis::math::RSGISKDTree(trainData, numTrainFeats, 1, numFloatVals, rsgis::math::rsgis_euclidean);
+                maxDist = distThreshold * sqrt((double)numFeatVals);
             }
             else if(distKNN == rsgis::math::rsgis_manhatten)
             {
-                calcDist = new rsgis::math::RSGISCalcManhattenDistMetric();
-                calcDist->init();
+                // RSGISCalcManhattenDistMetric is sqrt(sum/n) of the absolute differences.
+                kdTree = new rsgis::math::RSGISKDTree(trainData, numTrainFeats, 1, numFloatVals, rsgis::math::rsgis_manhatten);
+                maxDist = ((double)distThreshold) * distThreshold * numFeatVals;
             }
             else if(distKNN == rsgis::math::rsgis_mahalanobis)
             {
                 double *meanVec = mathUtils.calcMeanVector(trainData, numTrainFeats, numFloatVals, 1, numFloatVals);
                 double **covarMatrix = mathUtils.calcCovarianceMatrix(trainData, meanVec, numTrainFeats, numFloatVals, 1, numFloatVals);
-                size_t numVals = numFloatVals - 1;
                 delete[] meanVec;
-                calcDist = new rsgis::math::RSGISCalcMahalanobisDistMetric(covarMatrix, numVals);
-                calcDist->init();
+                
+                whitenMatrix = new double*[numFeatVals];
+                for(size_t i = 0; i < numFeatVals; ++i)
+                {
+                    whitenMatrix[i] = new double[numFeatVals];
+                }
+                if(this->calcWhitenMatrix(covarMatrix, numFeatVals, whitenMatrix))
+                {
+                    // Euclidean distance between whitened features is the Mahalanobis distance.
+                    whitenTrainData = new double*[numTrainFeats];
+                    for(size_t i = 0; i < numTrainFeats; ++i)
+                    {
+                        whitenTrainData[i] = new double[numFeatVals];
+                        this->whitenFeatures(whitenMatrix, numFeatVals, &trainData[i][1], whitenTrainData[i]);
+                    }
+                    kdTree = new rsgis::math::RSGISKDTree(whitenTrainData, numTrainFeats, 0, numFeatVals, rsgis::math::rsgis_euclidean);
+                    for(size_t i = 0; i < numFeatVals; ++i)
+                    {
+                        delete[] covarMatrix[i];
+                    }
+                    delete[] covarMatrix;
+                }
+                else
+                {
+                    // The covariance matrix is not positive definite so search all the training data.
+                    for(size_t i = 0; i < numFeatVals; ++i)
+                    {
+                        delete[] whitenMatrix[i];
+                    }
+                    delete[] whitenMatrix;
+                    whitenMatrix = NULL;
+                    calcDist = new rsgis::math::RSGISCalcMahalanobisDistMetric(covarMatrix, numFeatVals);
+                    calcDist->init();
+                }
             }
             else if(distKNN == rsgis::math::rsgis_minkowski)
             {
@@ -174,15 +217,40 @@ namespace rsgis{namespace rastergis{
                 
             // Perform KNN
             std::cout << "Perform KNN\n";
-            inIntColIdx.clear();
-            if(useApplyField)
+            if(kdTree != NULL)
             {
-                inIntColIdx.push_back(applyRegFieldIdx);
+                this->applyKNNWithIndex(gdalAtt, kdTree, whitenMatrix, trainData, fieldsIdx, useApplyField, applyRegFieldIdx, outExtrapFieldIdx, kFeatures, maxDist, approxEps, mathSumStats);
+            }
+            else
+            {
+                inIntColIdx.clear();
+                if(useApplyField)
+                {
+                    inIntColIdx.push_back(applyRegFieldIdx);
+                }
+                outRealColIdx.push_back(outExtrapFieldIdx);
+                RSGISPerformKNNCalcValues performKNN = RSGISPerformKNNCalcValues(trainData, numTrainFeats, numFloatVals, kFeatures, calcDist, distThreshold, mathSumStats);
+                ratCalc = RSGISRATCalc(&performKNN);
+                ratCalc.calcRATValues(gdalAtt, inRealColIdx, inIntColIdx, inStrColIdx, outRealColIdx, outIntColIdx, outStrColIdx);
             }
-            outRealColIdx.push_back(outExtrapFieldIdx);
-            RSGISPerformKNNCalcValues performKNN = RSGISPerformKNNCalcValues(trainData, numTrainFeats, numFloatVals, kFeatures, calcDist, distThreshold, mathSumStats);
-            ratCalc = RSGISRATCalc(&performKNN);
-            ratCalc.calcRATValues(gdalAtt, inRealColIdx, inIntColIdx, inStrColIdx, outRealColIdx, outIntColIdx, outStrColIdx);
+            
+            if(whitenTrainData != NULL)
+            {
+                for(size_t i = 0; i < numTrainFeats; ++i)
+                {
+                    delete[] whitenTrainData[i];
+                }
+                delete[] whitenTrainData;
+            }
+            if(whitenMatrix != NULL)
+            {
+                for(size_t i = 0; i < numFeatVals; ++i)
+                {
+                    delete[] whitenMatrix[i];
+                }
+                delete[] whitenMatrix;
+            }
+            delete kdTree;
             
             // Deallocate memory
             for(size_t i = 0; i < numTrainFeats; ++i)
@@ -191,7 +259,10 @@ namespace rsgis{namespace rastergis{
             }
             delete[]trainData;
             delete mathSumStats;
-            delete calcDist;
+            if(calcDist != NULL)
+            {
+                delete calcDist;
+            }
         }
         catch (RSGISAttributeTableException &e)
         {
@@ -207,6 +278,172 @@ namespace rsgis{namespace rastergis{
         }
     }
     
+    void RSGISApplyRATKNN::applyKNNWithIndex(GDALRasterAttributeTable *gdalAtt, rsgis::math::RSGISKDTree *kdTree, double **whitenMatrix, double **trainData, std::vector<unsigned int> fieldsIdx, bool useApplyField, unsigned int applyRegFieldIdx, unsigned int outExtrapFieldIdx, unsigned int kFeatures, double maxDist, float approxEps, rsgis::math::RSGISStatsSummary *mathSumStats)
+    {
+        size_t numFeatVals = fieldsIdx.size();
+        size_t nRows = gdalAtt->GetRowCount();
+        size_t blockLen = std::min(nRows, (size_t)RAT_BLOCK_LENGTH);
+        const size_t rowsPerTask = 1000;
+        
+        // Feature values for each row in the block (row-major, whitened if required).
+        std::vector<double> featVals(blockLen * numFeatVals);
+        std::vector<double> colVals(blockLen);
+        std::vector<int> applyVals(blockLen, 1);
+        std::vector<double> outVals(blockLen);
+        
+        rsgis::RSGISThreadPool threadPool(rsgis::RSGISThreadPool::getDefaultNumThreads());
+        unsigned int numThreads = threadPool.getNumThreads();
+        std::vector<rsgis::math::RSGISStatsSummary> threadStats(numThreads, *mathSumStats);
+        
+        rsgis_tqdm pbar;
+        for(size_t startRow = 0; startRow < nRows; startRow += blockLen)
+        {
+            pbar.progress(startRow, nRows);
+            size_t numBlockRows = std::min(blockLen, nRows - startRow);
+            
+            for(size_t n = 0; n < numFeatVals; ++n)
+            {
+                if(gdalAtt->ValuesIO(GF_Read, fieldsIdx[n], startRow, numBlockRows, colVals.data()) != CE_None)
+                {
+                    throw RSGISAttributeTableException("Could not read column from the attribute table.");
+                }
+                for(size_t i = 0; i < numBlockRows; ++i)
+                {
+                    featVals[(i * numFeatVals) + n] = colVals[i];
+                }
+            }
+            if(useApplyField)
+            {
+                if(gdalAtt->ValuesIO(GF_Read, applyRegFieldIdx, startRow, numBlockRows, applyVals.data()) != CE_None)
+                {
+                    throw RSGISAttributeTableException("Could not read column from the attribute table.");
+                }
+            }
+            
+            for(size_t taskStart = 0; taskStart < numBlockRows; taskStart += rowsPerTask)
+            {
+                size_t taskEnd = std::min(taskStart + rowsPerTask, numBlockRows);
+                threadPool.submit([this, taskStart, taskEnd, numFeatVals, kdTree, whitenMatrix, trainData, kFeatures, maxDist, approxEps, &featVals, &applyVals, &outVals, &threadStats](unsigned int threadIdx)
+                {
+                    rsgis::math::RSGISMathsUtils mathUtils;
+                    rsgis::math::RSGISStatsSummary *stats = &threadStats[threadIdx];
+                    std::vector<rsgis::math::RSGISKDTreeNeighbour> neighbours;
+                    std::vector<double> whitenVals(numFeatVals);
+                    std::vector<double> data;
+                    data.reserve(kFeatures);
+                    for(size_t i = taskStart; i < taskEnd; ++i)
+                    {
+                        if(applyVals[i] != 1)
+                        {
+                            outVals[i] = std::numeric_limits<double>::signaling_NaN();
+                            continue;
+                        }
+                        const double *query = &featVals[i * numFeatVals];
+                        if(whitenMatrix != NULL)
+                        {
+                            this->whitenFeatures(whitenMatrix, numFeatVals, query, whitenVals.data());
+                            query = whitenVals.data();
+                        }
+                        kdTree->findKNearest(query, kFeatures, &neighbours, maxDist, approxEps);
+                        if(neighbours.empty())
+                        {
+                            outVals[i] = std::numeric_limits<double>::quiet_NaN();
+                            continue;
+                        }
+                        
+                        data.clear();
+                        for(std::vector<rsgis::math::RSGISKDTreeNeighbour>::iterator iterNeigh = neighbours.begin(); iterNeigh != neighbours.end(); ++iterNeigh)
+                        {
+                            data.push_back(trainData[(*iterNeigh).idx][0]);
+                        }
+                        mathUtils.generateStats(&data, stats);
+                        
+                        if(stats->calcMean)
+                        {
+                            outVals[i] = stats->mean;
+                        }
+                        else if(stats->calcMedian)
+                        {
+                            outVals[i] = stats->median;
+                        }
+                        else if(stats->calcMax)
+                        {
+                            outVals[i] = stats->max;
+                        }
+                        else if(stats->calcMin)
+                        {
+                            outVals[i] = stats->min;
+                        }
+                        else if(stats->calcMode)
+                        {
+                            outVals[i] = stats->mode;
+                        }
+                        else
+                        {
+                            throw RSGISAttributeTableException("Summarise option unknown.");
+                        }
+                    }
+                });
+            }
+            threadPool.wait();
+            
+            if(gdalAtt->ValuesIO(GF_Write, outExtrapFieldIdx, startRow, numBlockRows, outVals.data()) != CE_None)
+            {
+                throw RSGISAttributeTableException("Could not write column to the attribute table.");
+            }
+        }
+        pbar.finish();
+    }
+    
+    bool RSGISApplyRATKNN::calcWhitenMatrix(double **covarMatrix, size_t n, double **whitenMatrix)
+    {
+        // Cholesky decomposition (covarMatrix = L L^T), L is stored in the lower triangle.
+        for(size_t i = 0; i < n; ++i)
+        {
+            for(size_t j = 0; j < n; ++j)
+            {
+                whitenMatrix[i][j] = 0.0;
+            }
+        }
+        for(size_t j = 0; j < n; ++j)
+        {
+            double diagVal = covarMatrix[j][j];
+            for(size_t k = 0; k < j; ++k)
+            {
+                diagVal -= whitenMatrix[j][k] * whitenMatrix[j][k];
+            }
+            if(!(diagVal > 0))
+            {
+                return false;
+            }
+            whitenMatrix[j][j] = sqrt(diagVal);
+            for(size_t i = j + 1; i < n; ++i)
+            {
+                double val = covarMatrix[i][j];
+                for(size_t k = 0; k < j; ++k)
+                {
+                    val -= whitenMatrix[i][k] * whitenMatrix[j][k];
+                }
+                whitenMatrix[i][j] = val / whitenMatrix[j][j];
+            }
+        }
+        return true;
+    }
+    
+    void RSGISApplyRATKNN::whitenFeatures(double **whitenMatrix, size_t n, const double *inVals, double *outVals)
+    {
+        // Solve L z = x by forward substitution so |z1 - z2| is the Mahalanobis distance between x1 and x2.
+        for(size_t i = 0; i < n; ++i)
+        {
+            double val = inVals[i];
+            for(size_t k = 0; k < i; ++k)
+            {
+                val -= whitenMatrix[i][k] * outVals[k];
+            }
+            outVals[i] = val / whitenMatrix[i][i];
+        }
+    }
+    
     RSGISApplyRATKNN::~RSGISApplyRATKNN()
     {
         
@@ -404,14 +641,20 @@ namespace rsgis{namespace rastergis{
                     }
                     else
                     {
+                        bool inserted = false;
                         for(std::list<std::pair<double, double*> >::iterator iterFeat = kVals->begin(); iterFeat != kVals->end(); ++iterFeat)
                         {
                             if(dist < (*iterFeat).first)
                             {
                                 kVals->insert(iterFeat, std::pair<double, double*>(dist, this->trainData[i]));
+                                inserted = true;
                                 break;
                             }
                         }
+                        if((!inserted) && (kVals->size() < this->kFeatures))
+                        {
+                            kVals->push_back(std::pair<double, double*>(dist, this->trainData[i]));
+                        }
                         if(kVals->size() > this->kFeatures)
                         {
                             kVals->pop_back();
@@ -27,11 +27,15 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <algorithm>
+#include <limits>
 
 #include "gdal_priv.h"
 #include "gdal_rat.h"
 
 #include "common/RSGISAttributeTableException.h"
+#include "common/RSGISThreadPool.h"
+#include "common/rsgis-tqdm.h"
 
 #include "rastergis/RSGISRasterAttUtils.h"
 #include "rastergis/RSGISRATCalcValue.h"
@@ -39,6 +43,7 @@
 
 #include "math/RSGISMathsUtils.h"
 #include "math/RSGISDistMetrics.h"
+#include "math/RSGISKDTree.h"
 
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
@@ -56,12 +61,25 @@
 namespace rsgis{namespace rastergis{
     
     
+    /**
+     * Extrapolates a column to the clumps in a RAT using the k nearest training
+     * clumps. For Euclidean, Manhattan and Mahalanobis distances the training
+     * clumps are indexed with a KD-tree (for Mahalanobis distance the features
+     * are whitened using the Cholesky decomposition of the covariance matrix)
+     * and the rows of the RAT are queried in blocks across the library default
+     * number of threads. If approxEps is greater than 0 the search is
+     * approximate (see rsgis::math::RSGISKDTree::findKNearest).
+     */
     class DllExport RSGISApplyRATKNN
     {
     public:
         RSGISApplyRATKNN();
-        void applyKNNExtrapolation(GDALDataset *clumpsDS, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures=12, rsgis::math::rsgisdistmetrics distKNN=rsgis::math::rsgis_mahalanobis, float distThreshold=100000, rsgis::math::rsgissummarytype summeriseKNN=rsgis::math::sumtype_median, unsigned int ratBand=1);
+        void applyKNNExtrapolation(GDALDataset *clumpsDS, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures=12, rsgis::math::rsgisdistmetrics distKNN=rsgis::math::rsgis_mahalanobis, float distThreshold=100000, rsgis::math::rsgissummarytype summeriseKNN=rsgis::math::sumtype_median, unsigned int ratBand=1, float approxEps=0);
         ~RSGISApplyRATKNN();
+    protected:
+        void applyKNNWithIndex(GDALRasterAttributeTable *gdalAtt, rsgis::math::RSGISKDTree *kdTree, double **whitenMatrix, double **trainData, std::vector<unsigned int> fieldsIdx, bool useApplyField, unsigned int applyRegFieldIdx, unsigned int outExtrapFieldIdx, unsigned int kFeatures, double maxDist, float approxEps, rsgis::math::RSGISStatsSummary *mathSumStats);
+        bool calcWhitenMatrix(double **covarMatrix, size_t n, double **whitenMatrix);
+        void whitenFeatures(double **whitenMatrix, size_t n, const double *inVals, double *outVals);
     };
     
     class DllExport RSGISCountTrainingValues : public RSGISRATCalcValue
@@ -0,0 +1,173 @@
+/*
+ *  RSGISSortedClumpValues.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISSortedClumpValues.h"
+
+namespace rsgis{namespace rastergis{
+
+    RSGISSortedClumpValues::RSGISSortedClumpValues(size_t maxMemory, std::string tmpDIR)
+    {
+        this->maxBufferVals = maxMemory / sizeof(RSGISClumpValue);
+        if(this->maxBufferVals < 1024)
+        {
+            throw rsgis::RSGISAttributeTableException("The memory available for sorting the clump values is too small.");
+        }
+        if(tmpDIR == "")
+        {
+            this->tmpDIR = boost::filesystem::temp_directory_path();
+        }
+        else
+        {
+            this->tmpDIR = boost::filesystem::path(tmpDIR);
+        }
+        this->adding = true;
+        this->bufferPos = 0;
+    }
+
+    void RSGISSortedClumpValues::finishAdding()
+    {
+        if(!this->adding)
+        {
+            throw rsgis::RSGISAttributeTableException("Values have already been finished.");
+        }
+        this->adding = false;
+
+        if(this->runFiles.empty())
+        {
+            std::sort(this->buffer.begin(), this->buffer.end());
+            this->bufferPos = 0;
+            return;
+        }
+
+        if(!this->buffer.empty())
+        {
+            this->writeRun();
+        }
+        std::vector<RSGISClumpValue>().swap(this->buffer);
+
+        // Share the memory between the runs for reading them back.
+        size_t numRuns = this->runFiles.size();
+        size_t runBufferVals = this->maxBufferVals / numRuns;
+        if(runBufferVals < 256)
+        {
+            runBufferVals = 256;
+        }
+        this->runs.resize(numRuns);
+        this->runHeap.reserve(numRuns);
+        for(size_t i = 0; i < numRuns; ++i)
+        {
+            this->runs[i].file = new std::ifstream(this->runFiles[i].c_str(), std::ios::in | std::ios::binary);
+            if(!this->runs[i].file->is_open())
+            {
+                throw rsgis::RSGISAttributeTableException("Could not open temporary file: " + this->runFiles[i]);
+            }
+            this->runs[i].vals.resize(runBufferVals);
+            this->runs[i].pos = 0;
+            if(this->readRunVals(&this->runs[i]))
+            {
+                this->runHeap.push_back(std::pair<RSGISClumpValue, size_t>(this->runs[i].vals[0], i));
+            }
+        }
+        std::make_heap(this->runHeap.begin(), this->runHeap.end(), RSGISSortedClumpValues::heapGreater);
+    }
+
+    bool RSGISSortedClumpValues::getNextValue(RSGISClumpValue *clumpVal)
+    {
+        if(this->adding)
+        {
+            throw rsgis::RSGISAttributeTableException("finishAdding() must be called before the values are read.");
+        }
+
+        if(this->runFiles.empty())
+        {
+            if(this->bufferPos < this->buffer.size())
+            {
+                *clumpVal = this->buffer[this->bufferPos++];
+                return true;
+            }
+            return false;
+        }
+
+        if(this->runHeap.empty())
+        {
+            return false;
+        }
+        std::pop_heap(this->runHeap.begin(), this->runHeap.end(), RSGISSortedClumpValues::heapGreater);
+        *clumpVal = this->runHeap.back().first;
+        size_t runIdx = this->runHeap.back().second;
+        this->runHeap.pop_back();
+
+        RSGISClumpValueRun *run = &this->runs[runIdx];
+        ++run->pos;
+        if((run->pos < run->vals.size()) || this->readRunVals(run))
+        {
+            this->runHeap.push_back(std::pair<RSGISClumpValue, size_t>(run->vals[run->pos], runIdx));
+            std::push_heap(this->runHeap.begin(), this->runHeap.end(), RSGISSortedClumpValues::heapGreater);
+        }
+        return true;
+    }
+
+    void RSGISSortedClumpValues::writeRun()
+    {
+        std::sort(this->buffer.begin(), this->buffer.end());
+
+        boost::filesystem::path runPath = this->tmpDIR / boost::filesystem::unique_path("rsgis_clumpvals_%%%%-%%%%-%%%%-%%%%.tmp");
+        std::string runFile = runPath.string();
+        std::ofstream outFile(runFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!outFile.is_open())
+        {
+            throw rsgis::RSGISAttributeTableException("Could not create temporary file: " + runFile);
+        }
+        this->runFiles.push_back(runFile);
+        outFile.write((const char *)this->buffer.data(), this->buffer.size() * sizeof(RSGISClumpValue));
+        outFile.close();
+        if(outFile.fail())
+        {
+            throw rsgis::RSGISAttributeTableException("Could not write to temporary file: " + runFile);
+        }
+        this->buffer.clear();
+    }
+
+    bool RSGISSortedClumpValues::readRunVals(RSGISClumpValueRun *run)
+    {
+        run->vals.resize(run->vals.capacity());
+        run->file->read((char *)run->vals.data(), run->vals.size() * sizeof(RSGISClumpValue));
+        size_t numRead = run->file->gcount() / sizeof(RSGISClumpValue);
+        run->vals.resize(numRead);
+        run->pos = 0;
+        return numRead > 0;
+    }
+
+    RSGISSortedClumpValues::~RSGISSortedClumpValues()
+    {
+        for(std::vector<RSGISClumpValueRun>::iterator iterRun = this->runs.begin(); iterRun != this->runs.end(); ++iterRun)
+        {
+            delete (*iterRun).file;
+        }
+        for(std::vector<std::string>::iterator iterFile = this->runFiles.begin(); iterFile != this->runFiles.end(); ++iterFile)
+        {
+            boost::system::error_code errCode;
+            boost::filesystem::remove(boost::filesystem::path(*iterFile), errCode);
+        }
+    }
+
+}}
@@ -0,0 +1,121 @@
+/*
+ *  RSGISSortedClumpValues.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISSortedClumpValues_H
+#define RSGISSortedClumpValues_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include "common/RSGISAttributeTableException.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_rastergis_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace rastergis{
+
+    struct DllExport RSGISClumpValue
+    {
+        size_t clumpID;
+        float val;
+
+        bool operator<(const RSGISClumpValue &other) const
+        {
+            return (this->clumpID < other.clumpID) || ((this->clumpID == other.clumpID) && (this->val < other.val));
+        };
+    };
+
+    /**
+     * Sorts (clump, value) pairs by clump and then value using a bounded amount
+     * of memory. Values are buffered until maxMemory bytes are used, at which
+     * point the buffer is sorted and written to a temporary file in tmpDIR
+     * (a 'run'). Once all the values have been added the runs are merged as the
+     * values are read back with getNextValue(). If no run was written the values
+     * are sorted in memory. The temporary files are deleted by the destructor.
+     */
+    class DllExport RSGISSortedClumpValues
+    {
+    public:
+        RSGISSortedClumpValues(size_t maxMemory, std::string tmpDIR="");
+        inline void addValue(size_t clumpID, float val)
+        {
+            RSGISClumpValue clumpVal;
+            clumpVal.clumpID = clumpID;
+            clumpVal.val = val;
+            if(this->buffer.size() == this->buffer.capacity())
+            {
+                // Grow the buffer without going beyond the memory limit.
+                this->buffer.reserve(std::min(std::max(this->buffer.capacity() * 2, (size_t)1024), this->maxBufferVals));
+            }
+            this->buffer.push_back(clumpVal);
+            if(this->buffer.size() >= this->maxBufferVals)
+            {
+                this->writeRun();
+            }
+        };
+        /** Must be called once all the values have been added and before getNextValue(). */
+        void finishAdding();
+        /** Get the next value in clump then value order; returns false once all have been read. */
+        bool getNextValue(RSGISClumpValue *clumpVal);
+        size_t getNumRuns(){return this->runFiles.size();};
+        ~RSGISSortedClumpValues();
+    protected:
+        struct RSGISClumpValueRun
+        {
+            std::ifstream *file;
+            std::vector<RSGISClumpValue> vals;
+            size_t pos;
+        };
+        void writeRun();
+        bool readRunVals(RSGISClumpValueRun *run);
+        static bool heapGreater(const std::pair<RSGISClumpValue, size_t> &a, const std::pair<RSGISClumpValue, size_t> &b)
+        {
+            return b.first < a.first;
+        };
+        size_t maxBufferVals;
+        boost::filesystem::path tmpDIR;
+        bool adding;
+        std::vector<RSGISClumpValue> buffer;
+        size_t bufferPos;
+        std::vector<std::string> runFiles;
+        std::vector<RSGISClumpValueRun> runs;
+        std::vector< std::pair<RSGISClumpValue, size_t> > runHeap;
+    };
+
+}}
+
+#endif
@@ -68,7 +68,7 @@ namespace rsgis{namespace reg{
 		{
 			delete gcps;
 		}
-        GDALClose((GDALDatasetH) gcpDataset);
+        rsgis::img::RSGISImageBlockCache::closeDataset(gcpDataset);
 
     }
     
@@ -39,6 +39,7 @@
 #include "math/RSGISMathsUtils.h"
 
 #include "img/RSGISImageUtils.h"
+#include "img/RSGISImageBlockCache.h"
 #include "common/rsgis-tqdm.h"
 
 #include "registration/RSGISImageWarpException.h"
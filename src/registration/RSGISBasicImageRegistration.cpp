@@ -130,6 +130,15 @@ namespace rsgis{namespace reg{
 			giveFeedback = true;
 		}
 		
+		RSGISFFTSimilarityMetric *fftMetric = dynamic_cast<RSGISFFTSimilarityMetric*>(metric);
+		if(fftMetric != NULL)
+		{
+			std::cout << "Started (" << rsgis::RSGISThreadPool::getDefaultNumThreads() << " threads) ." << std::flush;
+			this->findTiePointLocations(tiePoints, windowSize, searchArea, fftMetric, metricThreshold, subPixelResolution);
+			std::cout << ". Complete\n";
+			return;
+		}
+		
 		std::cout << "Started ." << std::flush;
 		
 		float xShift = 0;
@@ -0,0 +1,364 @@
+/*
+ *  RSGISFFTImageSimilarityMetrics.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISFFTImageSimilarityMetrics.h"
+
+
+namespace rsgis{namespace reg{
+
+    void RSGISFFTSimilarityMetric::padBand(float *data, unsigned int width, unsigned int height, double offset, unsigned int fftWidth, unsigned int fftHeight, std::vector< std::complex<double> > *padded)
+    {
+        padded->assign(((size_t)fftWidth) * fftHeight, std::complex<double>(0, 0));
+        for(unsigned int y = 0; y < height; ++y)
+        {
+            for(unsigned int x = 0; x < width; ++x)
+            {
+                float val = data[(((size_t)y)*width)+x];
+                if(!((boost::math::isnan)(val)))
+                {
+                    (*padded)[(((size_t)y)*fftWidth)+x] = std::complex<double>(val - offset, 0);
+                }
+                else
+                {
+                    (*padded)[(((size_t)y)*fftWidth)+x] = std::complex<double>(0 - offset, 0);
+                }
+            }
+        }
+    }
+
+    double RSGISFFTSimilarityMetric::calcMean(float *data, size_t numVals)
+    {
+        double sum = 0;
+        for(size_t i = 0; i < numVals; ++i)
+        {
+            if(!((boost::math::isnan)(data[i])))
+            {
+                sum += data[i];
+            }
+        }
+        return sum / numVals;
+    }
+
+
+	float RSGISFFTCorrelationSimilarityMetric::calcValue(float **reference, float **floating, unsigned int numVals, unsigned int numDims)
+	{
+		return this->correlation.calcValue(reference, floating, numVals, numDims);
+	}
+
+    void RSGISFFTCorrelationSimilarityMetric::calcSurface(float **reference, unsigned int refWidth, unsigned int refHeight, float **floating, unsigned int fltWidth, unsigned int fltHeight, unsigned int numDims, float **surface)
+    {
+        if((refWidth > fltWidth) | (refHeight > fltHeight))
+        {
+            throw rsgis::math::RSGISMathException("The reference window must not be larger than the floating region.");
+        }
+        size_t numRefVals = ((size_t)refWidth) * refHeight;
+        if(this->hasNaN(reference, numRefVals, numDims) || this->hasNaN(floating, ((size_t)fltWidth) * fltHeight, numDims))
+        {
+            this->calcSurfaceMasked(reference, refWidth, refHeight, floating, fltWidth, fltHeight, numDims, surface);
+            return;
+        }
+        rsgis::math::RSGISFFTWUtils fftUtils;
+        unsigned int fftWidth = fftUtils.calcFFTSize(fltWidth);
+        unsigned int fftHeight = fftUtils.calcFFTSize(fltHeight);
+        unsigned int numXShifts = fltWidth - refWidth + 1;
+        unsigned int numYShifts = fltHeight - refHeight + 1;
+
+        // Sums of the reference window and of the floating region (over all bands).
+        double sumR = 0;
+        double sumRSq = 0;
+        std::vector<double> fltSum(((size_t)fltWidth) * fltHeight, 0.0);
+        std::vector<double> fltSumSq(((size_t)fltWidth) * fltHeight, 0.0);
+
+        std::vector< std::complex<double> > refSpec;
+        std::vector< std::complex<double> > fltSpec;
+        std::vector< std::complex<double> > crossSpec(((size_t)fftWidth) * fftHeight, std::complex<double>(0, 0));
+
+        for(unsigned int n = 0; n < numDims; ++n)
+        {
+            for(size_t i = 0; i < numRefVals; ++i)
+            {
+                if(!((boost::math::isnan)(reference[n][i])))
+                {
+                    sumR += reference[n][i];
+                    sumRSq += (reference[n][i] * reference[n][i]);
+                }
+            }
+        }
+        double numVals = ((double)numDims) * numRefVals;
+        double refMean = sumR / numVals;
+
+        for(unsigned int n = 0; n < numDims; ++n)
+        {
+            for(size_t i = 0; i < fltSum.size(); ++i)
+            {
+                if(!((boost::math::isnan)(floating[n][i])))
+                {
+                    fltSum[i] += floating[n][i];
+                    fltSumSq[i] += (floating[n][i] * floating[n][i]);
+                }
+            }
+
+            // Cross correlation of the reference (less the mean over all bands) with the floating region.
+            this->padBand(reference[n], refWidth, refHeight, refMean, fftWidth, fftHeight, &refSpec);
+            this->padBand(floating[n], fltWidth, fltHeight, 0, fftWidth, fftHeight, &fltSpec);
+            fftUtils.fft2D(&refSpec, fftWidth, fftHeight, false);
+            fftUtils.fft2D(&fltSpec, fftWidth, fftHeight, false);
+            for(size_t i = 0; i < crossSpec.size(); ++i)
+            {
+                crossSpec[i] += std::conj(refSpec[i]) * fltSpec[i];
+            }
+        }
+        fftUtils.fft2D(&crossSpec, fftWidth, fftHeight, true);
+
+        // Integral images so the sums for each shift of the window are 4 look ups.
+        std::vector<double> intF((fltWidth+1) * ((size_t)fltHeight+1), 0.0);
+        std::vector<double> intFSq((fltWidth+1) * ((size_t)fltHeight+1), 0.0);
+        for(unsigned int y = 0; y < fltHeight; ++y)
+        {
+            double rowSum = 0;
+            double rowSumSq = 0;
+            for(unsigned int x = 0; x < fltWidth; ++x)
+            {
+                rowSum += fltSum[(((size_t)y)*fltWidth)+x];
+                rowSumSq += fltSumSq[(((size_t)y)*fltWidth)+x];
+                intF[(((size_t)y+1)*(fltWidth+1))+x+1] = intF[(((size_t)y)*(fltWidth+1))+x+1] + rowSum;
+                intFSq[(((size_t)y+1)*(fltWidth+1))+x+1] = intFSq[(((size_t)y)*(fltWidth+1))+x+1] + rowSumSq;
+            }
+        }
+
+        double refDenom = (numVals*sumRSq)-(sumR*sumR);
+        for(unsigned int y = 0; y < numYShifts; ++y)
+        {
+            for(unsigned int x = 0; x < numXShifts; ++x)
+            {
+                double sumF = intF[(((size_t)y+refHeight)*(fltWidth+1))+x+refWidth] - intF[(((size_t)y)*(fltWidth+1))+x+refWidth] - intF[(((size_t)y+refHeight)*(fltWidth+1))+x] + intF[(((size_t)y)*(fltWidth+1))+x];
+                double sumFSq = intFSq[(((size_t)y+refHeight)*(fltWidth+1))+x+refWidth] - intFSq[(((size_t)y)*(fltWidth+1))+x+refWidth] - intFSq[(((size_t)y+refHeight)*(fltWidth+1))+x] + intFSq[(((size_t)y)*(fltWidth+1))+x];
+
+                // numVals*sumRF - sumR*sumF == numVals * sum((R - mean(R)) * F)
+                double numerator = numVals * crossSpec[(((size_t)y)*fftWidth)+x].real();
+                float val = numerator/sqrt(refDenom*((numVals*sumFSq)-(sumF*sumF)));
+                if(val < 0)
+                {
+                    val *= -1;
+                }
+                surface[y][x] = val;
+            }
+        }
+    }
+
+    void RSGISFFTCorrelationSimilarityMetric::calcSurfaceMasked(float **reference, unsigned int refWidth, unsigned int refHeight, float **floating, unsigned int fltWidth, unsigned int fltHeight, unsigned int numDims, float **surface)
+    {
+        rsgis::math::RSGISFFTWUtils fftUtils;
+        unsigned int fftWidth = fftUtils.calcFFTSize(fltWidth);
+        unsigned int fftHeight = fftUtils.calcFFTSize(fltHeight);
+        size_t fftSize = ((size_t)fftWidth) * fftHeight;
+        unsigned int numXShifts = fltWidth - refWidth + 1;
+        unsigned int numYShifts = fltHeight - refHeight + 1;
+
+        // With R and F the values (0 where NaN) and MR and MF the valid masks, the sums over
+        // the pairs where both are valid are the cross correlations:
+        // sumRF = R*F, sumR = R*MF, sumRSq = R^2*MF, sumF = MR*F and sumFSq = MR*F^2.
+        std::vector< std::complex<double> > refVals, refValsSq, refMask;
+        std::vector< std::complex<double> > fltVals, fltValsSq, fltMask;
+        std::vector< std::complex<double> > crossRF(fftSize, std::complex<double>(0, 0));
+        std::vector< std::complex<double> > crossR(fftSize, std::complex<double>(0, 0));
+        std::vector< std::complex<double> > crossRSq(fftSize, std::complex<double>(0, 0));
+        std::vector< std::complex<double> > crossF(fftSize, std::complex<double>(0, 0));
+        std::vector< std::complex<double> > crossFSq(fftSize, std::complex<double>(0, 0));
+        for(unsigned int n = 0; n < numDims; ++n)
+        {
+            this->padMaskedBand(reference[n], refWidth, refHeight, 1, fftWidth, fftHeight, &refVals);
+            this->padMaskedBand(reference[n], refWidth, refHeight, 2, fftWidth, fftHeight, &refValsSq);
+            this->padMaskedBand(reference[n], refWidth, refHeight, 0, fftWidth, fftHeight, &refMask);
+            this->padMaskedBand(floating[n], fltWidth, fltHeight, 1, fftWidth, fftHeight, &fltVals);
+            this->padMaskedBand(floating[n], fltWidth, fltHeight, 2, fftWidth, fftHeight, &fltValsSq);
+            this->padMaskedBand(floating[n], fltWidth, fltHeight, 0, fftWidth, fftHeight, &fltMask);
+            fftUtils.fft2D(&refVals, fftWidth, fftHeight, false);
+            fftUtils.fft2D(&refValsSq, fftWidth, fftHeight, false);
+            fftUtils.fft2D(&refMask, fftWidth, fftHeight, false);
+            fftUtils.fft2D(&fltVals, fftWidth, fftHeight, false);
+            fftUtils.fft2D(&fltValsSq, fftWidth, fftHeight, false);
+            fftUtils.fft2D(&fltMask, fftWidth, fftHeight, false);
+            for(size_t i = 0; i < fftSize; ++i)
+            {
+                crossRF[i] += std::conj(refVals[i]) * fltVals[i];
+                crossR[i] += std::conj(refVals[i]) * fltMask[i];
+                crossRSq[i] += std::conj(refValsSq[i]) * fltMask[i];
+                crossF[i] += std::conj(refMask[i]) * fltVals[i];
+                crossFSq[i] += std::conj(refMask[i]) * fltValsSq[i];
+            }
+        }
+        fftUtils.fft2D(&crossRF, fftWidth, fftHeight, true);
+        fftUtils.fft2D(&crossR, fftWidth, fftHeight, true);
+        fftUtils.fft2D(&crossRSq, fftWidth, fftHeight, true);
+        fftUtils.fft2D(&crossF, fftWidth, fftHeight, true);
+        fftUtils.fft2D(&crossFSq, fftWidth, fftHeight, true);
+
+        // As calcValue, n is the number of values in the window including the no data values.
+        double numVals = ((double)numDims) * refWidth * refHeight;
+        for(unsigned int y = 0; y < numYShifts; ++y)
+        {
+            for(unsigned int x = 0; x < numXShifts; ++x)
+            {
+                size_t idx = (((size_t)y)*fftWidth)+x;
+                double sumRF = crossRF[idx].real();
+                double sumR = crossR[idx].real();
+                double sumRSq = crossRSq[idx].real();
+                double sumF = crossF[idx].real();
+                double sumFSq = crossFSq[idx].real();
+                float val = (((numVals * sumRF) - (sumR * sumF))/sqrt(((numVals*sumRSq)-(sumR*sumR))*((numVals*sumFSq)-(sumF*sumF))));
+                if(val < 0)
+                {
+                    val *= -1;
+                }
+                surface[y][x] = val;
+            }
+        }
+    }
+
+    void RSGISFFTCorrelationSimilarityMetric::padMaskedBand(float *data, unsigned int width, unsigned int height, unsigned int power, unsigned int fftWidth, unsigned int fftHeight, std::vector< std::complex<double> > *padded)
+    {
+        padded->assign(((size_t)fftWidth) * fftHeight, std::complex<double>(0, 0));
+        for(unsigned int y = 0; y < height; ++y)
+        {
+            for(unsigned int x = 0; x < width; ++x)
+            {
+                double val = data[(((size_t)y)*width)+x];
+                if(!((boost::math::isnan)(val)))
+                {
+                    if(power == 0)
+                    {
+                        val = 1;
+                    }
+                    else if(power == 2)
+                    {
+                        val = val * val;
+                    }
+                    (*padded)[(((size_t)y)*fftWidth)+x] = std::complex<double>(val, 0);
+                }
+            }
+        }
+    }
+
+    bool RSGISFFTCorrelationSimilarityMetric::hasNaN(float **data, size_t numVals, unsigned int numDims)
+    {
+        for(unsigned int n = 0; n < numDims; ++n)
+        {
+            for(size_t i = 0; i < numVals; ++i)
+            {
+                if((boost::math::isnan)(data[n][i]))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+
+    void RSGISPhaseCorrelationSimilarityMetric::normaliseCrossPower(std::vector< std::complex<double> > *crossPower)
+    {
+        for(size_t i = 0; i < crossPower->size(); ++i)
+        {
+            double mag = std::abs((*crossPower)[i]);
+            if(mag > 1e-12)
+            {
+                (*crossPower)[i] /= mag;
+            }
+            else
+            {
+                (*crossPower)[i] = std::complex<double>(0, 0);
+            }
+        }
+    }
+
+	float RSGISPhaseCorrelationSimilarityMetric::calcValue(float **reference, float **floating, unsigned int numVals, unsigned int numDims)
+	{
+        rsgis::math::RSGISFFTWUtils fftUtils;
+        unsigned int fftLen = fftUtils.calcFFTSize(numVals);
+
+        std::vector< std::complex<double> > refSpec;
+        std::vector< std::complex<double> > fltSpec;
+        std::vector< std::complex<double> > crossSpec(fftLen, std::complex<double>(0, 0));
+        for(unsigned int n = 0; n < numDims; ++n)
+        {
+            this->padBand(reference[n], numVals, 1, this->calcMean(reference[n], numVals), fftLen, 1, &refSpec);
+            this->padBand(floating[n], numVals, 1, this->calcMean(floating[n], numVals), fftLen, 1, &fltSpec);
+            fftUtils.fft1D(&refSpec[0], fftLen, 1, false);
+            fftUtils.fft1D(&fltSpec[0], fftLen, 1, false);
+            for(unsigned int i = 0; i < fftLen; ++i)
+            {
+                crossSpec[i] += std::conj(refSpec[i]) * fltSpec[i];
+            }
+        }
+        this->normaliseCrossPower(&crossSpec);
+
+        // The inverse transform at zero shift is the mean of the normalised cross power spectrum.
+        double sum = 0;
+        for(unsigned int i = 0; i < fftLen; ++i)
+        {
+            sum += crossSpec[i].real();
+        }
+		return sum / fftLen;
+	}
+
+    void RSGISPhaseCorrelationSimilarityMetric::calcSurface(float **reference, unsigned int refWidth, unsigned int refHeight, float **floating, unsigned int fltWidth, unsigned int fltHeight, unsigned int numDims, float **surface)
+    {
+        if((refWidth > fltWidth) | (refHeight > fltHeight))
+        {
+            throw rsgis::math::RSGISMathException("The reference window must not be larger than the floating region.");
+        }
+        rsgis::math::RSGISFFTWUtils fftUtils;
+        unsigned int fftWidth = fftUtils.calcFFTSize(fltWidth);
+        unsigned int fftHeight = fftUtils.calcFFTSize(fltHeight);
+        size_t numRefVals = ((size_t)refWidth) * refHeight;
+        size_t numFltVals = ((size_t)fltWidth) * fltHeight;
+        unsigned int numXShifts = fltWidth - refWidth + 1;
+        unsigned int numYShifts = fltHeight - refHeight + 1;
+
+        std::vector< std::complex<double> > refSpec;
+        std::vector< std::complex<double> > fltSpec;
+        std::vector< std::complex<double> > crossSpec(((size_t)fftWidth) * fftHeight, std::complex<double>(0, 0));
+        for(unsigned int n = 0; n < numDims; ++n)
+        {
+            this->padBand(reference[n], refWidth, refHeight, this->calcMean(reference[n], numRefVals), fftWidth, fftHeight, &refSpec);
+            this->padBand(floating[n], fltWidth, fltHeight, this->calcMean(floating[n], numFltVals), fftWidth, fftHeight, &fltSpec);
+            fftUtils.fft2D(&refSpec, fftWidth, fftHeight, false);
+            fftUtils.fft2D(&fltSpec, fftWidth, fftHeight, false);
+            for(size_t i = 0; i < crossSpec.size(); ++i)
+            {
+                crossSpec[i] += std::conj(refSpec[i]) * fltSpec[i];
+            }
+        }
+        this->normaliseCrossPower(&crossSpec);
+        fftUtils.fft2D(&crossSpec, fftWidth, fftHeight, true);
+
+        for(unsigned int y = 0; y < numYShifts; ++y)
+        {
+            for(unsigned int x = 0; x < numXShifts; ++x)
+            {
+                surface[y][x] = crossSpec[(((size_t)y)*fftWidth)+x].real();
+            }
+        }
+    }
+
+}}
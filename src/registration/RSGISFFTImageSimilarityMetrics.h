@@ -0,0 +1,121 @@
+/*
+ *  RSGISFFTImageSimilarityMetrics.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISFFTImageSimilarityMetrics_H
+#define RSGISFFTImageSimilarityMetrics_H
+
+#include <math.h>
+#include <complex>
+#include <vector>
+
+#include "math/RSGISMathException.h"
+#include "math/RSGISFFTWUtils.h"
+
+#include "registration/RSGISImageSimilarityMetric.h"
+#include "registration/RSGISStandardImageSimilarityMetrics.h"
+
+#include "boost/math/special_functions/fpclassify.hpp"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_registration_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace reg{
+
+    /**
+     * A similarity metric which can be calculated for all the shifts of the
+     * reference window within a floating image region at once (using FFTs)
+     * rather than calling calcValue for each shift. Used by RSGISImageRegistration
+     * for tie points where the whole search region is within the images.
+     */
+	class DllExport RSGISFFTSimilarityMetric : public RSGISImageSimilarityMetric
+	{
+	public:
+        /**
+         * Calculate the metric for each position of the refWidth x refHeight reference window
+         * within the fltWidth x fltHeight floating region. surface[y][x] is the value for the window
+         * starting at column x, row y of the region, for x <= (fltWidth-refWidth) and y <= (fltHeight-refHeight).
+         * Data values are [band][(row*width)+col]; no data (NaN) values are treated as 0 unless
+         * the metric states otherwise.
+         * This function must be safe to call from multiple threads at the same time.
+         */
+		virtual void calcSurface(float **reference, unsigned int refWidth, unsigned int refHeight, float **floating, unsigned int fltWidth, unsigned int fltHeight, unsigned int numDims, float **surface)=0;
+		virtual ~RSGISFFTSimilarityMetric(){};
+    protected:
+        /** Copy a band into a zero padded fftWidth x fftHeight array, less the offset (e.g., the mean). */
+        void padBand(float *data, unsigned int width, unsigned int height, double offset, unsigned int fftWidth, unsigned int fftHeight, std::vector< std::complex<double> > *padded);
+        double calcMean(float *data, size_t numVals);
+	};
+
+    /**
+     * The same metric as RSGISCorrelationSimilarityMetric (absolute correlation coefficient
+     * over all the bands) with the sum of products for every shift calculated by cross
+     * correlation in the frequency domain and the floating window sums from integral images.
+     * As calcValue, pairs of values where either is no data (NaN) are left out of the sums;
+     * if there are NaNs the sums over each shift's joint valid pairs are calculated from the
+     * cross correlations of the values and the valid masks (calcSurfaceMasked).
+     */
+	class DllExport RSGISFFTCorrelationSimilarityMetric : public RSGISFFTSimilarityMetric
+	{
+	public:
+		RSGISFFTCorrelationSimilarityMetric(){};
+		float calcValue(float **reference, float **floating, unsigned int numVals, unsigned int numDims);
+        void calcSurface(float **reference, unsigned int refWidth, unsigned int refHeight, float **floating, unsigned int fltWidth, unsigned int fltHeight, unsigned int numDims, float **surface);
+		bool findMin(){return false;};
+		~RSGISFFTCorrelationSimilarityMetric(){};
+    protected:
+        void calcSurfaceMasked(float **reference, unsigned int refWidth, unsigned int refHeight, float **floating, unsigned int fltWidth, unsigned int fltHeight, unsigned int numDims, float **surface);
+        /** Copy a band into a zero padded array as its valid mask (power 0), values (1) or squared values (2); NaNs are 0. */
+        void padMaskedBand(float *data, unsigned int width, unsigned int height, unsigned int power, unsigned int fftWidth, unsigned int fftHeight, std::vector< std::complex<double> > *padded);
+        bool hasNaN(float **data, size_t numVals, unsigned int numDims);
+        RSGISCorrelationSimilarityMetric correlation;
+	};
+
+    /**
+     * Phase correlation: the inverse transform of the normalised cross power spectrum
+     * (summed over the bands) of the mean subtracted reference window and floating region.
+     * Values are up to 1 at the matching shift. calcValue, for two windows of the same size,
+     * returns the value for no shift calculated over the windows as 1D sequences.
+     */
+	class DllExport RSGISPhaseCorrelationSimilarityMetric : public RSGISFFTSimilarityMetric
+	{
+	public:
+		RSGISPhaseCorrelationSimilarityMetric(){};
+		float calcValue(float **reference, float **floating, unsigned int numVals, unsigned int numDims);
+        void calcSurface(float **reference, unsigned int refWidth, unsigned int refHeight, float **floating, unsigned int fltWidth, unsigned int fltHeight, unsigned int numDims, float **surface);
+		bool findMin(){return false;};
+		~RSGISPhaseCorrelationSimilarityMetric(){};
+    protected:
+        void normaliseCrossPower(std::vector< std::complex<double> > *crossPower);
+	};
+}}
+
+#endif
@@ -124,6 +124,68 @@ namespace rsgis{namespace reg{
 		}
 		
 		rsgis::img::RSGISImageUtils imgUtils;
+		
+		// Calculate the metric for all the shifts at once where the metric and tie point allow.
+		RSGISFFTSimilarityMetric *fftMetric = dynamic_cast<RSGISFFTSimilarityMetric*>(metric);
+		if(fftMetric != NULL)
+		{
+			int refOffsets[2];
+			int fltOffsets[2];
+			float remainderX = 0;
+			float remainderY = 0;
+			if(this->getTiePointSearchRegion(tiePt, windowSize, searchArea, refOffsets, fltOffsets, &remainderX, &remainderY))
+			{
+				unsigned int winSize = (windowSize*2)+1;
+				unsigned int regionSize = winSize + (searchArea*2);
+				unsigned int numRefDataVals = 0;
+				unsigned int numFloatDataVals = 0;
+				float **refDataBlock = NULL;
+				float **floatDataBlock = NULL;
+				// Free whichever of the blocks have been read.
+				auto deleteDataBlocks = [&]()
+				{
+					if(refDataBlock != NULL)
+					{
+						for(unsigned int i = 0; i < overlap->numRefBands; ++i)
+						{
+							delete[] refDataBlock[i];
+						}
+						delete[] refDataBlock;
+						refDataBlock = NULL;
+					}
+					if(floatDataBlock != NULL)
+					{
+						for(unsigned int i = 0; i < overlap->numFloatBands; ++i)
+						{
+							delete[] floatDataBlock[i];
+						}
+						delete[] floatDataBlock;
+						floatDataBlock = NULL;
+					}
+				};
+				try
+				{
+					refDataBlock = imgUtils.getImageDataBlock(referenceIMG, refOffsets, winSize, winSize, &numRefDataVals);
+					floatDataBlock = imgUtils.getImageDataBlock(floatingIMG, fltOffsets, regionSize, regionSize, &numFloatDataVals);
+					
+					distanceMoved = this->findTiePointLocationInRegion(tiePt, refDataBlock, floatDataBlock, windowSize, searchArea, fftMetric, metricThreshold, subPixelResolution, remainderX, remainderY, moveInX, moveInY);
+				}
+				catch (rsgis::img::RSGISImageBandException &e) 
+				{
+					deleteDataBlocks();
+					throw RSGISRegistrationException(e.what());
+				}
+				catch (...)
+				{
+					deleteDataBlocks();
+					throw;
+				}
+				deleteDataBlocks();
+				
+				return distanceMoved;
+			}
+		}
+		
 		try 
 		{
 			// Setup overlapping region variables.
@@ -263,154 +325,451 @@ namespace rsgis{namespace reg{
 				++yIdx;
 			}
 			
-			float subPixelXShift = 0;
-			float subPixelYShift = 0;
-			float subPixelXMetric = currentMetricVal;
-			float subPixelYMetric = currentMetricVal;
+			distanceMoved = this->fitTiePointShift(tiePt, imageSimilarity, searchArea, metric, metricThreshold, subPixelResolution, currentShiftX, currentShiftY, currentXIdx, currentYIdx, currentMetricVal, currentRemainderX, currentRemainderY, moveInX, moveInY);
 			
-			rsgis::math::RSGISPolyFit polyFit;
-									
-			// Find subpixel component
-			if(searchArea == 1)
+			
+			delete[] overlapTransform;
+			delete[] dsOffsets[0];
+			delete[] dsOffsets[1];
+			delete[] dsOffsets;
+		}
+		catch (rsgis::img::RSGISImageBandException &e) 
+		{
+			throw RSGISRegistrationException(e.what());
+		}
+		catch (RSGISRegistrationException &e) 
+		{
+			throw e;
+		}
+		
+		return distanceMoved;
+	}
+    
+	float RSGISImageRegistration::findTiePointLocations(std::list<TiePoint*> *tiePts, unsigned int windowSize, unsigned int searchArea, RSGISFFTSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution)
+	{
+		if(!overlapDefined)
+		{
+			throw RSGISRegistrationException("The overlap needs to be defined before tie location can be defined.");
+		}
+		
+		unsigned int winSize = (windowSize*2)+1;
+		unsigned int regionSize = winSize + (searchArea*2);
+		unsigned int numBands = overlap->numRefBands;
+		double totalDistanceMoved = 0;
+		
+		rsgis::img::RSGISImageUtils imgUtils;
+		rsgis::RSGISThreadPool threadPool(rsgis::RSGISThreadPool::getDefaultNumThreads());
+		
+		struct TiePointRegion
+		{
+			TiePoint *tiePt;
+			int refOffsets[2];
+			int fltOffsets[2];
+			float remainderX;
+			float remainderY;
+		};
+		
+		std::vector<TiePoint*> outsideTiePts;
+		std::vector<TiePointRegion> rowTiePts;
+		std::vector<float> distancesMoved;
+		
+		try
+		{
+			std::list<TiePoint*>::iterator iterTiePts = tiePts->begin();
+			while(iterTiePts != tiePts->end())
 			{
-				// 2nd Order Poly
-				// Find subpixel X
-				if((currentXIdx != 0) & (currentXIdx != (numSearchPoints-1)))
+				// Find the search regions for the tie points on the same row of the reference image.
+				unsigned int rowRef = (*iterTiePts)->yRef;
+				rowTiePts.clear();
+				for(; (iterTiePts != tiePts->end()) && ((*iterTiePts)->yRef == rowRef); ++iterTiePts)
 				{
-					gsl_matrix *inputDataMatrix = gsl_matrix_alloc(3,2);
-					gsl_matrix_set (inputDataMatrix, 0, 0, -1);
-					gsl_matrix_set (inputDataMatrix, 0, 1, imageSimilarity[currentYIdx][currentXIdx-1]);
-					gsl_matrix_set (inputDataMatrix, 1, 0, 0);
-					gsl_matrix_set (inputDataMatrix, 1, 1, imageSimilarity[currentYIdx][currentXIdx]);
-					gsl_matrix_set (inputDataMatrix, 2, 0, 1);
-					gsl_matrix_set (inputDataMatrix, 2, 1, imageSimilarity[currentYIdx][currentXIdx+1]);
-					
-					unsigned int order = 3; // 2nd Order - starts at zero.
-					gsl_vector *coefficients = polyFit.PolyfitOneDimensionQuiet(order, inputDataMatrix);
-					
-					subPixelXShift = findExtreme(metric->findMin(), coefficients, order, -1, 1, subPixelResolution, &subPixelXMetric);
-					
-					gsl_matrix_free(inputDataMatrix);
+					TiePointRegion tiePtRegion;
+					tiePtRegion.tiePt = *iterTiePts;
+					if(this->getTiePointSearchRegion(tiePtRegion.tiePt, windowSize, searchArea, tiePtRegion.refOffsets, tiePtRegion.fltOffsets, &tiePtRegion.remainderX, &tiePtRegion.remainderY))
+					{
+						rowTiePts.push_back(tiePtRegion);
+					}
+					else
+					{
+						outsideTiePts.push_back(tiePtRegion.tiePt);
+					}
 				}
-
-				// Find subpixel Y
-				if((currentYIdx != 0) & (currentYIdx != (numSearchPoints-1)))
+				if(rowTiePts.empty())
 				{
-					gsl_matrix *inputDataMatrix = gsl_matrix_alloc(3,2);
-					gsl_matrix_set (inputDataMatrix, 0, 0, -1);
-					gsl_matrix_set (inputDataMatrix, 0, 1, imageSimilarity[currentYIdx-1][currentXIdx]);
-					gsl_matrix_set (inputDataMatrix, 1, 0, 0);
-					gsl_matrix_set (inputDataMatrix, 1, 1, imageSimilarity[currentYIdx][currentXIdx]);
-					gsl_matrix_set (inputDataMatrix, 2, 0, 1);
-					gsl_matrix_set (inputDataMatrix, 2, 1, imageSimilarity[currentYIdx+1][currentXIdx]);
-					
-					unsigned int order = 3; // 2nd Order - starts at zero.
-					gsl_vector *coefficients = polyFit.PolyfitOneDimensionQuiet(order, inputDataMatrix);
-					
-					subPixelYShift = findExtreme(metric->findMin(), coefficients, order, -1, 1, subPixelResolution, &subPixelYMetric);
-					
-					gsl_matrix_free(inputDataMatrix);
+					continue;
 				}
-			}
-			else
-			{
-				// 4th Order Poly
-				if((currentXIdx > 1) & (currentXIdx < (numSearchPoints-2)))
+				
+				// Read the regions covering all the windows for the row once.
+				int refBlockOffsets[2] = {rowTiePts[0].refOffsets[0], rowTiePts[0].refOffsets[1]};
+				int refBlockEnd[2] = {rowTiePts[0].refOffsets[0], rowTiePts[0].refOffsets[1]};
+				int fltBlockOffsets[2] = {rowTiePts[0].fltOffsets[0], rowTiePts[0].fltOffsets[1]};
+				int fltBlockEnd[2] = {rowTiePts[0].fltOffsets[0], rowTiePts[0].fltOffsets[1]};
+				for(std::vector<TiePointRegion>::iterator iterRegions = rowTiePts.begin(); iterRegions != rowTiePts.end(); ++iterRegions)
 				{
-					gsl_matrix *inputDataMatrix = gsl_matrix_alloc(5,2);
-					gsl_matrix_set (inputDataMatrix, 0, 0, -2);
-					gsl_matrix_set (inputDataMatrix, 0, 1, imageSimilarity[currentYIdx][currentXIdx-2]);
-					gsl_matrix_set (inputDataMatrix, 1, 0, -1);
-					gsl_matrix_set (inputDataMatrix, 1, 1, imageSimilarity[currentYIdx][currentXIdx-1]);
-					gsl_matrix_set (inputDataMatrix, 2, 0, 0);
-					gsl_matrix_set (inputDataMatrix, 2, 1, imageSimilarity[currentYIdx][currentXIdx]);
-					gsl_matrix_set (inputDataMatrix, 3, 0, 1);
-					gsl_matrix_set (inputDataMatrix, 3, 1, imageSimilarity[currentYIdx][currentXIdx+1]);
-					gsl_matrix_set (inputDataMatrix, 4, 0, 2);
-					gsl_matrix_set (inputDataMatrix, 4, 1, imageSimilarity[currentYIdx][currentXIdx+2]);
-					
-					unsigned int order = 4; // 3rd Order - starts at zero.
-					gsl_vector *coefficients = polyFit.PolyfitOneDimensionQuiet(order, inputDataMatrix);
-					
-					subPixelXShift = findExtreme(metric->findMin(), coefficients, order, -1, 1, subPixelResolution, &subPixelXMetric);
-					
-					gsl_matrix_free(inputDataMatrix);
-					gsl_vector_free(coefficients);
+					for(unsigned int i = 0; i < 2; ++i)
+					{
+						refBlockOffsets[i] = std::min(refBlockOffsets[i], (*iterRegions).refOffsets[i]);
+						refBlockEnd[i] = std::max(refBlockEnd[i], (*iterRegions).refOffsets[i]);
+						fltBlockOffsets[i] = std::min(fltBlockOffsets[i], (*iterRegions).fltOffsets[i]);
+						fltBlockEnd[i] = std::max(fltBlockEnd[i], (*iterRegions).fltOffsets[i]);
+					}
 				}
+				unsigned int refBlockWidth = (refBlockEnd[0] - refBlockOffsets[0]) + winSize;
+				unsigned int refBlockHeight = (refBlockEnd[1] - refBlockOffsets[1]) + winSize;
+				unsigned int fltBlockWidth = (fltBlockEnd[0] - fltBlockOffsets[0]) + regionSize;
+				unsigned int fltBlockHeight = (fltBlockEnd[1] - fltBlockOffsets[1]) + regionSize;
 				
-				if((currentYIdx > 1) & (currentYIdx < (numSearchPoints-2)))
+				unsigned int numRefDataVals = 0;
+				unsigned int numFloatDataVals = 0;
+				float **refDataBlock = imgUtils.getImageDataBlock(referenceIMG, refBlockOffsets, refBlockWidth, refBlockHeight, &numRefDataVals);
+				float **floatDataBlock = imgUtils.getImageDataBlock(floatingIMG, fltBlockOffsets, fltBlockWidth, fltBlockHeight, &numFloatDataVals);
+				
+				// Find the tie point locations in parallel from the data in memory.
+				distancesMoved.assign(rowTiePts.size(), 0);
+				for(size_t n = 0; n < rowTiePts.size(); ++n)
 				{
-					gsl_matrix *inputDataMatrix = gsl_matrix_alloc(5,2);
-					gsl_matrix_set (inputDataMatrix, 0, 0, -2);
-					gsl_matrix_set (inputDataMatrix, 0, 1, imageSimilarity[currentYIdx-2][currentXIdx]);
-					gsl_matrix_set (inputDataMatrix, 1, 0, -1);
-					gsl_matrix_set (inputDataMatrix, 1, 1, imageSimilarity[currentYIdx-1][currentXIdx]);
-					gsl_matrix_set (inputDataMatrix, 2, 0, 0);
-					gsl_matrix_set (inputDataMatrix, 2, 1, imageSimilarity[currentYIdx][currentXIdx]);
-					gsl_matrix_set (inputDataMatrix, 3, 0, 1);
-					gsl_matrix_set (inputDataMatrix, 3, 1, imageSimilarity[currentYIdx+1][currentXIdx]);
-					gsl_matrix_set (inputDataMatrix, 4, 0, 2);
-					gsl_matrix_set (inputDataMatrix, 4, 1, imageSimilarity[currentYIdx+2][currentXIdx]);
-					
-					unsigned int order = 4; // 3rd Order - starts at zero.
-					gsl_vector *coefficients = polyFit.PolyfitOneDimensionQuiet(order, inputDataMatrix);
-					
-					subPixelYShift = findExtreme(metric->findMin(), coefficients, order, -1, 1, subPixelResolution, &subPixelYMetric);
-					
-					gsl_matrix_free(inputDataMatrix);
-					gsl_vector_free(coefficients);
+					threadPool.submit([this, n, winSize, regionSize, numBands, windowSize, searchArea, metric, metricThreshold, subPixelResolution, refDataBlock, floatDataBlock, refBlockOffsets, fltBlockOffsets, refBlockWidth, fltBlockWidth, &rowTiePts, &distancesMoved](unsigned int threadIdx)
+					{
+						TiePointRegion *tiePtRegion = &rowTiePts[n];
+						std::vector< std::vector<float> > refWindow(numBands, std::vector<float>(winSize*winSize));
+						std::vector< std::vector<float> > fltRegion(numBands, std::vector<float>(regionSize*regionSize));
+						std::vector<float*> refWindowBands(numBands);
+						std::vector<float*> fltRegionBands(numBands);
+						unsigned int refXOff = tiePtRegion->refOffsets[0] - refBlockOffsets[0];
+						unsigned int refYOff = tiePtRegion->refOffsets[1] - refBlockOffsets[1];
+						unsigned int fltXOff = tiePtRegion->fltOffsets[0] - fltBlockOffsets[0];
+						unsigned int fltYOff = tiePtRegion->fltOffsets[1] - fltBlockOffsets[1];
+						for(unsigned int i = 0; i < numBands; ++i)
+						{
+							for(unsigned int y = 0; y < winSize; ++y)
+							{
+								for(unsigned int x = 0; x < winSize; ++x)
+								{
+									refWindow[i][(y*winSize)+x] = refDataBlock[i][(((size_t)(y+refYOff))*refBlockWidth)+x+refXOff];
+								}
+							}
+							for(unsigned int y = 0; y < regionSize; ++y)
+							{
+								for(unsigned int x = 0; x < regionSize; ++x)
+								{
+									fltRegion[i][(y*regionSize)+x] = floatDataBlock[i][(((size_t)(y+fltYOff))*fltBlockWidth)+x+fltXOff];
+								}
+							}
+							refWindowBands[i] = &refWindow[i][0];
+							fltRegionBands[i] = &fltRegion[i][0];
+						}
+						
+						float moveInX = 0;
+						float moveInY = 0;
+						distancesMoved[n] = this->findTiePointLocationInRegion(tiePtRegion->tiePt, &refWindowBands[0], &fltRegionBands[0], windowSize, searchArea, metric, metricThreshold, subPixelResolution, tiePtRegion->remainderX, tiePtRegion->remainderY, &moveInX, &moveInY);
+					});
+				}
+				
+				try
+				{
+					threadPool.wait();
+				}
+				catch(std::exception &e)
+				{
+					for(unsigned int i = 0; i < numBands; ++i)
+					{
+						delete[] refDataBlock[i];
+						delete[] floatDataBlock[i];
+					}
+					delete[] refDataBlock;
+					delete[] floatDataBlock;
+					throw RSGISRegistrationException(e.what());
+				}
+				
+				for(unsigned int i = 0; i < numBands; ++i)
+				{
+					delete[] refDataBlock[i];
+					delete[] floatDataBlock[i];
 				}
+				delete[] refDataBlock;
+				delete[] floatDataBlock;
 				
+				for(size_t n = 0; n < distancesMoved.size(); ++n)
+				{
+					totalDistanceMoved += distancesMoved[n];
+				}
 			}
+		}
+		catch (rsgis::img::RSGISImageBandException &e) 
+		{
+			throw RSGISRegistrationException(e.what());
+		}
+		
+		// Tie points where the search region is not within the images are found one shift at a time.
+		float moveInX = 0;
+		float moveInY = 0;
+		for(std::vector<TiePoint*>::iterator iterTiePts = outsideTiePts.begin(); iterTiePts != outsideTiePts.end(); ++iterTiePts)
+		{
+			totalDistanceMoved += this->findTiePointLocation(*iterTiePts, windowSize, searchArea, metric, metricThreshold, subPixelResolution, &moveInX, &moveInY);
+		}
+		
+		return totalDistanceMoved;
+	}
+	
+	bool RSGISImageRegistration::getTiePointSearchRegion(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, int *refOffsets, int *fltOffsets, float *remainderX, float *remainderY)
+	{
+		unsigned int winSize = (windowSize*2)+1;
+		unsigned int regionSize = winSize + (searchArea*2);
+		
+		int **dsOffsets = new int*[2];
+		dsOffsets[0] = new int[2];
+		dsOffsets[1] = new int[2];
+		int overlapWidth = 0;
+		int overlapHeight = 0;
+		double *overlapTransform = new double[6];
+		
+		double windowXWidth = (((double)windowSize)*overlap->xRes);
+		double windowYHeight = (((double)windowSize)*overlap->yRes);
+		
+		geos::geom::Envelope env;
+		env.init((tiePt->eastings - windowXWidth), 
+				 (tiePt->eastings + windowXWidth + overlap->xRes), 
+				 (tiePt->northings - windowYHeight),
+				 (tiePt->northings + windowYHeight + overlap->yRes));
+		
+		bool withinImages = true;
+		try
+		{
+			this->getImageOverlapWithFloatShift(tiePt->xShift, tiePt->yShift, dsOffsets, &overlapWidth, &overlapHeight, overlapTransform, &env, remainderX, remainderY);
+		}
+		catch (RSGISRegistrationException &e) 
+		{
+			withinImages = false;
+		}
+		
+		if(withinImages && (overlapWidth == ((int)winSize)) && (overlapHeight == ((int)winSize)))
+		{
+			// A shift of the floating image by +1 pixel moves the floating window by -1 pixel.
+			refOffsets[0] = dsOffsets[0][0];
+			refOffsets[1] = dsOffsets[0][1];
+			fltOffsets[0] = dsOffsets[1][0] - searchArea;
+			fltOffsets[1] = dsOffsets[1][1] - searchArea;
 			
-			currentMetricVal = (subPixelXMetric + subPixelYMetric)/2;
-            
-            // Calculate final shift, adding on offsets due to rounding in image overlap calculation
-            float finalXShift = (((float)currentShiftX) + subPixelXShift) + currentRemainderX;
-			float finalYShift = (((float)currentShiftY) + subPixelYShift) + currentRemainderY;
-            
-			distanceMoved = sqrt(((finalXShift*finalXShift)+(finalYShift*finalYShift))/2);
-			*moveInX = finalXShift;
-			*moveInY = finalYShift;
-            
-			if(metric->findMin() & (currentMetricVal < metricThreshold))
+			if((refOffsets[0] < 0) | (refOffsets[1] < 0) | ((refOffsets[0] + winSize) > ((unsigned int)referenceIMG->GetRasterXSize())) | ((refOffsets[1] + winSize) > ((unsigned int)referenceIMG->GetRasterYSize())))
 			{
-				tiePt->xShift += finalXShift;
-				tiePt->yShift += finalYShift;
-				tiePt->metricVal = currentMetricVal;
+				withinImages = false;
 			}
-			else if(!metric->findMin() & (currentMetricVal > metricThreshold))
+			else if((fltOffsets[0] < 0) | (fltOffsets[1] < 0) | ((fltOffsets[0] + regionSize) > ((unsigned int)floatingIMG->GetRasterXSize())) | ((fltOffsets[1] + regionSize) > ((unsigned int)floatingIMG->GetRasterYSize())))
 			{
-				tiePt->xShift += finalXShift;
-				tiePt->yShift += finalYShift;
-				tiePt->metricVal = currentMetricVal;
+				withinImages = false;
 			}
-			else
+		}
+		else
+		{
+			withinImages = false;
+		}
+		
+		delete[] overlapTransform;
+		delete[] dsOffsets[0];
+		delete[] dsOffsets[1];
+		delete[] dsOffsets;
+		
+		return withinImages;
+	}
+	
+	float RSGISImageRegistration::findTiePointLocationInRegion(TiePoint *tiePt, float **refWindow, float **fltRegion, unsigned int windowSize, unsigned int searchArea, RSGISFFTSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution, float remainderX, float remainderY, float *moveInX, float *moveInY)
+	{
+		unsigned int winSize = (windowSize*2)+1;
+		unsigned int regionSize = winSize + (searchArea*2);
+		unsigned int numSearchPoints = (searchArea*2)+1;
+		
+		float **surface = new float*[numSearchPoints];
+		float **imageSimilarity = new float*[numSearchPoints];
+		for(unsigned int i = 0; i < numSearchPoints; ++i)
+		{
+			surface[i] = new float[numSearchPoints];
+			imageSimilarity[i] = new float[numSearchPoints];
+		}
+		
+		metric->calcSurface(refWindow, winSize, winSize, fltRegion, regionSize, regionSize, overlap->numRefBands, surface);
+		
+		// The surface is indexed by the position of the window within the floating region
+		// which decreases as the shift increases.
+		bool first = true;
+		double currentMetricVal = 0;
+		double metricVal = 0;
+		int currentShiftX = 0;
+		int currentShiftY = 0;
+		unsigned int currentXIdx = 0;
+		unsigned int currentYIdx = 0;
+		for(unsigned int yIdx = 0; yIdx < numSearchPoints; ++yIdx)
+		{
+			for(unsigned int xIdx = 0; xIdx < numSearchPoints; ++xIdx)
+			{
+				metricVal = surface[(numSearchPoints-1)-yIdx][(numSearchPoints-1)-xIdx];
+				imageSimilarity[yIdx][xIdx] = metricVal;
+				
+				if(!((boost::math::isnan)(metricVal)))
+				{
+					if(first | (metric->findMin() & (metricVal < currentMetricVal)) | (!metric->findMin() & (metricVal > currentMetricVal)))
+					{
+						currentMetricVal = metricVal;
+						currentShiftX = ((int)xIdx) - ((int)searchArea);
+						currentShiftY = ((int)yIdx) - ((int)searchArea);
+						currentXIdx = xIdx;
+						currentYIdx = yIdx;
+						first = false;
+					}
+				}
+			}
+		}
+		
+		float distanceMoved = this->fitTiePointShift(tiePt, imageSimilarity, searchArea, metric, metricThreshold, subPixelResolution, currentShiftX, currentShiftY, currentXIdx, currentYIdx, currentMetricVal, remainderX, remainderY, moveInX, moveInY);
+		
+		for(unsigned int i = 0; i < numSearchPoints; ++i)
+		{
+			delete[] surface[i];
+			delete[] imageSimilarity[i];
+		}
+		delete[] surface;
+		delete[] imageSimilarity;
+		
+		return distanceMoved;
+	}
+	
+	float RSGISImageRegistration::fitTiePointShift(TiePoint *tiePt, float **imageSimilarity, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution, int currentShiftX, int currentShiftY, unsigned int currentXIdx, unsigned int currentYIdx, double currentMetricVal, float currentRemainderX, float currentRemainderY, float *moveInX, float *moveInY)
+	{
+		float distanceMoved = 0;
+		unsigned int numSearchPoints = (searchArea*2)+1;
+		
+		float subPixelXShift = 0;
+		float subPixelYShift = 0;
+		float subPixelXMetric = currentMetricVal;
+		float subPixelYMetric = currentMetricVal;
+		
+		rsgis::math::RSGISPolyFit polyFit;
+								
+		// Find subpixel component
+		if(searchArea == 1)
+		{
+			// 2nd Order Poly
+			// Find subpixel X
+			if((currentXIdx != 0) & (currentXIdx != (numSearchPoints-1)))
 			{
-				tiePt->metricVal = std::numeric_limits<double>::signaling_NaN();//NAN;
-				distanceMoved = 0;
-				*moveInX = 0;
-				*moveInY = 0;
+				gsl_matrix *inputDataMatrix = gsl_matrix_alloc(3,2);
+				gsl_matrix_set (inputDataMatrix, 0, 0, -1);
+				gsl_matrix_set (inputDataMatrix, 0, 1, imageSimilarity[currentYIdx][currentXIdx-1]);
+				gsl_matrix_set (inputDataMatrix, 1, 0, 0);
+				gsl_matrix_set (inputDataMatrix, 1, 1, imageSimilarity[currentYIdx][currentXIdx]);
+				gsl_matrix_set (inputDataMatrix, 2, 0, 1);
+				gsl_matrix_set (inputDataMatrix, 2, 1, imageSimilarity[currentYIdx][currentXIdx+1]);
+				
+				unsigned int order = 3; // 2nd Order - starts at zero.
+				gsl_vector *coefficients = polyFit.PolyfitOneDimensionQuiet(order, inputDataMatrix);
+				
+				subPixelXShift = findExtreme(metric->findMin(), coefficients, order, -1, 1, subPixelResolution, &subPixelXMetric);
+				
+				gsl_matrix_free(inputDataMatrix);
+			}
+
+			// Find subpixel Y
+			if((currentYIdx != 0) & (currentYIdx != (numSearchPoints-1)))
+			{
+				gsl_matrix *inputDataMatrix = gsl_matrix_alloc(3,2);
+				gsl_matrix_set (inputDataMatrix, 0, 0, -1);
+				gsl_matrix_set (inputDataMatrix, 0, 1, imageSimilarity[currentYIdx-1][currentXIdx]);
+				gsl_matrix_set (inputDataMatrix, 1, 0, 0);
+				gsl_matrix_set (inputDataMatrix, 1, 1, imageSimilarity[currentYIdx][currentXIdx]);
+				gsl_matrix_set (inputDataMatrix, 2, 0, 1);
+				gsl_matrix_set (inputDataMatrix, 2, 1, imageSimilarity[currentYIdx+1][currentXIdx]);
+				
+				unsigned int order = 3; // 2nd Order - starts at zero.
+				gsl_vector *coefficients = polyFit.PolyfitOneDimensionQuiet(order, inputDataMatrix);
+				
+				subPixelYShift = findExtreme(metric->findMin(), coefficients, order, -1, 1, subPixelResolution, &subPixelYMetric);
+				
+				gsl_matrix_free(inputDataMatrix);
+			}
+		}
+		else
+		{
+			// 4th Order Poly
+			if((currentXIdx > 1) & (currentXIdx < (numSearchPoints-2)))
+			{
+				gsl_matrix *inputDataMatrix = gsl_matrix_alloc(5,2);
+				gsl_matrix_set (inputDataMatrix, 0, 0, -2);
+				gsl_matrix_set (inputDataMatrix, 0, 1, imageSimilarity[currentYIdx][currentXIdx-2]);
+				gsl_matrix_set (inputDataMatrix, 1, 0, -1);
+				gsl_matrix_set (inputDataMatrix, 1, 1, imageSimilarity[currentYIdx][currentXIdx-1]);
+				gsl_matrix_set (inputDataMatrix, 2, 0, 0);
+				gsl_matrix_set (inputDataMatrix, 2, 1, imageSimilarity[currentYIdx][currentXIdx]);
+				gsl_matrix_set (inputDataMatrix, 3, 0, 1);
+				gsl_matrix_set (inputDataMatrix, 3, 1, imageSimilarity[currentYIdx][currentXIdx+1]);
+				gsl_matrix_set (inputDataMatrix, 4, 0, 2);
+				gsl_matrix_set (inputDataMatrix, 4, 1, imageSimilarity[currentYIdx][currentXIdx+2]);
+				
+				unsigned int order = 4; // 3rd Order - starts at zero.
+				gsl_vector *coefficients = polyFit.PolyfitOneDimensionQuiet(order, inputDataMatrix);
+				
+				subPixelXShift = findExtreme(metric->findMin(), coefficients, order, -1, 1, subPixelResolution, &subPixelXMetric);
+				
+				gsl_matrix_free(inputDataMatrix);
+				gsl_vector_free(coefficients);
 			}
 			
+			if((currentYIdx > 1) & (currentYIdx < (numSearchPoints-2)))
+			{
+				gsl_matrix *inputDataMatrix = gsl_matrix_alloc(5,2);
+				gsl_matrix_set (inputDataMatrix, 0, 0, -2);
+				gsl_matrix_set (inputDataMatrix, 0, 1, imageSimilarity[currentYIdx-2][currentXIdx]);
+				gsl_matrix_set (inputDataMatrix, 1, 0, -1);
+				gsl_matrix_set (inputDataMatrix, 1, 1, imageSimilarity[currentYIdx-1][currentXIdx]);
+				gsl_matrix_set (inputDataMatrix, 2, 0, 0);
+				gsl_matrix_set (inputDataMatrix, 2, 1, imageSimilarity[currentYIdx][currentXIdx]);
+				gsl_matrix_set (inputDataMatrix, 3, 0, 1);
+				gsl_matrix_set (inputDataMatrix, 3, 1, imageSimilarity[currentYIdx+1][currentXIdx]);
+				gsl_matrix_set (inputDataMatrix, 4, 0, 2);
+				gsl_matrix_set (inputDataMatrix, 4, 1, imageSimilarity[currentYIdx+2][currentXIdx]);
+				
+				unsigned int order = 4; // 3rd Order - starts at zero.
+				gsl_vector *coefficients = polyFit.PolyfitOneDimensionQuiet(order, inputDataMatrix);
+				
+				subPixelYShift = findExtreme(metric->findMin(), coefficients, order, -1, 1, subPixelResolution, &subPixelYMetric);
+				
+				gsl_matrix_free(inputDataMatrix);
+				gsl_vector_free(coefficients);
+			}
 			
-			delete[] overlapTransform;
-			delete[] dsOffsets[0];
-			delete[] dsOffsets[1];
-			delete[] dsOffsets;
 		}
-		catch (rsgis::img::RSGISImageBandException &e) 
+		
+		currentMetricVal = (subPixelXMetric + subPixelYMetric)/2;
+            
+            // Calculate final shift, adding on offsets due to rounding in image overlap calculation
+            float finalXShift = (((float)currentShiftX) + subPixelXShift) + currentRemainderX;
+		float finalYShift = (((float)currentShiftY) + subPixelYShift) + currentRemainderY;
+            
+		distanceMoved = sqrt(((finalXShift*finalXShift)+(finalYShift*finalYShift))/2);
+		*moveInX = finalXShift;
+		*moveInY = finalYShift;
+            
+		if(metric->findMin() & (currentMetricVal < metricThreshold))
 		{
-			throw RSGISRegistrationException(e.what());
+			tiePt->xShift += finalXShift;
+			tiePt->yShift += finalYShift;
+			tiePt->metricVal = currentMetricVal;
 		}
-		catch (RSGISRegistrationException &e) 
+		else if(!metric->findMin() & (currentMetricVal > metricThreshold))
 		{
-			throw e;
+			tiePt->xShift += finalXShift;
+			tiePt->yShift += finalYShift;
+			tiePt->metricVal = currentMetricVal;
+		}
+		else
+		{
+			tiePt->metricVal = std::numeric_limits<double>::signaling_NaN();//NAN;
+			distanceMoved = 0;
+			*moveInX = 0;
+			*moveInY = 0;
 		}
 		
 		return distanceMoved;
 	}
-    
+	
     float RSGISImageRegistration::findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, unsigned int subPixelResolution, float *moveInX, float *moveInY)
 	{
 		float distanceMoved = 0;
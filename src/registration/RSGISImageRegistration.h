@@ -30,6 +30,8 @@
 #include <string>
 #include <math.h>
 #include <list>
+#include <vector>
+#include <algorithm>
 
 #include "gdal_priv.h"
 #include "ogrsf_frmts.h"
@@ -37,6 +39,9 @@
 #include "common/RSGISRegistrationException.h"
 
 #include "registration/RSGISImageSimilarityMetric.h"
+#include "registration/RSGISFFTImageSimilarityMetrics.h"
+
+#include "common/RSGISThreadPool.h"
 
 #include "img/RSGISImageBandException.h"
 #include "img/RSGISImageUtils.h"
@@ -151,6 +156,17 @@ namespace rsgis{namespace reg{
 		void defineFirstTiePoint(unsigned int *startXOff, unsigned int *startYOff, unsigned int numXPts, unsigned int numYPts, unsigned int gap);
 		float findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution, float *moveInX, float *moveInY);
         float findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, unsigned int subPixelResolution, float *moveInX, float *moveInY);
+        /**
+         * Find the location of each tie point (as findTiePointLocation) where the metric is calculated for
+         * all the shifts at once. The image data for each row of tie points is read once and the tie points
+         * on the row processed concurrently. Returns the sum of the distances moved.
+         */
+        float findTiePointLocations(std::list<TiePoint*> *tiePts, unsigned int windowSize, unsigned int searchArea, RSGISFFTSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution);
+        /** Get the offsets of the reference window and floating search region; false if they are not within the images. */
+        bool getTiePointSearchRegion(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, int *refOffsets, int *fltOffsets, float *remainderX, float *remainderY);
+        float findTiePointLocationInRegion(TiePoint *tiePt, float **refWindow, float **fltRegion, unsigned int windowSize, unsigned int searchArea, RSGISFFTSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution, float remainderX, float remainderY, float *moveInX, float *moveInY);
+        /** Fit the sub-pixel shift around the best shift within imageSimilarity and update the tie point if the metric passes the threshold. */
+        float fitTiePointShift(TiePoint *tiePt, float **imageSimilarity, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution, int currentShiftX, int currentShiftY, unsigned int currentXIdx, unsigned int currentYIdx, double currentMetricVal, float currentRemainderX, float currentRemainderY, float *moveInX, float *moveInY);
 		float findExtreme(bool findMin, gsl_vector *coefficients, unsigned int order, float minRange, float maxRange, unsigned int resolution, float *extremeVal);
         void getImageOverlapFloat(GDALDataset **datasets, int numDS,  float **dsOffsets, int *width, int *height, double *gdalTransform);
 		void getImageOverlapWithFloatShift(float xShift, float yShift, int **dsOffsets, int *width, int *height, double *gdalTransform, geos::geom::Envelope *env, float *remainderX, float *remainderY);
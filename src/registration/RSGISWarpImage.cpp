@@ -348,24 +348,24 @@ namespace rsgis{namespace reg{
 			delete[] outDataColumn;
 			
 			GDALClose(inputImageDS);
-			GDALClose(outputImageDS);
+			rsgis::img::RSGISImageBlockCache::closeDataset(outputImageDS);
 		}
 		catch (RSGISImageWarpException &e) 
 		{
 			GDALClose(inputImageDS);
-			GDALClose(outputImageDS);
+			rsgis::img::RSGISImageBlockCache::closeDataset(outputImageDS);
 			throw e;
 		}
 		catch (rsgis::img::RSGISImageBandException &e) 
 		{
 			GDALClose(inputImageDS);
-			GDALClose(outputImageDS);
+			rsgis::img::RSGISImageBlockCache::closeDataset(outputImageDS);
 			throw RSGISImageWarpException(e.what());
 		}
 		catch (RSGISImageException &e) 
 		{
 			GDALClose(inputImageDS);
-			GDALClose(outputImageDS);
+			rsgis::img::RSGISImageBlockCache::closeDataset(outputImageDS);
 			throw RSGISImageWarpException(e.what());
 		} 
 	}
@@ -519,24 +519,24 @@ namespace rsgis{namespace reg{
 			delete[] outDataColumn;
 			
 			GDALClose(inputImageDS);
-			GDALClose(outputImageDS);
+			rsgis::img::RSGISImageBlockCache::closeDataset(outputImageDS);
 		}
 		catch (RSGISImageWarpException &e) 
 		{
 			GDALClose(inputImageDS);
-			GDALClose(outputImageDS);
+			rsgis::img::RSGISImageBlockCache::closeDataset(outputImageDS);
 			throw e;
 		}
 		catch (rsgis::img::RSGISImageBandException &e) 
 		{
 			GDALClose(inputImageDS);
-			GDALClose(outputImageDS);
+			rsgis::img::RSGISImageBlockCache::closeDataset(outputImageDS);
 			throw RSGISImageWarpException(e.what());
 		}
 		catch (RSGISImageException &e) 
 		{
 			GDALClose(inputImageDS);
-			GDALClose(outputImageDS);
+			rsgis::img::RSGISImageBlockCache::closeDataset(outputImageDS);
 			throw RSGISImageWarpException(e.what());
 		} 
 	}
@@ -44,6 +44,7 @@
 #include "math/RSGISMathsUtils.h"
 
 #include "img/RSGISImageUtils.h"
+#include "img/RSGISImageBlockCache.h"
 #include "img/RSGISImageBandException.h"
 
 #include "registration/RSGISImageWarpException.h"
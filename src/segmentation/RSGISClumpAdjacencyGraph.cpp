@@ -0,0 +1,335 @@
+/*
+ *  RSGISClumpAdjacencyGraph.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISClumpAdjacencyGraph.h"
+
+namespace rsgis{namespace segment{
+
+    RSGISClumpAdjacencyGraph::RSGISClumpAdjacencyGraph()
+    {
+        this->numClumps = 0;
+        this->numBands = 0;
+    }
+
+    void RSGISClumpAdjacencyGraph::buildGraph(GDALDataset *clumps, GDALDataset *spectral)
+    {
+        if(spectral->GetRasterXSize() != clumps->GetRasterXSize())
+        {
+            throw rsgis::img::RSGISImageCalcException("Widths are not the same");
+        }
+        if(spectral->GetRasterYSize() != clumps->GetRasterYSize())
+        {
+            throw rsgis::img::RSGISImageCalcException("Heights are not the same");
+        }
+
+        unsigned int width = clumps->GetRasterXSize();
+        unsigned int height = clumps->GetRasterYSize();
+        this->numBands = spectral->GetRasterCount();
+
+        GDALRasterBand *clumpBand = clumps->GetRasterBand(1);
+        GDALRasterBand **spectralBands = new GDALRasterBand*[this->numBands];
+        for(unsigned int n = 0; n < this->numBands; ++n)
+        {
+            spectralBands[n] = spectral->GetRasterBand(n+1);
+        }
+
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        clumpBand->GetBlockSize(&xBlockSize, &yBlockSize);
+        unsigned int numRows = (yBlockSize > 0)?yBlockSize:1;
+
+        std::vector<unsigned int> clumpIdxs(((size_t)width) * numRows);
+        std::vector<unsigned int> prevRow(width, 0);
+        std::vector<float> spectralVals(((size_t)width) * numRows * this->numBands);
+
+        this->numClumps = 0;
+        this->numPxls.assign(1, 0);
+        this->sums.assign(this->numBands, 0.0);
+
+        // Each pair of neighbouring clumps is stored as (low ID << 32 | high ID). Pairs
+        // are repeated along the boundaries so they are compacted as they are added.
+        std::vector<boost::uint64_t> edgePairs;
+        size_t compactSize = 1 << 20;
+        boost::uint64_t lastHorPair = 0;
+        boost::uint64_t lastVertPair = 0;
+
+        std::cout << "Building clump adjacency graph\n";
+        for(unsigned int row = 0; row < height; row += numRows)
+        {
+            unsigned int blockRows = std::min(numRows, height - row);
+            if(clumpBand->RasterIO(GF_Read, 0, row, width, blockRows, clumpIdxs.data(), width, blockRows, GDT_UInt32, 0, 0) != CE_None)
+            {
+                delete[] spectralBands;
+                throw rsgis::img::RSGISImageCalcException("Could not read the clumps image.");
+            }
+            for(unsigned int n = 0; n < this->numBands; ++n)
+            {
+                if(spectralBands[n]->RasterIO(GF_Read, 0, row, width, blockRows, &spectralVals[((size_t)width) * blockRows * n], width, blockRows, GDT_Float32, 0, 0) != CE_None)
+                {
+                    delete[] spectralBands;
+                    throw rsgis::img::RSGISImageCalcException("Could not read the spectral image.");
+                }
+            }
+
+            for(unsigned int i = 0; i < blockRows; ++i)
+            {
+                const unsigned int *cRow = &clumpIdxs[((size_t)width) * i];
+                const unsigned int *aboveRow = (i == 0)?prevRow.data():&clumpIdxs[((size_t)width) * (i-1)];
+                bool hasAbove = (row + i) > 0;
+                for(unsigned int j = 0; j < width; ++j)
+                {
+                    unsigned int clumpID = cRow[j];
+                    if(clumpID == 0)
+                    {
+                        continue;
+                    }
+                    if(clumpID > this->numClumps)
+                    {
+                        size_t newSize = std::max(((size_t)clumpID) + 1, this->numPxls.size() * 2);
+                        this->numPxls.resize(newSize, 0);
+                        this->sums.resize(newSize * this->numBands, 0.0);
+                        this->numClumps = clumpID;
+                    }
+                    ++this->numPxls[clumpID];
+                    double *clumpSums = &this->sums[((size_t)clumpID) * this->numBands];
+                    for(unsigned int n = 0; n < this->numBands; ++n)
+                    {
+                        clumpSums[n] += spectralVals[(((size_t)width) * blockRows * n) + (((size_t)width) * i) + j];
+                    }
+
+                    if(((j + 1) < width) && (cRow[j+1] != 0) && (cRow[j+1] != clumpID))
+                    {
+                        boost::uint64_t pair = (std::min(clumpID, cRow[j+1]) * ((boost::uint64_t)1 << 32)) + std::max(clumpID, cRow[j+1]);
+                        if(pair != lastHorPair)
+                        {
+                            edgePairs.push_back(pair);
+                            lastHorPair = pair;
+                        }
+                    }
+                    if(hasAbove && (aboveRow[j] != 0) && (aboveRow[j] != clumpID))
+                    {
+                        boost::uint64_t pair = (std::min(clumpID, aboveRow[j]) * ((boost::uint64_t)1 << 32)) + std::max(clumpID, aboveRow[j]);
+                        if(pair != lastVertPair)
+                        {
+                            edgePairs.push_back(pair);
+                            lastVertPair = pair;
+                        }
+                    }
+                }
+            }
+            std::copy(clumpIdxs.begin() + (((size_t)width) * (blockRows - 1)), clumpIdxs.begin() + (((size_t)width) * blockRows), prevRow.begin());
+
+            if(edgePairs.size() >= compactSize)
+            {
+                this->compactEdgePairs(&edgePairs);
+                compactSize = std::max(compactSize, edgePairs.size() * 2);
+            }
+        }
+        delete[] spectralBands;
+        this->compactEdgePairs(&edgePairs);
+        this->numPxls.resize(this->numClumps + 1);
+        this->sums.resize((this->numClumps + 1) * this->numBands);
+
+        // Build the compressed rows with each pair in both directions.
+        this->edgeOffsets.assign(this->numClumps + 2, 0);
+        for(std::vector<boost::uint64_t>::iterator iterPair = edgePairs.begin(); iterPair != edgePairs.end(); ++iterPair)
+        {
+            ++this->edgeOffsets[((*iterPair) >> 32) + 1];
+            ++this->edgeOffsets[((*iterPair) & 0xFFFFFFFF) + 1];
+        }
+        for(size_t i = 1; i < this->edgeOffsets.size(); ++i)
+        {
+            this->edgeOffsets[i] += this->edgeOffsets[i-1];
+        }
+        this->edges.resize(edgePairs.size() * 2);
+        std::vector<size_t> fillPos(this->edgeOffsets.begin(), this->edgeOffsets.end() - 1);
+        for(std::vector<boost::uint64_t>::iterator iterPair = edgePairs.begin(); iterPair != edgePairs.end(); ++iterPair)
+        {
+            unsigned int lowID = (unsigned int)((*iterPair) >> 32);
+            unsigned int highID = (unsigned int)((*iterPair) & 0xFFFFFFFF);
+            this->edges[fillPos[lowID]++] = highID;
+            this->edges[fillPos[highID]++] = lowID;
+        }
+        std::vector<boost::uint64_t>().swap(edgePairs);
+
+        this->parent.resize(this->numClumps + 1);
+        this->nextMember.assign(this->numClumps + 1, 0);
+        this->lastMember.resize(this->numClumps + 1);
+        for(size_t i = 0; i <= this->numClumps; ++i)
+        {
+            this->parent[i] = i;
+            this->lastMember[i] = i;
+        }
+        std::cout << "There are " << this->numClumps << " clumps with " << (this->edges.size() / 2) << " boundaries.\n";
+    }
+
+    void RSGISClumpAdjacencyGraph::getNeighbours(size_t clumpID, std::vector<size_t> *neighbours)
+    {
+        neighbours->clear();
+        for(size_t member = clumpID; member != 0; member = this->nextMember[member])
+        {
+            for(size_t e = this->edgeOffsets[member]; e < this->edgeOffsets[member+1]; ++e)
+            {
+                size_t neighbour = this->findClump(this->edges[e]);
+                if(neighbour != clumpID)
+                {
+                    neighbours->push_back(neighbour);
+                }
+            }
+        }
+        std::sort(neighbours->begin(), neighbours->end());
+        neighbours->erase(std::unique(neighbours->begin(), neighbours->end()), neighbours->end());
+    }
+
+    void RSGISClumpAdjacencyGraph::mergeClumps(size_t clumpID, size_t intoClumpID)
+    {
+        size_t fromClump = this->findClump(clumpID);
+        size_t toClump = this->findClump(intoClumpID);
+        if(fromClump == toClump)
+        {
+            return;
+        }
+        this->parent[fromClump] = toClump;
+        this->numPxls[toClump] += this->numPxls[fromClump];
+        for(unsigned int n = 0; n < this->numBands; ++n)
+        {
+            this->sums[(toClump*this->numBands)+n] += this->sums[(fromClump*this->numBands)+n];
+        }
+        this->nextMember[this->lastMember[toClump]] = fromClump;
+        this->lastMember[toClump] = this->lastMember[fromClump];
+    }
+
+    void RSGISClumpAdjacencyGraph::relabelClumps(GDALDataset *clumps)
+    {
+        std::vector<unsigned int> clumpLUT(this->numClumps + 1, 0);
+        for(size_t i = 1; i <= this->numClumps; ++i)
+        {
+            clumpLUT[i] = (unsigned int)this->findClump(i);
+        }
+
+        unsigned int width = clumps->GetRasterXSize();
+        unsigned int height = clumps->GetRasterYSize();
+        GDALRasterBand *clumpBand = clumps->GetRasterBand(1);
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        clumpBand->GetBlockSize(&xBlockSize, &yBlockSize);
+        unsigned int numRows = (yBlockSize > 0)?yBlockSize:1;
+        std::vector<unsigned int> clumpIdxs(((size_t)width) * numRows);
+
+        std::cout << "Relabelling clumps\n";
+        for(unsigned int row = 0; row < height; row += numRows)
+        {
+            unsigned int blockRows = std::min(numRows, height - row);
+            if(clumpBand->RasterIO(GF_Read, 0, row, width, blockRows, clumpIdxs.data(), width, blockRows, GDT_UInt32, 0, 0) != CE_None)
+            {
+                throw rsgis::img::RSGISImageCalcException("Could not read the clumps image.");
+            }
+            size_t numVals = ((size_t)width) * blockRows;
+            for(size_t i = 0; i < numVals; ++i)
+            {
+                if(clumpIdxs[i] <= this->numClumps)
+                {
+                    clumpIdxs[i] = clumpLUT[clumpIdxs[i]];
+                }
+            }
+            if(clumpBand->RasterIO(GF_Write, 0, row, width, blockRows, clumpIdxs.data(), width, blockRows, GDT_UInt32, 0, 0) != CE_None)
+            {
+                throw rsgis::img::RSGISImageCalcException("Could not write to the clumps image.");
+            }
+        }
+    }
+
+    size_t RSGISClumpAdjacencyGraph::relabelClumpsSequential(GDALDataset *clumps, GDALDataset *outClumps)
+    {
+        if(clumps->GetRasterXSize() != outClumps->GetRasterXSize())
+        {
+            throw rsgis::img::RSGISImageCalcException("Widths are not the same");
+        }
+        if(clumps->GetRasterYSize() != outClumps->GetRasterYSize())
+        {
+            throw rsgis::img::RSGISImageCalcException("Heights are not the same");
+        }
+
+        // Output IDs are given to the active clumps as they are found.
+        std::vector<unsigned int> clumpLUT(this->numClumps + 1, 0);
+        std::vector<unsigned int> outIDs(this->numClumps + 1, 0);
+        for(size_t i = 1; i <= this->numClumps; ++i)
+        {
+            clumpLUT[i] = (unsigned int)this->findClump(i);
+        }
+        size_t nextID = 1;
+
+        unsigned int width = clumps->GetRasterXSize();
+        unsigned int height = clumps->GetRasterYSize();
+        GDALRasterBand *clumpBand = clumps->GetRasterBand(1);
+        GDALRasterBand *outClumpBand = outClumps->GetRasterBand(1);
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        clumpBand->GetBlockSize(&xBlockSize, &yBlockSize);
+        unsigned int numRows = (yBlockSize > 0)?yBlockSize:1;
+        std::vector<unsigned int> clumpIdxs(((size_t)width) * numRows);
+
+        std::cout << "Relabelling clumps\n";
+        for(unsigned int row = 0; row < height; row += numRows)
+        {
+            unsigned int blockRows = std::min(numRows, height - row);
+            if(clumpBand->RasterIO(GF_Read, 0, row, width, blockRows, clumpIdxs.data(), width, blockRows, GDT_UInt32, 0, 0) != CE_None)
+            {
+                throw rsgis::img::RSGISImageCalcException("Could not read the clumps image.");
+            }
+            size_t numVals = ((size_t)width) * blockRows;
+            for(size_t i = 0; i < numVals; ++i)
+            {
+                if((clumpIdxs[i] > 0) && (clumpIdxs[i] <= this->numClumps))
+                {
+                    unsigned int rootID = clumpLUT[clumpIdxs[i]];
+                    if(outIDs[rootID] == 0)
+                    {
+                        outIDs[rootID] = (unsigned int)nextID++;
+                    }
+                    clumpIdxs[i] = outIDs[rootID];
+                }
+                else
+                {
+                    clumpIdxs[i] = 0;
+                }
+            }
+            if(outClumpBand->RasterIO(GF_Write, 0, row, width, blockRows, clumpIdxs.data(), width, blockRows, GDT_UInt32, 0, 0) != CE_None)
+            {
+                throw rsgis::img::RSGISImageCalcException("Could not write to the clumps image.");
+            }
+        }
+        return nextID - 1;
+    }
+
+    void RSGISClumpAdjacencyGraph::compactEdgePairs(std::vector<boost::uint64_t> *edgePairs)
+    {
+        std::sort(edgePairs->begin(), edgePairs->end());
+        edgePairs->erase(std::unique(edgePairs->begin(), edgePairs->end()), edgePairs->end());
+    }
+
+    RSGISClumpAdjacencyGraph::~RSGISClumpAdjacencyGraph()
+    {
+
+    }
+
+}}
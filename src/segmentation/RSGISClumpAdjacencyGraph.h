@@ -0,0 +1,116 @@
+/*
+ *  RSGISClumpAdjacencyGraph.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISClumpAdjacencyGraph_h
+#define RSGISClumpAdjacencyGraph_h
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+
+#include "gdal_priv.h"
+
+#include "img/RSGISImageCalcException.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_segmentation_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace segment{
+
+    /**
+     * A region adjacency graph of a clumps image, built in a single pass over the
+     * clumps and spectral images. For each clump the number of pixels and the sum
+     * of each spectral band are stored, along with the clumps it shares an edge
+     * with (4-connectivity, held as compressed rows). Clumps are then merged
+     * without accessing the image: merged clumps are held as sets (union-find)
+     * labelled with the ID of the clump they were merged into, and the final
+     * labels are written back to the clumps image in one pass.
+     *
+     * The memory used depends on the number of clumps and their boundaries,
+     * not on the number of pixels.
+     */
+    class DllExport RSGISClumpAdjacencyGraph
+    {
+    public:
+        RSGISClumpAdjacencyGraph();
+        /** Build the graph from band 1 of clumps (0 is no data) and all bands of spectral. */
+        void buildGraph(GDALDataset *clumps, GDALDataset *spectral);
+        /** The maximum clump ID; clumps are numbered 1 to getNumClumps(). */
+        size_t getNumClumps() const {return this->numClumps;};
+        unsigned int getNumBands() const {return this->numBands;};
+        /** The ID of the clump which clumpID has been merged into (itself if it has not been merged). */
+        inline size_t findClump(size_t clumpID)
+        {
+            while(this->parent[clumpID] != clumpID)
+            {
+                this->parent[clumpID] = this->parent[this->parent[clumpID]];
+                clumpID = this->parent[clumpID];
+            }
+            return clumpID;
+        };
+        bool isActive(size_t clumpID) const {return this->parent[clumpID] == clumpID;};
+        /** The number of pixels within an active clump (including the clumps merged into it). */
+        size_t getNumPxls(size_t clumpID) const {return this->numPxls[clumpID];};
+        /** The mean of the band for an active clump. */
+        double getMean(size_t clumpID, unsigned int band) const {return this->sums[(clumpID*this->numBands)+band] / this->numPxls[clumpID];};
+        /** Get the (sorted) active clumps which neighbour an active clump. */
+        void getNeighbours(size_t clumpID, std::vector<size_t> *neighbours);
+        /** Merge the active clump clumpID into the clump containing intoClumpID. */
+        void mergeClumps(size_t clumpID, size_t intoClumpID);
+        /** Write the ID of the active clump each pixel belongs to back to band 1 of clumps. */
+        void relabelClumps(GDALDataset *clumps);
+        /**
+         * Write the clumps to band 1 of outClumps numbered from 1 in the order they are
+         * first found (row by row) within the clumps image, as RSGISRelabelClumps does.
+         * Returns the number of clumps.
+         */
+        size_t relabelClumpsSequential(GDALDataset *clumps, GDALDataset *outClumps);
+        ~RSGISClumpAdjacencyGraph();
+    protected:
+        void compactEdgePairs(std::vector<boost::uint64_t> *edgePairs);
+        size_t numClumps;
+        unsigned int numBands;
+        std::vector<size_t> edgeOffsets;
+        std::vector<unsigned int> edges;
+        std::vector<size_t> parent;
+        std::vector<size_t> nextMember;
+        std::vector<size_t> lastMember;
+        std::vector<size_t> numPxls;
+        std::vector<double> sums;
+    };
+
+}}
+
+#endif
@@ -31,6 +31,17 @@ namespace rsgis{namespace segment{
     }
         
     void RSGISClumpPxls::performClump(GDALDataset *catagories, GDALDataset *clumps, bool noDataValProvided, unsigned int noDataVal, std::vector<unsigned int> *clumpPxlVals) 
+    {
+        this->labelClumps(catagories, clumps, noDataValProvided, noDataVal, clumpPxlVals);
+    }
+    
+    void RSGISClumpPxls::performClumpPosVals(GDALDataset *catagories, GDALDataset *clumps) 
+    {
+        // Only pixels with a value greater than zero are clumped.
+        this->labelClumps(catagories, clumps, true, 0, NULL);
+    }
+    
+    void RSGISClumpPxls::labelClumps(GDALDataset *catagories, GDALDataset *clumps, bool noDataValProvided, unsigned int noDataVal, std::vector<unsigned int> *clumpPxlVals)
     {
         if(catagories->GetRasterXSize() != clumps->GetRasterXSize())
         {
@@ -41,138 +52,154 @@ namespace rsgis{namespace segment{
             throw rsgis::img::RSGISImageCalcException("Heights are not the same");
         }
         
-        rsgis::img::RSGISImageUtils imgUtils;
-        imgUtils.zerosUIntGDALDataset(clumps);
+        this->width = catagories->GetRasterXSize();
+        this->height = catagories->GetRasterYSize();
+        this->catagoryBand = catagories->GetRasterBand(1);
+        this->clumpBand = clumps->GetRasterBand(1);
         
-        unsigned int width = catagories->GetRasterXSize();
-        unsigned int height = catagories->GetRasterYSize();
+        // Read and write whole image blocks of rows, with at least 64 rows at a time for scanline images.
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        this->catagoryBand->GetBlockSize(&xBlockSize, &yBlockSize);
+        if(yBlockSize < 1)
+        {
+            yBlockSize = 1;
+        }
+        this->ioRows = yBlockSize * std::max(1, 64/yBlockSize);
+        unsigned int numIOBlocks = (this->height + this->ioRows - 1) / this->ioRows;
         
-        GDALRasterBand *catagoryBand = catagories->GetRasterBand(1);
-        GDALRasterBand *clumpBand = clumps->GetRasterBand(1);
+        unsigned int numThreads = rsgis::RSGISThreadPool::getDefaultNumThreads();
+        unsigned int numStrips = std::max(1u, std::min(numThreads, numIOBlocks));
+        unsigned int stripRows = ((numIOBlocks + numStrips - 1) / numStrips) * this->ioRows;
         
-        unsigned long clumpIdx = 1;
-        std::vector<rsgis::img::PxlLoc> clumpPxls;
-        std::queue<rsgis::img::PxlLoc> clumpSearchPxls;
-        unsigned int catPxlVal = 0;
-        unsigned int catCPxlVal = 0;
+        std::vector<RSGISClumpStrip> strips;
+        for(unsigned int rowStart = 0; rowStart < this->height; rowStart += stripRows)
+        {
+            RSGISClumpStrip strip;
+            strip.rowStart = rowStart;
+            strip.rowEnd = std::min(rowStart + stripRows, this->height);
+            strips.push_back(strip);
+        }
+        numStrips = strips.size();
         
-        unsigned int uiPxlVal = 0;
+        // Pass 1: label each strip with provisional labels, recording the equivalences.
+        std::cout << "Labelling pixels\n";
+        this->rowsProcessed = 0;
+        this->pbar.reset();
+        if(numStrips == 1)
+        {
+            this->labelClumpStrip(&strips[0], noDataValProvided, noDataVal);
+        }
+        else
+        {
+            rsgis::RSGISThreadPool threadPool(numStrips);
+            for(unsigned int k = 0; k < numStrips; ++k)
+            {
+                RSGISClumpStrip *strip = &strips[k];
+                threadPool.submit([this, strip, noDataValProvided, noDataVal](unsigned int threadIdx)
+                {
+                    this->labelClumpStrip(strip, noDataValProvided, noDataVal);
+                });
+            }
+            threadPool.wait();
+        }
+        this->pbar.finish();
         
-        rsgis_tqdm pbar;
-        for(unsigned int i = 0; i < height; ++i)
+        // Combine the strip tables into one where strip k's labels are offset by the
+        // number of labels in the strips above so labels still increase in scan order.
+        std::vector<unsigned long> stripOffsets(numStrips, 0);
+        unsigned long numLabels = 0;
+        for(unsigned int k = 0; k < numStrips; ++k)
         {
-            pbar.progress(i, height);
-            
-            for(unsigned int j = 0; j < width; ++j)
+            stripOffsets[k] = numLabels;
+            numLabels += strips[k].parents.size() - 1;
+        }
+        if(numLabels >= std::numeric_limits<unsigned int>::max())
+        {
+            throw rsgis::img::RSGISImageCalcException("The number of clump labels exceeds the maximum of an unsigned 32 bit integer.");
+        }
+        
+        std::vector<unsigned int> parents(numLabels+1, 0);
+        std::vector<unsigned int> labelCatVals(numLabels+1, 0);
+        for(unsigned int k = 0; k < numStrips; ++k)
+        {
+            unsigned int offset = stripOffsets[k];
+            for(size_t l = 1; l < strips[k].parents.size(); ++l)
             {
-                // Get pixel value from clump image for (j,i)
-                clumpBand->RasterIO(GF_Read, j, i, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                
-                // if value is zero create new clump
-                if(uiPxlVal == 0) 
+                parents[offset+l] = offset + strips[k].parents[l];
+                labelCatVals[offset+l] = strips[k].labelCatVals[l];
+            }
+            std::vector<unsigned int>().swap(strips[k].parents);
+            std::vector<unsigned int>().swap(strips[k].labelCatVals);
+        }
+        
+        // Merge clumps which cross the borders between strips.
+        for(unsigned int k = 1; k < numStrips; ++k)
+        {
+            unsigned int *aboveLabels = strips[k-1].lastRowLabels.data();
+            unsigned int *belowLabels = strips[k].firstRowLabels.data();
+            for(unsigned int x = 0; x < this->width; ++x)
+            {
+                if((aboveLabels[x] != 0) && (belowLabels[x] != 0))
                 {
-                    catagoryBand->RasterIO(GF_Read, j, i, 1, 1, &catPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                    if((!noDataValProvided) | (noDataValProvided & (catPxlVal != noDataVal)))
-                    {     
-                        // Make sure all lists are empty.
-                        clumpPxls.clear();
-                        if(!clumpSearchPxls.empty())
-                        {
-                            while(clumpSearchPxls.size() > 0)
-                            {
-                                clumpSearchPxls.pop();
-                            }
-                        }
-                        
-                        if(clumpPxlVals != NULL)
-                        {
-                            clumpPxlVals->push_back(catPxlVal);
-                        }
-                            
-                        clumpPxls.push_back(rsgis::img::PxlLoc(j, i));
-                        clumpSearchPxls.push(rsgis::img::PxlLoc(j, i));
-                        clumpBand->RasterIO(GF_Write, j, i, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                        
-                        // Add neigbouring pixels to clump.
-                        // If no more pixels to add then stop.
-                        while(clumpSearchPxls.size() > 0)
-                        {
-                            rsgis::img::PxlLoc pxl = clumpSearchPxls.front();
-                            clumpSearchPxls.pop();
-                            
-                            // Above
-                            if(((long)pxl.yPos)-1 >= 0)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos-1, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos-1, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos-1));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos-1));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos, pxl.yPos-1, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                            // Below
-                            if((pxl.yPos+1) < height)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos+1, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos+1, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos+1));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos+1));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos, pxl.yPos+1, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                                
-                            }
-                            // Left
-                            if(((long)pxl.xPos)-1 >= 0)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos-1, pxl.yPos, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos-1, pxl.yPos, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos-1, pxl.yPos));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos-1, pxl.yPos));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos-1, pxl.yPos, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                            // Right
-                            if((pxl.xPos+1) < width)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos+1, pxl.yPos, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos+1, pxl.yPos, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos+1, pxl.yPos));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos+1, pxl.yPos));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos+1, pxl.yPos, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                        }
-                        
-                        ++clumpIdx;
+                    unsigned int aboveLabel = stripOffsets[k-1] + aboveLabels[x];
+                    unsigned int belowLabel = stripOffsets[k] + belowLabels[x];
+                    if(labelCatVals[aboveLabel] == labelCatVals[belowLabel])
+                    {
+                        this->mergeClumpLabels(parents, aboveLabel, belowLabel);
                     }
                 }
             }
         }
-        pbar.finish();
+        
+        // The root of each set is its smallest label, which is the label of the first
+        // pixel of the clump in scan order, so numbering the roots in order gives the
+        // same clump IDs as a flood fill in scan order.
+        std::vector<unsigned int> finalIDs(numLabels+1, 0);
+        unsigned int clumpIdx = 1;
+        for(unsigned int l = 1; l <= numLabels; ++l)
+        {
+            unsigned int root = this->findClumpRoot(parents, l);
+            if(root == l)
+            {
+                finalIDs[l] = clumpIdx++;
+                if(clumpPxlVals != NULL)
+                {
+                    clumpPxlVals->push_back(labelCatVals[l]);
+                }
+            }
+            else
+            {
+                finalIDs[l] = finalIDs[root];
+            }
+        }
+        std::vector<unsigned int>().swap(parents);
+        std::vector<unsigned int>().swap(labelCatVals);
+        
+        // Pass 2: replace the provisional labels with the final clump IDs.
+        std::cout << "Writing clump IDs\n";
+        this->rowsProcessed = 0;
+        this->pbar.reset();
+        if(numStrips == 1)
+        {
+            this->relabelClumpStrip(&strips[0], finalIDs.data());
+        }
+        else
+        {
+            rsgis::RSGISThreadPool threadPool(numStrips);
+            for(unsigned int k = 0; k < numStrips; ++k)
+            {
+                RSGISClumpStrip *strip = &strips[k];
+                unsigned int *stripFinalIDs = &finalIDs[stripOffsets[k]];
+                threadPool.submit([this, strip, stripFinalIDs](unsigned int threadIdx)
+                {
+                    this->relabelClumpStrip(strip, stripFinalIDs);
+                });
+            }
+            threadPool.wait();
+        }
+        this->pbar.finish();
+        
         std::cout << "(Generated " << clumpIdx-1 << " clumps).\n";
         if(clumpPxlVals != NULL)
         {
@@ -182,148 +209,159 @@ namespace rsgis{namespace segment{
                 throw rsgis::img::RSGISImageCalcException("Number of clump pixel values in list is not equal to the number of clumps.");
             }
         }
-        
     }
     
-    void RSGISClumpPxls::performClumpPosVals(GDALDataset *catagories, GDALDataset *clumps) 
+    void RSGISClumpPxls::labelClumpStrip(RSGISClumpStrip *strip, bool noDataValProvided, unsigned int noDataVal)
     {
-        if(catagories->GetRasterXSize() != clumps->GetRasterXSize())
-        {
-            throw rsgis::img::RSGISImageCalcException("Widths are not the same");
-        }
-        if(catagories->GetRasterYSize() != clumps->GetRasterYSize())
-        {
-            throw rsgis::img::RSGISImageCalcException("Heights are not the same");
-        }
+        unsigned int width = this->width;
+        strip->parents.assign(1, 0);
+        strip->labelCatVals.assign(1, 0);
         
-        rsgis::img::RSGISImageUtils imgUtils;
-        imgUtils.zerosUIntGDALDataset(clumps);
-        
-        unsigned int width = catagories->GetRasterXSize();
-        unsigned int height = catagories->GetRasterYSize();
-        
-        GDALRasterBand *catagoryBand = catagories->GetRasterBand(1);
-        GDALRasterBand *clumpBand = clumps->GetRasterBand(1);
+        std::vector<unsigned int> catVals(((size_t)width) * this->ioRows);
+        std::vector<unsigned int> labels(((size_t)width) * this->ioRows);
+        // The last row of the previous block; all zero for the first row of the strip.
+        std::vector<unsigned int> prevCatVals(width, 0);
+        std::vector<unsigned int> prevLabels(width, 0);
         
-        unsigned long clumpIdx = 1;
-        std::vector<rsgis::img::PxlLoc> clumpPxls;
-        std::queue<rsgis::img::PxlLoc> clumpSearchPxls;
-        unsigned int catPxlVal = 0;
-        unsigned int catCPxlVal = 0;
-        
-        unsigned int uiPxlVal = 0;
-        
-        rsgis_tqdm pbar;
-        for(unsigned int i = 0; i < height; ++i)
+        for(unsigned int rowOffset = strip->rowStart; rowOffset < strip->rowEnd; rowOffset += this->ioRows)
         {
-            pbar.progress(i, height);
+            unsigned int numRows = std::min(this->ioRows, strip->rowEnd - rowOffset);
+            {
+                std::lock_guard<std::mutex> ioLock(this->catagoryMutex);
+                if(this->catagoryBand->RasterIO(GF_Read, 0, rowOffset, width, numRows, catVals.data(), width, numRows, GDT_UInt32, 0, 0) != CE_None)
+                {
+                    throw rsgis::img::RSGISImageCalcException("Could not read the category image.");
+                }
+            }
             
-            for(unsigned int j = 0; j < width; ++j)
+            for(unsigned int r = 0; r < numRows; ++r)
             {
-                // Get pixel value from clump image for (j,i)
-                clumpBand->RasterIO(GF_Read, j, i, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
+                unsigned int *rowCatVals = &catVals[((size_t)r)*width];
+                unsigned int *rowLabels = &labels[((size_t)r)*width];
+                unsigned int *upCatVals = (r == 0)?prevCatVals.data():&catVals[((size_t)(r-1))*width];
+                unsigned int *upLabels = (r == 0)?prevLabels.data():&labels[((size_t)(r-1))*width];
                 
-                // if value is zero create new clump
-                if(uiPxlVal == 0)
+                for(unsigned int x = 0; x < width; ++x)
                 {
-                    catagoryBand->RasterIO(GF_Read, j, i, 1, 1, &catPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                    if(catPxlVal > 0)
+                    unsigned int catVal = rowCatVals[x];
+                    if(noDataValProvided && (catVal == noDataVal))
                     {
-                        // Make sure all lists are empty.
-                        clumpPxls.clear();
-                        if(!clumpSearchPxls.empty())
+                        rowLabels[x] = 0;
+                        continue;
+                    }
+                    
+                    unsigned int leftLabel = ((x > 0) && (rowLabels[x-1] != 0) && (rowCatVals[x-1] == catVal))?rowLabels[x-1]:0;
+                    unsigned int upLabel = ((upLabels[x] != 0) && (upCatVals[x] == catVal))?upLabels[x]:0;
+                    
+                    if((leftLabel != 0) && (upLabel != 0))
+                    {
+                        rowLabels[x] = leftLabel;
+                        if(leftLabel != upLabel)
                         {
-                            while(clumpSearchPxls.size() > 0)
-                            {
-                                clumpSearchPxls.pop();
-                            }
+                            this->mergeClumpLabels(strip->parents, leftLabel, upLabel);
                         }
-                        
-                        clumpPxls.push_back(rsgis::img::PxlLoc(j, i));
-                        clumpSearchPxls.push(rsgis::img::PxlLoc(j, i));
-                        clumpBand->RasterIO(GF_Write, j, i, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                        
-                        // Add neigbouring pixels to clump.
-                        // If no more pixels to add then stop.
-                        while(clumpSearchPxls.size() > 0)
+                    }
+                    else if(leftLabel != 0)
+                    {
+                        rowLabels[x] = leftLabel;
+                    }
+                    else if(upLabel != 0)
+                    {
+                        rowLabels[x] = upLabel;
+                    }
+                    else
+                    {
+                        if(strip->parents.size() >= std::numeric_limits<unsigned int>::max())
                         {
-                            rsgis::img::PxlLoc pxl = clumpSearchPxls.front();
-                            clumpSearchPxls.pop();
-                            
-                            // Above
-                            if(((long)pxl.yPos)-1 >= 0)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos-1, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos-1, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos-1));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos-1));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos, pxl.yPos-1, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                            // Below
-                            if((pxl.yPos+1) < height)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos+1, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos+1, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos+1));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos+1));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos, pxl.yPos+1, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                                
-                            }
-                            // Left
-                            if(((long)pxl.xPos)-1 >= 0)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos-1, pxl.yPos, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos-1, pxl.yPos, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos-1, pxl.yPos));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos-1, pxl.yPos));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos-1, pxl.yPos, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                            // Right
-                            if((pxl.xPos+1) < width)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos+1, pxl.yPos, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos+1, pxl.yPos, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos+1, pxl.yPos));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos+1, pxl.yPos));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos+1, pxl.yPos, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
+                            throw rsgis::img::RSGISImageCalcException("The number of clump labels exceeds the maximum of an unsigned 32 bit integer.");
                         }
-                        
-                        ++clumpIdx;
+                        unsigned int newLabel = strip->parents.size();
+                        strip->parents.push_back(newLabel);
+                        strip->labelCatVals.push_back(catVal);
+                        rowLabels[x] = newLabel;
                     }
                 }
             }
+            
+            if(rowOffset == strip->rowStart)
+            {
+                strip->firstRowLabels.assign(labels.begin(), labels.begin()+width);
+            }
+            size_t lastRowIdx = ((size_t)(numRows-1))*width;
+            std::copy(catVals.begin()+lastRowIdx, catVals.begin()+lastRowIdx+width, prevCatVals.begin());
+            std::copy(labels.begin()+lastRowIdx, labels.begin()+lastRowIdx+width, prevLabels.begin());
+            
+            {
+                std::lock_guard<std::mutex> ioLock(this->clumpMutex);
+                if(this->clumpBand->RasterIO(GF_Write, 0, rowOffset, width, numRows, labels.data(), width, numRows, GDT_UInt32, 0, 0) != CE_None)
+                {
+                    throw rsgis::img::RSGISImageCalcException("Could not write to the clumps image.");
+                }
+            }
+            this->updateClumpProgress(numRows);
+        }
+        strip->lastRowLabels = prevLabels;
+    }
+    
+    void RSGISClumpPxls::relabelClumpStrip(RSGISClumpStrip *strip, unsigned int *stripFinalIDs)
+    {
+        unsigned int width = this->width;
+        std::vector<unsigned int> labels(((size_t)width) * this->ioRows);
+        for(unsigned int rowOffset = strip->rowStart; rowOffset < strip->rowEnd; rowOffset += this->ioRows)
+        {
+            unsigned int numRows = std::min(this->ioRows, strip->rowEnd - rowOffset);
+            size_t numPxls = ((size_t)width) * numRows;
+            
+            std::lock_guard<std::mutex> ioLock(this->clumpMutex);
+            if(this->clumpBand->RasterIO(GF_Read, 0, rowOffset, width, numRows, labels.data(), width, numRows, GDT_UInt32, 0, 0) != CE_None)
+            {
+                throw rsgis::img::RSGISImageCalcException("Could not read the clumps image.");
+            }
+            for(size_t i = 0; i < numPxls; ++i)
+            {
+                if(labels[i] != 0)
+                {
+                    labels[i] = stripFinalIDs[labels[i]];
+                }
+            }
+            if(this->clumpBand->RasterIO(GF_Write, 0, rowOffset, width, numRows, labels.data(), width, numRows, GDT_UInt32, 0, 0) != CE_None)
+            {
+                throw rsgis::img::RSGISImageCalcException("Could not write to the clumps image.");
+            }
+            this->updateClumpProgress(numRows);
+        }
+    }
+    
+    void RSGISClumpPxls::updateClumpProgress(unsigned int numRows)
+    {
+        std::lock_guard<std::mutex> pbarLock(this->pbarMutex);
+        this->rowsProcessed += numRows;
+        this->pbar.progress(this->rowsProcessed, this->height);
+    }
+    
+    inline unsigned int RSGISClumpPxls::findClumpRoot(std::vector<unsigned int> &parents, unsigned int label)
+    {
+        // Roots are always the smallest label in the set so parents[l] <= l.
+        while(parents[label] != label)
+        {
+            parents[label] = parents[parents[label]];
+            label = parents[label];
+        }
+        return label;
+    }
+    
+    inline void RSGISClumpPxls::mergeClumpLabels(std::vector<unsigned int> &parents, unsigned int label1, unsigned int label2)
+    {
+        unsigned int root1 = this->findClumpRoot(parents, label1);
+        unsigned int root2 = this->findClumpRoot(parents, label2);
+        if(root1 < root2)
+        {
+            parents[root2] = root1;
+        }
+        else if(root2 < root1)
+        {
+            parents[root1] = root2;
         }
-        pbar.finish();
-        std::cout << "(Generated " << clumpIdx-1 << " clumps).\n";
     }
     
     void RSGISClumpPxls::performMultiBandClump(std::vector<GDALDataset*> *catagories, std::string clumpsOutputPath, std::string outFormat, bool noDataValProvided, unsigned int noDataVal, bool addRatPxlVals) 
@@ -775,15 +813,15 @@ namespace rsgis{namespace segment{
             
             std::cout << "Creating Look up table.\n";
             RSGISCreateRelabelLookupTable *createLookUp = new RSGISCreateRelabelLookupTable(clumpIdxLookUp, maxClumpIdx);
-            rsgis::img::RSGISCalcImage calcImgCreateLoopUp = rsgis::img::RSGISCalcImage(createLookUp);
-            calcImgCreateLoopUp.calcImage(&catagories, 1, 0);
+            rsgis::img::RSGISCalcImageTyped<unsigned int, unsigned int> calcImgCreateLoopUp = rsgis::img::RSGISCalcImageTyped<unsigned int, unsigned int>(createLookUp);
+            calcImgCreateLoopUp.calcImage(&catagories, 1);
             delete createLookUp;
             
             
             std::cout << "Applying Look up table.\n";
             RSGISApplyRelabelLookupTable *applyLookUp = new RSGISApplyRelabelLookupTable(clumpIdxLookUp, maxClumpIdx);
-            rsgis::img::RSGISCalcImage calcImgApplyLookUp = rsgis::img::RSGISCalcImage(applyLookUp);
-            calcImgApplyLookUp.calcImage(&catagories, 1, 0, clumps);
+            rsgis::img::RSGISCalcImageTyped<unsigned int, unsigned int> calcImgApplyLookUp = rsgis::img::RSGISCalcImageTyped<unsigned int, unsigned int>(applyLookUp);
+            calcImgApplyLookUp.calcImage(&catagories, 1, clumps);
             delete applyLookUp;
             
             delete[] clumpIdxLookUp;
@@ -811,51 +849,26 @@ namespace rsgis{namespace segment{
     
     
 
-    RSGISCreateRelabelLookupTable::RSGISCreateRelabelLookupTable(unsigned long *clumpIdxLookUp, unsigned long numVals):rsgis::img::RSGISCalcImageValue(0)
+    RSGISCreateRelabelLookupTable::RSGISCreateRelabelLookupTable(unsigned long *clumpIdxLookUp, unsigned long numVals):rsgis::img::RSGISCalcImageTypedValue<unsigned int, unsigned int>(0)
     {
         this->clumpIdxLookUp = clumpIdxLookUp;
         this->numVals = numVals;
         this->nextVal = 1;
     }
 
-    void RSGISCreateRelabelLookupTable::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) 
+    void RSGISCreateRelabelLookupTable::calcImageBlock(unsigned int **bandValues, int numBands, unsigned long nPxls) 
     {
-        try
+        unsigned int *clumpIDs = bandValues[0];
+        for(unsigned long i = 0; i < nPxls; ++i)
         {
-            if((intBandValues[0] > 0) & (intBandValues[0] < numVals))
+            if((clumpIDs[i] > 0) & (clumpIDs[i] < numVals))
             {
-                size_t fid = boost::lexical_cast<size_t>(intBandValues[0]);
-                
-                if(clumpIdxLookUp[fid] == 0)
+                if(clumpIdxLookUp[clumpIDs[i]] == 0)
                 {
-                    clumpIdxLookUp[fid] = this->nextVal++;
+                    clumpIdxLookUp[clumpIDs[i]] = this->nextVal++;
                 }
             }
         }
-        catch(boost::numeric::negative_overflow& e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch(boost::numeric::positive_overflow& e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch(boost::numeric::bad_numeric_cast& e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch(rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch(rsgis::RSGISException &e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch(std::exception &e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
     }
     
     RSGISCreateRelabelLookupTable::~RSGISCreateRelabelLookupTable()
@@ -865,51 +878,27 @@ namespace rsgis{namespace segment{
 
     
     
-    RSGISApplyRelabelLookupTable::RSGISApplyRelabelLookupTable(unsigned long *clumpIdxLookUp, unsigned long numVals): rsgis::img::RSGISCalcImageValue(1)
+    RSGISApplyRelabelLookupTable::RSGISApplyRelabelLookupTable(unsigned long *clumpIdxLookUp, unsigned long numVals): rsgis::img::RSGISCalcImageTypedValue<unsigned int, unsigned int>(1)
     {
         this->clumpIdxLookUp = clumpIdxLookUp;
         this->numVals = numVals;
     }
 		
-    void RSGISApplyRelabelLookupTable::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) 
+    void RSGISApplyRelabelLookupTable::calcImageBlock(unsigned int **bandValues, int numBands, unsigned long nPxls, unsigned int **output) 
     {
-        try
+        unsigned int *clumpIDs = bandValues[0];
+        unsigned int *outClumpIDs = output[0];
+        for(unsigned long i = 0; i < nPxls; ++i)
         {
-            if((intBandValues[0] > 0) & (intBandValues[0] < numVals))
+            if((clumpIDs[i] > 0) & (clumpIDs[i] < numVals))
             {
-                unsigned long fid = boost::lexical_cast<unsigned long>(intBandValues[0]);
-                
-                output[0] = clumpIdxLookUp[fid];
+                outClumpIDs[i] = clumpIdxLookUp[clumpIDs[i]];
             }
             else
             {
-                output[0] = 0;
+                outClumpIDs[i] = 0;
             }
         }
-        catch(boost::numeric::negative_overflow& e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch(boost::numeric::positive_overflow& e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch(boost::numeric::bad_numeric_cast& e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch(rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch(rsgis::RSGISException &e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch(std::exception &e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
     }
     
     RSGISApplyRelabelLookupTable::~RSGISApplyRelabelLookupTable()
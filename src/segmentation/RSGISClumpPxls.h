@@ -26,17 +26,22 @@
 #include <iostream>
 #include <vector>
 #include <queue>
+#include <mutex>
+#include <algorithm>
+#include <limits>
 #include <math.h>
 
 #include "gdal_priv.h"
 
 #include "common/rsgis-tqdm.h"
+#include "common/RSGISThreadPool.h"
 
 #include "img/RSGISImageUtils.h"
 #include "img/RSGISImageCalcException.h"
 
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISCalcImage.h"
+#include "img/RSGISCalcImageTyped.h"
 
 #include "rastergis/RSGISRasterAttUtils.h"
 
@@ -57,10 +62,34 @@
 
 namespace rsgis{namespace segment{
 
+    /**
+     * A horizontal strip of the image labelled independently during clumping. Labels
+     * are local to the strip (starting at 1) and are stored with the union-find
+     * parent of each label and the category value the label was created for.
+     */
+    struct DllExport RSGISClumpStrip
+    {
+        unsigned int rowStart;
+        unsigned int rowEnd;
+        std::vector<unsigned int> parents;
+        std::vector<unsigned int> labelCatVals;
+        std::vector<unsigned int> firstRowLabels;
+        std::vector<unsigned int> lastRowLabels;
+    };
+    
     class DllExport RSGISClumpPxls
     {
     public:
         RSGISClumpPxls();
+        /**
+         * Clump the pixels of the category image using a two pass connected component
+         * labelling (4-connectivity). Pixels are labelled in blocks of rows with a
+         * union-find equivalence table, so memory is bounded by the block size and the
+         * number of labels rather than the image size. When the library default number
+         * of threads is greater than 1 the image is labelled in strips in parallel and
+         * the labels are merged across the strip borders. The clump IDs are numbered in
+         * the order the first pixel of each clump occurs in the image.
+         */
         void performClump(GDALDataset *catagories, GDALDataset *clumps, bool noDataValProvided, unsigned int noDataVal, std::vector<unsigned int> *clumpPxlVals=NULL);
         void performClumpPosVals(GDALDataset *catagories, GDALDataset *clumps);
         void performMultiBandClump(std::vector<GDALDataset*> *catagories, std::string clumpsOutputPath, std::string outFormat, bool noDataValProvided, unsigned int noDataVal, bool addRatPxlVals=false);
@@ -68,6 +97,23 @@ namespace rsgis{namespace segment{
     protected:
         inline bool allValueEqual(unsigned int *vals, unsigned int numVals, unsigned int equalVal);
         inline bool allValueEqual(unsigned int *vals1, unsigned int *vals2, unsigned int numVals);
+        void labelClumps(GDALDataset *catagories, GDALDataset *clumps, bool noDataValProvided, unsigned int noDataVal, std::vector<unsigned int> *clumpPxlVals);
+        void labelClumpStrip(RSGISClumpStrip *strip, bool noDataValProvided, unsigned int noDataVal);
+        void relabelClumpStrip(RSGISClumpStrip *strip, unsigned int *stripFinalIDs);
+        void updateClumpProgress(unsigned int numRows);
+        inline unsigned int findClumpRoot(std::vector<unsigned int> &parents, unsigned int label);
+        inline void mergeClumpLabels(std::vector<unsigned int> &parents, unsigned int label1, unsigned int label2);
+        
+        GDALRasterBand *catagoryBand;
+        GDALRasterBand *clumpBand;
+        std::mutex catagoryMutex;
+        std::mutex clumpMutex;
+        std::mutex pbarMutex;
+        rsgis_tqdm pbar;
+        unsigned int rowsProcessed;
+        unsigned int width;
+        unsigned int height;
+        unsigned int ioRows;
     };
     
     class DllExport RSGISRelabelClumps
@@ -79,20 +125,12 @@ namespace rsgis{namespace segment{
         ~RSGISRelabelClumps();
     };
     
-    class DllExport RSGISCreateRelabelLookupTable : public rsgis::img::RSGISCalcImageValue
+    class DllExport RSGISCreateRelabelLookupTable : public rsgis::img::RSGISCalcImageTypedValue<unsigned int, unsigned int>
 	{
 	public:
 		RSGISCreateRelabelLookupTable(unsigned long *clumpIdxLookUp, unsigned long numVals);
-		void calcImageValue(float *bandValues, int numBands, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-		void calcImageValue(float *bandValues, int numBands) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals);
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, geos::geom::Envelope extent){throw rsgis::img::RSGISImageCalcException("Not implemented");};
-		void calcImageValue(float *bandValues, int numBands, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-		void calcImageValue(float *bandValues, int numBands, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-		void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-        void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-		bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+        void calcImageBlock(unsigned int **bandValues, int numBands, unsigned long nPxls, unsigned int **output) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
+        void calcImageBlock(unsigned int **bandValues, int numBands, unsigned long nPxls);
         ~RSGISCreateRelabelLookupTable();
     protected:
         unsigned long *clumpIdxLookUp;
@@ -101,20 +139,12 @@ namespace rsgis{namespace segment{
 	};
     
     
-    class DllExport RSGISApplyRelabelLookupTable : public rsgis::img::RSGISCalcImageValue
+    class DllExport RSGISApplyRelabelLookupTable : public rsgis::img::RSGISCalcImageTypedValue<unsigned int, unsigned int>
 	{
 	public:
 		RSGISApplyRelabelLookupTable(unsigned long *clumpIdxLookUp, unsigned long numVals);
-		void calcImageValue(float *bandValues, int numBands, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-		void calcImageValue(float *bandValues, int numBands) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output);
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, geos::geom::Envelope extent){throw rsgis::img::RSGISImageCalcException("Not implemented");};
-		void calcImageValue(float *bandValues, int numBands, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-		void calcImageValue(float *bandValues, int numBands, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-		void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-        void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, geos::geom::Envelope extent) {throw rsgis::img::RSGISImageCalcException("No implemented");};
-		bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw rsgis::img::RSGISImageCalcException("No implemented");};
+        void calcImageBlock(unsigned int **bandValues, int numBands, unsigned long nPxls, unsigned int **output);
+        void calcImageBlock(unsigned int **bandValues, int numBands, unsigned long nPxls) {throw rsgis::img::RSGISImageCalcException("Not implemented");};
         ~RSGISApplyRelabelLookupTable();
     protected:
         unsigned long *clumpIdxLookUp;
@@ -81,7 +81,7 @@ namespace rsgis{namespace segment{
             popImageStats.populateImageWithRasterGISStats(outClumpsDataset, true, true, 1);
             popImageStats.calcPyramids(outClumpsDataset);
             
-            GDALClose(outClumpsDataset);
+            rsgis::img::RSGISImageBlockCache::closeDataset(outClumpsDataset);
         }
         catch (rsgis::img::RSGISImageCalcException &e)
         {
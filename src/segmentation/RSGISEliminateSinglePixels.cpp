@@ -117,6 +117,52 @@ namespace rsgis{namespace segment{
             GDALDataset *outData = NULL;
             rsgis::img::RSGISImageUtils imgUtils;
             outData = imgUtils.createCopy(inClumpsData, outputImage, format, GDT_UInt32, projFromImage, proj);
+            
+            this->eliminateBlocks(inSpecData, inClumpsData, tmpData, outData, noDataVal, noDataValProvided);
+            
+            GDALClose(outData);
+        }
+        catch(rsgis::img::RSGISImageCalcException &e)
+        {
+            throw e;
+        }
+        catch(RSGISImageException &e)
+        {
+            throw rsgis::img::RSGISImageCalcException(e.what());
+        }
+    }
+    
+    void RSGISEliminateSinglePixels::eliminateBlocks(GDALDataset *inSpecData, GDALDataset *inClumpsData, GDALDataset *tmpData, GDALDataset *outData, float noDataVal, bool noDataValProvided)
+    {
+        try
+        {
+            // Check images have the same size!
+            if(inSpecData->GetRasterXSize() != inClumpsData->GetRasterXSize())
+            {
+                throw rsgis::img::RSGISImageCalcException("Widths are not the same (spectral and categories)");
+            }
+            if(inSpecData->GetRasterYSize() != inClumpsData->GetRasterYSize())
+            {
+                throw rsgis::img::RSGISImageCalcException("Heights are not the same (spectral and categories)");
+            }
+            if(inSpecData->GetRasterXSize() != tmpData->GetRasterXSize())
+            {
+                throw rsgis::img::RSGISImageCalcException("Widths are not the same (spectral and temp)");
+            }
+            if(inSpecData->GetRasterYSize() != tmpData->GetRasterYSize())
+            {
+                throw rsgis::img::RSGISImageCalcException("Heights are not the same (spectral and temp)");
+            }
+            if(inSpecData->GetRasterXSize() != outData->GetRasterXSize())
+            {
+                throw rsgis::img::RSGISImageCalcException("Widths are not the same (spectral and output)");
+            }
+            if(inSpecData->GetRasterYSize() != outData->GetRasterYSize())
+            {
+                throw rsgis::img::RSGISImageCalcException("Heights are not the same (spectral and output)");
+            }
+            
+            rsgis::img::RSGISImageUtils imgUtils;
             imgUtils.copyUIntGDALDataset(inClumpsData, outData);
             
             RSGISFindSinglePixels *findSingles = new RSGISFindSinglePixels(noDataVal, noDataValProvided);
@@ -161,9 +207,6 @@ namespace rsgis{namespace segment{
             delete findSingles;
             delete elimSingles;
             delete[] inElimDatasets;
-            
-            GDALClose(outData);
-            
         }
         catch(rsgis::img::RSGISImageCalcException &e)
         {
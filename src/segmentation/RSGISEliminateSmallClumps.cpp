@@ -1142,6 +1142,144 @@ namespace rsgis{namespace segment{
         delete[] spectralVals;
     }
   
+    void RSGISEliminateSmallClumps::stepwiseEliminateSmallClumpsGraph(GDALDataset *spectral, GDALDataset *clumps, unsigned int minClumpSize, float specThreshold, std::vector<rsgis::img::BandSpecThresholdStats> *bandStretchStats, bool bandStatsAvail, bool iterative)
+    {
+        RSGISClumpAdjacencyGraph clumpGraph;
+        clumpGraph.buildGraph(clumps, spectral);
+        this->stepwiseEliminateSmallClumpsGraph(&clumpGraph, minClumpSize, specThreshold, bandStretchStats, bandStatsAvail, iterative);
+        clumpGraph.relabelClumps(clumps);
+    }
+    
+    void RSGISEliminateSmallClumps::stepwiseEliminateSmallClumpsGraph(RSGISClumpAdjacencyGraph *clumpGraph, unsigned int minClumpSize, float specThreshold, std::vector<rsgis::img::BandSpecThresholdStats> *bandStretchStats, bool bandStatsAvail, bool iterative)
+    {
+        unsigned int numSpecBands = clumpGraph->getNumBands();
+
+        std::vector<double> stretch2reflGains;
+        if(bandStatsAvail && (numSpecBands != bandStretchStats->size()))
+        {
+            throw rsgis::img::RSGISImageCalcException("The number of image bands and the number band statistics are not the same.");
+        }
+        else if(bandStatsAvail)
+        {
+            // The offsets cancel when the difference between two means is taken.
+            for(unsigned int i = 0; i < numSpecBands; ++i)
+            {
+                stretch2reflGains.push_back((bandStretchStats->at(i).origMax - bandStretchStats->at(i).origMin) / (bandStretchStats->at(i).imgMax - bandStretchStats->at(i).imgMin));
+            }
+        }
+
+        size_t numClumps = clumpGraph->getNumClumps();
+
+        std::vector<size_t> smallClumps;
+        std::vector< std::pair<size_t, size_t> > mergeLookupTab;
+        std::vector<size_t> neighbours;
+        size_t closestNeighbour = 0;
+        bool firstNeighbourTested = true;
+        double closestNeighbourDist = 0;
+        double distance = 0;
+        double diff = 0;
+
+        std::cout << "Eliminating Small Clumps." << std::endl;
+        bool continueElim = true;
+        size_t clumpsBelowThresCounter = 0;
+        for(unsigned int clumpArea = 1; clumpArea <= minClumpSize; ++clumpArea)
+        {
+            continueElim = true;
+            while(continueElim)
+            {
+                std::cout << "Eliminating clumps of size " << clumpArea << std::endl;
+                smallClumps.clear();
+                for(size_t i = 1; i <= numClumps; ++i)
+                {
+                    if(clumpGraph->isActive(i) && (clumpGraph->getNumPxls(i) > 0) && (clumpGraph->getNumPxls(i) <= clumpArea))
+                    {
+                        smallClumps.push_back(i);
+                    }
+                }
+                std::cout << "Found " << smallClumps.size() << " small clumps to be eliminated." << std::endl;
+
+                // As with the other stepwise methods the merges are decided on the clumps
+                // at the start of the pass and applied at the end of the pass.
+                mergeLookupTab.clear();
+                for(std::vector<size_t>::iterator iterClumps = smallClumps.begin(); iterClumps != smallClumps.end(); ++iterClumps)
+                {
+                    size_t cClump = *iterClumps;
+                    if(clumpGraph->getNumPxls(cClump) >= minClumpSize)
+                    {
+                        continue;
+                    }
+                    clumpGraph->getNeighbours(cClump, &neighbours);
+
+                    // Decide on which neighbour to measure with.
+                    firstNeighbourTested = true;
+                    for(std::vector<size_t>::iterator iterNeighbours = neighbours.begin(); iterNeighbours != neighbours.end(); ++iterNeighbours)
+                    {
+                        if(clumpGraph->getNumPxls(*iterNeighbours) > clumpGraph->getNumPxls(cClump))
+                        {
+                            distance = 0;
+                            for(unsigned int b = 0; b < numSpecBands; ++b)
+                            {
+                                diff = clumpGraph->getMean(cClump, b) - clumpGraph->getMean(*iterNeighbours, b);
+                                distance += diff * diff;
+                            }
+                            distance = sqrt(distance);
+
+                            if(firstNeighbourTested || (distance < closestNeighbourDist))
+                            {
+                                closestNeighbour = *iterNeighbours;
+                                closestNeighbourDist = distance;
+                                firstNeighbourTested = false;
+                            }
+                        }
+                    }
+
+                    if(!firstNeighbourTested)
+                    {
+                        if(bandStatsAvail)
+                        {
+                            distance = 0;
+                            for(unsigned int b = 0; b < numSpecBands; ++b)
+                            {
+                                diff = (clumpGraph->getMean(cClump, b) - clumpGraph->getMean(closestNeighbour, b)) * stretch2reflGains[b];
+                                distance += diff * diff;
+                            }
+                            closestNeighbourDist = sqrt(distance);
+                        }
+
+                        if(closestNeighbourDist < specThreshold)
+                        {
+                            mergeLookupTab.push_back(std::pair<size_t, size_t>(cClump, closestNeighbour));
+                        }
+                    }
+                }
+
+                // Update the graph; a clump merged into a clump which was itself merged
+                // ends up within the clump at the end of the chain.
+                for(std::vector< std::pair<size_t, size_t> >::iterator iterMerge = mergeLookupTab.begin(); iterMerge != mergeLookupTab.end(); ++iterMerge)
+                {
+                    clumpGraph->mergeClumps((*iterMerge).first, (*iterMerge).second);
+                }
+                std::cout << "Eliminated " << mergeLookupTab.size() << " small clumps\n";
+
+                continueElim = false;
+                if(iterative)
+                {
+                    clumpsBelowThresCounter = 0;
+                    for(size_t i = 1; i <= numClumps; ++i)
+                    {
+                        if(clumpGraph->isActive(i) && (clumpGraph->getNumPxls(i) > 0) && (clumpGraph->getNumPxls(i) <= clumpArea))
+                        {
+                            ++clumpsBelowThresCounter;
+                        }
+                    }
+                    std::cout << "There are " << clumpsBelowThresCounter << " small clumps below " << clumpArea << " still to be eliminated\n";
+                    continueElim = (clumpsBelowThresCounter > 0) && (clumpsBelowThresCounter != smallClumps.size());
+                }
+            }
+            std::cout << std::endl;
+        }
+    }
+    
     RSGISEliminateSmallClumps::~RSGISEliminateSmallClumps()
     {
         
@@ -46,6 +46,8 @@
 
 #include "rastergis/RSGISRasterAttUtils.h"
 
+#include "segmentation/RSGISClumpAdjacencyGraph.h"
+
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
 #undef DllExport
@@ -69,6 +71,15 @@ namespace rsgis{namespace segment{
         void stepwiseEliminateSmallClumps(GDALDataset *spectral, GDALDataset *clumps, unsigned int minClumpSize, float specThreshold, std::vector<rsgis::img::BandSpecThresholdStats> *bandStretchStats, bool bandStatsAvail);
         void stepwiseIterativeEliminateSmallClumps(GDALDataset *spectral, GDALDataset *clumps, unsigned int minClumpSize, float specThreshold, std::vector<rsgis::img::BandSpecThresholdStats> *bandStretchStats, bool bandStatsAvail);
         void stepwiseEliminateSmallClumpsNoMean(GDALDataset *spectral, GDALDataset *clumps, unsigned int minClumpSize, float specThreshold, std::vector<rsgis::img::BandSpecThresholdStats> *bandStretchStats, bool bandStatsAvail);
+        /**
+         * The stepwise elimination of stepwiseEliminateSmallClumps (iterative = false) and
+         * stepwiseIterativeEliminateSmallClumps (iterative = true) using a region adjacency
+         * graph (RSGISClumpAdjacencyGraph) so the image is only read to build the graph and
+         * written once with the final clump IDs.
+         */
+        void stepwiseEliminateSmallClumpsGraph(GDALDataset *spectral, GDALDataset *clumps, unsigned int minClumpSize, float specThreshold, std::vector<rsgis::img::BandSpecThresholdStats> *bandStretchStats, bool bandStatsAvail, bool iterative);
+        /** As above but eliminating within a graph which has already been built; the clumps image is not relabelled. */
+        void stepwiseEliminateSmallClumpsGraph(RSGISClumpAdjacencyGraph *clumpGraph, unsigned int minClumpSize, float specThreshold, std::vector<rsgis::img::BandSpecThresholdStats> *bandStretchStats, bool bandStatsAvail, bool iterative);
         ~RSGISEliminateSmallClumps();
     };
     
@@ -67,7 +67,7 @@ namespace rsgis{namespace segment{
                                 
                 this->addTileBorder2Mask(inImage, borderMaskDataset, attTable, colsName, tileBoundary);
                 
-                GDALClose(inImage);
+                rsgis::img::RSGISImageBlockCache::closeDataset(inImage);
             }
         }
         catch (rsgis::img::RSGISImageCalcException &e)
@@ -132,7 +132,7 @@ namespace rsgis{namespace segment{
                                 
                 this->addTileBodyClumps(outputDataset, inImage, borderMaskDataset, attTable, "GlobalClumpID", colsName, tileBody, tileBoundary);
                 
-                GDALClose(inImage);
+                rsgis::img::RSGISImageBlockCache::closeDataset(inImage);
             }
         }
         catch (rsgis::img::RSGISImageCalcException &e)
@@ -245,7 +245,7 @@ namespace rsgis{namespace segment{
                 
                 imageOffset += (numClumps-1);
                 
-                GDALClose(inImage);
+                rsgis::img::RSGISImageBlockCache::closeDataset(inImage);
             }
         }
         catch (rsgis::img::RSGISImageCalcException &e)
@@ -0,0 +1,493 @@
+/*
+ *  RSGISShepherdSegmentation.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISShepherdSegmentation.h"
+
+namespace rsgis{namespace segment{
+
+    RSGISShepherdSegmentation::RSGISShepherdSegmentation(bool processInMemory, std::string tmpDIR, std::string tmpFormat)
+    {
+        this->processInMemory = processInMemory;
+        this->tmpDIR = boost::filesystem::path(tmpDIR);
+        this->tmpFormat = tmpFormat;
+    }
+
+    void RSGISShepherdSegmentation::performSegmentation(GDALDataset *inputImage, std::vector<unsigned int> bands, GDALDataset *outClumps, bool noStretch, unsigned int numClusters, unsigned int minPxls, float distThres, unsigned int sampling, unsigned int kmMaxIter, std::string inStretchStatsFile, std::string inKMeansCentresFile, std::string outStretchStatsFile, std::string outKMeansCentresFile)
+    {
+        if((inputImage->GetRasterXSize() != outClumps->GetRasterXSize()) || (inputImage->GetRasterYSize() != outClumps->GetRasterYSize()))
+        {
+            throw rsgis::img::RSGISImageCalcException("The input and output clumps images are not the same size.");
+        }
+        if(bands.empty())
+        {
+            for(int n = 1; n <= inputImage->GetRasterCount(); ++n)
+            {
+                bands.push_back(n);
+            }
+        }
+        for(std::vector<unsigned int>::iterator iterBands = bands.begin(); iterBands != bands.end(); ++iterBands)
+        {
+            if((*iterBands == 0) || (*iterBands > ((unsigned int)inputImage->GetRasterCount())))
+            {
+                throw rsgis::img::RSGISImageCalcException("A band specified is not within the input image.");
+            }
+        }
+        if(sampling == 0)
+        {
+            sampling = 1;
+        }
+        unsigned int numBands = bands.size();
+
+        rsgis::math::RSGISMatrices matrixUtils;
+        rsgis::math::Matrix *clusterCentres = NULL;
+        GDALDataset *spectral = NULL;
+        GDALDataset *labels = NULL;
+        GDALDataset *noSglsLabels = NULL;
+        GDALDataset *pxlMask = NULL;
+        GDALDataset *clumps = NULL;
+        try
+        {
+            // Stretch the image, sampling for the KMeans (or labelling if the centres are known).
+            std::vector<double> stretchMin;
+            std::vector<double> stretchMax;
+            bool ignoreZeros = false;
+            if(!noStretch)
+            {
+                if(inStretchStatsFile != "")
+                {
+                    std::vector<rsgis::img::BandSpecThresholdStats> *bandStats = rsgis::img::RSGISStretchImage::readBandSpecThresholds(inStretchStatsFile);
+                    if(bandStats->size() != numBands)
+                    {
+                        delete bandStats;
+                        throw rsgis::img::RSGISImageCalcException("The number of bands in the stretch statistics file does not match the number of image bands.");
+                    }
+                    for(unsigned int n = 0; n < numBands; ++n)
+                    {
+                        stretchMin.push_back(bandStats->at(n).origMin);
+                        stretchMax.push_back(bandStats->at(n).origMax);
+                    }
+                    delete bandStats;
+                }
+                else
+                {
+                    ignoreZeros = true;
+                    this->calcStretchStats(inputImage, &bands, &stretchMin, &stretchMax, outStretchStatsFile);
+                }
+            }
+
+            if(inKMeansCentresFile != "")
+            {
+                clusterCentres = matrixUtils.readMatrixFromGridTxt(inKMeansCentresFile);
+                if(((unsigned int)clusterCentres->n) != numBands)
+                {
+                    throw rsgis::img::RSGISImageCalcException("The number of bands in the cluster centres file does not match the number of image bands.");
+                }
+            }
+
+            spectral = this->createIntermediate(inputImage, numBands, noStretch?GDT_Float32:GDT_Byte);
+            labels = this->createIntermediate(inputImage, 1, GDT_UInt32);
+
+            std::vector< std::vector<float> > samples;
+            std::cout << "Stretching the input image\n";
+            this->stretchImage(inputImage, &bands, !noStretch, ignoreZeros, &stretchMin, &stretchMax, spectral, sampling, &samples, clusterCentres, labels);
+
+            if(clusterCentres == NULL)
+            {
+                std::cout << "Performing KMeans on " << samples.size() << " sampled pixels\n";
+                if(samples.empty())
+                {
+                    throw rsgis::img::RSGISImageCalcException("No pixels were sampled for the KMeans clustering.");
+                }
+                rsgis::math::RSGISKMeansClusterer clusterer(rsgis::math::init_diagonal_full_attach);
+                std::vector< rsgis::math::RSGISClusterCentre > *centres = clusterer.calcClusterCentres(&samples, numBands, numClusters, kmMaxIter, 0.0025);
+                clusterCentres = matrixUtils.createMatrix(numBands, centres->size());
+                for(unsigned int i = 0; i < centres->size(); ++i)
+                {
+                    for(unsigned int n = 0; n < numBands; ++n)
+                    {
+                        clusterCentres->matrix[(n*centres->size())+i] = centres->at(i).centre[n];
+                    }
+                }
+                delete centres;
+                if(outKMeansCentresFile != "")
+                {
+                    matrixUtils.saveMatrix2GridTxt(clusterCentres, outKMeansCentresFile);
+                }
+
+                std::cout << "Applying KMeans to the image\n";
+                this->labelPixels(spectral, clusterCentres, labels);
+            }
+            // Release the samples before the remaining steps.
+            std::vector< std::vector<float> >().swap(samples);
+            matrixUtils.freeMatrix(clusterCentres);
+            clusterCentres = NULL;
+
+            std::cout << "Eliminating single pixels\n";
+            noSglsLabels = this->createIntermediate(inputImage, 1, GDT_UInt32);
+            pxlMask = this->createIntermediate(inputImage, 1, GDT_Byte);
+            RSGISEliminateSinglePixels eliminateSingles;
+            eliminateSingles.eliminateBlocks(spectral, labels, pxlMask, noSglsLabels, 0, true);
+            this->deleteIntermediate(pxlMask);
+            pxlMask = NULL;
+            this->deleteIntermediate(labels);
+            labels = NULL;
+
+            std::cout << "Performing clump\n";
+            clumps = this->createIntermediate(inputImage, 1, GDT_UInt32);
+            RSGISClumpPxls clumpImg;
+            clumpImg.performClump(noSglsLabels, clumps, true, 0);
+            this->deleteIntermediate(noSglsLabels);
+            noSglsLabels = NULL;
+
+            std::cout << "Eliminating small clumps\n";
+            RSGISClumpAdjacencyGraph clumpGraph;
+            clumpGraph.buildGraph(clumps, spectral);
+            this->deleteIntermediate(spectral);
+            spectral = NULL;
+            RSGISEliminateSmallClumps eliminate;
+            eliminate.stepwiseEliminateSmallClumpsGraph(&clumpGraph, minPxls, distThres, NULL, false, false);
+            size_t numOutClumps = clumpGraph.relabelClumpsSequential(clumps, outClumps);
+            std::cout << "There are " << numOutClumps << " clumps in the output.\n";
+            this->deleteIntermediate(clumps);
+            clumps = NULL;
+        }
+        catch(std::exception &e)
+        {
+            // Any exception (e.g., std::bad_alloc) must still remove the temporary files.
+            if(clusterCentres != NULL)
+            {
+                matrixUtils.freeMatrix(clusterCentres);
+            }
+            GDALDataset *intermediates[] = {spectral, labels, noSglsLabels, pxlMask, clumps};
+            for(unsigned int i = 0; i < 5; ++i)
+            {
+                if(intermediates[i] != NULL)
+                {
+                    this->deleteIntermediate(intermediates[i]);
+                }
+            }
+            throw rsgis::img::RSGISImageCalcException(e.what());
+        }
+    }
+
+    GDALDataset* RSGISShepherdSegmentation::createIntermediate(GDALDataset *templateImg, unsigned int numBands, GDALDataType dataType)
+    {
+        rsgis::img::RSGISImageUtils imgUtils;
+        GDALDataset *dataset = NULL;
+        if(this->processInMemory)
+        {
+            dataset = imgUtils.createCopy(templateImg, numBands, "", "MEM", dataType, true, "");
+        }
+        else
+        {
+            boost::filesystem::path tmpPath = this->tmpDIR / boost::filesystem::unique_path("rsgis_shepseg_%%%%-%%%%-%%%%-%%%%.tmp");
+            dataset = imgUtils.createCopy(templateImg, numBands, tmpPath.string(), this->tmpFormat, dataType, true, "");
+            this->tmpFiles[dataset] = tmpPath.string();
+        }
+        return dataset;
+    }
+
+    void RSGISShepherdSegmentation::deleteIntermediate(GDALDataset *dataset)
+    {
+        std::map<GDALDataset*, std::string>::iterator iterFile = this->tmpFiles.find(dataset);
+        GDALDriver *driver = dataset->GetDriver();
+        GDALClose(dataset);
+        if(iterFile != this->tmpFiles.end())
+        {
+            if(driver != NULL)
+            {
+                driver->Delete(iterFile->second.c_str());
+            }
+            this->tmpFiles.erase(iterFile);
+        }
+    }
+
+    void RSGISShepherdSegmentation::calcStretchStats(GDALDataset *inputImage, std::vector<unsigned int> *bands, std::vector<double> *stretchMin, std::vector<double> *stretchMax, std::string outStretchStatsFile)
+    {
+        unsigned int numBands = bands->size();
+        unsigned int width = inputImage->GetRasterXSize();
+        unsigned int height = inputImage->GetRasterYSize();
+
+        GDALRasterBand **inBands = new GDALRasterBand*[numBands];
+        for(unsigned int n = 0; n < numBands; ++n)
+        {
+            inBands[n] = inputImage->GetRasterBand(bands->at(n));
+        }
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        inBands[0]->GetBlockSize(&xBlockSize, &yBlockSize);
+        unsigned int numRows = (yBlockSize > 0)?yBlockSize:1;
+        std::vector<float> vals(((size_t)width) * numRows);
+
+        // Mean and variance are accumulated in one pass (Welford), ignoring zeros as
+        // the stretch does.
+        std::vector<double> n(numBands, 0.0);
+        std::vector<double> mean(numBands, 0.0);
+        std::vector<double> m2(numBands, 0.0);
+        std::vector<double> minVal(numBands, 0.0);
+        std::vector<double> maxVal(numBands, 0.0);
+
+        std::cout << "Calculating image statistics\n";
+        rsgis_tqdm pbar;
+        for(unsigned int row = 0; row < height; row += numRows)
+        {
+            pbar.progress(row, height);
+            unsigned int blockRows = std::min(numRows, height - row);
+            size_t numVals = ((size_t)width) * blockRows;
+            for(unsigned int b = 0; b < numBands; ++b)
+            {
+                if(inBands[b]->RasterIO(GF_Read, 0, row, width, blockRows, vals.data(), width, blockRows, GDT_Float32, 0, 0) != CE_None)
+                {
+                    delete[] inBands;
+                    throw rsgis::img::RSGISImageCalcException("Could not read the input image.");
+                }
+                for(size_t i = 0; i < numVals; ++i)
+                {
+                    if((vals[i] == 0) || boost::math::isnan(vals[i]))
+                    {
+                        continue;
+                    }
+                    if(n[b] == 0)
+                    {
+                        minVal[b] = vals[i];
+                        maxVal[b] = vals[i];
+                    }
+                    else if(vals[i] < minVal[b])
+                    {
+                        minVal[b] = vals[i];
+                    }
+                    else if(vals[i] > maxVal[b])
+                    {
+                        maxVal[b] = vals[i];
+                    }
+                    n[b] += 1;
+                    double delta = vals[i] - mean[b];
+                    mean[b] += delta / n[b];
+                    m2[b] += delta * (vals[i] - mean[b]);
+                }
+            }
+        }
+        pbar.finish();
+        delete[] inBands;
+
+        std::ofstream outTxtFile;
+        if(outStretchStatsFile != "")
+        {
+            outTxtFile.open(outStretchStatsFile.c_str());
+            if(!outTxtFile.is_open())
+            {
+                throw rsgis::img::RSGISImageCalcException("Output file for the statistics could not be opened.");
+            }
+            outTxtFile << "#stddev\n";
+            outTxtFile << "#band,img_min,img_max,out_min,out_max\n";
+        }
+
+        stretchMin->clear();
+        stretchMax->clear();
+        for(unsigned int b = 0; b < numBands; ++b)
+        {
+            double stddev = (n[b] > 0)?sqrt(m2[b]/n[b]):0;
+            stretchMin->push_back(std::max(mean[b] - (stddev * 2), minVal[b]));
+            stretchMax->push_back(std::min(mean[b] + (stddev * 2), maxVal[b]));
+            std::cout << "Band[" << b+1 << "] Min = " << minVal[b] << " Mean = " << mean[b] << " (Std Dev = " << stddev << ") max = " << maxVal[b] << std::endl;
+            if(outStretchStatsFile != "")
+            {
+                outTxtFile << b+1 << "," << stretchMin->at(b) << "," << stretchMax->at(b) << ",0,255" << std::endl;
+            }
+        }
+
+        if(outStretchStatsFile != "")
+        {
+            outTxtFile.flush();
+            outTxtFile.close();
+        }
+    }
+
+    void RSGISShepherdSegmentation::stretchImage(GDALDataset *inputImage, std::vector<unsigned int> *bands, bool stretch, bool ignoreZeros, std::vector<double> *stretchMin, std::vector<double> *stretchMax, GDALDataset *spectral, unsigned int sampling, std::vector< std::vector<float> > *samples, rsgis::math::Matrix *clusterCentres, GDALDataset *labels)
+    {
+        unsigned int numBands = bands->size();
+        unsigned int width = inputImage->GetRasterXSize();
+        unsigned int height = inputImage->GetRasterYSize();
+
+        GDALRasterBand **inBands = new GDALRasterBand*[numBands];
+        for(unsigned int n = 0; n < numBands; ++n)
+        {
+            inBands[n] = inputImage->GetRasterBand(bands->at(n));
+        }
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        inBands[0]->GetBlockSize(&xBlockSize, &yBlockSize);
+        unsigned int numRows = (yBlockSize > 0)?yBlockSize:1;
+        size_t blockSize = ((size_t)width) * numRows;
+        std::vector<float> vals(blockSize * numBands);
+        std::vector<unsigned int> labelVals;
+        if(clusterCentres != NULL)
+        {
+            labelVals.resize(blockSize);
+        }
+        std::vector<float> pxlVals(numBands);
+
+        unsigned long pxlCount = 0;
+        rsgis_tqdm pbar;
+        for(unsigned int row = 0; row < height; row += numRows)
+        {
+            pbar.progress(row, height);
+            unsigned int blockRows = std::min(numRows, height - row);
+            size_t numVals = ((size_t)width) * blockRows;
+            for(unsigned int b = 0; b < numBands; ++b)
+            {
+                if(inBands[b]->RasterIO(GF_Read, 0, row, width, blockRows, &vals[numVals * b], width, blockRows, GDT_Float32, 0, 0) != CE_None)
+                {
+                    delete[] inBands;
+                    throw rsgis::img::RSGISImageCalcException("Could not read the input image.");
+                }
+            }
+
+            for(size_t i = 0; i < numVals; ++i)
+            {
+                if(stretch)
+                {
+                    // Matches stretchImage, adding 1 and masking where band 1 is 0.
+                    bool masked = (vals[i] == 0);
+                    for(unsigned int b = 0; b < numBands; ++b)
+                    {
+                        float *val = &vals[(numVals * b) + i];
+                        double outVal = 0;
+                        if(boost::math::isnan(*val) || (ignoreZeros && (*val == 0)))
+                        {
+                            outVal = 0;
+                        }
+                        else if(*val < stretchMin->at(b))
+                        {
+                            outVal = 0;
+                        }
+                        else if(*val > stretchMax->at(b))
+                        {
+                            outVal = 255;
+                        }
+                        else
+                        {
+                            outVal = ((*val - stretchMin->at(b)) / (stretchMax->at(b) - stretchMin->at(b))) * 255;
+                            if(outVal == 0)
+                            {
+                                outVal = 1;
+                            }
+                        }
+                        outVal = std::min(floor(outVal + 0.5) + 1, 255.0);
+                        *val = masked?0:outVal;
+                    }
+                }
+
+                if(((pxlCount % sampling) == 0) || (clusterCentres != NULL))
+                {
+                    bool nonZeroFound = false;
+                    for(unsigned int b = 0; b < numBands; ++b)
+                    {
+                        pxlVals[b] = vals[(numVals * b) + i];
+                        if(pxlVals[b] != 0)
+                        {
+                            nonZeroFound = true;
+                        }
+                    }
+                    if(clusterCentres != NULL)
+                    {
+                        labelVals[i] = this->findClosestCentre(pxlVals.data(), numBands, clusterCentres);
+                    }
+                    else if(nonZeroFound)
+                    {
+                        samples->push_back(pxlVals);
+                    }
+                }
+                ++pxlCount;
+            }
+
+            for(unsigned int b = 0; b < numBands; ++b)
+            {
+                if(spectral->GetRasterBand(b+1)->RasterIO(GF_Write, 0, row, width, blockRows, &vals[numVals * b], width, blockRows, GDT_Float32, 0, 0) != CE_None)
+                {
+                    delete[] inBands;
+                    throw rsgis::img::RSGISImageCalcException("Could not write the stretched image.");
+                }
+            }
+            if(clusterCentres != NULL)
+            {
+                if(labels->GetRasterBand(1)->RasterIO(GF_Write, 0, row, width, blockRows, labelVals.data(), width, blockRows, GDT_UInt32, 0, 0) != CE_None)
+                {
+                    delete[] inBands;
+                    throw rsgis::img::RSGISImageCalcException("Could not write the labels image.");
+                }
+            }
+        }
+        pbar.finish();
+        delete[] inBands;
+    }
+
+    void RSGISShepherdSegmentation::labelPixels(GDALDataset *spectral, rsgis::math::Matrix *clusterCentres, GDALDataset *labels)
+    {
+        unsigned int numBands = spectral->GetRasterCount();
+        unsigned int width = spectral->GetRasterXSize();
+        unsigned int height = spectral->GetRasterYSize();
+
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        spectral->GetRasterBand(1)->GetBlockSize(&xBlockSize, &yBlockSize);
+        unsigned int numRows = (yBlockSize > 0)?yBlockSize:1;
+        size_t blockSize = ((size_t)width) * numRows;
+        std::vector<float> vals(blockSize * numBands);
+        std::vector<unsigned int> labelVals(blockSize);
+        std::vector<float> pxlVals(numBands);
+
+        rsgis_tqdm pbar;
+        for(unsigned int row = 0; row < height; row += numRows)
+        {
+            pbar.progress(row, height);
+            unsigned int blockRows = std::min(numRows, height - row);
+            size_t numVals = ((size_t)width) * blockRows;
+            for(unsigned int b = 0; b < numBands; ++b)
+            {
+                if(spectral->GetRasterBand(b+1)->RasterIO(GF_Read, 0, row, width, blockRows, &vals[numVals * b], width, blockRows, GDT_Float32, 0, 0) != CE_None)
+                {
+                    throw rsgis::img::RSGISImageCalcException("Could not read the stretched image.");
+                }
+            }
+            for(size_t i = 0; i < numVals; ++i)
+            {
+                for(unsigned int b = 0; b < numBands; ++b)
+                {
+                    pxlVals[b] = vals[(numVals * b) + i];
+                }
+                labelVals[i] = this->findClosestCentre(pxlVals.data(), numBands, clusterCentres);
+            }
+            if(labels->GetRasterBand(1)->RasterIO(GF_Write, 0, row, width, blockRows, labelVals.data(), width, blockRows, GDT_UInt32, 0, 0) != CE_None)
+            {
+                throw rsgis::img::RSGISImageCalcException("Could not write the labels image.");
+            }
+        }
+        pbar.finish();
+    }
+
+    RSGISShepherdSegmentation::~RSGISShepherdSegmentation()
+    {
+
+    }
+
+}}
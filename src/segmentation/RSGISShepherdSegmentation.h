@@ -0,0 +1,147 @@
+/*
+ *  RSGISShepherdSegmentation.h
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISShepherdSegmentation_h
+#define RSGISShepherdSegmentation_h
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <math.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+
+#include "gdal_priv.h"
+
+#include "common/RSGISImageException.h"
+#include "common/rsgis-tqdm.h"
+
+#include "math/RSGISMatrices.h"
+#include "math/RSGISClustering.h"
+
+#include "img/RSGISImageUtils.h"
+#include "img/RSGISImageCalcException.h"
+#include "img/RSGISStretchImage.h"
+
+#include "segmentation/RSGISEliminateSinglePixels.h"
+#include "segmentation/RSGISClumpPxls.h"
+#include "segmentation/RSGISClumpAdjacencyGraph.h"
+#include "segmentation/RSGISEliminateSmallClumps.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_segmentation_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace segment{
+
+    /**
+     * The segmentation algorithm of Shepherd et al. (2019) (as in segutils.runShepherdSegmentation)
+     * run within a single process:
+     *
+     *  1. The stretch (linear 2 std dev, plus 1 and masked where band 1 is 0) is applied while
+     *     reading the input image, which is also sampled for the KMeans at the same time. If
+     *     the cluster centres are provided the pixels are also labelled within this pass.
+     *  2. KMeans clustering of the sample and labelling of the stretched image.
+     *  3. Elimination of single pixels and clumping.
+     *  4. A region adjacency graph is built from the clumps and the small clumps eliminated
+     *     within the graph, which then writes the final (relabelled) clumps in a single pass.
+     *
+     * The intermediate images are held in memory (processInMemory) or as temporary files
+     * within tmpDIR which are deleted as soon as they are no longer needed.
+     */
+    class DllExport RSGISShepherdSegmentation
+    {
+    public:
+        RSGISShepherdSegmentation(bool processInMemory, std::string tmpDIR, std::string tmpFormat);
+        /**
+         * Segment the bands (numbered from 1; all bands if empty) of inputImage writing the clumps
+         * to band 1 of outClumps. If inStretchStatsFile and/or inKMeansCentresFile are provided
+         * they are used rather than being calculated. If outStretchStatsFile and/or
+         * outKMeansCentresFile are provided the calculated stretch and centres are saved.
+         */
+        void performSegmentation(GDALDataset *inputImage, std::vector<unsigned int> bands, GDALDataset *outClumps, bool noStretch, unsigned int numClusters, unsigned int minPxls, float distThres, unsigned int sampling, unsigned int kmMaxIter, std::string inStretchStatsFile="", std::string inKMeansCentresFile="", std::string outStretchStatsFile="", std::string outKMeansCentresFile="");
+        ~RSGISShepherdSegmentation();
+    protected:
+        GDALDataset* createIntermediate(GDALDataset *templateImg, unsigned int numBands, GDALDataType dataType);
+        void deleteIntermediate(GDALDataset *dataset);
+        void calcStretchStats(GDALDataset *inputImage, std::vector<unsigned int> *bands, std::vector<double> *stretchMin, std::vector<double> *stretchMax, std::string outStretchStatsFile);
+        void stretchImage(GDALDataset *inputImage, std::vector<unsigned int> *bands, bool stretch, bool ignoreZeros, std::vector<double> *stretchMin, std::vector<double> *stretchMax, GDALDataset *spectral, unsigned int sampling, std::vector< std::vector<float> > *samples, rsgis::math::Matrix *clusterCentres, GDALDataset *labels);
+        void labelPixels(GDALDataset *spectral, rsgis::math::Matrix *clusterCentres, GDALDataset *labels);
+        /** Nearest cluster centre (numbered from 1) using the same measure as RSGISLabelPixelsUsingClustersCalcImg; 0 if all the values are 0. */
+        inline unsigned int findClosestCentre(const float *vals, unsigned int numBands, rsgis::math::Matrix *clusterCentres)
+        {
+            bool nonZeroFound = false;
+            for(unsigned int n = 0; n < numBands; ++n)
+            {
+                if(vals[n] != 0)
+                {
+                    nonZeroFound = true;
+                    break;
+                }
+            }
+            if(!nonZeroFound)
+            {
+                return 0;
+            }
+
+            unsigned int clusterID = 0;
+            float minDist = 0;
+            float dist = 0;
+            for(int cluster = 0; cluster < clusterCentres->m; ++cluster)
+            {
+                dist = 0;
+                for(unsigned int n = 0; n < numBands; ++n)
+                {
+                    float diff = vals[n] - clusterCentres->matrix[(n*clusterCentres->m)+cluster];
+                    dist += diff * diff;
+                }
+                dist = sqrt(dist);
+                if((cluster == 0) || (dist < minDist))
+                {
+                    clusterID = cluster + 1;
+                    minDist = dist;
+                }
+            }
+            return clusterID;
+        };
+        bool processInMemory;
+        boost::filesystem::path tmpDIR;
+        std::string tmpFormat;
+        std::map<GDALDataset*, std::string> tmpFiles;
+    };
+
+}}
+
+#endif
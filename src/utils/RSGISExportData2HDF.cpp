@@ -81,7 +81,7 @@ namespace rsgis{namespace utils{
         return h5_dtype;
     }
     
-    void RSGISExportColumnData2HDF::createFile(std::string filePath, unsigned int numCols, std::string description, H5::DataType dataType)
+    void RSGISExportColumnData2HDF::createFile(std::string filePath, unsigned int numCols, std::string description, H5::DataType dataType, unsigned int chunkRows, bool compress)
     {
         try
         {
@@ -117,15 +117,21 @@ namespace rsgis{namespace utils{
             datasetDescription.close();
             delete[] wStrdata;
             
-            this->blockSize = 1000;
-            int deflate = 1;
+            if(chunkRows == 0)
+            {
+                throw RSGISFileException("The number of rows within a chunk must be greater than 0.");
+            }
+            this->blockSize = chunkRows;
             int initFillVal = 0;
             
             hsize_t dimsDataChunk[] = { blockSize, numCols };
             H5::DSetCreatPropList initParamsData;
             initParamsData.setChunk(2, dimsDataChunk);
-            initParamsData.setShuffle();
-            initParamsData.setDeflate(deflate);
+            if(compress)
+            {
+                initParamsData.setShuffle();
+                initParamsData.setDeflate(HDF5_WRITE_DEFLATE);
+            }
             initParamsData.setFillValue( H5::PredType::NATIVE_INT, &initFillVal);
             
             hsize_t initDataDims[] = { 0, numCols };
@@ -165,12 +171,21 @@ namespace rsgis{namespace utils{
     
     void RSGISExportColumnData2HDF::addDataRow(void *data, H5::DataType h5Datatype)
     {
+        this->addDataRows(data, 1, h5Datatype);
+    }
+    
+    void RSGISExportColumnData2HDF::addDataRows(void *data, unsigned int nRows, H5::DataType h5Datatype)
+    {
+        if(nRows == 0)
+        {
+            return;
+        }
         try
         {
             H5::Exception::dontPrint();
             
             hsize_t extendDatasetTo[2];
-            extendDatasetTo[0] = this->numColsWritten + 1;
+            extendDatasetTo[0] = this->numColsWritten + nRows;
             extendDatasetTo[1] = this->numCols;
             columnDataSet.extend( extendDatasetTo );
             
@@ -178,7 +193,7 @@ namespace rsgis{namespace utils{
             dataOffset[0] = this->numColsWritten;
             dataOffset[1] = 0;
             hsize_t dataDims[2];
-            dataDims[0] = 1;
+            dataDims[0] = nRows;
             dataDims[1] = numCols;
             
             H5::DataSpace colWriteDataSpace = columnDataSet.getSpace();
@@ -187,7 +202,7 @@ namespace rsgis{namespace utils{
             
             columnDataSet.write(data, h5Datatype, newDataspace, colWriteDataSpace);
             
-            ++this->numColsWritten;
+            this->numColsWritten += nRows;
         }
         catch (rsgis::RSGISFileException &e)
         {
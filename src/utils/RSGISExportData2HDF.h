@@ -70,8 +70,15 @@ namespace rsgis{namespace utils{
 	public:
 		RSGISExportColumnData2HDF();
         H5::DataType getH5DataType(RSGISLibDataType rsgis_datatype);
-        void createFile(std::string filePath, unsigned int numCols, std::string description, H5::DataType dataType);
+        /**
+         * Create the file with an extendable /DATA/DATA dataset of numCols columns, stored in
+         * chunks of chunkRows rows. If compress is true the chunks are shuffled and deflated.
+         */
+        void createFile(std::string filePath, unsigned int numCols, std::string description, H5::DataType dataType, unsigned int chunkRows=1000, bool compress=true);
         void addDataRow(void *data, H5::DataType h5Datatype);
+        /** Append nRows rows (row major, numCols values per row) with a single write. */
+        void addDataRows(void *data, unsigned int nRows, H5::DataType h5Datatype);
+        unsigned long long getNumRowsWritten(){return this->numColsWritten;};
         void close();
 		~RSGISExportColumnData2HDF();
     protected:
@@ -79,7 +86,7 @@ namespace rsgis{namespace utils{
         H5::DataSet columnDataSet;
         unsigned int numCols;
         unsigned int blockSize;
-        unsigned int numColsWritten;
+        hsize_t numColsWritten;
 	};
     
     class DllExport RSGISReadHDFColumnData
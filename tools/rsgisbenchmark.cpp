@@ -0,0 +1,659 @@
+/*
+ *  rsgisbenchmark.cpp
+ *  RSGIS_LIB
+ *
+ *  Created on 18/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Times representative processing paths of the library on synthetic data created
+ * (deterministically, from a seed) with RSGISCreateTestImages and writes the results
+ * as JSON, so they can be compared across releases and machines:
+ *
+ *   rsgisbenchmark [--width 4096] [--height 4096] [--threads 1] [--seed 42]
+ *                  [--repeats 3] [--tmpdir .] [--output results.json] [--bench name]...
+ *
+ * Each benchmark is run 'repeats' times and the fastest time is reported. The peak
+ * resident memory is reset before each benchmark where the OS allows it (Linux),
+ * otherwise it is the peak for the process so far.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <exception>
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <limits>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "gdal_priv.h"
+#include "cpl_vsi.h"
+
+#include "common/RSGISThreadPool.h"
+
+#include "img/RSGISCalcImage.h"
+#include "img/RSGISCalcImageValue.h"
+#include "img/RSGISCalcImageTyped.h"
+#include "img/RSGISCreateTestImages.h"
+#include "img/RSGISImageMosaic.h"
+
+#include "filtering/RSGISStatsFilters.h"
+
+#include "segmentation/RSGISClumpPxls.h"
+
+#include "rastergis/RSGISPopRATWithStats.h"
+
+#include "math/RSGISKMeansEngine.h"
+
+#include "cmds/RSGISCmdZonalStats.h"
+
+#ifndef RSGISLIB_BENCHMARK_VERSION
+#define RSGISLIB_BENCHMARK_VERSION "unknown"
+#endif
+
+/*
+ * Copies a single band through the float32 in / float64 out path of RSGISCalcImage.
+ */
+class RSGISBenchCopyBand : public rsgis::img::RSGISCalcImageValue
+{
+public:
+    RSGISBenchCopyBand():rsgis::img::RSGISCalcImageValue(1){};
+    void calcImageValue(float *bandValues, int numBands, double *output){output[0] = bandValues[0];};
+    ~RSGISBenchCopyBand(){};
+};
+
+/*
+ * Copies a single band through the native type path of RSGISCalcImageTyped.
+ */
+template <typename T>
+class RSGISBenchCopyBandTyped : public rsgis::img::RSGISCalcImageTypedValue<T, T>
+{
+public:
+    RSGISBenchCopyBandTyped():rsgis::img::RSGISCalcImageTypedValue<T, T>(1){};
+    void calcImageBlock(T **bandValues, int numBands, unsigned long nPxls, T **output)
+    {
+        for(unsigned long i = 0; i < nPxls; ++i)
+        {
+            output[0][i] = bandValues[0][i];
+        }
+    };
+    ~RSGISBenchCopyBandTyped(){};
+};
+
+/*
+ * Mean of the bands for each pixel, per pixel or per block.
+ */
+class RSGISBenchBandMean : public rsgis::img::RSGISCalcImageValue
+{
+public:
+    RSGISBenchBandMean(bool useBlocks):rsgis::img::RSGISCalcImageValue(1), useBlocks(useBlocks){};
+    void calcImageValue(float *bandValues, int numBands, double *output)
+    {
+        double sum = 0;
+        for(int n = 0; n < numBands; ++n)
+        {
+            sum += bandValues[n];
+        }
+        output[0] = sum / numBands;
+    };
+    void calcImageBlock(float **bandValues, int numBands, unsigned long nPxls, double **output)
+    {
+        for(unsigned long i = 0; i < nPxls; ++i)
+        {
+            output[0][i] = 0;
+        }
+        for(int n = 0; n < numBands; ++n)
+        {
+            for(unsigned long i = 0; i < nPxls; ++i)
+            {
+                output[0][i] += bandValues[n][i];
+            }
+        }
+        for(unsigned long i = 0; i < nPxls; ++i)
+        {
+            output[0][i] /= numBands;
+        }
+    };
+    bool implementsCalcImageBlock(){return this->useBlocks;};
+    ~RSGISBenchBandMean(){};
+protected:
+    bool useBlocks;
+};
+
+/*
+ * Mean of the window of the first band.
+ */
+class RSGISBenchWindowMean : public rsgis::img::RSGISCalcImageValue
+{
+public:
+    RSGISBenchWindowMean():rsgis::img::RSGISCalcImageValue(1){};
+    void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output)
+    {
+        double sum = 0;
+        for(int y = 0; y < winSize; ++y)
+        {
+            for(int x = 0; x < winSize; ++x)
+            {
+                sum += dataBlock[0][y][x];
+            }
+        }
+        output[0] = sum / (winSize * winSize);
+    };
+    ~RSGISBenchWindowMean(){};
+};
+
+struct RSGISBenchResult
+{
+    std::string name;
+    double numPxls;
+    double minSecs;
+    double meanSecs;
+    double peakRSSMB;
+};
+
+/*
+ * Reset the peak resident memory of the process (Linux only; returns false otherwise).
+ */
+bool resetPeakRSS()
+{
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if(!clearRefs.is_open())
+    {
+        return false;
+    }
+    clearRefs << "5";
+    return clearRefs.good();
+}
+
+/*
+ * The peak resident memory (MB) of the process, or a negative value if it is not available.
+ */
+double getPeakRSSMB()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while(std::getline(status, line))
+    {
+        if(line.compare(0, 6, "VmHWM:") == 0)
+        {
+            return atof(line.substr(6).c_str()) / 1024.0;
+        }
+    }
+#ifndef _WIN32
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef __APPLE__
+        return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+        return usage.ru_maxrss / 1024.0;
+#endif
+    }
+#endif
+    return -1;
+}
+
+/*
+ * Send std::cout to another stream buffer until restored (or destroyed) so the progress
+ * messages printed by the library do not end up in the JSON written to stdout.
+ */
+class RSGISRedirectStdOut
+{
+public:
+    RSGISRedirectStdOut(std::streambuf *buf)
+    {
+        this->stdOutBuf = std::cout.rdbuf(buf);
+    };
+    void restore()
+    {
+        if(this->stdOutBuf != NULL)
+        {
+            std::cout.flush();
+            std::cout.rdbuf(this->stdOutBuf);
+            this->stdOutBuf = NULL;
+        }
+    };
+    ~RSGISRedirectStdOut()
+    {
+        this->restore();
+    };
+private:
+    std::streambuf *stdOutBuf;
+};
+
+class RSGISBenchmarkRunner
+{
+public:
+    RSGISBenchmarkRunner(unsigned int repeats, std::vector<std::string> selected):repeats(repeats), selected(selected){};
+    bool isSelected(std::string name)
+    {
+        if(this->selected.empty())
+        {
+            return true;
+        }
+        for(std::vector<std::string>::iterator iterName = this->selected.begin(); iterName != this->selected.end(); ++iterName)
+        {
+            // Allow a prefix (e.g., 'calcimage') to select a group of benchmarks.
+            if(name.compare(0, (*iterName).size(), *iterName) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+    /*
+     * Time 'run' (repeated), calling 'setup' before and 'teardown' after each run outside the timing.
+     */
+    void run(std::string name, double numPxls, std::function<void()> setup, std::function<void()> run, std::function<void()> teardown)
+    {
+        if(!this->isSelected(name))
+        {
+            return;
+        }
+        std::cerr << "Running " << name << std::endl;
+        resetPeakRSS();
+        RSGISBenchResult result;
+        result.name = name;
+        result.numPxls = numPxls;
+        result.minSecs = std::numeric_limits<double>::max();
+        result.meanSecs = 0;
+        for(unsigned int i = 0; i < this->repeats; ++i)
+        {
+            setup();
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            run();
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            teardown();
+            if(secs < result.minSecs)
+            {
+                result.minSecs = secs;
+            }
+            result.meanSecs += secs / this->repeats;
+        }
+        result.peakRSSMB = getPeakRSSMB();
+        std::cerr << "\t" << result.minSecs << " s, " << (numPxls/result.minSecs) << " pixels/s\n";
+        this->results.push_back(result);
+    };
+    void writeJSON(std::ostream &out, std::string header)
+    {
+        out << "{\n" << header << "  \"benchmarks\": [\n";
+        for(size_t i = 0; i < this->results.size(); ++i)
+        {
+            RSGISBenchResult &result = this->results[i];
+            out << "    {\"name\": \"" << result.name << "\", \"pixels\": " << result.numPxls;
+            out << ", \"seconds\": " << result.minSecs << ", \"mean_seconds\": " << result.meanSecs;
+            out << ", \"pixels_per_sec\": " << (result.numPxls/result.minSecs) << ", \"peak_rss_mb\": ";
+            if(result.peakRSSMB < 0)
+            {
+                out << "null";
+            }
+            else
+            {
+                out << result.peakRSSMB;
+            }
+            out << "}" << ((i+1) < this->results.size()?",":"") << "\n";
+        }
+        out << "  ]\n}\n";
+    };
+protected:
+    unsigned int repeats;
+    std::vector<std::string> selected;
+    std::vector<RSGISBenchResult> results;
+};
+
+GDALDataset* createBenchImage(GDALDriver *driver, std::string fileName, int width, int height, int numBands, GDALDataType dataType, double tlX=0, double tlY=0)
+{
+    GDALDataset *dataset = driver->Create(fileName.c_str(), width, height, numBands, dataType, NULL);
+    if(dataset == NULL)
+    {
+        throw rsgis::RSGISImageException("Could not create image " + fileName);
+    }
+    double trans[6] = {tlX, 1.0, 0.0, tlY + height, 0.0, -1.0};
+    dataset->SetGeoTransform(trans);
+    return dataset;
+}
+
+template <typename T>
+void benchmarkNativeIO(RSGISBenchmarkRunner *runner, GDALDriver *memDriver, int width, int height, unsigned int seed)
+{
+    GDALDataType dataType = rsgis::img::RSGISGDALDataTypeOf<T>::type();
+    std::string typeName = GDALGetDataTypeName(dataType);
+    for(std::string::iterator iterChar = typeName.begin(); iterChar != typeName.end(); ++iterChar)
+    {
+        *iterChar = tolower(*iterChar);
+    }
+    std::string floatName = "calcimage_copy_" + typeName;
+    std::string typedName = "calcimagetyped_copy_" + typeName;
+    if(!(runner->isSelected(floatName) | runner->isSelected(typedName)))
+    {
+        return;
+    }
+    double numPxls = ((double)width) * ((double)height);
+
+    rsgis::img::RSGISCreateTestImages createImages;
+    GDALDataset *inDS = createBenchImage(memDriver, "", width, height, 1, dataType);
+    createImages.fillRandomImage(inDS, seed, 0, 250);
+    GDALDataset *outDS = NULL;
+    std::function<void()> createOut = [&](){outDS = createBenchImage(memDriver, "", width, height, 1, dataType);};
+    std::function<void()> closeOut = [&](){GDALClose(outDS); outDS = NULL;};
+
+    RSGISBenchCopyBand copyFloat;
+    rsgis::img::RSGISCalcImage calcFloat(&copyFloat);
+    runner->run(floatName, numPxls, createOut, [&](){calcFloat.calcImage(&inDS, 1, outDS);}, closeOut);
+
+    RSGISBenchCopyBandTyped<T> copyTyped;
+    rsgis::img::RSGISCalcImageTyped<T, T> calcTyped(&copyTyped);
+    runner->run(typedName, numPxls, createOut, [&](){calcTyped.calcImage(&inDS, 1, outDS);}, closeOut);
+
+    GDALClose(inDS);
+}
+
+void removeFile(std::string fileName)
+{
+    VSIStatBufL statBuf;
+    if(VSIStatL(fileName.c_str(), &statBuf) == 0)
+    {
+        GDALDriver *driver = (GDALDriver *)GDALIdentifyDriver(fileName.c_str(), NULL);
+        if((driver == NULL) || (driver->Delete(fileName.c_str()) != CE_None))
+        {
+            VSIUnlink(fileName.c_str());
+        }
+    }
+}
+
+void printUsage()
+{
+    std::cerr << "Usage: rsgisbenchmark [--width 4096] [--height 4096] [--threads 1] [--seed 42] [--repeats 3]\n";
+    std::cerr << "                      [--tmpdir .] [--output results.json] [--bench name]...\n";
+    std::cerr << "  --threads  number of threads used by the library (0 = number of cores).\n";
+    std::cerr << "  --tmpdir   directory for the files used by the file based benchmarks.\n";
+    std::cerr << "  --output   JSON output file (default: stdout).\n";
+    std::cerr << "  --bench    only run the benchmarks starting with this name (can be repeated).\n";
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        int width = 4096;
+        int height = 4096;
+        unsigned int numThreads = 1;
+        unsigned int seed = 42;
+        unsigned int repeats = 3;
+        std::string tmpDir = ".";
+        std::string outputFile = "";
+        std::vector<std::string> selected;
+        for(int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if((arg == "-h") | (arg == "--help"))
+            {
+                printUsage();
+                return 0;
+            }
+            if((i+1) >= argc)
+            {
+                printUsage();
+                return 1;
+            }
+            std::string val = argv[++i];
+            if(arg == "--width"){width = atoi(val.c_str());}
+            else if(arg == "--height"){height = atoi(val.c_str());}
+            else if(arg == "--threads"){numThreads = atoi(val.c_str());}
+            else if(arg == "--seed"){seed = strtoul(val.c_str(), NULL, 10);}
+            else if(arg == "--repeats"){repeats = atoi(val.c_str());}
+            else if(arg == "--tmpdir"){tmpDir = val;}
+            else if(arg == "--output"){outputFile = val;}
+            else if(arg == "--bench"){selected.push_back(val);}
+            else
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        if((width < 16) | (height < 16) | (repeats < 1))
+        {
+            std::cerr << "The width and height must be at least 16 pixels and repeats at least 1.\n";
+            return 1;
+        }
+        rsgis::RSGISThreadPool::setDefaultNumThreads(numThreads);
+        RSGISRedirectStdOut redirectStdOut(std::cerr.rdbuf());
+        double numPxls = ((double)width) * ((double)height);
+
+        GDALAllRegister();
+        GDALDriver *memDriver = GetGDALDriverManager()->GetDriverByName("MEM");
+        GDALDriver *gtiffDriver = GetGDALDriverManager()->GetDriverByName("GTiff");
+        if((memDriver == NULL) | (gtiffDriver == NULL))
+        {
+            std::cerr << "The GDAL MEM and GTiff drivers are required.\n";
+            return 1;
+        }
+
+        RSGISBenchmarkRunner runner(repeats, selected);
+        rsgis::img::RSGISCreateTestImages createImages;
+        std::function<void()> noOp = [](){};
+
+        // Input and output data types of RSGISCalcImage vs RSGISCalcImageTyped.
+        benchmarkNativeIO<unsigned char>(&runner, memDriver, width, height, seed);
+        benchmarkNativeIO<unsigned short>(&runner, memDriver, width, height, seed);
+        benchmarkNativeIO<unsigned int>(&runner, memDriver, width, height, seed);
+
+        GDALDataset *valsDS = createBenchImage(memDriver, "", width, height, 3, GDT_Float32);
+        createImages.fillRandomImage(valsDS, seed, 0, 1000);
+        GDALDataset *outDS = NULL;
+        std::function<void()> createOut = [&](){outDS = createBenchImage(memDriver, "", width, height, 1, GDT_Float32);};
+        std::function<void()> closeOut = [&](){GDALClose(outDS); outDS = NULL;};
+
+        RSGISBenchBandMean bandMean(false);
+        rsgis::img::RSGISCalcImage calcBandMean(&bandMean);
+        runner.run("calcimage_bandmean", numPxls, createOut, [&](){calcBandMean.calcImage(&valsDS, 1, outDS);}, closeOut);
+
+        RSGISBenchBandMean bandMeanBlock(true);
+        rsgis::img::RSGISCalcImage calcBandMeanBlock(&bandMeanBlock);
+        runner.run("calcimage_bandmean_block", numPxls, createOut, [&](){calcBandMeanBlock.calcImage(&valsDS, 1, outDS);}, closeOut);
+
+        RSGISBenchWindowMean winMean;
+        rsgis::img::RSGISCalcImage calcWinMean(&winMean);
+        runner.run("calcimagewindowdata_mean_3x3", numPxls, createOut, [&](){calcWinMean.calcImageWindowData(&valsDS, 1, outDS, 3);}, closeOut);
+
+        rsgis::filter::RSGISMedianFilter medianFilter(3, 5, "");
+        runner.run("filter_median_5x5", numPxls, noOp, [&](){medianFilter.runFilter(&valsDS, 1, "", "MEM", GDT_Float32);}, noOp);
+
+        // Clumping of a categorical image and the population of the attribute table of the clumps.
+        GDALDataset *regionsDS = createBenchImage(memDriver, "", width, height, 1, GDT_UInt32);
+        createImages.fillRegionsImage(regionsDS, 16, 5, seed);
+        GDALDataset *clumpsDS = NULL;
+        rsgis::segment::RSGISClumpPxls clumpPxls;
+        runner.run("clump", numPxls, [&](){if(clumpsDS != NULL){GDALClose(clumpsDS);} clumpsDS = createBenchImage(memDriver, "", width, height, 1, GDT_UInt32);},
+                   [&](){clumpPxls.performClump(regionsDS, clumpsDS, false, 0);}, noOp);
+        if(clumpsDS == NULL)
+        {
+            clumpsDS = createBenchImage(memDriver, "", width, height, 1, GDT_UInt32);
+            clumpPxls.performClump(regionsDS, clumpsDS, false, 0);
+        }
+
+        std::vector<rsgis::rastergis::RSGISBandAttStats*> bandStats;
+        for(unsigned int n = 1; n <= 3; ++n)
+        {
+            rsgis::rastergis::RSGISBandAttStats *stats = new rsgis::rastergis::RSGISBandAttStats();
+            stats->init();
+            stats->band = n;
+            std::string baseName = "b" + std::to_string(n);
+            stats->calcMin = true;
+            stats->minField = baseName + "Min";
+            stats->calcMax = true;
+            stats->maxField = baseName + "Max";
+            stats->calcMean = true;
+            stats->meanField = baseName + "Mean";
+            stats->calcStdDev = true;
+            stats->stdDevField = baseName + "StdDev";
+            bandStats.push_back(stats);
+        }
+        rsgis::rastergis::RSGISPopRATWithStats popRATStats;
+        runner.run("rat_basic_stats", numPxls, [&](){GDALDefaultRasterAttributeTable emptyRAT; clumpsDS->GetRasterBand(1)->SetDefaultRAT(&emptyRAT);},
+                   [&](){popRATStats.populateRATWithBasicStats(clumpsDS, valsDS, &bandStats, 1);}, noOp);
+        for(std::vector<rsgis::rastergis::RSGISBandAttStats*>::iterator iterStats = bandStats.begin(); iterStats != bandStats.end(); ++iterStats)
+        {
+            delete *iterStats;
+        }
+        GDALClose(clumpsDS);
+        GDALClose(regionsDS);
+
+        // K-means of (up to 1 million) pixel values.
+        if(runner.isSelected("kmeans"))
+        {
+            size_t step = ((size_t)(numPxls / 1000000)) + 1;
+            rsgis::math::RSGISKMeansEngine kmeans(3, numThreads);
+            std::vector<float> rowData(((size_t)width) * 3);
+            std::vector<float> sample(3);
+            size_t pxlIdx = 0;
+            for(int y = 0; y < height; ++y)
+            {
+                valsDS->RasterIO(GF_Read, 0, y, width, 1, &rowData[0], width, 1, GDT_Float32, 3, NULL, 0, 0, 0);
+                for(int x = 0; x < width; ++x, ++pxlIdx)
+                {
+                    if((pxlIdx % step) == 0)
+                    {
+                        for(unsigned int n = 0; n < 3; ++n)
+                        {
+                            sample[n] = rowData[(((size_t)n)*width)+x];
+                        }
+                        kmeans.addSample(&sample[0]);
+                    }
+                }
+            }
+            std::vector<float> centres;
+            std::vector<unsigned int> labels;
+            std::vector<unsigned int> numClusterPxls;
+            std::function<void()> initCentres = [&]()
+            {
+                // The first samples are the initial centres so every run does the same iterations.
+                centres.clear();
+                labels.clear();
+                for(size_t i = 0; i < 10; ++i)
+                {
+                    centres.insert(centres.end(), kmeans.getSample(i), kmeans.getSample(i)+3);
+                }
+            };
+            runner.run("kmeans_10", kmeans.getNumSamples(), initCentres, [&](){kmeans.clusterSamples(&centres, &labels, &numClusterPxls, 20, 0.0025, false);}, noOp);
+        }
+
+        // File based benchmarks.
+        std::string valsFile = tmpDir + "/rsgisbench_vals.tif";
+        std::string zonesFile = tmpDir + "/rsgisbench_zones.gpkg";
+        std::string mosaicFile = tmpDir + "/rsgisbench_mosaic.tif";
+        std::vector<std::string> tileFiles;
+
+        GDALDriver *gpkgDriver = GetGDALDriverManager()->GetDriverByName("GPKG");
+        if(runner.isSelected("zonal_stats") & (gpkgDriver != NULL))
+        {
+            GDALDataset *valsFileDS = gtiffDriver->CreateCopy(valsFile.c_str(), valsDS, FALSE, NULL, NULL, NULL);
+            GDALClose(valsFileDS);
+            runner.run("zonal_stats", numPxls, [&](){removeFile(zonesFile); createImages.createGridPolygons(valsDS, zonesFile, "zones", "GPKG", 64, 64);},
+                       [&]()
+                       {
+                           rsgis::cmds::RSGISZonalBandAttrsCmds zonalAtts;
+                           zonalAtts.band = 1;
+                           zonalAtts.baseName = "b1";
+                           zonalAtts.outMin = true;
+                           zonalAtts.outMax = true;
+                           zonalAtts.outMean = true;
+                           zonalAtts.outStDev = true;
+                           zonalAtts.outCount = true;
+                           zonalAtts.outMode = false;
+                           zonalAtts.outMedian = false;
+                           zonalAtts.outSum = true;
+                           zonalAtts.minThres = -std::numeric_limits<float>::max();
+                           zonalAtts.maxThres = std::numeric_limits<float>::max();
+                           // Deleted by executePixelBandStatsVecLyr.
+                           std::vector<rsgis::cmds::RSGISZonalBandAttrsCmds> *zonBandAtts = new std::vector<rsgis::cmds::RSGISZonalBandAttrsCmds>();
+                           zonBandAtts->push_back(zonalAtts);
+                           rsgis::cmds::executePixelBandStatsVecLyr(valsFile, zonesFile, "zones", zonBandAtts, 1, true);
+                       }, noOp);
+            removeFile(zonesFile);
+            removeFile(valsFile);
+        }
+        else if(runner.isSelected("zonal_stats"))
+        {
+            std::cerr << "Skipping zonal_stats as the GDAL GPKG driver is not available.\n";
+        }
+
+        if(runner.isSelected("mosaic"))
+        {
+            // 2 x 2 overlapping tiles covering the width x height output.
+            int tileWidth = (width / 2) + (width / 16);
+            int tileHeight = (height / 2) + (height / 16);
+            for(unsigned int i = 0; i < 4; ++i)
+            {
+                std::string tileFile = tmpDir + "/rsgisbench_tile" + std::to_string(i) + ".tif";
+                double tlX = (i % 2) * (width - tileWidth);
+                double tlY = (i / 2) * (height - tileHeight);
+                GDALDataset *tileDS = createBenchImage(gtiffDriver, tileFile, tileWidth, tileHeight, 3, GDT_Float32, tlX, tlY);
+                createImages.fillRandomImage(tileDS, seed+i+1, 1, 1000);
+                GDALClose(tileDS);
+                tileFiles.push_back(tileFile);
+            }
+            rsgis::img::RSGISImageMosaic mosaic;
+            runner.run("mosaic", numPxls, noOp, [&](){mosaic.mosaic(&tileFiles[0], tileFiles.size(), mosaicFile, 0, true, "", "GTiff", GDT_Float32);}, [&](){removeFile(mosaicFile);});
+            for(std::vector<std::string>::iterator iterFile = tileFiles.begin(); iterFile != tileFiles.end(); ++iterFile)
+            {
+                removeFile(*iterFile);
+            }
+        }
+        GDALClose(valsDS);
+
+        std::stringstream header;
+        header << "  \"rsgislib_version\": \"" << RSGISLIB_BENCHMARK_VERSION << "\",\n";
+        header << "  \"gdal_version\": \"" << GDALVersionInfo("RELEASE_NAME") << "\",\n";
+        header << "  \"num_threads\": " << rsgis::RSGISThreadPool::getDefaultNumThreads() << ",\n";
+        header << "  \"num_cores\": " << rsgis::RSGISThreadPool::getNumCores() << ",\n";
+        header << "  \"width\": " << width << ",\n";
+        header << "  \"height\": " << height << ",\n";
+        header << "  \"seed\": " << seed << ",\n";
+        header << "  \"repeats\": " << repeats << ",\n";
+        if(outputFile == "")
+        {
+            redirectStdOut.restore();
+            runner.writeJSON(std::cout, header.str());
+        }
+        else
+        {
+            std::ofstream outJSON(outputFile.c_str());
+            if(!outJSON.is_open())
+            {
+                std::cerr << "Could not open " << outputFile << std::endl;
+                return 1;
+            }
+            runner.writeJSON(outJSON, header.str());
+            outJSON.close();
+        }
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}